@@ -38,6 +38,20 @@ else ()
 option (ENABLE_MPI "Enable the compilation of the MPI communication code" off)
 endif ()
 
+#################################
+## OpenMP threading of the CPU code paths
+option(ENABLE_OPENMP "Enable OpenMP threading of CPU code paths" off)
+if (ENABLE_OPENMP)
+    find_package(OpenMP)
+    if (NOT OPENMP_FOUND)
+        message(FATAL_ERROR "ENABLE_OPENMP is set, but the compiler does not support OpenMP")
+    endif()
+    set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}")
+    set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}")
+    set(CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}")
+endif (ENABLE_OPENMP)
+
 #################################
 ## Optionally enable documentation build
 OPTION(ENABLE_DOXYGEN "Enables building of documentation with doxygen" OFF)
@@ -115,6 +115,15 @@ class AABBTree
         //! Update the AABB of a particle
         inline void update(unsigned int idx, const AABB& aabb);
 
+        //! Recompute all node AABBs for new AABBs of the same particles
+        inline void refit(const AABB *aabbs, unsigned int N);
+
+        //! Get the number of particles in the tree
+        inline unsigned int getNumParticles() const
+            {
+            return (unsigned int)m_mapping.size();
+            }
+
         //! Get the height of a given particle's leaf node
         inline unsigned int height(unsigned int idx);
 
@@ -298,6 +307,40 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
         }
     }
 
+/*! \param aabbs List of AABBs, one for each particle the tree was built from
+    \param N Number of AABBs in the list, must equal getNumParticles()
+
+    refit() keeps the structure of the tree and only recomputes the node AABBs bottom up, which is O(N) and much cheaper
+    than buildTree(). The result is exact for any new set of AABBs, but the tree is only efficient to query as long as
+    the particles have moved little relative to each other (e.g. after a uniform scaling of the box).
+*/
+inline void AABBTree::refit(const AABB *aabbs, unsigned int N)
+    {
+    assert(N == m_mapping.size());
+
+    // nodes are allocated in pre-order by buildNode(), so every child has a larger index than its parent and a
+    // backwards loop updates the children before their parents
+    for (int node_idx = int(m_num_nodes) - 1; node_idx >= 0; node_idx--)
+        {
+        AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE)
+            {
+            AABB aabb = aabbs[node.particles[0]];
+            node.particle_tags[0] = aabbs[node.particles[0]].tag;
+            for (unsigned int j = 1; j < node.num_particles; j++)
+                {
+                aabb = merge(aabb, aabbs[node.particles[j]]);
+                node.particle_tags[j] = aabbs[node.particles[j]].tag;
+                }
+            node.aabb = aabb;
+            }
+        else
+            {
+            node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            }
+        }
+    }
+
 /*! \param idx Particle to get height for
     \returns Height of the node
 */
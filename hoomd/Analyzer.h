@@ -91,6 +91,12 @@ class Analyzer
         */
         virtual void resetStats(){}
 
+        //! Write out buffered output
+        /*! Analyzers that buffer their output to write it in larger blocks should override flush(). System calls it
+            at the end of every run(), so that all output of a run is written when run() returns.
+        */
+        virtual void flush(){}
+
         //! Get needed pdata flags
         /*! Not all fields in ParticleData are computed by default. When derived classes need one of these optional
             fields, they must return the requested fields in getRequestedPDataFlags().
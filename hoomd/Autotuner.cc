@@ -8,6 +8,10 @@
 #include "HOOMDMPI.h"
 #endif
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -65,6 +69,10 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
     CHECK_CUDA_ERROR();
     #endif
 
+    // time CPU code with the wall clock
+    m_use_clock = !m_exec_conf->isCUDAEnabled();
+    m_clk_start = 0;
+
     m_sync = false;
     }
 
@@ -129,6 +137,10 @@ Autotuner::Autotuner(unsigned int start,
     CHECK_CUDA_ERROR();
     #endif
 
+    // time CPU code with the wall clock
+    m_use_clock = !m_exec_conf->isCUDAEnabled();
+    m_clk_start = 0;
+
     m_sync = false;
     }
 
@@ -148,6 +160,14 @@ void Autotuner::begin()
     if (!m_enabled)
         return;
 
+    // if we are scanning on the CPU, record the start time
+    if (m_use_clock)
+        {
+        if (m_state == STARTUP || m_state == SCANNING)
+            m_clk_start = m_clk.getTime();
+        return;
+        }
+
     #ifdef ENABLE_CUDA
     // if we are scanning, record a cuda event - otherwise do nothing
     if (m_state == STARTUP || m_state == SCANNING)
@@ -165,9 +185,17 @@ void Autotuner::end()
     if (!m_enabled)
         return;
 
+    // handle timing updates if scanning on the CPU
+    if (m_use_clock && (m_state == STARTUP || m_state == SCANNING))
+        {
+        m_samples[m_current_element][m_current_sample] = float(m_clk.getTime() - m_clk_start) / 1e6f;
+        m_exec_conf->msg->notice(9) << "Autotuner " << m_name << ": t(" << m_current_param << "," << m_current_sample
+                                     << ") = " << m_samples[m_current_element][m_current_sample] << endl;
+        }
+
     #ifdef ENABLE_CUDA
     // handle timing updates if scanning
-    if (m_state == STARTUP || m_state == SCANNING)
+    if (!m_use_clock && (m_state == STARTUP || m_state == SCANNING))
         {
         cudaEventRecord(m_stop, 0);
         cudaEventSynchronize(m_stop);
@@ -353,6 +381,60 @@ unsigned int Autotuner::computeOptimalParameter()
     return opt;
     }
 
+/*! Nothing is printed before the initial scan is complete. The times are the medians (or averages or maxima, see
+    setMode()) of the last samples in milliseconds.
+*/
+void Autotuner::printStats()
+    {
+    if (!isComplete())
+        return;
+
+    // the sampled times are only valid on the root rank when synchronizing
+    #ifdef ENABLE_MPI
+    if (m_sync && m_exec_conf->getRank() != 0)
+        return;
+    #endif
+
+    // find the time of the chosen parameter
+    float opt_time = 0.0f;
+    for (unsigned int i = 0; i < m_parameters.size(); i++)
+        {
+        if (m_parameters[i] == m_current_param)
+            opt_time = m_sample_median[i];
+        }
+
+    m_exec_conf->msg->notice(1) << "Autotuner " << m_name << ": chose " << m_current_param << " ("
+                                << opt_time << " ms)" << endl;
+
+    if (m_parameters.size() > 1)
+        {
+        std::ostream& o = m_exec_conf->msg->notice(2);
+        o << "Autotuner " << m_name << ": sampled";
+        for (unsigned int i = 0; i < m_parameters.size(); i++)
+            o << " " << m_parameters[i] << " (" << m_sample_median[i] << " ms)";
+        o << endl;
+        }
+    }
+
+/*! \returns Powers of two smaller than the maximum number of OpenMP threads, followed by the maximum
+
+    Small systems often run faster on fewer threads than are available, because the cost of starting and
+    synchronizing the threads outweighs the work per thread. Without OpenMP, the only thread count is 1.
+*/
+std::vector<unsigned int> Autotuner::getThreadCounts()
+    {
+    unsigned int max_threads = 1;
+    #ifdef ENABLE_OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+
+    std::vector<unsigned int> counts;
+    for (unsigned int n = 1; n < max_threads; n *= 2)
+        counts.push_back(n);
+    counts.push_back(max_threads);
+    return counts;
+    }
+
 void export_Autotuner(py::module& m)
     {
     py::class_<Autotuner>(m,"Autotuner")
@@ -361,5 +443,6 @@ void export_Autotuner(py::module& m)
     .def("setEnabled", &Autotuner::setEnabled)
     .def("setMoveRatio", &Autotuner::isComplete)
     .def("setNSelect", &Autotuner::setPeriod)
+    .def("printStats", &Autotuner::printStats)
     ;
     }
@@ -11,6 +11,7 @@
 */
 
 #include "ExecutionConfiguration.h"
+#include "ClockSource.h"
 
 #include <vector>
 #include <string>
@@ -23,7 +24,7 @@
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #endif
 
-//! Autotuner for low level GPU kernel parameters
+//! Autotuner for low level GPU kernel parameters and CPU implementation choices
 /*! **Overview** <br>
     Autotuner is a helper class that autotunes GPU kernel parameters (such as block size) for performance. It runs an
     internal state machine and makes sweeps over all valid parameter values. Performance is measured just for the single
@@ -44,8 +45,14 @@
 
     Each Autotuner instance has a string name to help identify it's output on the notice stream.
 
-    Autotuner is not useful in non-GPU builds. Timing is performed with CUDA events and requires ENABLE_CUDA=on.
-    Behavior of Autotuner is undefined when ENABLE_CUDA=off.
+    When the execution configuration does not use a GPU, begin() and end() measure the wall clock time between them
+    with ClockSource instead. The same state machine then selects among CPU code paths, such as the number of OpenMP
+    threads of a loop or the index of one of several alternative implementations. The code between begin() and end()
+    must do the same work for every parameter, and it should take at least a few ten microseconds so that the
+    resolution of the clock does not dominate the samples.
+
+    printStats() reports the chosen parameter and the sampled time of every parameter on the notice stream. Classes that
+    own an Autotuner should call it from their own printStats().
 
     ** Implementation ** <br>
     Internally, m_nsamples is the number of samples to take (odd for median computation). m_current_sample is the
@@ -82,6 +89,12 @@ class Autotuner
         //! Call after kernel launch
         void end();
 
+        //! Print the chosen parameter and the sampled times
+        void printStats();
+
+        //! Get thread counts to tune OpenMP loops over
+        static std::vector<unsigned int> getThreadCounts();
+
         //! Get the parameter to set for the kernel launch
         /*! \returns the current parameter that should be set for the kernel launch
 
@@ -202,6 +215,10 @@ class Autotuner
         cudaEvent_t m_stop;       //!< CUDA event for recording end times
         #endif
 
+        bool m_use_clock;         //!< If true, time with m_clk instead of CUDA events
+        ClockSource m_clk;        //!< Clock for timing CPU code
+        int64_t m_clk_start;      //!< Time of the last call to begin() in ns
+
         bool m_sync;              //!< If true, synchronize results via MPI
         mode_Enum m_mode;         //!< The sampling mode
     };
@@ -130,7 +130,7 @@ uint3 CellList::computeDimensions()
     return dim;
     }
 
-void CellList::compute(unsigned int timestep)
+void CellList::doCompute(unsigned int timestep)
     {
     bool force = false;
 
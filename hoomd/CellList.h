@@ -301,7 +301,7 @@ class CellList : public Compute
 
 
         //! Compute the cell list given the current particle positions
-        void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
         //! Benchmark the computation
         double benchmark(unsigned int num_iters);
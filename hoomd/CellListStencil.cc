@@ -49,7 +49,7 @@ CellListStencil::~CellListStencil()
     m_cl->getCellWidthChangeSignal().disconnect<CellListStencil, &CellListStencil::requestCompute>(this);
     }
 
-void CellListStencil::compute(unsigned int timestep)
+void CellListStencil::doCompute(unsigned int timestep)
     {
     // guard against unnecessary calls
     if (!shouldCompute(timestep)) return;
@@ -51,7 +51,7 @@ class CellListStencil : public Compute
         virtual ~CellListStencil();
 
         //! Computes the stencil for each type
-        virtual void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
         //! Set the per-type stencil radius
         void setRStencil(const std::vector<Scalar>& rstencil)
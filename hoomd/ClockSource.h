@@ -25,8 +25,13 @@
 #include <iostream>
 
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 //! Sleep for for a time
@@ -54,6 +59,9 @@ class ClockSource
 
         //! Formats a given time value to HH:MM:SS
         static std::string formatHMS(int64_t t);
+
+        //! Read a fast, monotonic tick counter
+        static uint64_t getTicks();
     private:
         int64_t m_start_time; //!< Stores a base time to reference from
     };
@@ -72,4 +80,20 @@ inline int64_t ClockSource::getTime() const
     return nsec - m_start_time;
     }
 
+/*! On x86, the ticks are cycles of the time stamp counter. Reading it costs a few ns and does not enter the kernel.
+    Modern CPUs run the counter at a constant rate independent of frequency scaling, but the rate is not known
+    in advance. Callers that need seconds must calibrate it against getTime() (see StepTimer). On other
+    architectures, the ticks are nanoseconds of the monotonic clock.
+*/
+inline uint64_t ClockSource::getTicks()
+    {
+    #if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+    #else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec) * uint64_t(1000000000) + uint64_t(t.tv_nsec);
+    #endif
+    }
+
 #endif
@@ -320,6 +320,20 @@ class Communicator
          */
         virtual void updateNetForce(unsigned int timestep);
 
+        //! Copy a per-particle quantity of local particles to their ghost copies on neighboring ranks
+        /*! \param field Array indexed like the particle data, holding at least N+Nghosts elements
+
+            The entries of \a field for local particles are sent along the current ghost exchange lists,
+            and the entries for ghost particles are overwritten with the values received. This lets force
+            computes that depend on an intermediate per-particle result (such as the embedding term of a
+            many-body potential) communicate only that result instead of recomputing it for the ghosts.
+
+            \pre The ghost exchange list has been constructed using exchangeGhosts().
+            \note This method uses the host-side ghost lists and is only valid for the CPU communicator.
+        */
+        template<class T>
+        void updateGhostField(GPUArray<T>& field);
+
         /*! This methods finds all the particles that are no longer inside the domain
          * boundaries and transfers them to neighboring processors.
          *
@@ -644,6 +658,66 @@ class Communicator
 
     };
 
+template<class T>
+void Communicator::updateGhostField(GPUArray<T>& field)
+    {
+    assert(field.getNumElements() >= m_pdata->getN() + m_pdata->getNGhosts());
+
+    if (m_prof)
+        m_prof->push("comm_ghost_field");
+
+    std::vector<T> copybuf;
+    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+
+    ArrayHandle<T> h_field(field, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        // pack the values of the particles sent in this direction, which includes ghosts
+        // received in previous directions
+        copybuf.resize(m_num_copy_ghosts[dir]);
+
+            {
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+
+            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+                {
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+                copybuf[ghost_idx] = h_field.data[idx];
+                }
+            }
+
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+        unsigned int start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+
+        MPI_Request reqs[2];
+        MPI_Status status[2];
+
+        // write directly into the ghost section of the field
+        MPI_Isend(copybuf.empty() ? NULL : &copybuf.front(), m_num_copy_ghosts[dir]*sizeof(T), MPI_BYTE,
+            send_neighbor, 1, m_mpi_comm, &reqs[0]);
+        MPI_Irecv(h_field.data + start_idx, m_num_recv_ghosts[dir]*sizeof(T), MPI_BYTE,
+            recv_neighbor, 1, m_mpi_comm, &reqs[1]);
+        MPI_Waitall(2, reqs, status);
+        } // end dir loop
+
+    if (m_prof)
+        m_prof->pop(0, num_tot_recv_ghosts*sizeof(T));
+    }
+
 
 //! Declaration of python export function
 void export_Communicator(pybind11::module& m);
@@ -23,7 +23,8 @@ using namespace std;
     \post The Compute is constructed with the given particle data and a NULL profiler.
 */
 Compute::Compute(std::shared_ptr<SystemDefinition> sysdef) : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()),
-        exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_last_computed(0), m_first_compute(true)
+        exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_timing_region(StepTimer::NO_REGION),
+        m_last_computed(0), m_first_compute(true)
     {
     // sanity check
     assert(m_sysdef);
@@ -31,6 +32,34 @@ Compute::Compute(std::shared_ptr<SystemDefinition> sysdef) : m_sysdef(sysdef), m
     m_exec_conf = exec_conf;
     }
 
+/*! \param quantity Name of a quantity listed by getProvidedLogQuantities()
+    \returns A handle to pass to getLogValueByHandle()
+
+    Logger resolves the quantities it logs to handles once, so that logging does not compare strings on every
+    time step. The base class numbers the quantity names and getLogValueByHandle() passes the name to getLogValue().
+    Derived classes that provide many quantities should override both methods to avoid the string comparisons.
+*/
+unsigned int Compute::getLogHandle(const std::string& quantity)
+    {
+    for (unsigned int i = 0; i < m_log_handle_names.size(); i++)
+        {
+        if (m_log_handle_names[i] == quantity)
+            return i;
+        }
+
+    m_log_handle_names.push_back(quantity);
+    return (unsigned int)m_log_handle_names.size() - 1;
+    }
+
+/*! \param handle Handle returned by getLogHandle()
+    \param timestep Current time step of the simulation
+*/
+Scalar Compute::getLogValueByHandle(unsigned int handle, unsigned int timestep)
+    {
+    assert(handle < m_log_handle_names.size());
+    return getLogValue(m_log_handle_names[handle], timestep);
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
     Derived classes can optionally implement this method. */
@@ -60,7 +89,7 @@ void Compute::setProfiler(std::shared_ptr<Profiler> prof)
         at this \a timestep.
     \note This method is designed to only be called once per call to compute() like so:
 \code
-void SomeClass::compute(unsgned int timestep)
+void SomeClass::doCompute(unsigned int timestep)
     {
     if (!shouldCompute(timestep))
         return;
@@ -6,6 +6,7 @@
 
 #include "SystemDefinition.h"
 #include "Profiler.h"
+#include "StepTimer.h"
 
 #include <memory>
 #include <string>
@@ -54,6 +55,9 @@
     For convenience, the base class will provide a shouldCompute() method that implements
     this behaviour. Derived classes can override if more complicated behavior is needed.
 
+    compute() records the execution time of every call in the StepTimer region that System assigns to the compute,
+    so derived classes implement doCompute() and do not time themselves.
+
     See \ref page_dev_info for more information
     \ingroup computes
 */
@@ -64,11 +68,16 @@ class Compute
         Compute(std::shared_ptr<SystemDefinition> sysdef);
         virtual ~Compute() {};
 
-        //! Abstract method that performs the computation
+        //! Performs the computation
         /*! \param timestep Current time step
-            Derived classes will implement this method to calculate their results
+            The execution time is recorded in the StepTimer region of the compute. Derived classes implement
+            doCompute() to calculate their results.
         */
-        virtual void compute(unsigned int timestep){}
+        virtual void compute(unsigned int timestep) final
+            {
+            StepTimerScope timing(m_exec_conf->getStepTimer(), m_timing_region, timestep);
+            doCompute(timestep);
+            }
 
         //! Abstract method that performs a benchmark
         virtual double benchmark(unsigned int num_iters);
@@ -90,6 +99,14 @@ class Compute
         //! Sets the profiler for the compute to use
         void setProfiler(std::shared_ptr<Profiler> prof);
 
+        //! Sets the StepTimer region the compute records its execution time in
+        /*! \param region Id of the region, or StepTimer::NO_REGION to not record the time
+        */
+        void setTimingRegion(unsigned int region)
+            {
+            m_timing_region = region;
+            }
+
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
             \param period period (approximate) in time steps when returning occurs
@@ -126,6 +143,13 @@ class Compute
             {
             return Scalar(0.0);
             }
+
+        //! Get a handle for a log quantity
+        virtual unsigned int getLogHandle(const std::string& quantity);
+
+        //! Calculates the log value of a handle and returns it
+        virtual Scalar getLogValueByHandle(unsigned int handle, unsigned int timestep);
+
         //! Returns a list of log matrix quantities this compute calculates
         /*! The base class implementation just returns an empty vector. Derived classes should override
             this behavior and return a list of quantities that they log.
@@ -182,6 +206,13 @@ class Compute
 #endif
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Stored shared ptr to the execution configuration
         bool m_force_compute;           //!< true if calculation is enforced
+        unsigned int m_timing_region;   //!< StepTimer region that compute() records its time in
+
+        //! Abstract method that performs the computation
+        /*! \param timestep Current time step
+            Derived classes will implement this method to calculate their results
+        */
+        virtual void doCompute(unsigned int timestep){}
 
         //! Simple method for testing if the computation should be run or not
         virtual bool shouldCompute(unsigned int timestep);
@@ -189,6 +220,7 @@ class Compute
     private:
         unsigned int m_last_computed;   //!< Stores the last timestep compute was called
         bool m_first_compute;           //!< true if compute has not yet been called
+        std::vector<std::string> m_log_handle_names; //!< Log quantities by handle (default getLogHandle())
 
         //! The python export needs to be a friend to export shouldCompute()
         friend void export_Compute();
@@ -82,7 +82,7 @@ void ComputeThermo::setNDOF(unsigned int ndof)
 /*! Calls computeProperties if the properties need updating
     \param timestep Current time step of the simulation
 */
-void ComputeThermo::compute(unsigned int timestep)
+void ComputeThermo::doCompute(unsigned int timestep)
     {
     if (!shouldCompute(timestep))
         return;
@@ -104,83 +104,71 @@ std::vector< std::string > ComputeThermo::getProvidedLogQuantities()
 
 Scalar ComputeThermo::getLogValue(const std::string& quantity, unsigned int timestep)
     {
-    compute(timestep);
-    if (quantity == m_logname_list[0])
-        {
-        return getTemperature();
-        }
-    else if (quantity == m_logname_list[1])
-        {
-        return getTranslationalTemperature();
-        }
-    else if (quantity == m_logname_list[2])
-        {
-        return getRotationalTemperature();
-        }
-    else if (quantity == m_logname_list[3])
-        {
-        return getKineticEnergy();
-        }
-    else if (quantity == m_logname_list[4])
-        {
-        return getTranslationalKineticEnergy();
-        }
-    else if (quantity == m_logname_list[5])
-        {
-        return getRotationalKineticEnergy();
-        }
-    else if (quantity == m_logname_list[6])
-        {
-        return getPotentialEnergy();
-        }
-    else if (quantity == m_logname_list[7])
-        {
-        return Scalar(m_ndof + m_ndof_rot);
-        }
-    else if (quantity == m_logname_list[8])
-        {
-        return Scalar(m_ndof);
-        }
-    else if (quantity == m_logname_list[9])
-        {
-        return Scalar(m_ndof_rot);
-        }
-    else if (quantity == m_logname_list[10])
-        {
-        return Scalar(m_group->getNumMembersGlobal());
-        }
-    else if (quantity == m_logname_list[11])
-        {
-        return getPressure();
-        }
-    else if (quantity == m_logname_list[12])
-        {
-        return Scalar(getPressureTensor().xx);
-        }
-    else if (quantity == m_logname_list[13])
-        {
-        return Scalar(getPressureTensor().xy);
-        }
-    else if (quantity == m_logname_list[14])
-        {
-        return Scalar(getPressureTensor().xz);
-        }
-    else if (quantity == m_logname_list[15])
-        {
-        return Scalar(getPressureTensor().yy);
-        }
-    else if (quantity == m_logname_list[16])
-        {
-        return Scalar(getPressureTensor().yz);
-        }
-    else if (quantity == m_logname_list[17])
+    return getLogValueByHandle(getLogHandle(quantity), timestep);
+    }
+
+/*! \param quantity Name of a log quantity
+    \returns The index of \a quantity in m_logname_list
+*/
+unsigned int ComputeThermo::getLogHandle(const std::string& quantity)
+    {
+    for (unsigned int i = 0; i < m_logname_list.size(); i++)
         {
-        return Scalar(getPressureTensor().zz);
+        if (quantity == m_logname_list[i])
+            return i;
         }
-    else
+
+    m_exec_conf->msg->error() << "compute.thermo: " << quantity << " is not a valid log quantity" << endl;
+    throw runtime_error("Error getting log value");
+    }
+
+/*! \param handle Index of the quantity in m_logname_list
+    \param timestep Current time step of the simulation
+*/
+Scalar ComputeThermo::getLogValueByHandle(unsigned int handle, unsigned int timestep)
+    {
+    compute(timestep);
+    switch (handle)
         {
-        m_exec_conf->msg->error() << "compute.thermo: " << quantity << " is not a valid log quantity" << endl;
-        throw runtime_error("Error getting log value");
+        case 0:
+            return getTemperature();
+        case 1:
+            return getTranslationalTemperature();
+        case 2:
+            return getRotationalTemperature();
+        case 3:
+            return getKineticEnergy();
+        case 4:
+            return getTranslationalKineticEnergy();
+        case 5:
+            return getRotationalKineticEnergy();
+        case 6:
+            return getPotentialEnergy();
+        case 7:
+            return Scalar(m_ndof + m_ndof_rot);
+        case 8:
+            return Scalar(m_ndof);
+        case 9:
+            return Scalar(m_ndof_rot);
+        case 10:
+            return Scalar(m_group->getNumMembersGlobal());
+        case 11:
+            return getPressure();
+        case 12:
+            return Scalar(getPressureTensor().xx);
+        case 13:
+            return Scalar(getPressureTensor().xy);
+        case 14:
+            return Scalar(getPressureTensor().xz);
+        case 15:
+            return Scalar(getPressureTensor().yy);
+        case 16:
+            return Scalar(getPressureTensor().yz);
+        case 17:
+            return Scalar(getPressureTensor().zz);
+        default:
+            m_exec_conf->msg->error() << "compute.thermo: " << handle << " is not a valid log handle" << endl;
+            throw runtime_error("Error getting log value");
         }
     }
 
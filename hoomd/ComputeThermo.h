@@ -66,7 +66,7 @@ class ComputeThermo : public Compute
         virtual ~ComputeThermo();
 
         //! Compute the temperature
-        virtual void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
         //! Change the number of degrees of freedom
         void setNDOF(unsigned int ndof);
@@ -77,6 +77,12 @@ class ComputeThermo : public Compute
             return m_ndof;
             }
 
+        //! Get the group over which the properties are computed
+        std::shared_ptr<ParticleGroup> getGroup()
+            {
+            return m_group;
+            }
+
         //! Change the number of degrees of freedom
         void setRotationalNDOF(unsigned int ndof)
             {
@@ -291,6 +297,12 @@ class ComputeThermo : public Compute
         //! Calculates the requested log value and returns it
         virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        //! Get a handle for a log quantity
+        virtual unsigned int getLogHandle(const std::string& quantity);
+
+        //! Calculates the log value of a handle and returns it
+        virtual Scalar getLogValueByHandle(unsigned int handle, unsigned int timestep);
+
         //! Control the enable_logging flag
         /*! Set this flag to false to prevent this compute from providing logged quantities.
             This is useful for internal computes that should not appear in the logs.
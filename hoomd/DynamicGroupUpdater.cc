@@ -0,0 +1,62 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file DynamicGroupUpdater.cc
+    \brief Defines the DynamicGroupUpdater class
+*/
+
+#include "DynamicGroupUpdater.h"
+
+#include <iostream>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System definition containing the particles of the group
+    \param group Group to update
+*/
+DynamicGroupUpdater::DynamicGroupUpdater(std::shared_ptr<SystemDefinition> sysdef,
+                                         std::shared_ptr<ParticleGroup> group)
+    : Updater(sysdef), m_group(group)
+    {
+    assert(m_group);
+    m_exec_conf->msg->notice(5) << "Constructing DynamicGroupUpdater" << endl;
+    }
+
+DynamicGroupUpdater::~DynamicGroupUpdater()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying DynamicGroupUpdater" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void DynamicGroupUpdater::update(unsigned int timestep)
+    {
+    m_exec_conf->msg->notice(10) << "Dynamic group update" << endl;
+    if (m_prof) m_prof->push("Group");
+
+    m_group->updateMemberTags(true);
+
+    // the members of the thermos' groups, or of the integration methods' groups, may have changed
+    if (m_integrator)
+        {
+        for (unsigned int i = 0; i < m_thermos.size(); i++)
+            {
+            std::shared_ptr<ParticleGroup> group = m_thermos[i]->getGroup();
+            m_thermos[i]->setNDOF(m_integrator->getNDOF(group));
+            m_thermos[i]->setRotationalNDOF(m_integrator->getRotationalNDOF(group));
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+void export_DynamicGroupUpdater(py::module& m)
+    {
+    py::class_<DynamicGroupUpdater, std::shared_ptr<DynamicGroupUpdater> >(m,"DynamicGroupUpdater",py::base<Updater>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup> >())
+    .def("setIntegrator", &DynamicGroupUpdater::setIntegrator)
+    .def("addThermo", &DynamicGroupUpdater::addThermo)
+    .def("removeAllThermos", &DynamicGroupUpdater::removeAllThermos);
+    }
@@ -0,0 +1,76 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file DynamicGroupUpdater.h
+    \brief Declares an updater that periodically re-evaluates the membership of a particle group
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "Updater.h"
+#include "ParticleGroup.h"
+#include "Integrator.h"
+#include "ComputeThermo.h"
+
+#include <memory>
+#include <vector>
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __DYNAMICGROUPUPDATER_H__
+#define __DYNAMICGROUPUPDATER_H__
+
+//! Re-evaluates the selection criteria of a particle group
+/*! Every time it is called, the updater builds a new list of member tags for its group from the current state of
+    the system. The selector tests the local particles in a threaded loop. The group must have been constructed from
+    a ParticleSelector.
+
+    The number of degrees of freedom of a group depends on its members, and on the members of the integration
+    methods' groups. After every update, the updater recounts them with the integrator set by setIntegrator() for all
+    thermos added by addThermo().
+
+    \ingroup updaters
+*/
+class DynamicGroupUpdater : public Updater
+    {
+    public:
+        //! Constructor
+        DynamicGroupUpdater(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<ParticleGroup> group);
+
+        //! Destructor
+        virtual ~DynamicGroupUpdater();
+
+        //! Update the group membership
+        virtual void update(unsigned int timestep);
+
+        //! Set the integrator that counts the degrees of freedom
+        void setIntegrator(std::shared_ptr<Integrator> integrator)
+            {
+            m_integrator = integrator;
+            }
+
+        //! Add a thermo whose degrees of freedom are recounted after every update
+        void addThermo(std::shared_ptr<ComputeThermo> thermo)
+            {
+            m_thermos.push_back(thermo);
+            }
+
+        //! Remove all thermos
+        void removeAllThermos()
+            {
+            m_thermos.clear();
+            }
+
+    private:
+        std::shared_ptr<ParticleGroup> m_group;                     //!< The group that is updated
+        std::shared_ptr<Integrator> m_integrator;                   //!< Integrator that counts the degrees of freedom
+        std::vector< std::shared_ptr<ComputeThermo> > m_thermos;    //!< Thermos to recount the degrees of freedom of
+    };
+
+//! Export the DynamicGroupUpdater to python
+void export_DynamicGroupUpdater(pybind11::module& m);
+
+#endif
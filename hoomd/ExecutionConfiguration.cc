@@ -5,6 +5,9 @@
 
 #include "ExecutionConfiguration.h"
 #include "HOOMDVersion.h"
+#include "HostMemoryPool.h"
+#include "StepTimer.h"
+#include "TraceRecorder.h"
 
 
 #ifdef ENABLE_CUDA
@@ -14,6 +17,10 @@
 #ifdef ENABLE_MPI
 #include "HOOMDMPI.h"
 #endif
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 namespace py = pybind11;
 
 #include <stdexcept>
@@ -105,6 +112,13 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
 
     setupStats();
 
+    // initialize the pool for host memory allocations
+    m_host_pool = new HostMemoryPool(msg);
+
+    // initialize the always-on timing of the computes, updaters and analyzers
+    m_step_timer = new StepTimer();
+    m_trace = new TraceRecorder(this);
+
     #ifdef ENABLE_CUDA
     if (exec_mode == GPU)
         {
@@ -178,6 +192,10 @@ ExecutionConfiguration::~ExecutionConfiguration()
         }
     #endif
 
+    delete m_host_pool;
+    delete m_step_timer;
+    delete m_trace;
+
     #ifdef ENABLE_MPI
     // enable Messenger to gracefully finish any MPI-IO
     msg->unsetMPICommunicator();
@@ -668,9 +686,16 @@ void ExecutionConfiguration::setupStats()
 
     if (exec_mode == CPU)
         {
+        #ifdef ENABLE_OPENMP
+        n_cpu = omp_get_max_threads();
+        #endif
+
         ostringstream s;
 
-        s << "HOOMD-blue is running on the CPU" << endl;
+        s << "HOOMD-blue is running on the CPU";
+        if (n_cpu > 1)
+            s << " with " << n_cpu << " threads";
+        s << endl;
         msg->collectiveNoticeStr(1,s.str());
         }
     }
@@ -692,6 +717,9 @@ void export_ExecutionConfiguration(py::module& m)
          .def("isCUDAEnabled", &ExecutionConfiguration::isCUDAEnabled)
          .def("setCUDAErrorChecking", &ExecutionConfiguration::setCUDAErrorChecking)
          .def("getGPUName", &ExecutionConfiguration::getGPUName)
+         .def("getHostMemoryPool", &ExecutionConfiguration::getHostMemoryPool, py::return_value_policy::reference_internal)
+         .def("getStepTimer", &ExecutionConfiguration::getStepTimer, py::return_value_policy::reference_internal)
+         .def("getTraceRecorder", &ExecutionConfiguration::getTraceRecorder, py::return_value_policy::reference_internal)
          .def_readonly("n_cpu", &ExecutionConfiguration::n_cpu)
          .def_readonly("msg", &ExecutionConfiguration::msg)
 #ifdef ENABLE_CUDA
@@ -39,6 +39,10 @@
 class CachedAllocator;
 #endif
 
+class HostMemoryPool;
+class StepTimer;
+class TraceRecorder;
+
 // values used in measuring hoomd launch timing
 extern unsigned int hoomd_launch_time, hoomd_start_time, hoomd_mpi_init_time;
 extern bool hoomd_launch_timing;
@@ -94,7 +98,7 @@ struct ExecutionConfiguration
     int guessLocalRank();
 
     executionMode exec_mode;    //!< Execution mode specified in the constructor
-    unsigned int n_cpu;         //!< Number of CPUS hoomd is executing on
+    unsigned int n_cpu;         //!< Number of CPU threads hoomd is executing on
     bool m_cuda_error_checking;                //!< Set to true if GPU error checking is enabled
     std::shared_ptr<Messenger> msg;          //!< Messenger for use in printing messages to the screen / log file
 
@@ -193,6 +197,24 @@ struct ExecutionConfiguration
         }
     #endif
 
+    //! Returns the pool that backs the host memory of GPUArray
+    HostMemoryPool& getHostMemoryPool() const
+        {
+        return *m_host_pool;
+        }
+
+    //! Returns the timer for the components of a time step
+    StepTimer& getStepTimer() const
+        {
+        return *m_step_timer;
+        }
+
+    //! Returns the recorder for timeline traces
+    TraceRecorder& getTraceRecorder() const
+        {
+        return *m_trace;
+        }
+
     #ifdef ENABLE_CUDA
     //! Returns the cached allocator for temporary allocations
     const CachedAllocator& getCachedAllocator() const
@@ -242,6 +264,10 @@ private:
     CachedAllocator *m_cached_alloc;       //!< Cached allocator for temporary allocations
     #endif
 
+    HostMemoryPool *m_host_pool;           //!< Pool for host memory allocations
+    StepTimer *m_step_timer;               //!< Timer for the components of a time step
+    TraceRecorder *m_trace;                //!< Recorder for timeline traces
+
     //! Setup and print out stats on the chosen CPUs/GPUs
     void setupStats();
     };
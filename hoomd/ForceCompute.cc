@@ -134,7 +134,7 @@ Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
         be done
 */
 
-void ForceCompute::compute(unsigned int timestep)
+void ForceCompute::doCompute(unsigned int timestep)
     {
     // skip if we shouldn't compute this step
     if (!m_particles_sorted && !shouldCompute(timestep))
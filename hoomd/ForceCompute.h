@@ -69,7 +69,7 @@ class ForceCompute : public Compute
         #endif
 
         //! Computes the forces
-        virtual void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
         //! Benchmark the force compute
         virtual double benchmark(unsigned int num_iters);
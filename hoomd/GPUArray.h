@@ -24,12 +24,19 @@
 #endif
 
 #include "ExecutionConfiguration.h"
+#include "HostMemoryPool.h"
 #include <string.h>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
 #include <stdlib.h>
 
+//! Alignment of host memory allocations in bytes
+/*! This is the cache line size of current x86 processors and the width of an AVX-512 register. With it, every host
+    array starts on its own cache line, and so does every row of a 2D array whose pitch is a multiple of 64 bytes.
+*/
+const size_t GPUARRAY_HOST_ALIGNMENT = 64;
+
 //! Specifies where to acquire the data
 struct access_location
     {
@@ -317,6 +324,10 @@ template<class T> class GPUArray
         inline void allocate();
         //! Helper function to free memory
         inline void deallocate();
+        //! Helper function to allocate aligned host memory
+        inline T* allocateHostMemory(size_t num_bytes);
+        //! Helper function to release host memory
+        inline void freeHostMemory(T* ptr);
 
 #ifdef ENABLE_CUDA
         //! Helper function to copy memory from the device to host
@@ -618,14 +629,7 @@ template<class T> void GPUArray<T>::allocate()
     assert(h_data == NULL);
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_data, 32, m_num_elements*sizeof(T));
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    h_data = allocateHostMemory(m_num_elements*sizeof(T));
 
 #ifdef ENABLE_CUDA
     assert(d_data == NULL);
@@ -679,7 +683,7 @@ template<class T> void GPUArray<T>::deallocate()
         }
 #endif
 
-    free(h_data);
+    freeHostMemory(h_data);
 
     // set pointers to NULL
     h_data = NULL;
@@ -688,6 +692,40 @@ template<class T> void GPUArray<T>::deallocate()
 #endif
     }
 
+/*! \param num_bytes Number of bytes to allocate
+    \returns Pointer to the host memory, aligned to at least GPUARRAY_HOST_ALIGNMENT bytes
+
+    Memory is taken from the HostMemoryPool of the execution configuration, or from posix_memalign when there is
+    none.
+*/
+template<class T> T* GPUArray<T>::allocateHostMemory(size_t num_bytes)
+    {
+    void *ptr = NULL;
+    if (m_exec_conf)
+        ptr = m_exec_conf->getHostMemoryPool().allocate(num_bytes);
+    else if (posix_memalign(&ptr, GPUARRAY_HOST_ALIGNMENT, num_bytes) != 0)
+        ptr = NULL;
+
+    if (ptr == NULL)
+        {
+        if (m_exec_conf)
+            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
+        throw std::runtime_error("Error allocating GPUArray.");
+        }
+
+    return (T*)ptr;
+    }
+
+/*! \param ptr Host memory obtained from allocateHostMemory()
+*/
+template<class T> void GPUArray<T>::freeHostMemory(T* ptr)
+    {
+    if (m_exec_conf)
+        m_exec_conf->getHostMemoryPool().deallocate(ptr);
+    else
+        free(ptr);
+    }
+
 /*! \pre allocate() has been called
     \post All allocated memory is set to 0
 */
@@ -957,14 +995,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
     T *h_tmp = NULL;
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_tmp, 32, num_elements*sizeof(T));
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    h_tmp = allocateHostMemory(num_elements*sizeof(T));
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -988,7 +1019,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
         }
 #endif
 
-    free(h_data);
+    freeHostMemory(h_data);
     h_data = h_tmp;
 
 #ifdef ENABLE_CUDA
@@ -1010,15 +1041,8 @@ template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned
     T *h_tmp = NULL;
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
     unsigned int size = new_pitch*new_height*sizeof(T);
-    int retval = posix_memalign((void**)&h_tmp, 32, size);
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    h_tmp = allocateHostMemory(size);
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -1046,7 +1070,7 @@ template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned
         }
 #endif
 
-    free(h_data);
+    freeHostMemory(h_data);
     h_data = h_tmp;
 
 #ifdef ENABLE_CUDA
@@ -0,0 +1,264 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file HostMemoryPool.cc
+    \brief Defines the HostMemoryPool class
+*/
+
+#include "HostMemoryPool.h"
+#include "Messenger.h"
+
+#include <stdlib.h>
+#include <cassert>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace py = pybind11;
+
+using namespace std;
+
+//! Alignment of blocks smaller than a huge page
+const size_t HOST_POOL_ALIGNMENT = 64;
+
+HostMemoryPool::HostMemoryPool(std::shared_ptr<Messenger> msg, size_t max_cached_bytes, float cache_reltol)
+    : m_msg(msg), m_max_cached_bytes(max_cached_bytes), m_cache_reltol(cache_reltol),
+      m_huge_page_mode(transparent), m_hugetlb_warned(false), m_num_allocations(0), m_num_cache_hits(0),
+      m_num_system_allocations(0), m_bytes_in_use(0), m_peak_bytes_in_use(0), m_bytes_cached(0),
+      m_huge_page_bytes(0)
+    {
+    }
+
+HostMemoryPool::~HostMemoryPool()
+    {
+    m_msg->notice(5) << "HostMemoryPool: " << m_num_allocations << " allocations, " << m_num_cache_hits
+                     << " served from the cache" << endl;
+
+    // outstanding blocks belong to arrays that outlive the pool, leave them alone
+    if (m_allocated_blocks.size())
+        m_msg->notice(5) << "HostMemoryPool: " << m_allocated_blocks.size() << " blocks still in use" << endl;
+
+    releaseCached();
+    }
+
+/*! \param num_bytes Number of bytes to allocate
+    \returns Pointer to the block, or NULL if the system is out of memory
+
+    The block is aligned to at least 64 bytes. Its contents are undefined.
+*/
+void *HostMemoryPool::allocate(size_t num_bytes)
+    {
+    // round up to full cache lines, and to full huge pages for large blocks
+    if (num_bytes == 0)
+        num_bytes = HOST_POOL_ALIGNMENT;
+    num_bytes = (num_bytes + HOST_POOL_ALIGNMENT - 1) / HOST_POOL_ALIGNMENT * HOST_POOL_ALIGNMENT;
+    if (num_bytes >= hugePageSize())
+        num_bytes = (num_bytes + hugePageSize() - 1) / hugePageSize() * hugePageSize();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_num_allocations++;
+
+    char *result = NULL;
+    Block block;
+
+    // look for a cached block within the relative tolerance
+    free_blocks_type::iterator free_block = m_free_blocks.lower_bound(num_bytes);
+    if (free_block != m_free_blocks.end()
+        && free_block->first <= num_bytes + (size_t)((float)num_bytes*m_cache_reltol))
+        {
+        result = free_block->second.first;
+        block = free_block->second.second;
+        m_free_blocks.erase(free_block);
+        m_bytes_cached -= block.num_bytes;
+        m_num_cache_hits++;
+        }
+    else
+        {
+        result = systemAllocate(num_bytes, block);
+
+        // release cached blocks once the system allocation fails, and try again
+        if (result == NULL && m_free_blocks.size())
+            {
+            m_msg->notice(5) << "HostMemoryPool: allocation of " << float(num_bytes)/1024.0f/1024.0f
+                             << " MB failed, releasing the cache" << endl;
+            size_t max_cached_bytes = m_max_cached_bytes;
+            m_max_cached_bytes = 0;
+            trimCache();
+            m_max_cached_bytes = max_cached_bytes;
+            result = systemAllocate(num_bytes, block);
+            }
+
+        if (result == NULL)
+            return NULL;
+        }
+
+    m_allocated_blocks.insert(std::make_pair(result, block));
+    m_bytes_in_use += block.num_bytes;
+    if (m_bytes_in_use > m_peak_bytes_in_use)
+        m_peak_bytes_in_use = m_bytes_in_use;
+
+    return result;
+    }
+
+/*! \param ptr Pointer previously returned by allocate()
+
+    The block is kept in the cache for later requests. Passing a pointer that the pool did not allocate, or that was
+    already returned, is an error.
+*/
+void HostMemoryPool::deallocate(void *ptr)
+    {
+    if (ptr == NULL)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    allocated_blocks_type::iterator iter = m_allocated_blocks.find((char *)ptr);
+    if (iter == m_allocated_blocks.end())
+        {
+        m_msg->error() << "HostMemoryPool: deallocating a pointer that is not in use by the pool" << endl;
+        throw runtime_error("Error deallocating host memory");
+        }
+
+    Block block = iter->second;
+    m_allocated_blocks.erase(iter);
+    m_bytes_in_use -= block.num_bytes;
+
+    m_free_blocks.insert(std::make_pair(block.num_bytes, std::make_pair((char *)ptr, block)));
+    m_bytes_cached += block.num_bytes;
+
+    trimCache();
+    }
+
+void HostMemoryPool::releaseCached()
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (free_blocks_type::iterator i = m_free_blocks.begin(); i != m_free_blocks.end(); ++i)
+        systemFree(i->second.first, i->second.second);
+
+    m_free_blocks.clear();
+    m_bytes_cached = 0;
+    }
+
+/*! \param max_cached_bytes Maximum number of bytes kept in the cache
+*/
+void HostMemoryPool::setMaxCachedBytes(size_t max_cached_bytes)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_cached_bytes = max_cached_bytes;
+    trimCache();
+    }
+
+/*! \param num_bytes Size of the block (already rounded)
+    \param block Descriptor to fill out
+    \returns Pointer to the new block, or NULL on failure
+*/
+char *HostMemoryPool::systemAllocate(size_t num_bytes, Block& block)
+    {
+    block.num_bytes = num_bytes;
+    block.huge = false;
+    block.mapped = false;
+
+    m_msg->notice(10) << "HostMemoryPool: allocating " << float(num_bytes)/1024.0f/1024.0f << " MB" << endl;
+
+    bool huge = num_bytes >= hugePageSize() && m_huge_page_mode != none;
+    void *ptr = NULL;
+
+    #if defined(__linux__) && defined(MAP_HUGETLB)
+    if (huge && m_huge_page_mode == hugetlb)
+        {
+        ptr = mmap(NULL, num_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+            {
+            block.huge = block.mapped = true;
+            m_huge_page_bytes += num_bytes;
+            m_num_system_allocations++;
+            return (char *)ptr;
+            }
+
+        ptr = NULL;
+        if (!m_hugetlb_warned)
+            {
+            m_msg->warning() << "No explicit huge pages available, falling back to transparent huge pages" << endl;
+            m_hugetlb_warned = true;
+            }
+        }
+    #endif
+
+    if (posix_memalign(&ptr, huge ? hugePageSize() : HOST_POOL_ALIGNMENT, num_bytes) != 0)
+        return NULL;
+
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (huge && madvise(ptr, num_bytes, MADV_HUGEPAGE) == 0)
+        {
+        block.huge = true;
+        m_huge_page_bytes += num_bytes;
+        }
+    #endif
+
+    m_num_system_allocations++;
+    return (char *)ptr;
+    }
+
+/*! \param ptr Block to release
+    \param block Descriptor of the block
+*/
+void HostMemoryPool::systemFree(char *ptr, const Block& block)
+    {
+    if (block.huge)
+        m_huge_page_bytes -= block.num_bytes;
+
+    #ifdef __linux__
+    if (block.mapped)
+        {
+        munmap(ptr, block.num_bytes);
+        return;
+        }
+    #endif
+
+    free(ptr);
+    }
+
+void HostMemoryPool::trimCache()
+    {
+    // release the largest blocks first
+    while (m_bytes_cached > m_max_cached_bytes && m_free_blocks.size())
+        {
+        free_blocks_type::iterator i = --m_free_blocks.end();
+
+        m_msg->notice(10) << "HostMemoryPool: maximum cache size reached, releasing "
+                          << float(i->first)/1024.0f/1024.0f << " MB" << endl;
+
+        systemFree(i->second.first, i->second.second);
+        m_bytes_cached -= i->first;
+        m_free_blocks.erase(i);
+        }
+    }
+
+void export_HostMemoryPool(py::module& m)
+    {
+    py::class_<HostMemoryPool> hostmemorypool(m, "HostMemoryPool");
+    hostmemorypool.def("setHugePageMode", &HostMemoryPool::setHugePageMode)
+        .def("getHugePageMode", &HostMemoryPool::getHugePageMode)
+        .def("setMaxCachedBytes", &HostMemoryPool::setMaxCachedBytes)
+        .def("getMaxCachedBytes", &HostMemoryPool::getMaxCachedBytes)
+        .def("releaseCached", &HostMemoryPool::releaseCached)
+        .def("getNumAllocations", &HostMemoryPool::getNumAllocations)
+        .def("getNumCacheHits", &HostMemoryPool::getNumCacheHits)
+        .def("getNumSystemAllocations", &HostMemoryPool::getNumSystemAllocations)
+        .def("getBytesInUse", &HostMemoryPool::getBytesInUse)
+        .def("getPeakBytesInUse", &HostMemoryPool::getPeakBytesInUse)
+        .def("getBytesCached", &HostMemoryPool::getBytesCached)
+        .def("getHugePageBytes", &HostMemoryPool::getHugePageBytes)
+        ;
+
+    py::enum_<HostMemoryPool::hugePageMode>(hostmemorypool, "hugePageMode")
+        .value("none", HostMemoryPool::hugePageMode::none)
+        .value("transparent", HostMemoryPool::hugePageMode::transparent)
+        .value("hugetlb", HostMemoryPool::hugePageMode::hugetlb)
+        .export_values()
+        ;
+    }
@@ -0,0 +1,204 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file HostMemoryPool.h
+    \brief Declares the HostMemoryPool class
+*/
+
+#ifndef __HOST_MEMORY_POOL_H__
+#define __HOST_MEMORY_POOL_H__
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <cstddef>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+class Messenger;
+
+//! Pooled allocator for host memory
+/*! HostMemoryPool backs the host side of GPUArray and GPUVector. ExecutionConfiguration owns one instance.
+
+    Freed blocks are kept in a cache and handed out again for later requests of nearly the same size (within a
+    relative tolerance). Arrays that are sized by the number of particles are resized and reallocated together
+    after migration and ghost exchange, so most of these requests are served from the cache without a call
+    into the system allocator. When the cache grows beyond its maximum size, the largest cached blocks are released.
+
+    Blocks of at least hugePageSize() bytes are rounded up to a multiple of the huge page size and aligned to it.
+    Depending on the huge page mode, they are then backed by huge pages to reduce TLB misses when large per
+    particle arrays are streamed through:
+     - \c none: no special treatment
+     - \c transparent: transparent huge pages are requested with madvise()
+     - \c hugetlb: explicit huge pages are mapped with mmap(MAP_HUGETLB). If none are available (see
+       /proc/sys/vm/nr_hugepages), the pool warns once and falls back to transparent huge pages
+
+    Huge pages are only supported on Linux. On other platforms the mode has no effect.
+
+    All other blocks are aligned to 64 byte cache lines. HostMemoryPool is thread safe, including the statistics
+    getters.
+*/
+class HostMemoryPool
+    {
+    public:
+        //! Huge page modes
+        enum hugePageMode
+            {
+            none,           //!< Do not use huge pages
+            transparent,    //!< Request transparent huge pages for large blocks
+            hugetlb         //!< Map large blocks from the explicit huge page pool
+            };
+
+        //! Constructor
+        /*! \param msg Messenger for diagnostic output
+            \param max_cached_bytes Maximum number of bytes kept in the cache
+            \param cache_reltol Relative tolerance for cache hits
+        */
+        HostMemoryPool(std::shared_ptr<Messenger> msg,
+                       size_t max_cached_bytes=256u*1024u*1024u,
+                       float cache_reltol=0.1f);
+
+        //! Destructor
+        ~HostMemoryPool();
+
+        //! Allocate a block of host memory
+        void *allocate(size_t num_bytes);
+
+        //! Return a block to the pool
+        void deallocate(void *ptr);
+
+        //! Release all cached blocks to the system
+        void releaseCached();
+
+        //! Set the huge page mode
+        /*! \param mode New mode
+            The mode applies to blocks allocated from the system after the call.
+        */
+        void setHugePageMode(hugePageMode mode)
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_huge_page_mode = mode;
+            }
+
+        //! Get the huge page mode
+        hugePageMode getHugePageMode() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_huge_page_mode;
+            }
+
+        //! Set the maximum cache size
+        void setMaxCachedBytes(size_t max_cached_bytes);
+
+        //! Get the maximum cache size
+        size_t getMaxCachedBytes() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_max_cached_bytes;
+            }
+
+        //! Get the huge page size in bytes
+        static size_t hugePageSize()
+            {
+            return 2*1024*1024;
+            }
+
+        //! Get the number of allocation requests
+        unsigned long long getNumAllocations() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_num_allocations;
+            }
+
+        //! Get the number of allocation requests served from the cache
+        unsigned long long getNumCacheHits() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_num_cache_hits;
+            }
+
+        //! Get the number of blocks allocated from the system
+        unsigned long long getNumSystemAllocations() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_num_system_allocations;
+            }
+
+        //! Get the number of bytes handed out and not yet returned
+        size_t getBytesInUse() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bytes_in_use;
+            }
+
+        //! Get the largest number of bytes in use at any time
+        size_t getPeakBytesInUse() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_peak_bytes_in_use;
+            }
+
+        //! Get the number of bytes held in the cache
+        size_t getBytesCached() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bytes_cached;
+            }
+
+        //! Get the number of bytes (in use or cached) backed by huge pages
+        size_t getHugePageBytes() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_huge_page_bytes;
+            }
+
+    private:
+        //! A block of memory owned by the pool
+        struct Block
+            {
+            size_t num_bytes;   //!< Size of the block
+            bool huge;          //!< True if huge pages were requested for the block
+            bool mapped;        //!< True if the block was mapped with mmap()
+            };
+
+        typedef std::multimap<size_t, std::pair<char *, Block> > free_blocks_type;
+        typedef std::map<char *, Block> allocated_blocks_type;
+
+        std::shared_ptr<Messenger> m_msg;   //!< Messenger for diagnostic output
+        size_t m_max_cached_bytes;          //!< Maximum number of bytes in the cache
+        float m_cache_reltol;               //!< Relative tolerance for cache hits
+        hugePageMode m_huge_page_mode;      //!< Huge page mode for new blocks
+        bool m_hugetlb_warned;              //!< True after the warning about missing explicit huge pages
+
+        free_blocks_type m_free_blocks;             //!< Cached blocks sorted by size
+        allocated_blocks_type m_allocated_blocks;   //!< Blocks in use
+
+        unsigned long long m_num_allocations;           //!< Number of allocation requests
+        unsigned long long m_num_cache_hits;            //!< Number of requests served from the cache
+        unsigned long long m_num_system_allocations;    //!< Number of blocks allocated from the system
+        size_t m_bytes_in_use;                          //!< Bytes handed out
+        size_t m_peak_bytes_in_use;                     //!< Peak of m_bytes_in_use
+        size_t m_bytes_cached;                          //!< Bytes in the cache
+        size_t m_huge_page_bytes;                       //!< Bytes in blocks backed by huge pages
+
+        mutable std::mutex m_mutex;         //!< Protects all members
+
+        //! Allocate a new block from the system
+        char *systemAllocate(size_t num_bytes, Block& block);
+
+        //! Return a block to the system
+        void systemFree(char *ptr, const Block& block);
+
+        //! Release cached blocks until the cache fits its maximum size
+        void trimCache();
+    };
+
+//! Exports HostMemoryPool to python
+void export_HostMemoryPool(pybind11::module& m);
+
+#endif
@@ -12,6 +12,8 @@
 #include "Communicator.h"
 #endif
 
+#include <algorithm>
+
 namespace py = pybind11;
 
 using namespace std;
@@ -47,11 +49,8 @@ void LogHDF5::analyze(unsigned int timestep)
     assert( numpy_array_buf.shape[0] == m_logged_quantities.size());
     assert( numpy_array_buf.itemsize == sizeof(Scalar));
     Scalar*const numpy_array_data = static_cast<Scalar*>(numpy_array_buf.ptr);
-    //Prepare non-matrix data in a single array.
-    for(unsigned int i=0; i < m_logged_quantities.size(); i++)
-        {
-        numpy_array_data[i] = this->getQuantity(m_logged_quantities[i],timestep,true);
-        }
+    //Prepare non-matrix data in a single array. The cached values are in the order of m_logged_quantities.
+    std::copy(m_cached_quantities.begin(), m_cached_quantities.end(), numpy_array_data);
 
     //Call the python function, which manages the prepared data and writes it to disk.
     m_python_analyze(timestep);
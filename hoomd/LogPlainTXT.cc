@@ -33,12 +33,14 @@ LogPlainTXT::LogPlainTXT(std::shared_ptr<SystemDefinition> sysdef,
                          const std::string& header_prefix,
                          bool overwrite)
     : Logger(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite),
-                        m_is_initialized(false), m_file_output(true)
+                        m_is_initialized(false), m_file_output(true), m_last_flush(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing LogPlainTXT: " << fname << " " << header_prefix << " " << overwrite << endl;
 
     if (m_filename == string(""))
         m_file_output=false;
+
+    m_buffer << setprecision(10);
     }
 
 void LogPlainTXT::openOutputFiles()
@@ -76,6 +78,32 @@ void LogPlainTXT::openOutputFiles()
 LogPlainTXT::~LogPlainTXT()
     {
     m_exec_conf->msg->notice(5) << "Destroying LogPlainTXT" << endl;
+
+    // write out the remaining rows, but do not throw from the destructor
+    if (m_file.is_open() && m_buffer.tellp() > 0)
+        {
+        m_file << m_buffer.str();
+        m_file.flush();
+        }
+    }
+
+/*! Writes the buffered rows to the file and flushes it.
+*/
+void LogPlainTXT::flush()
+    {
+    if (!m_file.is_open() || m_buffer.tellp() == 0)
+        return;
+
+    m_file << m_buffer.str();
+    m_file.flush();
+    m_buffer.str("");
+    m_last_flush = m_clk.getTime();
+
+    if (!m_file.good())
+        {
+        m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
+        throw runtime_error("Error writting log file");
+        }
     }
 
 /*! \param delimiter Delimiter to place between columns in the output file
@@ -112,29 +140,27 @@ void LogPlainTXT::analyze(unsigned int timestep)
 #endif
 
     // The timestep is always output
-    m_file << setprecision(10) << timestep;
+    m_buffer << timestep;
 
     // quit now if there is nothing to log
     if (m_logged_quantities.size() == 0)
         {
+        if (m_prof) m_prof->pop();
         return;
         }
 
     // only print the delimiter after the timestep if there are more quantities logged
-    m_file << m_delimiter;
+    m_buffer << m_delimiter;
 
     // write all but the last of the quantities separated by the delimiter
     for (unsigned int i = 0; i < m_logged_quantities.size()-1; i++)
-        m_file << setprecision(10) << m_cached_quantities[i] << m_delimiter;
+        m_buffer << m_cached_quantities[i] << m_delimiter;
     // write the last one with no delimiter after it
-    m_file << setprecision(10) << m_cached_quantities[m_logged_quantities.size()-1] << endl;
-    m_file.flush();
+    m_buffer << m_cached_quantities[m_logged_quantities.size()-1] << '\n';
 
-    if (!m_file.good())
-        {
-        m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
-        throw runtime_error("Error writting log file");
-        }
+    // write out the rows in blocks, but at least once per second
+    if (size_t(m_buffer.tellp()) >= flush_bytes || m_clk.getTime() - m_last_flush >= int64_t(1000000000))
+        flush();
 
     if (m_prof) m_prof->pop();
     }
@@ -164,6 +190,9 @@ void LogPlainTXT::setLoggedQuantities(const std::vector< std::string >& quantiti
 
     m_is_initialized = true;
 
+    // rows logged so far come before the new header
+    flush();
+
     // only write the header if this is a new file
     if (!m_appending && m_file_output)
         {
@@ -11,6 +11,8 @@
 
 #include "Logger.h"
 
+#include <sstream>
+
 #ifndef __LOGPLAINTXT_H__
 #define __LOGPLAINTXT_H__
 
@@ -33,6 +35,10 @@
     As an option, Logger can be initialized with no file. Such a logger will skip doing anything during
     analyze() but is still available for getQuantity() operations.
 
+    Rows are formatted into a buffer and written to the file in blocks, when the buffer holds more than
+    flush_bytes, when more than a second passed since the last write, at the end of every run (flush()), and on
+    destruction. This avoids a write and flush system call for every logged time step.
+
     \ingroup analyzers
 */
 class LogPlainTXT : public Logger
@@ -56,7 +62,13 @@ class LogPlainTXT : public Logger
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Write the buffered rows to the file
+        virtual void flush();
+
     private:
+        //! Size of the row buffer in bytes above which it is written to the file
+        static const size_t flush_bytes = 65536;
+
         //! The delimiter to put between columns in the file
         std::string m_delimiter;
         //! The output file name
@@ -71,6 +83,10 @@ class LogPlainTXT : public Logger
         bool m_is_initialized;
         //! true if we are writing to the output file
         bool m_file_output;
+        //! Rows that have not been written to the file yet
+        std::ostringstream m_buffer;
+        //! Time of the last write to the file
+        int64_t m_last_flush;
 
         //! Helper function to open output files
         void openOutputFiles();
@@ -24,7 +24,7 @@ using namespace std;
 /*! \param sysdef Specified for Analyzer, but not used directly by Logger
 */
 Logger::Logger(std::shared_ptr<SystemDefinition> sysdef)
-    : Analyzer(sysdef)
+    : Analyzer(sysdef), m_cached_timestep(-1), m_sources_valid(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Logger: " << endl;
     }
@@ -56,6 +56,8 @@ void Logger::registerCompute(std::shared_ptr<Compute> compute)
         m_compute_quantities[provided_quantities[i]] = compute;
         m_exec_conf->msg->notice(6) << "analyze.log: Registering log quantity " << provided_quantities[i] << endl;
         }
+
+    m_sources_valid = false;
     }
 
 /*! \param updater The Updater to register
@@ -79,6 +81,8 @@ void Logger::registerUpdater(std::shared_ptr<Updater> updater)
                  " has been registered more than once. Only the most recent registration takes effect" << endl;
         m_updater_quantities[provided_quantities[i]] = updater;
         }
+
+    m_sources_valid = false;
     }
 
 /*! \param name Name of the quantity
@@ -97,6 +101,7 @@ void Logger::registerCallback(std::string name, py::object callback)
     m_exec_conf->msg->warning() << "analyze.log: The log quantity " << name <<
                          " has been registered more than once. Only the most recent registration takes effect" << endl;
     m_callback_quantities[name] = callback;
+    m_sources_valid = false;
     }
 
 /*! After calling removeAll(), no quantities are registered for logging
@@ -105,6 +110,7 @@ void Logger::removeAll()
     {
     m_compute_quantities.clear();
     m_updater_quantities.clear();
+    m_sources_valid = false;
     //The callbacks are intentionally not cleared, because before each
     //run all compute and updaters should be cleared, but the python
     //callbacks should not be cleared for this.
@@ -122,6 +128,7 @@ void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
     // prepare or adjust storage for caching the logger properties.
     m_cached_timestep = -1;
     m_cached_quantities.resize(quantities.size());
+    m_sources_valid = false;
     }
 
 /*! \param timestep Time step to write out data for
@@ -134,10 +141,7 @@ void Logger::analyze(unsigned int timestep)
     if (m_prof) m_prof->push("Log");
 
     // update info in cache for later use and for immediate output.
-    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
-        m_cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
-
-    m_cached_timestep = timestep;
+    updateCache(timestep);
 
     if (m_prof) m_prof->pop();
     }
@@ -148,11 +152,7 @@ Scalar Logger::getQuantity(const std::string &quantity, unsigned int timestep, b
     {
     // update info in cache for later use
     if (!use_cache && timestep != m_cached_timestep)
-        {
-        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
-            m_cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
-        m_cached_timestep = timestep;
-        }
+        updateCache(timestep);
 
     // first see if it is the timestep number
     if (quantity == "timestep")
@@ -169,6 +169,115 @@ Scalar Logger::getQuantity(const std::string &quantity, unsigned int timestep, b
     return Scalar(0.0);
     }
 
+/*! \param timestep Time step to compute the values for
+*/
+void Logger::updateCache(unsigned int timestep)
+    {
+    if (!m_sources_valid)
+        resolveSources();
+
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        m_cached_quantities[i] = getSourceValue(i, timestep);
+
+    m_cached_timestep = timestep;
+    }
+
+/*! Looks up the logged quantities in the same order as getValue(). Quantities that are not registered are looked
+    up again on every call, which also prints the warning every time.
+*/
+void Logger::resolveSources()
+    {
+    StepTimer& timer = m_exec_conf->getStepTimer();
+
+    m_sources.resize(m_logged_quantities.size());
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        {
+        const std::string& quantity = m_logged_quantities[i];
+        LogSource& src = m_sources[i];
+        src.kind = LogSource::src_unresolved;
+        src.compute = NULL;
+        src.updater = NULL;
+        src.callback = NULL;
+        src.handle = 0;
+
+        std::map< std::string, std::shared_ptr<Compute> >::iterator compute = m_compute_quantities.find(quantity);
+        std::map< std::string, std::shared_ptr<Updater> >::iterator updater = m_updater_quantities.find(quantity);
+        std::map< std::string, py::object >::iterator callback = m_callback_quantities.find(quantity);
+
+        if (quantity == "time")
+            {
+            src.kind = LogSource::src_clock;
+            }
+        else if (compute != m_compute_quantities.end())
+            {
+            src.kind = LogSource::src_compute;
+            src.compute = compute->second.get();
+            src.handle = src.compute->getLogHandle(quantity);
+            }
+        else if (updater != m_updater_quantities.end())
+            {
+            src.kind = LogSource::src_updater;
+            src.updater = updater->second.get();
+            }
+        else if (callback != m_callback_quantities.end())
+            {
+            src.kind = LogSource::src_callback;
+            src.callback = &callback->second;
+            }
+        else if (quantity.compare(0, 5, "time_") == 0
+                 && timer.findRegion(quantity.substr(5)) != StepTimer::NO_REGION)
+            {
+            src.kind = LogSource::src_timer;
+            src.handle = timer.findRegion(quantity.substr(5));
+            }
+        }
+
+    m_sources_valid = true;
+    }
+
+/*! \param i Index of the logged quantity
+    \param timestep Time step to compute value for (needed for Compute classes)
+*/
+Scalar Logger::getSourceValue(unsigned int i, unsigned int timestep)
+    {
+    const LogSource& src = m_sources[i];
+    switch (src.kind)
+        {
+        case LogSource::src_clock:
+            return Scalar(double(m_clk.getTime())/1e9);
+        case LogSource::src_compute:
+            src.compute->compute(timestep);
+            return src.compute->getLogValueByHandle(src.handle, timestep);
+        case LogSource::src_updater:
+            return src.updater->getLogValue(m_logged_quantities[i], timestep);
+        case LogSource::src_callback:
+            return getCallbackValue(m_logged_quantities[i], *src.callback, timestep);
+        case LogSource::src_timer:
+            return Scalar(m_exec_conf->getStepTimer().getMeanTime(src.handle));
+        default:
+            return getValue(m_logged_quantities[i], timestep);
+        }
+    }
+
+/*! \param quantity Name of the quantity
+    \param callback Python callback that produces the quantity
+    \param timestep Time step to pass to the callback
+*/
+Scalar Logger::getCallbackValue(const std::string &quantity, py::object& callback, unsigned int timestep)
+    {
+    try
+        {
+        py::object rv = callback(timestep);
+        Scalar extracted_rv = rv.cast<Scalar>();
+        return extracted_rv;
+        }
+    catch (py::cast_error)
+        {
+            m_exec_conf->msg->warning() << "analyze.log: Log callback " << quantity << " returned invalid value, logging 0." << endl;
+            return Scalar(0.0);
+        }
+    }
+
 /*! \param quantity Quantity to get
     \param timestep Time step to compute value for (needed for Compute classes)
 */
@@ -196,17 +305,14 @@ Scalar Logger::getValue(const std::string &quantity, int timestep)
     else if (m_callback_quantities.count(quantity))
         {
         // get a quantity from a callback
-        try
-            {
-            py::object rv = m_callback_quantities[quantity](timestep);
-            Scalar extracted_rv = rv.cast<Scalar>();
-            return extracted_rv;
-            }
-        catch (py::cast_error)
-            {
-                m_exec_conf->msg->warning() << "analyze.log: Log callback " << quantity << " returned invalid value, logging 0." << endl;
-                return Scalar(0.0);
-            }
+        return getCallbackValue(quantity, m_callback_quantities[quantity], timestep);
+        }
+    // check to see if the quantity is the time spent in a StepTimer region
+    else if (quantity.compare(0, 5, "time_") == 0
+             && m_exec_conf->getStepTimer().findRegion(quantity.substr(5)) != StepTimer::NO_REGION)
+        {
+        StepTimer& timer = m_exec_conf->getStepTimer();
+        return Scalar(timer.getMeanTime(timer.findRegion(quantity.substr(5))));
         }
     else
         {
@@ -40,6 +40,13 @@
     log. Every call to analyze() will result in the computes for the
     logged quantities being called.
 
+    Quantities named time_<region> return the mean time per step of the StepTimer region of that name.
+
+    The source of every logged quantity is looked up by name only once, after the logged quantities or the
+    registrations change. Compute quantities are then read through the handles of Compute::getLogHandle(), which
+    lets computes that provide many quantities (such as ComputeThermo) skip string comparisons. The values of one
+    time step are stored in m_cached_quantities, one column per logged quantity, for derived classes to write out.
+
     The removeAll method can be used to clear all registered computes and updaters. hoomd_script will
     removeAll() and re-register all active computes and updaters before every run()
 
@@ -107,9 +114,45 @@ class Logger : public Analyzer
         //! The values of the logged quantities at the last logger update.
         std::vector< Scalar > m_cached_quantities;
 
+        //! Store the values of all logged quantities at the given time step in m_cached_quantities
+        void updateCache(unsigned int timestep);
+
     private:
+        //! Source of a logged quantity
+        struct LogSource
+            {
+            //! Kinds of sources
+            enum Kind
+                {
+                src_unresolved,     //!< Not registered when resolved, looked up by name on every call
+                src_clock,          //!< The built-in time quantity
+                src_compute,        //!< A quantity of a Compute
+                src_updater,        //!< A quantity of an Updater
+                src_callback,       //!< A python callback
+                src_timer           //!< The mean time of a StepTimer region
+                };
+
+            Kind kind;                          //!< Kind of the source
+            Compute *compute;                   //!< The compute (src_compute)
+            Updater *updater;                   //!< The updater (src_updater)
+            pybind11::object *callback;         //!< The callback in m_callback_quantities (src_callback)
+            unsigned int handle;                //!< Log handle of the compute or StepTimer region
+            };
+
+        std::vector<LogSource> m_sources;   //!< Source of each logged quantity
+        bool m_sources_valid;               //!< False when m_sources needs to be resolved again
+
+        //! Look up the source of every logged quantity
+        void resolveSources();
+
+        //! Helper function to get a value from the source of a logged quantity
+        Scalar getSourceValue(unsigned int i, unsigned int timestep);
+
         //! Helper function to get a value for a given quantity
         Scalar getValue(const std::string &quantity, int timestep);
+
+        //! Helper function to get a value from a python callback
+        Scalar getCallbackValue(const std::string &quantity, pybind11::object& callback, unsigned int timestep);
     };
 
 //! exports the Logger class to python
@@ -101,6 +101,12 @@ class ManagedArray
             return data[i];
             }
 
+        //! Get the number of elements
+        HOSTDEVICE unsigned int size() const
+            {
+            return N;
+            }
+
         //! Get pointer to array data
         HOSTDEVICE T * get()
             {
@@ -55,10 +55,18 @@ namespace py = pybind11;
 */
 ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned int n_types, std::shared_ptr<ExecutionConfiguration> exec_conf, std::shared_ptr<DomainDecomposition> decomposition)
         : m_exec_conf(exec_conf),
+          m_reorder_known(false),
+          m_reorder_map(NULL),
+          m_reorder_n_old(0),
+          m_reorder_first_new(0),
           m_nparticles(0),
           m_nghosts(0),
           m_max_nparticles(0),
           m_nglobal(0),
+          m_soa(false),
+          m_soa_n(0),
+          m_soa_pos_state(soa_stale),
+          m_soa_vel_state(soa_stale),
           m_resize_factor(9./8.)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
@@ -130,10 +138,18 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
                            std::shared_ptr<DomainDecomposition> decomposition
                           )
     : m_exec_conf(exec_conf),
+      m_reorder_known(false),
+      m_reorder_map(NULL),
+      m_reorder_n_old(0),
+      m_reorder_first_new(0),
       m_nparticles(0),
       m_nghosts(0),
       m_max_nparticles(0),
       m_nglobal(0),
+      m_soa(false),
+      m_soa_n(0),
+      m_soa_pos_state(soa_stale),
+      m_soa_vel_state(soa_stale),
       m_resize_factor(9./8.)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
@@ -234,6 +250,30 @@ void ParticleData::notifyParticleSort()
     m_sort_signal.emit();
     }
 
+/*! \param new_idx New index of every particle that was local before the rearrangement (NOT_LOCAL if it was
+                    removed), or NULL if these particles kept their indices
+    \param n_old Number of local particles before the rearrangement
+    \param first_new Index of the first particle that was added to the domain
+
+    Emits the particle sort signal like notifyParticleSort(). While the slots are executed, they can query
+    the rearrangement with getReorderMap() to update their own per-particle data incrementally, instead of
+    rebuilding it. Particles added to the domain must occupy the indices from \a first_new to getN()-1.
+*/
+void ParticleData::notifyParticleReorder(const unsigned int *new_idx, unsigned int n_old, unsigned int first_new)
+    {
+    assert(first_new <= getN());
+
+    m_reorder_known = true;
+    m_reorder_map = new_idx;
+    m_reorder_n_old = n_old;
+    m_reorder_first_new = first_new;
+
+    m_sort_signal.emit();
+
+    m_reorder_known = false;
+    m_reorder_map = NULL;
+    }
+
 /*! This function is called any time the ghost particles are removed
  *
  * The rationale is that a subscriber (i.e. the Communicator) can perform clean-up for ghost particles
@@ -325,6 +365,11 @@ void ParticleData::allocate(unsigned int N)
     GPUArray< Scalar4 > vel(N, m_exec_conf);
     m_vel.swap(vel);
 
+    // the structure-of-arrays copy refers to the old arrays
+    m_soa_n = 0;
+    m_soa_pos_state = soa_stale;
+    m_soa_vel_state = soa_stale;
+
     // accelerations
     GPUArray< Scalar3 > accel(N, m_exec_conf);
     m_accel.swap(accel);
@@ -489,6 +534,9 @@ void ParticleData::reallocate(unsigned int max_n)
         << m_max_nparticles << " -> " << max_n << " ptls" << std::endl;
     m_max_nparticles = max_n;
 
+    // copy pending structure-of-arrays writes back before the arrays move
+    releaseSoA(soa_field::position | soa_field::velocity);
+
     m_pos.resize(max_n);
     m_vel.resize(max_n);
     m_accel.resize(max_n);
@@ -532,6 +580,171 @@ void ParticleData::reallocate(unsigned int max_n)
     m_max_particle_num_signal.emit();
     }
 
+/*! \param enable True to enable the structure-of-arrays layout
+
+    With the layout enabled, host kernels may access positions and velocities through SoAHandle. The AoS arrays
+    remain the primary storage and are always valid when returned by getPositions() and getVelocities(), so code
+    that does not know about the layout is unaffected. The layout is not available on the GPU.
+*/
+void ParticleData::setSoALayout(bool enable)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "The structure-of-arrays particle data layout is only available on the CPU" << endl;
+        throw runtime_error("Error setting the particle data layout");
+        }
+
+    if (!enable && m_soa)
+        {
+        releaseSoA(soa_field::position | soa_field::velocity);
+
+        // free the memory
+        GPUArray<Scalar> soa_data;
+        m_soa_data.swap(soa_data);
+        GPUArray<unsigned int> soa_type;
+        m_soa_type.swap(soa_type);
+        m_soa_n = 0;
+        }
+
+    m_soa = enable;
+    }
+
+/*! \param fields Bitwise or of soa_field flags to access
+    \param mode Access mode of the caller
+    \returns The SoA rows, with the requested field groups up to date
+
+    The SoA arrays are (re)allocated to hold getMaxN() particles when they are too small, and the requested field
+    groups are gathered from the AoS arrays unless they already hold valid data or the caller overwrites them.
+*/
+const GPUArray<Scalar>& ParticleData::acquireSoA(unsigned int fields, access_mode::Enum mode) const
+    {
+    if (!m_soa)
+        {
+        m_exec_conf->msg->error() << "The structure-of-arrays particle data layout is not enabled" << endl;
+        throw runtime_error("Error accessing particle data");
+        }
+
+    const unsigned int n = m_nparticles + m_nghosts;
+    if (n != m_soa_n)
+        {
+        // the number of particles changed, start over from the AoS arrays
+        releaseSoA(soa_field::position | soa_field::velocity);
+        m_soa_n = n;
+        }
+
+    if (m_soa_data.getPitch() < n || m_soa_data.getHeight() < 7)
+        {
+        GPUArray<Scalar> soa_data(m_max_nparticles, 7, m_exec_conf);
+        m_soa_data.swap(soa_data);
+        GPUArray<unsigned int> soa_type(m_max_nparticles, m_exec_conf);
+        m_soa_type.swap(soa_type);
+        }
+
+    const bool gather_pos = (fields & soa_field::position) && m_soa_pos_state == soa_stale && mode != access_mode::overwrite;
+    const bool gather_vel = (fields & soa_field::velocity) && m_soa_vel_state == soa_stale && mode != access_mode::overwrite;
+
+    if (gather_pos || gather_vel)
+        {
+        ArrayHandle<Scalar> h_soa(m_soa_data, access_location::host, access_mode::readwrite);
+        const unsigned int pitch = m_soa_data.getPitch();
+        Scalar *x = h_soa.data, *y = x + pitch, *z = y + pitch;
+        Scalar *vx = z + pitch, *vy = vx + pitch, *vz = vy + pitch, *mass = vz + pitch;
+
+        if (gather_pos)
+            {
+            ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_type(m_soa_type, access_location::host, access_mode::overwrite);
+
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < (int)n; ++i)
+                {
+                const Scalar4 postype = h_pos.data[i];
+                x[i] = postype.x;
+                y[i] = postype.y;
+                z[i] = postype.z;
+                h_type.data[i] = __scalar_as_int(postype.w);
+                }
+            }
+
+        if (gather_vel)
+            {
+            ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
+
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < (int)n; ++i)
+                {
+                const Scalar4 velmass = h_vel.data[i];
+                vx[i] = velmass.x;
+                vy[i] = velmass.y;
+                vz[i] = velmass.z;
+                mass[i] = velmass.w;
+                }
+            }
+        }
+
+    if (fields & soa_field::position)
+        {
+        if (mode != access_mode::read)
+            m_soa_pos_state = soa_dirty;
+        else if (m_soa_pos_state == soa_stale)
+            m_soa_pos_state = soa_clean;
+        }
+
+    if (fields & soa_field::velocity)
+        {
+        if (mode != access_mode::read)
+            m_soa_vel_state = soa_dirty;
+        else if (m_soa_vel_state == soa_stale)
+            m_soa_vel_state = soa_clean;
+        }
+
+    return m_soa_data;
+    }
+
+/*! \param fields Bitwise or of soa_field flags to release
+
+    Dirty field groups are scattered back into the AoS arrays. Afterwards the groups are marked stale, since the
+    caller is about to hand out the AoS arrays, which may then be modified.
+*/
+void ParticleData::releaseSoA(unsigned int fields) const
+    {
+    const bool scatter_pos = (fields & soa_field::position) && m_soa_pos_state == soa_dirty;
+    const bool scatter_vel = (fields & soa_field::velocity) && m_soa_vel_state == soa_dirty;
+
+    if (scatter_pos || scatter_vel)
+        {
+        const unsigned int n = m_soa_n;
+        ArrayHandle<Scalar> h_soa(m_soa_data, access_location::host, access_mode::read);
+        const unsigned int pitch = m_soa_data.getPitch();
+        const Scalar *x = h_soa.data, *y = x + pitch, *z = y + pitch;
+        const Scalar *vx = z + pitch, *vy = vx + pitch, *vz = vy + pitch, *mass = vz + pitch;
+
+        if (scatter_pos)
+            {
+            ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_type(m_soa_type, access_location::host, access_mode::read);
+
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < (int)n; ++i)
+                h_pos.data[i] = make_scalar4(x[i], y[i], z[i], __int_as_scalar(h_type.data[i]));
+            }
+
+        if (scatter_vel)
+            {
+            ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < (int)n; ++i)
+                h_vel.data[i] = make_scalar4(vx[i], vy[i], vz[i], mass[i]);
+            }
+        }
+
+    if (fields & soa_field::position)
+        m_soa_pos_state = soa_stale;
+    if (fields & soa_field::velocity)
+        m_soa_vel_state = soa_stale;
+    }
+
 /*! Rebuild the cached vector of active tags, if necessary
 */
 void ParticleData::maybe_rebuild_tag_cache()
@@ -848,8 +1061,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             allocate(m_nparticles);
 
         // Load particle data
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::overwrite);
         ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::overwrite);
@@ -900,8 +1113,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         // allocate particle data such that we can accomodate the particles
         allocate(snapshot.size);
 
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::overwrite);
         ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::overwrite);
@@ -985,8 +1198,8 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
 
     m_exec_conf->msg->notice(4) << "ParticleData: taking snapshot" << std::endl;
 
-    ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
-    ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::read);
     ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::read);
     ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::read);
     ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::read);
@@ -1283,7 +1496,7 @@ Scalar3 ParticleData::getPosition(unsigned int tag) const
     int3 img = make_int3(0,0,0);
     if (found)
         {
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::read);
         result = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
         result = result - m_origin;
 
@@ -1316,7 +1529,7 @@ Scalar3 ParticleData::getVelocity(unsigned int tag) const
     Scalar3 result = make_scalar3(0.0,0.0,0.0);
     if (found)
         {
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::read);
         result = make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z);
         }
 #ifdef ENABLE_MPI
@@ -1364,7 +1577,7 @@ int3 ParticleData::getImage(unsigned int tag) const
     if (found)
         {
         ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::read);
-        ArrayHandle< Scalar4 > h_postype(m_pos, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_postype(getPositions(), access_location::host, access_mode::read);
         result = make_int3(h_image.data[idx].x, h_image.data[idx].y, h_image.data[idx].z);
         pos = make_scalar3(h_postype.data[idx].x,h_postype.data[idx].y,h_postype.data[idx].z);
         pos = pos - m_origin;
@@ -1422,7 +1635,7 @@ Scalar ParticleData::getMass(unsigned int tag) const
     Scalar result = 0.0;
     if (found)
         {
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::read);
         result = h_vel.data[idx].w;
         }
 #ifdef ENABLE_MPI
@@ -1491,7 +1704,7 @@ unsigned int ParticleData::getType(unsigned int tag) const
     unsigned int result = 0;
     if (found)
         {
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::read);
         result = __scalar_as_int(h_pos.data[idx].w);
         }
 #ifdef ENABLE_MPI
@@ -1659,7 +1872,7 @@ void ParticleData::setPosition(unsigned int tag, const Scalar3& pos, bool move)
     // store position and image
     if (ptl_local)
         {
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::readwrite);
         ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::readwrite);
 
         h_pos.data[idx].x = tmp_pos.x; h_pos.data[idx].y = tmp_pos.y; h_pos.data[idx].z = tmp_pos.z;
@@ -1765,7 +1978,7 @@ void ParticleData::setVelocity(unsigned int tag, const Scalar3& vel)
 #endif
     if (found)
         {
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::readwrite);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::readwrite);
         h_vel.data[idx].x = vel.x; h_vel.data[idx].y = vel.y; h_vel.data[idx].z = vel.z;
         }
     }
@@ -1821,7 +2034,7 @@ void ParticleData::setMass(unsigned int tag, Scalar mass)
 #endif
     if (found)
         {
-        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::readwrite);
+        ArrayHandle< Scalar4 > h_vel(getVelocities(), access_location::host, access_mode::readwrite);
         h_vel.data[idx].w = mass;
         }
     }
@@ -1877,7 +2090,7 @@ void ParticleData::setType(unsigned int tag, unsigned int typ)
 #endif
     if (found)
         {
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle< Scalar4 > h_pos(getPositions(), access_location::host, access_mode::readwrite);
         h_pos.data[idx].w = __int_as_scalar(typ);
         // signal that the types have changed
         notifyParticleSort();
@@ -2262,6 +2475,8 @@ void export_ParticleData(py::module& m)
     .def("setGlobalBoxL", &ParticleData::setGlobalBoxL)
     .def("setGlobalBox", &ParticleData::setGlobalBox)
     .def("getN", &ParticleData::getN)
+    .def("setSoALayout", &ParticleData::setSoALayout)
+    .def("getSoALayout", &ParticleData::getSoALayout)
     .def("getNGhosts", &ParticleData::getNGhosts)
     .def("getNGlobal", &ParticleData::getNGlobal)
     .def("getNTypes", &ParticleData::getNTypes)
@@ -2448,6 +2663,9 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         ArrayHandle<Scalar3> h_inertia_alt(m_inertia_alt, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag_alt(m_tag_alt, access_location::host, access_mode::overwrite);
 
+        // record where the remaining particles move to
+        m_removed_new_idx.resize(old_nparticles);
+
         unsigned int n =0;
         unsigned int m = 0;
         for (unsigned int i = 0; i < old_nparticles; ++i)
@@ -2455,6 +2673,8 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
             unsigned int tag = h_tag.data[i];
             if (h_rtag.data[tag] != NOT_LOCAL)
                 {
+                m_removed_new_idx[i] = n;
+
                 // copy over to alternate pdata arrays
                 h_pos_alt.data[n] = h_pos.data[i];
                 h_vel_alt.data[n] = h_vel.data[i];
@@ -2471,6 +2691,8 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 }
             else
                 {
+                m_removed_new_idx[i] = NOT_LOCAL;
+
                 // write to packed array
                 pdata_element p;
                 p.pos = h_pos.data[i];
@@ -2526,7 +2748,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
     if (m_prof) m_prof->pop();
 
     // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    notifyParticleReorder(m_removed_new_idx.data(), old_nparticles, m_nparticles);
     }
 
 //! Remove particles from local domain and append new particle data
@@ -2592,8 +2814,8 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    // notify subscribers that particle data order has been changed, the local particles kept their indices
+    notifyParticleReorder(NULL, old_nparticles, old_nparticles);
     }
 
 #ifdef ENABLE_CUDA
@@ -86,6 +86,17 @@ struct pdata_flag
 //! flags determines which optional fields in in the particle data arrays are to be computed / are valid
 typedef std::bitset<32> PDataFlags;
 
+//! Groups of fields that can be accessed in the structure-of-arrays layout (see SoAHandle)
+struct soa_field
+    {
+    //! The enum
+    enum Enum
+        {
+        position=1,                //!< x, y, z coordinates and types
+        velocity=2                 //!< vx, vy, vz velocities and masses
+        };
+    };
+
 //! Defines a simple structure to deal with complex numbers
 /*! This structure is useful to deal with complex numbers for such situations
     as Fourier transforms. Note that we do not need any to define any operations and the
@@ -250,7 +261,9 @@ struct pdata_element
 
     In order to help other classes deal with particles changing indices, any class that
     changes the order must call notifyParticleSort(). Any class interested in being notified
-    can subscribe to the signal by calling connectParticleSort().
+    can subscribe to the signal by calling connectParticleSort(). Classes that know where every particle
+    moved to (e.g. the particle sorter and migration on the CPU) call notifyParticleReorder() instead, so that
+    subscribers can update their own per-particle data incrementally.
 
     Some fields in ParticleData are not computed and assigned by default because they require additional processing
     time. PDataFlags is a bitset that lists which flags (enumerated in pdata_flag) are enable/disabled. Computes should
@@ -489,10 +502,33 @@ class ParticleData
             }
 
         //! Return positions and types
-        const GPUArray< Scalar4 >& getPositions() const { return m_pos; }
+        /*! When the structure-of-arrays layout is in use, pending writes made through SoAHandle are copied back first.
+        */
+        const GPUArray< Scalar4 >& getPositions() const
+            {
+            if (m_soa_pos_state != soa_stale)
+                releaseSoA(soa_field::position);
+            return m_pos;
+            }
 
         //! Return velocities and masses
-        const GPUArray< Scalar4 >& getVelocities() const { return m_vel; }
+        /*! When the structure-of-arrays layout is in use, pending writes made through SoAHandle are copied back first.
+        */
+        const GPUArray< Scalar4 >& getVelocities() const
+            {
+            if (m_soa_vel_state != soa_stale)
+                releaseSoA(soa_field::velocity);
+            return m_vel;
+            }
+
+        //! Enable or disable the structure-of-arrays layout for positions and velocities (CPU only)
+        void setSoALayout(bool enable);
+
+        //! Test if the structure-of-arrays layout is enabled
+        bool getSoALayout() const
+            {
+            return m_soa;
+            }
 
         //! Return accelerations
         const GPUArray< Scalar3 >& getAccelerations() const { return m_accel; }
@@ -540,13 +576,23 @@ class ParticleData
         const GPUArray< Scalar4 >& getAltPositions() const { return m_pos_alt; }
 
         //! Swap in positions
-        inline void swapPositions() { m_pos.swap(m_pos_alt); }
+        inline void swapPositions()
+            {
+            if (m_soa_pos_state != soa_stale)
+                releaseSoA(soa_field::position);
+            m_pos.swap(m_pos_alt);
+            }
 
         //! Return velocities and masses (alternate array)
         const GPUArray< Scalar4 >& getAltVelocities() const { return m_vel_alt; }
 
         //! Swap in velocities
-        inline void swapVelocities() { m_vel.swap(m_vel_alt); }
+        inline void swapVelocities()
+            {
+            if (m_soa_vel_state != soa_stale)
+                releaseSoA(soa_field::velocity);
+            m_vel.swap(m_vel_alt);
+            }
 
         //! Return accelerations (alternate array)
         const GPUArray< Scalar3 >& getAltAccelerations() const { return m_accel_alt; }
@@ -637,6 +683,42 @@ class ParticleData
         //! Notify listeners that the particles have been rearranged in memory
         void notifyParticleSort();
 
+        //! Notify listeners that the particles have been rearranged in memory in a known way
+        void notifyParticleReorder(const unsigned int *new_idx, unsigned int n_old, unsigned int first_new);
+
+        //! Test if the rearrangement that is currently being notified is known
+        /*! \returns true only inside the slots of the particle sort signal, when it was emitted by
+                      notifyParticleReorder()
+        */
+        bool isReorderKnown() const
+            {
+            return m_reorder_known;
+            }
+
+        //! Get the new index of every particle that was local before the current rearrangement
+        /*! \returns Array of length getReorderNOld(), with NOT_LOCAL for particles that were removed, or NULL
+                      if the particles kept their indices
+            \note Only valid while isReorderKnown() is true
+        */
+        const unsigned int *getReorderMap() const
+            {
+            return m_reorder_map;
+            }
+
+        //! Get the number of local particles before the current rearrangement
+        unsigned int getReorderNOld() const
+            {
+            return m_reorder_n_old;
+            }
+
+        //! Get the index of the first particle that was added to the domain in the current rearrangement
+        /*! Particles with indices from getReorderFirstNew() to getN()-1 were not local before the rearrangement
+        */
+        unsigned int getReorderFirstNew() const
+            {
+            return m_reorder_first_new;
+            }
+
         //! Connects a function to be called every time the box size is changed
         Nano::Signal<void ()>& getBoxChangeSignal()
             {
@@ -997,6 +1079,11 @@ class ParticleData
         std::vector<std::string> m_type_mapping;    //!< Mapping between particle type indices and names
 
         Nano::Signal<void ()> m_sort_signal;       //!< Signal that is triggered when particles are sorted in memory
+        bool m_reorder_known;                      //!< True while a known rearrangement is notified
+        const unsigned int *m_reorder_map;         //!< New indices of the particles in the current rearrangement
+        unsigned int m_reorder_n_old;              //!< Number of local particles before the current rearrangement
+        unsigned int m_reorder_first_new;          //!< First index of the particles added in the current rearrangement
+        std::vector<unsigned int> m_removed_new_idx; //!< New indices of the particles kept by removeParticles()
         Nano::Signal<void ()> m_boxchange_signal;  //!< Signal that is triggered when the box size changes
         Nano::Signal<void ()> m_max_particle_num_signal; //!< Signal that is triggered when the maximum particle number changes
         Nano::Signal<void ()> m_ghost_particles_removed_signal; //!< Signal that is triggered when ghost particles are removed
@@ -1025,6 +1112,25 @@ class ParticleData
         GPUArray< Scalar4 > m_orientation;          //!< Orientation quaternion for each particle (ignored if not anisotropic)
         GPUArray< Scalar4 > m_angmom;               //!< Angular momementum quaternion for each particle
         GPUArray< Scalar3 > m_inertia;              //!< Principal moments of inertia for each particle
+
+        /* The structure-of-arrays layout keeps a second copy of the positions and velocities in separate x, y, z, ...
+           arrays for host kernels that stream over single components. Each field group is either stale (the AoS arrays
+           hold the only valid copy), clean (both copies agree) or dirty (the SoA copy was written and has to be copied
+           back before the AoS arrays are handed out).
+         */
+        //! Synchronization state of a field group in the structure-of-arrays layout
+        enum soa_state
+            {
+            soa_stale=0,
+            soa_clean,
+            soa_dirty
+            };
+        bool m_soa;                                 //!< True if the structure-of-arrays layout is enabled
+        mutable GPUArray<Scalar> m_soa_data;        //!< SoA rows x, y, z, vx, vy, vz, mass (2D array)
+        mutable GPUArray<unsigned int> m_soa_type;  //!< SoA particle types
+        mutable unsigned int m_soa_n;               //!< Number of local and ghost particles held in the SoA arrays
+        mutable soa_state m_soa_pos_state;          //!< Synchronization state of the SoA positions and types
+        mutable soa_state m_soa_vel_state;          //!< Synchronization state of the SoA velocities and masses
         #ifdef ENABLE_MPI
         GPUArray<unsigned int> m_comm_flags;        //!< Array of communication flags
         #endif
@@ -1091,6 +1197,14 @@ class ParticleData
         //! Helper function to rebuild the active tag cache if necessary
         void maybe_rebuild_tag_cache();
 
+        //! Helper function to bring the SoA arrays up to date before they are accessed
+        const GPUArray<Scalar>& acquireSoA(unsigned int fields, access_mode::Enum mode) const;
+
+        //! Helper function to copy pending SoA writes back into the AoS arrays
+        void releaseSoA(unsigned int fields) const;
+
+        friend class SoAHandle;
+
         //! Helper function to check that particles of a snapshot are in the box
         /*! \return true If and only if all particles are in the simulation box
          * \param Snapshot to check
@@ -1099,6 +1213,57 @@ class ParticleData
         bool inBox(const SnapshotParticleData<Real>& snap);
     };
 
+//! Host access to the positions and velocities in the structure-of-arrays layout
+/*! SoAHandle provides separate, cache line aligned arrays for the components of the requested field groups (a
+    combination of soa_field flags), so that host kernels can stream over x, y, z, ... without loading the whole
+    Scalar4. Entries 0 to getN()+getNGhosts()-1 are valid, pointers of field groups that were not requested must not
+    be used.
+
+    Out of date SoA arrays are gathered from the AoS arrays on construction. A handle acquired for writing marks the
+    requested groups dirty, and the copy back into the AoS arrays is deferred until the next call to getPositions()
+    or getVelocities(), so that consecutive SoA kernels share one gather. As with ArrayHandle, the AoS arrays of the
+    requested groups must not be accessed while the handle is alive.
+
+    \pre ParticleData::setSoALayout(true) has been called.
+*/
+class SoAHandle
+    {
+    public:
+        //! Acquire the SoA arrays
+        /*! \param pdata Particle data to access
+            \param fields Bitwise or of soa_field flags to access
+            \param mode Access mode
+        */
+        SoAHandle(const ParticleData& pdata, unsigned int fields, const access_mode::Enum mode)
+            : m_h_data(pdata.acquireSoA(fields, mode), access_location::host, mode),
+              m_h_type(pdata.m_soa_type, access_location::host, mode)
+            {
+            const unsigned int pitch = pdata.m_soa_data.getPitch();
+            x = m_h_data.data;
+            y = x + pitch;
+            z = y + pitch;
+            vx = z + pitch;
+            vy = vx + pitch;
+            vz = vy + pitch;
+            mass = vz + pitch;
+            type = m_h_type.data;
+            }
+
+    private:
+        ArrayHandle<Scalar> m_h_data;         //!< Handle to the SoA rows
+        ArrayHandle<unsigned int> m_h_type;   //!< Handle to the SoA types
+
+    public:
+        Scalar *x;              //!< x coordinates
+        Scalar *y;              //!< y coordinates
+        Scalar *z;              //!< z coordinates
+        unsigned int *type;     //!< Particle types
+        Scalar *vx;             //!< x velocities
+        Scalar *vy;             //!< y velocities
+        Scalar *vz;             //!< z velocities
+        Scalar *mass;           //!< Particle masses
+    };
+
 #ifndef NVCC
 //! Exports the BoxDim class to python
 void export_BoxDim(pybind11::module& m);
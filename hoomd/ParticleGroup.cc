@@ -10,6 +10,10 @@
 #include "CachedAllocator.h"
 #endif
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
 #include <iostream>
 using namespace std;
@@ -19,6 +23,40 @@ namespace py = pybind11;
     \brief Defines the ParticleGroup and related classes
 */
 
+//! Collect the tags of the local particles that pass a test, in a threaded loop
+/*! \param N Number of local particles
+    \param tag Tags of the local particles
+    \param pred Test that is called with the index of each particle
+    \param member_tags List that the tags of the selected particles are appended to
+*/
+template<class Predicate>
+static void select_local(unsigned int N, const unsigned int *tag, const Predicate& pred,
+    std::vector<unsigned int>& member_tags)
+    {
+    unsigned int n_threads = 1;
+    #ifdef ENABLE_OPENMP
+    n_threads = omp_get_max_threads();
+    #endif
+    std::vector< std::vector<unsigned int> > thread_tags(n_threads);
+
+    #pragma omp parallel num_threads(n_threads)
+        {
+        unsigned int tid = 0;
+        #ifdef ENABLE_OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        std::vector<unsigned int>& my_tags = thread_tags[tid];
+
+        #pragma omp for schedule(static)
+        for (int idx = 0; idx < (int)N; idx++)
+            if (pred(idx))
+                my_tags.push_back(tag[idx]);
+        }
+
+    for (unsigned int i = 0; i < n_threads; i++)
+        member_tags.insert(member_tags.end(), thread_tags[i].begin(), thread_tags[i].end());
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelector
 
@@ -42,6 +80,19 @@ bool ParticleSelector::isSelected(unsigned int tag) const
     return false;
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelector::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    for (unsigned int idx = 0; idx < m_pdata->getN(); ++idx)
+        {
+        unsigned int tag = h_tag.data[idx];
+        if (isSelected(tag))
+            member_tags.push_back(tag);
+        }
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorAll
 
@@ -61,6 +112,14 @@ bool ParticleSelectorAll::isSelected(unsigned int tag) const
     return m_pdata->isParticleLocal(tag);
     }
 
+/*! \param member_tags List that the tags of all local particles are appended to
+*/
+void ParticleSelectorAll::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    member_tags.insert(member_tags.end(), h_tag.data, h_tag.data + m_pdata->getN());
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorTag
 
@@ -94,6 +153,21 @@ bool ParticleSelectorTag::isSelected(unsigned int tag) const
     return (m_tag_min <= tag && tag <= m_tag_max);
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelectorTag::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    const unsigned int *tags = h_tag.data;
+    const unsigned int tag_min = m_tag_min;
+    const unsigned int tag_max = m_tag_max;
+
+    select_local(m_pdata->getN(), tags, [&](unsigned int idx)
+        {
+        return tag_min <= tags[idx] && tags[idx] <= tag_max;
+        }, member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorType
 
@@ -141,6 +215,23 @@ bool ParticleSelectorType::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelectorType::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    const Scalar4 *postype = h_postype.data;
+    const unsigned int typ_min = m_typ_min;
+    const unsigned int typ_max = m_typ_max;
+
+    select_local(m_pdata->getN(), h_tag.data, [&](unsigned int idx)
+        {
+        unsigned int typ = __scalar_as_int(postype[idx].w);
+        return typ_min <= typ && typ <= typ_max;
+        }, member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorRigid
 
@@ -185,6 +276,21 @@ bool ParticleSelectorRigid::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelectorRigid::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    const unsigned int *body = h_body.data;
+    const bool rigid = m_rigid;
+
+    select_local(m_pdata->getN(), h_tag.data, [&](unsigned int idx)
+        {
+        return (body[idx] != NO_BODY) == rigid;
+        }, member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorRigidCenter
 
@@ -219,6 +325,21 @@ bool ParticleSelectorRigidCenter::isSelected(unsigned int tag) const
     return (body == tag);
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelectorRigidCenter::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    const unsigned int *body = h_body.data;
+    const unsigned int *tags = h_tag.data;
+
+    select_local(m_pdata->getN(), tags, [&](unsigned int idx)
+        {
+        return body[idx] == tags[idx];
+        }, member_tags);
+    }
+
 
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorCuboid
@@ -264,6 +385,25 @@ bool ParticleSelectorCuboid::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags List that the tags of the selected local particles are appended to
+*/
+void ParticleSelectorCuboid::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    const Scalar4 *postype = h_postype.data;
+    const Scalar3 lo = m_min;
+    const Scalar3 hi = m_max;
+
+    select_local(m_pdata->getN(), h_tag.data, [&](unsigned int idx)
+        {
+        Scalar4 p = postype[idx];
+        return lo.x <= p.x && p.x < hi.x &&
+               lo.y <= p.y && p.y < hi.y &&
+               lo.z <= p.z && p.z < hi.z;
+        }, member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleGroup
 
@@ -429,16 +569,8 @@ void ParticleGroup::updateMemberTags(bool force_update) const
         // for each particle in the (global) data
         vector<unsigned int> member_tags;
 
-            {
-            // loop through local particles and select those that match selection criterium
-            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            for (unsigned int idx = 0; idx < m_pdata->getN(); ++idx)
-                {
-                unsigned int tag = h_tag.data[idx];
-                if (m_selector->isSelected(tag))
-                    member_tags.push_back(tag);
-                }
-            }
+        // select the local particles that match the selection criterium
+        m_selector->getSelectedTags(member_tags);
 
         #ifdef ENABLE_MPI
         if (m_pdata->getDomainDecomposition())
@@ -762,6 +894,104 @@ void ParticleGroup::rebuildIndexList() const
     m_particles_sorted = false;
     }
 
+/*! When the particle data reports where the particles moved to and the index list is otherwise up to date, the
+    index list is patched right away. Otherwise, it is rebuilt on the next access.
+*/
+void ParticleGroup::slotParticleSort()
+    {
+    bool patch = m_pdata->isReorderKnown() && !m_particles_sorted && !m_global_ptl_num_change;
+
+    #ifdef ENABLE_CUDA
+    // the index list lives on the GPU, rebuild it there
+    if (m_exec_conf->isCUDAEnabled())
+        patch = false;
+    #endif
+
+    if (!patch)
+        {
+        m_particles_sorted = true;
+        return;
+        }
+
+    if (m_reallocated)
+        {
+        reallocate();
+        m_reallocated = false;
+        }
+
+    patchIndexList();
+    }
+
+/*! \pre m_is_member and m_member_idx reflect the particle order before the rearrangement that ParticleData is
+         currently notifying
+    \post m_is_member is updated so that it reflects the current indices of the particles in the group
+    \post m_member_idx is updated listing all particle indices belonging to the group, in index order
+
+    Members that remain local are moved to their new indices, and only the particles that were added to the domain
+    are looked up in the tag membership table.
+*/
+void ParticleGroup::patchIndexList() const
+    {
+    m_exec_conf->msg->notice(10) << "ParticleGroup: patching index" << std::endl;
+
+    ArrayHandle<unsigned char> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+
+    const unsigned int *new_idx = m_pdata->getReorderMap();
+    unsigned int num_members = m_num_local_members;
+
+    if (new_idx)
+        {
+        // move the members to their new indices, dropping those that left the domain
+        bool in_order = true;
+        unsigned int cur_member = 0;
+        for (unsigned int i = 0; i < num_members; i++)
+            {
+            unsigned int old_idx = h_member_idx.data[i];
+            assert(old_idx < m_pdata->getReorderNOld());
+            h_is_member.data[old_idx] = 0;
+
+            unsigned int idx = new_idx[old_idx];
+            if (idx != NOT_LOCAL)
+                {
+                if (cur_member && idx < h_member_idx.data[cur_member-1])
+                    in_order = false;
+                h_member_idx.data[cur_member++] = idx;
+                }
+            }
+
+        // a sort permutes the members, removal of particles keeps them in order
+        if (!in_order)
+            std::sort(h_member_idx.data, h_member_idx.data + cur_member);
+
+        for (unsigned int i = 0; i < cur_member; i++)
+            h_is_member.data[h_member_idx.data[i]] = 1;
+
+        num_members = cur_member;
+        }
+
+    // look up the particles that were added to the domain
+    unsigned int first_new = m_pdata->getReorderFirstNew();
+    unsigned int nparticles = m_pdata->getN();
+    if (first_new < nparticles)
+        {
+        ArrayHandle<unsigned char> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int idx = first_new; idx < nparticles; idx++)
+            {
+            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+            unsigned char is_member = h_is_member_tag.data[h_tag.data[idx]];
+            h_is_member.data[idx] = is_member;
+            if (is_member)
+                h_member_idx.data[num_members++] = idx;
+            }
+        }
+
+    m_num_local_members = num_members;
+    assert(m_num_local_members <= m_member_tags.getNumElements());
+    }
+
 #ifdef ENABLE_CUDA
 //! rebuild index list on the GPU
 void ParticleGroup::rebuildIndexListGPU() const
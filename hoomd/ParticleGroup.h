@@ -39,6 +39,10 @@
 
     The base class isSelected() method will simply reject all particles. Derived classes will implement specific
     selection semantics.
+
+    getSelectedTags() evaluates the criteria for all local particles at once. The base class implementation calls
+    isSelected() for every particle. Derived classes override it to acquire the particle data only once and to test
+    the particles in a threaded loop, which is what makes frequent re-evaluation of dynamic groups affordable.
 */
 class ParticleSelector
     {
@@ -50,6 +54,9 @@ class ParticleSelector
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
 
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
+
     protected:
         std::shared_ptr<SystemDefinition> m_sysdef;   //!< The system definition assigned to this selector
         std::shared_ptr<ParticleData> m_pdata;        //!< The particle data from m_sysdef, stored as a convenience
@@ -66,6 +73,9 @@ class ParticleSelectorAll : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     };
 
 
@@ -79,6 +89,9 @@ class ParticleSelectorTag : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         unsigned int m_tag_min;     //!< Minimum tag to select
         unsigned int m_tag_max;     //!< Maximum tag to select (inclusive)
@@ -94,6 +107,9 @@ class ParticleSelectorType : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         unsigned int m_typ_min;     //!< Minimum type to select
         unsigned int m_typ_max;     //!< Maximum type to select (inclusive)
@@ -109,6 +125,9 @@ class ParticleSelectorCuboid : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         Scalar3 m_min;     //!< Minimum type to select (inclusive)
         Scalar3 m_max;     //!< Maximum type to select (exclusive)
@@ -124,6 +143,9 @@ class ParticleSelectorRigid : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         bool m_rigid;   //!< true if we should select rigid boides, false if we should select non-rigid particles
     };
@@ -137,6 +159,9 @@ class ParticleSelectorRigidCenter : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all local particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     };
 
 
@@ -155,9 +180,9 @@ class ParticleSelectorRigidCenter : public ParticleSelector
 
     Membership in the group is determined through a generic ParticleSelector class. See its documentation for details.
 
-    Group membership is determined once at the instantiation of the group. Thus ParticleGroup only supports static
-    groups where membership does not change over the course of a simulation. Dynamic groups, if they are needed,
-    may require a drastically different design to allow for efficient access.
+    Group membership is determined at the instantiation of the group. It is re-evaluated when updateMemberTags() is
+    called, which DynamicGroupUpdater does periodically to implement dynamic groups. In between, the set of member
+    tags does not change.
 
     In many use-cases, ParticleGroup may be accessed many times within inner loops. Thus, it must not aquire any
     ParticleData arrays within most of the get() calls as the caller must be allowed to leave their ParticleData
@@ -170,6 +195,9 @@ class ParticleSelectorRigidCenter : public ParticleSelector
     in a sorted tag order. This list can be accessed directly via getMemberTag() to meet the 2nd use case listed above.
     In order to iterate through all particles in the group in a cache-efficient manner, an auxilliary list is stored
     that lists all particle <i>indicies</i> that belong to the group. This list must be updated on every particle sort.
+    When ParticleData reports where the particles moved to (see ParticleData::notifyParticleReorder()), the list is
+    patched on the CPU in time proportional to the number of local members and added particles. Otherwise, it is
+    rebuilt from the tags of all local particles the next time it is accessed.
     Thirdly, a dynamic bitset is used to store one bit per particle for efficient O(1) tests if a given particle is in
     the group.
 
@@ -338,6 +366,9 @@ class ParticleGroup
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexList() const;
 
+        //! Helper function to patch the index lists after a known rearrangement of the particles
+        void patchIndexList() const;
+
         //! Helper function to rebuild internal arrays
         void checkRebuild() const
             {
@@ -366,10 +397,7 @@ class ParticleGroup
             }
 
         //! Helper function to be called when the particles are resorted
-        void slotParticleSort()
-            {
-            m_particles_sorted = true;
-            }
+        void slotParticleSort();
 
         //! Helper function to be called when particles are added/removed
         void slotGlobalParticleNumChange()
@@ -191,7 +191,7 @@ void ProfileDataElem::output_line(std::ostream &o,
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+Profiler::Profiler(const std::string& name) : m_name(name), m_trace(NULL)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
@@ -14,6 +14,7 @@
 
 #include "ExecutionConfiguration.h"
 #include "ClockSource.h"
+#include "TraceRecorder.h"
 
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
@@ -118,6 +119,9 @@ class ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    When a TraceRecorder is set with setTraceRecorder(), every push() and pop() is also recorded as a begin and end
+    event in the trace.
     \ingroup utils
     */
 class Profiler
@@ -135,11 +139,20 @@ class Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Set the recorder that push() and pop() events are traced to
+        /*! \param trace The recorder, or NULL to not trace
+        */
+        void setTraceRecorder(TraceRecorder *trace)
+            {
+            m_trace = trace;
+            }
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
+        TraceRecorder *m_trace;  //!< Recorder to trace push/pop events to (may be NULL)
 
         //! Output helper function
         void output(std::ostream &o);
@@ -200,6 +213,9 @@ inline void Profiler::push(const std::string& name)
     // and updating the stack
     m_stack.push(&cur->m_children[name]);
 
+    if (m_trace)
+        m_trace->begin(name);
+
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
     SCOREP_USER_REGION_BEGIN( cur->m_children[name].m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
@@ -232,6 +248,9 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
 
     // and finally popping the stack so that the next pop will access the correct element
     m_stack.pop();
+
+    if (m_trace)
+        m_trace->end();
     }
 
 #endif
@@ -0,0 +1,385 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#include "HOOMDMath.h"
+
+#ifndef __RANDOM_NUMBERS_H__
+#define __RANDOM_NUMBERS_H__
+
+/*! \file RandomNumbers.h
+    \brief Counter based random number generation shared by the host and device code
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#undef DEVICE
+#ifdef NVCC
+#define DEVICE __host__ __device__
+#else
+#define DEVICE
+#endif
+
+//! Counter based random numbers live in the hoomd namespace, apart from the deprecated RandomGenerator initializer
+namespace hoomd
+{
+
+//! Stream identifiers for RandomGenerator
+/*! Every class that draws random numbers from RandomGenerator passes its own identifier as part of the key. Two
+    classes given the same user seed therefore still draw statistically independent streams.
+*/
+struct RNGIdentifier
+    {
+    enum
+        {
+        TwoStepLangevin = 0x2b4c5e01,
+        TwoStepBD = 0x2b4c5e02,
+        EvaluatorPairDPDThermo = 0x2b4c5e03,
+        EvaluatorPairDPDLJThermo = 0x2b4c5e04
+        };
+    };
+
+//! Philox4x32-10 counter based random number generator
+/*! Philox (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11) maps a 128 bit counter and a 64 bit
+    key to 128 random bits with 10 rounds of a multiply and xor bijection. There is no state to seed or advance, so any
+    particle (or pair of particles) can compute its random numbers independently of all others. The random bits do not
+    depend on the processing order, the number of threads, the number of MPI ranks, or whether they are computed on
+    the host or the device.
+*/
+struct Philox4x32
+    {
+    static const unsigned int M0 = 0xD2511F53; //!< Multiplier for counter word 0
+    static const unsigned int M1 = 0xCD9E8D57; //!< Multiplier for counter word 2
+    static const unsigned int W0 = 0x9E3779B9; //!< Key schedule increment for key word 0 (golden ratio)
+    static const unsigned int W1 = 0xBB67AE85; //!< Key schedule increment for key word 1 (sqrt(3)-1)
+
+    //! Apply a single Philox round
+    /*! \param c Counter, updated in place
+        \param k0 First key word of this round
+        \param k1 Second key word of this round
+    */
+    DEVICE static inline void round(unsigned int *c, unsigned int k0, unsigned int k1)
+        {
+        unsigned long long p0 = (unsigned long long)M0 * (unsigned long long)c[0];
+        unsigned long long p1 = (unsigned long long)M1 * (unsigned long long)c[2];
+        unsigned int c0 = (unsigned int)(p1 >> 32) ^ c[1] ^ k0;
+        unsigned int c2 = (unsigned int)(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = (unsigned int)p1;
+        c[3] = (unsigned int)p0;
+        c[0] = c0;
+        c[2] = c2;
+        }
+
+    //! Compute the 10 round Philox bijection
+    /*! \param c Counter on input, random bits on output
+        \param k0 First key word
+        \param k1 Second key word
+    */
+    DEVICE static inline void generate(unsigned int *c, unsigned int k0, unsigned int k1)
+        {
+        for (unsigned int r = 0; r < 10; r++)
+            {
+            round(c, k0, k1);
+            k0 += W0;
+            k1 += W1;
+            }
+        }
+    };
+
+//! Convert 32 random bits to a uniform random number in [0,1)
+/*! Single precision uses the upper 24 bits so that the result is exactly representable and never rounds up to 1.
+*/
+template<class Real>
+DEVICE inline Real u01(unsigned int u);
+
+//! Convert 32 random bits to a uniform float in [0,1)
+template<>
+DEVICE inline float u01<float>(unsigned int u)
+    {
+    return float(u >> 8) * 5.9604644775390625e-8f;
+    }
+
+//! Convert 32 random bits to a uniform double in [0,1)
+template<>
+DEVICE inline double u01<double>(unsigned int u)
+    {
+    return double(u) * 2.3283064365386962890625e-10;
+    }
+
+//! Transform two pairs of random bits into four standard normal random numbers
+/*! \param u Four 32 bit random words
+    \param r Output array of four normal random numbers with zero mean and unit variance
+
+    The Box-Muller transform is used without rejection, so every call consumes exactly one Philox block. This keeps
+    the stream position of every draw fixed, which is what makes the block generators below reproducible.
+
+    \note The transform uses fast::sqrt(), fast::cos() and fast::sin(), which map to approximate intrinsics on the
+    device. Normal random numbers computed on the host and on the device from the same bits agree only to within
+    rounding.
+*/
+template<class Real>
+DEVICE inline void boxMuller4(const unsigned int *u, Real *r)
+    {
+    const Real two_pi = Real(6.283185307179586);
+    for (unsigned int i = 0; i < 4; i += 2)
+        {
+        // 1 - u01 lies in (0,1], so the log is always finite
+        Real rad = fast::sqrt(Real(-2.0) * log(Real(1.0) - u01<Real>(u[i])));
+        Real theta = two_pi * u01<Real>(u[i+1]);
+        r[i] = rad * fast::cos(theta);
+        r[i+1] = rad * fast::sin(theta);
+        }
+    }
+
+//! Random number stream for a single particle or pair of particles
+/*! A RandomGenerator is identified by the tuple (stream, seed, i, j, timestep). \a stream is one of the
+    RNGIdentifier values, \a seed is the user seed, \a i and \a j are particle tags (\a j is 0 for per-particle
+    streams), and \a timestep is the current time step. Every call to one of the draw methods consumes one block of
+    four 32 bit words; the n-th block of a given stream is always the same regardless of where it is evaluated.
+    u32x4() and uniform4() therefore return identical values on the host and the device, while normal4() only agrees
+    to within rounding (see boxMuller4()).
+
+    Constructing a RandomGenerator is free: unlike Saru there is no state to mix, so it is cheap to create one per
+    particle or pair inside a kernel or loop body.
+*/
+class RandomGenerator
+    {
+    public:
+        //! Construct a random number stream
+        /*! \param stream Identifier of the calling class (see RNGIdentifier)
+            \param seed User chosen random number seed
+            \param i First particle tag
+            \param j Second particle tag (0 for per-particle streams)
+            \param timestep Current time step
+            \param block Index of the first block to draw
+        */
+        DEVICE RandomGenerator(unsigned int stream,
+                               unsigned int seed,
+                               unsigned int i,
+                               unsigned int j,
+                               unsigned int timestep,
+                               unsigned int block=0)
+            : m_k0(seed), m_k1(stream), m_i(i), m_j(j), m_timestep(timestep), m_block(block)
+            {
+            }
+
+        //! Draw the next block of four random 32 bit words
+        /*! \param u Output array of four words
+        */
+        DEVICE inline void u32x4(unsigned int *u)
+            {
+            u[0] = m_i;
+            u[1] = m_j;
+            u[2] = m_timestep;
+            u[3] = m_block++;
+            Philox4x32::generate(u, m_k0, m_k1);
+            }
+
+        //! Draw the next block as four uniform random numbers in [a,b)
+        /*! \param r Output array of four random numbers
+            \param a Lower bound
+            \param b Upper bound
+        */
+        template<class Real>
+        DEVICE inline void uniform4(Real *r, Real a, Real b)
+            {
+            unsigned int u[4];
+            u32x4(u);
+            for (unsigned int k = 0; k < 4; k++)
+                r[k] = a + (b-a)*u01<Real>(u[k]);
+            }
+
+        //! Draw the next block as four normal random numbers
+        /*! \param r Output array of four random numbers
+            \param sigma Standard deviation
+        */
+        template<class Real>
+        DEVICE inline void normal4(Real *r, Real sigma)
+            {
+            unsigned int u[4];
+            u32x4(u);
+            boxMuller4(u, r);
+            for (unsigned int k = 0; k < 4; k++)
+                r[k] *= sigma;
+            }
+
+    private:
+        unsigned int m_k0;          //!< First key word (user seed)
+        unsigned int m_k1;          //!< Second key word (stream identifier)
+        unsigned int m_i;           //!< First counter word (particle tag)
+        unsigned int m_j;           //!< Second counter word (partner tag)
+        unsigned int m_timestep;    //!< Third counter word (time step)
+        unsigned int m_block;       //!< Fourth counter word (index of the next block)
+    };
+
+#ifndef NVCC
+//! Number of ids processed together by the block generators
+const unsigned int RANDOM_BLOCK_TILE = 16;
+
+//! Evaluate Philox4x32 for a tile of counters at once
+/*! \param c0 First counter words, RANDOM_BLOCK_TILE entries
+    \param c1 Second counter words
+    \param c2 Third counter words
+    \param c3 Fourth counter words
+    \param k0 First key word
+    \param k1 Second key word
+
+    This is the same bijection as Philox4x32::generate() with the loop over counters moved innermost and the counter
+    words split into separate arrays. The inner loop has no dependencies between lanes, so the compiler vectorizes it.
+*/
+inline void philoxTile(unsigned int *c0,
+                       unsigned int *c1,
+                       unsigned int *c2,
+                       unsigned int *c3,
+                       unsigned int k0,
+                       unsigned int k1)
+    {
+    for (unsigned int r = 0; r < 10; r++)
+        {
+        for (unsigned int l = 0; l < RANDOM_BLOCK_TILE; l++)
+            {
+            unsigned long long p0 = (unsigned long long)Philox4x32::M0 * (unsigned long long)c0[l];
+            unsigned long long p1 = (unsigned long long)Philox4x32::M1 * (unsigned long long)c2[l];
+            unsigned int n0 = (unsigned int)(p1 >> 32) ^ c1[l] ^ k0;
+            unsigned int n2 = (unsigned int)(p0 >> 32) ^ c3[l] ^ k1;
+            c1[l] = (unsigned int)p1;
+            c3[l] = (unsigned int)p0;
+            c0[l] = n0;
+            c2[l] = n2;
+            }
+        k0 += Philox4x32::W0;
+        k1 += Philox4x32::W1;
+        }
+    }
+
+//! Generate raw random words for many ids at once
+/*! \param u Output array of 4*\a n words, four consecutive words per id
+    \param ids Particle tags
+    \param n Number of ids
+    \param stream Identifier of the calling class (see RNGIdentifier)
+    \param seed User chosen random number seed
+    \param timestep Current time step
+    \param block Block index to draw for every id
+
+    u[4*k] .. u[4*k+3] are identical to the words returned by the \a block-th call to RandomGenerator::u32x4() on
+    RandomGenerator(stream, seed, ids[k], 0, timestep).
+*/
+inline void generateBlock(unsigned int *u,
+                          const unsigned int *ids,
+                          unsigned int n,
+                          unsigned int stream,
+                          unsigned int seed,
+                          unsigned int timestep,
+                          unsigned int block)
+    {
+    for (unsigned int start = 0; start < n; start += RANDOM_BLOCK_TILE)
+        {
+        unsigned int m = n - start;
+        if (m > RANDOM_BLOCK_TILE)
+            m = RANDOM_BLOCK_TILE;
+
+        unsigned int c0[RANDOM_BLOCK_TILE], c1[RANDOM_BLOCK_TILE], c2[RANDOM_BLOCK_TILE], c3[RANDOM_BLOCK_TILE];
+        for (unsigned int l = 0; l < RANDOM_BLOCK_TILE; l++)
+            {
+            c0[l] = (l < m) ? ids[start+l] : 0;
+            c1[l] = 0;
+            c2[l] = timestep;
+            c3[l] = block;
+            }
+
+        philoxTile(c0, c1, c2, c3, seed, stream);
+
+        for (unsigned int l = 0; l < m; l++)
+            {
+            u[4*(start+l)] = c0[l];
+            u[4*(start+l)+1] = c1[l];
+            u[4*(start+l)+2] = c2[l];
+            u[4*(start+l)+3] = c3[l];
+            }
+        }
+    }
+
+//! Generate four uniform random numbers in [a,b) for each of many ids
+/*! \param r Output array of 4*\a n random numbers
+    \param ids Particle tags
+    \param n Number of ids
+    \param stream Identifier of the calling class (see RNGIdentifier)
+    \param seed User chosen random number seed
+    \param timestep Current time step
+    \param block Block index to draw for every id
+    \param a Lower bound
+    \param b Upper bound
+
+    The output matches RandomGenerator::uniform4() for the same stream and block.
+*/
+template<class Real>
+inline void generateUniformBlock(Real *r,
+                                 const unsigned int *ids,
+                                 unsigned int n,
+                                 unsigned int stream,
+                                 unsigned int seed,
+                                 unsigned int timestep,
+                                 unsigned int block,
+                                 Real a,
+                                 Real b)
+    {
+    unsigned int u[4*RANDOM_BLOCK_TILE];
+    for (unsigned int start = 0; start < n; start += RANDOM_BLOCK_TILE)
+        {
+        unsigned int m = n - start;
+        if (m > RANDOM_BLOCK_TILE)
+            m = RANDOM_BLOCK_TILE;
+
+        generateBlock(u, ids + start, m, stream, seed, timestep, block);
+        for (unsigned int k = 0; k < 4*m; k++)
+            r[4*start+k] = a + (b-a)*u01<Real>(u[k]);
+        }
+    }
+
+//! Generate four normal random numbers for each of many ids
+/*! \param r Output array of 4*\a n random numbers
+    \param ids Particle tags
+    \param n Number of ids
+    \param stream Identifier of the calling class (see RNGIdentifier)
+    \param seed User chosen random number seed
+    \param timestep Current time step
+    \param block Block index to draw for every id
+    \param sigma Standard deviation
+
+    The output matches RandomGenerator::normal4() evaluated on the host for the same stream and block. Results of
+    normal4() on the device differ in the last bits (see boxMuller4()).
+*/
+template<class Real>
+inline void generateNormalBlock(Real *r,
+                                const unsigned int *ids,
+                                unsigned int n,
+                                unsigned int stream,
+                                unsigned int seed,
+                                unsigned int timestep,
+                                unsigned int block,
+                                Real sigma)
+    {
+    unsigned int u[4*RANDOM_BLOCK_TILE];
+    for (unsigned int start = 0; start < n; start += RANDOM_BLOCK_TILE)
+        {
+        unsigned int m = n - start;
+        if (m > RANDOM_BLOCK_TILE)
+            m = RANDOM_BLOCK_TILE;
+
+        generateBlock(u, ids + start, m, stream, seed, timestep, block);
+        for (unsigned int l = 0; l < m; l++)
+            {
+            Real *out = r + 4*(start+l);
+            boxMuller4(u + 4*l, out);
+            for (unsigned int k = 0; k < 4; k++)
+                out[k] *= sigma;
+            }
+        }
+    }
+#endif
+
+} // end namespace hoomd
+
+#undef DEVICE
+
+#endif // __RANDOM_NUMBERS_H__
@@ -18,21 +18,29 @@
 #include <fstream>
 #include <iostream>
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
 /*! \param sysdef System to perform sorts on
  */
 SFCPackUpdater::SFCPackUpdater(std::shared_ptr<SystemDefinition> sysdef)
-        : Updater(sysdef), m_last_grid(0), m_last_dim(0)
+        : Updater(sysdef), m_last_grid(0), m_last_dim(0), m_max_disorder(0.0), m_last_sort_step(0),
+          m_next_check(0), m_schedule_started(false), m_reorder_known(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing SFCPackUpdater" << endl;
 
     // perform lots of sanity checks
     assert(m_pdata);
 
-    m_sort_order.resize(m_pdata->getMaxN());
-    m_particle_bins.resize(m_pdata->getMaxN());
+    reallocate();
 
     // set the default grid
     // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order
@@ -52,6 +60,8 @@ void SFCPackUpdater::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_sort_order_alt.resize(m_pdata->getMaxN());
+    m_particle_bins_alt.resize(m_pdata->getMaxN());
     }
 
 /*! Destructor
@@ -67,9 +77,44 @@ SFCPackUpdater::~SFCPackUpdater()
     gets ahold of the particle data
 
     \param timestep Current timestep of the simulation
+
+    When a maximum disorder is set, the sort is skipped if the particles are still close to the order of the curve.
+    The decision is made before any communication and is the same on all ranks. Measuring the disorder requires a
+    reduction over all ranks, so it is not repeated on every call: assuming that the disorder grows linearly since the
+    last sort, the next measurement is scheduled for the time step at which it is expected to reach the maximum, but
+    no later than the number of steps since the last sort. The schedule only depends on the reduced disorder and
+    the time step, so all ranks follow it without communication.
  */
 void SFCPackUpdater::update(unsigned int timestep)
     {
+    if (m_max_disorder > Scalar(0.0))
+        {
+        // start the schedule at the first time step this updater sees, which is not 0 after a restart, and restart it
+        // when the time step has been reset since the last sort
+        if (!m_schedule_started || timestep < m_last_sort_step)
+            {
+            m_last_sort_step = m_next_check = timestep;
+            m_schedule_started = true;
+            }
+
+        if (timestep < m_next_check)
+            return;
+
+        Scalar disorder = computeDisorder();
+        if (disorder <= m_max_disorder)
+            {
+            unsigned int elapsed = timestep - m_last_sort_step;
+            unsigned int wait = elapsed;
+            if (disorder > Scalar(0.0))
+                wait = (unsigned int)std::min(double(elapsed), double(elapsed) * (m_max_disorder / disorder - 1.0));
+            m_next_check = timestep + wait;
+
+            m_exec_conf->msg->notice(6) << "SFCPackUpdater: skipping sort, disorder " << disorder
+                                        << ", next check at step " << m_next_check << std::endl;
+            return;
+            }
+        }
+
     m_exec_conf->msg->notice(6) << "SFCPackUpdater: particle sort" << std::endl;
 
     #ifdef ENABLE_MPI
@@ -93,10 +138,14 @@ void SFCPackUpdater::update(unsigned int timestep)
         getSortedOrder3D();
 
     // apply that sort order to the particles
+    m_reorder_known = false;
     applySortOrder();
 
     // trigger sort signal (this also forces particle migration)
-    m_pdata->notifyParticleSort();
+    if (m_reorder_known)
+        m_pdata->notifyParticleReorder(m_sort_order_alt.data(), m_pdata->getN(), m_pdata->getN());
+    else
+        m_pdata->notifyParticleSort();
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -106,146 +155,149 @@ void SFCPackUpdater::update(unsigned int timestep)
         }
     #endif
 
+    m_last_sort_step = m_next_check = timestep;
+    m_schedule_started = true;
+
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*! The sorted order is applied to all per-particle arrays in a single threaded region that gathers into the
+    alternate arrays of ParticleData, which are then swapped in without copying.
+*/
 void SFCPackUpdater::applySortOrder()
     {
     assert(m_pdata);
     assert(m_sort_order.size() >= m_pdata->getN());
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
-
-    // construct a temporary holding array for the sorted data
-    Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
-
-    // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
-
-    // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
-
-    Scalar3 *scal3_tmp = new Scalar3[m_pdata->getN()];
-    // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
-
-    Scalar *scal_tmp  = new Scalar[m_pdata->getN()];
-    // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
-
-    // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
-
-    // sort angular momentum
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_angmom.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_angmom.data[i] = scal4_tmp[i];
-
-    // sort moment of inertia
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_inertia.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_inertia.data[i] = scal3_tmp[i];
-
-    // in case anyone access it from frame to frame, sort the net virial
-        {
-        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
-        unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
 
-        for (unsigned int j = 0; j < 6; j++)
+        {
+        // access alternate arrays to write to
+        ArrayHandle<Scalar4> h_pos_alt(m_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel_alt(m_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel_alt(m_pdata->getAltAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge_alt(m_pdata->getAltCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter_alt(m_pdata->getAltDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image_alt(m_pdata->getAltImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body_alt(m_pdata->getAltBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag_alt(m_pdata->getAltTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation_alt(m_pdata->getAltOrientationArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom_alt(m_pdata->getAltAngularMomentumArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia_alt(m_pdata->getAltMomentsOfInertiaArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial_alt(m_pdata->getAltNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force_alt(m_pdata->getAltNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque_alt(m_pdata->getAltNetTorqueArray(), access_location::host, access_mode::overwrite);
+
+        // access live particle data to read from
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+
+        // access rtags
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+        // the live and alternate virial arrays are allocated identically and share the pitch
+        const unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+        const unsigned int N = m_pdata->getN();
+
+        // gather each array in turn inside a single parallel region. Streaming through one array at a time keeps the
+        // number of pages touched per iteration small, which is faster than gathering all arrays per particle
+        #pragma omp parallel
             {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j*virial_pitch+i] = scal_tmp[i];
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_pos_alt.data[i] = h_pos.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_vel_alt.data[i] = h_vel.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_accel_alt.data[i] = h_accel.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_charge_alt.data[i] = h_charge.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_diameter_alt.data[i] = h_diameter.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_image_alt.data[i] = h_image.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_body_alt.data[i] = h_body.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_orientation_alt.data[i] = h_orientation.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_angmom_alt.data[i] = h_angmom.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_inertia_alt.data[i] = h_inertia.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_net_force_alt.data[i] = h_net_force.data[m_sort_order[i]];
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                h_net_torque_alt.data[i] = h_net_torque.data[m_sort_order[i]];
+
+            for (unsigned int j = 0; j < 6; j++)
+                {
+                #pragma omp for schedule(static) nowait
+                for (int i = 0; i < (int)N; i++)
+                    h_net_virial_alt.data[j*virial_pitch+i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
+                }
+
+            // sort the tags, rebuild the rtags and record the new index of every particle for the sort signal
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < (int)N; i++)
+                {
+                unsigned int old_idx = m_sort_order[i];
+                unsigned int tag = h_tag.data[old_idx];
+                h_tag_alt.data[i] = tag;
+                h_rtag.data[tag] = i;
+                m_sort_order_alt[old_idx] = i;
+                }
             }
         }
 
-    // sort net force, net torque, and orientation
-        {
-        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
-        }
-
-        {
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
-        }
-
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
-        }
-
-    // sort image
-    int3 *int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
-
-    // sort body
-    unsigned int *uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
-
-    // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
-
-    // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        h_rtag.data[h_tag.data[i]] = i;
-        }
-
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
-
+    m_reorder_known = true;
+
+    // make alternate arrays current
+    m_pdata->swapPositions();
+    m_pdata->swapVelocities();
+    m_pdata->swapAccelerations();
+    m_pdata->swapCharges();
+    m_pdata->swapDiameters();
+    m_pdata->swapImages();
+    m_pdata->swapBodies();
+    m_pdata->swapTags();
+    m_pdata->swapOrientations();
+    m_pdata->swapAngularMomenta();
+    m_pdata->swapMomentsOfInertia();
+    m_pdata->swapNetVirial();
+    m_pdata->swapNetForce();
+    m_pdata->swapNetTorque();
     }
 
 //! x walking table for the hilbert curve
@@ -441,60 +493,13 @@ void SFCPackUpdater::generateTraversalOrder(int i, int j, int k, int w, int Mx,
         }
     }
 
-void SFCPackUpdater::getSortedOrder2D()
-    {
-    // start by checking the saneness of some member variables
-    assert(m_pdata);
-    assert(m_sort_order.size() >= m_pdata->getN());
-
-    // make even bin dimensions
-    const BoxDim& box = m_pdata->getBox();
-
-    // put the particles in the bins
-    {
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-
-    // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
-        {
-        // find the bin each particle belongs in
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
-
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
-
-        // record its bin
-        unsigned int bin = ib*m_grid + jb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
-        }
-    }
-
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
-    }
-
-void SFCPackUpdater::getSortedOrder3D()
+/*! Regenerates the hilbert curve traversal order of the 3D grid when the grid dimension has changed. Nothing needs to
+    be done in 2D, where the bins are ordered row by row.
+*/
+void SFCPackUpdater::updateTraversalOrder()
     {
-    // start by checking the saneness of some member variables
-    assert(m_pdata);
-    assert(m_sort_order.size() >= m_pdata->getN());
-
-    // make even bin dimensions
-    const BoxDim& box = m_pdata->getBox();
+    if (m_sysdef->getNDimensions() == 2)
+        return;
 
     // reallocate memory arrays if m_grid changed
     // also regenerate the traversal order
@@ -538,48 +543,207 @@ void SFCPackUpdater::getSortedOrder3D()
         }
 
     // sanity checks
-    assert(m_particle_bins.size() >= m_pdata->getN());
     assert(m_traversal_order.getNumElements() == m_grid*m_grid*m_grid);
+    }
 
-    // put the particles in the bins
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+/*! \param postype Position of the particle
+    \param box Simulation box
+    \param traversal_order Traversal order of the 3D grid, or NULL in 2D
+    \returns The position of the particle's bin along the space filling curve
+*/
+inline unsigned int SFCPackUpdater::getCurvePosition(const Scalar4& postype,
+                                                     const BoxDim& box,
+                                                     const unsigned int *traversal_order) const
+    {
+    // find the bin the particle belongs in
+    Scalar3 p = make_scalar3(postype.x, postype.y, postype.z);
+    Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
+    int ib = (unsigned int)(f.x * m_grid) % m_grid;
+    int jb = (unsigned int)(f.y * m_grid) % m_grid;
+
+    // if the particle is slightly outside, move back into grid
+    if (ib < 0) ib = 0;
+    if (ib >= (int)m_grid) ib = m_grid - 1;
+
+    if (jb < 0) jb = 0;
+    if (jb >= (int)m_grid) jb = m_grid - 1;
+
+    if (!traversal_order)
+        return ib*m_grid + jb;
+
+    int kb = (unsigned int)(f.z * m_grid) % m_grid;
+    if (kb < 0) kb = 0;
+    if (kb >= (int)m_grid) kb = m_grid - 1;
+
+    return traversal_order[ib*(m_grid*m_grid) + jb * m_grid + kb];
+    }
+
+/*! m_particle_bins is filled with the position along the space filling curve of the bin of every local particle,
+    in the current memory order. In 2D the bins are ordered row by row, in 3D along the hilbert curve, whose traversal
+    order is regenerated when the grid dimension changes.
+*/
+void SFCPackUpdater::computeBins()
+    {
+    // start by checking the saneness of some member variables
+    assert(m_pdata);
+    assert(m_particle_bins.size() >= m_pdata->getN());
+
+    updateTraversalOrder();
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int N = m_pdata->getN();
 
-    // access traversal order
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::read);
+    const unsigned int *traversal_order = (m_sysdef->getNDimensions() == 2) ? NULL : h_traversal_order.data;
 
     // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < (int)N; n++)
+        m_particle_bins[n] = getCurvePosition(h_pos.data[n], box, traversal_order);
+    }
+
+/*! Sorts the particle indices by m_particle_bins with a least significant digit radix sort on 8 bit digits. Each
+    pass builds a digit histogram per thread over a contiguous chunk of particles, turns the histograms into scatter
+    offsets ordered by digit and then by thread, and scatters in parallel. The sort is stable, so particles in the same
+    bin keep their relative order, exactly like sorting (bin, index) pairs.
+
+    \post m_sort_order[j] is the index of the particle that moves to position j
+*/
+void SFCPackUpdater::sortBins()
+    {
+    const unsigned int N = m_pdata->getN();
+
+    // only sort as many digits as there are bins along the curve
+    unsigned int n_bins = (m_sysdef->getNDimensions() == 2) ? m_grid*m_grid : m_grid*m_grid*m_grid;
+    unsigned int n_bits = 0;
+    while (n_bits < 32 && ((n_bins-1) >> n_bits) != 0)
+        n_bits++;
+
+    const unsigned int radix_bits = 8;
+    const unsigned int radix = 1 << radix_bits;
+
+    unsigned int n_threads = 1;
+    #ifdef ENABLE_OPENMP
+    n_threads = omp_get_max_threads();
+    #endif
+    m_digit_offsets.resize(n_threads*radix);
+
+    // start from the identity permutation
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < (int)N; i++)
+        m_sort_order[i] = i;
+
+    for (unsigned int shift = 0; shift < n_bits; shift += radix_bits)
         {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-        int kb = (unsigned int)(f.z * m_grid) % m_grid;
+        #pragma omp parallel num_threads(n_threads)
+            {
+            // the runtime may provide fewer threads than requested
+            unsigned int tid = 0;
+            unsigned int n_active = 1;
+            #ifdef ENABLE_OPENMP
+            tid = omp_get_thread_num();
+            n_active = omp_get_num_threads();
+            #endif
+            unsigned int begin = (unsigned int)((unsigned long long)N * tid / n_active);
+            unsigned int end = (unsigned int)((unsigned long long)N * (tid+1) / n_active);
+            unsigned int *offsets = &m_digit_offsets[tid*radix];
+
+            // count the digits in this thread's chunk
+            for (unsigned int d = 0; d < radix; d++)
+                offsets[d] = 0;
+            for (unsigned int i = begin; i < end; i++)
+                offsets[(m_particle_bins[i] >> shift) & (radix-1)]++;
+
+            #pragma omp barrier
+
+            // convert the counts to scatter offsets, ordered by digit first and thread second
+            #pragma omp single
+                {
+                unsigned int sum = 0;
+                for (unsigned int d = 0; d < radix; d++)
+                    for (unsigned int t = 0; t < n_active; t++)
+                        {
+                        unsigned int count = m_digit_offsets[t*radix+d];
+                        m_digit_offsets[t*radix+d] = sum;
+                        sum += count;
+                        }
+                }
+
+            // scatter this thread's chunk, preserving its order
+            for (unsigned int i = begin; i < end; i++)
+                {
+                unsigned int bin = m_particle_bins[i];
+                unsigned int pos = offsets[(bin >> shift) & (radix-1)]++;
+                m_particle_bins_alt[pos] = bin;
+                m_sort_order_alt[pos] = m_sort_order[i];
+                }
+            }
 
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
+        m_particle_bins.swap(m_particle_bins_alt);
+        m_sort_order.swap(m_sort_order_alt);
+        }
+    }
 
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
+void SFCPackUpdater::getSortedOrder2D()
+    {
+    computeBins();
+    sortBins();
+    }
 
-        if (kb < 0) kb = 0;
-        if (kb >= (int)m_grid) kb = m_grid - 1;
+void SFCPackUpdater::getSortedOrder3D()
+    {
+    computeBins();
+    sortBins();
+    }
 
-        // record its bin
-        unsigned int bin = ib*(m_grid*m_grid) + jb * m_grid + kb;
+/*! \returns The fraction of particles whose successor in memory is further along the space filling curve than 64
+    average particle spacings. It is close to 0 right after a sort and close to 1 for a random order. In MPI
+    simulations the maximum over all ranks is returned.
 
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
+    The fraction is estimated from at most 4096 pairs of consecutive particles spread evenly over the local particles,
+    which gives an absolute error below about 0.01 at a cost that does not grow with the number of particles.
+*/
+Scalar SFCPackUpdater::computeDisorder()
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "SFCPack disorder");
+
+    updateTraversalOrder();
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int N = m_pdata->getN();
+    unsigned int n_bins = (m_sysdef->getNDimensions() == 2) ? m_grid*m_grid : m_grid*m_grid*m_grid;
+    double window = 64.0 * double(n_bins) / double(N > 0 ? N : 1);
+
+    const unsigned int max_samples = 4096;
+    unsigned int n_samples = (N > 1) ? std::min(N-1, max_samples) : 0;
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::read);
+    const unsigned int *traversal_order = (m_sysdef->getNDimensions() == 2) ? NULL : h_traversal_order.data;
+
+    unsigned int n_far = 0;
+    for (unsigned int s = 0; s < n_samples; s++)
+        {
+        unsigned int i = (unsigned int)((unsigned long long)s * (N-1) / n_samples);
+        double delta = fabs(double(getCurvePosition(h_pos.data[i+1], box, traversal_order))
+                            - double(getCurvePosition(h_pos.data[i], box, traversal_order)));
+        if (delta > window)
+            n_far++;
         }
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
+    Scalar disorder = (n_samples > 0) ? Scalar(n_far) / Scalar(n_samples) : Scalar(0.0);
 
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
+    #ifdef ENABLE_MPI
+    if (m_comm)
         {
-        m_sort_order[j] = m_particle_bins[j].second;
+        MPI_Allreduce(MPI_IN_PLACE, &disorder, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_exec_conf->getMPICommunicator());
         }
+    #endif
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+
+    return disorder;
     }
 
 void SFCPackUpdater::writeTraversalOrder(const std::string& fname, const vector< unsigned int >& reverse_order)
@@ -617,5 +781,7 @@ void export_SFCPackUpdater(py::module& m)
     py::class_<SFCPackUpdater, std::shared_ptr<SFCPackUpdater> >(m,"SFCPackUpdater",py::base<Updater>())
     .def(py::init< std::shared_ptr<SystemDefinition> >())
     .def("setGrid", &SFCPackUpdater::setGrid)
+    .def("setMaxDisorder", &SFCPackUpdater::setMaxDisorder)
+    .def("computeDisorder", &SFCPackUpdater::computeDisorder)
     ;
     }
@@ -42,7 +42,18 @@
     Implementation details:<br>
     The rearranging is done by computing bins for the particles, and then ordering the particles based on the order in
     which those bins appear along a hilbert curve. It is very efficient, even when the box size changes often as the
-    grid dimension is kept constant.
+    grid dimension is kept constant. The (bin, particle) pairs are ordered with a threaded LSD radix sort, which is
+    stable and so produces the same order as a comparison sort of the pairs. All per-particle arrays are then gathered
+    into the alternate particle data arrays in a single threaded pass and swapped in.
+
+    Adaptive sorting:<br>
+    When setMaxDisorder() is given a value greater than 0, the sort is skipped on a scheduled time step unless the
+    particles have become sufficiently disordered along the curve. The disorder is the fraction of particles whose
+    successor in memory lies further along the curve than 64 average particle spacings, and is close to 0 right after a
+    sort and close to 1 for a random order. It measures the memory locality of neighboring particles directly, so slowly
+    diffusing systems are sorted less often without having to tune the period by hand. The disorder is estimated from a
+    fixed size sample of particles, and is measured less and less often while it stays below the maximum (see
+    update()).
 
     \ingroup updaters
 */
@@ -67,10 +78,27 @@ class SFCPackUpdater : public Updater
             m_grid = (unsigned int)pow(2.0, ceil(log(double(grid)) / log(2.0)));;
             }
 
+        //! Set the disorder below which a scheduled sort is skipped
+        /*! \param max_disorder Fraction of out of place particles that triggers a sort (0 always sorts)
+        */
+        void setMaxDisorder(Scalar max_disorder)
+            {
+            m_max_disorder = max_disorder;
+            m_next_check = 0;
+            }
+
+        //! Measure the disorder of the current particle order
+        Scalar computeDisorder();
+
     protected:
         unsigned int m_grid;        //!< Grid dimension to use
         unsigned int m_last_grid;   //!< The last value of MMax
         unsigned int m_last_dim;    //!< Check the last dimension we ran at
+        Scalar m_max_disorder;      //!< Disorder below which a scheduled sort is skipped
+        unsigned int m_last_sort_step;  //!< Time step of the last sort
+        unsigned int m_next_check;  //!< Time step of the next disorder measurement
+        bool m_schedule_started;    //!< True once m_last_sort_step and m_next_check have been set by update()
+        bool m_reorder_known;       //!< True if applySortOrder() recorded the new index of every particle
         GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins
 
         //! Helper function that actually performs the sort
@@ -90,9 +118,25 @@ class SFCPackUpdater : public Updater
         //! Reallocate internal arrays
         virtual void reallocate();
 
-    private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
-        std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
+        std::vector<unsigned int> m_particle_bins;          //!< Position of each particle's bin along the curve
+
+        //! Compute the position of each particle's bin along the curve
+        void computeBins();
+
+        //! Sort the particles by bin with a stable radix sort
+        void sortBins();
+
+    private:
+        std::vector<unsigned int> m_sort_order_alt;         //!< Radix sort scratch for m_sort_order, new index of each particle after the sort
+        std::vector<unsigned int> m_particle_bins_alt;      //!< Radix sort scratch for m_particle_bins
+        std::vector<unsigned int> m_digit_offsets;          //!< Per-thread digit histograms of the radix sort
+
+        //! Regenerate the traversal order of the 3D grid if needed
+        void updateTraversalOrder();
+
+        //! Compute the position of a particle's bin along the curve
+        unsigned int getCurvePosition(const Scalar4& postype, const BoxDim& box, const unsigned int *traversal_order) const;
 
    };
 
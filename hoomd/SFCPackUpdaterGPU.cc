@@ -48,6 +48,9 @@ SFCPackUpdaterGPU::SFCPackUpdaterGPU(std::shared_ptr<SystemDefinition> sysdef)
  */
 void SFCPackUpdaterGPU::reallocate()
     {
+    // the host arrays are used to measure the disorder
+    SFCPackUpdater::reallocate();
+
     m_gpu_sort_order.resize(m_pdata->getMaxN());
     m_gpu_particle_bins.resize(m_pdata->getMaxN());
     }
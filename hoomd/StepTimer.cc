@@ -0,0 +1,207 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file StepTimer.cc
+    \brief Defines the StepTimer class
+*/
+
+#include "StepTimer.h"
+
+namespace py = pybind11;
+
+using namespace std;
+
+const unsigned int StepTimer::NO_REGION;
+
+//! Minimum time in ns over which the tick rate is calibrated
+const int64_t STEP_TIMER_MIN_CALIBRATION = 10000000;
+
+StepTimer::StepTimer(unsigned int history)
+    : m_history(history > 0 ? history : 1), m_enabled(true), m_depth(0)
+    {
+    for (unsigned int i = 0; i < MAX_DEPTH; i++)
+        m_child_ticks[i] = 0;
+
+    m_calib_time = m_clk.getTime();
+    m_calib_ticks = ClockSource::getTicks();
+    }
+
+/*! \param name Name of the region
+    \returns Id of the region
+
+    Registering a name a second time returns the id of the existing region.
+*/
+unsigned int StepTimer::registerRegion(const std::string& name)
+    {
+    map<string, unsigned int>::iterator i = m_ids.find(name);
+    if (i != m_ids.end())
+        return i->second;
+
+    Region r;
+    r.name = name;
+    r.ticks.resize(m_history);
+    r.steps.resize(m_history);
+    resetRegion(r);
+
+    unsigned int id = (unsigned int)m_regions.size();
+    m_regions.push_back(r);
+    m_ids[name] = id;
+    return id;
+    }
+
+/*! \param name Name of the region
+    \returns Id of the region, or NO_REGION if no region of that name is registered
+*/
+unsigned int StepTimer::findRegion(const std::string& name) const
+    {
+    map<string, unsigned int>::const_iterator i = m_ids.find(name);
+    if (i == m_ids.end())
+        return NO_REGION;
+    return i->second;
+    }
+
+/*! \param history Number of steps kept in the ring buffer of each region
+
+    The ring buffers are cleared. Total and self times are kept.
+*/
+void StepTimer::setHistoryLength(unsigned int history)
+    {
+    m_history = history > 0 ? history : 1;
+    for (unsigned int i = 0; i < m_regions.size(); i++)
+        {
+        m_regions[i].ticks.assign(m_history, 0);
+        m_regions[i].steps.assign(m_history, 0);
+        m_regions[i].last = m_history - 1;
+        m_regions[i].num_entries = 0;
+        }
+    }
+
+/*! Regions stay registered. The calibration of the tick rate is restarted.
+*/
+void StepTimer::reset()
+    {
+    for (unsigned int i = 0; i < m_regions.size(); i++)
+        resetRegion(m_regions[i]);
+
+    m_calib_time = m_clk.getTime();
+    m_calib_ticks = ClockSource::getTicks();
+    }
+
+void StepTimer::resetRegion(Region& r)
+    {
+    r.last = m_history - 1;
+    r.num_entries = 0;
+    r.total_ticks = 0;
+    r.self_ticks = 0;
+    r.num_steps = 0;
+    }
+
+/*! \param region Id of the region
+    \returns The mean over the entries in the ring buffer, or 0 if the region did not execute yet
+*/
+double StepTimer::getMeanTime(unsigned int region) const
+    {
+    const Region& r = m_regions[region];
+    if (r.num_entries == 0)
+        return 0.0;
+
+    uint64_t sum = 0;
+    for (unsigned int i = 0; i < r.num_entries; i++)
+        sum += r.ticks[(r.last + m_history - i) % m_history];
+
+    return double(sum) / double(r.num_entries) / getTicksPerSecond();
+    }
+
+/*! \param region Id of the region
+*/
+double StepTimer::getLastTime(unsigned int region) const
+    {
+    const Region& r = m_regions[region];
+    if (r.num_entries == 0)
+        return 0.0;
+    return double(r.ticks[r.last]) / getTicksPerSecond();
+    }
+
+/*! \param region Id of the region
+*/
+double StepTimer::getTotalTime(unsigned int region) const
+    {
+    return double(m_regions[region].total_ticks) / getTicksPerSecond();
+    }
+
+/*! \param region Id of the region
+*/
+double StepTimer::getSelfTime(unsigned int region) const
+    {
+    return double(m_regions[region].self_ticks) / getTicksPerSecond();
+    }
+
+/*! \param region Id of the region
+*/
+std::vector<double> StepTimer::getHistory(unsigned int region) const
+    {
+    const Region& r = m_regions[region];
+    double ticks_per_second = getTicksPerSecond();
+
+    vector<double> result(r.num_entries);
+    for (unsigned int i = 0; i < r.num_entries; i++)
+        result[r.num_entries - 1 - i] = double(r.ticks[(r.last + m_history - i) % m_history]) / ticks_per_second;
+    return result;
+    }
+
+/*! \param region Id of the region
+*/
+std::vector<unsigned int> StepTimer::getHistorySteps(unsigned int region) const
+    {
+    const Region& r = m_regions[region];
+
+    vector<unsigned int> result(r.num_entries);
+    for (unsigned int i = 0; i < r.num_entries; i++)
+        result[r.num_entries - 1 - i] = r.steps[(r.last + m_history - i) % m_history];
+    return result;
+    }
+
+/*! The rate is measured against the system clock over the time since construction or the last reset. If that is
+    shorter than 10 ms, the call waits until 10 ms have passed.
+*/
+double StepTimer::getTicksPerSecond() const
+    {
+    #if defined(__x86_64__) || defined(__i386__)
+    int64_t elapsed = m_clk.getTime() - m_calib_time;
+    if (elapsed < STEP_TIMER_MIN_CALIBRATION)
+        {
+        usleep((STEP_TIMER_MIN_CALIBRATION - elapsed) / 1000 + 1);
+        elapsed = m_clk.getTime() - m_calib_time;
+        }
+
+    uint64_t ticks = ClockSource::getTicks() - m_calib_ticks;
+    return double(ticks) / double(elapsed) * 1e9;
+    #else
+    // the ticks are nanoseconds
+    return 1e9;
+    #endif
+    }
+
+void export_StepTimer(py::module& m)
+    {
+    py::class_<StepTimer>(m, "StepTimer")
+        .def("registerRegion", &StepTimer::registerRegion)
+        .def("findRegion", &StepTimer::findRegion)
+        .def("getNumRegions", &StepTimer::getNumRegions)
+        .def("getRegionName", &StepTimer::getRegionName, py::return_value_policy::copy)
+        .def("setEnabled", &StepTimer::setEnabled)
+        .def("isEnabled", &StepTimer::isEnabled)
+        .def("setHistoryLength", &StepTimer::setHistoryLength)
+        .def("getHistoryLength", &StepTimer::getHistoryLength)
+        .def("reset", &StepTimer::reset)
+        .def("getMeanTime", &StepTimer::getMeanTime)
+        .def("getLastTime", &StepTimer::getLastTime)
+        .def("getTotalTime", &StepTimer::getTotalTime)
+        .def("getSelfTime", &StepTimer::getSelfTime)
+        .def("getNumSteps", &StepTimer::getNumSteps)
+        .def("getHistory", &StepTimer::getHistory)
+        .def("getHistorySteps", &StepTimer::getHistorySteps)
+        .def("getTicksPerSecond", &StepTimer::getTicksPerSecond)
+        ;
+    }
@@ -0,0 +1,239 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file StepTimer.h
+    \brief Declares the StepTimer class
+*/
+
+#ifndef __STEP_TIMER_H__
+#define __STEP_TIMER_H__
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ClockSource.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Always-on timing of the computes, updaters and analyzers in a run
+/*! Profiler identifies its sections by strings and looks them up in a map on every push(). That is too slow to
+    leave on for fast steps, so it has to be enabled explicitly. StepTimer is meant to stay enabled in production
+    runs: regions are registered once by name and are afterwards addressed by an integer id. Starting and stopping
+    a region reads the tick counter of ClockSource and updates a few counters, which costs tens of nanoseconds.
+
+    For every region, StepTimer keeps the total and self time since the last reset, and a ring buffer with the
+    time spent in the region on each of the last getHistoryLength() steps it executed. Executions of the same
+    region on the same time step are summed into one entry. Regions may nest, and the self time of a region
+    excludes the time spent in the regions started inside it. ExecutionConfiguration owns one instance.
+
+    System registers a region for each compute, updater, analyzer and the integrator, named after the python class
+    of the object (e.g. PotentialPairLJ). Components of the same class share a region. The Logger provides the
+    mean time per step of a region as the log quantity \c time_<region name>.
+
+    Ticks are converted to seconds with a rate calibrated against the system clock since construction or the
+    last reset.
+
+    StepTimer is not thread safe. Regions must be started and stopped by the thread that runs the time step loop,
+    outside of parallel sections.
+*/
+class StepTimer
+    {
+    public:
+        //! Id returned by findRegion() for unknown names
+        static const unsigned int NO_REGION = 0xffffffff;
+
+        //! Constructor
+        /*! \param history Number of steps kept in the ring buffer of each region
+        */
+        StepTimer(unsigned int history=100);
+
+        //! Register a region
+        unsigned int registerRegion(const std::string& name);
+
+        //! Look up the id of a region
+        unsigned int findRegion(const std::string& name) const;
+
+        //! Get the number of registered regions
+        unsigned int getNumRegions() const
+            {
+            return (unsigned int)m_regions.size();
+            }
+
+        //! Get the name of a region
+        const std::string& getRegionName(unsigned int region) const
+            {
+            return m_regions[region].name;
+            }
+
+        //! Enable or disable timing
+        /*! \param enable Set to false to turn timing off
+        */
+        void setEnabled(bool enable)
+            {
+            m_enabled = enable;
+            }
+
+        //! Test if timing is enabled
+        bool isEnabled() const
+            {
+            return m_enabled;
+            }
+
+        //! Set the length of the ring buffers
+        void setHistoryLength(unsigned int history);
+
+        //! Get the length of the ring buffers
+        unsigned int getHistoryLength() const
+            {
+            return m_history;
+            }
+
+        //! Clear the timings of all regions
+        void reset();
+
+        //! Start a region
+        /*! \returns The tick count to pass to stop()
+        */
+        uint64_t start()
+            {
+            m_depth++;
+            if (m_depth < MAX_DEPTH)
+                m_child_ticks[m_depth] = 0;
+            return ClockSource::getTicks();
+            }
+
+        //! Stop a region
+        /*! \param region Id of the region
+            \param timestep Current time step
+            \param start_ticks Value returned by the matching start()
+        */
+        void stop(unsigned int region, unsigned int timestep, uint64_t start_ticks)
+            {
+            uint64_t elapsed = ClockSource::getTicks() - start_ticks;
+            uint64_t child = (m_depth < MAX_DEPTH) ? m_child_ticks[m_depth] : 0;
+            m_depth--;
+            if (m_depth < MAX_DEPTH)
+                m_child_ticks[m_depth] += elapsed;
+
+            Region& r = m_regions[region];
+            r.total_ticks += elapsed;
+            r.self_ticks += elapsed - (child < elapsed ? child : elapsed);
+
+            if (r.num_entries == 0 || r.steps[r.last] != timestep)
+                {
+                r.last = (r.last + 1) % m_history;
+                r.ticks[r.last] = 0;
+                r.steps[r.last] = timestep;
+                if (r.num_entries < m_history)
+                    r.num_entries++;
+                r.num_steps++;
+                }
+            r.ticks[r.last] += elapsed;
+            }
+
+        //! Get the mean time per step over the ring buffer, in seconds
+        double getMeanTime(unsigned int region) const;
+
+        //! Get the time spent on the last step the region executed, in seconds
+        double getLastTime(unsigned int region) const;
+
+        //! Get the total time since the last reset, in seconds
+        double getTotalTime(unsigned int region) const;
+
+        //! Get the self time since the last reset, in seconds
+        double getSelfTime(unsigned int region) const;
+
+        //! Get the number of steps the region executed since the last reset
+        unsigned long long getNumSteps(unsigned int region) const
+            {
+            return m_regions[region].num_steps;
+            }
+
+        //! Get the times per step in the ring buffer, oldest first, in seconds
+        std::vector<double> getHistory(unsigned int region) const;
+
+        //! Get the time steps of the entries in the ring buffer, oldest first
+        std::vector<unsigned int> getHistorySteps(unsigned int region) const;
+
+        //! Get the calibrated rate of the tick counter
+        double getTicksPerSecond() const;
+
+    private:
+        //! Maximum nesting depth that is accounted for in the self times
+        static const unsigned int MAX_DEPTH = 32;
+
+        //! Timings of one region
+        struct Region
+            {
+            std::string name;               //!< Name of the region
+            std::vector<uint64_t> ticks;    //!< Ring buffer of ticks per step
+            std::vector<unsigned int> steps;    //!< Time steps of the ring buffer entries
+            unsigned int last;              //!< Index of the newest entry
+            unsigned int num_entries;       //!< Number of valid entries
+            uint64_t total_ticks;           //!< Ticks since the last reset
+            uint64_t self_ticks;            //!< Ticks not spent in nested regions
+            unsigned long long num_steps;   //!< Steps executed since the last reset
+            };
+
+        std::vector<Region> m_regions;                  //!< Registered regions, indexed by id
+        std::map<std::string, unsigned int> m_ids;      //!< Region ids by name
+        unsigned int m_history;                         //!< Length of the ring buffers
+        bool m_enabled;                                 //!< True if timing is enabled
+
+        unsigned int m_depth;                           //!< Number of open regions
+        uint64_t m_child_ticks[MAX_DEPTH];              //!< Ticks of the nested regions at each depth
+
+        ClockSource m_clk;                              //!< Reference clock for the calibration
+        int64_t m_calib_time;                           //!< Reference time at the start of the calibration
+        uint64_t m_calib_ticks;                         //!< Tick count at the start of the calibration
+
+        //! Clear the timings of one region
+        void resetRegion(Region& r);
+    };
+
+//! Times a region for the lifetime of the object
+/*! Nothing is recorded if the timer is disabled or the region is StepTimer::NO_REGION.
+*/
+class StepTimerScope
+    {
+    public:
+        //! Start the region
+        /*! \param timer Timer to record into
+            \param region Id of the region
+            \param timestep Current time step
+        */
+        StepTimerScope(StepTimer& timer, unsigned int region, unsigned int timestep)
+            : m_timer(timer), m_region(region), m_timestep(timestep), m_active(false), m_start(0)
+            {
+            if (region != StepTimer::NO_REGION && timer.isEnabled())
+                {
+                m_active = true;
+                m_start = timer.start();
+                }
+            }
+
+        //! Stop the region
+        ~StepTimerScope()
+            {
+            if (m_active)
+                m_timer.stop(m_region, m_timestep, m_start);
+            }
+
+    private:
+        StepTimer& m_timer;         //!< Timer to record into
+        unsigned int m_region;      //!< Id of the region
+        unsigned int m_timestep;    //!< Current time step
+        bool m_active;              //!< True if the region was started
+        uint64_t m_start;           //!< Tick count at the start
+    };
+
+//! Exports StepTimer to python
+void export_StepTimer(pybind11::module& m);
+
+#endif
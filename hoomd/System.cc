@@ -11,6 +11,7 @@
 
 #include "System.h"
 #include "SignalHandler.h"
+#include "TraceRecorder.h"
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
@@ -25,6 +26,39 @@ namespace py = pybind11;
 
 PyObject* walltimeLimitExceptionTypeObj = 0;
 
+//! Get the name of the StepTimer region of a component
+/*! \param obj The component
+    \param name Name the component is added to the System with
+    \returns The name of the python class of \a obj (e.g. PotentialPairLJ), or \a name if python is not available
+*/
+template<class T>
+static std::string get_timing_name(std::shared_ptr<T> obj, const std::string& name)
+    {
+    if (!Py_IsInitialized())
+        return name;
+
+    try
+        {
+        // unregistered types (e.g. in unit tests) give a null object
+        py::object pyobj = py::cast(obj);
+        if (!pyobj)
+            {
+            PyErr_Clear();
+            return name;
+            }
+        return pyobj.attr("__class__").attr("__name__").cast<std::string>();
+        }
+    catch (py::error_already_set& e)
+        {
+        PyErr_Clear();
+        return name;
+        }
+    catch (py::cast_error& e)
+        {
+        return name;
+        }
+    }
+
 /*! \param sysdef SystemDefinition for the system to be simulated
     \param initial_tstep Initial time step of the simulation
 
@@ -37,6 +71,8 @@ System::System(std::shared_ptr<SystemDefinition> sysdef, unsigned int initial_ts
         m_med_tps(0), m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
         m_profile(false), m_stats_period(10)
     {
+    m_integrator_timing_region = StepTimer::NO_REGION;
+
     // sanity check
     assert(m_sysdef);
     m_exec_conf = m_sysdef->getParticleData()->getExecConf();
@@ -93,6 +129,7 @@ void System::addAnalyzer(std::shared_ptr<Analyzer> analyzer, const std::string&
 
     // if we get here, we can add it
     m_analyzers.push_back(analyzer_item(analyzer, name, period, m_cur_tstep, start_step));
+    m_analyzers.back().m_timing_region = m_exec_conf->getStepTimer().registerRegion(get_timing_name(analyzer, name));
     }
 
 /*! \param name Name of the Analyzer to find in m_analyzers
@@ -241,6 +278,7 @@ void System::addUpdater(std::shared_ptr<Updater> updater, const std::string& nam
 
     // if we get here, we can add it
     m_updaters.push_back(updater_item(updater, name, period, m_cur_tstep, start_step));
+    m_updaters.back().m_timing_region = m_exec_conf->getStepTimer().registerRegion(get_timing_name(updater, name));
     }
 
 /*! \param name Name of the Updater to be removed
@@ -307,7 +345,7 @@ unsigned int System::getUpdaterPeriod(const std::string& name)
     \param name Unique name to assign to this Compute
 
     Computes are added to the System only as a convenience for naming,
-    saving to restart files, and to activate profiling. They are never
+    saving to restart files, and to activate profiling and timing. They are never
     directly called by the system.
 */
 void System::addCompute(std::shared_ptr<Compute> compute, const std::string& name)
@@ -324,6 +362,8 @@ void System::addCompute(std::shared_ptr<Compute> compute, const std::string& nam
         m_exec_conf->msg->error() << "Compute " << name << " already exists" << endl;
         throw runtime_error("System: cannot add compute");
         }
+
+    compute->setTimingRegion(m_exec_conf->getStepTimer().registerRegion(get_timing_name(compute, name)));
     }
 
 
@@ -366,6 +406,10 @@ std::shared_ptr<Compute> System::getCompute(const std::string& name)
 void System::setIntegrator(std::shared_ptr<Integrator> integrator)
     {
     m_integrator = integrator;
+
+    m_integrator_timing_region = StepTimer::NO_REGION;
+    if (m_integrator)
+        m_integrator_timing_region = m_exec_conf->getStepTimer().registerRegion(get_timing_name(integrator, "integrator"));
     }
 
 /*! \returns A shared pointer to the Integrator for this System
@@ -468,6 +512,9 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_integrator->prepRun(m_cur_tstep);
         }
 
+    StepTimer& timer = m_exec_conf->getStepTimer();
+    TraceRecorder& trace = m_exec_conf->getTraceRecorder();
+
     // handle time steps
     for ( ; m_cur_tstep < m_end_tstep; m_cur_tstep++)
         {
@@ -558,12 +605,20 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
             #endif
             }
 
+        bool trace_step = trace.isActive();
+        if (trace_step)
+            trace.beginStep(m_cur_tstep);
+
         // execute analyzers
         vector<analyzer_item>::iterator analyzer;
         for (analyzer =  m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
             {
             if (analyzer->shouldExecute(m_cur_tstep))
+                {
+                StepTimerScope timing(timer, analyzer->m_timing_region, m_cur_tstep);
+                TraceScope tracing(trace, timer.getRegionName(analyzer->m_timing_region));
                 analyzer->m_analyzer->analyze(m_cur_tstep);
+                }
             }
 
         // execute updaters
@@ -571,7 +626,11 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         for (updater =  m_updaters.begin(); updater != m_updaters.end(); ++updater)
             {
             if (updater->shouldExecute(m_cur_tstep))
+                {
+                StepTimerScope timing(timer, updater->m_timing_region, m_cur_tstep);
+                TraceScope tracing(trace, timer.getRegionName(updater->m_timing_region));
                 updater->m_updater->update(m_cur_tstep);
+                }
             }
 
         // look ahead to the next time step and see which analyzers and updaters will be executed
@@ -580,16 +639,26 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
 
         // execute the integrator
         if (m_integrator)
+            {
+            StepTimerScope timing(timer, m_integrator_timing_region, m_cur_tstep);
+            TraceScope tracing(trace, timer.getRegionName(m_integrator_timing_region));
             m_integrator->update(m_cur_tstep);
+            }
+
+        if (trace_step)
+            trace.end();
 
         // quit if cntrl-C was pressed
         if (g_sigint_recvd)
             {
             g_sigint_recvd = 0;
+            flushAnalyzers();
             return;
             }
         }
 
+    flushAnalyzers();
+
     // generate a final status line
     generateStatusLine();
     m_last_status_tstep = m_cur_tstep;
@@ -615,7 +684,7 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_exec_conf->msg->notice(1) << "Average TPS: " << m_last_TPS << endl;
 
     // write out the profile data
-    if (m_profiler)
+    if (m_profiler && m_profile)
         m_exec_conf->msg->notice(1) << *m_profiler;
 
     if (!m_quiet_run)
@@ -697,11 +766,16 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
+    // a trace records the profiler sections, too
+    TraceRecorder& trace = m_exec_conf->getTraceRecorder();
+    if (m_profile || trace.isActive())
         m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation"));
     else
         m_profiler = std::shared_ptr<Profiler>();
 
+    if (m_profiler && trace.isActive())
+        m_profiler->setTraceRecorder(&trace);
+
     // set the profiler on everything
     if (m_integrator)
         m_integrator->setProfiler(m_profiler);
@@ -758,6 +832,13 @@ void System::printStats()
         compute->second->printStats();
     }
 
+void System::flushAnalyzers()
+    {
+    vector<analyzer_item>::iterator analyzer;
+    for (analyzer = m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        analyzer->m_analyzer->flush();
+    }
+
 void System::resetStats()
     {
     if (m_integrator)
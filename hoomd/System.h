@@ -51,6 +51,9 @@ class Communicator;
     Integrator::update() method is called to advance the simulation forward
     one step and the process is repeated again.
 
+    The analyzers, updaters, and the integrator are timed in the StepTimer of the ExecutionConfiguration, each in a
+    region named after its python class. Added computes are assigned a region, too, which they record in.
+
     \note Adding/removing/accessing analyzers, updaters, and computes by name
     is meant to be a once per simulation operation. In other words, the accesses
     are not optimized.
@@ -195,7 +198,8 @@ class System
             */
             analyzer_item(std::shared_ptr<Analyzer> analyzer, const std::string& name, unsigned int period,
                           unsigned int created_tstep, unsigned int next_execute_tstep)
-                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1)
+                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1),
+                      m_timing_region(StepTimer::NO_REGION)
                 {
                 }
 
@@ -286,6 +290,7 @@ class System
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             pybind11::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
+            unsigned int m_timing_region;           //!< StepTimer region of this item
             };
 
         std::vector<analyzer_item> m_analyzers; //!< List of analyzers belonging to this System
@@ -302,7 +307,8 @@ class System
             */
             updater_item(std::shared_ptr<Updater> updater, const std::string& name, unsigned int period,
                          unsigned int created_tstep, unsigned int next_execute_tstep)
-                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1)
+                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1),
+                      m_timing_region(StepTimer::NO_REGION)
                 {
                 }
 
@@ -392,6 +398,7 @@ class System
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             pybind11::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
+            unsigned int m_timing_region;           //!< StepTimer region of this item
             };
 
         std::vector<updater_item> m_updaters;   //!< List of updaters belonging to this System
@@ -399,6 +406,7 @@ class System
         std::map< std::string, std::shared_ptr<Compute> > m_computes; //!< Named list of Computes belonging to this System
 
         std::shared_ptr<Integrator> m_integrator;     //!< Integrator that advances time in this System
+        unsigned int m_integrator_timing_region;        //!< StepTimer region of the integrator
         std::shared_ptr<SystemDefinition> m_sysdef;   //!< SystemDefinition for this System
         std::shared_ptr<Profiler> m_profiler;         //!< Profiler to profile runs
 
@@ -430,6 +438,9 @@ class System
         //! Resets stats for all contained classes
         void resetStats();
 
+        //! Writes out the buffered output of all analyzers
+        void flushAnalyzers();
+
         //! Prints out a formatted status line
         void generateStatusLine();
 
@@ -0,0 +1,212 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file TraceRecorder.cc
+    \brief Defines the TraceRecorder class
+*/
+
+#include "TraceRecorder.h"
+#include "ExecutionConfiguration.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace py = pybind11;
+
+using namespace std;
+
+TraceRecorder::TraceRecorder(const ExecutionConfiguration *exec_conf)
+    : m_exec_conf(exec_conf), m_active(false), m_max_events(0), m_dropped_depth(0), m_warned(false)
+    {
+    }
+
+/*! \param filename File to write the trace to
+    \param max_events Maximum number of events kept per rank
+
+    Must be called collectively on all ranks. Events of a previous trace are discarded. With more than one partition,
+    every partition writes its own file, named \a filename followed by a dot and the partition index.
+*/
+void TraceRecorder::start(const std::string& filename, unsigned int max_events)
+    {
+    if (m_active)
+        {
+        m_exec_conf->msg->error() << "A trace is already being recorded to " << m_filename << endl;
+        throw runtime_error("Error starting trace");
+        }
+
+    m_filename = filename;
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNPartitions() > 1)
+        {
+        ostringstream oss;
+        oss << filename << "." << m_exec_conf->getPartition();
+        m_filename = oss.str();
+        }
+    #endif
+    m_max_events = max_events;
+    m_dropped_depth = 0;
+    m_warned = false;
+
+    m_events.clear();
+    m_events.reserve(std::min(max_events, 1u << 20));
+    m_names.clear();
+    m_name_ids.clear();
+
+    m_exec_conf->msg->notice(2) << "Recording a trace to " << m_filename << endl;
+
+    #ifdef ENABLE_MPI
+    // align the time stamps of all ranks
+    MPI_Barrier(m_exec_conf->getMPICommunicator());
+    #endif
+
+    m_clk = ClockSource();
+    m_active = true;
+    }
+
+/*! Must be called collectively on all ranks. The root rank writes the events of all ranks to the file.
+*/
+void TraceRecorder::stop()
+    {
+    if (!m_active)
+        return;
+
+    m_active = false;
+
+    string events = formatEvents();
+
+    vector<string> all_events;
+    #ifdef ENABLE_MPI
+    gather_v(events, all_events, 0, m_exec_conf->getMPICommunicator());
+    #else
+    all_events.push_back(events);
+    #endif
+
+    if (m_exec_conf->getRank() == 0)
+        {
+        ofstream f(m_filename.c_str());
+        if (!f.good())
+            {
+            m_exec_conf->msg->error() << "Unable to open trace file " << m_filename << " for writing" << endl;
+            throw runtime_error("Error writing trace");
+            }
+
+        f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+        bool first = true;
+        for (unsigned int i = 0; i < all_events.size(); i++)
+            {
+            if (all_events[i].empty())
+                continue;
+            if (!first)
+                f << "," << endl;
+            f << all_events[i];
+            first = false;
+            }
+        f << endl << "]}" << endl;
+
+        m_exec_conf->msg->notice(2) << "Wrote trace to " << m_filename << endl;
+        }
+
+    // release the memory
+    vector<Event>().swap(m_events);
+    }
+
+/*! \param name Name of a region
+    \returns Index of \a name in m_names
+*/
+unsigned int TraceRecorder::getNameId(const std::string& name)
+    {
+    map<string, unsigned int>::iterator i = m_name_ids.find(name);
+    if (i != m_name_ids.end())
+        return i->second;
+
+    unsigned int id = (unsigned int)m_names.size();
+    m_names.push_back(name);
+    m_name_ids[name] = id;
+    return id;
+    }
+
+void TraceRecorder::dropBegin()
+    {
+    m_dropped_depth++;
+
+    if (!m_warned)
+        {
+        m_exec_conf->msg->warning() << "Trace reached the maximum of " << m_max_events
+                                    << " events, dropping further events" << endl;
+        m_warned = true;
+        }
+    }
+
+//! Write a string as a JSON string literal
+static void write_json_string(std::ostream& o, const std::string& s)
+    {
+    o << '"';
+    for (unsigned int i = 0; i < s.size(); i++)
+        {
+        char c = s[i];
+        if (c == '"' || c == '\\')
+            o << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            o << ' ';
+        else
+            o << c;
+        }
+    o << '"';
+    }
+
+/*! \returns Comma separated JSON objects, one per event, with the rank as the process id
+*/
+std::string TraceRecorder::formatEvents() const
+    {
+    unsigned int rank = m_exec_conf->getRank();
+
+    ostringstream o;
+    o << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":0,\"args\":{\"name\":\"rank "
+      << rank << "\"}}," << endl;
+    o << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":0,\"args\":{\"sort_index\":"
+      << rank << "}}";
+
+    // time stamps are in microseconds
+    o << setiosflags(ios::fixed) << setprecision(3);
+    for (unsigned int i = 0; i < m_events.size(); i++)
+        {
+        const Event& e = m_events[i];
+        o << "," << endl << "{";
+        if (e.phase == 'B')
+            {
+            o << "\"name\":";
+            write_json_string(o, m_names[e.name]);
+            o << ",\"ph\":\"B\",";
+            }
+        else if (e.phase == 'S')
+            {
+            o << "\"name\":\"step\",\"ph\":\"B\",\"args\":{\"timestep\":" << e.step << "},";
+            }
+        else
+            {
+            o << "\"ph\":\"E\",";
+            }
+        o << "\"ts\":" << double(e.time)/1000.0 << ",\"pid\":" << rank << ",\"tid\":0}";
+        }
+
+    return o.str();
+    }
+
+void export_TraceRecorder(py::module& m)
+    {
+    py::class_<TraceRecorder>(m, "TraceRecorder")
+        .def("start", &TraceRecorder::start)
+        .def("stop", &TraceRecorder::stop)
+        .def("isActive", &TraceRecorder::isActive)
+        .def("getMaxEvents", &TraceRecorder::getMaxEvents)
+        .def("getNumEvents", &TraceRecorder::getNumEvents)
+        ;
+    }
@@ -0,0 +1,206 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file TraceRecorder.h
+    \brief Declares the TraceRecorder class
+*/
+
+#ifndef __TRACE_RECORDER_H__
+#define __TRACE_RECORDER_H__
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ClockSource.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+struct ExecutionConfiguration;
+
+//! Records a timeline of begin and end events and writes it as a Chrome trace
+/*! The Profiler only reports times summed over a whole run, which hides on which steps and on which rank time was
+    lost. While a trace is active, TraceRecorder stores a time stamped begin and end event for every Profiler push()
+    and pop() (which includes the communication phases of Communicator), for every analyzer, updater and integrator
+    call made by System, and for every time step.
+
+    stop() collects the events of all ranks on the root rank and writes them to a file in the trace event format
+    (JSON) of the Chrome browser, which chrome://tracing and https://ui.perfetto.dev open. Each rank is shown as one
+    process. All ranks wait in a barrier in start() and measure their time stamps from the end of that barrier, so
+    the timelines of different ranks are aligned to within the latency of the barrier.
+
+    Events are only recorded while the trace is active, so that regions that are still open in stop() do not leak
+    their end event into the next trace.
+
+    To bound the memory use, at most getMaxEvents() events are kept per rank. Further regions are dropped with a
+    warning.
+
+    ExecutionConfiguration owns one instance. TraceRecorder is not thread safe, events must be recorded by the thread
+    that runs the time step loop.
+*/
+class TraceRecorder
+    {
+    public:
+        //! Constructor
+        /*! \param exec_conf Execution configuration that owns the recorder
+        */
+        TraceRecorder(const ExecutionConfiguration *exec_conf);
+
+        //! Start recording
+        void start(const std::string& filename, unsigned int max_events);
+
+        //! Stop recording and write the trace file
+        void stop();
+
+        //! Test if a trace is being recorded
+        bool isActive() const
+            {
+            return m_active;
+            }
+
+        //! Get the maximum number of events kept per rank
+        unsigned int getMaxEvents() const
+            {
+            return m_max_events;
+            }
+
+        //! Get the number of recorded events on this rank
+        unsigned int getNumEvents() const
+            {
+            return (unsigned int)m_events.size();
+            }
+
+        //! Record the beginning of a region
+        /*! \param name Name of the region
+        */
+        void begin(const std::string& name)
+            {
+            if (!m_active)
+                return;
+
+            if (m_events.size() >= m_max_events)
+                {
+                dropBegin();
+                return;
+                }
+
+            Event e;
+            e.time = m_clk.getTime();
+            e.name = getNameId(name);
+            e.phase = 'B';
+            e.step = 0;
+            m_events.push_back(e);
+            }
+
+        //! Record the end of the most recently begun region
+        void end()
+            {
+            if (!m_active)
+                return;
+
+            if (m_dropped_depth > 0)
+                {
+                m_dropped_depth--;
+                return;
+                }
+
+            Event e;
+            e.time = m_clk.getTime();
+            e.name = 0;
+            e.phase = 'E';
+            e.step = 0;
+            m_events.push_back(e);
+            }
+
+        //! Record the beginning of a time step
+        /*! \param timestep The time step
+        */
+        void beginStep(unsigned int timestep)
+            {
+            if (!m_active)
+                return;
+
+            if (m_events.size() >= m_max_events)
+                {
+                dropBegin();
+                return;
+                }
+
+            Event e;
+            e.time = m_clk.getTime();
+            e.name = 0;
+            e.phase = 'S';
+            e.step = timestep;
+            m_events.push_back(e);
+            }
+
+    private:
+        //! A begin or end event
+        struct Event
+            {
+            int64_t time;       //!< Time stamp in ns
+            unsigned int name;  //!< Index into m_names
+            unsigned int step;  //!< Time step of a step event
+            char phase;         //!< 'B' for begin, 'E' for end, 'S' for the beginning of a time step
+            };
+
+        const ExecutionConfiguration *m_exec_conf;  //!< Execution configuration that owns the recorder
+        bool m_active;                              //!< True while recording
+        std::string m_filename;                     //!< File to write the trace to
+        unsigned int m_max_events;                  //!< Maximum number of events kept per rank
+        unsigned int m_dropped_depth;               //!< Number of open regions whose begin event was dropped
+        bool m_warned;                              //!< True after the warning about dropped events
+
+        ClockSource m_clk;                          //!< Clock for the time stamps
+        std::vector<Event> m_events;                //!< Recorded events
+        std::vector<std::string> m_names;           //!< Names of the regions
+        std::map<std::string, unsigned int> m_name_ids; //!< Indices into m_names
+
+        //! Get the index of a name
+        unsigned int getNameId(const std::string& name);
+
+        //! Account for a begin event that does not fit
+        void dropBegin();
+
+        //! Format the events of this rank as JSON
+        std::string formatEvents() const;
+    };
+
+//! Begins a TraceRecorder region on construction and ends it on destruction
+/*! Nothing is recorded if the recorder is not active.
+*/
+class TraceScope
+    {
+    public:
+        //! Begin the region
+        /*! \param trace Recorder to record into
+            \param name Name of the region
+        */
+        TraceScope(TraceRecorder& trace, const std::string& name)
+            : m_trace(trace), m_active(trace.isActive())
+            {
+            if (m_active)
+                m_trace.begin(name);
+            }
+
+        //! End the region
+        ~TraceScope()
+            {
+            if (m_active)
+                m_trace.end();
+            }
+
+    private:
+        TraceRecorder& m_trace;     //!< Recorder to record into
+        bool m_active;              //!< True if the region was begun
+    };
+
+//! Exports TraceRecorder to python
+void export_TraceRecorder(pybind11::module& m);
+
+#endif
@@ -250,6 +250,9 @@ class log(_analyzer):
     into a spreadsheet, MATLAB, or other software that can handle simple delimited files.
     See :ref:`page-units` for information on the units in hoomd.
 
+    Lines are written to the file in blocks, at least once per second of wall-clock time and at the end
+    of every :py:func:`hoomd.run()`.
+
     Quantities that can be logged at any time:
 
     - **volume** - Volume of the simulation box (in volume units)
@@ -262,6 +265,9 @@ class log(_analyzer):
     - **yz** - Box tilt factor in yz plane (dimensionless)
     - **momentum** - Magnitude of the average momentum of all particles (in momentum units)
     - **time** - Wall-clock running time from the start of the log (in seconds)
+    - **time_<class name>** - Mean wall-clock time per step spent in the computes, updaters, analyzers, or integrator
+      of the given C++ class over the last steps they executed, e.g. **time_PotentialPairLJ** (in seconds). See
+      :py:func:`hoomd.util.get_timings()`.
 
     Thermodynamic properties:
     - The following quantities are always available and computed over all particles in the system (see :py:class:`hoomd.compute.thermo` for detailed definitions):
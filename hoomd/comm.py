@@ -71,6 +71,23 @@ def barrier_all():
     if _hoomd.is_MPI_available():
         _hoomd.mpi_barrier_world();
 
+def sum_all(value):
+    """ Sum a value over all ranks of the whole MPI run.
+
+    Args:
+        value (float): Value on this rank
+
+    Returns:
+        The sum of *value* over all ranks of all partitions.
+
+    Note:
+        Returns *value* in non-MPI builds.
+    """
+    if _hoomd.is_MPI_available():
+        return _hoomd.mpi_allreduce_sum_world(float(value));
+    else:
+        return value;
+
 def barrier():
     """ Perform a MPI barrier synchronization across all ranks in the partition.
 
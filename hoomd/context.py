@@ -283,6 +283,8 @@ def _create_exec_conf():
     if options.gpu_error_checking:
        exec_conf.setCUDAErrorChecking(True);
 
+    hoomd.option._apply_host_memory_params(exec_conf);
+
     exec_conf = exec_conf;
 
     return exec_conf;
@@ -891,6 +891,25 @@ class system_data(hoomd.meta._metadata):
 
         self.sysdef.initializeFromSnapshot(snapshot);
 
+    def set_soa_layout(self, enable=True):
+        R""" Enable the structure-of-arrays layout of the particle data.
+
+        Args:
+            enable (bool): Set to True to enable the layout, False to disable it
+
+        With the layout enabled, positions, types, velocities and masses are also kept in separate, cache line aligned
+        arrays, which `md.integrate.nve` and the isotropic pair potentials read and write on the CPU. All other code keeps
+        using the default layout, and the two copies are synchronized on demand. The layout is not available on the GPU.
+
+        Example::
+
+            system.set_soa_layout(True)
+
+        """
+        hoomd.util.print_status_line();
+
+        self.sysdef.getParticleData().setSoALayout(enable);
+
     ## \internal
     # \brief Get particle metadata
     def get_metadata(self):
@@ -215,7 +215,8 @@ def cuboid(name, xmin=None, xmax=None, ymin=None, ymax=None, zmin=None, zmax=Non
         removed automatically.
 
     Between runs, you can force a group to update its membership with the particles currently
-    in the originally defined region using :py:meth:`hoomd.group.group.force_update()`.
+    in the originally defined region using :py:meth:`hoomd.group.group.force_update()`. To update it
+    periodically during a run, use :py:class:`hoomd.update.dynamic_group`.
 
     Examples::
 
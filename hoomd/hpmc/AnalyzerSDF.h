@@ -12,6 +12,9 @@
 #include "hoomd/Analyzer.h"
 #include "hoomd/Filesystem.h"
 #include "IntegratorHPMCMono.h"
+#include "CellGrid.h"
+#include "ShapeSphere.h"
+#include "ShapeEllipsoid.h"
 
 #ifdef ENABLE_MPI
 #include "hoomd/Communicator.h"
@@ -48,6 +51,43 @@ bool test_scaled_overlap(const vec3<Scalar>& r_ij,
     return check_circumsphere_overlap(r_ij_scaled, shape_i, shape_j) && test_overlap(r_ij_scaled, shape_i, shape_j, dummy);
     }
 
+//! Compute the scale factor at which two particles first touch, for shapes where it is known in closed form
+/*! \param r_ij Vector pointing from particle i to j
+    \param shape_i Shape of particle i
+    \param shape_j Shape of particle j
+    \param lambda Scale factor at first contact (return value)
+    \returns true if lambda was computed, false if the shape has no closed form
+*/
+template < class Shape >
+inline bool sdf_contact_scale(const vec3<Scalar>& r_ij, const Shape& shape_i, const Shape& shape_j, Scalar& lambda)
+    {
+    return false;
+    }
+
+//! Spheres first touch when their scaled distance is the sum of their radii
+template < >
+inline bool sdf_contact_scale(const vec3<Scalar>& r_ij, const ShapeSphere& shape_i, const ShapeSphere& shape_j,
+    Scalar& lambda)
+    {
+    Scalar sigma = Scalar(shape_i.params.radius + shape_j.params.radius);
+    lambda = Scalar(1.0) - sigma / sqrt(dot(r_ij, r_ij));
+    return true;
+    }
+
+//! Radius of a sphere contained in the shape
+template < class Shape >
+inline OverlapReal sdf_insphere_radius(const Shape& shape)
+    {
+    return shape.getInsphereRadius();
+    }
+
+//! An ellipsoid contains the sphere with the radius of its shortest semi-axis
+template < >
+inline OverlapReal sdf_insphere_radius(const ShapeEllipsoid& shape)
+    {
+    return detail::min(shape.axes.x, detail::min(shape.axes.y, shape.axes.z));
+    }
+
 }
 
 //! SDF analysis
@@ -69,9 +109,15 @@ bool test_scaled_overlap(const vec3<Scalar>& r_ij,
 
     \b Computing \f$ \lambda \f$ <br>
 
-    In the initial version of the code, a completely general way of computing *\f$ \lambda \f$* is implemented.
-    It uses a binary search tree and the existing test_overlap code to find wich bin a given pair of particles sits in.
-    Future versions of the code may use shape specific data to compute *\f$ \lambda \f$* directly.
+    A completely general way of computing *\f$ \lambda \f$* is implemented. It uses a binary search tree and the
+    existing test_overlap code to find wich bin a given pair of particles sits in. The search starts from the range of
+    bins allowed by the circumspheres and inspheres of the two shapes, and ends early when the pair cannot lower the
+    smallest bin found for the particle so far. Spheres compute *\f$ \lambda \f$* directly (see
+    detail::sdf_contact_scale()).
+
+    Particles are processed in parallel with OpenMP, each thread counting into its own histogram. Neighbors are found
+    with a uniform grid of cells when all particle types have similar circumsphere diameters, and with the AABB tree of
+    the integrator otherwise. The integrator reuses that tree in its next trial moves.
 
     Outside of that AnalyzerSDF is a pretty basic histogramming code. The only other notable features in the design
     are:
@@ -140,6 +186,7 @@ class AnalyzerSDF : public Analyzer
         bool m_is_initialized;                  //!< Bool indicating if we have initialized the file yet
         bool m_appending;                       //!< Flag indicating this file is being appended to
         std::vector<unsigned int> m_hist;       //!< Raw histogram data
+        detail::CellGrid m_cell_grid;           //!< Grid of cells to find the neighbors of similarly sized particles
 
         unsigned int m_iavg;                    //!< Current count of the number of steps averaged
         Scalar m_last_max_diam;                 //!< Last recorded maximum diameter
@@ -156,12 +203,16 @@ class AnalyzerSDF : public Analyzer
         //! Add to histogram counts
         void countHistogram(unsigned int timestep);
 
+        //! Build the cell grid if it is a better choice than the AABB tree to find neighbors
+        bool buildCellGrid(Scalar max_range);
+
         //! Determine the s bin of a given particle pair
         int computeBin(const vec3<Scalar>& r_ij,
                        const quat<Scalar>& orientation_i,
                        const quat<Scalar>& orientation_j,
                        const typename Shape::param_type& params_i,
-                       const typename Shape::param_type& params_j);
+                       const typename Shape::param_type& params_j,
+                       unsigned int max_bin);
     };
 
 
@@ -330,88 +381,191 @@ void AnalyzerSDF<Shape>::zeroHistogram()
 template < class Shape >
 void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
     {
-    // update the aabb tree
-    const detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
+    Scalar extra_width = m_lmax / (1 - m_lmax) * m_mc->getMaxDiameter();
+
+    // find the neighbors with the cell grid when the particles have similar sizes, and with the AABB tree otherwise
+    bool use_cell_grid = buildCellGrid(m_mc->getMaxDiameter() + extra_width);
+
+    // update the aabb tree, the integrator reuses it in its next sweep
+    const detail::AABBTree *aabb_tree = use_cell_grid ? NULL : &m_mc->buildAABBTree();
     // update the image list
     const std::vector<vec3<Scalar> >&image_list = m_mc->updateImageList();
 
-    Scalar extra_width = m_lmax / (1 - m_lmax) * m_mc->getMaxDiameter();
-
     // access particle data and system box
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    const BoxDim& box = m_pdata->getBox();
 
     const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
 
-    // loop through N particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int n_bins = m_hist.size();
+    const unsigned int N = m_pdata->getN();
+
+    #pragma omp parallel
         {
-        int min_bin = m_hist.size();
+        // per thread histogram
+        std::vector<unsigned int> hist(n_bins, 0);
 
-        // read in the current position and orientation
-        Scalar4 postype_i = h_postype.data[i];
-        Scalar4 orientation_i = h_orientation.data[i];
-        Shape shape_i(quat<Scalar>(orientation_i), params[__scalar_as_int(postype_i.w)]);
-        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+        // loop through N particles
+        #pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < (int)N; i++)
+            {
+            unsigned int min_bin = n_bins;
 
-        // construct the AABB around the particle's circumsphere
-        // pad with enough extra width so that when scaled by lmax, found particles might touch
-        detail::AABB aabb_i_local(vec3<Scalar>(0,0,0), shape_i.getCircumsphereDiameter()/Scalar(2) + extra_width);
+            // read in the current position and orientation
+            Scalar4 postype_i = h_postype.data[i];
+            quat<Scalar> orientation_i(h_orientation.data[i]);
+            const param_type& params_i = params[__scalar_as_int(postype_i.w)];
+            Shape shape_i(orientation_i, params_i);
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
 
-        const unsigned int n_images = image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-            {
-            vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-            detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
+            if (use_cell_grid)
+                {
+                // the cells are wider than the largest circumsphere scaled by lmax and the box is at least 3 cells
+                // wide, so all pairs that can touch are with the nearest image of a particle in a neighboring cell
+                const unsigned int *nbr_cells = m_cell_grid.getNeighborCells(m_cell_grid.getCell(pos_i));
+                for (unsigned int cur_nbr = 0; cur_nbr < m_cell_grid.getNumNeighborCells(); cur_nbr++)
+                    {
+                    unsigned int cell = nbr_cells[cur_nbr];
+                    const unsigned int *cell_particles = m_cell_grid.getCellParticles(cell);
+                    for (unsigned int cur_p = 0; cur_p < m_cell_grid.getCellSize(cell); cur_p++)
+                        {
+                        unsigned int j = cell_particles[cur_p];
+                        if (j == (unsigned int)i)
+                            continue;
+
+                        Scalar4 postype_j = h_postype.data[j];
+                        vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(postype_j) - pos_i)));
+
+                        int bin = computeBin(r_ij,
+                                             orientation_i,
+                                             quat<Scalar>(h_orientation.data[j]),
+                                             params_i,
+                                             params[__scalar_as_int(postype_j.w)],
+                                             min_bin);
+
+                        if (bin >= 0)
+                            min_bin = std::min(min_bin, (unsigned int)bin);
+                        }
+                    }
+                }
+
+            // construct the AABB around the particle's circumsphere
+            // pad with enough extra width so that when scaled by lmax, found particles might touch
+            detail::AABB aabb_i_local(vec3<Scalar>(0,0,0), shape_i.getCircumsphereDiameter()/Scalar(2) + extra_width);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
+            const unsigned int n_images = use_cell_grid ? 0 : image_list.size();
+            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                 {
-                if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+                detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i_image);
+
+                // stackless search
+                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree->getNumNodes(); cur_node_idx++)
                     {
-                    if (aabb_tree.isNodeLeaf(cur_node_idx))
+                    if (detail::overlap(aabb_tree->getNodeAABB(cur_node_idx), aabb))
                         {
-                        for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        if (aabb_tree->isNodeLeaf(cur_node_idx))
                             {
-                            // read in its position and orientation
-                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            for (unsigned int cur_p = 0; cur_p < aabb_tree->getNodeNumParticles(cur_node_idx); cur_p++)
+                                {
+                                // read in its position and orientation
+                                unsigned int j = aabb_tree->getNodeParticle(cur_node_idx, cur_p);
+
+                                // skip i==j in the 0 image
+                                if (cur_image == 0 && (unsigned int)i == j)
+                                    continue;
+
+                                Scalar4 postype_j = h_postype.data[j];
+                                Scalar4 orientation_j = h_orientation.data[j];
+
+                                // put particles in coordinate system of particle i
+                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                                int bin = computeBin(r_ij,
+                                                     orientation_i,
+                                                     quat<Scalar>(orientation_j),
+                                                     params_i,
+                                                     params[__scalar_as_int(postype_j.w)],
+                                                     min_bin);
+
+                                if (bin >= 0)
+                                    min_bin = std::min(min_bin, (unsigned int)bin);
+                                }
+                            }
+                        }
+                    else
+                        {
+                        // skip ahead
+                        cur_node_idx += aabb_tree->getNodeSkip(cur_node_idx);
+                        }
+                    } // end loop over AABB nodes
+                } // end loop over images
+
+            // record the minimum bin
+            if (min_bin < n_bins)
+                hist[min_bin]++;
+
+            } // end loop over all particles
+
+        // sum the per thread histograms
+        #pragma omp critical
+            {
+            for (unsigned int b = 0; b < n_bins; b++)
+                m_hist[b] += hist[b];
+            }
+        }
+    }
+
+/*! \param max_range Largest distance between two particles that can touch when scaled by lmax
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+    The grid is used under the same conditions as in IntegratorHPMCMono::buildCellGrid(), with cells wide enough for
+    the range of the SDF.
+
+    \returns true if the grid was built and should be used to find neighbors
+*/
+template < class Shape >
+bool AnalyzerSDF<Shape>::buildCellGrid(Scalar max_range)
+    {
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
+    // largest ratio of circumsphere diameters for which the grid is used
+    const Scalar max_diameter_ratio = Scalar(1.5);
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
 
+    // find the range of diameters of the types present
+    std::vector<bool> present(m_pdata->getNTypes(), false);
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        present[__scalar_as_int(h_postype.data[i].w)] = true;
 
-                            int bin = computeBin(r_ij,
-                                                 quat<Scalar>(orientation_i),
-                                                 quat<Scalar>(orientation_j),
-                                                 params[__scalar_as_int(postype_i.w)],
-                                                 params[__scalar_as_int(postype_j.w)]);
+    Scalar min_d = Scalar(0.0), max_d = Scalar(0.0);
+    bool first = true;
+    quat<Scalar> q;
+    for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+        {
+        if (!present[typ])
+            continue;
+        Shape shape(q, params[typ]);
+        Scalar d = shape.getCircumsphereDiameter();
+        min_d = first ? d : std::min(min_d, d);
+        max_d = first ? d : std::max(max_d, d);
+        first = false;
+        }
 
-                            if (bin >= 0)
-                                min_bin = std::min(min_bin, bin);
-                            }
-                        }
-                    }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                    }
-                } // end loop over AABB nodes
-            } // end loop over images
+    if (!(max_d > Scalar(0.0)) || max_d > max_diameter_ratio*min_d)
+        return false;
 
-        // record the minimum bin
-        if ((unsigned int)min_bin < m_hist.size())
-            m_hist[min_bin]++;
+    if (!m_cell_grid.setup(m_pdata->getBox(), max_range, this->m_sysdef->getNDimensions()))
+        return false;
 
-        } // end loop over all particles
+    m_cell_grid.build(h_postype.data, m_pdata->getN());
+    return true;
     }
 
 /*! \param r_ij Vector pointing from particle i to j (already wrapped into the box)
@@ -419,8 +573,9 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
     \param orientation_j Orientation of particle j
     \param params_i Parameters for particle i
     \param params_j Parameters for particle j
+    \param max_bin Largest bin of interest
 
-    \returns s bin index
+    \returns s bin index, or max_bin if the bin is max_bin or larger
 
     In the first general version, computeBin uses a binary search tree to determine
     the bin. In this way, only a test_overlap method is needed, no extra math. The
@@ -428,27 +583,69 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
     left boundary and does overlap a the right. Then it picks a new point halfway between
     the left and right, ensuring that the same assumption holds. Once right=left+1, the
     correct bin has been found.
+
+    The circumspheres of the shapes cannot touch below some scale factor, and the inspheres overlap above another one,
+    which limits the initial search window. For shapes with a closed form for the scale factor at first contact, the
+    bin is computed directly.
 */
 template < class Shape >
 int AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
                              const quat<Scalar>& orientation_i,
                              const quat<Scalar>& orientation_j,
                              const typename Shape::param_type& params_i,
-                             const typename Shape::param_type& params_j)
+                             const typename Shape::param_type& params_j,
+                             unsigned int max_bin)
     {
     unsigned int L=0;
-    unsigned int R=m_hist.size();
+    unsigned int R=max_bin;
+
+    Shape shape_i(orientation_i, params_i);
+    Shape shape_j(orientation_j, params_j);
+
+    Scalar lambda;
+    if (detail::sdf_contact_scale(r_ij, shape_i, shape_j, lambda))
+        {
+        if (lambda < Scalar(0.0))
+            return -1;
+        Scalar bin = lambda / m_dl;
+        return bin < Scalar(R) ? int(bin) : R;
+        }
+
+    Scalar r = sqrt(dot(r_ij, r_ij));
+
+    // the circumspheres do not touch below this scale
+    Scalar lambda_min = Scalar(1.0) - (shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter())
+        / (Scalar(2.0) * r);
+    if (lambda_min >= R*m_dl)
+        return R;
+
+    // the inspheres overlap above this scale
+    Scalar lambda_max = Scalar(1.0) - (detail::sdf_insphere_radius(shape_i) + detail::sdf_insphere_radius(shape_j)) / r;
+    if (lambda_max < Scalar(0.0))
+        return -1;
 
-    // if the particles already overlap a the left boundary, return an out of range value
-    if (detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, L*m_dl))
+    if (lambda_min > Scalar(0.0))
+        {
+        L = (unsigned int)(lambda_min / m_dl);
+        }
+    else if (detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, L*m_dl))
+        {
+        // if the particles already overlap a the left boundary, return an out of range value
         return -1;
+        }
 
-    // if the particles do not overlap a the right boundary, return an out of range value
-    if (!detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, R*m_dl))
-        return m_hist.size();
+    if (lambda_max < R*m_dl)
+        {
+        R = std::min(R, (unsigned int)(lambda_max / m_dl) + 1);
+        }
+    else if (!detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, R*m_dl))
+        {
+        // if the particles do not overlap a the right boundary, return an out of range value
+        return R;
+        }
 
     // progressively narrow the search window by halves
-    do
+    while ((R-L) > 1)
         {
         unsigned int m = (L+R)/2;
 
@@ -456,7 +653,7 @@ int AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
             R = m;
         else
             L = m;
-        } while ((R-L) > 1);
+        }
 
     return L;
     }
@@ -0,0 +1,286 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/BoxDim.h"
+#include <vector>
+#include <algorithm>
+
+#ifndef __HPMC_CELL_GRID_H__
+#define __HPMC_CELL_GRID_H__
+
+/*! \file CellGrid.h
+    \brief Uniform grid of cells for HPMC neighbor queries
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Uniform grid of cells over a periodic box
+/*! The box is divided into cells that are at least as wide as the given width in every direction, so that all
+    particles closer than that width to a particle are in the same or one of the neighboring cells. Each cell stores
+    the indices of its particles in a fixed capacity slice of a flat array, which is grown when a cell overflows.
+
+    The grid supports the following operations:
+
+    - build : Sort all particles into the cells. Runs in O(N) time.
+    - move : Move a single particle to another cell, e.g. after an accepted trial move. Runs in O(1) time.
+    - getNeighborCells : List the cell itself and its neighbors (27 in 3D, 9 in 2D) with periodic wrapping.
+
+    The neighbor cells of a cell are only distinct when there are at least 3 cells in every direction. setup() fails
+    when the box is too small for that, and the caller should use a different method to find neighbors.
+
+    For checkerboard decompositions, setup() can round the number of cells in every direction down to an even number,
+    so that cells of the same parity never share a face, edge or corner across the periodic boundaries. The grid can
+    also be offset by a fraction of the box, so that the cell boundaries do not stay fixed in space.
+
+    \ingroup hpmc_data_structs
+*/
+class CellGrid
+    {
+    public:
+        //! Construct an empty grid
+        CellGrid()
+            : m_cell_capacity(0), m_num_nbr_cells(0)
+            {
+            m_dim = make_uint3(0,0,0);
+            m_offset = make_scalar3(0,0,0);
+            }
+
+        //! Set up the cells for a box
+        /*! \param box Simulation box, must be periodic in all directions
+            \param width Minimum width of a cell
+            \param ndim Number of dimensions of the system
+            \param even If true, use an even number of cells in every periodic direction
+            \returns false if the box is less than 3 cells wide in some direction
+
+            The cell contents are invalid after setup(), call build() to fill them.
+        */
+        bool setup(const BoxDim& box, Scalar width, unsigned int ndim, bool even=false)
+            {
+            Scalar3 npd = box.getNearestPlaneDistance();
+            uint3 dim = make_uint3((unsigned int)(npd.x / width),
+                                   (unsigned int)(npd.y / width),
+                                   ndim == 2 ? 1 : (unsigned int)(npd.z / width));
+
+            if (even)
+                {
+                dim.x &= ~1u;
+                dim.y &= ~1u;
+                if (ndim == 3)
+                    dim.z &= ~1u;
+                }
+
+            if (dim.x < 3 || dim.y < 3 || (ndim == 3 && dim.z < 3))
+                return false;
+
+            m_box = box;
+            if (dim.x == m_dim.x && dim.y == m_dim.y && dim.z == m_dim.z)
+                return true;
+
+            m_dim = dim;
+            unsigned int num_cells = m_dim.x*m_dim.y*m_dim.z;
+            m_cell_size.assign(num_cells, 0);
+            m_cell_idx.clear();
+            m_cell_capacity = 0;
+
+            // precompute the neighbors of all cells
+            int kmax = (ndim == 2) ? 0 : 1;
+            m_num_nbr_cells = (ndim == 2) ? 9 : 27;
+            m_nbr_cells.resize(num_cells*m_num_nbr_cells);
+            for (unsigned int k = 0; k < m_dim.z; k++)
+                for (unsigned int j = 0; j < m_dim.y; j++)
+                    for (unsigned int i = 0; i < m_dim.x; i++)
+                        {
+                        unsigned int cell = getCellIndex(i, j, k);
+                        unsigned int n = 0;
+                        for (int dk = -kmax; dk <= kmax; dk++)
+                            for (int dj = -1; dj <= 1; dj++)
+                                for (int di = -1; di <= 1; di++)
+                                    m_nbr_cells[cell*m_num_nbr_cells + n++] = getCellIndex((i + m_dim.x + di) % m_dim.x,
+                                                                                           (j + m_dim.y + dj) % m_dim.y,
+                                                                                           (k + m_dim.z + dk) % m_dim.z);
+                        }
+            return true;
+            }
+
+        //! Offset the cell boundaries
+        /*! \param offset Offset of the grid in fractional coordinates of the box
+
+            Call build() after changing the offset.
+        */
+        void setOffset(const Scalar3& offset)
+            {
+            m_offset = offset;
+            }
+
+        //! Sort all particles into the cells
+        /*! \param postype Particle positions
+            \param N Number of particles
+        */
+        void build(const Scalar4 *postype, unsigned int N)
+            {
+            unsigned int num_cells = m_cell_size.size();
+            m_particle_cell.resize(N);
+            m_particle_slot.resize(N);
+
+            // count the particles in each cell to size the cells
+            m_cell_size.assign(num_cells, 0);
+            unsigned int max_size = 0;
+            for (unsigned int i = 0; i < N; i++)
+                {
+                unsigned int cell = getCell(vec3<Scalar>(postype[i]));
+                m_particle_cell[i] = cell;
+                max_size = std::max(max_size, ++m_cell_size[cell]);
+                }
+
+            // leave room for particles moving in
+            if (max_size > m_cell_capacity || m_cell_capacity > 2*max_size + 8)
+                {
+                m_cell_capacity = max_size + 4;
+                m_cell_idx.resize(num_cells*m_cell_capacity);
+                }
+
+            m_cell_size.assign(num_cells, 0);
+            for (unsigned int i = 0; i < N; i++)
+                {
+                unsigned int cell = m_particle_cell[i];
+                unsigned int slot = m_cell_size[cell]++;
+                m_cell_idx[cell*m_cell_capacity + slot] = i;
+                m_particle_slot[i] = slot;
+                }
+            }
+
+        //! Move a particle to a new cell
+        /*! \param i Index of the particle
+            \param cell New cell of the particle
+        */
+        void move(unsigned int i, unsigned int cell)
+            {
+            unsigned int old_cell = m_particle_cell[i];
+            if (cell == old_cell)
+                return;
+
+            // fill the hole with the last particle in the old cell
+            unsigned int slot = m_particle_slot[i];
+            unsigned int last = m_cell_idx[old_cell*m_cell_capacity + m_cell_size[old_cell] - 1];
+            m_cell_idx[old_cell*m_cell_capacity + slot] = last;
+            m_particle_slot[last] = slot;
+            m_cell_size[old_cell]--;
+
+            if (m_cell_size[cell] == m_cell_capacity)
+                grow();
+
+            slot = m_cell_size[cell]++;
+            m_cell_idx[cell*m_cell_capacity + slot] = i;
+            m_particle_cell[i] = cell;
+            m_particle_slot[i] = slot;
+            }
+
+        //! Get the cell containing a position
+        /*! \param pos Position, which may be outside of the box
+            \returns Index of the cell, with periodic wrapping
+        */
+        unsigned int getCell(const vec3<Scalar>& pos) const
+            {
+            Scalar3 f = m_box.makeFraction(vec_to_scalar3(pos)) + m_offset;
+            int i = (int)floor(f.x*Scalar(m_dim.x));
+            int j = (int)floor(f.y*Scalar(m_dim.y));
+            int k = (int)floor(f.z*Scalar(m_dim.z));
+            return getCellIndex(wrap(i, m_dim.x), wrap(j, m_dim.y), wrap(k, m_dim.z));
+            }
+
+        //! Get the cell of a particle
+        unsigned int getParticleCell(unsigned int i) const
+            {
+            return m_particle_cell[i];
+            }
+
+        //! Get the neighbor cells of a cell, including the cell itself
+        const unsigned int *getNeighborCells(unsigned int cell) const
+            {
+            return &m_nbr_cells[cell*m_num_nbr_cells];
+            }
+
+        //! Get the number of neighbor cells of each cell
+        unsigned int getNumNeighborCells() const
+            {
+            return m_num_nbr_cells;
+            }
+
+        //! Get the particles in a cell
+        const unsigned int *getCellParticles(unsigned int cell) const
+            {
+            return &m_cell_idx[cell*m_cell_capacity];
+            }
+
+        //! Get the number of particles in a cell
+        unsigned int getCellSize(unsigned int cell) const
+            {
+            return m_cell_size[cell];
+            }
+
+        //! Get the number of cells in each direction
+        uint3 getDim() const
+            {
+            return m_dim;
+            }
+
+        //! Get the number of cells
+        unsigned int getNumCells() const
+            {
+            return m_dim.x*m_dim.y*m_dim.z;
+            }
+
+        //! Linear index of a cell
+        unsigned int getCellIndex(unsigned int i, unsigned int j, unsigned int k) const
+            {
+            return (k*m_dim.y + j)*m_dim.x + i;
+            }
+
+    private:
+        BoxDim m_box;                               //!< Box the grid covers
+        uint3 m_dim;                                //!< Number of cells in each direction
+        Scalar3 m_offset;                           //!< Offset of the grid in fractional coordinates
+        unsigned int m_cell_capacity;               //!< Maximum number of particles per cell
+        unsigned int m_num_nbr_cells;               //!< Number of neighbor cells of each cell
+        std::vector<unsigned int> m_cell_size;      //!< Number of particles in each cell
+        std::vector<unsigned int> m_cell_idx;       //!< Particle indices, m_cell_capacity entries per cell
+        std::vector<unsigned int> m_nbr_cells;      //!< Neighbor cells, m_num_nbr_cells entries per cell
+        std::vector<unsigned int> m_particle_cell;  //!< Cell of each particle
+        std::vector<unsigned int> m_particle_slot;  //!< Position of each particle in its cell
+
+        //! Wrap a cell coordinate into the grid
+        static unsigned int wrap(int i, unsigned int n)
+            {
+            i %= (int)n;
+            return (unsigned int)(i < 0 ? i + (int)n : i);
+            }
+
+        //! Double the capacity of the cells
+        void grow()
+            {
+            unsigned int num_cells = m_cell_size.size();
+            unsigned int new_capacity = 2*m_cell_capacity;
+            std::vector<unsigned int> new_idx(num_cells*new_capacity);
+            for (unsigned int cell = 0; cell < num_cells; cell++)
+                for (unsigned int slot = 0; slot < m_cell_size[cell]; slot++)
+                    new_idx[cell*new_capacity + slot] = m_cell_idx[cell*m_cell_capacity + slot];
+            m_cell_idx.swap(new_idx);
+            m_cell_capacity = new_capacity;
+            }
+    };
+
+}; // end namespace detail
+
+}; // end namespace hpmc
+
+#endif // __HPMC_CELL_GRID_H__
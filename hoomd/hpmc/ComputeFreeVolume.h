@@ -75,7 +75,7 @@ class ComputeFreeVolume : public Compute
         virtual void computeFreeVolume(unsigned int timestep);
 
         //! Analyze the current configuration
-        virtual void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
     protected:
         std::shared_ptr<IntegratorHPMCMono<Shape> > m_mc;              //!< The parent integrator
@@ -111,7 +111,7 @@ ComputeFreeVolume< Shape >::ComputeFreeVolume(std::shared_ptr<SystemDefinition>
     }
 
 template<class Shape>
-void ComputeFreeVolume<Shape>::compute(unsigned int timestep)
+void ComputeFreeVolume<Shape>::doCompute(unsigned int timestep)
     {
     if (!shouldCompute(timestep))
         return;
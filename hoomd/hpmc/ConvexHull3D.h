@@ -0,0 +1,223 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "HPMCPrecisionSetup.h"
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+
+#ifndef __CONVEX_HULL_3D_H__
+#define __CONVEX_HULL_3D_H__
+
+/*! \file ConvexHull3D.h
+    \brief Computes the edges of the convex hull of a point set in 3D
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Compute the vertex adjacency of the convex hull of a set of points
+/*! \param points Points to compute the hull of
+    \param nbrs Output: for each point, the indices of the points connected to it by an edge of the hull. Points inside
+                the hull (or on its surface but not at a corner) have no neighbors.
+    \returns false if the points do not span a volume, in which case \a nbrs is left empty
+
+    The hull is built incrementally: each point that is outside the current hull replaces the faces it sees with a fan
+    of triangles to the horizon. Faces with more than three corners are triangulated, which adds diagonals to the
+    adjacency of their corners. That is harmless for the hill climbing support function, which only needs the edges
+    of the hull to be a subset of the adjacency.
+
+    The hull is computed once per shape when the parameters are set, so the O(N^2) worst case cost does not matter.
+
+    \ingroup minkowski
+*/
+inline bool convex_hull_adjacency(const std::vector< vec3<OverlapReal> >& points,
+                                  std::vector< std::vector<unsigned int> >& nbrs)
+    {
+    nbrs.clear();
+    const unsigned int N = points.size();
+    if (N < 4)
+        return false;
+
+    // work in double precision
+    std::vector< vec3<double> > p(N);
+    double scale = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        p[i] = vec3<double>(points[i].x, points[i].y, points[i].z);
+        scale = std::max(scale, std::max(fabs(p[i].x), std::max(fabs(p[i].y), fabs(p[i].z))));
+        }
+    const double eps = 1e-9 * scale;
+
+    // find an initial tetrahedron of extreme points
+    unsigned int i0 = 0;
+    for (unsigned int i = 1; i < N; i++)
+        if (p[i].x < p[i0].x)
+            i0 = i;
+
+    unsigned int i1 = i0;
+    double max_dsq = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        double dsq = dot(p[i]-p[i0], p[i]-p[i0]);
+        if (dsq > max_dsq)
+            {
+            max_dsq = dsq;
+            i1 = i;
+            }
+        }
+    if (max_dsq <= eps*eps)
+        return false;
+
+    unsigned int i2 = i0;
+    double max_area = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        vec3<double> c = cross(p[i1]-p[i0], p[i]-p[i0]);
+        double area = dot(c,c);
+        if (area > max_area)
+            {
+            max_area = area;
+            i2 = i;
+            }
+        }
+    if (sqrt(max_area) <= eps*sqrt(max_dsq))
+        return false;
+
+    vec3<double> n012 = cross(p[i1]-p[i0], p[i2]-p[i0]);
+    unsigned int i3 = i0;
+    double max_vol = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        double vol = fabs(dot(n012, p[i]-p[i0]));
+        if (vol > max_vol)
+            {
+            max_vol = vol;
+            i3 = i;
+            }
+        }
+    if (max_vol <= eps*sqrt(dot(n012,n012)))
+        return false;
+
+    // faces are stored with counter clockwise corners seen from the outside
+    struct Face
+        {
+        unsigned int v[3];      //!< Corners
+        vec3<double> n;         //!< Outward normal (not normalized)
+        double d;               //!< Plane offset dot(n, p[v[0]])
+        double tol;             //!< Distance tolerance scaled by |n|
+        bool alive;             //!< False when the face is no longer part of the hull
+        };
+    std::vector<Face> faces;
+    unsigned int n_alive = 0;
+
+    // the tolerance is scaled by |n| so that it is a distance
+    auto add_face = [&](unsigned int a, unsigned int b, unsigned int c)
+        {
+        Face f;
+        f.v[0] = a; f.v[1] = b; f.v[2] = c;
+        f.n = cross(p[b]-p[a], p[c]-p[a]);
+        f.d = dot(f.n, p[a]);
+        f.tol = eps*sqrt(dot(f.n, f.n));
+        f.alive = true;
+        faces.push_back(f);
+        n_alive++;
+        };
+
+    // the initial tetrahedron, with each face oriented away from the opposite corner
+    unsigned int tet[4] = {i0, i1, i2, i3};
+    for (unsigned int k = 0; k < 4; k++)
+        {
+        unsigned int a = tet[k], b = tet[(k+1)%4], c = tet[(k+2)%4], opposite = tet[(k+3)%4];
+        if (dot(cross(p[b]-p[a], p[c]-p[a]), p[opposite]-p[a]) > 0)
+            std::swap(b, c);
+        add_face(a, b, c);
+        }
+
+    std::vector<unsigned int> visible;
+    std::set< std::pair<unsigned int, unsigned int> > visible_edges;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (i == i0 || i == i1 || i == i2 || i == i3)
+            continue;
+
+        // find all faces that see the point
+        visible.clear();
+        visible_edges.clear();
+        for (unsigned int f = 0; f < faces.size(); f++)
+            {
+            if (faces[f].alive && dot(faces[f].n, p[i]) - faces[f].d > faces[f].tol)
+                {
+                visible.push_back(f);
+                for (unsigned int k = 0; k < 3; k++)
+                    visible_edges.insert(std::make_pair(faces[f].v[k], faces[f].v[(k+1)%3]));
+                }
+            }
+
+        // points inside the hull do not change it
+        if (visible.size() == 0)
+            continue;
+
+        // replace the visible faces by a fan from the horizon to the new point. An edge of a visible face is on the
+        // horizon when the face on its other side (which has the reversed edge) is not visible.
+        for (unsigned int k = 0; k < visible.size(); k++)
+            {
+            Face f = faces[visible[k]];
+            faces[visible[k]].alive = false;
+            n_alive--;
+            for (unsigned int e = 0; e < 3; e++)
+                {
+                unsigned int a = f.v[e];
+                unsigned int b = f.v[(e+1)%3];
+                if (visible_edges.find(std::make_pair(b, a)) == visible_edges.end())
+                    add_face(a, b, i);
+                }
+            }
+
+        // drop the removed faces once they are the majority
+        if (faces.size() > 2*n_alive + 64)
+            {
+            std::vector<Face> alive_faces;
+            for (unsigned int f = 0; f < faces.size(); f++)
+                if (faces[f].alive)
+                    alive_faces.push_back(faces[f]);
+            faces.swap(alive_faces);
+            }
+        }
+
+    // collect the edges of the remaining faces
+    std::vector< std::set<unsigned int> > nbr_sets(N);
+    for (unsigned int f = 0; f < faces.size(); f++)
+        {
+        if (!faces[f].alive)
+            continue;
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            nbr_sets[faces[f].v[k]].insert(faces[f].v[(k+1)%3]);
+            nbr_sets[faces[f].v[(k+1)%3]].insert(faces[f].v[k]);
+            }
+        }
+
+    nbrs.resize(N);
+    for (unsigned int i = 0; i < N; i++)
+        nbrs[i].assign(nbr_sets[i].begin(), nbr_sets[i].end());
+
+    return true;
+    }
+
+}; // end namespace detail
+
+}; // end namespace hpmc
+
+#endif // __CONVEX_HULL_3D_H__
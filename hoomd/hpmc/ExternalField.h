@@ -62,7 +62,7 @@ class ExternalFieldMono : public ExternalField
         ~ExternalFieldMono(){}
 
         //! needed for Compute. currently not used.
-        virtual void compute(unsigned int timestep) {}
+        virtual void doCompute(unsigned int timestep) {}
 
         //! method to accept or reject the proposed move used by the integrator.
         virtual bool accept(const unsigned int& index, const vec3<Scalar>& position_old, const Shape& shape_old, const vec3<Scalar>& position_new, const Shape& shape_new, Saru& rng){return 0;}
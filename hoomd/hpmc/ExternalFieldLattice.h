@@ -247,7 +247,7 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             return fast::exp(dE);
             }
 
-        void compute(unsigned int timestep)
+        void doCompute(unsigned int timestep)
             {
             if(!this->shouldCompute(timestep))
                 {
@@ -416,7 +416,7 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
         //! Calculates the requested log value and returns it
         Scalar getLogValue(const std::string& quantity, unsigned int timestep)
             {
-            compute(timestep);
+            this->compute(timestep);
 
             if( quantity == LATTICE_ENERGY_LOG_NAME )
                 {
@@ -480,19 +480,19 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
 
         Scalar getEnergy(unsigned int timestep)
         {
-            compute(timestep);
+            this->compute(timestep);
             return m_Energy;
         }
         Scalar getAvgEnergy(unsigned int timestep)
         {
-            compute(timestep);
+            this->compute(timestep);
             if( !m_num_samples )
                 return 0.0;
             return m_EnergySum/double(m_num_samples);
         }
         Scalar getSigma(unsigned int timestep)
         {
-            compute(timestep);
+            this->compute(timestep);
             if( !m_num_samples )
                 return 0.0;
             Scalar first_moment = m_EnergySum/double(m_num_samples);
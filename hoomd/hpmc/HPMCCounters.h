@@ -307,6 +307,92 @@ struct hpmc_muvt_counters_t
 
     };
 
+//! Storage for event chain counters
+/*! \ingroup hpmc_data_structs */
+struct hpmc_ec_counters_t
+    {
+    unsigned long long int chain_count;     //!< Count of event chains
+    unsigned long long int event_count;     //!< Count of collision events (lifts)
+    double chain_length;                    //!< Total displacement of the straight chains
+    double lift_sum;                        //!< Sum of the center separations along the chain direction at the lifts
+
+    //! Construct a zero set of counters
+    hpmc_ec_counters_t()
+        {
+        chain_count = 0;
+        event_count = 0;
+        chain_length = 0.0;
+        lift_sum = 0.0;
+        }
+
+    //! Get the average number of events per chain
+    /*! \returns The ratio of events to chains, or 0 if there are no chains
+    */
+    DEVICE double getEventsPerChain()
+        {
+        if (chain_count == 0)
+            return 0.0;
+        else
+            return double(event_count) / double(chain_count);
+        }
+
+    //! Get the compressibility factor measured by the chains
+    /*! \returns betaP/rho = 1 + lift_sum / chain_length, or 0 if no straight chains were run
+    */
+    DEVICE double getCompressibility()
+        {
+        if (chain_length == 0.0)
+            return 0.0;
+        else
+            return 1.0 + lift_sum / chain_length;
+        }
+    };
+
+//! Storage for cluster move counters
+/*! \ingroup hpmc_data_structs */
+struct hpmc_clusters_counters_t
+    {
+    unsigned long long int cluster_count;           //!< Count of clusters
+    unsigned long long int particle_count;          //!< Count of particles in the clusters
+    unsigned long long int moved_count;             //!< Count of transformed particles
+    unsigned long long int boundary_reject_count;   //!< Count of clusters rejected at domain boundaries
+    unsigned long long int point_reflection_count;  //!< Count of point reflection moves
+    unsigned long long int pivot_move_count;        //!< Count of pivot moves
+
+    //! Construct a zero set of counters
+    hpmc_clusters_counters_t()
+        {
+        cluster_count = 0;
+        particle_count = 0;
+        moved_count = 0;
+        boundary_reject_count = 0;
+        point_reflection_count = 0;
+        pivot_move_count = 0;
+        }
+
+    //! Get the average cluster size
+    /*! \returns The average number of particles per cluster, or 0 if there are no clusters
+    */
+    DEVICE double getAverageClusterSize()
+        {
+        if (cluster_count == 0)
+            return 0.0;
+        else
+            return double(particle_count) / double(cluster_count);
+        }
+
+    //! Get the fraction of particles moved
+    /*! \returns The ratio of transformed particles to particles in clusters, or 0 if there are no clusters
+    */
+    DEVICE double getMovedFraction()
+        {
+        if (particle_count == 0)
+            return 0.0;
+        else
+            return double(moved_count) / double(particle_count);
+        }
+    };
+
 //! Take the difference of two sets of counters
 DEVICE inline hpmc_implicit_counters_t operator-(const hpmc_implicit_counters_t& a, const hpmc_implicit_counters_t& b)
     {
@@ -332,6 +418,28 @@ DEVICE inline hpmc_muvt_counters_t operator-(const hpmc_muvt_counters_t& a, cons
     return result;
     }
 
+DEVICE inline hpmc_ec_counters_t operator-(const hpmc_ec_counters_t& a, const hpmc_ec_counters_t& b)
+    {
+    hpmc_ec_counters_t result;
+    result.chain_count = a.chain_count - b.chain_count;
+    result.event_count = a.event_count - b.event_count;
+    result.chain_length = a.chain_length - b.chain_length;
+    result.lift_sum = a.lift_sum - b.lift_sum;
+    return result;
+    }
+
+DEVICE inline hpmc_clusters_counters_t operator-(const hpmc_clusters_counters_t& a, const hpmc_clusters_counters_t& b)
+    {
+    hpmc_clusters_counters_t result;
+    result.cluster_count = a.cluster_count - b.cluster_count;
+    result.particle_count = a.particle_count - b.particle_count;
+    result.moved_count = a.moved_count - b.moved_count;
+    result.boundary_reject_count = a.boundary_reject_count - b.boundary_reject_count;
+    result.point_reflection_count = a.point_reflection_count - b.point_reflection_count;
+    result.pivot_move_count = a.pivot_move_count - b.pivot_move_count;
+    return result;
+    }
+
 } // end namespace hpmc
 
 #endif // _HPMC_COUNTERS_H_
@@ -12,12 +12,15 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "hoomd/Integrator.h"
 #include "HPMCPrecisionSetup.h"
 #include "IntegratorHPMC.h"
 #include "Moves.h"
 #include "hoomd/AABBTree.h"
+#include "CellGrid.h"
 
 #include "hoomd/Index1D.h"
 
@@ -106,6 +109,15 @@ class UpdateOrder
         std::vector<unsigned int> m_update_order; //!< Update order
     };
 
+//! Separating direction of a pair of particles found in an earlier overlap check
+/*! \ingroup hpmc_data_structs
+*/
+struct SeparatingDirection
+    {
+    vec3<OverlapReal> sep;  //!< Direction that separated the particles, for the particle with the lower tag as shape a
+    vec3<OverlapReal> r;    //!< Position of the particle with the higher tag relative to the other when sep was found
+    };
+
 }; // end namespace detail
 
 //! HPMC on systems of mono-disperse shapes
@@ -132,6 +144,7 @@ class IntegratorHPMCMono : public IntegratorHPMC
                 free(m_aabbs);
             m_pdata->getBoxChangeSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
             m_pdata->getParticleSortSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+            m_pdata->getGlobalParticleNumberChangeSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotGlobalParticleNumberChange>(this);
             }
 
         virtual void printStats();
@@ -175,6 +188,19 @@ class IntegratorHPMCMono : public IntegratorHPMC
             return m_overlap_idx;
             }
 
+        //! Enable or disable the cache of separating directions in trial moves
+        void setSeparationCache(bool enable)
+            {
+            m_sep_cache_enabled = enable;
+            m_sep_cache.clear();
+            }
+
+        //! Get whether the cache of separating directions is enabled
+        bool getSeparationCache()
+            {
+            return m_sep_cache_enabled;
+            }
+
         //! Count overlaps with the option to exit early at the first detected overlap
         virtual unsigned int countOverlaps(unsigned int timestep, bool early_exit);
 
@@ -252,6 +278,7 @@ class IntegratorHPMCMono : public IntegratorHPMC
                 m_comm->exchangeGhosts();
 
                 m_aabb_tree_invalid = true;
+                m_aabb_tree_refit = false;
                 }
             #endif
             }
@@ -259,13 +286,16 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Build the AABB tree (if needed)
         const detail::AABBTree& buildAABBTree();
 
+        //! Build the cell grid if it is a better choice than the AABB tree for the trial moves
+        bool buildCellGrid();
+
         //! Make list of image indices for boxes to check in small-box mode
         const std::vector<vec3<Scalar> >& updateImageList();
 
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange();
 
-        void invalidateAABBTree(){ m_aabb_tree_invalid = true; }
+        void invalidateAABBTree(){ m_aabb_tree_invalid = true; m_aabb_tree_refit = false; }
 
     protected:
         std::vector<param_type, managed_allocator<param_type> > m_params;   //!< Parameters for each particle type on GPU
@@ -284,6 +314,12 @@ class IntegratorHPMCMono : public IntegratorHPMC
         detail::AABB* m_aabbs;                      //!< list of AABBs, one per particle
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
+        bool m_aabb_tree_refit;                     //!< Flag if the invalid aabb tree may be refit instead of rebuilt
+        std::vector<unsigned int> m_overlap_hint;   //!< Tags of particles found in recent overlaps, most recent first
+        detail::CellGrid m_cell_grid;               //!< Grid of cells for the trial moves of similarly sized particles
+
+        bool m_sep_cache_enabled;                   //!< True if trial moves start overlap checks from cached directions
+        std::unordered_map<uint64_t, detail::SeparatingDirection> m_sep_cache; //!< Separating directions by pair of tags
 
         bool m_past_first_run;                      //!< Flag to test if the first run() has started
 
@@ -295,6 +331,28 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Grow the m_aabbs list
         virtual void growAABBList(unsigned int N);
 
+        //! Count the overlaps of a single particle
+        unsigned int countParticleOverlaps(unsigned int i,
+                                           const Scalar4 *postype,
+                                           const Scalar4 *orientation,
+                                           const unsigned int *tag,
+                                           const unsigned int *overlaps,
+                                           bool early_exit,
+                                           bool all_pairs,
+                                           unsigned int& partner,
+                                           unsigned int& err_count);
+
+        //! Remember the particles of an overlapping pair to check them first in the next early exit overlap count
+        void addOverlapHint(unsigned int tag_i, unsigned int tag_j);
+
+        //! Check a pair of particles for overlap, starting from the separating direction found in an earlier check
+        bool testOverlapCached(const vec3<Scalar>& r_ij,
+                               const Shape& shape_i,
+                               const Shape& shape_j,
+                               unsigned int tag_i,
+                               unsigned int tag_j,
+                               unsigned int& err_count);
+
         //! Limit the maximum move distances
         virtual void limitMoveDistances();
 
@@ -304,7 +362,9 @@ class IntegratorHPMCMono : public IntegratorHPMC
             m_image_list_valid = false;
             // changing the box does not necessarily invalidate the AABB tree - however, practically
             // anything that changes the box (i.e. NPT, box_resize) is also moving the particles,
-            // so use it as a sign to rebuild the AABB tree
+            // so use it as a sign to update the AABB tree. The particles are scaled affinely with the box, which
+            // preserves the structure of a tree that was valid before the change, so the tree only needs a refit.
+            m_aabb_tree_refit = m_aabb_tree_refit || !m_aabb_tree_invalid;
             m_aabb_tree_invalid = true;
             }
 
@@ -312,6 +372,13 @@ class IntegratorHPMCMono : public IntegratorHPMC
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            m_aabb_tree_refit = false;
+            }
+
+        //! callback so that tags of removed particles or of an earlier snapshot are not used as overlap hints
+        virtual void slotGlobalParticleNumberChange()
+            {
+            m_overlap_hint.clear();
             }
     };
 
@@ -323,6 +390,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_is_initialized(false),
               m_image_list_valid(false),
               m_hasOrientation(true),
+              m_sep_cache_enabled(false),
               m_past_first_run(false)
     {
     // allocate the parameter storage
@@ -335,6 +403,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     // Connect to the BoxChange signal
     m_pdata->getBoxChangeSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
     m_pdata->getParticleSortSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotGlobalParticleNumberChange>(this);
 
     m_image_list_rebuilds = 0;
     m_image_list_warning_issued = false;
@@ -343,6 +412,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     m_aabbs = NULL;
     m_aabbs_capacity = 0;
     m_aabb_tree_invalid = true;
+    m_aabb_tree_refit = false;
     }
 
 template <class Shape>
@@ -417,8 +487,11 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     m_update_order.resize(m_pdata->getN());
     m_update_order.shuffle(timestep);
 
-    // update the AABB Tree
-    buildAABBTree();
+    // find the neighbors in the trial moves with the cell grid when the particles have similar sizes, and with the
+    // AABB tree otherwise
+    bool use_cell_grid = buildCellGrid();
+    if (!use_cell_grid)
+        buildAABBTree();
     // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
     limitMoveDistances();
     // update the image list
@@ -434,12 +507,18 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // drop the directions of pairs that are no longer neighbors once the cache grows large
+    const unsigned int max_sep_cache_per_particle = 32;
+    if (m_sep_cache.size() > max_sep_cache_per_particle*(m_pdata->getN() + m_pdata->getNGhosts()))
+        m_sep_cache.clear();
+
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         //access move sizes
         ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
@@ -505,8 +584,44 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             bool overlap=false;
             detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
 
+            if (use_cell_grid && !reject_external)
+                {
+                // the cells are at least as wide as the largest circumsphere and the box is at least 3 cells wide,
+                // so all possible overlaps are with the nearest image of a particle in a neighboring cell
+                const unsigned int *nbr_cells = m_cell_grid.getNeighborCells(m_cell_grid.getCell(pos_i));
+                for (unsigned int cur_nbr = 0; cur_nbr < m_cell_grid.getNumNeighborCells() && !overlap; cur_nbr++)
+                    {
+                    unsigned int cell = nbr_cells[cur_nbr];
+                    const unsigned int *cell_particles = m_cell_grid.getCellParticles(cell);
+                    for (unsigned int cur_p = 0; cur_p < m_cell_grid.getCellSize(cell); cur_p++)
+                        {
+                        unsigned int j = cell_particles[cur_p];
+                        if (j == i)
+                            continue;
+
+                        Scalar4 postype_j = h_postype.data[j];
+                        vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(postype_j) - pos_i)));
+
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(h_orientation.data[j]), m_params[typ_j]);
+
+                        counters.overlap_checks++;
+                        if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && (m_sep_cache_enabled
+                                ? testOverlapCached(r_ij, shape_i, shape_j, h_tag.data[i], h_tag.data[j],
+                                                    counters.overlap_err_count)
+                                : test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count)))
+                            {
+                            overlap = true;
+                            break;
+                            }
+                        }
+                    }
+                }
+
             // All image boxes (including the primary)
-            const unsigned int n_images = m_image_list.size();
+            const unsigned int n_images = use_cell_grid ? 0 : m_image_list.size();
             for (unsigned int cur_image = 0; cur_image < n_images && !reject_external; cur_image++) // only do the loop if the external is accepted. allows to track statistics better
                 {
                 vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
@@ -559,7 +674,10 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                 counters.overlap_checks++;
                                 if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
                                     && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                                    && ((m_sep_cache_enabled && j != i)
+                                        ? testOverlapCached(r_ij, shape_i, shape_j, h_tag.data[i], h_tag.data[j],
+                                                            counters.overlap_err_count)
+                                        : test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count)))
                                     {
                                     overlap = true;
                                     break;
@@ -592,10 +710,17 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                   else
                       counters.rotate_accept_count++;
                   }
-                // update the position of the particle in the tree for future updates
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i);
-                m_aabb_tree.update(i, aabb);
+                // update the position of the particle in the tree or the grid for future updates
+                if (use_cell_grid)
+                    {
+                    m_cell_grid.move(i, m_cell_grid.getCell(pos_i));
+                    }
+                else
+                    {
+                    detail::AABB aabb = aabb_i_local;
+                    aabb.translate(pos_i);
+                    m_aabb_tree.update(i, aabb);
+                    }
 
                 // update position of particle
                 h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
@@ -666,12 +791,16 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     communicate(true);
 
     // all particle have been moved, the aabb tree is now invalid
-    m_aabb_tree_invalid = true;
+    invalidateAABBTree();
     }
 
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
+
+    The particles are checked in parallel. With \a early_exit, all threads stop as soon as one of them finds an
+    overlap, and the particles of the last few overlapping pairs are checked first: in a sequence of rejected box
+    moves, the same pairs tend to overlap again.
 */
 template <class Shape>
 unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, bool early_exit)
@@ -703,90 +832,79 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
     // access parameters and interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
-    // Loop over all particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        // read in the current position and orientation
-        Scalar4 postype_i = h_postype.data[i];
-        Scalar4 orientation_i = h_orientation.data[i];
-        unsigned int typ_i = __scalar_as_int(postype_i.w);
-        Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
-        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+    const unsigned int N = m_pdata->getN();
 
-        // Check particle against AABB tree for neighbors
-        detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+    if (early_exit)
+        {
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
-        const unsigned int n_images = m_image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        // check the particles of recent overlaps against all of their neighbors first
+        const unsigned int n_rtag = m_pdata->getRTags().size();
+        for (unsigned int k = 0; k < m_overlap_hint.size(); k++)
             {
-            vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-            detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
-
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
-                {
-                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
-                    {
-                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+            if (m_overlap_hint[k] >= n_rtag)
+                continue;
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+            unsigned int i = h_rtag.data[m_overlap_hint[k]];
+            if (i >= N)
+                continue;
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
+            unsigned int j;
+            if (countParticleOverlaps(i, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data, true, true,
+                                      j, err_count))
+                {
+                addOverlapHint(h_tag.data[i], h_tag.data[j]);
+                overlap_count = 1;
+                break;
+                }
+            }
+        }
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+    if (!overlap_count)
+        {
+        // set by the first thread that finds an overlap when exiting early
+        int found = 0;
+        unsigned int found_i = 0, found_j = 0;
 
-                            unsigned int typ_j = __scalar_as_int(postype_j.w);
-                            Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+        // Loop over all particles
+        #pragma omp parallel for schedule(dynamic, 16) reduction(+:overlap_count,err_count)
+        for (unsigned int i = 0; i < N; i++)
+            {
+            if (early_exit)
+                {
+                int stop;
+                #pragma omp atomic read
+                stop = found;
+                if (stop)
+                    continue;
+                }
 
-                            if (h_tag.data[i] <= h_tag.data[j]
-                                && h_overlaps.data[m_overlap_idx(typ_i,typ_j)]
-                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                && test_overlap(r_ij, shape_i, shape_j, err_count)
-                                && test_overlap(-r_ij, shape_j, shape_i, err_count))
-                                {
-                                overlap_count++;
-                                if (early_exit)
-                                    {
-                                    // exit early from loop over neighbor particles
-                                    break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
+            unsigned int j;
+            unsigned int n = countParticleOverlaps(i, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data,
+                                                   early_exit, false, j, err_count);
+            overlap_count += n;
 
-                if (overlap_count && early_exit)
+            if (n && early_exit)
+                {
+                #pragma omp critical (hpmc_count_overlaps)
                     {
-                    break;
+                    if (!found)
+                        {
+                        found_i = i;
+                        found_j = j;
+                        #pragma omp atomic write
+                        found = 1;
+                        }
                     }
-                } // end loop over AABB nodes
-
-            if (overlap_count && early_exit)
-                {
-                break;
                 }
-            } // end loop over images
+            }
 
-        if (overlap_count && early_exit)
+        if (found)
             {
-            break;
+            addOverlapHint(h_tag.data[found_i], h_tag.data[found_j]);
+            overlap_count = 1;
             }
-        } // end loop over particles
+        }
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
@@ -802,6 +920,173 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
     return overlap_count;
     }
 
+/*! \param i Index of the particle to check
+    \param postype Particle positions and types
+    \param orientation Particle orientations
+    \param tag Particle tags
+    \param overlaps Interaction matrix
+    \param early_exit Return after the first overlap found if true
+    \param all_pairs Check \a i against all particles if true, otherwise only against those with a tag not smaller
+                     than the tag of \a i (so that every pair is counted once in a loop over all particles)
+    \param partner Set to the index of the last overlapping particle found
+    \param err_count Error counter of the overlap checks
+
+    \returns The number of overlaps of particle \a i
+
+    countParticleOverlaps() only reads the AABB tree and the image list, which must be up to date. It may be called
+    concurrently from several threads.
+*/
+template <class Shape>
+unsigned int IntegratorHPMCMono<Shape>::countParticleOverlaps(unsigned int i,
+                                                              const Scalar4 *postype,
+                                                              const Scalar4 *orientation,
+                                                              const unsigned int *tag,
+                                                              const unsigned int *overlaps,
+                                                              bool early_exit,
+                                                              bool all_pairs,
+                                                              unsigned int& partner,
+                                                              unsigned int& err_count)
+    {
+    unsigned int overlap_count = 0;
+
+    // read in the current position and orientation
+    Scalar4 postype_i = postype[i];
+    Scalar4 orientation_i = orientation[i];
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
+    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+    // Check particle against AABB tree for neighbors
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    const unsigned int n_images = m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        // read in its position and orientation
+                        unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
+
+                        Scalar4 postype_j = postype[j];
+                        Scalar4 orientation_j = orientation[j];
+
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+
+                        if ((all_pairs || tag[i] <= tag[j])
+                            && overlaps[m_overlap_idx(typ_i,typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, err_count)
+                            && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                            {
+                            overlap_count++;
+                            partner = j;
+                            if (early_exit)
+                                {
+                                // exit early from loop over neighbor particles
+                                return overlap_count;
+                                }
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            } // end loop over AABB nodes
+        } // end loop over images
+
+    return overlap_count;
+    }
+
+/*! \param tag_i Tag of the first particle of the pair
+    \param tag_j Tag of the second particle of the pair
+
+    Only a few tags are kept, so that checking them first costs little when they no longer overlap.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::addOverlapHint(unsigned int tag_i, unsigned int tag_j)
+    {
+    const unsigned int max_hints = 8;
+
+    unsigned int tags[2] = {tag_j, tag_i};
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        std::vector<unsigned int>::iterator it = std::find(m_overlap_hint.begin(), m_overlap_hint.end(), tags[k]);
+        if (it != m_overlap_hint.end())
+            m_overlap_hint.erase(it);
+        m_overlap_hint.insert(m_overlap_hint.begin(), tags[k]);
+        }
+
+    if (m_overlap_hint.size() > max_hints)
+        m_overlap_hint.resize(max_hints);
+    }
+
+/*! \param r_ij Position of particle j relative to particle i
+    \param shape_i Shape of particle i
+    \param shape_j Shape of particle j
+    \param tag_i Tag of particle i
+    \param tag_j Tag of particle j
+    \param err_count Incremented when an error condition occurs in the overlap test
+    \returns true when the particles overlap
+
+    Small trial moves rarely change the direction that separates two particles, so when a pair was disjoint in an
+    earlier check, that direction usually proves it disjoint again with a single support function evaluation. The
+    cached direction is only a starting point for the overlap test and never changes its result. It is ignored once the
+    relative position of the pair changed by more than a quarter of the sum of the circumsphere radii since it was
+    found.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::testOverlapCached(const vec3<Scalar>& r_ij,
+                                                  const Shape& shape_i,
+                                                  const Shape& shape_j,
+                                                  unsigned int tag_i,
+                                                  unsigned int tag_j,
+                                                  unsigned int& err_count)
+    {
+    // the entry of a pair is stored with the lower tag as the first particle
+    bool swap = tag_i > tag_j;
+    uint64_t key = swap ? (uint64_t(tag_j) << 32 | tag_i) : (uint64_t(tag_i) << 32 | tag_j);
+    vec3<OverlapReal> r_ab = swap ? vec3<OverlapReal>(-r_ij) : vec3<OverlapReal>(r_ij);
+
+    detail::SeparatingDirection& entry = m_sep_cache[key];
+
+    vec3<OverlapReal> sep;
+    vec3<OverlapReal> dr = r_ab - entry.r;
+    OverlapReal max_dr = OverlapReal(0.125)*(shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter());
+    if (dot(dr, dr) < max_dr*max_dr)
+        sep = swap ? -entry.sep : entry.sep;
+
+    bool overlap = test_overlap(r_ij, shape_i, shape_j, err_count, sep);
+
+    if (!overlap)
+        {
+        entry.sep = swap ? -sep : sep;
+        entry.r = r_ab;
+        }
+    return overlap;
+    }
+
 template <class Shape>
 Scalar IntegratorHPMCMono<Shape>::getMaxDiameter()
     {
@@ -1020,7 +1305,7 @@ void IntegratorHPMCMono<Shape>::updateCellWidth()
     // changing the cell width means that the particle shapes have changed, assume this invalidates the
     // image list and aabb tree
     m_image_list_valid = false;
-    m_aabb_tree_invalid = true;
+    invalidateAABBTree();
     }
 
 template <class Shape>
@@ -1051,6 +1336,9 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
     this is on the next timestep. But in same cases (i.e. NPT), the tree may need to be rebuilt several times in a
     single step because of box volume moves.
 
+    When the tree was valid before the box changed (m_aabb_tree_refit), the particles have only been scaled with the
+    box and the tree is refit to the new AABBs instead, which is much cheaper than a rebuild.
+
     Subclasses that override update() or other methods must be user to set m_aabb_tree_invalid appropriately, or
     erroneous simulations will result.
 
@@ -1061,15 +1349,17 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
     {
     if (m_aabb_tree_invalid)
         {
-        m_exec_conf->msg->notice(8) << "Building AABB tree: " << m_pdata->getN() << " ptls " << m_pdata->getNGhosts() << " ghosts" << std::endl;
-        if (this->m_prof) this->m_prof->push(this->m_exec_conf, "AABB tree build");
+        // grow the AABB list to the needed size
+        unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
+        bool refit = m_aabb_tree_refit && n_aabb == m_aabb_tree.getNumParticles();
+
+        m_exec_conf->msg->notice(8) << (refit ? "Refitting" : "Building") << " AABB tree: " << m_pdata->getN() << " ptls " << m_pdata->getNGhosts() << " ghosts" << std::endl;
+        if (this->m_prof) this->m_prof->push(this->m_exec_conf, refit ? "AABB tree refit" : "AABB tree build");
         // build the AABB tree
             {
             ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
 
-            // grow the AABB list to the needed size
-            unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
             if (n_aabb > 0)
                 {
                 growAABBList(n_aabb);
@@ -1079,7 +1369,11 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
                     Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[__scalar_as_int(h_postype.data[i].w)]);
                     m_aabbs[i] = shape.getAABB(vec3<Scalar>(h_postype.data[i]));
                     }
-                m_aabb_tree.buildTree(m_aabbs, n_aabb);
+
+                if (refit)
+                    m_aabb_tree.refit(m_aabbs, n_aabb);
+                else
+                    m_aabb_tree.buildTree(m_aabbs, n_aabb);
                 }
             }
 
@@ -1087,9 +1381,66 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
         }
 
     m_aabb_tree_invalid = false;
+    m_aabb_tree_refit = false;
     return m_aabb_tree;
     }
 
+/*! A uniform grid of cells finds the neighbors of a particle with a few memory accesses, and is faster than the AABB
+    tree when all particles have similar circumsphere diameters. With a broad distribution of diameters, the cells
+    sized for the largest particles contain many small ones, and the tree is used instead. The grid also needs a box
+    that is at least 3 cells wide, and is not used with domain decomposition.
+
+    The grid is rebuilt on every call, because the particles may have been moved, sorted, or inserted since the last
+    one. Accepted trial moves update it incrementally.
+
+    \returns true if the grid was built and should be used for the trial moves
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::buildCellGrid()
+    {
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+    // largest ratio of circumsphere diameters for which the grid is used
+    const Scalar max_diameter_ratio = Scalar(1.5);
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    // find the range of diameters of the types present
+    std::vector<bool> present(m_pdata->getNTypes(), false);
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        present[__scalar_as_int(h_postype.data[i].w)] = true;
+
+    Scalar min_d = Scalar(0.0), max_d = Scalar(0.0);
+    bool first = true;
+    quat<Scalar> q;
+    for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+        {
+        if (!present[typ])
+            continue;
+        Shape shape(q, m_params[typ]);
+        Scalar d = shape.getCircumsphereDiameter();
+        min_d = first ? d : std::min(min_d, d);
+        max_d = first ? d : std::max(max_d, d);
+        first = false;
+        }
+
+    if (!(max_d > Scalar(0.0)) || max_d > max_diameter_ratio*min_d)
+        return false;
+
+    if (!m_cell_grid.setup(m_pdata->getBox(), max_d, this->m_sysdef->getNDimensions()))
+        return false;
+
+    m_exec_conf->msg->notice(8) << "Building cell grid: " << m_pdata->getN() << " ptls" << std::endl;
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "Cell grid build");
+    m_cell_grid.build(h_postype.data, m_pdata->getN());
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    return true;
+    }
+
 /*! Call to reduce the m_d values down to safe levels for the bvh tree + small box limitations. That code path
     will not work if particles can wander more than one image in a time step.
 
@@ -1242,6 +1593,8 @@ template < class Shape > void export_IntegratorHPMCMono(pybind11::module& m, con
           .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
           .def("setParam", &IntegratorHPMCMono<Shape>::setParam)
           .def("setOverlapChecks", &IntegratorHPMCMono<Shape>::setOverlapChecks)
+          .def("setSeparationCache", &IntegratorHPMCMono<Shape>::setSeparationCache)
+          .def("getSeparationCache", &IntegratorHPMCMono<Shape>::getSeparationCache)
           .def("setExternalField", &IntegratorHPMCMono<Shape>::setExternalField)
           .def("mapOverlaps", &IntegratorHPMCMono<Shape>::PyMapOverlaps)
           ;
@@ -0,0 +1,751 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __HPMC_MONO_EC__H__
+#define __HPMC_MONO_EC__H__
+
+#include "IntegratorHPMCMono.h"
+#include "ShapeSphere.h"
+
+/*! \file IntegratorHPMCMonoEC.h
+    \brief Defines the template class for HPMC with event chain moves
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Bisect the boundary of an overlap along a direction
+/*! \param r_ij Position of particle j relative to particle i
+    \param e Unit direction in which particle i moves
+    \param s_free Displacement of particle i where the particles do not overlap
+    \param s_overlap Displacement of particle i where the particles overlap
+    \param a Shape of particle i
+    \param b Shape of particle j
+    \param err Incremented if there is an error condition in the overlap checks
+    \returns A displacement between \a s_free and \a s_overlap where the particles are just apart
+*/
+template <class Shape>
+inline Scalar ec_bisect(const vec3<Scalar>& r_ij, const vec3<Scalar>& e, Scalar s_free, Scalar s_overlap,
+                        const Shape& a, const Shape& b, unsigned int& err)
+    {
+    const Scalar tol = Scalar(1e-6) * Scalar(0.5) * (a.getCircumsphereDiameter() + b.getCircumsphereDiameter());
+    for (unsigned int k = 0; k < 64 && s_overlap - s_free > tol; k++)
+        {
+        Scalar s_mid = Scalar(0.5) * (s_free + s_overlap);
+        if (test_overlap(r_ij - s_mid*e, a, b, err))
+            s_overlap = s_mid;
+        else
+            s_free = s_mid;
+        }
+    return s_free;
+    }
+
+//! Find the first collision of a particle moving along a direction
+/*! \param r_ij Position of particle j relative to particle i
+    \param e Unit direction in which particle i moves
+    \param s_max Maximum displacement of particle i
+    \param a Shape of particle i
+    \param b Shape of particle j
+    \param s Output: displacement of particle i at the collision
+    \param err Incremented if there is an error condition in the overlap checks
+    \returns true if particle i collides with particle j before moving \a s_max
+
+    The displacement range where the circumspheres overlap is found exactly. That range is searched with test_overlap()
+    in steps of a fiftieth of the smaller circumsphere diameter, and the first overlapping step is bisected. Grazing
+    collisions shorter than a step may be missed, the caller has to check that the final position is free (see
+    ec_backtrack()). The returned displacement leaves the particles just apart.
+
+    \ingroup hpmc_integrators
+*/
+template <class Shape>
+inline bool ec_collision(const vec3<Scalar>& r_ij, const vec3<Scalar>& e, Scalar s_max,
+                         const Shape& a, const Shape& b, Scalar& s, unsigned int& err)
+    {
+    Scalar d_a = a.getCircumsphereDiameter();
+    Scalar d_b = b.getCircumsphereDiameter();
+    Scalar D = (d_a + d_b) / Scalar(2.0);
+
+    // ray cast against the circumsphere
+    Scalar proj = dot(r_ij, e);
+    Scalar disc = proj*proj - dot(r_ij, r_ij) + D*D;
+    if (disc <= Scalar(0.0))
+        return false;
+
+    Scalar root = fast::sqrt(disc);
+    Scalar s_lo = proj - root;
+    Scalar s_hi = proj + root;
+    if (s_hi <= Scalar(0.0) || s_lo >= s_max)
+        return false;
+    s_lo = detail::max(s_lo, Scalar(0.0));
+    s_hi = detail::min(s_hi, s_max);
+
+    // march to the first overlap, the particles do not overlap at s_lo
+    const Scalar h = Scalar(0.02) * detail::min(d_a, d_b);
+    Scalar s_free = s_lo;
+    Scalar s_test = s_lo;
+    bool overlap = false;
+    while (s_test < s_hi)
+        {
+        s_test = detail::min(s_test + h, s_hi);
+        if (test_overlap(r_ij - s_test*e, a, b, err))
+            {
+            overlap = true;
+            break;
+            }
+        s_free = s_test;
+        }
+
+    if (!overlap)
+        return false;
+
+    s = ec_bisect(r_ij, e, s_free, s_test, a, b, err);
+    return true;
+    }
+
+//! Find the first collision of a sphere moving along a direction
+/*! The collision of two spheres is found with an exact ray cast. Spheres that move apart never collide, so that
+    spheres left touching by a collision do not collide again.
+*/
+template <>
+inline bool ec_collision(const vec3<Scalar>& r_ij, const vec3<Scalar>& e, Scalar s_max,
+                         const ShapeSphere& a, const ShapeSphere& b, Scalar& s, unsigned int& err)
+    {
+    Scalar proj = dot(r_ij, e);
+    if (proj <= Scalar(0.0))
+        return false;
+
+    Scalar D = Scalar(a.params.radius + b.params.radius);
+    Scalar disc = proj*proj - dot(r_ij, r_ij) + D*D;
+    if (disc < Scalar(0.0))
+        return false;
+
+    Scalar s_contact = proj - fast::sqrt(disc);
+    if (s_contact >= s_max)
+        return false;
+
+    s = detail::max(s_contact, Scalar(0.0));
+    return true;
+    }
+
+//! Trait for shapes whose collisions are found exactly
+/*! Moves of other shapes are checked for overlaps at their final position, because the stepped search in
+    ec_collision() may miss grazing collisions.
+*/
+template <class Shape>
+struct ec_exact_collision
+    {
+    static const bool value = false;
+    };
+
+//! Sphere collisions are found with an exact ray cast
+template <>
+struct ec_exact_collision<ShapeSphere>
+    {
+    static const bool value = true;
+    };
+
+//! Trait for shapes that support reflected event chains
+/*! Reflected chains change the direction at a collision by a reflection about the contact normal, which is only
+    known in closed form for spheres.
+*/
+template <class Shape>
+struct ec_reflect_supported
+    {
+    static const bool value = false;
+    };
+
+//! Spheres support reflected event chains
+template <>
+struct ec_reflect_supported<ShapeSphere>
+    {
+    static const bool value = true;
+    };
+
+}; // end namespace detail
+
+//! Template class for HPMC update with event chain moves
+/*! Each time step runs N event chains, each of them starting from a randomly chosen particle. The active particle
+    moves along the chain direction until it collides with another particle, which then continues the chain (a lift).
+    The chain ends when the total displacement reaches the chain length. All displacements are accepted, there are
+    no rejected translation moves.
+
+    Straight chains move along +x, +y or +z (chosen randomly per chain) and keep their direction. Reflected chains
+    start in a random direction and reflect it about the line through the centers of the colliding particles at every
+    lift, which is only supported for spheres. The pressure is measured from the straight chains as
+    \f$ \beta P = \rho (1 + \sum \Delta / \sum \ell) \f$, where \f$ \Delta \f$ is the center separation along the
+    chain direction at a lift and \f$ \ell \f$ is the chain length.
+
+    Collisions are found with the AABB tree, querying the volume swept by the active particle. The free flight of
+    every step is limited to the move size d of the particle type, so that the image list covers the swept volume.
+    Except for spheres, the final position of every step is checked for overlaps and the step is shortened to end in
+    front of an overlapping particle, which then continues the chain.
+    Shapes with orientation additionally make one Metropolis rotation trial per particle and step.
+
+    Event chains run on a single rank only.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class IntegratorHPMCMonoEC : public IntegratorHPMCMono<Shape>
+    {
+    public:
+        //! Construct the integrator
+        IntegratorHPMCMonoEC(std::shared_ptr<SystemDefinition> sysdef,
+                             unsigned int seed);
+        //! Destructor
+        virtual ~IntegratorHPMCMonoEC();
+
+        //! Set the total displacement of a chain
+        void setChainLength(Scalar chain_length)
+            {
+            m_chain_length = chain_length;
+            }
+
+        //! Get the total displacement of a chain
+        Scalar getChainLength()
+            {
+            return m_chain_length;
+            }
+
+        //! Enable or disable reflected chains
+        void setReflect(bool reflect)
+            {
+            if (reflect && !detail::ec_reflect_supported<Shape>::value)
+                {
+                this->m_exec_conf->msg->error() << "integrate.*: Reflected event chains are only supported for spheres"
+                                                << std::endl;
+                throw std::runtime_error("Error setting event chain parameters");
+                }
+            m_reflect = reflect;
+            }
+
+        //! Get whether chains are reflected
+        bool getReflect()
+            {
+            return m_reflect;
+            }
+
+        //! Reset statistics counters
+        virtual void resetStats()
+            {
+            IntegratorHPMCMono<Shape>::resetStats();
+            m_ec_count_run_start = m_ec_count;
+            }
+
+        //! Print statistics about the hpmc steps taken
+        virtual void printStats()
+            {
+            IntegratorHPMCMono<Shape>::printStats();
+
+            hpmc_ec_counters_t result = getECCounters(1);
+
+            double cur_time = double(this->m_clock.getTime()) / Scalar(1e9);
+
+            this->m_exec_conf->msg->notice(2) << "-- Event chain stats:" << "\n";
+            this->m_exec_conf->msg->notice(2) << "Chains per second:   " << double(result.chain_count)/cur_time << "\n";
+            this->m_exec_conf->msg->notice(2) << "Events per second:   " << double(result.event_count)/cur_time << "\n";
+            this->m_exec_conf->msg->notice(2) << "Events per chain:    " << result.getEventsPerChain() << "\n";
+            if (result.chain_length > 0.0)
+                {
+                this->m_exec_conf->msg->notice(2) << "Compressibility Z:   " << result.getCompressibility() << "\n";
+                }
+            }
+
+        //! Get the current counter values
+        hpmc_ec_counters_t getECCounters(unsigned int mode=0);
+
+        /* \returns a list of provided quantities
+        */
+        std::vector< std::string > getProvidedLogQuantities()
+            {
+            // start with the integrator provided quantities
+            std::vector< std::string > result = IntegratorHPMCMono<Shape>::getProvidedLogQuantities();
+
+            // then add ours
+            result.push_back("hpmc_ec_pressure");
+            result.push_back("hpmc_ec_events_per_chain");
+            return result;
+            }
+
+        //! Get the value of a logged quantity
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    protected:
+        Scalar m_chain_length;                      //!< Total displacement of a chain
+        bool m_reflect;                             //!< True if chains are reflected at collisions
+
+        hpmc_ec_counters_t m_ec_count;              //!< Event chain counters
+        hpmc_ec_counters_t m_ec_count_run_start;    //!< Event chain counters at run start
+        hpmc_ec_counters_t m_ec_count_step_start;   //!< Event chain counters at the start of the last step
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+        //! Find the first collision of a moving particle
+        bool findCollision(unsigned int i,
+                           const vec3<Scalar>& pos_i,
+                           const Shape& shape_i,
+                           unsigned int typ_i,
+                           const vec3<Scalar>& e,
+                           Scalar step,
+                           const Scalar4 *postype,
+                           const Scalar4 *orientation,
+                           const unsigned int *overlaps,
+                           hpmc_counters_t& counters,
+                           unsigned int& j_hit,
+                           Scalar& s_hit,
+                           vec3<Scalar>& r_hit);
+
+        //! Find a particle that overlaps a particle at a given position
+        bool findOverlap(unsigned int i,
+                         const vec3<Scalar>& pos_i,
+                         const Shape& shape_i,
+                         unsigned int typ_i,
+                         const Scalar4 *postype,
+                         const Scalar4 *orientation,
+                         const unsigned int *overlaps,
+                         hpmc_counters_t& counters,
+                         unsigned int& j_overlap,
+                         vec3<Scalar>& r_overlap);
+    };
+
+/*! \param sysdef System definition
+    \param seed Random number generator seed
+*/
+template< class Shape >
+IntegratorHPMCMonoEC< Shape >::IntegratorHPMCMonoEC(std::shared_ptr<SystemDefinition> sysdef,
+                                                    unsigned int seed)
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_chain_length(1.0), m_reflect(false)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing IntegratorHPMCMonoEC" << std::endl;
+
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        this->m_exec_conf->msg->error() << "integrate.*: Event chains are not supported with domain decomposition"
+                                        << std::endl;
+        throw std::runtime_error("Error initializing IntegratorHPMCMonoEC");
+        }
+    #endif
+    }
+
+//! Destructor
+template< class Shape >
+IntegratorHPMCMonoEC< Shape >::~IntegratorHPMCMonoEC()
+    {
+    this->m_exec_conf->msg->notice(5) << "Destroying IntegratorHPMCMonoEC" << std::endl;
+    }
+
+template< class Shape >
+void IntegratorHPMCMonoEC< Shape >::update(unsigned int timestep)
+    {
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoEC update: " << timestep << std::endl;
+    IntegratorHPMC::update(timestep);
+    m_ec_count_step_start = m_ec_count;
+
+    if (this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "integrate.*: External fields are not supported with event chains"
+                                        << std::endl;
+        throw std::runtime_error("Error during HPMC event chain integration");
+        }
+
+    // get needed vars
+    ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+    hpmc_counters_t& counters = h_counters.data[0];
+    const BoxDim& box = this->m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    this->buildAABBTree();
+    // limit m_d entries so that particles cannot possibly wander more than one box image in one step
+    this->limitMoveDistances();
+    // update the image list
+    this->updateImageList();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC EC update");
+
+    // access interaction matrix
+    ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+
+    // access particle data
+    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(this->m_pdata->getTags(), access_location::host, access_mode::read);
+
+    // access move sizes
+    ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+
+    const unsigned int N = this->m_pdata->getN();
+    Saru rng(timestep, this->m_seed, 0x6c2e8a17);
+
+    // end chains that fail to make progress, e.g. when numerical errors leave two particles overlapping
+    const unsigned int max_events = 1000 + 100*N;
+
+    for (unsigned int chain = 0; chain < N && m_chain_length > Scalar(0.0); chain++)
+        {
+        unsigned int i = rand_select(rng, N-1);
+
+        vec3<Scalar> e;
+        if (m_reflect)
+            {
+            Scalar phi = rng.s(Scalar(0.0), Scalar(2.0*M_PI));
+            Scalar cos_theta = (ndim == 2) ? Scalar(0.0) : rng.s(Scalar(-1.0), Scalar(1.0));
+            Scalar sin_theta = fast::sqrt(Scalar(1.0) - cos_theta*cos_theta);
+            e = vec3<Scalar>(sin_theta*fast::cos(phi), sin_theta*fast::sin(phi), cos_theta);
+            }
+        else
+            {
+            unsigned int axis = rand_select(rng, ndim-1);
+            e = vec3<Scalar>(axis == 0 ? 1 : 0, axis == 1 ? 1 : 0, axis == 2 ? 1 : 0);
+            }
+
+        Scalar remaining = m_chain_length;
+        Scalar lift_sum = 0.0;
+        unsigned int n_events = 0;
+        while (remaining > Scalar(0.0))
+            {
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+            unsigned int typ_i = __scalar_as_int(postype_i.w);
+            Shape shape_i(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
+
+            // particles of types that do not move end the chain
+            Scalar step = detail::min(remaining, h_d.data[typ_i]);
+            if (step <= Scalar(0.0))
+                break;
+
+            unsigned int j_hit = i;
+            Scalar s_hit = step;
+            vec3<Scalar> r_hit;
+            bool hit = findCollision(i, pos_i, shape_i, typ_i, e, step, h_postype.data, h_orientation.data,
+                                     h_overlaps.data, counters, j_hit, s_hit, r_hit);
+
+            // the stepped collision search may miss grazing collisions, move back in front of any particle that
+            // overlaps the final position
+            unsigned int j_overlap;
+            vec3<Scalar> r_overlap;
+            while (!detail::ec_exact_collision<Shape>::value && s_hit > Scalar(0.0)
+                   && findOverlap(i, pos_i + s_hit*e, shape_i, typ_i, h_postype.data, h_orientation.data,
+                                  h_overlaps.data, counters, j_overlap, r_overlap))
+                {
+                unsigned int typ_j = __scalar_as_int(h_postype.data[j_overlap].w);
+                Shape shape_j(quat<Scalar>(h_orientation.data[j_overlap]), this->m_params[typ_j]);
+                vec3<Scalar> r_ij = r_overlap + s_hit*e;
+
+                hit = true;
+                j_hit = j_overlap;
+                s_hit = detail::ec_bisect(r_ij, e, Scalar(0.0), s_hit, shape_i, shape_j, counters.overlap_err_count);
+                r_hit = r_ij - s_hit*e;
+                }
+
+            pos_i += s_hit*e;
+            remaining -= s_hit;
+            if (!shape_i.ignoreStatistics())
+                counters.translate_accept_count++;
+
+            // keep the particle in the box so that the image list covers it. A wrapped particle stretches its leaf
+            // of the AABB tree across the box until the tree is rebuilt in the next step, which only costs time.
+            box.wrap(pos_i, h_image.data[i]);
+            h_postype.data[i] = vec_to_scalar4(pos_i, postype_i.w);
+            this->m_aabb_tree.update(i, shape_i.getAABB(pos_i));
+
+            if (hit)
+                {
+                lift_sum += dot(r_hit, e);
+                n_events++;
+
+                if (m_reflect)
+                    {
+                    vec3<Scalar> n = r_hit * fast::rsqrt(dot(r_hit, r_hit));
+                    e = Scalar(2.0)*dot(e, n)*n - e;
+                    e *= fast::rsqrt(dot(e, e));
+                    }
+
+                i = j_hit;
+
+                if (n_events >= max_events)
+                    {
+                    counters.overlap_err_count++;
+                    break;
+                    }
+                }
+            }
+
+        m_ec_count.chain_count++;
+        m_ec_count.event_count += n_events;
+        if (!m_reflect)
+            {
+            m_ec_count.chain_length += m_chain_length - remaining;
+            m_ec_count.lift_sum += lift_sum;
+            }
+        }
+
+    // Metropolis rotation trials for shapes with orientation
+    for (unsigned int k = 0; k < N; k++)
+        {
+        unsigned int i = rand_select(rng, N-1);
+        Scalar4 postype_i = h_postype.data[i];
+        Scalar4 orientation_i = h_orientation.data[i];
+        unsigned int typ_i = __scalar_as_int(postype_i.w);
+        Shape shape_i(quat<Scalar>(orientation_i), this->m_params[typ_i]);
+        if (!shape_i.hasOrientation() || h_a.data[typ_i] == Scalar(0.0))
+            continue;
+
+        move_rotate(shape_i.orientation, rng, h_a.data[typ_i], ndim);
+        h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+
+        unsigned int partner;
+        if (this->countParticleOverlaps(i, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data, true, true,
+                                        partner, counters.overlap_err_count))
+            {
+            h_orientation.data[i] = orientation_i;
+            if (!shape_i.ignoreStatistics())
+                counters.rotate_reject_count++;
+            }
+        else
+            {
+            this->m_aabb_tree.update(i, shape_i.getAABB(vec3<Scalar>(postype_i)));
+            if (!shape_i.ignoreStatistics())
+                counters.rotate_accept_count++;
+            }
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // all particle have been moved, the aabb tree is now invalid
+    this->invalidateAABBTree();
+    }
+
+/*! \param i Index of the moving particle
+    \param pos_i Position of particle i
+    \param shape_i Shape of particle i
+    \param typ_i Type of particle i
+    \param e Unit direction of the move
+    \param step Maximum displacement
+    \param postype Particle positions and types
+    \param orientation Particle orientations
+    \param overlaps Interaction matrix
+    \param counters Counters of the overlap checks
+    \param j_hit Output: particle that particle i collides with first
+    \param s_hit Output: displacement of particle i at the collision, must be initialized to \a step
+    \param r_hit Output: position of particle j_hit relative to particle i at the collision
+    \returns true if particle i collides with another particle before moving \a step
+*/
+template< class Shape >
+bool IntegratorHPMCMonoEC< Shape >::findCollision(unsigned int i,
+                                                  const vec3<Scalar>& pos_i,
+                                                  const Shape& shape_i,
+                                                  unsigned int typ_i,
+                                                  const vec3<Scalar>& e,
+                                                  Scalar step,
+                                                  const Scalar4 *postype,
+                                                  const Scalar4 *orientation,
+                                                  const unsigned int *overlaps,
+                                                  hpmc_counters_t& counters,
+                                                  unsigned int& j_hit,
+                                                  Scalar& s_hit,
+                                                  vec3<Scalar>& r_hit)
+    {
+    bool hit = false;
+
+    // the volume swept by particle i
+    detail::AABB aabb_i_local = detail::merge(shape_i.getAABB(vec3<Scalar>(0,0,0)), shape_i.getAABB(step*e));
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // images of particle i move along with it
+                        if (j == i)
+                            continue;
+
+                        Scalar4 postype_j = postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        if (!overlaps[this->m_overlap_idx(typ_i, typ_j)])
+                            continue;
+
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        Shape shape_j(quat<Scalar>(orientation[j]), this->m_params[typ_j]);
+
+                        counters.overlap_checks++;
+                        Scalar s;
+                        if (detail::ec_collision(r_ij, e, s_hit, shape_i, shape_j, s, counters.overlap_err_count))
+                            {
+                            hit = true;
+                            j_hit = j;
+                            s_hit = s;
+                            r_hit = r_ij - s*e;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }  // end loop over AABB nodes
+        } // end loop over images
+
+    return hit;
+    }
+
+/*! \param i Index of the particle
+    \param pos_i Position to check particle i at
+    \param shape_i Shape of particle i
+    \param typ_i Type of particle i
+    \param postype Particle positions and types
+    \param orientation Particle orientations
+    \param overlaps Interaction matrix
+    \param counters Counters of the overlap checks
+    \param j_overlap Output: a particle that overlaps particle i
+    \param r_overlap Output: position of particle j_overlap relative to \a pos_i
+    \returns true if particle i at \a pos_i overlaps another particle
+*/
+template< class Shape >
+bool IntegratorHPMCMonoEC< Shape >::findOverlap(unsigned int i,
+                                                const vec3<Scalar>& pos_i,
+                                                const Shape& shape_i,
+                                                unsigned int typ_i,
+                                                const Scalar4 *postype,
+                                                const Scalar4 *orientation,
+                                                const unsigned int *overlaps,
+                                                hpmc_counters_t& counters,
+                                                unsigned int& j_overlap,
+                                                vec3<Scalar>& r_overlap)
+    {
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        if (j == i)
+                            continue;
+
+                        Scalar4 postype_j = postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        if (!overlaps[this->m_overlap_idx(typ_i, typ_j)])
+                            continue;
+
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        Shape shape_j(quat<Scalar>(orientation[j]), this->m_params[typ_j]);
+
+                        counters.overlap_checks++;
+                        if (check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                            {
+                            j_overlap = j;
+                            r_overlap = r_ij;
+                            return true;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }  // end loop over AABB nodes
+        } // end loop over images
+
+    return false;
+    }
+
+/*! \param quantity Name of the log quantity to get
+    \param timestep Current time step of the simulation
+    \return the requested log quantity.
+*/
+template<class Shape>
+Scalar IntegratorHPMCMonoEC<Shape>::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    hpmc_ec_counters_t ec_counters = getECCounters(2);
+
+    if (quantity == "hpmc_ec_pressure")
+        {
+        // beta P = rho Z, measured by the straight chains of the last step
+        Scalar rho = Scalar(this->m_pdata->getNGlobal()) / this->m_pdata->getGlobalBox().getVolume(this->m_sysdef->getNDimensions() == 2);
+        return rho * Scalar(ec_counters.getCompressibility());
+        }
+    if (quantity == "hpmc_ec_events_per_chain")
+        {
+        return Scalar(ec_counters.getEventsPerChain());
+        }
+
+    //nothing found -> pass on to base class
+    return IntegratorHPMCMono<Shape>::getLogValue(quantity, timestep);
+    }
+
+/*! \param mode 0 -> Absolute count, 1 -> relative to the start of the run, 2 -> relative to the last executed step
+    \return The current state of the event chain counters
+*/
+template<class Shape>
+hpmc_ec_counters_t IntegratorHPMCMonoEC<Shape>::getECCounters(unsigned int mode)
+    {
+    if (mode == 0)
+        return m_ec_count;
+    else if (mode == 1)
+        return m_ec_count - m_ec_count_run_start;
+    else
+        return m_ec_count - m_ec_count_step_start;
+    }
+
+//! Export this hpmc integrator to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of IntegratorHPMCMonoEC<Shape> will be exported
+*/
+template < class Shape > void export_IntegratorHPMCMonoEC(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_<IntegratorHPMCMonoEC<Shape>, std::shared_ptr< IntegratorHPMCMonoEC<Shape> > >(m, name.c_str(),  pybind11::base< IntegratorHPMCMono<Shape> >())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
+        .def("setChainLength", &IntegratorHPMCMonoEC<Shape>::setChainLength)
+        .def("getChainLength", &IntegratorHPMCMonoEC<Shape>::getChainLength)
+        .def("setReflect", &IntegratorHPMCMonoEC<Shape>::setReflect)
+        .def("getReflect", &IntegratorHPMCMonoEC<Shape>::getReflect)
+        ;
+    }
+
+} // end namespace hpmc
+
+#endif // __HPMC_MONO_EC__H__
@@ -371,7 +371,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
     this->communicate(true);
 
     // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    this->invalidateAABBTree();
     }
 
 template< class Shape >
@@ -446,7 +446,7 @@ void IntegratorHPMCMonoGPU< Shape >::updateCellWidth()
     // changing the cell width means that the particle shapes have changed, assume this invalidates the
     // image list and aabb tree
     this->m_image_list_valid = false;
-    this->m_aabb_tree_invalid = true;
+    this->invalidateAABBTree();
 
     this->m_nominal_width = this->getMaxDiameter();
     this->m_cl->setNominalWidth(this->m_nominal_width);
@@ -28,12 +28,55 @@
 namespace hpmc
 {
 
+namespace detail
+{
+
+//! Adapts a Saru RNG to the random number engine interface of the standard library distributions
+class SaruEngine
+    {
+    public:
+        typedef unsigned int result_type;
+
+        //! Construct the adapter
+        /*! \param rng Saru RNG to draw the random bits from
+        */
+        SaruEngine(Saru& rng)
+            : m_rng(rng)
+            { }
+
+        //! Smallest value returned by operator()
+        static result_type min()
+            {
+            return 0;
+            }
+
+        //! Largest value returned by operator()
+        static result_type max()
+            {
+            return 0xffffffff;
+            }
+
+        //! Draw 32 random bits
+        result_type operator()()
+            {
+            return m_rng.u32();
+            }
+
+    private:
+        Saru& m_rng; //!< The underlying RNG
+    };
+
+}; // end namespace detail
+
 //! Template class for HPMC update with implicit depletants
 /*!
     Depletants are generated randomly on the fly according to the semi-grand canonical ensemble.
 
     The penetrable depletants model is simulated.
 
+    On more than one OpenMP thread, the trial moves are made in parallel on a checkerboard of cells when the box is
+    large enough, see updateCheckerboard(). Otherwise, the particles are moved one after another.
+
     \ingroup hpmc_integrators
 */
 template< class Shape >
@@ -173,6 +216,13 @@ class IntegratorHPMCMonoImplicit : public IntegratorHPMCMono<Shape>
         //! Take one timestep forward
         virtual void update(unsigned int timestep);
 
+        //! Set up the cell grid for parallel trial moves on a checkerboard
+        bool buildCheckerboard(unsigned int timestep);
+
+        //! Make the trial moves of one timestep in parallel on a checkerboard
+        void updateCheckerboard(unsigned int timestep, hpmc_counters_t& counters,
+            hpmc_implicit_counters_t& implicit_counters);
+
         //! Initalize Poisson distribution parameters
         virtual void updatePoissonParameters();
 
@@ -376,530 +426,557 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
     Scalar3 ghost_fraction = this->m_nominal_width / npd;
     #endif
 
-    // Shuffle the order of particles for this step
-    this->m_update_order.resize(this->m_pdata->getN());
-    this->m_update_order.shuffle(timestep);
+    // make the trial moves in parallel on a checkerboard of cells when possible, and serially otherwise
+    bool use_checkerboard = buildCheckerboard(timestep);
 
-    // update the AABB Tree
-    this->buildAABBTree();
     // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
     this->limitMoveDistances();
-    // update the image list
-    this->updateImageList();
-
-    // combine the three seeds
-    std::vector<unsigned int> seed_seq(3);
-    seed_seq[0] = this->m_seed;
-    seed_seq[1] = timestep;
-    seed_seq[2] = this->m_exec_conf->getRank();
-    std::seed_seq seed(seed_seq.begin(), seed_seq.end());
-
-    // RNG for poisson distribution
-    std::mt19937 rng_poisson(seed);
 
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC implicit");
 
-    // access depletant insertion sphere dimensions
-    ArrayHandle<Scalar> h_d_min(m_d_min, access_location::host, access_mode::read);
-    ArrayHandle<Scalar> h_d_max(m_d_max, access_location::host, access_mode::read);
-
-    // loop over local particles nselect times
-    for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+    if (use_checkerboard)
         {
-        // access particle data and system box
-        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-
-        // access interaction matrix
-        ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
-
-        //access move sizes
-        ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
-
-        // loop through N particles in a shuffled order
-        for (unsigned int cur_particle = 0; cur_particle < this->m_pdata->getN(); cur_particle++)
+        updateCheckerboard(timestep, counters, implicit_counters);
+        }
+    else
+        {
+        // Shuffle the order of particles for this step
+        this->m_update_order.resize(this->m_pdata->getN());
+        this->m_update_order.shuffle(timestep);
+
+        // update the AABB Tree
+        this->buildAABBTree();
+        // update the image list
+        this->updateImageList();
+
+        // combine the three seeds
+        std::vector<unsigned int> seed_seq(3);
+        seed_seq[0] = this->m_seed;
+        seed_seq[1] = timestep;
+        seed_seq[2] = this->m_exec_conf->getRank();
+        std::seed_seq seed(seed_seq.begin(), seed_seq.end());
+
+        // RNG for poisson distribution
+        std::mt19937 rng_poisson(seed);
+
+        // access depletant insertion sphere dimensions
+        ArrayHandle<Scalar> h_d_min(m_d_min, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_d_max(m_d_max, access_location::host, access_mode::read);
+
+        // loop over local particles nselect times
+        for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
             {
-            unsigned int i = this->m_update_order[cur_particle];
+            // access particle data and system box
+            ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
 
-            // read in the current position and orientation
-            Scalar4 postype_i = h_postype.data[i];
-            Scalar4 orientation_i = h_orientation.data[i];
-            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+            // access interaction matrix
+            ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
 
-            #ifdef ENABLE_MPI
-            if (this->m_comm)
-                {
-                // only move particle if active
-                if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
-                    continue;
-                }
-            #endif
-
-            // make a trial move for i
-            Saru rng_i(i, this->m_seed + this->m_exec_conf->getRank()*this->m_nselect + i_nselect, timestep);
-            int typ_i = __scalar_as_int(postype_i.w);
-            Shape shape_i(quat<Scalar>(orientation_i), this->m_params[typ_i]);
-            unsigned int move_type_select = rng_i.u32() & 0xffff;
-            bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < this->m_move_ratio);
-
-            if (move_type_translate)
+            //access move sizes
+            ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+
+            // loop through N particles in a shuffled order
+            for (unsigned int cur_particle = 0; cur_particle < this->m_pdata->getN(); cur_particle++)
                 {
-                move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
+                unsigned int i = this->m_update_order[cur_particle];
+
+                // read in the current position and orientation
+                Scalar4 postype_i = h_postype.data[i];
+                Scalar4 orientation_i = h_orientation.data[i];
+                vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
 
                 #ifdef ENABLE_MPI
                 if (this->m_comm)
                     {
-                    // check if particle has moved into the ghost layer, and skip if it is
-                    if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
+                    // only move particle if active
+                    if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
                         continue;
                     }
                 #endif
-                }
-            else
-                {
-                move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
-                }
 
-            // check for overlaps with neighboring particle's positions
-            bool overlap=false;
-            detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+                // make a trial move for i
+                Saru rng_i(i, this->m_seed + this->m_exec_conf->getRank()*this->m_nselect + i_nselect, timestep);
+                int typ_i = __scalar_as_int(postype_i.w);
+                Shape shape_i(quat<Scalar>(orientation_i), this->m_params[typ_i]);
+                unsigned int move_type_select = rng_i.u32() & 0xffff;
+                bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < this->m_move_ratio);
 
-            // All image boxes (including the primary)
-            const unsigned int n_images = this->m_image_list.size();
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                {
-                vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i_image);
+                if (move_type_translate)
+                    {
+                    move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
+
+                    #ifdef ENABLE_MPI
+                    if (this->m_comm)
+                        {
+                        // check if particle has moved into the ghost layer, and skip if it is
+                        if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
+                            continue;
+                        }
+                    #endif
+                    }
+                else
+                    {
+                    move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
+                    }
+
+                // check for overlaps with neighboring particle's positions
+                bool overlap=false;
+                detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+                // All image boxes (including the primary)
+                const unsigned int n_images = this->m_image_list.size();
+                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                     {
-                    if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+                    detail::AABB aabb = aabb_i_local;
+                    aabb.translate(pos_i_image);
+
+                    // stackless search
+                    for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                        if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
                             {
-                            for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                            if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
-                                // read in its position and orientation
-                                unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                                for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                    {
+                                    // read in its position and orientation
+                                    unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                                    Scalar4 postype_j;
+                                    Scalar4 orientation_j;
 
-                                // handle j==i situations
-                                if ( j != i )
-                                    {
-                                    // load the position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-                                    }
-                                else
-                                    {
-                                    if (cur_image == 0)
+                                    // handle j==i situations
+                                    if ( j != i )
                                         {
-                                        // in the first image, skip i == j
-                                        continue;
+                                        // load the position and orientation of the j particle
+                                        postype_j = h_postype.data[j];
+                                        orientation_j = h_orientation.data[j];
                                         }
                                     else
                                         {
-                                        // If this is particle i and we are in an outside image, use the translated position and orientation
-                                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                        orientation_j = quat_to_scalar4(shape_i.orientation);
+                                        if (cur_image == 0)
+                                            {
+                                            // in the first image, skip i == j
+                                            continue;
+                                            }
+                                        else
+                                            {
+                                            // If this is particle i and we are in an outside image, use the translated position and orientation
+                                            postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                                            orientation_j = quat_to_scalar4(shape_i.orientation);
+                                            }
                                         }
-                                    }
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                                    // put particles in coordinate system of particle i
+                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
+                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                    Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
 
-                                counters.overlap_checks++;
+                                    counters.overlap_checks++;
 
-                                // check circumsphere overlap
-                                OverlapReal rsq = dot(r_ij,r_ij);
-                                OverlapReal DaDb = shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
-                                bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
+                                    // check circumsphere overlap
+                                    OverlapReal rsq = dot(r_ij,r_ij);
+                                    OverlapReal DaDb = shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                                    bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
 
-                                if (h_overlaps.data[this->m_overlap_idx(typ_i,typ_j)]
-                                    && circumsphere_overlap
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
-                                    {
-                                    overlap = true;
-                                    break;
+                                    if (h_overlaps.data[this->m_overlap_idx(typ_i,typ_j)]
+                                        && circumsphere_overlap
+                                        && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                                        {
+                                        overlap = true;
+                                        break;
+                                        }
                                     }
                                 }
                             }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                        }
+                        else
+                            {
+                            // skip ahead
+                            cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                            }
+
+                        if (overlap)
+                            break;
+                        }  // end loop over AABB nodes
 
                     if (overlap)
                         break;
-                    }  // end loop over AABB nodes
-
-                if (overlap)
-                    break;
-
-                } // end loop over images
 
-            // whether the move is accepted
-            bool accept = !overlap;
+                    } // end loop over images
 
-            if (!overlap)
-                {
-                // log of acceptance probability
-                Scalar lnb(0.0);
-                unsigned int zero = 0;
+                // whether the move is accepted
+                bool accept = !overlap;
 
-                // The trial move is valid. Now generate random depletant particles in a sphere
-                // of radius (d_max+d_depletant+move size)/2.0 around the original particle position
-
-                // draw number from Poisson distribution
-                unsigned int n = 0;
-                if (m_lambda[typ_i] > Scalar(0.0))
+                if (!overlap)
                     {
-                    n = m_poisson[typ_i](rng_poisson);
-                    }
+                    // log of acceptance probability
+                    Scalar lnb(0.0);
+                    unsigned int zero = 0;
 
-                unsigned int n_overlap_checks = 0;
-                unsigned int overlap_err_count = 0;
-                unsigned int insert_count = 0;
-                unsigned int reinsert_count = 0;
-                unsigned int free_volume_count = 0;
-                unsigned int overlap_count = 0;
+                    // The trial move is valid. Now generate random depletant particles in a sphere
+                    // of radius (d_max+d_depletant+move size)/2.0 around the original particle position
 
-                volatile bool flag=false;
-
-                #pragma omp parallel for reduction(+ : lnb, n_overlap_checks, overlap_err_count, insert_count, reinsert_count, free_volume_count, overlap_count) reduction(max: zero) shared(flag) if (n>0) schedule(dynamic)
-                for (unsigned int k = 0; k < n; ++k)
-                    {
-                    if (flag)
+                    // draw number from Poisson distribution
+                    unsigned int n = 0;
+                    if (m_lambda[typ_i] > Scalar(0.0))
                         {
-                        #ifndef _OPENMP
-                        break;
-                        #else
-                        continue;
-                        #endif
+                        n = m_poisson[typ_i](rng_poisson);
                         }
-                    insert_count++;
-
-                    // generate a random depletant coordinate and orientation in the sphere around the new position
-                    vec3<Scalar> pos_test;
-                    quat<Scalar> orientation_test;
 
-                    #ifdef _OPENMP
-                    unsigned int thread_idx = omp_get_thread_num();
-                    #else
-                    unsigned int thread_idx = 0;
-                    #endif
+                    unsigned int n_overlap_checks = 0;
+                    unsigned int overlap_err_count = 0;
+                    unsigned int insert_count = 0;
+                    unsigned int reinsert_count = 0;
+                    unsigned int free_volume_count = 0;
+                    unsigned int overlap_count = 0;
 
-                    generateDepletant(m_rng_depletant[thread_idx], pos_i, h_d_max.data[typ_i], h_d_min.data[typ_i], pos_test,
-                        orientation_test, this->m_params[m_type]);
-                    Shape shape_test(orientation_test, this->m_params[m_type]);
+                    // depletants closer than the sum of the insphere radii to both the old and the new position
+                    // overlap particle i in both configurations and never count, so they need no overlap checks
+                    vec3<Scalar> pos_old(h_postype.data[i]);
+                    Shape shape_dep(quat<Scalar>(), this->m_params[m_type]);
+                    OverlapReal r_in = shape_i.getInsphereRadius() + shape_dep.getInsphereRadius();
+                    OverlapReal r_in_sq = h_overlaps.data[this->m_overlap_idx(m_type, typ_i)] ? r_in*r_in : OverlapReal(0.0);
 
-                    detail::AABB aabb_test_local = shape_test.getAABB(vec3<Scalar>(0,0,0));
+                    volatile bool flag=false;
 
-                    bool overlap_depletant = false;
-
-                    // Check if the new configuration of particle i generates an overlap
-                    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                    #pragma omp parallel for reduction(+ : lnb, n_overlap_checks, overlap_err_count, insert_count, reinsert_count, free_volume_count, overlap_count) reduction(max: zero) shared(flag) if (n>0) schedule(dynamic)
+                    for (unsigned int k = 0; k < n; ++k)
                         {
-                        vec3<Scalar> pos_test_image = pos_test + this->m_image_list[cur_image];
-                        detail::AABB aabb = aabb_test_local;
-                        aabb.translate(pos_test_image);
+                        if (flag)
+                            {
+                            #ifndef _OPENMP
+                            break;
+                            #else
+                            continue;
+                            #endif
+                            }
+                        insert_count++;
 
-                        vec3<Scalar> r_ij = pos_i - pos_test_image;
+                        // generate a random depletant coordinate and orientation in the sphere around the new position
+                        vec3<Scalar> pos_test;
+                        quat<Scalar> orientation_test;
 
-                        n_overlap_checks++;
+                        #ifdef _OPENMP
+                        unsigned int thread_idx = omp_get_thread_num();
+                        #else
+                        unsigned int thread_idx = 0;
+                        #endif
 
-                        // check circumsphere overlap
-                        OverlapReal rsq = dot(r_ij,r_ij);
-                        OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_i.getCircumsphereDiameter();
-                        bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
+                        generateDepletant(m_rng_depletant[thread_idx], pos_i, h_d_max.data[typ_i], h_d_min.data[typ_i], pos_test,
+                            orientation_test, this->m_params[m_type]);
 
-                        if (h_overlaps.data[this->m_overlap_idx(m_type, typ_i)]
-                            && circumsphere_overlap
-                            && test_overlap(r_ij, shape_test, shape_i, overlap_err_count))
+                        vec3<Scalar> r_new = pos_test - pos_i;
+                        vec3<Scalar> r_old = pos_test - pos_old;
+                        if (dot(r_new,r_new) < r_in_sq && dot(r_old,r_old) < r_in_sq)
                             {
-                            overlap_depletant = true;
                             overlap_count++;
-                            break;
+                            continue;
                             }
-                        }
 
-                    if (overlap_depletant)
-                        {
-                        // check against overlap with old position
-                        bool overlap_old = false;
+                        Shape shape_test(orientation_test, this->m_params[m_type]);
+
+                        detail::AABB aabb_test_local = shape_test.getAABB(vec3<Scalar>(0,0,0));
 
-                        // Check if the old configuration of particle i generates an overlap
+                        bool overlap_depletant = false;
+
+                        // Check if the new configuration of particle i generates an overlap
                         for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                             {
                             vec3<Scalar> pos_test_image = pos_test + this->m_image_list[cur_image];
-                            vec3<Scalar> r_ij = vec3<Scalar>(h_postype.data[i]) - pos_test_image;
+                            detail::AABB aabb = aabb_test_local;
+                            aabb.translate(pos_test_image);
+
+                            vec3<Scalar> r_ij = pos_i - pos_test_image;
 
                             n_overlap_checks++;
 
                             // check circumsphere overlap
-                            Shape shape_i_old(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
                             OverlapReal rsq = dot(r_ij,r_ij);
-                            OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_i_old.getCircumsphereDiameter();
+                            OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_i.getCircumsphereDiameter();
                             bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
 
                             if (h_overlaps.data[this->m_overlap_idx(m_type, typ_i)]
                                 && circumsphere_overlap
-                                && test_overlap(r_ij, shape_test, shape_i_old, overlap_err_count))
+                                && test_overlap(r_ij, shape_test, shape_i, overlap_err_count))
                                 {
-                                overlap_old = true;
+                                overlap_depletant = true;
+                                overlap_count++;
                                 break;
                                 }
                             }
 
-                        if (!overlap_old)
+                        if (overlap_depletant)
                             {
-                            // All image boxes (including the primary)
-                            const unsigned int n_images = this->m_image_list.size();
+                            // check against overlap with old position
+                            bool overlap_old = false;
+
+                            // Check if the old configuration of particle i generates an overlap
                             for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                                 {
                                 vec3<Scalar> pos_test_image = pos_test + this->m_image_list[cur_image];
-                                detail::AABB aabb = aabb_test_local;
-                                aabb.translate(pos_test_image);
+                                vec3<Scalar> r_ij = vec3<Scalar>(h_postype.data[i]) - pos_test_image;
+
+                                n_overlap_checks++;
 
-                                // stackless search
-                                for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+                                // check circumsphere overlap
+                                Shape shape_i_old(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
+                                OverlapReal rsq = dot(r_ij,r_ij);
+                                OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_i_old.getCircumsphereDiameter();
+                                bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
+
+                                if (h_overlaps.data[this->m_overlap_idx(m_type, typ_i)]
+                                    && circumsphere_overlap
+                                    && test_overlap(r_ij, shape_test, shape_i_old, overlap_err_count))
                                     {
-                                    if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                                    overlap_old = true;
+                                    break;
+                                    }
+                                }
+
+                            if (!overlap_old)
+                                {
+                                // All image boxes (including the primary)
+                                const unsigned int n_images = this->m_image_list.size();
+                                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                                    {
+                                    vec3<Scalar> pos_test_image = pos_test + this->m_image_list[cur_image];
+                                    detail::AABB aabb = aabb_test_local;
+                                    aabb.translate(pos_test_image);
+
+                                    // stackless search
+                                    for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                                         {
-                                        if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                                        if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
                                             {
-                                            for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                            if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                                                 {
-                                                // read in its position and orientation
-                                                unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                                                for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                                    {
+                                                    // read in its position and orientation
+                                                    unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                                // we checked ptl i first
-                                                if (i == j) continue;
+                                                    // we checked ptl i first
+                                                    if (i == j) continue;
 
-                                                Scalar4 postype_j;
-                                                Scalar4 orientation_j;
+                                                    Scalar4 postype_j;
+                                                    Scalar4 orientation_j;
 
-                                                // load the old position and orientation of the j particle
-                                                postype_j = h_postype.data[j];
-                                                orientation_j = h_orientation.data[j];
+                                                    // load the old position and orientation of the j particle
+                                                    postype_j = h_postype.data[j];
+                                                    orientation_j = h_orientation.data[j];
 
-                                                // put particles in coordinate system of particle i
-                                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+                                                    // put particles in coordinate system of particle i
+                                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
 
-                                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                                Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
+                                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                                    Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
 
-                                                n_overlap_checks++;
+                                                    n_overlap_checks++;
 
-                                                // check circumsphere overlap
-                                                OverlapReal rsq = dot(r_ij,r_ij);
-                                                OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
-                                                bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
+                                                    // check circumsphere overlap
+                                                    OverlapReal rsq = dot(r_ij,r_ij);
+                                                    OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                                                    bool circumsphere_overlap = (rsq*OverlapReal(4.0) <= DaDb * DaDb);
 
-                                                if (h_overlaps.data[this->m_overlap_idx(m_type,typ_j)]
-                                                    && circumsphere_overlap
-                                                    && test_overlap(r_ij, shape_test, shape_j, overlap_err_count))
-                                                    {
-                                                    // depletant is ignored for any overlap in the old configuration
-                                                    overlap_old = true;
-                                                    break;
+                                                    if (h_overlaps.data[this->m_overlap_idx(m_type,typ_j)]
+                                                        && circumsphere_overlap
+                                                        && test_overlap(r_ij, shape_test, shape_j, overlap_err_count))
+                                                        {
+                                                        // depletant is ignored for any overlap in the old configuration
+                                                        overlap_old = true;
+                                                        break;
+                                                        }
                                                     }
                                                 }
                                             }
-                                        }
-                                    else
-                                        {
-                                        // skip ahead
-                                        cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                                        }
+                                        else
+                                            {
+                                            // skip ahead
+                                            cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                                            }
+
+                                        if (overlap_old)
+                                            break;
+                                        }  // end loop over AABB nodes
 
                                     if (overlap_old)
                                         break;
-                                    }  // end loop over AABB nodes
+                                    } // end loop over images
+                                }
 
-                                if (overlap_old)
-                                    break;
-                                } // end loop over images
+                            if (!overlap_old)
+                                {
+                                free_volume_count++;
+                                }
+                            else
+                                {
+                                // the depletant overlap doesn't count since it was already overlapping
+                                // in the old configuration
+                                overlap_depletant = false;
+                                }
                             }
 
-                        if (!overlap_old)
+                        if (overlap_depletant && !m_n_trial)
                             {
-                            free_volume_count++;
+                            zero = 1;
+                            // break out of loop
+                            flag = true;
                             }
-                        else
+                        else if (overlap_depletant && m_n_trial)
                             {
-                            // the depletant overlap doesn't count since it was already overlapping
-                            // in the old configuration
-                            overlap_depletant = false;
-                            }
-                        }
+                            const typename Shape::param_type& params_depletant = this->m_params[m_type];
 
-                    if (overlap_depletant && !m_n_trial)
-                        {
-                        zero = 1;
-                        // break out of loop
-                        flag = true;
-                        }
-                    else if (overlap_depletant && m_n_trial)
-                        {
-                        const typename Shape::param_type& params_depletant = this->m_params[m_type];
+                            // Number of successful depletant insertions in new configuration
+                            unsigned int n_success_new = 0;
 
-                        // Number of successful depletant insertions in new configuration
-                        unsigned int n_success_new = 0;
+                            // Number of allowed insertion trials (those which overlap with colloid at old position)
+                            unsigned int n_overlap_shape_new = 0;
 
-                        // Number of allowed insertion trials (those which overlap with colloid at old position)
-                        unsigned int n_overlap_shape_new = 0;
+                            // diameter (around origin) in which we are guaruanteed to intersect with the shape
+                            Scalar delta_insphere = Scalar(2.0)*shape_i.getInsphereRadius();
 
-                        // diameter (around origin) in which we are guaruanteed to intersect with the shape
-                        Scalar delta_insphere = Scalar(2.0)*shape_i.getInsphereRadius();
+                            // same for old reverse move. Because we have already sampled one successful insertion
+                            // that overlaps with the colloid at the new position, we increment by one (super-detailed
+                            // balance)
+                            unsigned int n_success_old = 1;
+                            unsigned int n_overlap_shape_old = 1;
 
-                        // same for old reverse move. Because we have already sampled one successful insertion
-                        // that overlaps with the colloid at the new position, we increment by one (super-detailed
-                        // balance)
-                        unsigned int n_success_old = 1;
-                        unsigned int n_overlap_shape_old = 1;
+                            Scalar4& postype_i_old = h_postype.data[i];
+                            vec3<Scalar> pos_i_old(postype_i_old);
+                            quat<Scalar> orientation_i_old(h_orientation.data[i]);
 
-                        Scalar4& postype_i_old = h_postype.data[i];
-                        vec3<Scalar> pos_i_old(postype_i_old);
-                        quat<Scalar> orientation_i_old(h_orientation.data[i]);
-
-                        for (unsigned int l = 0; l < m_n_trial; ++l)
-                            {
-                            // generate a random depletant position and orientation
-                            // in both the old and the new configuration of the colloid particle
-                            vec3<Scalar> pos_depletant_old, pos_depletant_new;
-                            quat<Scalar> orientation_depletant_old, orientation_depletant_new;
+                            for (unsigned int l = 0; l < m_n_trial; ++l)
+                                {
+                                // generate a random depletant position and orientation
+                                // in both the old and the new configuration of the colloid particle
+                                vec3<Scalar> pos_depletant_old, pos_depletant_new;
+                                quat<Scalar> orientation_depletant_old, orientation_depletant_new;
 
-                            // try moving the overlapping depletant in the excluded volume
-                            // such that it overlaps with the particle at the old position
-                            generateDepletantRestricted(m_rng_depletant[thread_idx], pos_i_old, h_d_max.data[typ_i], delta_insphere,
-                                pos_depletant_new, orientation_depletant_new, params_depletant, pos_i);
+                                // try moving the overlapping depletant in the excluded volume
+                                // such that it overlaps with the particle at the old position
+                                generateDepletantRestricted(m_rng_depletant[thread_idx], pos_i_old, h_d_max.data[typ_i], delta_insphere,
+                                    pos_depletant_new, orientation_depletant_new, params_depletant, pos_i);
 
-                            reinsert_count++;
+                                reinsert_count++;
 
-                            Shape shape_depletant_new(orientation_depletant_new, params_depletant);
-                            const typename Shape::param_type& params_i = this->m_params[__scalar_as_int(postype_i_old.w)];
+                                Shape shape_depletant_new(orientation_depletant_new, params_depletant);
+                                const typename Shape::param_type& params_i = this->m_params[__scalar_as_int(postype_i_old.w)];
 
-                            bool overlap_shape = false;
-                            if (insertDepletant(pos_depletant_new, shape_depletant_new, i, this->m_params.data(), h_overlaps.data, typ_i,
-                                h_postype.data, h_orientation.data, pos_i, shape_i.orientation, params_i,
-                                n_overlap_checks, overlap_err_count, overlap_shape, false))
-                                {
-                                n_success_new++;
-                                }
-
-                            if (overlap_shape)
-                                {
-                                // depletant overlaps with colloid at old position
-                                n_overlap_shape_new++;
-                                }
-
-                            if (l >= 1)
-                                {
-                                // as above, in excluded volume sphere at new position
-                                generateDepletantRestricted(m_rng_depletant[thread_idx], pos_i, h_d_max.data[typ_i], delta_insphere,
-                                    pos_depletant_old, orientation_depletant_old, params_depletant, pos_i_old);
-                                Shape shape_depletant_old(orientation_depletant_old, params_depletant);
-                                if (insertDepletant(pos_depletant_old, shape_depletant_old, i, this->m_params.data(), h_overlaps.data, typ_i,
+                                bool overlap_shape = false;
+                                if (insertDepletant(pos_depletant_new, shape_depletant_new, i, this->m_params.data(), h_overlaps.data, typ_i,
                                     h_postype.data, h_orientation.data, pos_i, shape_i.orientation, params_i,
-                                    n_overlap_checks, overlap_err_count, overlap_shape, true))
+                                    n_overlap_checks, overlap_err_count, overlap_shape, false))
                                     {
-                                    n_success_old++;
+                                    n_success_new++;
                                     }
 
                                 if (overlap_shape)
                                     {
-                                    // depletant overlaps with colloid at new position
-                                    n_overlap_shape_old++;
+                                    // depletant overlaps with colloid at old position
+                                    n_overlap_shape_new++;
                                     }
-                                reinsert_count++;
-                                }
 
-                            n_overlap_checks += counters.overlap_checks;
-                            overlap_err_count += counters.overlap_err_count;
-                            } // end loop over re-insertion attempts
+                                if (l >= 1)
+                                    {
+                                    // as above, in excluded volume sphere at new position
+                                    generateDepletantRestricted(m_rng_depletant[thread_idx], pos_i, h_d_max.data[typ_i], delta_insphere,
+                                        pos_depletant_old, orientation_depletant_old, params_depletant, pos_i_old);
+                                    Shape shape_depletant_old(orientation_depletant_old, params_depletant);
+                                    if (insertDepletant(pos_depletant_old, shape_depletant_old, i, this->m_params.data(), h_overlaps.data, typ_i,
+                                        h_postype.data, h_orientation.data, pos_i, shape_i.orientation, params_i,
+                                        n_overlap_checks, overlap_err_count, overlap_shape, true))
+                                        {
+                                        n_success_old++;
+                                        }
 
-                        if (n_success_new != 0)
-                            {
-                            lnb += log((Scalar)n_success_new/(Scalar)n_overlap_shape_new);
-                            lnb -= log((Scalar)n_success_old/(Scalar)n_overlap_shape_old);
-                            }
-                        else
-                            {
-                            zero = 1;
-                            // break out of loop
-                            flag = true;
-                            }
-                        } // end if depletant overlap
+                                    if (overlap_shape)
+                                        {
+                                        // depletant overlaps with colloid at new position
+                                        n_overlap_shape_old++;
+                                        }
+                                    reinsert_count++;
+                                    }
 
-                    } // end loop over depletants
+                                n_overlap_checks += counters.overlap_checks;
+                                overlap_err_count += counters.overlap_err_count;
+                                } // end loop over re-insertion attempts
 
-                // increment counters
-                counters.overlap_checks += n_overlap_checks;
-                counters.overlap_err_count += overlap_err_count;
-                implicit_counters.insert_count += insert_count;
-                implicit_counters.free_volume_count += free_volume_count;
-                implicit_counters.overlap_count += overlap_count;
-                implicit_counters.reinsert_count += reinsert_count;
+                            if (n_success_new != 0)
+                                {
+                                lnb += log((Scalar)n_success_new/(Scalar)n_overlap_shape_new);
+                                lnb -= log((Scalar)n_success_old/(Scalar)n_overlap_shape_old);
+                                }
+                            else
+                                {
+                                zero = 1;
+                                // break out of loop
+                                flag = true;
+                                }
+                            } // end if depletant overlap
 
-                // apply acceptance criterium
-                if (!zero)
-                    {
-                    accept = rng_i.f() < exp(lnb);
-                    }
-                else
-                    {
-                    accept = false;
-                    }
-                } // end depletant placement
+                        } // end loop over depletants
 
-            // if the move is accepted
-            if (accept)
-                {
-                // increment accept counter and assign new position
-                if (!shape_i.ignoreStatistics())
-                  {
-                  if (move_type_translate)
-                      counters.translate_accept_count++;
-                  else
-                      counters.rotate_accept_count++;
-                  }
-                // update the position of the particle in the tree for future updates
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i);
-                this->m_aabb_tree.update(i, aabb);
-
-                // update position of particle
-                h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
-
-                if (shape_i.hasOrientation())
+                    // increment counters
+                    counters.overlap_checks += n_overlap_checks;
+                    counters.overlap_err_count += overlap_err_count;
+                    implicit_counters.insert_count += insert_count;
+                    implicit_counters.free_volume_count += free_volume_count;
+                    implicit_counters.overlap_count += overlap_count;
+                    implicit_counters.reinsert_count += reinsert_count;
+
+                    // apply acceptance criterium
+                    if (!zero)
+                        {
+                        accept = rng_i.f() < exp(lnb);
+                        }
+                    else
+                        {
+                        accept = false;
+                        }
+                    } // end depletant placement
+
+                // if the move is accepted
+                if (accept)
                     {
-                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                    // increment accept counter and assign new position
+                    if (!shape_i.ignoreStatistics())
+                      {
+                      if (move_type_translate)
+                          counters.translate_accept_count++;
+                      else
+                          counters.rotate_accept_count++;
+                      }
+                    // update the position of the particle in the tree for future updates
+                    detail::AABB aabb = aabb_i_local;
+                    aabb.translate(pos_i);
+                    this->m_aabb_tree.update(i, aabb);
+
+                    // update position of particle
+                    h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
+
+                    if (shape_i.hasOrientation())
+                        {
+                        h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                        }
                     }
-                }
-             else
-                {
-                if (!shape_i.ignoreStatistics())
+                 else
                     {
-                    // increment reject counter
-                    if (move_type_translate)
-                        counters.translate_reject_count++;
-                    else
-                        counters.rotate_reject_count++;
+                    if (!shape_i.ignoreStatistics())
+                        {
+                        // increment reject counter
+                        if (move_type_translate)
+                            counters.translate_reject_count++;
+                        else
+                            counters.rotate_reject_count++;
+                        }
                     }
-                }
-            } // end loop over all particles
-        } // end loop over nselect
+                } // end loop over all particles
+            } // end loop over nselect
+        }
 
         {
         ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
@@ -947,7 +1024,317 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
     this->communicate(true);
 
     // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    this->invalidateAABBTree();
+    }
+
+/*! The trial moves are made in parallel when there is more than one OpenMP thread and the box is at least 4 cells of
+    the interaction range wide in every direction. Configurational bias moves and domain decomposition always use the
+    serial code path.
+
+    \param timestep Current timestep, seeds the random offset of the grid
+    \returns true if the cell grid was built and the trial moves should be made on the checkerboard
+*/
+template<class Shape>
+bool IntegratorHPMCMonoImplicit<Shape>::buildCheckerboard(unsigned int timestep)
+    {
+    unsigned int n_omp_threads = 1;
+
+    #ifdef _OPENMP
+    n_omp_threads = omp_get_max_threads();
+    #endif
+
+    if (n_omp_threads < 2 || m_n_trial > 0)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (this->m_comm)
+        return false;
+    #endif
+
+    // a particle interacts with the particles and the depletants around it within this range
+    Scalar width = this->getMaxDiameter() + m_d_dep;
+
+    if (!this->m_cell_grid.setup(this->m_pdata->getBox(), width, this->m_sysdef->getNDimensions(), true))
+        return false;
+
+    // offset the grid randomly by up to one cell, so that the cell boundaries move between timesteps
+    uint3 dim = this->m_cell_grid.getDim();
+    Saru rng(timestep, this->m_seed, 0x2b8e4f61);
+    Scalar3 offset = make_scalar3(0,0,0);
+    offset.x = rng.s(Scalar(0.0), Scalar(1.0)/Scalar(dim.x));
+    offset.y = rng.s(Scalar(0.0), Scalar(1.0)/Scalar(dim.y));
+    offset.z = rng.s(Scalar(0.0), Scalar(1.0)/Scalar(dim.z));
+    this->m_cell_grid.setOffset(offset);
+
+    this->m_exec_conf->msg->notice(8) << "Building checkerboard: " << this->m_pdata->getN() << " ptls" << std::endl;
+    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
+    this->m_cell_grid.build(h_postype.data, this->m_pdata->getN());
+
+    return true;
+    }
+
+/*! The cells of the grid are colored by the parity of their coordinates. Cells of the same color are separated by at
+    least one cell, which is as wide as the interaction range including the depletants, so the particles in different
+    cells of one color can be moved at the same time as long as they stay in their cell. Trial moves that leave the
+    cell are rejected, which keeps detailed balance, and the random offset of the grid between timesteps keeps the
+    moves ergodic.
+
+    Each sweep visits the colors in a random order and makes as many trial moves in every cell as it has particles,
+    picking the particles at random. The cells of one color are distributed over the OpenMP threads. Each cell has its
+    own random number stream, so the result does not depend on the number of threads.
+
+    Overlaps are found with the cell grid instead of the AABB tree, which cannot be updated concurrently.
+
+    \param timestep Current timestep
+    \param counters Counters of the trial moves to increment
+    \param implicit_counters Counters of the depletant insertions to increment
+*/
+template<class Shape>
+void IntegratorHPMCMonoImplicit<Shape>::updateCheckerboard(unsigned int timestep, hpmc_counters_t& counters,
+    hpmc_implicit_counters_t& implicit_counters)
+    {
+    const BoxDim& box = this->m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+    const detail::CellGrid& grid = this->m_cell_grid;
+
+    // number of cells of each color in every direction
+    uint3 dim = grid.getDim();
+    uint3 color_dim = make_uint3(dim.x/2, dim.y/2, ndim == 2 ? 1 : dim.z/2);
+    unsigned int n_color_cells = color_dim.x*color_dim.y*color_dim.z;
+    unsigned int n_colors = (ndim == 2) ? 4 : 8;
+
+    // access particle data
+    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+
+    // access interaction matrix
+    ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+
+    // access move sizes and depletant insertion sphere dimensions
+    ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_d_min(m_d_min, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_d_max(m_d_max, access_location::host, access_mode::read);
+
+    Shape shape_dep(quat<Scalar>(), this->m_params[m_type]);
+    OverlapReal r_in_dep = shape_dep.getInsphereRadius();
+
+    for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+        {
+        // visit the colors in a random order
+        Saru rng_colors(timestep, this->m_seed + i_nselect, 0x6a09e667);
+        unsigned int colors[8];
+        for (unsigned int c = 0; c < n_colors; c++)
+            colors[c] = c;
+        for (unsigned int c = n_colors - 1; c > 0; c--)
+            std::swap(colors[c], colors[rand_select(rng_colors, c)]);
+
+        for (unsigned int cur_color = 0; cur_color < n_colors; cur_color++)
+            {
+            unsigned int color = colors[cur_color];
+
+            unsigned long long int translate_accept_count = 0;
+            unsigned long long int translate_reject_count = 0;
+            unsigned long long int rotate_accept_count = 0;
+            unsigned long long int rotate_reject_count = 0;
+            unsigned long long int overlap_checks = 0;
+            unsigned int overlap_err_count = 0;
+            unsigned long long int insert_count = 0;
+            unsigned long long int free_volume_count = 0;
+            unsigned long long int overlap_count = 0;
+
+            #pragma omp parallel for reduction(+ : translate_accept_count, translate_reject_count, rotate_accept_count, rotate_reject_count, overlap_checks, overlap_err_count, insert_count, free_volume_count, overlap_count) schedule(dynamic)
+            for (unsigned int cur_cell = 0; cur_cell < n_color_cells; cur_cell++)
+                {
+                unsigned int cell = grid.getCellIndex(2*(cur_cell % color_dim.x) + (color & 1),
+                                                      2*((cur_cell / color_dim.x) % color_dim.y) + ((color >> 1) & 1),
+                                                      2*(cur_cell / (color_dim.x*color_dim.y)) + ((color >> 2) & 1));
+                const unsigned int *cell_particles = grid.getCellParticles(cell);
+                unsigned int n_cell = grid.getCellSize(cell);
+                const unsigned int *nbr_cells = grid.getNeighborCells(cell);
+
+                Saru rng_cell(cell, this->m_seed + this->m_exec_conf->getRank()*this->m_nselect + i_nselect, timestep);
+
+                for (unsigned int cur_move = 0; cur_move < n_cell; cur_move++)
+                    {
+                    unsigned int i = cell_particles[rand_select(rng_cell, n_cell - 1)];
+
+                    // read in the current position and orientation
+                    Scalar4 postype_i = h_postype.data[i];
+                    Scalar4 orientation_i = h_orientation.data[i];
+                    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+                    vec3<Scalar> pos_old = pos_i;
+
+                    // make a trial move for i
+                    int typ_i = __scalar_as_int(postype_i.w);
+                    Shape shape_i(quat<Scalar>(orientation_i), this->m_params[typ_i]);
+                    Shape shape_old(quat<Scalar>(orientation_i), this->m_params[typ_i]);
+                    unsigned int move_type_select = rng_cell.u32() & 0xffff;
+                    bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < this->m_move_ratio);
+
+                    bool accept = true;
+                    if (move_type_translate)
+                        {
+                        move_translate(pos_i, rng_cell, h_d.data[typ_i], ndim);
+
+                        // the particle must stay in its cell to be independent of the other cells of this color
+                        accept = grid.getCell(pos_i) == cell;
+                        }
+                    else
+                        {
+                        move_rotate(shape_i.orientation, rng_cell, h_a.data[typ_i], ndim);
+                        }
+
+                    // check for overlaps with the particles in the neighboring cells
+                    for (unsigned int cur_nbr = 0; cur_nbr < grid.getNumNeighborCells() && accept; cur_nbr++)
+                        {
+                        unsigned int nbr_cell = nbr_cells[cur_nbr];
+                        const unsigned int *nbr_particles = grid.getCellParticles(nbr_cell);
+                        for (unsigned int cur_p = 0; cur_p < grid.getCellSize(nbr_cell); cur_p++)
+                            {
+                            unsigned int j = nbr_particles[cur_p];
+                            if (j == i)
+                                continue;
+
+                            Scalar4 postype_j = h_postype.data[j];
+                            vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(postype_j) - pos_i)));
+
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            Shape shape_j(quat<Scalar>(h_orientation.data[j]), this->m_params[typ_j]);
+
+                            overlap_checks++;
+                            if (h_overlaps.data[this->m_overlap_idx(typ_i, typ_j)]
+                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                                && test_overlap(r_ij, shape_i, shape_j, overlap_err_count))
+                                {
+                                accept = false;
+                                break;
+                                }
+                            }
+                        }
+
+                    // the trial move is valid, now generate random depletants in the sphere around the new position
+                    if (accept && m_lambda[typ_i] > Scalar(0.0))
+                        {
+                        // draw the number of depletants from the stream of this cell
+                        std::poisson_distribution<unsigned int> poisson(m_poisson[typ_i].param());
+                        detail::SaruEngine engine(rng_cell);
+                        unsigned int n = poisson(engine);
+
+                        bool overlap_dep_i = h_overlaps.data[this->m_overlap_idx(m_type, typ_i)];
+
+                        // depletants closer than the sum of the insphere radii to both positions never count
+                        OverlapReal r_in = shape_i.getInsphereRadius() + r_in_dep;
+                        OverlapReal r_in_sq = overlap_dep_i ? r_in*r_in : OverlapReal(0.0);
+
+                        for (unsigned int k = 0; k < n && accept; k++)
+                            {
+                            insert_count++;
+
+                            vec3<Scalar> pos_test;
+                            quat<Scalar> orientation_test;
+                            generateDepletant(rng_cell, pos_i, h_d_max.data[typ_i], h_d_min.data[typ_i], pos_test,
+                                orientation_test, this->m_params[m_type]);
+
+                            vec3<Scalar> r_new = pos_i - pos_test;
+                            vec3<Scalar> r_old = pos_old - pos_test;
+                            if (dot(r_new,r_new) < r_in_sq && dot(r_old,r_old) < r_in_sq)
+                                {
+                                overlap_count++;
+                                continue;
+                                }
+
+                            Shape shape_test(orientation_test, this->m_params[m_type]);
+
+                            // the depletant must overlap with the new configuration of particle i
+                            overlap_checks++;
+                            if (!overlap_dep_i
+                                || !check_circumsphere_overlap(r_new, shape_test, shape_i)
+                                || !test_overlap(r_new, shape_test, shape_i, overlap_err_count))
+                                continue;
+
+                            overlap_count++;
+
+                            // and with neither the old configuration of particle i nor any other particle
+                            overlap_checks++;
+                            bool overlap_old = check_circumsphere_overlap(r_old, shape_test, shape_old)
+                                && test_overlap(r_old, shape_test, shape_old, overlap_err_count);
+
+                            for (unsigned int cur_nbr = 0; cur_nbr < grid.getNumNeighborCells() && !overlap_old; cur_nbr++)
+                                {
+                                unsigned int nbr_cell = nbr_cells[cur_nbr];
+                                const unsigned int *nbr_particles = grid.getCellParticles(nbr_cell);
+                                for (unsigned int cur_p = 0; cur_p < grid.getCellSize(nbr_cell); cur_p++)
+                                    {
+                                    unsigned int j = nbr_particles[cur_p];
+                                    if (j == i)
+                                        continue;
+
+                                    Scalar4 postype_j = h_postype.data[j];
+                                    vec3<Scalar> r_j(box.minImage(vec_to_scalar3(vec3<Scalar>(postype_j) - pos_test)));
+
+                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                    Shape shape_j(quat<Scalar>(h_orientation.data[j]), this->m_params[typ_j]);
+
+                                    overlap_checks++;
+                                    if (h_overlaps.data[this->m_overlap_idx(m_type, typ_j)]
+                                        && check_circumsphere_overlap(r_j, shape_test, shape_j)
+                                        && test_overlap(r_j, shape_test, shape_j, overlap_err_count))
+                                        {
+                                        overlap_old = true;
+                                        break;
+                                        }
+                                    }
+                                }
+
+                            // a depletant in the free volume of the old configuration rejects the move
+                            if (!overlap_old)
+                                {
+                                free_volume_count++;
+                                accept = false;
+                                }
+                            }
+                        }
+
+                    if (accept)
+                        {
+                        if (!shape_i.ignoreStatistics())
+                            {
+                            if (move_type_translate)
+                                translate_accept_count++;
+                            else
+                                rotate_accept_count++;
+                            }
+
+                        // the particle stays in its cell, so the grid remains valid
+                        h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
+
+                        if (shape_i.hasOrientation())
+                            {
+                            h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                            }
+                        }
+                    else if (!shape_i.ignoreStatistics())
+                        {
+                        if (move_type_translate)
+                            translate_reject_count++;
+                        else
+                            rotate_reject_count++;
+                        }
+                    } // end loop over trial moves in the cell
+                } // end loop over cells of this color
+
+            counters.translate_accept_count += translate_accept_count;
+            counters.translate_reject_count += translate_reject_count;
+            counters.rotate_accept_count += rotate_accept_count;
+            counters.rotate_reject_count += rotate_reject_count;
+            counters.overlap_checks += overlap_checks;
+            counters.overlap_err_count += overlap_err_count;
+            implicit_counters.insert_count += insert_count;
+            implicit_counters.free_volume_count += free_volume_count;
+            implicit_counters.overlap_count += overlap_count;
+            } // end loop over colors
+        } // end loop over nselect
     }
 
 /* \param rng The random number generator
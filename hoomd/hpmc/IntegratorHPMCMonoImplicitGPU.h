@@ -828,7 +828,7 @@ void IntegratorHPMCMonoImplicitGPU< Shape >::update(unsigned int timestep)
     this->communicate(true);
 
     // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    this->invalidateAABBTree();
     }
 
 template<class Shape>
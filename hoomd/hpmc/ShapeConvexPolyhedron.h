@@ -23,6 +23,10 @@
 #define DEVICE
 #include <iostream>
 #include <immintrin.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include "ConvexHull3D.h"
 #endif
 
 namespace hpmc
@@ -31,8 +35,17 @@ namespace hpmc
 namespace detail
 {
 
-//! maximum number of vertices that can be stored (must be multiple of 8)
-/*! \ingroup hpmc_data_structs */
+//! Minimum number of vertices for which the CPU support function walks along the edges of the convex hull
+/*! Below this number, the vectorized search over all vertices is faster in the overlap checks.
+    \ingroup hpmc_data_structs
+*/
+const unsigned int HULL_MIN_VERTS = 1024;
+
+//! Number of vertices in a block of the hull adjacency, matches the width of an AVX register
+const unsigned int HULL_BLOCK_SIZE = 8;
+
+// The adjacency of the hull vertices is host only, see make_hull_adjacency()
+struct hull_adjacency;
 
 //! Data structure for polyhedron vertices
 //! Note that vectorized methods using this struct will assume unused coordinates are set to zero.
@@ -45,13 +58,14 @@ struct poly3d_verts : param_base
         : N(0),
           diameter(OverlapReal(0)),
           sweep_radius(OverlapReal(0)),
-          ignore(0)
+          ignore(0),
+          hull(NULL)
         { }
 
     #ifndef NVCC
     //! Shape constructor
     poly3d_verts(unsigned int _N, bool _managed)
-        : N(_N)
+        : N(_N), hull(NULL)
         {
         unsigned int align_size = 8; //for AVX
         unsigned int N_align =((N + align_size - 1)/align_size)*align_size;
@@ -95,8 +109,133 @@ struct poly3d_verts : param_base
     OverlapReal sweep_radius;               //!< Radius of the sphere sweep (used for spheropolyhedra)
     unsigned int ignore;                    //!< Bitwise ignore flag for stats, overlaps. 1 will ignore, 0 will not ignore
                                             //   First bit is ignore overlaps, Second bit is ignore statistics
+
+    const hull_adjacency *hull;             //!< Hull adjacency for the CPU support function (host memory, NULL if not set)
     } __attribute__((aligned(32)));
 
+#ifndef NVCC
+//! Adjacency of the vertices on the convex hull of a polyhedron
+/*! The neighbors of each vertex are stored in blocks of HULL_BLOCK_SIZE, with their coordinates in SoA layout so that a
+    whole block is evaluated at once. Unused entries repeat the vertex itself. The blocks after those of the last
+    vertex hold the seeds of the walk: the hull vertices most extreme along the directions to the faces, edges and
+    corners of a cube.
+
+    The adjacency is only used by the CPU support function, so it lives in host memory outside of poly3d_verts, which
+    is copied to the GPU.
+    \ingroup hpmc_data_structs
+*/
+struct hull_adjacency
+    {
+    std::vector<unsigned int> block_offset;     //!< First block of each vertex, then of the seeds (N+2 entries)
+    std::vector<unsigned int> block_idx;        //!< Vertex indices in the blocks
+    std::vector<OverlapReal> block_pos;         //!< Vertex coordinates in the blocks, x, y and z of each block in turn
+    std::vector<OverlapReal> verts;             //!< Vertices the adjacency was built for, x, y and z of each in turn
+    };
+
+//! Build the hull adjacency of a polyhedron
+/*! \param verts Vertices of the polyhedron
+    \param min_verts Minimum number of vertices to build the adjacency for
+    \returns The adjacency, or NULL for shapes with fewer than \a min_verts vertices or whose vertices do not span a
+              volume, which keep the search over all vertices
+
+    poly3d_verts is copied by value into the integrators and to the GPU and only points to its adjacency, so the
+    adjacencies are owned by a table that lives as long as the process. Shapes with the same vertices share one entry.
+*/
+inline const hull_adjacency *make_hull_adjacency(const poly3d_verts& verts, unsigned int min_verts = HULL_MIN_VERTS)
+    {
+    const unsigned int N = verts.N;
+    if (N < min_verts)
+        return NULL;
+
+    std::vector<OverlapReal> key(3*N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        key[3*i] = verts.x[i];
+        key[3*i+1] = verts.y[i];
+        key[3*i+2] = verts.z[i];
+        }
+
+    static std::mutex table_mutex;
+    static std::list< std::unique_ptr<hull_adjacency> > table;
+    std::lock_guard<std::mutex> lock(table_mutex);
+
+    for (std::list< std::unique_ptr<hull_adjacency> >::const_iterator it = table.begin(); it != table.end(); ++it)
+        {
+        if ((*it)->verts == key)
+            return it->get();
+        }
+
+    std::vector< vec3<OverlapReal> > points(N);
+    for (unsigned int i = 0; i < N; i++)
+        points[i] = vec3<OverlapReal>(verts.x[i], verts.y[i], verts.z[i]);
+
+    std::vector< std::vector<unsigned int> > nbrs;
+    if (!convex_hull_adjacency(points, nbrs))
+        return NULL;
+
+    std::vector<unsigned int> seeds;
+    for (int dx = -1; dx <= 1; dx++)
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dz = -1; dz <= 1; dz++)
+                {
+                if (dx == 0 && dy == 0 && dz == 0)
+                    continue;
+
+                vec3<OverlapReal> axis(dx, dy, dz);
+                unsigned int max_idx = 0;
+                OverlapReal max_dot = 0;
+                bool first = true;
+                for (unsigned int i = 0; i < N; i++)
+                    {
+                    OverlapReal d = dot(axis, points[i]);
+                    if (nbrs[i].size() > 0 && (first || d > max_dot))
+                        {
+                        max_dot = d;
+                        max_idx = i;
+                        first = false;
+                        }
+                    }
+                seeds.push_back(max_idx);
+                }
+    nbrs.push_back(seeds);
+
+    std::unique_ptr<hull_adjacency> hull(new hull_adjacency);
+    hull->verts.swap(key);
+
+    const unsigned int B = HULL_BLOCK_SIZE;
+    hull->block_offset.resize(N+2);
+    unsigned int n_blocks = 0;
+    for (unsigned int i = 0; i <= N; i++)
+        {
+        hull->block_offset[i] = n_blocks;
+        n_blocks += (nbrs[i].size() + B - 1)/B;
+        }
+    hull->block_offset[N+1] = n_blocks;
+
+    hull->block_idx.resize(B*n_blocks);
+    hull->block_pos.resize(3*B*n_blocks);
+    for (unsigned int i = 0; i <= N; i++)
+        {
+        unsigned int pad = (i < N) ? i : seeds[0];
+        for (unsigned int b = hull->block_offset[i]; b < hull->block_offset[i+1]; b++)
+            {
+            for (unsigned int j = 0; j < B; j++)
+                {
+                unsigned int k = (b - hull->block_offset[i])*B + j;
+                unsigned int v = (k < nbrs[i].size()) ? nbrs[i][k] : pad;
+                hull->block_idx[b*B + j] = v;
+                hull->block_pos[3*B*b + j] = verts.x[v];
+                hull->block_pos[3*B*b + B + j] = verts.y[v];
+                hull->block_pos[3*B*b + 2*B + j] = verts.z[v];
+                }
+            }
+        }
+
+    table.push_back(std::move(hull));
+    return table.back().get();
+    }
+#endif
+
 //! Support function for ShapePolyhedron
 /*! SupportFuncPolyhedron is a functor that computes the support function for ShapePolyhedron. For a given
     input vector in local coordinates, it finds the vertex most in that direction.
@@ -112,7 +251,7 @@ class SupportFuncConvexPolyhedron
             Note that for performance it is assumed that unused vertices (beyond N) have already been set to zero.
         */
         DEVICE SupportFuncConvexPolyhedron(const poly3d_verts& _verts)
-            : verts(_verts)
+            : verts(_verts), last_vertex(0xffffffff)
             {
             }
 
@@ -122,6 +261,12 @@ class SupportFuncConvexPolyhedron
         */
         DEVICE vec3<OverlapReal> operator() (const vec3<OverlapReal>& n) const
             {
+            #ifndef NVCC
+            // on the CPU, walk along the hull of shapes with many vertices
+            if (verts.hull)
+                return climbHull(n);
+            #endif
+
             OverlapReal max_dot = -(verts.diameter * verts.diameter);
             unsigned int max_idx = 0;
 
@@ -292,6 +437,103 @@ class SupportFuncConvexPolyhedron
 
     private:
         const poly3d_verts& verts;      //!< Vertices of the polyhedron
+        mutable unsigned int last_vertex; //!< Result of the previous hill climb (0xffffffff if none)
+
+        #ifndef NVCC
+        //! Compute the support function by hill climbing on the convex hull
+        /*! \param n Normal vector input (in the local frame)
+            \returns Local coords of the point furthest in the direction of n
+
+            The walk repeatedly moves to the neighbor furthest along \a n. On a convex polyhedron, a vertex without a
+            neighbor further along \a n is the support vertex, so only the vertices near the path are visited instead
+            of all N. To keep the walk short, it starts from the best of the seed vertices, or from the previous
+            result of this support function when that is better (the overlap tests query support points in slowly
+            changing directions).
+        */
+        vec3<OverlapReal> climbHull(const vec3<OverlapReal>& n) const
+            {
+            const unsigned int *offset = verts.hull->block_offset.data();
+            const unsigned int N = verts.N;
+
+            unsigned int cur = verts.hull->block_idx[HULL_BLOCK_SIZE*offset[N]];
+            OverlapReal cur_dot = n.x*verts.x[cur] + n.y*verts.y[cur] + n.z*verts.z[cur];
+            scanBlocks(offset[N], offset[N+1], n, cur, cur_dot);
+
+            if (last_vertex != 0xffffffff)
+                {
+                OverlapReal last_dot = n.x*verts.x[last_vertex] + n.y*verts.y[last_vertex] + n.z*verts.z[last_vertex];
+                if (last_dot > cur_dot)
+                    {
+                    cur = last_vertex;
+                    cur_dot = last_dot;
+                    }
+                }
+
+            while (true)
+                {
+                unsigned int prev = cur;
+                scanBlocks(offset[prev], offset[prev+1], n, cur, cur_dot);
+                if (cur == prev)
+                    break;
+                }
+
+            last_vertex = cur;
+            return vec3<OverlapReal>(verts.x[cur], verts.y[cur], verts.z[cur]);
+            }
+
+        //! Find the vertex furthest along n in a range of blocks
+        /*! \param begin First block
+            \param end One past the last block
+            \param n Direction
+            \param cur Input: best vertex so far. Output: best vertex, unchanged if no vertex in the blocks is better
+            \param cur_dot Input and output: dot product of \a n and \a cur
+        */
+        inline void scanBlocks(unsigned int begin, unsigned int end, const vec3<OverlapReal>& n,
+                               unsigned int& cur, OverlapReal& cur_dot) const
+            {
+            const unsigned int B = HULL_BLOCK_SIZE;
+            const unsigned int *idx = verts.hull->block_idx.data();
+            const OverlapReal *pos = verts.hull->block_pos.data();
+
+            for (unsigned int b = begin; b < end; b++)
+                {
+                const OverlapReal *bx = pos + 3*B*b;
+                const OverlapReal *by = bx + B;
+                const OverlapReal *bz = by + B;
+
+                #if defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+                // evaluate the whole block and only look at the entries if one of them is better
+                __m256 d_v = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n.x), _mm256_loadu_ps(bx)),
+                             _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n.y), _mm256_loadu_ps(by)),
+                                           _mm256_mul_ps(_mm256_set1_ps(n.z), _mm256_loadu_ps(bz))));
+                int mask = _mm256_movemask_ps(_mm256_cmp_ps(d_v, _mm256_set1_ps(cur_dot), _CMP_GT_OQ));
+                if (!mask)
+                    continue;
+
+                float d_s[8] __attribute__((aligned(32)));
+                _mm256_store_ps(d_s, d_v);
+                for (unsigned int j = 0; j < B; j++)
+                    {
+                    if (d_s[j] > cur_dot)
+                        {
+                        cur_dot = d_s[j];
+                        cur = idx[B*b + j];
+                        }
+                    }
+                #else
+                for (unsigned int j = 0; j < B; j++)
+                    {
+                    OverlapReal d = n.x*bx[j] + n.y*by[j] + n.z*bz[j];
+                    if (d > cur_dot)
+                        {
+                        cur_dot = d;
+                        cur = idx[B*b + j];
+                        }
+                    }
+                #endif
+                }
+            }
+        #endif
     };
 
 
@@ -424,6 +666,39 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Convex polyhedron overlap test with a separating direction
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param sep In/out: direction (in the space frame) that separated the shapes in an earlier check, or zero. Set to
+               a separating direction when the shapes are disjoint.
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
+                                 const ShapeConvexPolyhedron& a,
+                                 const ShapeConvexPolyhedron& b,
+                                 unsigned int& err,
+                                 vec3<OverlapReal>& sep)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+    quat<OverlapReal> q_a(a.orientation);
+
+    vec3<OverlapReal> sep_a = rotate(conj(q_a), sep);
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts),
+                                          detail::SupportFuncConvexPolyhedron(b.verts),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/2.0,
+                                          err,
+                                          sep_a);
+    sep = rotate(q_a, sep_a);
+    return overlap;
+    }
+
 }; // end namespace hpmc
 
 #endif //__SHAPE_CONVEX_POLYHEDRON_H__
@@ -409,6 +409,44 @@ DEVICE inline bool test_overlap<ShapeFacetedSphere, ShapeFacetedSphere>(const ve
     */
     }
 
+//! Overlap of faceted spheres with a separating direction
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param sep In/out: direction (in the space frame) that separated the shapes in an earlier check, or zero. Set to
+               a separating direction when the shapes are disjoint.
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+template <>
+DEVICE inline bool test_overlap<ShapeFacetedSphere, ShapeFacetedSphere>(const vec3<Scalar>& r_ab, const ShapeFacetedSphere& a, const ShapeFacetedSphere& b, unsigned int& err, vec3<OverlapReal>& sep)
+    {
+    vec3<OverlapReal> dr(r_ab);
+
+    OverlapReal RaRb = a.params.insphere_radius + b.params.insphere_radius;
+
+    if (dot(dr,dr) < RaRb*RaRb)
+        {
+        // trivial rejection
+        return true;
+        }
+
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+    quat<OverlapReal> q_a(a.orientation);
+    vec3<OverlapReal> sep_a = rotate(conj(q_a), sep);
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncFacetedSphere(a.params),
+                           detail::SupportFuncFacetedSphere(b.params),
+                           rotate(conj(q_a), dr + rotate(quat<OverlapReal>(b.orientation),b.params.origin))-a.params.origin,
+                           conj(q_a)* quat<OverlapReal>(b.orientation),
+                           DaDb/2.0,
+                           err,
+                           sep_a);
+    sep = rotate(q_a, sep_a);
+    return overlap;
+    }
+
 }; // end namespace hpmc
 
 #endif //__SHAPE_FACETED_SPHERE_H__
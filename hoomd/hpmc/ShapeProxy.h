@@ -273,6 +273,9 @@ poly3d_verts make_poly3d_verts(pybind11::list verts, OverlapReal sweep_radius, b
     // set the diameter
     result.diameter = 2*(sqrt(radius_sq) + sweep_radius);
 
+    // speed up the support function of shapes with many vertices
+    result.hull = make_hull_adjacency(result);
+
     return result;
     }
 
@@ -211,6 +211,24 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab, const ShapeA &a, const
     return true;
     }
 
+//! Define the general overlap function with a separating direction
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err Incremented if there is an error condition. Left unchanged otherwise.
+    \param sep In/out: direction (in the space frame) that separated the shapes in an earlier check, or zero
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    Shapes whose overlap test can start from a known separating direction overload this function and set \a sep
+    when the shapes are disjoint. The default implementation ignores \a sep and leaves it unchanged.
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab, const ShapeA &a, const ShapeB& b, unsigned int& err,
+                                vec3<OverlapReal>& sep)
+    {
+    return test_overlap(r_ab, a, b, err);
+    }
+
 //! Sphere-Sphere overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
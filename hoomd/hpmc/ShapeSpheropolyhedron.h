@@ -47,7 +47,7 @@ class SupportFuncSpheropolyhedron
         /*! \param _verts Polyhedron vertices and additional parameters
         */
         DEVICE SupportFuncSpheropolyhedron(const poly3d_verts& _verts)
-            : verts(_verts)
+            : verts(_verts), poly3d_support(_verts)
             {
             }
 
@@ -58,7 +58,7 @@ class SupportFuncSpheropolyhedron
         DEVICE vec3<OverlapReal> operator() (const vec3<OverlapReal>& n) const
             {
             // get the support function of the underlying convex polyhedron
-            vec3<OverlapReal> max_poly3d = SupportFuncConvexPolyhedron(verts)(n);
+            vec3<OverlapReal> max_poly3d = poly3d_support(n);
             // add to that the support mapping of the sphere
             vec3<OverlapReal> max_sphere = (verts.sweep_radius * fast::rsqrt(dot(n,n))) * n;
 
@@ -67,6 +67,7 @@ class SupportFuncSpheropolyhedron
 
     private:
         const poly3d_verts& verts;        //!< Vertices of the polyhedron
+        SupportFuncConvexPolyhedron poly3d_support; //!< Support function of the underlying convex polyhedron
     };
 
 }; // end namespace detail
@@ -217,6 +218,39 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Spheropolyhedron overlap test with a separating direction
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param sep In/out: direction (in the space frame) that separated the shapes in an earlier check, or zero. Set to
+               a separating direction when the shapes are disjoint.
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
+                                 const ShapeSpheropolyhedron& a,
+                                 const ShapeSpheropolyhedron& b,
+                                 unsigned int& err,
+                                 vec3<OverlapReal>& sep)
+    {
+    vec3<OverlapReal> dr = r_ab;
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+    quat<OverlapReal> q_a(a.orientation);
+
+    vec3<OverlapReal> sep_a = rotate(conj(q_a), sep);
+    bool overlap = xenocollide_3d(detail::SupportFuncSpheropolyhedron(a.verts),
+                                  detail::SupportFuncSpheropolyhedron(b.verts),
+                                  rotate(conj(q_a), dr),
+                                  conj(q_a) * quat<OverlapReal>(b.orientation),
+                                  DaDb/2.0,
+                                  err,
+                                  sep_a);
+    sep = rotate(q_a, sep_a);
+    return overlap;
+    }
+
 }; // end namespace hpmc
 
 #endif //__SHAPE_SPHEROPOLYHEDRON_H__
@@ -299,6 +299,17 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
                                           Saru& rng
                                           )
     {
+    // attemptBoxResize() does not draw random numbers, so drawing the acceptance test first does not change the
+    // random number stream
+    double p = rng.d();
+
+    // without an external field, the acceptance probability is known before the trial box is checked for
+    // overlaps. Reject right away instead of resizing the box and checking all particle pairs.
+    if (!m_mc->getExternalField() && !(p < boltzmann))
+        {
+        return false;
+        }
+
     // Make a backup copy of position data
     unsigned int N_backup = m_pdata->getN();
         {
@@ -324,8 +335,6 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
         boltzmann *= ext_boltzmann;
         }
 
-    double p = rng.d();
-
     if (allowed && p < boltzmann)
         {
         return true;
@@ -0,0 +1,607 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __UPDATER_CLUSTERS_H__
+#define __UPDATER_CLUSTERS_H__
+
+/*! \file UpdaterClusters.h
+    \brief Declaration of UpdaterClusters
+*/
+
+#include "hoomd/Updater.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/HOOMDMPI.h"
+#include "hoomd/extern/saruprng.h"
+
+#include "Moves.h"
+#include "HPMCCounters.h"
+#include "IntegratorHPMCMono.h"
+
+#ifndef NVCC
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#endif
+
+namespace hpmc
+{
+
+/*!
+ * This class implements an Updater for the geometric cluster algorithm (GCA) of Dress and Krauth, J. Phys.: Condens.
+ * Matter 1995 and Liu and Luijten, Phys. Rev. Lett. 2004.
+ *
+ * Every step, a self-inverse isometry T is chosen: either a point reflection about a random pivot (only for shapes
+ * without orientation in 3D), or a rotation by pi about a random box axis through the pivot (the pivot move, which
+ * is the point reflection in 2D). Particle i is linked to particle j if T applied to particle i overlaps particle j in
+ * the old configuration. The clusters of linked particles are transformed with probability 1/2 each. The moves are
+ * rejection free and never create overlaps.
+ *
+ * With domain decomposition, the clusters are built on each rank independently. The pivot is drawn at random inside
+ * the active region of the local domain (the same fractional position on every rank). A cluster is rejected if it is
+ * linked to a ghost particle, or if any of its particles is outside of the active region before or after the
+ * transformation, so that no cluster crosses a domain boundary.
+ *
+ * Subclasses add additional links through the virtual method findDepletantLinks().
+ */
+template<class Shape>
+class UpdaterClusters : public Updater
+    {
+    public:
+        //! Constructor
+        /*! \param sysdef System definition
+            \param mc HPMC integrator
+            \param seed RNG seed
+        */
+        UpdaterClusters(std::shared_ptr<SystemDefinition> sysdef,
+            std::shared_ptr<IntegratorHPMCMono<Shape> > mc,
+            unsigned int seed);
+        virtual ~UpdaterClusters();
+
+        //! The entry method for this updater
+        /*! \param timestep Current simulation step
+         */
+        virtual void update(unsigned int timestep);
+
+        //! Set the fraction of point reflections among the moves (3D and shapes without orientation only)
+        void setMoveRatio(Scalar move_ratio)
+            {
+            if (move_ratio < Scalar(0.0) || move_ratio > Scalar(1.0))
+                {
+                throw std::runtime_error("Move ratio has to be between 0 and 1.\n");
+                }
+            m_move_ratio = move_ratio;
+            }
+
+        //! Get the fraction of point reflections among the moves
+        Scalar getMoveRatio()
+            {
+            return m_move_ratio;
+            }
+
+        //! Print statistics about the cluster moves
+        void printStats()
+            {
+            hpmc_clusters_counters_t counters = getCounters(1);
+            m_exec_conf->msg->notice(2) << "-- HPMC cluster move stats:" << std::endl;
+            if (counters.cluster_count > 0)
+                {
+                m_exec_conf->msg->notice(2) << "Average cluster size:                " << counters.getAverageClusterSize() << std::endl;
+                m_exec_conf->msg->notice(2) << "Largest cluster size:                " << m_max_cluster_size_run << std::endl;
+                m_exec_conf->msg->notice(2) << "Fraction of particles moved:         " << counters.getMovedFraction() << std::endl;
+                m_exec_conf->msg->notice(2) << "Clusters rejected at domain borders: " << counters.boundary_reject_count << std::endl;
+                }
+            m_exec_conf->msg->notice(2) << "Total point reflections:             " << counters.point_reflection_count << std::endl;
+            m_exec_conf->msg->notice(2) << "Total pivot moves:                   " << counters.pivot_move_count << std::endl;
+            }
+
+        //! Get a list of logged quantities
+        virtual std::vector< std::string > getProvidedLogQuantities()
+            {
+            std::vector< std::string > result;
+
+            result.push_back("hpmc_clusters_avg_size");
+            result.push_back("hpmc_clusters_max_size");
+            result.push_back("hpmc_clusters_moved_fraction");
+            result.push_back("hpmc_clusters_boundary_rejects");
+            return result;
+            }
+
+        //! Get the value of a logged quantity
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! Reset statistics counters
+        void resetStats()
+            {
+            m_count_run_start = m_count_total;
+            m_max_cluster_size_run = 0;
+            }
+
+        //! Get the current counter values
+        hpmc_clusters_counters_t getCounters(unsigned int mode=0);
+
+    protected:
+        std::shared_ptr<IntegratorHPMCMono<Shape> > m_mc;    //!< The MC Integrator this Updater is associated with
+        unsigned int m_seed;                                  //!< RNG seed
+        Scalar m_move_ratio;                                  //!< Fraction of point reflections among the moves
+        bool m_warned_tilt;                                   //!< True after warning about pivot moves in tilted boxes
+
+        hpmc_clusters_counters_t m_count_total;               //!< Total count since initialization
+        hpmc_clusters_counters_t m_count_run_start;           //!< Count saved at run() start
+        hpmc_clusters_counters_t m_count_step_start;          //!< Count saved at the start of the last step
+        unsigned int m_max_cluster_size_step;                 //!< Largest cluster in the last step
+        unsigned int m_max_cluster_size_run;                  //!< Largest cluster since the start of the run
+
+        vec3<Scalar> m_pivot;                                 //!< Pivot point of the current move
+        quat<Scalar> m_q_move;                                //!< Rotation of the current move
+        bool m_point_reflection;                              //!< True if the current move is a point reflection
+
+        std::vector< vec3<Scalar> > m_pos_new;                //!< Transformed positions of the local particles
+        std::vector< quat<Scalar> > m_orientation_new;        //!< Transformed orientations of the local particles
+        std::vector<int3> m_image_shift;                      //!< Change of the image flags by the transformation
+        std::vector<unsigned int> m_parent;                   //!< Union-find forest over the local and ghost particles
+
+        //! Apply the transformation of the current move
+        /*! \param pos Position
+            \param orientation Orientation
+            \param pos_new Output: transformed position, not wrapped into the box
+            \param orientation_new Output: transformed orientation
+        */
+        void transform(const vec3<Scalar>& pos, const quat<Scalar>& orientation,
+            vec3<Scalar>& pos_new, quat<Scalar>& orientation_new) const
+            {
+            if (m_point_reflection)
+                {
+                pos_new = Scalar(2.0)*m_pivot - pos;
+                orientation_new = orientation;
+                }
+            else
+                {
+                pos_new = m_pivot + rotate(m_q_move, pos - m_pivot);
+                orientation_new = m_q_move * orientation;
+                }
+            }
+
+        //! Find the root of the cluster of a particle
+        unsigned int findRoot(unsigned int i)
+            {
+            while (m_parent[i] != i)
+                {
+                m_parent[i] = m_parent[m_parent[i]];
+                i = m_parent[i];
+                }
+            return i;
+            }
+
+        //! Link two particles into the same cluster
+        void link(unsigned int i, unsigned int j)
+            {
+            i = findRoot(i);
+            j = findRoot(j);
+            if (i < j)
+                m_parent[j] = i;
+            else if (j < i)
+                m_parent[i] = j;
+            }
+
+        //! Choose the transformation for this step
+        /*! \param rng Random number generator of the step
+            \param ghost_fraction Width of the inactive region at the upper domain borders, as fraction of the box
+            \returns false if no valid move is available
+        */
+        bool chooseMove(Saru& rng, const Scalar3& ghost_fraction);
+
+        //! Link the particles that overlap when one of them is transformed
+        void findOverlapLinks();
+
+        //! Add links mediated by implicit depletants
+        /*! \param timestep Current simulation step
+
+            The base class has no depletants and adds no links.
+        */
+        virtual void findDepletantLinks(unsigned int timestep)
+            {
+            }
+
+        //! Check if the updater can run
+        virtual void checkSupported();
+    };
+
+/*! \param sysdef System definition
+    \param mc HPMC integrator
+    \param seed RNG seed
+*/
+template<class Shape>
+UpdaterClusters<Shape>::UpdaterClusters(std::shared_ptr<SystemDefinition> sysdef,
+    std::shared_ptr<IntegratorHPMCMono<Shape> > mc,
+    unsigned int seed)
+    : Updater(sysdef), m_mc(mc), m_seed(seed), m_move_ratio(0.5), m_warned_tilt(false),
+      m_max_cluster_size_step(0), m_max_cluster_size_run(0), m_point_reflection(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing UpdaterClusters" << std::endl;
+    }
+
+template<class Shape>
+UpdaterClusters<Shape>::~UpdaterClusters()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying UpdaterClusters" << std::endl;
+    }
+
+template<class Shape>
+void UpdaterClusters<Shape>::checkSupported()
+    {
+    if (m_mc->getExternalField())
+        {
+        m_exec_conf->msg->error() << "update.clusters: External fields are not supported." << std::endl;
+        throw std::runtime_error("Error in update.clusters");
+        }
+    }
+
+/*! \param rng Random number generator of the step
+    \param ghost_fraction Width of the inactive region at the upper domain borders, as fraction of the box
+    \returns false if no valid move is available
+
+    Shapes with orientation cannot be point reflected in 3D, since that would invert their handedness. Rotations by pi
+    about a box axis only map the periodic lattice onto itself in orthorhombic boxes.
+*/
+template<class Shape>
+bool UpdaterClusters<Shape>::chooseMove(Saru& rng, const Scalar3& ghost_fraction)
+    {
+    const BoxDim& box = m_pdata->getBox();
+    unsigned int ndim = m_sysdef->getNDimensions();
+
+    // the pivot is random, inside the active region along the directions split by the domain decomposition
+    uchar3 periodic = box.getPeriodic();
+    Scalar3 f_max = make_scalar3(periodic.x ? Scalar(1.0) : Scalar(1.0) - ghost_fraction.x,
+                                 periodic.y ? Scalar(1.0) : Scalar(1.0) - ghost_fraction.y,
+                                 periodic.z ? Scalar(1.0) : Scalar(1.0) - ghost_fraction.z);
+    Scalar3 f = make_scalar3(0.5, 0.5, 0.5);
+    f.x = rng.template s<Scalar>(Scalar(0.0), f_max.x);
+    f.y = rng.template s<Scalar>(Scalar(0.0), f_max.y);
+    if (ndim == 3)
+        f.z = rng.template s<Scalar>(Scalar(0.0), f_max.z);
+    m_pivot = vec3<Scalar>(box.makeCoordinates(f));
+
+    if (ndim == 2)
+        {
+        // the pivot move about the z axis is the point reflection in the plane
+        m_point_reflection = false;
+        m_q_move = quat<Scalar>(Scalar(0.0), vec3<Scalar>(0,0,1));
+        return true;
+        }
+
+    // point reflections invert the handedness of shapes with orientation
+    bool has_orientation = false;
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> >& params = m_mc->getParams();
+    for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+        {
+        Shape shape(quat<Scalar>(), params[typ]);
+        if (shape.hasOrientation())
+            has_orientation = true;
+        }
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    bool tilted = global_box.getTiltFactorXY() != Scalar(0.0) || global_box.getTiltFactorXZ() != Scalar(0.0)
+        || global_box.getTiltFactorYZ() != Scalar(0.0);
+
+    Scalar select = rng.template s<Scalar>();
+    if (!has_orientation && (tilted || select < m_move_ratio))
+        {
+        m_point_reflection = true;
+        m_count_total.point_reflection_count++;
+        return true;
+        }
+
+    if (tilted)
+        {
+        if (!m_warned_tilt)
+            {
+            m_exec_conf->msg->warning() << "update.clusters: Pivot moves of shapes with orientation require an orthorhombic "
+                << "box, skipping cluster moves." << std::endl;
+            m_warned_tilt = true;
+            }
+        return false;
+        }
+
+    // rotation by pi about a random box axis
+    vec3<Scalar> axis(0,0,0);
+    unsigned int i_axis = rand_select(rng, 2);
+    if (i_axis == 0)
+        axis.x = Scalar(1.0);
+    else if (i_axis == 1)
+        axis.y = Scalar(1.0);
+    else
+        axis.z = Scalar(1.0);
+
+    m_point_reflection = false;
+    m_q_move = quat<Scalar>(Scalar(0.0), axis);
+    m_count_total.pivot_move_count++;
+    return true;
+    }
+
+/*! Links particle i to particle j if the transformed particle i overlaps particle j in its old position. Since the
+    move is a self-inverse isometry, this relation is symmetric, and only the local particles need to be transformed.
+    Particles j may be ghosts.
+*/
+template<class Shape>
+void UpdaterClusters<Shape>::findOverlapLinks()
+    {
+    const detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
+    const std::vector<vec3<Scalar> >& image_list = m_mc->updateImageList();
+    const unsigned int n_images = image_list.size();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> >& params = m_mc->getParams();
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+    const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+
+    unsigned int err_count = 0;
+
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+        Shape shape_i(m_orientation_new[i], params[typ_i]);
+        detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+            {
+            vec3<Scalar> pos_i_image = m_pos_new[i] + image_list[cur_image];
+            detail::AABB aabb = aabb_i_local;
+            aabb.translate(pos_i_image);
+
+            // stackless search
+            for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
+                {
+                if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    {
+                    if (aabb_tree.isNodeLeaf(cur_node_idx))
+                        {
+                        for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                            {
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            // the images of a particle move with it
+                            if (j == i)
+                                continue;
+
+                            Scalar4 postype_j = h_postype.data[j];
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            if (!h_overlaps.data[overlap_idx(typ_i, typ_j)] || findRoot(i) == findRoot(j))
+                                continue;
+
+                            Shape shape_j(quat<Scalar>(h_orientation.data[j]), params[typ_j]);
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                            if (check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                                && test_overlap(r_ij, shape_i, shape_j, err_count))
+                                {
+                                link(i, j);
+                                }
+                            }
+                        }
+                    }
+                else
+                    {
+                    // skip ahead
+                    cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                    }
+                } // end loop over AABB nodes
+            } // end loop over images
+        } // end loop over local particles
+    }
+
+/*! Perform one sweep of cluster moves
+    \param timestep Current time step of the simulation
+*/
+template<class Shape>
+void UpdaterClusters<Shape>::update(unsigned int timestep)
+    {
+    m_exec_conf->msg->notice(10) << "UpdaterClusters: " << timestep << std::endl;
+    m_count_step_start = m_count_total;
+    m_max_cluster_size_step = 0;
+
+    checkSupported();
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_total = N + m_pdata->getNGhosts();
+    const BoxDim& box = m_pdata->getBox();
+
+    // the width of the region at the domain borders that clusters may not touch
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar3 ghost_fraction = m_mc->getGhostLayerWidth(0) / npd;
+
+    // the move is the same on all ranks, the clusters are flipped independently
+    Saru rng(timestep, m_seed, 0x1c2e7a3b);
+    if (!chooseMove(rng, ghost_fraction))
+        return;
+    Saru rng_flip(timestep, m_seed + m_exec_conf->getRank(), 0x5e0b4c9d);
+
+    if (m_prof) m_prof->push(m_exec_conf, "HPMC Clusters");
+
+    // transform the local particles
+    m_pos_new.resize(N);
+    m_orientation_new.resize(N);
+    m_image_shift.resize(N);
+    m_parent.resize(n_total);
+    for (unsigned int i = 0; i < n_total; i++)
+        {
+        m_parent[i] = i;
+        }
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            transform(vec3<Scalar>(h_postype.data[i]), quat<Scalar>(h_orientation.data[i]), m_pos_new[i], m_orientation_new[i]);
+
+            // the image list only covers positions inside the box
+            Scalar3 pos = vec_to_scalar3(m_pos_new[i]);
+            m_image_shift[i] = make_int3(0,0,0);
+            global_box.wrap(pos, m_image_shift[i]);
+            m_pos_new[i] = vec3<Scalar>(pos);
+            }
+        }
+
+    findOverlapLinks();
+    findDepletantLinks(timestep);
+
+    // clusters with ghosts or with particles outside of the active region are rejected
+    std::vector<unsigned int> cluster_size(n_total, 0);
+    std::vector<char> reject(n_total, 0);
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n_total; i++)
+            {
+            unsigned int root = findRoot(i);
+            if (i >= N)
+                {
+                reject[root] = 1;
+                continue;
+                }
+
+            cluster_size[root]++;
+            #ifdef ENABLE_MPI
+            if (m_pdata->getDomainDecomposition()
+                && (!isActive(make_scalar3(h_postype.data[i].x, h_postype.data[i].y, h_postype.data[i].z), box, ghost_fraction)
+                    || !isActive(vec_to_scalar3(m_pos_new[i]), box, ghost_fraction)))
+                {
+                reject[root] = 1;
+                }
+            #endif
+            }
+        }
+
+    // flip each cluster with probability 1/2, in order of the cluster roots
+    std::vector<char> flip(n_total, 0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (findRoot(i) != i)
+            continue;
+
+        m_count_total.cluster_count++;
+        m_count_total.particle_count += cluster_size[i];
+        m_max_cluster_size_step = std::max(m_max_cluster_size_step, cluster_size[i]);
+
+        if (reject[i])
+            m_count_total.boundary_reject_count++;
+        else if (rng_flip.template s<Scalar>() < Scalar(0.5))
+            flip[i] = 1;
+        }
+
+    // move the flipped clusters
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            if (!flip[findRoot(i)])
+                continue;
+
+            h_postype.data[i] = make_scalar4(m_pos_new[i].x, m_pos_new[i].y, m_pos_new[i].z, h_postype.data[i].w);
+            h_image.data[i].x += m_image_shift[i].x;
+            h_image.data[i].y += m_image_shift[i].y;
+            h_image.data[i].z += m_image_shift[i].z;
+            h_orientation.data[i] = quat_to_scalar4(m_orientation_new[i]);
+            m_count_total.moved_count++;
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        unsigned int max_size = m_max_cluster_size_step;
+        MPI_Allreduce(&max_size, &m_max_cluster_size_step, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    m_max_cluster_size_run = std::max(m_max_cluster_size_run, m_max_cluster_size_step);
+
+    // the moved particles stay in the domain, but the ghosts and the tree have to be updated
+    m_mc->invalidateAABBTree();
+    m_mc->communicate(false);
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*! \param quantity Name of the log quantity to get
+    \param timestep Current time step of the simulation
+    \return the requested log quantity.
+*/
+template<class Shape>
+Scalar UpdaterClusters<Shape>::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    hpmc_clusters_counters_t counters = getCounters(2);
+
+    if (quantity == "hpmc_clusters_avg_size")
+        {
+        return counters.getAverageClusterSize();
+        }
+    else if (quantity == "hpmc_clusters_max_size")
+        {
+        return m_max_cluster_size_step;
+        }
+    else if (quantity == "hpmc_clusters_moved_fraction")
+        {
+        return counters.getMovedFraction();
+        }
+    else if (quantity == "hpmc_clusters_boundary_rejects")
+        {
+        return counters.boundary_reject_count;
+        }
+    else
+        {
+        m_exec_conf->msg->error() << "update.clusters: Log quantity " << quantity
+            << " is not supported by this Updater." << std::endl;
+        throw std::runtime_error("Error querying log value.");
+        }
+    }
+
+/*! \param mode 0 -> Absolute count, 1 -> relative to the start of the run, 2 -> relative to the last executed step
+    \return The current state of the counters
+
+    The point reflection and pivot move counts are the same on all ranks, the other counts are summed over the
+    domains.
+*/
+template<class Shape>
+hpmc_clusters_counters_t UpdaterClusters<Shape>::getCounters(unsigned int mode)
+    {
+    hpmc_clusters_counters_t result;
+
+    if (mode == 0)
+        result = m_count_total;
+    else if (mode == 1)
+        result = m_count_total - m_count_run_start;
+    else
+        result = m_count_total - m_count_step_start;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &result.cluster_count, 1, MPI_LONG_LONG_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &result.particle_count, 1, MPI_LONG_LONG_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &result.moved_count, 1, MPI_LONG_LONG_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &result.boundary_reject_count, 1, MPI_LONG_LONG_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return result;
+    }
+
+//! Export the UpdaterClusters class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of UpdaterClusters<Shape> will be exported
+*/
+template < class Shape > void export_UpdaterClusters(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< UpdaterClusters<Shape>, std::shared_ptr< UpdaterClusters<Shape> > >(m, name.c_str(), pybind11::base<Updater>())
+          .def( pybind11::init< std::shared_ptr<SystemDefinition>, std::shared_ptr< IntegratorHPMCMono<Shape> >, unsigned int >())
+          .def("setMoveRatio", &UpdaterClusters<Shape>::setMoveRatio)
+          .def("getMoveRatio", &UpdaterClusters<Shape>::getMoveRatio)
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // __UPDATER_CLUSTERS_H__
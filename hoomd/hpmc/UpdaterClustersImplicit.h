@@ -0,0 +1,281 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __UPDATER_CLUSTERS_IMPLICIT_H__
+#define __UPDATER_CLUSTERS_IMPLICIT_H__
+
+/*! \file UpdaterClustersImplicit.h
+    \brief Declaration of UpdaterClustersImplicit
+*/
+
+#include "UpdaterClusters.h"
+#include "IntegratorHPMCMonoImplicit.h"
+
+#include <random>
+
+#ifndef NVCC
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#endif
+
+namespace hpmc
+{
+
+/*!
+ * This class implements the geometric cluster algorithm with implicit depletants.
+ *
+ * The depletants are an ideal gas in the free volume of the colloids. Treated as explicit particles, a depletant joins
+ * the cluster of every colloid whose transformed image it overlaps. Integrating the depletants out, colloids i and j
+ * are linked if a depletant in the free volume of the old configuration overlaps both transformed colloids.
+ *
+ * The depletants are drawn from a Poisson process in the union of the spheres around the transformed colloids that
+ * contain all depletants overlapping them. Each sphere is sampled in turn, and a depletant is only kept by the
+ * lowest indexed sphere that contains it, so that every region is sampled exactly once.
+ */
+template<class Shape>
+class UpdaterClustersImplicit : public UpdaterClusters<Shape>
+    {
+    public:
+        //! Constructor
+        /*! \param sysdef System definition
+            \param mc_implicit Implicit depletants integrator
+            \param seed RNG seed
+        */
+        UpdaterClustersImplicit(std::shared_ptr<SystemDefinition> sysdef,
+            std::shared_ptr<IntegratorHPMCMonoImplicit<Shape> > mc_implicit,
+            unsigned int seed);
+
+    protected:
+        std::shared_ptr<IntegratorHPMCMonoImplicit<Shape> > m_mc_implicit;   //!< The associated implicit depletants integrator
+
+        //! Add links mediated by implicit depletants
+        virtual void findDepletantLinks(unsigned int timestep);
+    };
+
+/*! \param sysdef System definition
+    \param mc_implicit Implicit depletants integrator
+    \param seed RNG seed
+*/
+template<class Shape>
+UpdaterClustersImplicit<Shape>::UpdaterClustersImplicit(std::shared_ptr<SystemDefinition> sysdef,
+    std::shared_ptr<IntegratorHPMCMonoImplicit<Shape> > mc_implicit,
+    unsigned int seed)
+    : UpdaterClusters<Shape>(sysdef, mc_implicit, seed), m_mc_implicit(mc_implicit)
+    {
+    if (this->m_sysdef->getNDimensions() == 2)
+        {
+        throw std::runtime_error("2D runs not supported with implicit depletants in update.clusters().");
+        }
+    }
+
+/*! \param timestep Current simulation step
+
+    A depletant d overlaps the transformed colloid T(j) if and only if T(d) overlaps colloid j in its old position,
+    because the move is a self-inverse isometry. The colloids linked by d are therefore found with a query of the AABB
+    tree of the old configuration.
+*/
+template<class Shape>
+void UpdaterClustersImplicit<Shape>::findDepletantLinks(unsigned int timestep)
+    {
+    Scalar n_R = m_mc_implicit->getDepletantDensity();
+    if (n_R <= Scalar(0.0))
+        return;
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "Depletants");
+
+    const detail::AABBTree& aabb_tree = this->m_mc->buildAABBTree();
+    const std::vector<vec3<Scalar> >& image_list = this->m_mc->updateImageList();
+    const unsigned int n_images = image_list.size();
+
+    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> >& params = this->m_mc->getParams();
+    ArrayHandle<unsigned int> h_overlaps(this->m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+    const Index2D& overlap_idx = this->m_mc->getOverlapIndexer();
+    const BoxDim& global_box = this->m_pdata->getGlobalBox();
+
+    unsigned int type_d = m_mc_implicit->getDepletantType();
+    Shape shape_d_ref(quat<Scalar>(), params[type_d]);
+    Scalar d_dep = shape_d_ref.getCircumsphereDiameter();
+
+    // depletants overlapping a colloid are within this distance of its center
+    Scalar r_max = Scalar(0.5)*(this->m_mc->getMaxDiameter() + d_dep);
+
+    // Poisson distributions of the number of depletants in the sphere around each type
+    std::vector<Scalar> delta(this->m_pdata->getNTypes());
+    std::vector< std::poisson_distribution<unsigned int> > poisson(this->m_pdata->getNTypes());
+    for (unsigned int typ = 0; typ < this->m_pdata->getNTypes(); typ++)
+        {
+        Shape shape(quat<Scalar>(), params[typ]);
+        delta[typ] = shape.getCircumsphereDiameter() + d_dep;
+        Scalar lambda = n_R*Scalar(M_PI/6.0)*delta[typ]*delta[typ]*delta[typ];
+        if (lambda > Scalar(0.0))
+            poisson[typ] = std::poisson_distribution<unsigned int>(lambda);
+        }
+
+    // combine four seeds
+    std::vector<unsigned int> seed_seq(4);
+    seed_seq[0] = this->m_seed;
+    seed_seq[1] = timestep;
+    seed_seq[2] = this->m_exec_conf->getRank();
+    #ifdef ENABLE_MPI
+    seed_seq[3] = this->m_exec_conf->getPartition();
+    #else
+    seed_seq[3] = 0;
+    #endif
+    std::seed_seq seed(seed_seq.begin(), seed_seq.end());
+    std::mt19937 rng_poisson(seed);
+
+    unsigned int err_count = 0;
+    std::vector<unsigned int> linked;
+
+    for (unsigned int i = 0; i < this->m_pdata->getN(); i++)
+        {
+        unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+        if (delta[typ_i] <= Scalar(0.0))
+            continue;
+
+        unsigned int n_depletants = poisson[typ_i](rng_poisson);
+        Saru rng_i(i, this->m_seed + this->m_exec_conf->getRank(), timestep);
+
+        for (unsigned int k = 0; k < n_depletants; k++)
+            {
+            // draw a random depletant in the sphere around the transformed colloid
+            Scalar theta = rng_i.template s<Scalar>(Scalar(0.0),Scalar(2.0*M_PI));
+            Scalar z = rng_i.template s<Scalar>(Scalar(-1.0),Scalar(1.0));
+            vec3<Scalar> n(fast::sqrt(Scalar(1.0)-z*z)*fast::cos(theta),fast::sqrt(Scalar(1.0)-z*z)*fast::sin(theta),z);
+            Scalar r = Scalar(0.5)*delta[typ_i]*fast::pow(rng_i.template s<Scalar>(),Scalar(1.0/3.0));
+            vec3<Scalar> pos_d = this->m_pos_new[i] + r*n;
+
+            Shape shape_d(quat<Scalar>(), params[type_d]);
+            if (shape_d.hasOrientation())
+                shape_d.orientation = generateRandomOrientation(rng_i);
+
+            // the depletant after the transformation
+            vec3<Scalar> pos_d_new;
+            quat<Scalar> orientation_d_new;
+            this->transform(pos_d, shape_d.orientation, pos_d_new, orientation_d_new);
+            Shape shape_d_new(orientation_d_new, params[type_d]);
+
+            Scalar3 pos = vec_to_scalar3(pos_d_new);
+            int3 img = make_int3(0,0,0);
+            global_box.wrap(pos, img);
+            pos_d_new = vec3<Scalar>(pos);
+
+            // find the colloids that are linked by the depletant, and skip depletants that belong to the sphere of a
+            // colloid with a lower index
+            linked.clear();
+            bool skip = false;
+            for (unsigned int cur_image = 0; cur_image < n_images && !skip; cur_image++)
+                {
+                vec3<Scalar> pos_d_image = pos_d_new + image_list[cur_image];
+                detail::AABB aabb(pos_d_image, r_max);
+
+                // stackless search
+                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes() && !skip; cur_node_idx++)
+                    {
+                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        {
+                        if (aabb_tree.isNodeLeaf(cur_node_idx))
+                            {
+                            for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                {
+                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                                Scalar4 postype_j = h_postype.data[j];
+                                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                vec3<Scalar> r_dj = vec3<Scalar>(postype_j) - pos_d_image;
+
+                                if (j < i && dot(r_dj,r_dj) < Scalar(0.25)*delta[typ_j]*delta[typ_j])
+                                    {
+                                    skip = true;
+                                    break;
+                                    }
+
+                                Shape shape_j(quat<Scalar>(h_orientation.data[j]), params[typ_j]);
+                                if (h_overlaps.data[overlap_idx(type_d, typ_j)]
+                                    && check_circumsphere_overlap(r_dj, shape_d_new, shape_j)
+                                    && test_overlap(r_dj, shape_d_new, shape_j, err_count))
+                                    {
+                                    linked.push_back(j);
+                                    }
+                                }
+                            }
+                        }
+                    else
+                        {
+                        // skip ahead
+                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                        }
+                    } // end loop over AABB nodes
+                } // end loop over images
+
+            if (skip || linked.size() < 2)
+                continue;
+
+            // the depletant only exists if it is in the free volume of the old configuration
+            bool overlap = false;
+            detail::AABB aabb_d_local = shape_d.getAABB(vec3<Scalar>(0,0,0));
+            for (unsigned int cur_image = 0; cur_image < n_images && !overlap; cur_image++)
+                {
+                vec3<Scalar> pos_d_image = pos_d + image_list[cur_image];
+                detail::AABB aabb = aabb_d_local;
+                aabb.translate(pos_d_image);
+
+                // stackless search
+                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes() && !overlap; cur_node_idx++)
+                    {
+                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        {
+                        if (aabb_tree.isNodeLeaf(cur_node_idx))
+                            {
+                            for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                {
+                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                                Scalar4 postype_j = h_postype.data[j];
+                                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                Shape shape_j(quat<Scalar>(h_orientation.data[j]), params[typ_j]);
+                                vec3<Scalar> r_dj = vec3<Scalar>(postype_j) - pos_d_image;
+
+                                if (h_overlaps.data[overlap_idx(type_d, typ_j)]
+                                    && check_circumsphere_overlap(r_dj, shape_d, shape_j)
+                                    && test_overlap(r_dj, shape_d, shape_j, err_count))
+                                    {
+                                    overlap = true;
+                                    break;
+                                    }
+                                }
+                            }
+                        }
+                    else
+                        {
+                        // skip ahead
+                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                        }
+                    } // end loop over AABB nodes
+                } // end loop over images
+
+            if (overlap)
+                continue;
+
+            for (unsigned int l = 1; l < linked.size(); l++)
+                this->link(linked[0], linked[l]);
+            } // end loop over depletants
+        } // end loop over local particles
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    }
+
+//! Export the UpdaterClustersImplicit class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of UpdaterClustersImplicit<Shape> will be exported
+*/
+template < class Shape > void export_UpdaterClustersImplicit(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< UpdaterClustersImplicit<Shape>, std::shared_ptr< UpdaterClustersImplicit<Shape> > >(m, name.c_str(), pybind11::base<UpdaterClusters<Shape> >())
+          .def( pybind11::init< std::shared_ptr<SystemDefinition>, std::shared_ptr< IntegratorHPMCMonoImplicit<Shape> >, unsigned int >())
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // __UPDATER_CLUSTERS_IMPLICIT_H__
@@ -17,10 +17,47 @@
 namespace hpmc
 {
 
+namespace detail
+{
+
+//! Data that one box of a Gibbs ensemble sends to the other for a batch of transfer moves
+struct TransferBatchData
+    {
+    unsigned int timestep;        //!< Current time step, to check that the boxes are in sync
+    Scalar volume;                //!< Volume of the box
+
+    //! Tags of the particles of every transfer type
+    std::vector<std::vector<unsigned int> > type_tags;
+
+    //! For every move into this box, the tags of the particles that overlap the trial particle (UINT_MAX for itself)
+    std::vector<std::vector<unsigned int> > overlap_tags;
+
+    //! For every move into this box, the earlier moves into this box whose trial particle overlaps
+    std::vector<std::vector<unsigned int> > overlap_moves;
+
+    //! Serialize the data
+    template<class Archive>
+    void serialize(Archive & ar)
+        {
+        ar(timestep, volume, type_tags, overlap_tags, overlap_moves);
+        }
+    };
+
+} // end namespace detail
+
 /*!
  * This class implements an Updater for simulations in the grand-canonical ensemble (mu-V-T).
  *
  * Gibbs ensemble integration between two MPI partitions is also supported.
+ *
+ * The tags of the particles of every type are kept in an index that is identical on all ranks, so that a random
+ * particle of a given type can be chosen without communication. The index is updated along with the insertions,
+ * removals and identity changes of this updater, and rebuilt when the number of particles changes otherwise.
+ *
+ * Updates that choose a transfer move (with probability m_transfer_ratio) can make a batch of them instead. In the
+ * grand-canonical ensemble, these are insertion and removal moves, see updateBatch(). In the Gibbs ensemble, a single
+ * message is exchanged between the boxes per batch, see updateTransferBatch(). Identity exchange moves are always made
+ * one at a time.
  */
 template<class Shape>
 class UpdaterMuVT : public Updater
@@ -74,6 +111,28 @@ class UpdaterMuVT : public Updater
             m_transfer_ratio = transfer_ratio;
             }
 
+        //! Set the number of insertion and removal (or transfer) moves per call
+        void setBatchSize(unsigned int batch_size)
+            {
+            if (batch_size == 0)
+                {
+                throw std::runtime_error("Batch size has to be at least 1.\n");
+                }
+            if (batch_size > 1 && !isBatchSupported())
+                {
+                m_exec_conf->msg->error() << "update.muvt: Batched moves are not supported with implicit depletants."
+                    << std::endl;
+                throw std::runtime_error("Error setting muVT parameters");
+                }
+            m_batch_size = batch_size;
+            }
+
+        //! Get the number of insertion and removal moves per call
+        unsigned int getBatchSize()
+            {
+            return m_batch_size;
+            }
+
         //! List of types that are inserted/removed/transfered
         void setTransferTypes(std::vector<unsigned int>& transfer_types)
             {
@@ -135,6 +194,9 @@ class UpdaterMuVT : public Updater
         void resetStats()
             {
             m_count_run_start = m_count_total;
+
+            // particle types may have been changed between runs
+            m_type_map_dirty = true;
             }
 
         //! Get the current counter values
@@ -159,9 +221,14 @@ class UpdaterMuVT : public Updater
         hpmc_muvt_counters_t m_count_run_start;      //!< Count saved at run() start
         hpmc_muvt_counters_t m_count_step_start;     //!< Count saved at the start of the last step
 
-        std::vector<std::vector<unsigned int> > m_type_map;   //!< Local list of particle tags per type
+        std::vector<std::vector<unsigned int> > m_type_map;   //!< Global list of particle tags per type, same on all ranks
+        std::vector<unsigned int> m_type_map_pos;  //!< Position of every tag in its list in m_type_map
+        bool m_type_map_dirty;                     //!< True if m_type_map needs to be rebuilt
+        bool m_updating_type_map;                  //!< True while this updater adds or removes particles
         std::vector<unsigned int> m_transfer_types;  //!< List of types being insert/removed/transfered between boxes
 
+        unsigned int m_batch_size;                   //!< Number of insertion and removal (or transfer) moves per call
+
         /*! Check for overlaps of a fictituous particle
          * \param timestep Current time step
          * \param type Type of particle to test
@@ -173,6 +240,62 @@ class UpdaterMuVT : public Updater
         virtual bool tryInsertParticle(unsigned int timestep, unsigned int type, vec3<Scalar> pos, quat<Scalar> orientation,
             Scalar &lnboltzmann);
 
+        /*! Check for overlaps of a fictitious particle with the local particles and ghosts
+         * \param type Type of particle to test
+         * \param pos Position of fictitous particle
+         * \param orientation Orientation of particle
+         * \param aabb_tree AABB tree of the integrator
+         * \param image_list Image list of the integrator
+         * \param h_postype Particle positions and types
+         * \param h_orientation Particle orientations
+         * \param h_tag Particle tags
+         * \param h_overlaps Interaction matrix
+         * \param skip_tags If not NULL, flags of the particle tags to ignore
+         * \param overlap_tags If not NULL, the tags of all overlapping particles are appended (UINT_MAX for a
+         *        periodic image of the particle itself)
+         * \param err_count Overlap check error counter (incremented)
+         * \returns True if the particle overlaps
+         *
+         * This method does not modify the updater and can be called from multiple threads.
+         */
+        bool checkOverlap(unsigned int type, const vec3<Scalar>& pos, const quat<Scalar>& orientation,
+            const detail::AABBTree& aabb_tree, const std::vector<vec3<Scalar> >& image_list,
+            const Scalar4 *h_postype, const Scalar4 *h_orientation, const unsigned int *h_tag,
+            const unsigned int *h_overlaps, const std::vector<bool> *skip_tags,
+            std::vector<unsigned int> *overlap_tags, unsigned int& err_count);
+
+        //! Check for overlaps between two fictitious particles
+        bool checkTrialOverlap(unsigned int type_a, const vec3<Scalar>& pos_a, const quat<Scalar>& orientation_a,
+            unsigned int type_b, const vec3<Scalar>& pos_b, const quat<Scalar>& orientation_b,
+            const std::vector<vec3<Scalar> >& image_list, const unsigned int *h_overlaps, unsigned int& err_count);
+
+        //! Make a batch of insertion and removal moves
+        void updateBatch(unsigned int timestep, unsigned int batch_seed);
+
+        //! Make a batch of transfer moves between the two boxes of a Gibbs ensemble
+        void updateTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod);
+
+        //! Draw the trial particle of a transfer move of a batch
+        void drawTransferTrial(unsigned int k, unsigned int batch_seed, unsigned int type, vec3<Scalar>& pos,
+            quat<Scalar>& orientation);
+
+        //! Compute the data this box sends to the other box for a batch of transfer moves
+        void buildTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod,
+            detail::TransferBatchData& data);
+
+        //! Accept or reject a batch of transfer moves and apply them to this box
+        void applyTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod,
+            const detail::TransferBatchData& data_0, const detail::TransferBatchData& data_1);
+
+        //! Returns true if the moves can be made in batches
+        /*! Subclasses that evaluate the Boltzmann weights of insertions and removals with the current particle data
+            must return false, because the particle data only changes at the end of a batch.
+        */
+        virtual bool isBatchSupported()
+            {
+            return true;
+            }
+
         /*! Try removing a particle
             \param timestep Current time step
             \param tag Tag of particle being removed
@@ -213,9 +336,32 @@ class UpdaterMuVT : public Updater
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange();
 
+        //! Method to be called when the global number of particles changes
+        void slotGlobalParticleNumberChange()
+            {
+            if (!m_updating_type_map)
+                m_type_map_dirty = true;
+            }
+
         //! Map particles by type
         virtual void mapTypes();
 
+        //! Add a particle to the index of its type
+        void addTypeMapTag(unsigned int tag, unsigned int type);
+
+        //! Remove a particle from the index of its type
+        void removeTypeMapTag(unsigned int tag, unsigned int type);
+
+        //! Insert a particle into the system
+        unsigned int addParticle(unsigned int type, const vec3<Scalar>& pos, const quat<Scalar>& orientation,
+            bool has_orientation);
+
+        //! Remove a particle from the system
+        void removeParticle(unsigned int tag, unsigned int type);
+
+        //! Change the type of a particle
+        void setParticleType(unsigned int tag, unsigned int type, unsigned int new_type);
+
         //! Get the nth particle of a given type
         /*! \param type the requested type of the particle
          *  \param type_offs offset of the particle in the list of particles per type
@@ -239,6 +385,8 @@ template < class Shape > void export_UpdaterMuVT(pybind11::module& m, const std:
           .def("setMoveRatio", &UpdaterMuVT<Shape>::setMoveRatio)
           .def("setTransferRatio", &UpdaterMuVT<Shape>::setTransferRatio)
           .def("setTransferTypes", &UpdaterMuVT<Shape>::setTransferTypes)
+          .def("setBatchSize", &UpdaterMuVT<Shape>::setBatchSize)
+          .def("getBatchSize", &UpdaterMuVT<Shape>::getBatchSize)
           ;
     }
 
@@ -254,13 +402,15 @@ UpdaterMuVT<Shape>::UpdaterMuVT(std::shared_ptr<SystemDefinition> sysdef,
     unsigned int seed,
     unsigned int npartition)
     : Updater(sysdef), m_mc(mc), m_seed(seed), m_npartition(npartition), m_gibbs(false),
-      m_max_vol_rescale(0.1), m_move_ratio(0.5), m_transfer_ratio(1.0), m_gibbs_other(0)
+      m_max_vol_rescale(0.1), m_move_ratio(0.5), m_transfer_ratio(1.0), m_gibbs_other(0),
+      m_type_map_dirty(true), m_updating_type_map(false), m_batch_size(1)
     {
     m_fugacity.resize(m_pdata->getNTypes(), std::shared_ptr<Variant>(new VariantConst(0.0)));
     m_type_map.resize(m_pdata->getNTypes());
 
     m_pdata->getNumTypesChangeSignal().template connect<UpdaterMuVT<Shape>, &UpdaterMuVT<Shape>::slotNumTypesChange>(this);
-    m_pdata->getParticleSortSignal().template connect<UpdaterMuVT<Shape>, &UpdaterMuVT<Shape>::mapTypes>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().template connect<UpdaterMuVT<Shape>,
+        &UpdaterMuVT<Shape>::slotGlobalParticleNumberChange>(this);
 
     if (npartition > 1)
         {
@@ -300,9 +450,6 @@ UpdaterMuVT<Shape>::UpdaterMuVT(std::shared_ptr<SystemDefinition> sysdef,
         {
         throw std::runtime_error("2D runs not supported with update.muvt().");
         }
-
-    // initialize list of tags per type
-    mapTypes();
     }
 
 //! Destructor
@@ -310,77 +457,155 @@ template<class Shape>
 UpdaterMuVT<Shape>::~UpdaterMuVT()
     {
     m_pdata->getNumTypesChangeSignal().template disconnect<UpdaterMuVT<Shape>, &UpdaterMuVT<Shape>::slotNumTypesChange>(this);
-    m_pdata->getParticleSortSignal().template disconnect<UpdaterMuVT<Shape>, &UpdaterMuVT<Shape>::mapTypes>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().template disconnect<UpdaterMuVT<Shape>,
+        &UpdaterMuVT<Shape>::slotGlobalParticleNumberChange>(this);
     }
 
+/*! The index lists the tags of every type in increasing order. It is built from the local particles of all ranks with
+    one collective call, so that it is identical on all ranks.
+*/
 template<class Shape>
 void UpdaterMuVT<Shape>::mapTypes()
     {
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
+    m_exec_conf->msg->notice(8) << "UpdaterMuVT: building the type index" << std::endl;
+
+    // type of every tag, UINT_MAX for unused tags
+    unsigned int ntags = m_pdata->getNGlobal() ? m_pdata->getMaximumTag() + 1 : 0;
+    std::vector<unsigned int> tag_type(ntags, UINT_MAX);
+
+    unsigned int nptl = m_pdata->getN();
+    for (unsigned int idx = 0; idx < nptl; idx++)
+        {
+        assert(h_tag.data[idx] < ntags);
+        tag_type[h_tag.data[idx]] = __scalar_as_int(h_postype.data[idx].w);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition() && ntags)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &tag_type.front(), ntags, MPI_UNSIGNED, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
     assert(m_pdata->getNTypes() == m_type_map.size());
     for (unsigned int itype = 0; itype < m_pdata->getNTypes(); ++itype)
         {
         m_type_map[itype].clear();
         }
 
-    unsigned int nptl = m_pdata->getN();
-    for (unsigned int idx = 0; idx < nptl; idx++)
+    m_type_map_pos.resize(ntags);
+    for (unsigned int tag = 0; tag < ntags; tag++)
         {
-        unsigned int typei = __scalar_as_int(h_postype.data[idx].w);
-        unsigned int tag = h_tag.data[idx];
+        unsigned int typei = tag_type[tag];
+        if (typei == UINT_MAX)
+            continue;
 
         // store tag in per-type list
         assert(m_type_map.size() > typei);
+        m_type_map_pos[tag] = m_type_map[typei].size();
         m_type_map[typei].push_back(tag);
         }
+
+    m_type_map_dirty = false;
     }
 
+/*! \param tag Tag of the particle
+    \param type Type of the particle
+*/
 template<class Shape>
-unsigned int UpdaterMuVT<Shape>::getNthTypeTag(unsigned int type, unsigned int type_offs)
+void UpdaterMuVT<Shape>::addTypeMapTag(unsigned int tag, unsigned int type)
     {
-    unsigned int tag = UINT_MAX;
+    if (tag >= m_type_map_pos.size())
+        m_type_map_pos.resize(tag+1);
 
-    assert(m_type_map.size() > type);
-    #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        // get number of particles of given type
-        unsigned int nptl = m_type_map[type].size();
+    m_type_map_pos[tag] = m_type_map[type].size();
+    m_type_map[type].push_back(tag);
+    }
 
-        // have to initialize correctly for prefix sum
-        unsigned int begin_offs=0;
-        unsigned int end_offs=0;
+/*! \param tag Tag of the particle
+    \param type Type of the particle
 
-        // exclusive scan
-        MPI_Exscan(&nptl, &begin_offs, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+    The last particle in the list of the type takes the place of the removed one.
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::removeTypeMapTag(unsigned int tag, unsigned int type)
+    {
+    assert(tag < m_type_map_pos.size());
+    unsigned int pos = m_type_map_pos[tag];
+    assert(pos < m_type_map[type].size() && m_type_map[type][pos] == tag);
+
+    unsigned int last = m_type_map[type].back();
+    m_type_map[type][pos] = last;
+    m_type_map_pos[last] = pos;
+    m_type_map[type].pop_back();
+    }
 
-        // inclusive scan
-        MPI_Scan(&nptl, &end_offs, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+/*! \param type Type of the new particle
+    \param pos Position of the new particle
+    \param orientation Orientation of the new particle
+    \param has_orientation True if the orientation should be set
+    \returns Tag of the new particle
+*/
+template<class Shape>
+unsigned int UpdaterMuVT<Shape>::addParticle(unsigned int type, const vec3<Scalar>& pos, const quat<Scalar>& orientation,
+    bool has_orientation)
+    {
+    // create a new particle with given type
+    m_updating_type_map = true;
+    unsigned int tag = m_pdata->addParticle(type);
+    m_updating_type_map = false;
 
-        bool is_local = type_offs >= begin_offs && type_offs < end_offs;
+    // set the position of the particle
 
-        unsigned int rank = is_local ? m_exec_conf->getRank() : 0;
+    // setPosition() takes into account the grid shift, so subtract that one
+    Scalar3 p = vec_to_scalar3(pos)-m_pdata->getOrigin();
+    int3 tmp = make_int3(0,0,0);
+    m_pdata->getGlobalBox().wrap(p,tmp);
+    m_pdata->setPosition(tag, p);
+    if (has_orientation)
+        {
+        m_pdata->setOrientation(tag, quat_to_scalar4(orientation));
+        }
 
-        MPI_Allreduce(MPI_IN_PLACE, &rank, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
-        assert(rank == m_exec_conf->getRank() || !is_local);
+    addTypeMapTag(tag, type);
+    return tag;
+    }
 
-        // broadcast the chosen particle tag
-        if (is_local)
-            {
-            assert(type_offs - begin_offs < m_type_map[type].size());
-            tag = m_type_map[type][type_offs - begin_offs];
-            }
+/*! \param tag Tag of the particle to remove
+    \param type Type of the particle
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::removeParticle(unsigned int tag, unsigned int type)
+    {
+    removeTypeMapTag(tag, type);
 
-        MPI_Bcast(&tag, 1, MPI_UNSIGNED, rank, m_exec_conf->getMPICommunicator());
-        }
-    else
-    #endif
-        {
-        assert(type_offs < m_type_map[type].size());
-        tag = m_type_map[type][type_offs];
-        }
+    m_updating_type_map = true;
+    m_pdata->removeParticle(tag);
+    m_updating_type_map = false;
+    }
+
+/*! \param tag Tag of the particle
+    \param type Current type of the particle
+    \param new_type New type of the particle
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::setParticleType(unsigned int tag, unsigned int type, unsigned int new_type)
+    {
+    m_pdata->setType(tag, new_type);
+
+    removeTypeMapTag(tag, type);
+    addTypeMapTag(tag, new_type);
+    }
+
+template<class Shape>
+unsigned int UpdaterMuVT<Shape>::getNthTypeTag(unsigned int type, unsigned int type_offs)
+    {
+    assert(m_type_map.size() > type);
+    assert(type_offs < m_type_map[type].size());
+    unsigned int tag = m_type_map[type][type_offs];
 
     assert(tag <= m_pdata->getMaximumTag());
     return tag;
@@ -390,15 +615,7 @@ template<class Shape>
 unsigned int UpdaterMuVT<Shape>::getNumParticlesType(unsigned int type)
     {
     assert(type < m_type_map.size());
-    unsigned int nptl_type = m_type_map[type].size();
-
-    #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        MPI_Allreduce(MPI_IN_PLACE, &nptl_type, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
-        }
-    #endif
-    return nptl_type;
+    return m_type_map[type].size();
     }
 
 //! Destructor
@@ -408,6 +625,7 @@ void UpdaterMuVT<Shape>::slotNumTypesChange()
     // resize parameter list
     m_fugacity.resize(m_pdata->getNTypes(), std::shared_ptr<Variant>(new VariantConst(0.0)));
     m_type_map.resize(m_pdata->getNTypes());
+    m_type_map_dirty = true;
     }
 
 /*! Set new box and scale positions
@@ -457,6 +675,10 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
 
     m_exec_conf->msg->notice(10) << "UpdaterMuVT update: " << timestep << std::endl;
 
+    // rebuild the index of particles per type if particles were added or removed by someone else
+    if (m_type_map_dirty)
+        mapTypes();
+
     // initialize random number generator
     #ifdef ENABLE_MPI
     unsigned int group = (m_exec_conf->getPartition()/m_npartition);
@@ -537,7 +759,24 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
         {
         bool transfer_move = (rng.f() <= m_transfer_ratio);
 
-        if (transfer_move)
+        if (transfer_move && m_batch_size > 1)
+            {
+            if (m_gibbs)
+                {
+                #ifdef ENABLE_MPI
+                m_exec_conf->msg->notice(10) << "UpdaterMuVT: Gibbs ensemble transfer batch " << src << "<->" << dest
+                    << " " << timestep << " (Gibbs ensemble partition " << m_exec_conf->getPartition() % m_npartition
+                    << ")" << std::endl;
+                #endif
+
+                updateTransferBatch(timestep, rng.u32(), mod);
+                }
+            else
+                {
+                updateBatch(timestep, rng.u32());
+                }
+            }
+        else if (transfer_move)
             {
             #ifdef ENABLE_MPI
             if (m_gibbs)
@@ -693,23 +932,7 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                     if (accept)
                         {
                         // insertion was successful
-
-                        // create a new particle with given type
-                        unsigned int tag;
-
-                        tag = m_pdata->addParticle(type);
-
-                        // set the position of the particle
-
-                        // setPosition() takes into account the grid shift, so subtract that one
-                        Scalar3 p = vec_to_scalar3(pos_test)-m_pdata->getOrigin();
-                        int3 tmp = make_int3(0,0,0);
-                        m_pdata->getGlobalBox().wrap(p,tmp);
-                        m_pdata->setPosition(tag, p);
-                        if (shape_test.hasOrientation())
-                            {
-                            m_pdata->setOrientation(tag, quat_to_scalar4(shape_test.orientation));
-                            }
+                        addParticle(type, pos_test, shape_test.orientation, shape_test.hasOrientation());
                         m_count_total.insert_accept_count++;
                         }
                     else
@@ -839,7 +1062,7 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                 if (accept)
                     {
                     // remove particle
-                    m_pdata->removeParticle(tag);
+                    removeParticle(tag, type);
                     m_count_total.remove_accept_count++;
                     }
                 else
@@ -971,7 +1194,7 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                     if (accept)
                         {
                         // update the type
-                        m_pdata->setType(tag, other_type);
+                        setParticleType(tag, type, other_type);
 
                         // we have changed types, notify particle data
                         m_pdata->notifyParticleSort();
@@ -1067,7 +1290,7 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                     if (accept)
                         {
                         // update the type
-                        m_pdata->setType(tag, type);
+                        setParticleType(tag, other_type, type);
 
                         // we have changed types, notify particle data
                         m_pdata->notifyParticleSort();
@@ -1264,14 +1487,632 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
     if (m_prof) m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \param batch_seed Seed of the batch, drawn from the random number generator of update()
+
+    The updater makes m_batch_size insertion or removal moves. The random numbers of every move are drawn from their own
+    generator, and all trial insertions are first checked for overlaps with the current configuration in parallel. The
+    moves are then accepted or rejected one after the other, in the same way as in update(): particles removed earlier
+    in the batch are ignored and particles inserted earlier in the batch are taken into account. The particle data is
+    changed only at the end of the batch.
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::updateBatch(unsigned int timestep, unsigned int batch_seed)
+    {
+    if (m_prof) m_prof->push("batch");
+
+    assert(m_transfer_types.size() > 0);
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    Scalar V = global_box.getVolume();
+
+    // draw the parameters of all moves
+    std::vector<Saru> rngs;
+    std::vector<unsigned int> move_insert(m_batch_size);
+    std::vector<unsigned int> move_type(m_batch_size);
+    std::vector<vec3<Scalar> > move_pos(m_batch_size);
+    std::vector<quat<Scalar> > move_orientation(m_batch_size);
+    rngs.reserve(m_batch_size);
+
+    for (unsigned int k = 0; k < m_batch_size; ++k)
+        {
+        rngs.push_back(Saru(k, batch_seed, 0x7c4ad3e1));
+        Saru& rng = rngs.back();
+
+        move_insert[k] = rand_select(rng, 1);
+        move_type[k] = m_transfer_types[rand_select(rng, m_transfer_types.size()-1)];
+
+        if (move_insert[k])
+            {
+            // Propose a random position uniformly in the box
+            Scalar3 f;
+            f.x = rng.template s<Scalar>();
+            f.y = rng.template s<Scalar>();
+            f.z = rng.template s<Scalar>();
+            move_pos[k] = vec3<Scalar>(global_box.makeCoordinates(f));
+
+            Shape shape_test(quat<Scalar>(), params[move_type[k]]);
+            if (shape_test.hasOrientation())
+                {
+                move_orientation[k] = generateRandomOrientation(rng);
+                }
+            }
+        }
+
+    // check all trial insertions against the current configuration
+    const detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
+    const std::vector<vec3<Scalar> >&image_list = m_mc->updateImageList();
+
+    std::vector<unsigned int> overlap(m_batch_size, 0);
+    unsigned int err_count = 0;
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+
+        #pragma omp parallel for schedule(dynamic) reduction(+:err_count)
+        for (int k = 0; k < (int)m_batch_size; ++k)
+            {
+            if (move_insert[k])
+                {
+                overlap[k] = checkOverlap(move_type[k], move_pos[k], move_orientation[k], aabb_tree, image_list,
+                    h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data, NULL, NULL, err_count);
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &overlap.front(), m_batch_size, MPI_UNSIGNED, MPI_MAX,
+            m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    // accepted insertions get temporary tags past the largest tag in use
+    unsigned int first_new_tag = m_pdata->getNGlobal() ? m_pdata->getMaximumTag() + 1 : 0;
+    std::vector<unsigned int> inserted;         // accepted insertions, as move index
+    std::vector<bool> inserted_removed;         // true if the inserted particle was removed again
+    std::vector<bool> removed(first_new_tag, false);
+    std::vector<unsigned int> removed_tags;
+
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+
+    for (unsigned int k = 0; k < m_batch_size; ++k)
+        {
+        Saru& rng = rngs[k];
+        unsigned int type = move_type[k];
+        unsigned int nptl_type = getNumParticlesType(type);
+
+        // get fugacity value
+        Scalar fugacity = m_fugacity[type]->getValue(timestep);
+
+        // sanity check
+        if (fugacity <= Scalar(0.0))
+            {
+            m_exec_conf->msg->error() << "Fugacity has to be greater than zero." << std::endl;
+            throw std::runtime_error("Error in UpdaterMuVT");
+            }
+
+        if (move_insert[k])
+            {
+            bool nonzero = true;
+
+            if (overlap[k] && removed_tags.size())
+                {
+                // the overlapping particles may have been removed earlier in this batch
+                ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+                ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+                ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+                overlap[k] = checkOverlap(type, move_pos[k], move_orientation[k], aabb_tree, image_list,
+                    h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data, &removed, NULL, err_count);
+
+                #ifdef ENABLE_MPI
+                if (m_comm)
+                    {
+                    MPI_Allreduce(MPI_IN_PLACE, &overlap[k], 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+                    }
+                #endif
+                }
+
+            if (overlap[k])
+                nonzero = false;
+
+            // check against the particles inserted earlier in this batch
+            for (unsigned int i = 0; nonzero && i < inserted.size(); ++i)
+                {
+                unsigned int p = inserted[i];
+                if (!inserted_removed[i] && checkTrialOverlap(type, move_pos[k], move_orientation[k],
+                    move_type[p], move_pos[p], move_orientation[p], image_list, h_overlaps.data, err_count))
+                    {
+                    nonzero = false;
+                    }
+                }
+
+            // apply acceptance criterium
+            bool accept = false;
+            if (nonzero)
+                {
+                Scalar lnboltzmann = log(fugacity*V/(Scalar)(nptl_type+1));
+                accept = (rng.template s<Scalar>() < exp(lnboltzmann));
+                }
+
+            if (accept)
+                {
+                addTypeMapTag(first_new_tag + inserted.size(), type);
+                inserted.push_back(k);
+                inserted_removed.push_back(false);
+                m_count_total.insert_accept_count++;
+                }
+            else
+                {
+                m_count_total.insert_reject_count++;
+                }
+            }
+        else
+            {
+            bool accept = false;
+            unsigned int tag = UINT_MAX;
+
+            if (nptl_type)
+                {
+                // get random tag of given type
+                // (this may be the temporary tag of a particle inserted earlier in this batch)
+                unsigned int type_offset = rand_select(rng, nptl_type-1);
+                tag = m_type_map[type][type_offset];
+
+                // apply acceptance criterium
+                Scalar lnboltzmann = -log(fugacity) + log((Scalar)nptl_type/V);
+                accept = (rng.f() < exp(lnboltzmann));
+                }
+
+            if (accept)
+                {
+                removeTypeMapTag(tag, type);
+                if (tag >= first_new_tag)
+                    {
+                    inserted_removed[tag - first_new_tag] = true;
+                    }
+                else
+                    {
+                    removed[tag] = true;
+                    removed_tags.push_back(tag);
+                    }
+                m_count_total.remove_accept_count++;
+                }
+            else
+                {
+                m_count_total.remove_reject_count++;
+                }
+            }
+        }
+
+    // apply the accepted moves to the particle data
+    m_updating_type_map = true;
+    for (unsigned int i = 0; i < removed_tags.size(); ++i)
+        {
+        m_pdata->removeParticle(removed_tags[i]);
+        }
+
+    // look up the index positions of the temporary tags before they are reused
+    std::vector<unsigned int> inserted_pos(inserted.size());
+    for (unsigned int i = 0; i < inserted.size(); ++i)
+        {
+        if (!inserted_removed[i])
+            inserted_pos[i] = m_type_map_pos[first_new_tag + i];
+        }
+
+    for (unsigned int i = 0; i < inserted.size(); ++i)
+        {
+        if (inserted_removed[i])
+            continue;
+
+        unsigned int k = inserted[i];
+        unsigned int type = move_type[k];
+        unsigned int tag = m_pdata->addParticle(type);
+
+        // setPosition() takes into account the grid shift, so subtract that one
+        Scalar3 p = vec_to_scalar3(move_pos[k])-m_pdata->getOrigin();
+        int3 tmp = make_int3(0,0,0);
+        global_box.wrap(p,tmp);
+        m_pdata->setPosition(tag, p);
+
+        Shape shape_test(move_orientation[k], params[type]);
+        if (shape_test.hasOrientation())
+            {
+            m_pdata->setOrientation(tag, quat_to_scalar4(move_orientation[k]));
+            }
+
+        // replace the temporary tag in the index
+        if (tag >= m_type_map_pos.size())
+            m_type_map_pos.resize(tag+1);
+        m_type_map[type][inserted_pos[i]] = tag;
+        m_type_map_pos[tag] = inserted_pos[i];
+        }
+    m_updating_type_map = false;
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param k Index of the move in the batch
+    \param batch_seed Seed of the batch
+    \param type Type of the trial particle
+    \param pos Position of the trial particle (return value)
+    \param orientation Orientation of the trial particle (return value)
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::drawTransferTrial(unsigned int k, unsigned int batch_seed, unsigned int type,
+    vec3<Scalar>& pos, quat<Scalar>& orientation)
+    {
+    Saru rng(k, batch_seed, 0x5e2a09c1);
+
+    // Propose a random position uniformly in the box
+    Scalar3 f;
+    f.x = rng.template s<Scalar>();
+    f.y = rng.template s<Scalar>();
+    f.z = rng.template s<Scalar>();
+    pos = vec3<Scalar>(m_pdata->getGlobalBox().makeCoordinates(f));
+
+    orientation = quat<Scalar>();
+    Shape shape_test(orientation, m_mc->getParams()[type]);
+    if (shape_test.hasOrientation())
+        {
+        orientation = generateRandomOrientation(rng);
+        }
+    }
+
+/*! \param timestep Current time step
+    \param batch_seed Seed of the batch, the same in both boxes
+    \param mod 0 or 1, the index of this box in the pair
+    \param data The data to send to the other box (return value)
+
+    The trial particles of the moves into this box are checked for overlaps with the current configuration and with
+    each other. All overlaps are recorded, so that the other box can tell whether a trial insertion overlaps after the
+    earlier moves of the batch have been applied.
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::buildTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod,
+    detail::TransferBatchData& data)
+    {
+    const unsigned int n_transfer_types = m_transfer_types.size();
+
+    data.timestep = timestep;
+    data.volume = m_pdata->getGlobalBox().getVolume();
+    data.type_tags.resize(n_transfer_types);
+    for (unsigned int t = 0; t < n_transfer_types; ++t)
+        {
+        data.type_tags[t] = m_type_map[m_transfer_types[t]];
+        }
+    data.overlap_tags.assign(m_batch_size, std::vector<unsigned int>());
+    data.overlap_moves.assign(m_batch_size, std::vector<unsigned int>());
+
+    // draw the trial particles of the moves into this box
+    std::vector<unsigned int> moves;
+    std::vector<unsigned int> move_type;
+    std::vector<vec3<Scalar> > move_pos;
+    std::vector<quat<Scalar> > move_orientation;
+
+    for (unsigned int k = 0; k < m_batch_size; ++k)
+        {
+        Saru rng_move(k, batch_seed, 0x1b9f3a07);
+        unsigned int dest = rand_select(rng_move, 1);
+        unsigned int t = rand_select(rng_move, n_transfer_types-1);
+
+        if (dest == mod)
+            {
+            vec3<Scalar> pos;
+            quat<Scalar> orientation;
+            drawTransferTrial(k, batch_seed, m_transfer_types[t], pos, orientation);
+
+            moves.push_back(k);
+            move_type.push_back(m_transfer_types[t]);
+            move_pos.push_back(pos);
+            move_orientation.push_back(orientation);
+            }
+        }
+
+    const detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
+    const std::vector<vec3<Scalar> >&image_list = m_mc->updateImageList();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+
+    unsigned int err_count = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:err_count)
+    for (int i = 0; i < (int)moves.size(); ++i)
+        {
+        unsigned int k = moves[i];
+        checkOverlap(move_type[i], move_pos[i], move_orientation[i], aabb_tree, image_list, h_postype.data,
+            h_orientation.data, h_tag.data, h_overlaps.data, NULL, &data.overlap_tags[k], err_count);
+
+        for (unsigned int j = 0; j < (unsigned int)i; ++j)
+            {
+            if (checkTrialOverlap(move_type[i], move_pos[i], move_orientation[i], move_type[j], move_pos[j],
+                move_orientation[j], image_list, h_overlaps.data, err_count))
+                {
+                data.overlap_moves[k].push_back(moves[j]);
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        // combine the overlaps with the local particles of all ranks
+        std::vector<std::vector<std::vector<unsigned int> > > overlap_tags_rank;
+        gather_v(data.overlap_tags, overlap_tags_rank, 0, m_exec_conf->getMPICommunicator());
+
+        if (m_exec_conf->getRank() == 0)
+            {
+            for (unsigned int k = 0; k < m_batch_size; ++k)
+                {
+                std::vector<unsigned int>& overlap_tags = data.overlap_tags[k];
+                overlap_tags.clear();
+                for (unsigned int rank = 0; rank < overlap_tags_rank.size(); ++rank)
+                    {
+                    overlap_tags.insert(overlap_tags.end(), overlap_tags_rank[rank][k].begin(),
+                        overlap_tags_rank[rank][k].end());
+                    }
+
+                // ghost particles are seen by more than one rank
+                std::sort(overlap_tags.begin(), overlap_tags.end());
+                overlap_tags.erase(std::unique(overlap_tags.begin(), overlap_tags.end()), overlap_tags.end());
+                }
+            }
+        }
+    #endif
+    }
+
+/*! \param timestep Current time step
+    \param batch_seed Seed of the batch, the same in both boxes
+    \param mod 0 or 1, the index of this box in the pair
+    \param data_0 Data of box 0
+    \param data_1 Data of box 1
+
+    Both boxes make the same decisions from the same data. Every move transfers a particle of a random transfer type
+    from one box to the other, in a random direction, and is accepted or rejected in the same way as a single
+    transfer move in update(). The type index of both boxes is replicated, including the particles inserted and removed
+    earlier in the batch, so that the particles to remove and the overlaps of the trial insertions are known in both
+    boxes. Finally, the accepted moves are applied to this box.
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::applyTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod,
+    const detail::TransferBatchData& data_0, const detail::TransferBatchData& data_1)
+    {
+    const unsigned int n_transfer_types = m_transfer_types.size();
+    const detail::TransferBatchData *data[2] = {&data_0, &data_1};
+
+    if (data_0.type_tags.size() != n_transfer_types || data_1.type_tags.size() != n_transfer_types)
+        {
+        m_exec_conf->msg->error() << "UpdaterMuVT: The boxes transfer a different number of types." << std::endl;
+        throw std::runtime_error("Error in update.muvt.");
+        }
+
+    // the type index of both boxes, particles inserted in this batch get temporary tags past the largest tag
+    std::vector<std::vector<unsigned int> > type_tags[2];
+    std::vector<unsigned int> type_tags_pos[2];
+    std::vector<bool> removed[2];
+    std::vector<unsigned int> inserted[2];       // moves inserted into each box
+    unsigned int first_new_tag[2];
+
+    for (unsigned int b = 0; b < 2; ++b)
+        {
+        type_tags[b] = data[b]->type_tags;
+
+        first_new_tag[b] = 0;
+        for (unsigned int t = 0; t < n_transfer_types; ++t)
+            for (unsigned int i = 0; i < type_tags[b][t].size(); ++i)
+                first_new_tag[b] = std::max(first_new_tag[b], type_tags[b][t][i]+1);
+
+        type_tags_pos[b].resize(first_new_tag[b] + m_batch_size);
+        for (unsigned int t = 0; t < n_transfer_types; ++t)
+            for (unsigned int i = 0; i < type_tags[b][t].size(); ++i)
+                type_tags_pos[b][type_tags[b][t][i]] = i;
+
+        removed[b].assign(first_new_tag[b], false);
+        }
+
+    // true if the trial particle of a move is in its box
+    std::vector<bool> present(m_batch_size, false);
+
+    // the particles to remove from this box
+    std::vector<unsigned int> removed_tags;
+    std::vector<unsigned int> removed_types;
+
+    // the type of the particle of every move
+    std::vector<unsigned int> move_type(m_batch_size);
+
+    for (unsigned int k = 0; k < m_batch_size; ++k)
+        {
+        Saru rng_move(k, batch_seed, 0x1b9f3a07);
+        unsigned int dest = rand_select(rng_move, 1);
+        unsigned int t = rand_select(rng_move, n_transfer_types-1);
+        unsigned int src = 1 - dest;
+        move_type[k] = m_transfer_types[t];
+
+        unsigned int n_src = type_tags[src][t].size();
+        unsigned int n_dest = type_tags[dest][t].size();
+
+        bool accept = false;
+        unsigned int tag = UINT_MAX;
+
+        if (n_src)
+            {
+            // get random tag of given type
+            tag = type_tags[src][t][rand_select(rng_move, n_src-1)];
+
+            // the trial particle overlaps with particles not removed earlier in this batch
+            bool overlap = false;
+            const std::vector<unsigned int>& overlap_tags = data[dest]->overlap_tags[k];
+            for (unsigned int i = 0; i < overlap_tags.size() && !overlap; ++i)
+                {
+                unsigned int j = overlap_tags[i];
+                overlap = j >= removed[dest].size() || !removed[dest][j];
+                }
+
+            // and with the trial particles of earlier moves that are still in the box
+            const std::vector<unsigned int>& overlap_moves = data[dest]->overlap_moves[k];
+            for (unsigned int i = 0; i < overlap_moves.size() && !overlap; ++i)
+                {
+                overlap = present[overlap_moves[i]];
+                }
+
+            if (!overlap)
+                {
+                // apply acceptance criterium
+                Scalar lnboltzmann = log(data[dest]->volume/(Scalar)(n_dest+1))
+                    + log((Scalar)n_src/data[src]->volume);
+                accept = (rng_move.template s<Scalar>() < exp(lnboltzmann));
+                }
+            }
+
+        if (accept)
+            {
+            // remove the particle from the source box
+            unsigned int pos = type_tags_pos[src][tag];
+            unsigned int last = type_tags[src][t].back();
+            type_tags[src][t][pos] = last;
+            type_tags_pos[src][last] = pos;
+            type_tags[src][t].pop_back();
+
+            if (tag >= first_new_tag[src])
+                {
+                present[inserted[src][tag - first_new_tag[src]]] = false;
+                }
+            else
+                {
+                removed[src][tag] = true;
+                if (src == mod)
+                    {
+                    removed_tags.push_back(tag);
+                    removed_types.push_back(move_type[k]);
+                    }
+                }
+
+            // and insert it into the other box
+            unsigned int new_tag = first_new_tag[dest] + inserted[dest].size();
+            type_tags_pos[dest][new_tag] = type_tags[dest][t].size();
+            type_tags[dest][t].push_back(new_tag);
+            inserted[dest].push_back(k);
+            present[k] = true;
+            }
+
+        if (dest == mod)
+            {
+            if (accept)
+                m_count_total.insert_accept_count++;
+            else
+                m_count_total.insert_reject_count++;
+            }
+        else
+            {
+            if (accept)
+                m_count_total.remove_accept_count++;
+            else
+                m_count_total.remove_reject_count++;
+            }
+        }
+
+    // apply the accepted moves to this box
+    for (unsigned int i = 0; i < removed_tags.size(); ++i)
+        {
+        removeParticle(removed_tags[i], removed_types[i]);
+        }
+
+    for (unsigned int i = 0; i < inserted[mod].size(); ++i)
+        {
+        unsigned int k = inserted[mod][i];
+        if (!present[k])
+            continue;
+
+        unsigned int type = move_type[k];
+
+        vec3<Scalar> pos;
+        quat<Scalar> orientation;
+        drawTransferTrial(k, batch_seed, type, pos, orientation);
+
+        Shape shape_test(orientation, m_mc->getParams()[type]);
+        addParticle(type, pos, orientation, shape_test.hasOrientation());
+        }
+    }
+
+/*! \param timestep Current time step
+    \param batch_seed Seed of the batch, the same in both boxes
+    \param mod 0 or 1, the index of this box in the pair
+
+    Both boxes compute their part of the batch at the same time, and exchange it in a single non-blocking message.
+*/
+template<class Shape>
+void UpdaterMuVT<Shape>::updateTransferBatch(unsigned int timestep, unsigned int batch_seed, unsigned int mod)
+    {
+    if (m_prof) m_prof->push("transfer batch");
+
+    detail::TransferBatchData data, data_other;
+    buildTransferBatch(timestep, batch_seed, mod, data);
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getRank() == 0)
+        {
+        std::stringstream s(std::ios_base::out | std::ios_base::binary);
+        cereal::BinaryOutputArchive ar(s);
+        ar << data;
+        s.flush();
+        std::string send_buf = s.str();
+
+        // send our data while we wait for the data of the other box
+        MPI_Request req;
+        MPI_Isend((void *)send_buf.data(), send_buf.size(), MPI_BYTE, m_gibbs_other, 0, MPI_COMM_WORLD, &req);
+
+        MPI_Status stat;
+        MPI_Probe(m_gibbs_other, 0, MPI_COMM_WORLD, &stat);
+        int recv_count;
+        MPI_Get_count(&stat, MPI_BYTE, &recv_count);
+        std::vector<char> recv_buf(recv_count);
+        MPI_Recv(&recv_buf.front(), recv_count, MPI_BYTE, m_gibbs_other, 0, MPI_COMM_WORLD, &stat);
+
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+
+        // de-serialize
+        std::stringstream r(std::string(&recv_buf.front(), recv_count), std::ios_base::in | std::ios_base::binary);
+        cereal::BinaryInputArchive iar(r);
+        iar >> data_other;
+
+        if (data_other.timestep != timestep)
+            {
+            m_exec_conf->msg->error() << "UpdaterMuVT: Boxes are at different time steps " << timestep << " != "
+                << data_other.timestep << ". Aborting." << std::endl;
+            throw std::runtime_error("Error in update.muvt.");
+            }
+        }
+
+    if (m_comm)
+        {
+        bcast(data, 0, m_exec_conf->getMPICommunicator());
+        bcast(data_other, 0, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (mod == 0)
+        applyTransferBatch(timestep, batch_seed, mod, data, data_other);
+    else
+        applyTransferBatch(timestep, batch_seed, mod, data_other, data);
+
+    if (m_prof) m_prof->pop();
+    }
+
 template<class Shape>
 bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int type, vec3<Scalar> pos,
     quat<Scalar> orientation, Scalar &lnboltzmann)
     {
     lnboltzmann = Scalar(0.0);
 
-    unsigned int overlap = 0;
-
     // update the aabb tree
     const detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
 
@@ -1281,10 +2122,31 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
     // check for overlaps
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
 
-    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
+    unsigned int err_count = 0;
+    unsigned int overlap = checkOverlap(type, pos, orientation, aabb_tree, image_list, h_postype.data,
+        h_orientation.data, h_tag.data, h_overlaps.data, NULL, NULL, err_count);
 
-    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &overlap, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return !overlap;
+    }
+
+template<class Shape>
+bool UpdaterMuVT<Shape>::checkOverlap(unsigned int type, const vec3<Scalar>& pos, const quat<Scalar>& orientation,
+    const detail::AABBTree& aabb_tree, const std::vector<vec3<Scalar> >& image_list,
+    const Scalar4 *h_postype, const Scalar4 *h_orientation, const unsigned int *h_tag,
+    const unsigned int *h_overlaps, const std::vector<bool> *skip_tags, std::vector<unsigned int> *overlap_tags,
+    unsigned int& err_count)
+    {
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
     const Index2D& overlap_idx = m_mc->getOverlapIndexer();
 
     // read in the current position and orientation
@@ -1293,8 +2155,6 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
     // Check particle against AABB tree for neighbors
     detail::AABB aabb_local = shape.getAABB(vec3<Scalar>(0,0,0));
 
-    unsigned int err_count = 0;
-
     const unsigned int n_images = image_list.size();
     for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
         {
@@ -1304,12 +2164,13 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
             {
             // check for self-overlap with all images except the original
             vec3<Scalar> r_ij = pos - pos_image;
-            if (h_overlaps.data[overlap_idx(type, type)]
+            if (h_overlaps[overlap_idx(type, type)]
                 && check_circumsphere_overlap(r_ij, shape, shape)
                 && test_overlap(r_ij, shape, shape, err_count))
                 {
-                overlap = 1;
-                break;
+                if (overlap_tags)
+                    overlap_tags->push_back(UINT_MAX);
+                return true;
                 }
             }
 
@@ -1328,8 +2189,11 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
                         // read in its position and orientation
                         unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                        Scalar4 postype_j = h_postype.data[j];
-                        Scalar4 orientation_j = h_orientation.data[j];
+                        if (skip_tags && (*skip_tags)[h_tag[j]])
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        Scalar4 orientation_j = h_orientation[j];
 
                         // put particles in coordinate system of particle i
                         vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_image;
@@ -1337,12 +2201,14 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
                         unsigned int typ_j = __scalar_as_int(postype_j.w);
                         Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
 
-                        if (h_overlaps.data[overlap_idx(type, typ_j)]
+                        if (h_overlaps[overlap_idx(type, typ_j)]
                             && check_circumsphere_overlap(r_ij, shape, shape_j)
                             && test_overlap(r_ij, shape, shape_j, err_count))
                             {
-                            overlap = 1;
-                            break;
+                            if (!overlap_tags)
+                                return true;
+
+                            overlap_tags->push_back(h_tag[j]);
                             }
                         }
                     }
@@ -1352,27 +2218,49 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
                 // skip ahead
                 cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
                 }
-
-            if (overlap)
-                {
-                break;
-                }
             } // end loop over AABB nodes
-
-        if (overlap)
-            {
-            break;
-            }
         } // end loop over images
 
-    #ifdef ENABLE_MPI
-    if (m_comm)
+    return overlap_tags && overlap_tags->size();
+    }
+
+/*! \param type_a Type of the first particle
+    \param pos_a Position of the first particle
+    \param orientation_a Orientation of the first particle
+    \param type_b Type of the second particle
+    \param pos_b Position of the second particle
+    \param orientation_b Orientation of the second particle
+    \param image_list Image list of the integrator
+    \param h_overlaps Interaction matrix
+    \param err_count Overlap check error counter (incremented)
+    \returns True if the particles overlap
+*/
+template<class Shape>
+bool UpdaterMuVT<Shape>::checkTrialOverlap(unsigned int type_a, const vec3<Scalar>& pos_a,
+    const quat<Scalar>& orientation_a, unsigned int type_b, const vec3<Scalar>& pos_b,
+    const quat<Scalar>& orientation_b, const std::vector<vec3<Scalar> >& image_list, const unsigned int *h_overlaps,
+    unsigned int& err_count)
+    {
+    if (!h_overlaps[m_mc->getOverlapIndexer()(type_a, type_b)])
+        return false;
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
+    Shape shape_a(orientation_a, params[type_a]);
+    Shape shape_b(orientation_b, params[type_b]);
+
+    vec3<Scalar> r0 = vec3<Scalar>(m_pdata->getGlobalBox().minImage(vec_to_scalar3(pos_b - pos_a)));
+
+    for (unsigned int cur_image = 0; cur_image < image_list.size(); ++cur_image)
         {
-        MPI_Allreduce(MPI_IN_PLACE, &overlap, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+        vec3<Scalar> r_ij = r0 - image_list[cur_image];
+        if (check_circumsphere_overlap(r_ij, shape_a, shape_b)
+            && test_overlap(r_ij, shape_a, shape_b, err_count))
+            {
+            return true;
+            }
         }
-    #endif
 
-    return !overlap;
+    return false;
     }
 
 template<class Shape>
@@ -1510,6 +2398,8 @@ Scalar UpdaterMuVT<Shape>::getLogValue(const std::string& quantity, unsigned int
         std::string q = "hpmc_muvt_N_"+m_pdata->getNameByType(i);
         if (quantity == q)
             {
+            if (m_type_map_dirty)
+                mapTypes();
             return getNumParticlesType(i);
             }
         }
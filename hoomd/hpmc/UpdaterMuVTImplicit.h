@@ -79,6 +79,12 @@ class UpdaterMuVTImplicit : public UpdaterMuVT<Shape>
         virtual bool boxResizeAndScale(unsigned int timestep, const BoxDim old_box, const BoxDim new_box,
             unsigned int &extra_ndof);
 
+        //! The depletant free volume is evaluated with the current particle data, so moves cannot be batched
+        virtual bool isBatchSupported()
+            {
+            return false;
+            }
+
         /*! Try inserting depletants into space created by changing a particle type
          * \param timestep  time step
          * \param n_insert Number of depletants to insert
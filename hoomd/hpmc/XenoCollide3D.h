@@ -39,6 +39,8 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     \param q Orientation of shape B in frame A
     \param R Approximate radius of Minkowski difference for scaling tolerance value
     \param err_count Error counter to increment whenever an infinite loop is encountered
+    \param sep In/out: direction in frame A that separated the shapes in an earlier check, or zero. Set to a
+               separating direction when the shapes are disjoint, and left unchanged when they overlap.
     \returns true when the two shapes overlap and false when they are disjoint.
 
     XenoCollide is a generic algorithm for detecting overlaps between two shapes. It operates with the support function
@@ -57,6 +59,12 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     where particle *A* is at the origin, and particle *B* is at position *ab_t*. Particle A has orientation (1,0,0,0)
     and particle B has orientation *q*.
 
+    **Separating direction**
+    When the shapes only moved a little since an earlier check found them disjoint, the direction that separated them
+    then usually still does. A non-zero \a sep is tested first, and when the support point of the Minkowski difference
+    in that direction lies behind the origin, the shapes are disjoint after a single evaluation of the support
+    functions. Otherwise, the full algorithm runs.
+
     The recommended way of using this code is to specify the support functor in the same file as the shape data
     (e.g. ShapeConvexPolyhedron.h). Then include XenoCollide3D.h and call xenocollide_3d where needed.
 
@@ -73,7 +81,8 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
                                   const vec3<OverlapReal>& ab_t,
                                   const quat<OverlapReal>& q,
                                   const OverlapReal R,
-                                  unsigned int& err_count)
+                                  unsigned int& err_count,
+                                  vec3<OverlapReal>& sep)
     {
     // This implementation of XenoCollide is hand-written from the description of the algorithm on page 171 of _Games
     // Programming Gems 7_
@@ -90,6 +99,13 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         return true;
         }
 
+    // try the separating direction of an earlier check
+    if (sep.x != OverlapReal(0.0) || sep.y != OverlapReal(0.0) || sep.z != OverlapReal(0.0))
+        {
+        if (dot(S(sep), sep) < OverlapReal(0.0))
+            return false;
+        }
+
     // Phase 1: Portal Discovery
     // ------
     // Find the origin ray v0 from the origin to an interior point of the Minkowski difference.
@@ -104,7 +120,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
     /* if (dot(v1, v1 - v0) <= 0) // by convexity */
     if (dot(v1, v0) > OverlapReal(0.0))
+        {
+        sep = -v0;
         return false;   // origin is outside v1 support plane
+        }
 
     // find support v2 perpendicular to v0, v1 plane
     n = cross(v1, v0);
@@ -117,7 +136,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     v2 = S(n); // Convexity should guarantee ||v2|| > 0, but v2 == v1 may be possible in edge cases of {B}-{A}
     // particles do not overlap if origin outside v2 support plane
     if (dot(v2, n) < OverlapReal(0.0))
+        {
+        sep = n;
         return false;
+        }
 
     // Find next support direction perpendicular to plane (v1,v0,v2)
     n = cross(v1 - v0, v2 - v0);
@@ -145,7 +167,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // Get the next support point
         v3 = S(n);
         if (dot(v3, n) <= 0)
+            {
+            sep = n;
             return false; // check if origin outside v3 support plane
+            }
 
         // If origin lies on opposite side of a plane from the third support point, use outer-facing plane normal
         // to find a new support point.
@@ -199,6 +224,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // if (origin outside support plane) return false
         if (dot(v4, n) < OverlapReal(0.0))
             {
+            sep = n;
             return false;
             }
 
@@ -211,7 +237,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         // First, check if v4 is on plane (v2,v1,v3)
         if (fabs(d) < tol)
+            {
+            sep = n;
             return false; // no more refinement possible, but not intersection detected
+            }
 
         // Second, check if origin is on plane (v2,v1,v3) and has been missed by other checks
         d = dot(v1 * tol_multiplier, n);
@@ -278,6 +307,32 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         }
     }
+
+//! XenoCollide overlap check in 3D
+/*! \tparam SupportFuncA Support function class type for shape A
+    \tparam SupportFuncB Support function class type for shape B
+    \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever an infinite loop is encountered
+    \returns true when the two shapes overlap and false when they are disjoint.
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
+                                  const SupportFuncB& sb,
+                                  const vec3<OverlapReal>& ab_t,
+                                  const quat<OverlapReal>& q,
+                                  const OverlapReal R,
+                                  unsigned int& err_count)
+    {
+    vec3<OverlapReal> sep(0,0,0);
+    return xenocollide_3d(sa, sb, ab_t, q, R, err_count, sep);
+    }
+
 } // end namespace hpmc::detail
 
 }; // end namespace hpmc
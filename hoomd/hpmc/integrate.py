@@ -184,6 +184,7 @@ class mode_hpmc(_integrator):
     def __init__(self, implicit):
         _integrator.__init__(self);
         self.implicit=implicit
+        self.event_chain=False
 
         # setup the shape parameters
         self.shape_param = data.param_dict(self); # must call initialize_shape_params() after the cpp_integrator is created.
@@ -368,7 +369,10 @@ class mode_hpmc(_integrator):
                    nselect=None,
                    nR=None,
                    depletant_type=None,
-                   ntrial=None):
+                   ntrial=None,
+                   separation_cache=None,
+                   chain_length=None,
+                   reflect=None):
         R""" Changes parameters of an existing integration mode.
 
         Args:
@@ -379,6 +383,14 @@ class mode_hpmc(_integrator):
             nR (int): (if set) **Implicit depletants only**: Number density of implicit depletants in free volume.
             depletant_type (str): (if set) **Implicit depletants only**: Particle type to use as implicit depletant.
             ntrial (int): (if set) **Implicit depletants only**: Number of re-insertion attempts per overlapping depletant.
+            separation_cache (bool): (if set) **CPU only**: Remember the direction that separated each pair of particles
+                in the last overlap check and try it first in the next trial move of either particle. This speeds up
+                dense systems of :py:class:`convex_polyhedron`, :py:class:`convex_spheropolyhedron` and
+                :py:class:`faceted_sphere`, and has no effect on other shapes.
+            chain_length (float): (if set) **Event chains only**: Total displacement of each event chain.
+            reflect (bool): (if set) **Event chains only**: Reflect the direction of the chains at every collision
+                instead of moving along the box axes. Only supported by :py:class:`sphere`. The pressure is only
+                measured by straight chains.
         """
 
         hoomd.util.print_status_line();
@@ -410,6 +422,9 @@ class mode_hpmc(_integrator):
         if nselect is not None:
             self.cpp_integrator.setNSelect(nselect);
 
+        if separation_cache is not None:
+            self.cpp_integrator.setSeparationCache(separation_cache);
+
         if self.implicit:
             if nR is not None:
                 self.implicit_params.append('nR')
@@ -424,6 +439,14 @@ class mode_hpmc(_integrator):
         elif any([p is not None for p in [nR,depletant_type,ntrial]]):
             hoomd.context.msg.warning("Implicit depletant parameters not supported by this integrator.\n")
 
+        if self.event_chain:
+            if chain_length is not None:
+                self.cpp_integrator.setChainLength(chain_length)
+            if reflect is not None:
+                self.cpp_integrator.setReflect(reflect)
+        elif any([p is not None for p in [chain_length,reflect]]):
+            hoomd.context.msg.warning("Event chain parameters not supported by this integrator.\n")
+
     def map_overlaps(self):
         R""" Build an overlap map of the system
 
@@ -635,6 +658,17 @@ def setA(cpp_integrator,a):
         for i in range(hoomd.context.current.system_definition.getParticleData().getNTypes()):
             cpp_integrator.setA(a,i);
 
+## Helper method to check that event chains are supported with the given options
+def check_event_chain(implicit, event_chain):
+    if not event_chain:
+        return
+    if implicit:
+        hoomd.context.msg.error("Event chains are not supported with implicit depletants.\n");
+        raise RuntimeError('Error initializing HPMC integrator');
+    if hoomd.context.exec_conf.isCUDAEnabled():
+        hoomd.context.msg.error("Event chains are not supported on the GPU.\n");
+        raise RuntimeError('Error initializing HPMC integrator');
+
 class sphere(mode_hpmc):
     R""" HPMC integration for spheres (2D/3D).
 
@@ -643,9 +677,18 @@ class sphere(mode_hpmc):
         d (float): Maximum move displacement, Scalar to set for all types, or a dict containing {type:size} to set by type.
         nselect (int): The number of trial moves to perform in each cell.
         implicit (bool): Flag to enable implicit depletants.
+        event_chain (bool): Flag to move the particles with event chains (CPU only).
 
     Hard particle Monte Carlo integration method for spheres.
 
+    With *event_chain=True*, every time step runs N event chains instead of local trial moves. Each chain starts at a
+    random particle, which moves along the chain direction until it hits another particle, which then continues the
+    chain. A chain ends when the total displacement reaches *chain_length* (see :py:meth:`set_params`). All moves are
+    accepted. The free flight between two collision checks is limited to *d*, which should be about the particle
+    diameter. Event chains log the pressure as **hpmc_ec_pressure** (measured by the chains of the last step) and
+    the average number of collisions per chain as **hpmc_ec_events_per_chain**. Event chains do not support
+    external fields, implicit depletants or domain decomposition.
+
     Sphere parameters:
 
     * *diameter* (**required**) - diameter of the sphere (distance units)
@@ -669,18 +712,29 @@ class sphere(mode_hpmc):
         mc.set_param(nselect=8,nR=3,depletant_type='B')
         mc.shape_param.set('A', diameter=1.0)
         mc.shape_param.set('B', diameter=.1)
+
+    Event Chain Example::
+
+        mc = hpmc.integrate.sphere(seed=415236, d=1.0, event_chain=True)
+        mc.set_params(chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
+        log = analyze.log(filename=None, quantities=['hpmc_ec_pressure'], period=10)
     """
 
-    def __init__(self, seed, d=0.1, nselect=4, implicit=False):
+    def __init__(self, seed, d=0.1, nselect=4, implicit=False, event_chain=False):
         hoomd.util.print_status_line();
 
         # initialize base class
         mode_hpmc.__init__(self,implicit);
+        check_event_chain(implicit, event_chain);
+        self.event_chain = event_chain;
 
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
             if(implicit):
                 self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitSphere(hoomd.context.current.system_definition, seed)
+            elif event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoECSphere(hoomd.context.current.system_definition, seed);
             else:
                 self.cpp_integrator = _hpmc.IntegratorHPMCMonoSphere(hoomd.context.current.system_definition, seed);
         else:
@@ -1141,6 +1195,8 @@ class convex_polyhedron(mode_hpmc):
         implicit (bool): Flag to enable implicit depletants.
         max_verts (int): Set the maximum number of vertices in a polyhedron.
             * .. deprecated:: 2.2
+        event_chain (bool): Flag to move the particles with straight event chains (CPU only), see :py:class:`sphere`.
+            The rotations are still made as trial moves, one per particle and time step.
 
     Convex polyhedron parameters:
 
@@ -1174,7 +1230,7 @@ class convex_polyhedron(mode_hpmc):
         mc.shape_param.set('A', vertices=[(0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (-0.5, 0.5, -0.5), (-0.5, -0.5, 0.5)]);
         mc.shape_param.set('B', vertices=[(0.05, 0.05, 0.05), (0.05, -0.05, -0.05), (-0.05, 0.05, -0.05), (-0.05, -0.05, 0.05)]);
     """
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, max_verts=None):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, max_verts=None, event_chain=False):
         hoomd.util.print_status_line();
 
         if max_verts is not None:
@@ -1182,11 +1238,15 @@ class convex_polyhedron(mode_hpmc):
 
         # initialize base class
         mode_hpmc.__init__(self,implicit);
+        check_event_chain(implicit, event_chain);
+        self.event_chain = event_chain;
 
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
             if(implicit):
                 self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitConvexPolyhedron(hoomd.context.current.system_definition, seed);
+            elif event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoECConvexPolyhedron(hoomd.context.current.system_definition, seed);
             else:
                 self.cpp_integrator = _hpmc.IntegratorHPMCMonoConvexPolyhedron(hoomd.context.current.system_definition, seed);
         else:
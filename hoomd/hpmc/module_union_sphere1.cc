@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere1(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 1, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 1> >(m, "UpdaterMuVTSphereUnion1");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 1> >(m, "UpdaterMuVTImplicitSphereUnion1");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 1> >(m, "UpdaterClustersSphereUnion1");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 1> >(m, "UpdaterClustersImplicitSphereUnion1");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 1> >(m, "ExternalFieldSphereUnion1");
     export_LatticeField<ShapeUnion<ShapeSphere, 1> >(m, "ExternalFieldLatticeSphereUnion1");
@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere16(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 16, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 16> >(m, "UpdaterMuVTSphereUnion16");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 16> >(m, "UpdaterMuVTImplicitSphereUnion16");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 16> >(m, "UpdaterClustersSphereUnion16");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 16> >(m, "UpdaterClustersImplicitSphereUnion16");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 16> >(m, "ExternalFieldSphereUnion16");
     export_LatticeField<ShapeUnion<ShapeSphere, 16> >(m, "ExternalFieldLatticeSphereUnion16");
@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere2(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 2, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 2> >(m, "UpdaterMuVTSphereUnion2");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 2> >(m, "UpdaterMuVTImplicitSphereUnion2");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 2> >(m, "UpdaterClustersSphereUnion2");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 2> >(m, "UpdaterClustersImplicitSphereUnion2");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 2> >(m, "ExternalFieldSphereUnion2");
     export_LatticeField<ShapeUnion<ShapeSphere, 2> >(m, "ExternalFieldLatticeSphereUnion2");
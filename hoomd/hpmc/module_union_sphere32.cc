@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere32(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 32, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 32> >(m, "UpdaterMuVTSphereUnion32");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 32> >(m, "UpdaterMuVTImplicitSphereUnion32");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 32> >(m, "UpdaterClustersSphereUnion32");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 32> >(m, "UpdaterClustersImplicitSphereUnion32");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 32> >(m, "ExternalFieldSphereUnion32");
     export_LatticeField<ShapeUnion<ShapeSphere, 32> >(m, "ExternalFieldLatticeSphereUnion32");
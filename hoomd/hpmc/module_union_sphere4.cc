@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere4(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 4, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 4> >(m, "UpdaterMuVTSphereUnion4");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 4> >(m, "UpdaterMuVTImplicitSphereUnion4");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 4> >(m, "UpdaterClustersSphereUnion4");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 4> >(m, "UpdaterClustersImplicitSphereUnion4");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 4> >(m, "ExternalFieldSphereUnion4");
     export_LatticeField<ShapeUnion<ShapeSphere, 4> >(m, "ExternalFieldLatticeSphereUnion4");
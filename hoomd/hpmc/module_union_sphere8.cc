@@ -19,6 +19,7 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterMuVTImplicit.h"
+#include "UpdaterClustersImplicit.h"
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
@@ -44,6 +45,8 @@ void export_union_sphere8(py::module& m)
     // export_AnalyzerSDF< ShapeUnion<ShapeSphere, 8, > >(m, "AnalyzerSDFSphereUnion");
     export_UpdaterMuVT< ShapeUnion<ShapeSphere, 8> >(m, "UpdaterMuVTSphereUnion8");
     export_UpdaterMuVTImplicit< ShapeUnion<ShapeSphere, 8> >(m, "UpdaterMuVTImplicitSphereUnion8");
+    export_UpdaterClusters< ShapeUnion<ShapeSphere, 8> >(m, "UpdaterClustersSphereUnion8");
+    export_UpdaterClustersImplicit< ShapeUnion<ShapeSphere, 8> >(m, "UpdaterClustersImplicitSphereUnion8");
 
     export_ExternalFieldInterface<ShapeUnion<ShapeSphere, 8> >(m, "ExternalFieldSphereUnion8");
     export_LatticeField<ShapeUnion<ShapeSphere, 8> >(m, "ExternalFieldLatticeSphereUnion8");
@@ -0,0 +1,102 @@
+from hoomd import *
+from hoomd import deprecated
+from hoomd import hpmc
+
+import unittest
+
+import math
+
+context.initialize()
+
+class clusters_updater_test(unittest.TestCase):
+    def tearDown(self):
+        del self.clusters
+        del self.mc
+        del self.system
+        context.initialize()
+
+    def test_spheres(self):
+        self.system = deprecated.init.create_random(N=1000,phi_p=0.3,min_dist=1.0,seed=12345)
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.set_params(d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+
+        self.clusters = hpmc.update.clusters(mc=self.mc, seed=456)
+        self.clusters.set_params(move_ratio=0.5)
+        log = analyze.log(filename=None, quantities=['hpmc_clusters_avg_size', 'hpmc_clusters_moved_fraction'], period=10)
+
+        run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+        self.assertGreater(log.query('hpmc_clusters_avg_size'), 0)
+
+    def test_spheres_equilibrium(self):
+        self.system = deprecated.init.create_random(N=1000,phi_p=0.3,min_dist=1.0,seed=12345)
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.set_params(d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        log = analyze.log(filename=None, quantities=['hpmc_translate_acceptance'], period=5)
+
+        self.clusters = hpmc.update.clusters(mc=self.mc, seed=456)
+
+        # the acceptance of local moves at fixed d is an equilibrium average, which must not change when cluster
+        # moves are added. It varies by about 0.001 between runs of 100 samples.
+        def avg_acceptance():
+            run(100)
+            nsample = 100
+            avg = 0.0
+            for i in range(nsample):
+                run(5)
+                avg += log.query('hpmc_translate_acceptance')
+            return avg/nsample
+
+        self.clusters.disable()
+        acc_local = avg_acceptance()
+        self.clusters.enable()
+        acc_clusters = avg_acceptance()
+
+        self.assertAlmostEqual(acc_clusters, acc_local, delta=0.01)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_convex_polyhedron(self):
+        self.system = deprecated.init.create_random(N=500,phi_p=0.1,min_dist=2.0,seed=12345)
+        self.mc = hpmc.integrate.convex_polyhedron(seed=10);
+        self.mc.shape_param.set("A", vertices=[(-0.5,-0.5,-0.5),
+                                               (-0.5,0.5,-0.5),
+                                               (-0.5,-0.5,0.5),
+                                               (-0.5,0.5,0.5),
+                                               (0.5,-0.5,-0.5),
+                                               (0.5,0.5,-0.5),
+                                               (0.5,-0.5,0.5),
+                                               (0.5,0.5,0.5)]);
+
+        self.clusters = hpmc.update.clusters(mc=self.mc, seed=456)
+
+        run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_convex_polygon(self):
+        self.system = deprecated.init.create_random(N=500,phi_p=0.3,min_dist=1.5,seed=12345,dimensions=2)
+        self.mc = hpmc.integrate.convex_polygon(seed=10);
+        self.mc.shape_param.set("A", vertices=[(-0.5,-0.5), (0.5,-0.5), (0.5,0.5), (-0.5,0.5)]);
+
+        self.clusters = hpmc.update.clusters(mc=self.mc, seed=456)
+
+        run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_implicit_spheres(self):
+        self.system = deprecated.init.create_random(N=1000,phi_p=0.2,min_dist=1.0,seed=12345)
+        self.system.particles.types.add('B')
+        self.mc = hpmc.integrate.sphere(seed=123,implicit=True)
+        self.mc.set_params(d=0.1)
+        self.mc.set_params(nR=4.0/(math.pi/6.0*0.2**3),depletant_type='B')
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=0.2)
+
+        self.clusters = hpmc.update.clusters(mc=self.mc, seed=456)
+
+        run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
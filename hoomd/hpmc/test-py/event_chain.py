@@ -0,0 +1,72 @@
+from hoomd import *
+from hoomd import deprecated
+from hoomd import hpmc
+
+import unittest
+
+import math
+
+context.initialize()
+
+class event_chain_test(unittest.TestCase):
+    def tearDown(self):
+        del self.mc
+        del self.system
+        context.initialize()
+
+    def test_sphere_pressure(self):
+        phi = 0.3
+        self.system = deprecated.init.create_random(N=500,phi_p=phi,min_dist=1.0,seed=12345)
+        self.mc = hpmc.integrate.sphere(seed=123,d=1.0,event_chain=True)
+        self.mc.set_params(chain_length=2.0)
+        self.mc.shape_param.set('A', diameter=1.0)
+        log = analyze.log(filename=None, quantities=['hpmc_ec_pressure'], period=2)
+
+        # equilibrate
+        run(100)
+
+        # the pressure of a single step scatters by about 1.5%, so that 100 steps measure it to about 0.15%
+        nsample = 100
+        avg_p = 0.0
+        for i in range(nsample):
+            run(2)
+            avg_p += log.query('hpmc_ec_pressure')
+        avg_p /= nsample
+
+        # Carnahan-Starling equation of state
+        rho = 6.0*phi/math.pi
+        Z = (1.0 + phi + phi**2 - phi**3)/(1.0 - phi)**3
+        self.assertAlmostEqual(avg_p/(rho*Z), 1.0, delta=0.01)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_sphere_reflect(self):
+        self.system = deprecated.init.create_random(N=500,phi_p=0.3,min_dist=1.0,seed=12345)
+        self.mc = hpmc.integrate.sphere(seed=123,d=1.0,event_chain=True)
+        self.mc.set_params(chain_length=2.0, reflect=True)
+        self.mc.shape_param.set('A', diameter=1.0)
+
+        run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_convex_polyhedron(self):
+        self.system = deprecated.init.create_random(N=500,phi_p=0.1,min_dist=2.0,seed=12345)
+        self.mc = hpmc.integrate.convex_polyhedron(seed=10,d=1.0,a=0.2,event_chain=True)
+        self.mc.set_params(chain_length=2.0)
+        self.mc.shape_param.set("A", vertices=[(-0.5,-0.5,-0.5),
+                                               (-0.5,0.5,-0.5),
+                                               (-0.5,-0.5,0.5),
+                                               (-0.5,0.5,0.5),
+                                               (0.5,-0.5,-0.5),
+                                               (0.5,0.5,-0.5),
+                                               (0.5,-0.5,0.5),
+                                               (0.5,0.5,0.5)]);
+        log = analyze.log(filename=None, quantities=['hpmc_ec_events_per_chain'], period=10)
+
+        # check along the way, an overlap left by a missed collision would persist
+        for i in range(10):
+            run(20)
+            self.assertEqual(self.mc.count_overlaps(), 0)
+        self.assertGreater(log.query('hpmc_ec_events_per_chain'), 0)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
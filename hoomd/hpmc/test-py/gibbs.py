@@ -16,8 +16,6 @@ class gibbs_ensemble_test(unittest.TestCase):
         p = comm.get_partition()
         self.system = deprecated.init.create_random(N=128,phi_p=0.2,min_dist=1.0,seed=12345+p)
         self.system.particles.types.add('B')
-        self.mc = hpmc.integrate.sphere(seed=123+p,implicit=True)
-        self.mc.set_params(d=0.1)
 
     def tearDown(self):
         del self.mc
@@ -31,6 +29,8 @@ class gibbs_ensemble_test(unittest.TestCase):
         ntrial = 20
         p = comm.get_partition()
 
+        self.mc = hpmc.integrate.sphere(seed=123+p,implicit=True)
+        self.mc.set_params(d=0.1)
         self.mc.set_params(ntrial=ntrial)
         nR = etap/(math.pi/6.0*math.pow(q,3.0))
         self.mc.set_params(nR=nR,depletant_type='B')
@@ -46,5 +46,39 @@ class gibbs_ensemble_test(unittest.TestCase):
 
         run(100)
 
+    def test_spheres_batch(self):
+        p = comm.get_partition()
+
+        self.mc = hpmc.integrate.sphere(seed=123+p)
+        self.mc.set_params(d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=1.0)
+
+        # needs to be run with 2 partitions
+        muvt=hpmc.update.muvt(mc=self.mc,seed=456,ngibbs=2,transfer_types=['A'])
+
+        muvt.set_params(dV=0.01)
+        muvt.set_params(move_ratio=.01)
+        muvt.set_params(batch=50)
+
+        log = analyze.log(filename=None, quantities=['hpmc_muvt_insert_acceptance', 'hpmc_muvt_remove_acceptance'],
+                          period=None)
+
+        N_before = self.total_num_particles('A')
+        run(100)
+        N_after = self.total_num_particles('A')
+
+        # the transfer moves conserve the total number of particles in both boxes
+        self.assertEqual(N_before, N_after)
+
+        # particles were moved in both directions
+        self.assertGreater(log.query('hpmc_muvt_insert_acceptance'), 0)
+        self.assertGreater(log.query('hpmc_muvt_remove_acceptance'), 0)
+
+    # sum the number of particles of the given type over all partitions, with one rank per partition
+    def total_num_particles(self, type):
+        n = len([pt for pt in self.system.particles if pt.type == type])
+        return int(comm.sum_all(n))
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
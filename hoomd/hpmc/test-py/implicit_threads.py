@@ -0,0 +1,68 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import deprecated
+from hoomd import hpmc
+import numpy
+import math
+import unittest
+
+context.initialize()
+
+# This test is run with OMP_NUM_THREADS=1, which moves the particles one after another, and with OMP_NUM_THREADS=4,
+# which moves them in parallel on a checkerboard of cells (see CMakeLists.txt). Both code paths have to sample the
+# same equilibrium.
+
+# mean number of neighbors within the depletant contact distance, measured with the serial code path
+# (100 samples of 1000 particles, it varies by about 0.015 between runs)
+nn_ref = 1.89
+
+class implicit_threads_test(unittest.TestCase):
+    def setUp(self):
+        self.system = deprecated.init.create_random(N=1000,phi_p=0.2,min_dist=1.0,seed=12345)
+        self.system.particles.types.add('B')
+
+        q = 0.2
+        etap = 0.05
+        self.mc = hpmc.integrate.sphere(seed=123,implicit=True)
+        self.mc.set_params(d=0.1)
+        self.mc.set_params(nR=etap/(math.pi/6.0*q**3),depletant_type='B')
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=q)
+        self.r_cut = 1.0 + q
+
+    def tearDown(self):
+        del self.mc
+        del self.system
+        context.initialize()
+
+    # count the pairs of particles closer than the depletant contact distance
+    def mean_neighbors(self):
+        snap = self.system.take_snapshot()
+        pos = snap.particles.position
+        L = numpy.array([snap.box.Lx, snap.box.Ly, snap.box.Lz])
+
+        n_pairs = 0
+        for i in range(snap.particles.N-1):
+            dr = pos[i+1:] - pos[i]
+            dr -= L*numpy.round(dr/L)
+            n_pairs += numpy.count_nonzero(numpy.sum(dr*dr, axis=1) < self.r_cut**2)
+        return 2.0*n_pairs/snap.particles.N
+
+    def test_equilibrium(self):
+        # equilibrate
+        run(100)
+
+        nsample = 100
+        avg_nn = 0.0
+        for i in range(nsample):
+            run(5)
+            self.assertEqual(self.mc.count_overlaps(), 0)
+            avg_nn += self.mean_neighbors()
+        avg_nn /= nsample
+
+        # without depletants, the value is 1.78
+        self.assertAlmostEqual(avg_nn, nn_ref, delta=0.04)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -32,6 +32,20 @@ class muvt_updater_test(unittest.TestCase):
 
         run(100)
 
+    def test_spheres_batch(self):
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.set_params(d=0.1)
+
+        self.mc.shape_param.set('A', diameter=1.0)
+
+        self.muvt=hpmc.update.muvt(mc=self.mc,seed=456,transfer_types=['A'])
+        self.muvt.set_fugacity('A', 100)
+        self.muvt.set_params(batch=50)
+
+        run(100)
+
+        self.assertRaises(RuntimeError, self.muvt.set_params, batch=0)
+
     def test_convex_polyhedron(self):
         self.mc = hpmc.integrate.convex_polyhedron(seed=10);
         self.mc.shape_param.set("A", vertices=[(-2,-1,-1),
@@ -111,5 +125,57 @@ class muvt_updater_test(unittest.TestCase):
 
         run(100)
 
+class muvt_ideal_gas_test(unittest.TestCase):
+    def setUp(self):
+        snap = data.make_snapshot(N=1, box=data.boxdim(L=10), particle_types=['A','B'])
+        self.system = init.read_snapshot(snap)
+
+        # without overlap checks, the spheres form an ideal gas
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.set_params(d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=1.0)
+        self.mc.overlap_checks.set('A', 'A', enable=False)
+        self.mc.overlap_checks.set('A', 'B', enable=False)
+        self.mc.overlap_checks.set('B', 'B', enable=False)
+
+    def tearDown(self):
+        del self.muvt
+        del self.mc
+        del self.system
+        context.initialize()
+
+    # the mean number of particles of an ideal gas is <N> = z V for every type
+    def check_density(self, batch):
+        z = 0.02
+        V = 1000
+
+        self.muvt=hpmc.update.muvt(mc=self.mc,seed=456,transfer_types=['A','B'])
+        self.muvt.set_fugacity('A', z)
+        self.muvt.set_fugacity('B', z)
+        self.muvt.set_params(batch=batch)
+
+        log = analyze.log(filename=None, quantities=['hpmc_muvt_N_A', 'hpmc_muvt_N_B'], period=None)
+        run(1000)
+
+        N_A = []
+        N_B = []
+        def sample(timestep):
+            N_A.append(log.query('hpmc_muvt_N_A'))
+            N_B.append(log.query('hpmc_muvt_N_B'))
+        analyze.callback(callback=sample, period=10)
+        run(20000)
+
+        # N fluctuates with variance z V = 20 and relaxes within a few tens of steps. The standard error of the
+        # means is 0.36 with single moves (0.11 with batches of 20), the tolerance is four standard errors.
+        self.assertAlmostEqual(sum(N_A)/len(N_A), z*V, delta=1.5)
+        self.assertAlmostEqual(sum(N_B)/len(N_B), z*V, delta=1.5)
+
+    def test_density(self):
+        self.check_density(batch=1)
+
+    def test_density_batch(self):
+        self.check_density(batch=20)
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
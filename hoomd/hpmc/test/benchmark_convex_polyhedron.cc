@@ -0,0 +1,123 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file benchmark_convex_polyhedron.cc
+    \brief Compares the cost of the support function implementations of ShapeConvexPolyhedron
+
+    Usage: benchmark_convex_polyhedron [n_calls]
+
+    For random convex polyhedra with increasing numbers of vertices, prints the time per support function call and per
+    overlap check of pairs close to contact, once searching all vertices and once hill climbing on the convex hull.
+*/
+
+#include "hoomd/hpmc/IntegratorHPMC.h"
+#include "hoomd/hpmc/Moves.h"
+#include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "hoomd/ClockSource.h"
+#include "hoomd/extern/saruprng.h"
+
+using namespace hpmc;
+using namespace std;
+using namespace hpmc::detail;
+
+unsigned int err_count = 0;
+
+//! Build a convex polyhedron from \a N random vertices on (or slightly inside) the unit sphere
+poly3d_verts setup_random_verts(unsigned int N, Saru& rng)
+    {
+    poly3d_verts result(N, false);
+    result.ignore = 0;
+
+    OverlapReal radius_sq = OverlapReal(0.0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        vec3<OverlapReal> v(rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f));
+        v = v / sqrt(dot(v,v));
+        if (i % 5 == 0)
+            v = v * OverlapReal(0.9);
+        result.x[i] = v.x;
+        result.y[i] = v.y;
+        result.z[i] = v.z;
+        radius_sq = std::max(radius_sq, dot(v, v));
+        }
+    for (unsigned int i = N; i < result.N; i++)
+        {
+        result.x[i] = 0;
+        result.y[i] = 0;
+        result.z[i] = 0;
+        }
+    result.diameter = 2*sqrt(radius_sq);
+
+    return result;
+    }
+
+int main(int argc, char **argv)
+    {
+    unsigned int n_calls = 200000;
+    if (argc > 1)
+        n_calls = atoi(argv[1]);
+    const unsigned int n_pairs = n_calls / 10;
+
+    Saru rng(11);
+    vector< vec3<OverlapReal> > directions;
+    for (unsigned int i = 0; i < 1024; i++)
+        directions.push_back(vec3<OverlapReal>(rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f)));
+
+    unsigned int sizes[] = {16, 64, 256, 1024, 4096};
+    for (unsigned int s = 0; s < sizeof(sizes)/sizeof(unsigned int); s++)
+        {
+        poly3d_verts verts = setup_random_verts(sizes[s], rng);
+        poly3d_verts verts_hull = verts;
+        // time the hill climbing also below HULL_MIN_VERTS
+        verts_hull.hull = make_hull_adjacency(verts_hull, 4);
+
+        SupportFuncConvexPolyhedron sa(verts);
+        SupportFuncConvexPolyhedron sb(verts_hull);
+
+        // sum the results so that the calls are not optimized away
+        OverlapReal sum_a = 0, sum_b = 0;
+        ClockSource clk;
+        for (unsigned int i = 0; i < n_calls; i++)
+            sum_a += sa(directions[i % 1024]).x;
+        int64_t t_a = clk.getTime();
+        for (unsigned int i = 0; i < n_calls; i++)
+            sum_b += sb(directions[i % 1024]).x;
+        int64_t t_b = clk.getTime() - t_a;
+
+        // overlap checks of pairs close to contact
+        vector< vec3<Scalar> > r(1024);
+        vector< quat<Scalar> > q(1024);
+        for (unsigned int i = 0; i < 1024; i++)
+            {
+            vec3<Scalar> dir(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0));
+            r[i] = dir * (rng.s(1.5,2.0) / sqrt(dot(dir,dir)));
+            q[i] = quat<Scalar>(rng.s(-1.0,1.0), vec3<Scalar>(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0)));
+            q[i] = q[i] * fast::rsqrt(norm2(q[i]));
+            }
+
+        unsigned int n_overlap_a = 0, n_overlap_b = 0;
+        ShapeConvexPolyhedron a(quat<Scalar>(), verts);
+        ShapeConvexPolyhedron b(quat<Scalar>(), verts_hull);
+        clk = ClockSource();
+        for (unsigned int i = 0; i < n_pairs; i++)
+            n_overlap_a += test_overlap(r[i % 1024], a, ShapeConvexPolyhedron(q[i % 1024], verts), err_count);
+        int64_t t_overlap_a = clk.getTime();
+        for (unsigned int i = 0; i < n_pairs; i++)
+            n_overlap_b += test_overlap(r[i % 1024], b, ShapeConvexPolyhedron(q[i % 1024], verts_hull), err_count);
+        int64_t t_overlap_b = clk.getTime() - t_overlap_a;
+
+        cout << sizes[s] << " vertices: support function " << double(t_a)/n_calls << " ns (search all), "
+             << double(t_b)/n_calls << " ns (hill climbing); overlap test " << double(t_overlap_a)/n_pairs
+             << " ns (search all), " << double(t_overlap_b)/n_pairs << " ns (hill climbing)";
+        if (n_overlap_a != n_overlap_b || fabs(sum_a - sum_b) > 1e-2*fabs(sum_a))
+            cout << " MISMATCH";
+        cout << endl;
+        }
+
+    return 0;
+    }
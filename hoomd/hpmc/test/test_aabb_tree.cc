@@ -101,3 +101,47 @@ UP_TEST( bigger )
         UP_ASSERT(in(i, hits));
         }
     }
+
+UP_TEST( refit )
+    {
+    const unsigned int N = 1000;
+    Saru rng(2);
+
+    std::vector< vec3<Scalar> > points(N);
+    AABB aabbs[N];
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(rng.f(), rng.f(), rng.f()) * Scalar(100);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+
+    AABBTree tree;
+    tree.buildTree(aabbs, N);
+    UP_ASSERT_EQUAL(tree.getNumParticles(), N);
+
+    // shrink the box and refit the tree to the scaled points
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] *= Scalar(0.9);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+    tree.refit(aabbs, N);
+
+    // every point is found, and the query for a point outside all AABBs finds nothing
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+
+    hits.clear();
+    tree.query(hits, AABB(vec3<Scalar>(95,95,95), Scalar(0.01)));
+    UP_ASSERT_EQUAL(hits.size(), 0);
+
+    // the root bounds the refit AABBs tightly
+    AABB root = tree.getNodeAABB(0);
+    vec3<Scalar> upper = root.getUpper();
+    UP_ASSERT(upper.x <= Scalar(91.0));
+    }
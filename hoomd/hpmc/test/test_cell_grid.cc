@@ -0,0 +1,106 @@
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+
+#include "hoomd/hpmc/CellGrid.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+
+#include "hoomd/VectorMath.h"
+#include "hoomd/extern/saruprng.h"
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Check that every pair closer than width is found in the neighbor cells, and that each particle is in its cell
+void check_grid(const CellGrid& grid, const BoxDim& box, const std::vector<Scalar4>& postype, Scalar width)
+    {
+    unsigned int N = postype.size();
+
+    unsigned int total = 0;
+    for (unsigned int cell = 0; cell < grid.getNumCells(); cell++)
+        {
+        total += grid.getCellSize(cell);
+        for (unsigned int k = 0; k < grid.getCellSize(cell); k++)
+            UP_ASSERT_EQUAL(grid.getParticleCell(grid.getCellParticles(cell)[k]), cell);
+        }
+    UP_ASSERT_EQUAL(total, N);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        UP_ASSERT_EQUAL(grid.getParticleCell(i), grid.getCell(vec3<Scalar>(postype[i])));
+
+        const unsigned int *nbr_cells = grid.getNeighborCells(grid.getParticleCell(i));
+        for (unsigned int j = 0; j < N; j++)
+            {
+            vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(postype[j]) - vec3<Scalar>(postype[i]))));
+            if (dot(r_ij, r_ij) >= width*width)
+                continue;
+
+            bool found = false;
+            for (unsigned int n = 0; n < grid.getNumNeighborCells(); n++)
+                if (grid.getParticleCell(j) == nbr_cells[n])
+                    found = true;
+            UP_ASSERT(found);
+            }
+        }
+    }
+
+UP_TEST( build_and_move )
+    {
+    Saru rng(3);
+    BoxDim box(8.0, 7.0, 9.0);
+    box.setTiltFactors(0.3, -0.2, 0.1);
+    const Scalar width = 1.1;
+
+    CellGrid grid;
+    UP_ASSERT(grid.setup(box, width, 3));
+    UP_ASSERT_EQUAL(grid.getNumNeighborCells(), (unsigned int)27);
+
+    const unsigned int N = 500;
+    std::vector<Scalar4> postype(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar3 f = make_scalar3(rng.s(0.0,1.0), rng.s(0.0,1.0), rng.s(0.0,1.0));
+        vec3<Scalar> r(box.makeCoordinates(f));
+        postype[i] = vec_to_scalar4(r, 0);
+        }
+
+    grid.build(&postype[0], N);
+    check_grid(grid, box, postype, width);
+
+    // move particles, some of them slightly out of the box, and crowd many into one cell to grow the cells
+    for (unsigned int k = 0; k < 2000; k++)
+        {
+        unsigned int i = rng.u32() % N;
+        vec3<Scalar> r(postype[i]);
+        if (k % 4 == 0)
+            r = vec3<Scalar>(box.makeCoordinates(make_scalar3(0.05, 0.05, 0.05)));
+        else
+            r += vec3<Scalar>(rng.s(-0.5,0.5), rng.s(-0.5,0.5), rng.s(-0.5,0.5));
+        postype[i] = vec_to_scalar4(r, 0);
+        grid.move(i, grid.getCell(r));
+        }
+    check_grid(grid, box, postype, width);
+    }
+
+UP_TEST( small_box )
+    {
+    CellGrid grid;
+
+    // 3D boxes need 3 cells in every direction
+    UP_ASSERT(!grid.setup(BoxDim(8.0, 8.0, 2.5), 1.0, 3));
+    UP_ASSERT(grid.setup(BoxDim(8.0, 8.0, 3.0), 1.0, 3));
+
+    // 2D boxes only in x and y
+    BoxDim box_2d(8.0, 3.0, 0.5);
+    UP_ASSERT(grid.setup(box_2d, 1.0, 2));
+    UP_ASSERT_EQUAL(grid.getNumNeighborCells(), (unsigned int)9);
+    UP_ASSERT_EQUAL(grid.getDim().z, (unsigned int)1);
+    }
@@ -16,6 +16,8 @@ HOOMD_UP_MAIN();
 
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
+#include "hoomd/extern/saruprng.h"
+
 using namespace hpmc;
 using namespace std;
 using namespace hpmc::detail;
@@ -620,3 +622,103 @@ UP_TEST( overlap_cube_rot3 )
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
 
     }
+
+//! Make a polyhedron of N random points near the unit sphere, some of which are inside the hull
+poly3d_verts setup_random_verts(unsigned int N, Saru& rng)
+    {
+    vector< vec3<OverlapReal> > vlist;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        vec3<OverlapReal> v(rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f));
+        v = v / sqrt(dot(v,v));
+        if (i % 5 == 0)
+            v = v * OverlapReal(0.9);
+        vlist.push_back(v);
+        }
+    return setup_verts(vlist);
+    }
+
+UP_TEST( overlap_separating_direction )
+    {
+    Saru rng(5);
+    poly3d_verts verts = setup_random_verts(64, rng);
+
+    // move and rotate b in small steps around a, keeping the separating direction between the checks
+    vec3<OverlapReal> sep;
+    vec3<Scalar> r_ab(2.0, 0.0, 0.0);
+    quat<Scalar> q_a, q_b;
+    unsigned int n_overlap = 0;
+    for (unsigned int i = 0; i < 2000; i++)
+        {
+        r_ab += vec3<Scalar>(rng.s(-0.05,0.05), rng.s(-0.05,0.05), rng.s(-0.05,0.05));
+        r_ab = r_ab * (rng.s(1.6,2.4) / sqrt(dot(r_ab,r_ab)));
+        move_rotate(q_a, rng, 0.1, 3);
+        move_rotate(q_b, rng, 0.1, 3);
+
+        ShapeConvexPolyhedron a(q_a, verts);
+        ShapeConvexPolyhedron b(q_b, verts);
+
+        bool overlap = test_overlap(r_ab, a, b, err_count);
+        UP_ASSERT_EQUAL(test_overlap(r_ab, a, b, err_count, sep), overlap);
+        UP_ASSERT(overlap || dot(sep, sep) > 0);
+        n_overlap += overlap;
+        }
+
+    // the steps cross from overlapping to disjoint configurations
+    UP_ASSERT(n_overlap > 0);
+    UP_ASSERT(n_overlap < 2000);
+    }
+
+UP_TEST( support_hull )
+    {
+    Saru rng(7);
+
+    // random points and a cube lattice with many coplanar and interior points
+    vector<poly3d_verts> shapes;
+    shapes.push_back(setup_random_verts(200, rng));
+    vector< vec3<OverlapReal> > vlist;
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 5; j++)
+            for (int k = 0; k < 5; k++)
+                vlist.push_back(vec3<OverlapReal>(i-2, j-2, k-2));
+    shapes.push_back(setup_verts(vlist));
+
+    for (unsigned int s = 0; s < shapes.size(); s++)
+        {
+        poly3d_verts verts = shapes[s];
+        poly3d_verts verts_hull = shapes[s];
+        verts_hull.hull = make_hull_adjacency(verts_hull, 4);
+        UP_ASSERT(verts_hull.hull != NULL);
+        UP_ASSERT(verts_hull.hull->block_offset.size() == verts.N+2);
+
+        SupportFuncConvexPolyhedron sa(verts);
+        SupportFuncConvexPolyhedron sb(verts_hull);
+
+        // the support points may differ between vertices that are equally far along n
+        for (unsigned int i = 0; i < 1000; i++)
+            {
+            vec3<OverlapReal> n(rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f), rng.s(-1.0f,1.0f));
+            MY_CHECK_CLOSE(dot(n, sa(n)), dot(n, sb(n)), tol);
+            }
+
+        // and the overlap checks agree
+        ShapeConvexPolyhedron a(quat<Scalar>(), verts);
+        ShapeConvexPolyhedron b(quat<Scalar>(), verts_hull);
+        for (unsigned int i = 0; i < 1000; i++)
+            {
+            vec3<Scalar> r_ij(rng.s(-3.0,3.0), rng.s(-3.0,3.0), rng.s(-3.0,3.0));
+            quat<Scalar> q(rng.s(-1.0,1.0), vec3<Scalar>(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0)));
+            q = q * fast::rsqrt(norm2(q));
+            ShapeConvexPolyhedron a2(q, verts);
+            ShapeConvexPolyhedron b2(q, verts_hull);
+            UP_ASSERT_EQUAL(test_overlap(r_ij, a, a2, err_count), test_overlap(r_ij, b, b2, err_count));
+            }
+        }
+
+    // shapes with few vertices keep the vectorized search
+    poly3d_verts small = shapes[0];
+    UP_ASSERT(make_hull_adjacency(small) == NULL);
+
+    // shapes with the same vertices share their adjacency
+    UP_ASSERT(make_hull_adjacency(shapes[0], 4) == make_hull_adjacency(small, 4));
+    }
@@ -0,0 +1,121 @@
+
+
+#include "hoomd/hpmc/IntegratorHPMCMonoEC.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include <iostream>
+#include <string>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#include "hoomd/extern/saruprng.h"
+
+using namespace hpmc;
+using namespace std;
+using namespace hpmc::detail;
+
+unsigned int err_count;
+
+//! Build an axis aligned cube with the given edge length
+poly3d_verts setup_cube(OverlapReal a)
+    {
+    poly3d_verts result(8, false);
+    result.ignore = 0;
+    for (unsigned int k = 0; k < 8; k++)
+        {
+        result.x[k] = (k & 1) ? a/2 : -a/2;
+        result.y[k] = (k & 2) ? a/2 : -a/2;
+        result.z[k] = (k & 4) ? a/2 : -a/2;
+        }
+    result.diameter = a*sqrt(OverlapReal(3.0));
+    return result;
+    }
+
+UP_TEST( sphere_collision )
+    {
+    sph_params par;
+    par.radius = 0.5;
+    par.ignore = 0;
+    ShapeSphere a(quat<Scalar>(), par);
+    ShapeSphere b(quat<Scalar>(), par);
+
+    Scalar s = -1;
+
+    // head on
+    UP_ASSERT(ec_collision(vec3<Scalar>(3,0,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+    MY_CHECK_CLOSE(s, 2.0, tol);
+
+    // not reached
+    UP_ASSERT(!ec_collision(vec3<Scalar>(3,0,0), vec3<Scalar>(1,0,0), 1.5, a, b, s, err_count));
+
+    // off center
+    UP_ASSERT(ec_collision(vec3<Scalar>(3,0.6,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+    MY_CHECK_CLOSE(s, 3.0 - 0.8, tol);
+
+    // missed
+    UP_ASSERT(!ec_collision(vec3<Scalar>(3,1.1,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+
+    // behind
+    UP_ASSERT(!ec_collision(vec3<Scalar>(-3,0,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+
+    // touching spheres collide immediately only when moving towards each other
+    UP_ASSERT(ec_collision(vec3<Scalar>(1,0,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+    MY_CHECK_SMALL(s, tol_small);
+    UP_ASSERT(!ec_collision(vec3<Scalar>(1,0,0), vec3<Scalar>(-1,0,0), 5.0, a, b, s, err_count));
+    }
+
+UP_TEST( cube_collision )
+    {
+    poly3d_verts verts = setup_cube(1.0);
+    ShapeConvexPolyhedron a(quat<Scalar>(), verts);
+    ShapeConvexPolyhedron b(quat<Scalar>(), verts);
+
+    Scalar s = -1;
+
+    // face to face, closer than the circumspheres
+    UP_ASSERT(ec_collision(vec3<Scalar>(3,0.3,0.2), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+    MY_CHECK_CLOSE(s, 2.0, 1e-3);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(3-s,0.3,0.2), a, b, err_count));
+
+    // not reached
+    UP_ASSERT(!ec_collision(vec3<Scalar>(3,0.3,0.2), vec3<Scalar>(1,0,0), 1.9, a, b, s, err_count));
+
+    // passing by within the circumspheres
+    UP_ASSERT(!ec_collision(vec3<Scalar>(3,1.1,0), vec3<Scalar>(1,0,0), 5.0, a, b, s, err_count));
+
+    // a rotated cube is hit by its corner
+    quat<Scalar> q = quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), M_PI/4);
+    ShapeConvexPolyhedron c(q, verts);
+    UP_ASSERT(ec_collision(vec3<Scalar>(3,0,0), vec3<Scalar>(1,0,0), 5.0, a, c, s, err_count));
+    MY_CHECK_CLOSE(s, 3.0 - 0.5 - sqrt(0.5), 1e-3);
+    }
+
+UP_TEST( cube_bisect )
+    {
+    poly3d_verts verts = setup_cube(1.0);
+    ShapeConvexPolyhedron a(quat<Scalar>(), verts);
+    ShapeConvexPolyhedron b(quat<Scalar>(), verts);
+
+    // a move that ends overlapping is shortened to the contact
+    Scalar s = ec_bisect(vec3<Scalar>(3,0.3,0.2), vec3<Scalar>(1,0,0), 0.0, 2.5, a, b, err_count);
+    MY_CHECK_CLOSE(s, 2.0, 1e-3);
+    UP_ASSERT(s < 2.0);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(3-s,0.3,0.2), a, b, err_count));
+    }
+
+UP_TEST( exact_collision )
+    {
+    UP_ASSERT(ec_exact_collision<ShapeSphere>::value);
+    UP_ASSERT(!ec_exact_collision<ShapeConvexPolyhedron>::value);
+    }
+
+UP_TEST( reflect_support )
+    {
+    UP_ASSERT(ec_reflect_supported<ShapeSphere>::value);
+    UP_ASSERT(!ec_reflect_supported<ShapeConvexPolyhedron>::value);
+    }
@@ -0,0 +1,356 @@
+
+
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/hpmc/AnalyzerSDF.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/ShapeEllipsoid.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#include "hoomd/extern/saruprng.h"
+
+using namespace hpmc;
+using namespace std;
+using namespace hpmc::detail;
+
+unsigned int err_count;
+
+/*! \file test_sdf.cc
+    \brief Compares the bins and histograms of AnalyzerSDF with a plain bisection over all bins
+    \ingroup unit_tests
+*/
+
+//! Gives the tests access to the bins and the histogram of AnalyzerSDF
+template < class Shape >
+class AnalyzerSDFTester : public AnalyzerSDF<Shape>
+    {
+    public:
+        //! Constructs the tester
+        AnalyzerSDFTester(std::shared_ptr<SystemDefinition> sysdef,
+                          std::shared_ptr< IntegratorHPMCMono<Shape> > mc,
+                          double lmax,
+                          double dl)
+            : AnalyzerSDF<Shape>(sysdef, mc, lmax, dl, 1, "test_sdf.dat", true)
+            {
+            }
+
+        //! Determine the bin of a pair
+        int getBin(const vec3<Scalar>& r_ij,
+                   const quat<Scalar>& orientation_i,
+                   const quat<Scalar>& orientation_j,
+                   const typename Shape::param_type& params_i,
+                   const typename Shape::param_type& params_j,
+                   unsigned int max_bin)
+            {
+            return this->computeBin(r_ij, orientation_i, orientation_j, params_i, params_j, max_bin);
+            }
+
+        //! Count the histogram of the current configuration
+        std::vector<unsigned int> getHistogram()
+            {
+            this->zeroHistogram();
+            this->countHistogram(0);
+            return this->m_hist;
+            }
+
+        //! Check whether the histogram is counted with the cell grid
+        bool usesCellGrid()
+            {
+            Scalar max_diameter = this->m_mc->getMaxDiameter();
+            return this->buildCellGrid(max_diameter + this->m_lmax / (1 - this->m_lmax) * max_diameter);
+            }
+    };
+
+//! Find the bin of a pair by bisection over all bins below \a max_bin, as AnalyzerSDF did originally
+template < class Shape >
+int reference_bin(const vec3<Scalar>& r_ij,
+                  const quat<Scalar>& orientation_i,
+                  const quat<Scalar>& orientation_j,
+                  const typename Shape::param_type& params_i,
+                  const typename Shape::param_type& params_j,
+                  Scalar dl,
+                  unsigned int max_bin)
+    {
+    unsigned int L = 0;
+    unsigned int R = max_bin;
+    if (test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, L*dl))
+        return -1;
+    if (!test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, R*dl))
+        return R;
+
+    while ((R-L) > 1)
+        {
+        unsigned int m = (L+R)/2;
+        if (test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, m*dl))
+            R = m;
+        else
+            L = m;
+        }
+    return L;
+    }
+
+//! Draw a random unit quaternion
+quat<Scalar> random_orientation(Saru& rng)
+    {
+    quat<Scalar> q(rng.s(-1.0,1.0), vec3<Scalar>(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0)));
+    return q * fast::rsqrt(norm2(q));
+    }
+
+//! Check that the bins of random pairs agree with the reference, also when the search is limited to fewer bins
+/*! The overlap checks are in reduced precision, so pairs within rounding of a bin edge may land in the neighboring
+    bin. Those must be rare.
+*/
+template < class Shape >
+void sdf_bin_test(const std::vector<typename Shape::param_type>& params, bool orient)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(20.0), params.size(), 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<Shape> > mc(new IntegratorHPMCMono<Shape>(sysdef, 1));
+    for (unsigned int typ = 0; typ < params.size(); typ++)
+        mc->setParam(typ, params[typ]);
+
+    const Scalar lmax = 0.2, dl = 0.001;
+    const unsigned int n_bins = 200;
+    std::shared_ptr< AnalyzerSDFTester<Shape> > sdf(new AnalyzerSDFTester<Shape>(sysdef, mc, lmax, dl));
+
+    Saru rng(12345);
+    const unsigned int n_pairs = 20000;
+    unsigned int n_counted = 0, n_overlap = 0, n_edge = 0;
+    for (unsigned int k = 0; k < n_pairs; k++)
+        {
+        const typename Shape::param_type& params_i = params[rng.u32() % params.size()];
+        const typename Shape::param_type& params_j = params[rng.u32() % params.size()];
+        quat<Scalar> q_i = orient ? random_orientation(rng) : quat<Scalar>();
+        quat<Scalar> q_j = orient ? random_orientation(rng) : quat<Scalar>();
+        vec3<Scalar> dir(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0));
+
+        // aligned pairs close to the x or z axis touch near their circumspheres or inspheres, at the edges of the
+        // initial search window
+        if (k % 4 == 0)
+            {
+            q_i = q_j = quat<Scalar>();
+            dir = dir * Scalar(0.01) + ((k % 8 == 0) ? vec3<Scalar>(1,0,0) : vec3<Scalar>(0,0,1));
+            }
+
+        // distances from overlapping inspheres to beyond the reach of the last bin
+        Scalar d = Scalar(0.5) * (Shape(q_i, params_i).getCircumsphereDiameter()
+            + Shape(q_j, params_j).getCircumsphereDiameter());
+        vec3<Scalar> r_ij = dir * (d * rng.s(0.4,1.3) / sqrt(dot(dir,dir)));
+
+        // limit the search as when a smaller bin was already found for the particle
+        unsigned int max_bin = (k % 2) ? n_bins : rng.u32() % (n_bins + 1);
+
+        int ref = reference_bin<Shape>(r_ij, q_i, q_j, params_i, params_j, dl, n_bins);
+        if (ref > int(max_bin))
+            ref = max_bin;
+        int bin = sdf->getBin(r_ij, q_i, q_j, params_i, params_j, max_bin);
+
+        UP_ASSERT(bin <= int(max_bin));
+        if (ref < 0)
+            {
+            n_overlap++;
+            UP_ASSERT(bin <= 0);
+            }
+        else
+            {
+            if (ref < int(max_bin))
+                n_counted++;
+            UP_ASSERT(bin >= 0);
+            UP_ASSERT(std::abs(bin - ref) <= 1);
+            }
+        if (bin != ref)
+            n_edge++;
+        }
+
+    // make sure all paths were exercised
+    UP_ASSERT(n_counted > n_pairs / 10);
+    UP_ASSERT(n_overlap > n_pairs / 10);
+    UP_ASSERT(n_edge < n_pairs / 200);
+    }
+
+//! Place particles of the given types at random positions without overlaps
+template < class Shape >
+void place_random(std::shared_ptr<SystemDefinition> sysdef,
+                  const std::vector<typename Shape::param_type>& params,
+                  const std::vector<unsigned int>& types,
+                  bool orient)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    const BoxDim& box = pdata->getBox();
+    Scalar3 L = box.getL();
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+
+    Saru rng(54321);
+    for (unsigned int i = 0; i < types.size(); i++)
+        {
+        bool overlap = true;
+        while (overlap)
+            {
+            vec3<Scalar> pos_i(rng.s(-L.x/2,L.x/2), rng.s(-L.y/2,L.y/2), rng.s(-L.z/2,L.z/2));
+            quat<Scalar> q_i = orient ? random_orientation(rng) : quat<Scalar>();
+            Shape shape_i(q_i, params[types[i]]);
+
+            overlap = false;
+            for (unsigned int j = 0; j < i && !overlap; j++)
+                {
+                vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(h_pos.data[j]) - pos_i)));
+                Shape shape_j(quat<Scalar>(h_orientation.data[j]), params[types[j]]);
+                overlap = check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                    && test_overlap(r_ij, shape_i, shape_j, err_count);
+                }
+
+            h_pos.data[i] = make_scalar4(pos_i.x, pos_i.y, pos_i.z, __int_as_scalar(types[i]));
+            h_orientation.data[i] = quat_to_scalar4(q_i);
+            }
+        }
+    }
+
+//! Check the histogram of a random configuration against the minimum reference bins of all pairs
+template < class Shape >
+void sdf_histogram_test(const std::vector<typename Shape::param_type>& params,
+                        const std::vector<unsigned int>& types,
+                        Scalar L,
+                        bool orient,
+                        bool cell_grid)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    const unsigned int N = types.size();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), params.size(), 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<Shape> > mc(new IntegratorHPMCMono<Shape>(sysdef, 1));
+    for (unsigned int typ = 0; typ < params.size(); typ++)
+        mc->setParam(typ, params[typ]);
+    place_random<Shape>(sysdef, params, types, orient);
+
+    const Scalar lmax = 0.1, dl = 0.0005;
+    const unsigned int n_bins = 200;
+    std::shared_ptr< AnalyzerSDFTester<Shape> > sdf(new AnalyzerSDFTester<Shape>(sysdef, mc, lmax, dl));
+    UP_ASSERT_EQUAL(sdf->usesCellGrid(), cell_grid);
+
+    std::vector<unsigned int> hist = sdf->getHistogram();
+    UP_ASSERT_EQUAL(hist.size(), n_bins);
+
+    // smallest bin of every particle with any other particle
+    std::vector<unsigned int> ref_hist(n_bins, 0);
+        {
+        std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+        const BoxDim& box = pdata->getBox();
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int min_bin = n_bins;
+            for (unsigned int j = 0; j < N; j++)
+                {
+                if (i == j)
+                    continue;
+                vec3<Scalar> r_ij(box.minImage(vec_to_scalar3(vec3<Scalar>(h_pos.data[j]) - vec3<Scalar>(h_pos.data[i]))));
+                int bin = reference_bin<Shape>(r_ij,
+                                               quat<Scalar>(h_orientation.data[i]),
+                                               quat<Scalar>(h_orientation.data[j]),
+                                               params[types[i]],
+                                               params[types[j]],
+                                               dl,
+                                               n_bins);
+                if (bin >= 0)
+                    min_bin = std::min(min_bin, (unsigned int)bin);
+                }
+            if (min_bin < n_bins)
+                ref_hist[min_bin]++;
+            }
+        }
+
+    // a particle within rounding of a bin edge may move to the neighboring bin
+    unsigned int n_ref = 0, n_diff = 0;
+    for (unsigned int b = 0; b < n_bins; b++)
+        {
+        n_ref += ref_hist[b];
+        n_diff += std::abs(int(hist[b]) - int(ref_hist[b]));
+        }
+    UP_ASSERT(n_ref > N / 10);
+    UP_ASSERT(n_diff <= 2);
+
+    // counting again adds the same counts
+    sdf->getHistogram();
+    UP_ASSERT(sdf->getHistogram() == hist);
+    }
+
+//! Spheres of two sizes
+std::vector<sph_params> setup_spheres(OverlapReal radius_a, OverlapReal radius_b)
+    {
+    std::vector<sph_params> params(2);
+    params[0].radius = radius_a;
+    params[0].ignore = 0;
+    params[1].radius = radius_b;
+    params[1].ignore = 0;
+    return params;
+    }
+
+//! Ellipsoids of two sizes with the same aspect ratios
+std::vector<ell_params> setup_ellipsoids(OverlapReal scale_a, OverlapReal scale_b)
+    {
+    std::vector<ell_params> params(2);
+    OverlapReal scale[2] = {scale_a, scale_b};
+    for (unsigned int typ = 0; typ < 2; typ++)
+        {
+        params[typ].x = OverlapReal(0.5) * scale[typ];
+        params[typ].y = OverlapReal(0.35) * scale[typ];
+        params[typ].z = OverlapReal(0.25) * scale[typ];
+        params[typ].ignore = 0;
+        }
+    return params;
+    }
+
+//! Types of \a n_a particles of type 0 followed by \a n_b particles of type 1
+std::vector<unsigned int> setup_types(unsigned int n_a, unsigned int n_b)
+    {
+    std::vector<unsigned int> types(n_a, 0);
+    types.insert(types.end(), n_b, 1);
+    return types;
+    }
+
+//! Closed form bins of sphere pairs
+UP_TEST( sdf_sphere_bins )
+    {
+    sdf_bin_test<ShapeSphere>(setup_spheres(0.5, 0.8), false);
+    }
+
+//! Bisection within the circumsphere and insphere window for ellipsoid pairs
+UP_TEST( sdf_ellipsoid_bins )
+    {
+    sdf_bin_test<ShapeEllipsoid>(setup_ellipsoids(1.0, 1.4), true);
+    }
+
+//! Histogram of monodisperse spheres with the cell grid
+UP_TEST( sdf_sphere_histogram_cell_grid )
+    {
+    sdf_histogram_test<ShapeSphere>(setup_spheres(0.5, 0.5), setup_types(250, 0), 8.0, false, true);
+    }
+
+//! Histogram of monodisperse ellipsoids with the cell grid
+UP_TEST( sdf_ellipsoid_histogram_cell_grid )
+    {
+    sdf_histogram_test<ShapeEllipsoid>(setup_ellipsoids(1.0, 1.0), setup_types(300, 0), 6.0, true, true);
+    }
+
+//! Histogram of spheres with a diameter ratio of 2 with the AABB tree
+UP_TEST( sdf_sphere_histogram_aabb_tree )
+    {
+    sdf_histogram_test<ShapeSphere>(setup_spheres(1.0, 0.5), setup_types(80, 250), 12.0, false, false);
+    }
+
+//! Histogram of ellipsoids with a diameter ratio of 2 with the AABB tree
+UP_TEST( sdf_ellipsoid_histogram_aabb_tree )
+    {
+    sdf_histogram_test<ShapeEllipsoid>(setup_ellipsoids(2.0, 1.0), setup_types(80, 300), 9.0, true, false);
+    }
@@ -622,13 +622,23 @@ class muvt(_updater):
         fugacity_variant = hoomd.variant._setup_variant_input(fugacity);
         self.cpp_updater.setFugacity(type_id, fugacity_variant.cpp_variant);
 
-    def set_params(self, dV=None, move_ratio=None, transfer_ratio=None):
+    def set_params(self, dV=None, move_ratio=None, transfer_ratio=None, batch=None):
         R""" Set muVT parameters.
 
         Args:
             dV (float): (if set) Set volume rescaling factor (dimensionless)
             move_ratio (float): (if set) Set the ratio between volume and exchange/transfer moves (applies to Gibbs ensemble)
             transfer_ratio (float): (if set) Set the ratio between transfer and exchange moves
+            batch (int): (if set) Set the number of insertion and removal moves, or transfer moves in the Gibbs ensemble, per update
+
+        With *batch* larger than one, every update that makes transfer moves makes a batch of them. Updates that make
+        identity exchange moves (with probability 1 - *transfer_ratio*) still make a single move. The overlap checks of
+        all trial insertions in a batch are performed in parallel (with OpenMP), and the accepted moves are applied to
+        the system at the end of the batch. In the Gibbs ensemble, the transfer moves of a batch go in random directions
+        between the two boxes. Both boxes check their trial insertions at the same time and exchange the results in a
+        single message per batch.
+        The transfer types must be given in the same order in all boxes. Batched moves are not supported with
+        implicit depletants.
 
         Example::
 
@@ -636,6 +646,7 @@ class muvt(_updater):
             muvt.set_params(dV=0.1)
             muvt.set_params(n_trial=2)
             muvt.set_params(move_ratio=0.05)
+            muvt.set_params(batch=100)
 
         """
         hoomd.util.print_status_line();
@@ -652,6 +663,8 @@ class muvt(_updater):
             self.cpp_updater.setMaxVolumeRescale(float(dV))
         if transfer_ratio is not None:
             self.cpp_updater.setTransferRatio(float(transfer_ratio))
+        if batch is not None:
+            self.cpp_updater.setBatchSize(int(batch))
 
 class remove_drift(_updater):
     R""" Remove the center of mass drift from a system restrained on a lattice.
@@ -734,3 +747,127 @@ class remove_drift(_updater):
 
         self.cpp_updater = cls(hoomd.context.current.system_definition, external_lattice.cpp_compute, mc.cpp_integrator);
         self.setupUpdater(period);
+
+class clusters(_updater):
+    R""" Move clusters of particles with the geometric cluster algorithm.
+
+    Args:
+        mc (:py:mod:`hoomd.hpmc.integrate`): MC integrator.
+        seed (int): The seed of the pseudo-random number generator
+        period (int): Number of timesteps between cluster moves.
+
+    The geometric cluster algorithm (GCA) applies a point reflection, or a rotation by 180 degrees about a box
+    axis (pivot move), to clusters of particles. A particle joins the cluster of another particle if it would
+    overlap with the transformed other particle. Every cluster is transformed with probability 1/2. The moves
+    are rejection free and never create overlaps, and they relax dense and strongly interacting systems much
+    faster than local moves.
+
+    Point reflections are only used in 3D for shapes without orientation, because they would mirror the particles.
+    In 2D, the point reflection is the pivot move about the z axis. Pivot moves of shapes with orientation require
+    an orthorhombic box in 3D.
+
+    With implicit depletants (integrators created with *implicit=True*), two particles also join the same cluster
+    if a depletant in the free volume overlaps both of them after the transformation. Implicit depletants are
+    only supported in 3D.
+
+    With domain decomposition, the clusters are built on every rank independently, with a random pivot inside the
+    local domain, and clusters that would cross a domain boundary are rejected.
+
+    update.clusters() provides the following quantities for logging:
+
+    * ``hpmc_clusters_avg_size`` - The average number of particles per cluster in the last step
+    * ``hpmc_clusters_max_size`` - The number of particles in the largest cluster in the last step
+    * ``hpmc_clusters_moved_fraction`` - The fraction of particles transformed in the last step
+    * ``hpmc_clusters_boundary_rejects`` - The number of clusters rejected at domain boundaries in the last step
+
+    Example::
+
+        mc = hpmc.integrate.sphere(seed=415236)
+        hpmc.update.clusters(mc=mc, seed=123)
+
+    """
+    def __init__(self, mc, seed, period=1):
+        hoomd.util.print_status_line();
+
+        if not isinstance(mc, integrate.mode_hpmc):
+            hoomd.context.msg.warning("update.clusters: Must have a handle to an HPMC integrator.\n");
+            return;
+
+        # initialize base class
+        _updater.__init__(self);
+
+        cls = None;
+        if mc.implicit is True:
+            if isinstance(mc, integrate.sphere):
+                cls = _hpmc.UpdaterClustersImplicitSphere;
+            elif isinstance(mc, integrate.convex_polygon):
+                cls = _hpmc.UpdaterClustersImplicitConvexPolygon;
+            elif isinstance(mc, integrate.simple_polygon):
+                cls = _hpmc.UpdaterClustersImplicitSimplePolygon;
+            elif isinstance(mc, integrate.convex_polyhedron):
+                cls = _hpmc.UpdaterClustersImplicitConvexPolyhedron;
+            elif isinstance(mc, integrate.convex_spheropolyhedron):
+                cls = _hpmc.UpdaterClustersImplicitSpheropolyhedron;
+            elif isinstance(mc, integrate.ellipsoid):
+                cls = _hpmc.UpdaterClustersImplicitEllipsoid;
+            elif isinstance(mc, integrate.convex_spheropolygon):
+                cls =_hpmc.UpdaterClustersImplicitSpheropolygon;
+            elif isinstance(mc, integrate.faceted_sphere):
+                cls =_hpmc.UpdaterClustersImplicitFacetedSphere;
+            elif isinstance(mc, integrate.sphere_union):
+                cls = integrate._get_sized_entry('UpdaterClustersImplicitSphereUnion', mc.capacity);
+            elif isinstance(mc, integrate.polyhedron):
+                cls =_hpmc.UpdaterClustersImplicitPolyhedron;
+            else:
+                hoomd.context.msg.error("update.clusters: Unsupported integrator.\n");
+                raise RuntimeError("Error initializing update.clusters");
+        else:
+            if isinstance(mc, integrate.sphere):
+                cls = _hpmc.UpdaterClustersSphere;
+            elif isinstance(mc, integrate.convex_polygon):
+                cls = _hpmc.UpdaterClustersConvexPolygon;
+            elif isinstance(mc, integrate.simple_polygon):
+                cls = _hpmc.UpdaterClustersSimplePolygon;
+            elif isinstance(mc, integrate.convex_polyhedron):
+                cls = _hpmc.UpdaterClustersConvexPolyhedron;
+            elif isinstance(mc, integrate.convex_spheropolyhedron):
+                cls = _hpmc.UpdaterClustersSpheropolyhedron;
+            elif isinstance(mc, integrate.ellipsoid):
+                cls = _hpmc.UpdaterClustersEllipsoid;
+            elif isinstance(mc, integrate.convex_spheropolygon):
+                cls =_hpmc.UpdaterClustersSpheropolygon;
+            elif isinstance(mc, integrate.faceted_sphere):
+                cls =_hpmc.UpdaterClustersFacetedSphere;
+            elif isinstance(mc, integrate.sphere_union):
+                cls = integrate._get_sized_entry('UpdaterClustersSphereUnion', mc.capacity);
+            elif isinstance(mc, integrate.polyhedron):
+                cls =_hpmc.UpdaterClustersPolyhedron;
+            else:
+                hoomd.context.msg.error("update.clusters: Unsupported integrator.\n");
+                raise RuntimeError("Error initializing update.clusters");
+
+        self.cpp_updater = cls(hoomd.context.current.system_definition,
+                               mc.cpp_integrator,
+                               int(seed));
+
+        self.setupUpdater(period);
+
+    def set_params(self, move_ratio=None):
+        R""" Set options for the cluster moves.
+
+        Args:
+            move_ratio (float): (if set) Set the fraction of point reflections among the moves (3D shapes without
+                                orientation only), the other moves are pivot moves.
+
+        Example::
+
+            clusters = hpmc.update.clusters(mc, seed=123)
+            clusters.set_params(move_ratio=0.8)
+
+        """
+        hoomd.util.print_status_line();
+        self.check_initialization();
+
+        if move_ratio is not None:
+            self.cpp_updater.setMoveRatio(float(move_ratio))
+
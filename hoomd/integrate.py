@@ -167,6 +167,14 @@ class _integrator(hoomd.meta._metadata):
             ndof_rot = self.cpp_integrator.getRotationalNDOF(t.group.cpp_group);
             t.cpp_compute.setRotationalNDOF(ndof_rot);
 
+        # dynamic groups recount the degrees of freedom whenever they change
+        for u in hoomd.context.current.updaters:
+            if isinstance(u, hoomd.update.dynamic_group):
+                u.cpp_updater.setIntegrator(self.cpp_integrator);
+                u.cpp_updater.removeAllThermos();
+                for t in hoomd.context.current.thermos:
+                    u.cpp_updater.addThermo(t.cpp_compute);
+
 
 ## \internal
 # \brief Base class for integration methods
@@ -10,9 +10,16 @@
 #include <iostream>
 #include <stdexcept>
 #include <memory>
+#include <type_traits>
 
 #include "NeighborList.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/Autotuner.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 /*! \file AnisoPotentialPair.h
     \brief Defines the template class for anisotropic pair potentials
@@ -26,6 +33,22 @@
 
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
+//! Detects whether an aniso_evaluator accepts precomputed rotation matrices
+/*! needsRotationMatrix() and setRotationMatrix() are optional parts of the aniso_evaluator interface. Evaluators that
+    do not define them (such as those in plugins written before the matrices were passed in) compute their axes from the
+    quaternions, as before.
+*/
+template<class aniso_evaluator>
+struct aniso_evaluator_has_rotmat
+    {
+    template<class T>
+    static auto test(int) -> decltype(T::needsRotationMatrix(), std::true_type());
+    template<class T>
+    static std::false_type test(...);
+
+    typedef decltype(test<aniso_evaluator>(0)) type;
+    };
+
 //! Template class for computing pair potentials
 /*! <b>Overview:</b>
     AnisoPotentialPair computes standard pair potentials (and forces) between all particle pairs in the simulation. It
@@ -108,6 +131,26 @@ class AnisoPotentialPair : public ForceCompute
             return true;
             }
 
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            if (m_thread_tuner)
+                {
+                m_thread_tuner->setPeriod(period);
+                m_thread_tuner->setEnabled(enable);
+                }
+            }
+
+        //! Print the number of threads chosen by the autotuner
+        virtual void printStats()
+            {
+            if (m_thread_tuner)
+                m_thread_tuner->printStats();
+            }
+
     protected:
         std::shared_ptr<NeighborList> m_nlist;    //!< The neighborlist to use for the computation
         energyShiftMode m_shift_mode;               //!< Store the mode with which to handle the energy shift at r_cut
@@ -117,9 +160,44 @@ class AnisoPotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        GPUArray< rotmat3<Scalar> > m_rotmat;       //!< Per-particle space->body rotation matrices (CPU only)
+        GPUArray<Scalar4> m_thread_force;           //!< Per-thread force accumulators (half neighbor list)
+        GPUArray<Scalar4> m_thread_torque;          //!< Per-thread torque accumulators (half neighbor list)
+        GPUArray<Scalar> m_thread_virial;           //!< Per-thread virial accumulators (half neighbor list)
+        std::unique_ptr<Autotuner> m_thread_tuner;  //!< Autotuner for the number of threads (CPU only)
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! Returns true if the aniso_evaluator takes rotation matrices
+        static bool needsRotationMatrix()
+            {
+            return needsRotationMatrix(typename aniso_evaluator_has_rotmat<aniso_evaluator>::type());
+            }
+        static bool needsRotationMatrix(std::true_type)
+            {
+            return aniso_evaluator::needsRotationMatrix();
+            }
+        static bool needsRotationMatrix(std::false_type)
+            {
+            return false;
+            }
+
+        //! Pass the rotation matrices to the aniso_evaluator, if it takes them
+        static void setRotationMatrix(aniso_evaluator& eval, const rotmat3<Scalar>& rot_i, const rotmat3<Scalar>& rot_j)
+            {
+            setRotationMatrix(eval, rot_i, rot_j, typename aniso_evaluator_has_rotmat<aniso_evaluator>::type());
+            }
+        static void setRotationMatrix(aniso_evaluator& eval, const rotmat3<Scalar>& rot_i, const rotmat3<Scalar>& rot_j,
+                                      std::true_type)
+            {
+            eval.setRotationMatrix(rot_i, rot_j);
+            }
+        static void setRotationMatrix(aniso_evaluator& eval, const rotmat3<Scalar>& rot_i, const rotmat3<Scalar>& rot_j,
+                                      std::false_type)
+            {
+            }
+
         //! Method to be called when number of types changes
         void slotNumTypesChange()
             {
@@ -163,6 +241,17 @@ AnisoPotentialPair< aniso_evaluator >::AnisoPotentialPair(std::shared_ptr<System
     m_prof_name = std::string("Aniso_Pair ") + aniso_evaluator::getName();
     m_log_name = std::string("aniso_pair_") + aniso_evaluator::getName() + std::string("_energy") + log_suffix;
 
+    // small systems can run faster on fewer threads, tune the number of threads on the CPU
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_thread_tuner.reset(new Autotuner(Autotuner::getThreadCounts(), 5, 100000,
+                                           "aniso_pair_threads_" + aniso_evaluator::getName(), m_exec_conf));
+        #ifdef ENABLE_MPI
+        // synchronize autotuner results across ranks
+        m_thread_tuner->setSync(bool(m_pdata->getDomainDecomposition()));
+        #endif
+        }
+
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_pdata->getNumTypesChangeSignal().template connect<AnisoPotentialPair<aniso_evaluator>,
                                                         &AnisoPotentialPair<aniso_evaluator>::slotNumTypesChange>(this);
@@ -254,6 +343,11 @@ Scalar AnisoPotentialPair< aniso_evaluator >::getLogValue(const std::string& qua
     that it is up to date before proceeding.
 
     \param timestep specifies the current time step of the simulation
+
+    The space->body rotation matrix of every local and ghost particle is computed once per step and handed to the
+    evaluator, instead of converting both quaternions for every neighbor pair. The loop over particles is split across
+    OpenMP threads. With a half neighbor list, forces, torques and virials on the neighbors are accumulated in
+    per-thread scratch arrays that are summed after the loop. The number of threads is chosen by m_thread_tuner.
 */
 template< class aniso_evaluator >
 void AnisoPotentialPair< aniso_evaluator >::computeForces(unsigned int timestep)
@@ -268,6 +362,35 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(unsigned int timestep)
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int N_total = N + m_pdata->getNGhosts();
+
+    // every parallel region below runs on the number of threads chosen by the autotuner
+    if (m_thread_tuner) m_thread_tuner->begin();
+    unsigned int n_threads = 1;
+    #ifdef ENABLE_OPENMP
+    n_threads = m_thread_tuner ? m_thread_tuner->getParam() : omp_get_max_threads();
+    #endif
+
+    // with a half neighbor list, threads write to the neighbors of their particles and need private accumulators
+    const bool use_thread_scratch = third_law && n_threads > 1;
+
+    // resize the scratch arrays if needed
+    if (needsRotationMatrix() && m_rotmat.getNumElements() < N_total)
+        {
+        GPUArray< rotmat3<Scalar> > rotmat(N_total, m_exec_conf);
+        m_rotmat.swap(rotmat);
+        }
+    if (use_thread_scratch && m_thread_force.getNumElements() < n_threads*N_total)
+        {
+        GPUArray<Scalar4> thread_force(n_threads*N_total, m_exec_conf);
+        m_thread_force.swap(thread_force);
+        GPUArray<Scalar4> thread_torque(n_threads*N_total, m_exec_conf);
+        m_thread_torque.swap(thread_torque);
+        GPUArray<Scalar> thread_virial(6*n_threads*N_total, m_exec_conf);
+        m_thread_virial.swap(thread_virial);
+        }
+
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
@@ -283,176 +406,242 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> h_torque(m_torque,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
 
+    // scratch arrays
+    ArrayHandle< rotmat3<Scalar> > h_rotmat(m_rotmat, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_thread_force(m_thread_force, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_thread_torque(m_thread_torque, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_thread_virial(m_thread_virial, access_location::host, access_mode::overwrite);
+
     const BoxDim& box = m_pdata->getBox();
     ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
     {
     // need to start from a zero force, energy and virial
-    memset(&h_force.data[0] , 0, sizeof(Scalar4)*m_pdata->getN());
-    memset(&h_torque.data[0] , 0, sizeof(Scalar4)*m_pdata->getN());
+    memset(&h_force.data[0] , 0, sizeof(Scalar4)*N);
+    memset(&h_torque.data[0] , 0, sizeof(Scalar4)*N);
     memset(&h_virial.data[0] , 0, sizeof(Scalar)*m_virial.getNumElements());
+    if (use_thread_scratch)
+        {
+        memset((void*)h_thread_force.data, 0, sizeof(Scalar4)*n_threads*N_total);
+        memset((void*)h_thread_torque.data, 0, sizeof(Scalar4)*n_threads*N_total);
+        memset((void*)h_thread_virial.data, 0, sizeof(Scalar)*6*n_threads*N_total);
+        }
 
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
+    const unsigned int virial_pitch = m_virial_pitch;
 
-    // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
-        {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        Scalar4 quat_i = h_orientation.data[i];
-
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
-
-        // access diameter and charge (if needed)
-        Scalar di = Scalar(0.0);
-        Scalar qi = Scalar(0.0);
-        if (aniso_evaluator::needsDiameter())
-            di = h_diameter.data[i];
-        if (aniso_evaluator::needsCharge())
-            qi = h_charge.data[i];
-
-        // initialize current particle force, torque, potential energy, and virial to 0
-        Scalar fxi = Scalar(0.0);
-        Scalar fyi = Scalar(0.0);
-        Scalar fzi = Scalar(0.0);
-        Scalar txi = Scalar(0.0);
-        Scalar tyi = Scalar(0.0);
-        Scalar tzi = Scalar(0.0);
-        Scalar pei = Scalar(0.0);
-        Scalar virialxxi = 0.0;
-        Scalar virialxyi = 0.0;
-        Scalar virialxzi = 0.0;
-        Scalar virialyyi = 0.0;
-        Scalar virialyzi = 0.0;
-        Scalar virialzzi = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const unsigned int myHead = h_head_list.data[i];
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int k = 0; k < size; k++)
-            {
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[myHead + k];
-            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
-
-            // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-            Scalar3 dx = pi - pj;
-            Scalar4 quat_j = h_orientation.data[j];
+    // design specifies that energies are shifted if
+    // shift mode is set to shift
+    bool energy_shift = false;
+    if (m_shift_mode == shift)
+        energy_shift = true;
 
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
-            assert(typej < m_pdata->getNTypes());
-
-            // access diameter and charge (if needed)
-            Scalar dj = Scalar(0.0);
-            Scalar qj = Scalar(0.0);
-            if (aniso_evaluator::needsDiameter())
-                dj = h_diameter.data[j];
-            if (aniso_evaluator::needsCharge())
-                qj = h_charge.data[j];
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+    // convert every quaternion to a rotation matrix once
+    if (needsRotationMatrix())
+        {
+        #pragma omp parallel for schedule(static) num_threads(n_threads)
+        for (int i = 0; i < (int)N_total; i++)
+            h_rotmat.data[i] = rotmat3<Scalar>(conj(quat<Scalar>(h_orientation.data[i])));
+        }
 
-            // design specifies that energies are shifted if
-            // shift mode is set to shift
-            bool energy_shift = false;
-            if (m_shift_mode == shift)
-                energy_shift = true;
+    #pragma omp parallel num_threads(n_threads)
+        {
+        unsigned int tid = 0;
+        #ifdef ENABLE_OPENMP
+        tid = omp_get_thread_num();
+        #endif
 
-            // compute the force and potential energy
-            Scalar3 force = make_scalar3(0.0,0.0,0.0);
-            Scalar3 torque_i = make_scalar3(0.0,0.0,0.0);
-            Scalar3 torque_j = make_scalar3(0.0,0.0,0.0);
+        // each thread accumulates into its own slice when writing to neighbors
+        Scalar4 *f = use_thread_scratch ? h_thread_force.data + tid*N_total : h_force.data;
+        Scalar4 *t = use_thread_scratch ? h_thread_torque.data + tid*N_total : h_torque.data;
+        Scalar *virial = use_thread_scratch ? h_thread_virial.data + 6*tid*N_total : h_virial.data;
+        const unsigned int pitch = use_thread_scratch ? N_total : virial_pitch;
 
-            Scalar pair_eng = Scalar(0.0);
+        // for each particle
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < (int)N; i++)
+            {
+            // access the particle's position and type (MEM TRANSFER: 4 scalars)
+            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            Scalar4 quat_i = h_orientation.data[i];
 
-            aniso_evaluator eval(dx, quat_i, quat_j, rcutsq, param);
+            // sanity check
+            assert(typei < m_pdata->getNTypes());
 
+            // access diameter and charge (if needed)
+            Scalar di = Scalar(0.0);
+            Scalar qi = Scalar(0.0);
             if (aniso_evaluator::needsDiameter())
-                eval.setDiameter(di, dj);
+                di = h_diameter.data[i];
             if (aniso_evaluator::needsCharge())
-                eval.setCharge(qi, qj);
-
-            bool evaluated = eval.evaluate(force, pair_eng, energy_shift,torque_i,torque_j);
-
-            if (evaluated)
+                qi = h_charge.data[i];
+
+            // initialize current particle force, torque, potential energy, and virial to 0
+            Scalar fxi = Scalar(0.0);
+            Scalar fyi = Scalar(0.0);
+            Scalar fzi = Scalar(0.0);
+            Scalar txi = Scalar(0.0);
+            Scalar tyi = Scalar(0.0);
+            Scalar tzi = Scalar(0.0);
+            Scalar pei = Scalar(0.0);
+            Scalar virialxxi = 0.0;
+            Scalar virialxyi = 0.0;
+            Scalar virialxzi = 0.0;
+            Scalar virialyyi = 0.0;
+            Scalar virialyzi = 0.0;
+            Scalar virialzzi = 0.0;
+
+            // loop over all of the neighbors of this particle
+            const unsigned int myHead = h_head_list.data[i];
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
+            for (unsigned int k = 0; k < size; k++)
                 {
-                Scalar3 force2 = Scalar(0.5)*force;
-
-                // add the force, potential energy and virial to the particle i
-                // (FLOPS: 8)
-                fxi += force.x;
-                fyi += force.y;
-                fzi += force.z;
-                txi += torque_i.x;
-                tyi += torque_i.y;
-                tzi += torque_i.z;
-                pei += pair_eng * Scalar(0.5);
-
-                if (compute_virial)
+                // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                unsigned int j = h_nlist.data[myHead + k];
+                assert(j < N_total);
+
+                // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+                Scalar3 dx = pi - pj;
+                Scalar4 quat_j = h_orientation.data[j];
+
+                // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
+                unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+                assert(typej < m_pdata->getNTypes());
+
+                // access diameter and charge (if needed)
+                Scalar dj = Scalar(0.0);
+                Scalar qj = Scalar(0.0);
+                if (aniso_evaluator::needsDiameter())
+                    dj = h_diameter.data[j];
+                if (aniso_evaluator::needsCharge())
+                    qj = h_charge.data[j];
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // get parameters for this type pair
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                param_type param = h_params.data[typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+
+                // compute the force and potential energy
+                Scalar3 force = make_scalar3(0.0,0.0,0.0);
+                Scalar3 torque_i = make_scalar3(0.0,0.0,0.0);
+                Scalar3 torque_j = make_scalar3(0.0,0.0,0.0);
+
+                Scalar pair_eng = Scalar(0.0);
+
+                aniso_evaluator eval(dx, quat_i, quat_j, rcutsq, param);
+
+                if (aniso_evaluator::needsDiameter())
+                    eval.setDiameter(di, dj);
+                if (aniso_evaluator::needsCharge())
+                    eval.setCharge(qi, qj);
+                if (needsRotationMatrix())
+                    setRotationMatrix(eval, h_rotmat.data[i], h_rotmat.data[j]);
+
+                bool evaluated = eval.evaluate(force, pair_eng, energy_shift,torque_i,torque_j);
+
+                if (evaluated)
                     {
-                    virialxxi += dx.x*force2.x;
-                    virialxyi += dx.y*force2.x;
-                    virialxzi += dx.z*force2.x;
-                    virialyyi += dx.y*force2.y;
-                    virialyzi += dx.z*force2.y;
-                    virialzzi += dx.z*force2.z;
-                    }
+                    Scalar3 force2 = Scalar(0.5)*force;
+
+                    // add the force, potential energy and virial to the particle i
+                    // (FLOPS: 8)
+                    fxi += force.x;
+                    fyi += force.y;
+                    fzi += force.z;
+                    txi += torque_i.x;
+                    tyi += torque_i.y;
+                    tzi += torque_i.z;
+                    pei += pair_eng * Scalar(0.5);
 
-                // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law)
-                    {
-                    h_force.data[j].x -= force.x;
-                    h_force.data[j].y -= force.y;
-                    h_force.data[j].z -= force.z;
-                    h_torque.data[j].x += torque_j.x;
-                    h_torque.data[j].y += torque_j.y;
-                    h_torque.data[j].z += torque_j.z;
-                    h_force.data[j].w += pair_eng * Scalar(0.5);
                     if (compute_virial)
                         {
-                        h_virial.data[0*m_virial_pitch+j] += dx.x*force2.x;
-                        h_virial.data[1*m_virial_pitch+j] += dx.y*force2.x;
-                        h_virial.data[2*m_virial_pitch+j] += dx.z*force2.x;
-                        h_virial.data[3*m_virial_pitch+j] += dx.y*force2.y;
-                        h_virial.data[4*m_virial_pitch+j] += dx.z*force2.y;
-                        h_virial.data[5*m_virial_pitch+j] += dx.z*force2.z;
+                        virialxxi += dx.x*force2.x;
+                        virialxyi += dx.y*force2.x;
+                        virialxzi += dx.z*force2.x;
+                        virialyyi += dx.y*force2.y;
+                        virialyzi += dx.z*force2.y;
+                        virialzzi += dx.z*force2.z;
+                        }
+
+                    // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
+                    if (third_law)
+                        {
+                        f[j].x -= force.x;
+                        f[j].y -= force.y;
+                        f[j].z -= force.z;
+                        t[j].x += torque_j.x;
+                        t[j].y += torque_j.y;
+                        t[j].z += torque_j.z;
+                        f[j].w += pair_eng * Scalar(0.5);
+                        if (compute_virial)
+                            {
+                            virial[0*pitch+j] += dx.x*force2.x;
+                            virial[1*pitch+j] += dx.y*force2.x;
+                            virial[2*pitch+j] += dx.z*force2.x;
+                            virial[3*pitch+j] += dx.y*force2.y;
+                            virial[4*pitch+j] += dx.z*force2.y;
+                            virial[5*pitch+j] += dx.z*force2.z;
+                            }
                         }
                     }
                 }
+
+            // finally, increment the force, potential energy and virial for particle i
+            f[i].x += fxi;
+            f[i].y += fyi;
+            f[i].z += fzi;
+            t[i].x += txi;
+            t[i].y += tyi;
+            t[i].z += tzi;
+            f[i].w += pei;
+            if (compute_virial)
+                {
+                virial[0*pitch+i] += virialxxi;
+                virial[1*pitch+i] += virialxyi;
+                virial[2*pitch+i] += virialxzi;
+                virial[3*pitch+i] += virialyyi;
+                virial[4*pitch+i] += virialyzi;
+                virial[5*pitch+i] += virialzzi;
+                }
             }
+        }
 
-        // finally, increment the force, potential energy and virial for particle i
-        h_force.data[i].x += fxi;
-        h_force.data[i].y += fyi;
-        h_force.data[i].z += fzi;
-        h_torque.data[i].x += txi;
-        h_torque.data[i].y += tyi;
-        h_torque.data[i].z += tzi;
-        h_force.data[i].w += pei;
-        if (compute_virial)
+    // sum up the per-thread forces, torques and virials
+    if (use_thread_scratch)
+        {
+        #pragma omp parallel for schedule(static) num_threads(n_threads)
+        for (int i = 0; i < (int)N; i++)
             {
-            h_virial.data[0*m_virial_pitch+i] += virialxxi;
-            h_virial.data[1*m_virial_pitch+i] += virialxyi;
-            h_virial.data[2*m_virial_pitch+i] += virialxzi;
-            h_virial.data[3*m_virial_pitch+i] += virialyyi;
-            h_virial.data[4*m_virial_pitch+i] += virialyzi;
-            h_virial.data[5*m_virial_pitch+i] += virialzzi;
+            for (unsigned int tid = 0; tid < n_threads; tid++)
+                {
+                Scalar4 ft = h_thread_force.data[tid*N_total + i];
+                Scalar4 tt = h_thread_torque.data[tid*N_total + i];
+                h_force.data[i].x += ft.x;
+                h_force.data[i].y += ft.y;
+                h_force.data[i].z += ft.z;
+                h_force.data[i].w += ft.w;
+                h_torque.data[i].x += tt.x;
+                h_torque.data[i].y += tt.y;
+                h_torque.data[i].z += tt.z;
+                if (compute_virial)
+                    {
+                    for (int c = 0; c < 6; c++)
+                        h_virial.data[c*virial_pitch+i] += h_thread_virial.data[(6*tid+c)*N_total + i];
+                    }
+                }
             }
         }
     }
 
+    if (m_thread_tuner) m_thread_tuner->end();
+
     if (m_prof) m_prof->pop();
     }
 
@@ -13,11 +13,7 @@
 
 #include "hoomd/HOOMDMath.h"
 
-#ifdef NVCC
-#include "hoomd/extern/saruprngCUDA.h"
-#else
-#include "hoomd/extern/saruprng.h"
-#endif
+#include "hoomd/RandomNumbers.h"
 
 
 /*! \file EvaluatorPairDPDThermo.h
@@ -32,22 +28,6 @@
 #define DEVICE
 #endif
 
-// call different Saru PRNG initializers on the host / device
-// SARU is SaruGPU Class when included in nvcc and Saru Class when included into the host compiler
-#ifdef NVCC
-#define SARU(ix,iy,iz) SaruGPU saru( (ix) , (iy) , (iz) )
-#else
-#define SARU(ix, iy, iz) Saru saru( (ix) , (iy) , (iz) )
-#endif
-
-// use different Saru PRNG returns on the host / device
-// CALL_SARU is currently define to return a random Scalar for both the GPU and Host.  By changing saru.f to saru.d, a double could be returned instead.
-#ifdef NVCC
-#define CALL_SARU(x,y) saru.f( (x), (y))
-#else
-#define CALL_SARU(x,y) saru.f( (x), (y))
-#endif
-
 
 
 //! Class for evaluating the DPD Thermostat pair potential
@@ -217,11 +197,13 @@ class EvaluatorPairDPDThermo
                    m_oj = m_j;
                    }
 
-                SARU(m_oi, m_oj, m_seed + m_timestep);
-
+                // the pair draws from a counter based stream keyed by both tags, so i-j and j-i see the same number
+                hoomd::RandomGenerator rng(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, m_seed, m_oi, m_oj, m_timestep);
 
                 // Generate a single random number
-                Scalar alpha = CALL_SARU(-1,1) ;
+                Scalar uniform[4];
+                rng.uniform4(uniform, Scalar(-1), Scalar(1));
+                Scalar alpha = uniform[0];
 
                 // conservative dpd
                 //force_divr = FDIV(a,r)*(Scalar(1.0) - r*rcutinv);
@@ -271,6 +253,4 @@ class EvaluatorPairDPDThermo
         Scalar m_deltaT;   //!<  timestep size stored from constructor
     };
 
-#undef SARU
-
 #endif // __PAIR_EVALUATOR_DPD_H__
@@ -70,7 +70,7 @@ class EvaluatorPairDipole
         */
         DEVICE EvaluatorPairDipole(Scalar3& _dr, Scalar4& _quat_i, Scalar4& _quat_j, Scalar _rcutsq, param_type& params)
             :dr(_dr), rcutsq(_rcutsq), quat_i(_quat_i), quat_j(_quat_j),
-             mu(params.x), A(params.y), kappa(params.z)
+             mu(params.x), A(params.y), kappa(params.z), has_axes(false)
             {
             }
 
@@ -103,6 +103,27 @@ class EvaluatorPairDipole
             q_j = qj;
             }
 
+        //! uses rotation matrices
+        DEVICE static bool needsRotationMatrix()
+            {
+            return true;
+            }
+
+        //! Accept the optional rotation matrices
+        /*! \param rot_i Rotation matrix (space->body) of particle i
+            \param rot_j Rotation matrix (space->body) of particle j
+
+            When the matrices are given, the dipole directions are read from them instead of being computed from the
+            quaternions.
+        */
+        DEVICE void setRotationMatrix(const rotmat3<Scalar>& rot_i, const rotmat3<Scalar>& rot_j)
+            {
+            // the first row of the space->body matrix is the body x axis in the space frame
+            e_i = rot_i.row0;
+            e_j = rot_j.row0;
+            has_axes = true;
+            }
+
         //! Evaluate the force and energy
         /*! \param force Output parameter to write the computed force.
             \param pair_eng Output parameter to write the computed pair energy.
@@ -126,8 +147,17 @@ class EvaluatorPairDipole
             Scalar r5inv = r3inv*r2inv;
 
             // convert dipole vector in the body frame of each particle to space frame
-            vec3<Scalar> p_i = rotate(quat<Scalar>(quat_i), vec3<Scalar>(mu, 0, 0));
-            vec3<Scalar> p_j = rotate(quat<Scalar>(quat_j), vec3<Scalar>(mu, 0, 0));
+            vec3<Scalar> p_i, p_j;
+            if (has_axes)
+                {
+                p_i = mu*e_i;
+                p_j = mu*e_j;
+                }
+            else
+                {
+                p_i = rotate(quat<Scalar>(quat_i), vec3<Scalar>(mu, 0, 0));
+                p_j = rotate(quat<Scalar>(quat_j), vec3<Scalar>(mu, 0, 0));
+                }
 
             vec3<Scalar> f;
             vec3<Scalar> t_i;
@@ -224,6 +254,8 @@ class EvaluatorPairDipole
         Scalar q_i, q_j;            //!< Stored particle charges
         Scalar4 quat_i,quat_j;      //!< Stored quaternion of ith and jth particle from constuctor
         Scalar mu, A, kappa;        //!< Stored dipole magnitude, electrostatic magnitude and inverse screeing length
+        vec3<Scalar> e_i, e_j;      //!< Dipole directions in the space frame (if set from rotation matrices)
+        bool has_axes;              //!< True if the dipole directions were set from precomputed rotation matrices
     };
 
 
@@ -51,7 +51,7 @@ class EvaluatorPairGB
                                Scalar _rcutsq,
                                param_type& _params)
             : dr(_dr),rcutsq(_rcutsq),qi(_qi),qj(_qj),
-              epsilon(_params.x), lperp(_params.y), lpar(_params.z)
+              epsilon(_params.x), lperp(_params.y), lpar(_params.z), has_axes(false)
             {
             }
 
@@ -80,6 +80,25 @@ class EvaluatorPairGB
         */
         DEVICE void setCharge(Scalar qi, Scalar qj){}
 
+        //! uses rotation matrices
+        DEVICE static bool needsRotationMatrix()
+            {
+            return true;
+            }
+
+        //! Accept the optional rotation matrices
+        /*! \param rot_i Rotation matrix (space->body) of particle i
+            \param rot_j Rotation matrix (space->body) of particle j
+
+            When the matrices are given, the long axes are read from them instead of being computed from the quaternions.
+        */
+        DEVICE void setRotationMatrix(const rotmat3<Scalar>& rot_i, const rotmat3<Scalar>& rot_j)
+            {
+            a3 = rot_i.row2;
+            b3 = rot_j.row2;
+            has_axes = true;
+            }
+
         //! Evaluate the force and energy
         /*! \param force Output parameter to write the computed force.
             \param pair_eng Output parameter to write the computed pair energy.
@@ -95,13 +114,16 @@ class EvaluatorPairGB
             Scalar r = fast::sqrt(rsq);
             vec3<Scalar> unitr = fast::rsqrt(dot(dr,dr))*dr;
 
-            // obtain rotation matrices (space->body)
-            rotmat3<Scalar> rotA(conj(qi));
-            rotmat3<Scalar> rotB(conj(qj));
+            if (!has_axes)
+                {
+                // obtain rotation matrices (space->body)
+                rotmat3<Scalar> rotA(conj(qi));
+                rotmat3<Scalar> rotB(conj(qj));
 
-            // last row of rotation matrix
-            vec3<Scalar> a3 = rotA.row2;
-            vec3<Scalar> b3 = rotB.row2;
+                // last row of rotation matrix
+                a3 = rotA.row2;
+                b3 = rotB.row2;
+                }
 
             Scalar ca = dot(a3,unitr);
             Scalar cb = dot(b3,unitr);
@@ -185,6 +207,9 @@ class EvaluatorPairGB
         Scalar epsilon;    //!< Energy parameter
         Scalar lperp;      //!< Short axis length
         Scalar lpar;       //!< Longt axis length
+        vec3<Scalar> a3;   //!< Long axis of particle i in the space frame
+        vec3<Scalar> b3;   //!< Long axis of particle j in the space frame
+        bool has_axes;     //!< True if the long axes were set from precomputed rotation matrices
     };
 
 
@@ -61,12 +61,28 @@ HOSTDEVICE inline tersoff_params make_tersoff_params(Scalar cutoff_thickness,
     return retval;
     }
 
+//! Distance and bond angle dependent terms of the Tersoff potential for one ijk triplet
+/*! These are computed once per triplet in evalChiCached() and reused by evalForceikCached().
+*/
+struct tersoff_triplet
+    {
+    Scalar cos_th;   //!< Cosine of the angle between rij and rik
+    Scalar fcut_ik;  //!< Cutoff function of the ik distance
+    Scalar dfcut_ik; //!< Derivative of the cutoff function of the ik distance
+    Scalar g;        //!< Bond angle function g(theta)
+    Scalar dg;       //!< Derivative of g with respect to cos(theta)
+    Scalar h;        //!< Exponential term h(rij - rik)
+    Scalar dh;       //!< Derivative of h with respect to rij
+    };
+
 //! Class for evaluating the Tersoff three-body potential
 class EvaluatorTersoff
     {
     public:
         //! Define the parameter type used by this evaluator
         typedef tersoff_params param_type;
+        //! Define the type of the cached triplet terms
+        typedef tersoff_triplet triplet_type;
 
         //! Constructs the evaluator
         /*! \param _rij_sq Squared distance between particles i and j
@@ -227,6 +243,192 @@ class EvaluatorTersoff
             potential_eng = Scalar(0.5) * fcut_ij * (fR - bij * fA);
             }
 
+        //! Evaluate the cutoff function and its derivative
+        /*! \param r Distance at which to evaluate the cutoff function
+            \param fcut Value of the cutoff function
+            \param dfcut Derivative of the cutoff function
+
+            The cutoff function only depends on the distance and the type pair parameters, so callers evaluate it
+            once per neighbor pair and pass it to the cached evaluation methods below.
+        */
+        DEVICE void evalCutoff(Scalar r, Scalar& fcut, Scalar& dfcut) const
+            {
+            Scalar rcut = fast::sqrt(rcutsq);
+            Scalar r_shell_inner = rcut - cutoff_shell_thickness;
+
+            fcut = Scalar(1.0);
+            dfcut = Scalar(0.0);
+            if (r > r_shell_inner)
+                {
+                Scalar cutoff_x = (r - r_shell_inner) / cutoff_shell_thickness;
+                Scalar cutoff_x2 = cutoff_x * cutoff_x;
+                Scalar cutoff_x3 = cutoff_x2 * cutoff_x;
+                Scalar inv_denom = Scalar(1.0) / (cutoff_x3 - Scalar(1.0));
+
+                fcut = fast::exp( cutoff_alpha * cutoff_x3 * inv_denom );
+                dfcut = Scalar(-3.0) * cutoff_alpha * cutoff_x2 * inv_denom * inv_denom
+                    / cutoff_shell_thickness * fcut;
+                }
+            }
+
+        //! Evaluate chi for this triplet with a precomputed cutoff function and keep the triplet terms
+        /*! \param rij Distance between particles i and j
+            \param rik Distance between particles i and k
+            \param fcut_ik Cutoff function of \a rik (see evalCutoff())
+            \param dfcut_ik Derivative of the cutoff function of \a rik
+            \param chi Sum to add the contribution of this triplet to
+            \param t Returns the triplet terms for evalForceikCached()
+            \returns true if the triplet contributes to chi
+
+            rik_sq and the bond angle must be set with setRik() and setAngle() first. The result equals evalChi().
+        */
+        DEVICE bool evalChiCached(Scalar rij,
+                                  Scalar rik,
+                                  Scalar fcut_ik,
+                                  Scalar dfcut_ik,
+                                  Scalar& chi,
+                                  triplet_type& t)
+            {
+            if (rik_sq < rcutsq && gamman != 0)
+                {
+                // h function and its derivative
+                Scalar delta_r = rij - rik;
+                Scalar delta_r2 = delta_r * delta_r;
+                t.h = fast::exp( lambda_h3 * delta_r2 * delta_r );
+                t.dh = Scalar(3.0) * lambda_h3 * delta_r2 * t.h;
+
+                // g function and its derivative
+                Scalar ang_diff = tersoff_m - cos_th;
+                Scalar gdenom = tersoff_d2 + ang_diff * ang_diff;
+                t.g = Scalar(1.0) + tersoff_c2 / tersoff_d2 - tersoff_c2 / gdenom;
+                t.dg = Scalar(-2.0) * tersoff_c2 / (gdenom * gdenom) * ang_diff;
+
+                t.cos_th = cos_th;
+                t.fcut_ik = fcut_ik;
+                t.dfcut_ik = dfcut_ik;
+
+                chi += fcut_ik * t.g * t.h;
+                return true;
+                }
+            else return false;
+            }
+
+        //! Evaluate the force and potential energy due to ij interactions with a precomputed cutoff function
+        /*! \param fR Repulsive term
+            \param fA Attractive term
+            \param chi Sum of the triplet terms of this pair
+            \param rij Distance between particles i and j
+            \param fcut_ij Cutoff function of \a rij (see evalCutoff())
+            \param dfcut_ij Derivative of the cutoff function of \a rij
+            \param bij Returns the bond order
+            \param dbij Returns the derivative of \a bij with respect to \a chi, shared by all triplets of the pair
+            \param force_divr Returns the ij force divided by \a rij
+            \param potential_eng Returns the potential energy
+
+            The result equals evalForceij().
+        */
+        DEVICE void evalForceijCached(Scalar fR,
+                                      Scalar fA,
+                                      Scalar chi,
+                                      Scalar rij,
+                                      Scalar fcut_ij,
+                                      Scalar dfcut_ij,
+                                      Scalar& bij,
+                                      Scalar& dbij,
+                                      Scalar& force_divr,
+                                      Scalar& potential_eng)
+            {
+            // compute the derivative of the base repulsive and attractive terms
+            Scalar dfR = Scalar(-1.0) * lambda_R * fR;
+            Scalar dfA = Scalar(-1.0) * lambda_A * fA;
+
+            // compute chi^n and (1 + gamma^n * chi^n)
+            Scalar chin = fast::pow(chi, tersoff_n);
+            Scalar sum_gamma_chi = Scalar(1.0) + gamman * chin;
+
+            // compute bij and its derivative
+            bij = fast::pow( sum_gamma_chi, Scalar(-0.5) / tersoff_n );
+            dbij = Scalar(0.0);
+            if (chi != Scalar(0.0))
+                dbij = Scalar(-0.5) * fast::pow( chi, tersoff_n - Scalar(1.0) )
+                    * gamman * fast::pow( sum_gamma_chi, Scalar(-0.5) / tersoff_n - Scalar(1.0) );
+
+            // compute the ij force
+            force_divr = Scalar(-0.5)
+                * ( dfcut_ij * ( fR - bij * fA ) + fcut_ij * ( dfR - bij * dfA ) ) / rij;
+
+            // compute the potential energy
+            potential_eng = Scalar(0.5) * fcut_ij * (fR - bij * fA);
+            }
+
+        //! Evaluate the forces due to ijk interactions from the cached triplet terms
+        /*! \param fA Attractive term
+            \param chi Sum of the triplet terms of this pair
+            \param rij Distance between particles i and j
+            \param rik Distance between particles i and k
+            \param fcut_ij Cutoff function of \a rij
+            \param dbij Derivative of the bond order from evalForceijCached()
+            \param t Triplet terms from evalChiCached()
+            \param force_divr_ij Returns the forces along rij
+            \param force_divr_ik Returns the forces along rik
+            \returns true if the triplet exerts a force
+
+            The result equals evalForceik().
+        */
+        DEVICE bool evalForceikCached(Scalar fA,
+                                      Scalar chi,
+                                      Scalar rij,
+                                      Scalar rik,
+                                      Scalar fcut_ij,
+                                      Scalar dbij,
+                                      const triplet_type& t,
+                                      Scalar3& force_divr_ij,
+                                      Scalar3& force_divr_ik)
+            {
+            if (chi != Scalar(0.0))
+                {
+                Scalar inv_rij = Scalar(1.0) / rij;
+                Scalar inv_rik = Scalar(1.0) / rik;
+
+                // derivatives of g
+                Scalar dg_ij_i = t.dg * ( inv_rik - t.cos_th * inv_rij );
+                Scalar dg_ik_i = t.dg * ( inv_rij - t.cos_th * inv_rik );
+                Scalar dg_ij_j = t.dg * ( t.cos_th * inv_rij );
+                Scalar dg_ik_j = Scalar(-1.0) * t.dg * inv_rij;
+                Scalar dg_ij_k = Scalar(-1.0) * t.dg * inv_rik;
+                Scalar dg_ik_k = t.dg * ( t.cos_th * inv_rik );
+
+                // derivatives of chi
+                Scalar fgh = t.dfcut_ik * t.g * t.h;
+                Scalar fgdh = t.fcut_ik * t.g * t.dh;
+                Scalar fh = t.fcut_ik * t.h;
+                Scalar dchi_ij_i = fh * dg_ij_i + fgdh;
+                Scalar dchi_ik_i = fgh + fh * dg_ik_i - fgdh;
+
+                Scalar dchi_ij_j = fh * dg_ij_j - fgdh;
+                Scalar dchi_ik_j = fh * dg_ik_j;
+
+                Scalar dchi_ij_k = fh * dg_ij_k;
+                Scalar dchi_ik_k = -fgh + fh * dg_ik_k + fgdh;
+
+                // compute the forces
+                Scalar F = Scalar(0.5) * fcut_ij * dbij * fA;
+                Scalar F_ij = F * inv_rij;
+                Scalar F_ik = F * inv_rik;
+                // assign the ij forces
+                force_divr_ij.x = F_ij * dchi_ij_i;
+                force_divr_ij.y = F_ij * dchi_ij_j;
+                force_divr_ij.z = F_ij * dchi_ij_k;
+                // assign the ik forces
+                force_divr_ik.x = F_ik * dchi_ik_i;
+                force_divr_ik.y = F_ik * dchi_ik_j;
+                force_divr_ik.z = F_ik * dchi_ik_k;
+
+                return true;
+                }
+            else return false;
+            }
+
         //! Evaluate the forces due to ijk interactions
         DEVICE bool evalForceik(Scalar fR,
                                 Scalar fA,
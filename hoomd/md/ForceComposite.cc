@@ -7,6 +7,11 @@
 #include "ForceComposite.h"
 #include "hoomd/VectorMath.h"
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+#include <climits>
 #include <map>
 #include <string.h>
 namespace py = pybind11;
@@ -18,7 +23,8 @@ namespace py = pybind11;
 /*! \param sysdef SystemDefinition containing the ParticleData to compute forces on
 */
 ForceComposite::ForceComposite(std::shared_ptr<SystemDefinition> sysdef)
-        : MolecularForceCompute(sysdef), m_bodies_changed(false), m_ptls_added_removed(false)
+        : MolecularForceCompute(sysdef), m_bodies_changed(false), m_ptls_added_removed(false),
+          m_templates_changed(true), m_template_stride(0)
     {
     // connect to the ParticleData to receive notifications when the number of types changes
     m_pdata->getNumTypesChangeSignal().connect<ForceComposite, &ForceComposite::slotNumTypesChange>(this);
@@ -156,6 +162,7 @@ void ForceComposite::setParam(unsigned int body_typeid,
             }
 
         m_bodies_changed = true;
+        m_templates_changed = true;
         assert(m_d_max_changed.size() > body_typeid);
 
         // make sure central particle will be communicated
@@ -197,6 +204,49 @@ void ForceComposite::slotNumTypesChange()
 
     m_d_max.resize(new_ntypes, Scalar(0.0));
     m_d_max_changed.resize(new_ntypes, false);
+
+    m_templates_changed = true;
+    }
+
+void ForceComposite::updateTemplates()
+    {
+    if (! m_templates_changed)
+        return;
+
+    unsigned int ntypes = m_body_len.getNumElements();
+    m_template_stride = m_body_pos.getHeight();
+
+    unsigned int n = ntypes*m_template_stride;
+    m_template_pos_x.resize(n);
+    m_template_pos_y.resize(n);
+    m_template_pos_z.resize(n);
+    m_template_orientation_s.resize(n);
+    m_template_orientation_x.resize(n);
+    m_template_orientation_y.resize(n);
+    m_template_orientation_z.resize(n);
+
+    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_body_orientation(m_body_orientation, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+
+    for (unsigned int type = 0; type < ntypes; ++type)
+        {
+        for (unsigned int j = 0; j < h_body_len.data[type]; ++j)
+            {
+            unsigned int k = type*m_template_stride + j;
+            Scalar3 pos = h_body_pos.data[m_body_idx(type,j)];
+            Scalar4 orientation = h_body_orientation.data[m_body_idx(type,j)];
+            m_template_pos_x[k] = pos.x;
+            m_template_pos_y[k] = pos.y;
+            m_template_pos_z[k] = pos.z;
+            m_template_orientation_s[k] = orientation.x;
+            m_template_orientation_x[k] = orientation.y;
+            m_template_orientation_y[k] = orientation.z;
+            m_template_orientation_z[k] = orientation.w;
+            }
+        }
+
+    m_templates_changed = false;
     }
 
 Scalar ForceComposite::requestExtraGhostLayerWidth(unsigned int type)
@@ -657,13 +707,13 @@ CommFlags ForceComposite::getRequestedCommFlags(unsigned int timestep)
 //! Compute the forces and torques on the central particle
 void ForceComposite::computeForces(unsigned int timestep)
     {
+    updateTemplates();
+
     // access local molecule data
     // need to move this on top because of scoping issues
-    Index2D molecule_indexer = getMoleculeIndexer();
-    unsigned int nmol = molecule_indexer.getW();
-
-    ArrayHandle<unsigned int> h_molecule_length(getMoleculeLengths(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_molecule_list(getMoleculeList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_molecule_members(getMoleculeMembers(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_molecule_members_head(getMoleculeMembersHead(), access_location::host, access_mode::read);
+    unsigned int nmol = getMoleculeMembersHead().size() ? getMoleculeMembersHead().size() - 1 : 0;
 
     // access particle data
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
@@ -683,7 +733,6 @@ void ForceComposite::computeForces(unsigned int timestep)
     ArrayHandle<Scalar> h_virial(m_virial, access_location::host, access_mode::overwrite);
 
     // access rigid body definition
-    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
 
     // reset constraint forces and torques
@@ -701,14 +750,20 @@ void ForceComposite::computeForces(unsigned int timestep)
         compute_virial = true;
         }
 
+    // lowest tag of an incomplete body, reported after the parallel loop
+    unsigned int incomplete_body = UINT_MAX;
+
     // loop over all molecules, also incomplete ones
-    for (unsigned int ibody = 0; ibody < nmol; ibody++)
+    #pragma omp parallel for schedule(static) reduction(min:incomplete_body)
+    for (int ibody = 0; ibody < (int)nmol; ibody++)
         {
-        unsigned int len = h_molecule_length.data[ibody];
+        unsigned int head = h_molecule_members_head.data[ibody];
+        unsigned int len = h_molecule_members_head.data[ibody+1] - head;
+        const unsigned int *members = h_molecule_members.data + head;
 
         // get central ptl tag from first ptl in molecule
         assert(len>0);
-        unsigned int first_idx = h_molecule_list.data[molecule_indexer(ibody,0)];
+        unsigned int first_idx = members[0];
 
         assert(first_idx < m_pdata->getN() + m_pdata->getNGhosts());
         unsigned int central_tag = h_body.data[first_idx];
@@ -723,19 +778,33 @@ void ForceComposite::computeForces(unsigned int timestep)
 
         // central ptl position and orientation
         Scalar4 postype = h_postype.data[central_idx];
-        quat<Scalar> orientation(h_orientation.data[central_idx]);
+        rotmat3<Scalar> rotation(quat<Scalar>(h_orientation.data[central_idx]));
 
         // body type
         unsigned int type = __scalar_as_int(postype.w);
+        unsigned int template_head = type*m_template_stride;
+
+        bool central_local = central_idx < m_pdata->getN();
+
+        // if the central particle is local, the molecule should be complete
+        if (central_local && len != h_body_len.data[type] + 1)
+            {
+            if (central_tag < incomplete_body)
+                incomplete_body = central_tag;
+            continue;
+            }
+
+        vec3<Scalar> force(0.0,0.0,0.0);
+        vec3<Scalar> torque(0.0,0.0,0.0);
+        Scalar energy(0.0);
+        Scalar virial[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
 
         // sum up forces and torques from constituent particles
-        for (unsigned int jptl = 0; jptl < len; ++jptl)
+        for (unsigned int jptl = 1; jptl < len; ++jptl)
             {
-            unsigned int idxj = h_molecule_list.data[molecule_indexer(ibody, jptl)];
+            unsigned int idxj = members[jptl];
             assert(idxj < m_pdata->getN() + m_pdata->getNGhosts());
-
-            assert(idxj == central_idx || jptl > 0);
-            if (idxj == central_idx) continue;
+            assert(idxj != central_idx);
 
             // force and torque on particle
             Scalar4 net_force = h_net_force.data[idxj];
@@ -748,72 +817,59 @@ void ForceComposite::computeForces(unsigned int timestep)
             h_net_torque.data[idxj] = make_scalar4(0.0,0.0,0.0,0.0);
 
             // only add forces for local central particles
-            if (central_idx < m_pdata->getN())
-                {
-                // if the central particle is local, the molecule should be complete
-                if (len != h_body_len.data[type] + 1)
-                    {
-                    m_exec_conf->msg->error() << "constrain.rigid(): Composite particle with body tag " << central_tag << " incomplete"
-                        << std::endl << std::endl;
-                    throw std::runtime_error("Error computing composite particle forces.\n");
-                    }
+            if (! central_local) continue;
 
-                // sum up center of mass force
-                h_force.data[central_idx].x += f.x;
-                h_force.data[central_idx].y += f.y;
-                h_force.data[central_idx].z += f.z;
+            // sum up center of mass force and energy
+            force += f;
+            energy += net_force.w;
 
-                // sum up energy
-                h_force.data[central_idx].w += net_force.w;
+            // fetch relative position from rigid body definition and rotate into space frame
+            unsigned int k = template_head + jptl - 1;
+            vec3<Scalar> dr_space = rotation*vec3<Scalar>(m_template_pos_x[k], m_template_pos_y[k], m_template_pos_z[k]);
 
-                // fetch relative position from rigid body definition
-                vec3<Scalar> dr(h_body_pos.data[m_body_idx(type, jptl - 1)]);
+            // torque = r x f
+            torque += cross(dr_space,f);
 
-                // rotate into space frame
-                vec3<Scalar> dr_space = rotate(orientation, dr);
+            /* from previous rigid body implementation: Access Torque elements from a single particle. Right now I will am assuming that the particle
+                and rigid body reference frames are the same. Probably have to rotate first.
+             */
+            torque += vec3<Scalar>(net_torque);
 
-                // torque = r x f
-                vec3<Scalar> delta_torque(cross(dr_space,f));
-                h_torque.data[central_idx].x += delta_torque.x;
-                h_torque.data[central_idx].y += delta_torque.y;
-                h_torque.data[central_idx].z += delta_torque.z;
+            if (compute_virial)
+                {
+                // subtract intra-body virial prt
+                virial[0] += h_net_virial.data[0*net_virial_pitch+idxj] - f.x*dr_space.x;
+                virial[1] += h_net_virial.data[1*net_virial_pitch+idxj] - f.x*dr_space.y;
+                virial[2] += h_net_virial.data[2*net_virial_pitch+idxj] - f.x*dr_space.z;
+                virial[3] += h_net_virial.data[3*net_virial_pitch+idxj] - f.y*dr_space.y;
+                virial[4] += h_net_virial.data[4*net_virial_pitch+idxj] - f.y*dr_space.z;
+                virial[5] += h_net_virial.data[5*net_virial_pitch+idxj] - f.z*dr_space.z;
+
+                // zero net virial
+                for (unsigned int i = 0; i < 6; ++i)
+                    h_net_virial.data[i*net_virial_pitch+idxj] = 0.0;
+                }
+            }
 
-                /* from previous rigid body implementation: Access Torque elements from a single particle. Right now I will am assuming that the particle
-                    and rigid body reference frames are the same. Probably have to rotate first.
-                 */
-                h_torque.data[central_idx].x += net_torque.x;
-                h_torque.data[central_idx].y += net_torque.y;
-                h_torque.data[central_idx].z += net_torque.z;
+        if (central_local)
+            {
+            h_force.data[central_idx] = make_scalar4(force.x, force.y, force.z, energy);
+            h_torque.data[central_idx] = make_scalar4(torque.x, torque.y, torque.z, 0.0);
 
-                if (compute_virial)
-                    {
-                    // sum up virial
-                    Scalar virialxx = h_net_virial.data[0*net_virial_pitch+idxj];
-                    Scalar virialxy = h_net_virial.data[1*net_virial_pitch+idxj];
-                    Scalar virialxz = h_net_virial.data[2*net_virial_pitch+idxj];
-                    Scalar virialyy = h_net_virial.data[3*net_virial_pitch+idxj];
-                    Scalar virialyz = h_net_virial.data[4*net_virial_pitch+idxj];
-                    Scalar virialzz = h_net_virial.data[5*net_virial_pitch+idxj];
-
-                    // zero net virial
-                    h_net_virial.data[0*net_virial_pitch+idxj] = 0.0;
-                    h_net_virial.data[1*net_virial_pitch+idxj] = 0.0;
-                    h_net_virial.data[2*net_virial_pitch+idxj] = 0.0;
-                    h_net_virial.data[3*net_virial_pitch+idxj] = 0.0;
-                    h_net_virial.data[4*net_virial_pitch+idxj] = 0.0;
-                    h_net_virial.data[5*net_virial_pitch+idxj] = 0.0;
-
-                    // subtract intra-body virial prt
-                    h_virial.data[0*m_virial_pitch+central_idx] += virialxx - f.x*dr_space.x;
-                    h_virial.data[1*m_virial_pitch+central_idx] += virialxy - f.x*dr_space.y;
-                    h_virial.data[2*m_virial_pitch+central_idx] += virialxz - f.x*dr_space.z;
-                    h_virial.data[3*m_virial_pitch+central_idx] += virialyy - f.y*dr_space.y;
-                    h_virial.data[4*m_virial_pitch+central_idx] += virialyz - f.y*dr_space.z;
-                    h_virial.data[5*m_virial_pitch+central_idx] += virialzz - f.z*dr_space.z;
-                    }
+            if (compute_virial)
+                {
+                for (unsigned int i = 0; i < 6; ++i)
+                    h_virial.data[i*m_virial_pitch+central_idx] = virial[i];
                 }
             }
         }
+
+    if (incomplete_body != UINT_MAX)
+        {
+        m_exec_conf->msg->error() << "constrain.rigid(): Composite particle with body tag " << incomplete_body
+            << " incomplete" << std::endl << std::endl;
+        throw std::runtime_error("Error computing composite particle forces.\n");
+        }
     }
 
 /* Set position and velocity of constituent particles in rigid bodies in the 1st or second half of integration on the CPU
@@ -822,111 +878,127 @@ void ForceComposite::computeForces(unsigned int timestep)
 
 void ForceComposite::updateCompositeParticles(unsigned int timestep)
     {
-    // access molecule order (this needs to be on top because of ArrayHandle scope)
-    ArrayHandle<unsigned int> h_molecule_order(getMoleculeOrder(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_molecule_len(getMoleculeLengths(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_molecule_idx(getMoleculeIndex(), access_location::host, access_mode::read);
+    updateTemplates();
+
+    // access the contiguous member list (this needs to be on top because of ArrayHandle scope)
+    ArrayHandle<unsigned int> h_molecule_members(getMoleculeMembers(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_molecule_members_head(getMoleculeMembersHead(), access_location::host, access_mode::read);
+    unsigned int nmol = getMoleculeMembersHead().size() ? getMoleculeMembersHead().size() - 1 : 0;
 
     // access the particle data arrays
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    /*
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    */
-
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
-    // access body positions and orientations
-    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_body_orientation(m_body_orientation, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
     const BoxDim& global_box = m_pdata->getGlobalBox();
 
-    // we need to update both local and ghost particles
-    unsigned int nptl = m_pdata->getN() + m_pdata->getNGhosts();
+    unsigned int N = m_pdata->getN();
+
+    // lowest tags of a missing central particle and of an incomplete body, reported after the parallel loop
+    unsigned int missing_central = UINT_MAX;
+    unsigned int incomplete_body = UINT_MAX;
 
-    for (unsigned int iptl = 0; iptl < nptl; iptl++)
+    // we need to update both local and ghost particles
+    #pragma omp parallel for schedule(static) reduction(min:missing_central,incomplete_body)
+    for (int ibody = 0; ibody < (int)nmol; ibody++)
         {
-        unsigned int central_tag = h_body.data[iptl];
+        unsigned int head = h_molecule_members_head.data[ibody];
+        unsigned int len = h_molecule_members_head.data[ibody+1] - head;
+        const unsigned int *members = h_molecule_members.data + head;
 
-        if (central_tag == NO_BODY)
-            continue;
+        // does this molecule have local members?
+        bool has_local = false;
+        for (unsigned int j = 0; j < len; ++j)
+            {
+            if (members[j] < N)
+                has_local = true;
+            }
+
+        unsigned int central_tag = h_body.data[members[0]];
 
         // body tag equals tag for central ptl
         assert(central_tag <= m_pdata->getMaximumTag());
         unsigned int central_idx = h_rtag.data[central_tag];
 
-        if (central_idx == NOT_LOCAL && iptl >= m_pdata->getN())
-            continue;
-
         if (central_idx == NOT_LOCAL)
             {
-            m_exec_conf->msg->error() << "constrain.rigid(): Missing central particle tag " << central_tag << "!"
-                << std::endl << std::endl;
-            throw std::runtime_error("Error updating composite particles.\n");
+            if (has_local && central_tag < missing_central)
+                missing_central = central_tag;
+            continue;
             }
 
         // central ptl position and orientation
         assert(central_idx <= m_pdata->getN() + m_pdata->getNGhosts());
-
-        // do not overwrite the central ptl
-        if (iptl == central_idx) continue;
+        assert(central_idx == members[0]);
 
         Scalar4 postype = h_postype.data[central_idx];
         vec3<Scalar> pos(postype);
         quat<Scalar> orientation(h_orientation.data[central_idx]);
+        rotmat3<Scalar> rotation(orientation);
 
         // body type
         unsigned int type = __scalar_as_int(postype.w);
 
-        unsigned int body_len = h_body_len.data[type];
-        unsigned int mol_idx = h_molecule_idx.data[iptl];
-        if (body_len != h_molecule_len.data[mol_idx] - 1)
+        if (h_body_len.data[type] != len - 1)
             {
-            if (iptl < m_pdata->getN())
-                {
-                // if the molecule is incomplete and has local members, this is an error
-                m_exec_conf->msg->error() << "constrain.rigid(): Composite particle with body tag " << central_tag << " incomplete"
-                    << std::endl << std::endl;
-                throw std::runtime_error("Error while updating constituent particles.\n");
-                }
+            // if the molecule is incomplete and has local members, this is an error
+            if (has_local && central_tag < incomplete_body)
+                incomplete_body = central_tag;
 
             // otherwise we must ignore it
             continue;
             }
 
         int3 img = h_image.data[central_idx];
+        unsigned int template_head = type*m_template_stride;
 
-        // fetch relative index in body from molecule list
-        assert(h_molecule_order.data[iptl] > 0);
-        unsigned int idx_in_body = h_molecule_order.data[iptl] - 1;
+        // do not overwrite the central ptl
+        for (unsigned int jptl = 1; jptl < len; ++jptl)
+            {
+            unsigned int iptl = members[jptl];
+            unsigned int k = template_head + jptl - 1;
+
+            vec3<Scalar> local_pos(m_template_pos_x[k], m_template_pos_y[k], m_template_pos_z[k]);
+            vec3<Scalar> dr_space = rotation*local_pos;
 
-        vec3<Scalar> local_pos(h_body_pos.data[m_body_idx(type,idx_in_body)]);
-        vec3<Scalar> dr_space = rotate(orientation, local_pos);
+            // update position and orientation
+            vec3<Scalar> updated_pos(pos);
+            quat<Scalar> local_orientation(m_template_orientation_s[k],
+                vec3<Scalar>(m_template_orientation_x[k], m_template_orientation_y[k], m_template_orientation_z[k]));
 
-        // update position and orientation
-        vec3<Scalar> updated_pos(pos);
-        quat<Scalar> local_orientation(h_body_orientation.data[m_body_idx(type, idx_in_body)]);
+            updated_pos += dr_space;
+            quat<Scalar> updated_orientation = orientation*local_orientation;
 
-        updated_pos += dr_space;
-        quat<Scalar> updated_orientation = orientation*local_orientation;
+            // this runs before the ForceComputes,
+            // wrap into box, allowing rigid bodies to span multiple images
+            int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
+            int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
+            updated_pos = global_box.shift(updated_pos, negimgi);
+
+            h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
+            h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
+            h_image.data[iptl] = img+imgi;
+            }
+        }
 
-        // this runs before the ForceComputes,
-        // wrap into box, allowing rigid bodies to span multiple images
-        int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
-        int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
-        updated_pos = global_box.shift(updated_pos, negimgi);
+    if (missing_central != UINT_MAX)
+        {
+        m_exec_conf->msg->error() << "constrain.rigid(): Missing central particle tag " << missing_central << "!"
+            << std::endl << std::endl;
+        throw std::runtime_error("Error updating composite particles.\n");
+        }
 
-        h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
-        h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
-        h_image.data[iptl] = img+imgi;
+    if (incomplete_body != UINT_MAX)
+        {
+        m_exec_conf->msg->error() << "constrain.rigid(): Composite particle with body tag " << incomplete_body
+            << " incomplete" << std::endl << std::endl;
+        throw std::runtime_error("Error while updating constituent particles.\n");
         }
     }
 
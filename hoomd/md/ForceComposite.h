@@ -17,6 +17,10 @@
 
     The particle data body tag is equal to the tag of central particle, and therefore not-contiguous.
     The molecule/body id can therefore be used to look up the central particle easily.
+
+    On the CPU, constituent updates and force reductions loop over bodies, reading the members of every body
+    from the contiguous molecule member list. The rotation matrix of a body is computed once and applied to all of
+    its constituents. Both loops are threaded with OpenMP, every body only writes to its own particles.
 */
 
 #ifdef NVCC
@@ -87,6 +91,21 @@ class ForceComposite : public MolecularForceCompute
         std::vector<Scalar> m_d_max;                              //!< Maximum body diameter per type
         std::vector<bool> m_d_max_changed;                        //!< True if maximum body diameter changed (per type)
 
+        /* Host copies of the body templates in structure of arrays form, with the constituents of a body type
+           stored contiguously. Used by the CPU implementation. */
+        bool m_templates_changed;                     //!< True if the SoA templates need to be rebuilt
+        unsigned int m_template_stride;               //!< Maximum number of constituents per body type
+        std::vector<Scalar> m_template_pos_x;         //!< Constituent x offsets
+        std::vector<Scalar> m_template_pos_y;         //!< Constituent y offsets
+        std::vector<Scalar> m_template_pos_z;         //!< Constituent z offsets
+        std::vector<Scalar> m_template_orientation_s; //!< Constituent orientations, real part
+        std::vector<Scalar> m_template_orientation_x; //!< Constituent orientations, x component
+        std::vector<Scalar> m_template_orientation_y; //!< Constituent orientations, y component
+        std::vector<Scalar> m_template_orientation_z; //!< Constituent orientations, z component
+
+        //! Copy the body templates into the SoA arrays if they have changed
+        void updateTemplates();
+
         //! Helper function to be called when the number of types changes
         void slotNumTypesChange();
 
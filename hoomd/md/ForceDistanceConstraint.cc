@@ -6,6 +6,10 @@
 
 #include "ForceDistanceConstraint.h"
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
 #include <string.h>
 using namespace Eigen;
 namespace py = pybind11;
@@ -21,7 +25,8 @@ ForceDistanceConstraint::ForceDistanceConstraint(std::shared_ptr<SystemDefinitio
           m_cmatrix(m_exec_conf), m_cvec(m_exec_conf), m_lagrange(m_exec_conf),
           m_rel_tol(1e-3), m_constraint_violated(m_exec_conf), m_condition(m_exec_conf),
           m_sparse_idxlookup(m_exec_conf), m_constraint_reorder(true), m_constraints_added_removed(true),
-          m_d_max(0.0)
+          m_d_max(0.0), m_iterative(false), m_solver_tol(1e-10), m_max_iterations(1000), m_n_iterations(0),
+          m_residual(0.0)
     {
     m_constraint_violated.resetFlags(0);
 
@@ -63,17 +68,32 @@ void ForceDistanceConstraint::computeForces(unsigned int timestep)
 
     // reallocate through amortized resizin
     unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
-    m_cmatrix.resize(n_constraint*n_constraint);
     m_cvec.resize(n_constraint);
 
-    // populate the terms in the matrix vector equation
-    fillMatrixVector(timestep);
+    if (m_iterative)
+        {
+        // populate the terms needed for matrix vector products
+        fillConstraintVectors(timestep);
+
+        // check violations
+        checkConstraints(timestep);
+
+        // solve the matrix vector equation
+        solveConstraintsIterative(timestep);
+        }
+    else
+        {
+        m_cmatrix.resize(n_constraint*n_constraint);
+
+        // populate the terms in the matrix vector equation
+        fillMatrixVector(timestep);
 
-    // check violations
-    checkConstraints(timestep);
+        // check violations
+        checkConstraints(timestep);
 
-    // solve the matrix vector equation
-    solveConstraints(timestep);
+        // solve the matrix vector equation
+        solveConstraints(timestep);
+        }
 
     // compute forces
     computeConstraintForces(timestep);
@@ -372,6 +392,330 @@ void ForceDistanceConstraint::solveConstraints(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! Computes the constraint vectors, the RHS of the constraint equation and the diagonal of the constraint matrix,
+    and builds the list of constraints of every particle that is used to evaluate matrix vector products.
+ */
+void ForceDistanceConstraint::fillConstraintVectors(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+
+    m_rn.resize(n_constraint);
+    m_qn.resize(n_constraint);
+    m_diag.resize(n_constraint);
+    m_ptl_con.resize(2*n_constraint);
+    m_ptl_con_head.assign(max_local+1, 0);
+    m_ptl_inv_mass.resize(max_local);
+    m_ptl_sum.resize(max_local);
+
+    // access particle data
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::overwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    // count the constraints of every particle
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+        assert(constraint.tag[0] <= m_pdata->getMaximumTag());
+        assert(constraint.tag[1] <= m_pdata->getMaximumTag());
+
+        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+        if (idx_a >= max_local || idx_b >= max_local)
+            {
+            this->m_exec_conf->msg->error() << "constrain.distance(): constraint " <<
+                constraint.tag[0] << " " << constraint.tag[1] << " incomplete." << std::endl << std::endl;
+            throw std::runtime_error("Error in constraint calculation");
+            }
+
+        m_ptl_con_head[idx_a+1]++;
+        m_ptl_con_head[idx_b+1]++;
+        }
+
+    for (unsigned int i = 0; i < max_local; ++i)
+        {
+        m_ptl_con_head[i+1] += m_ptl_con_head[i];
+        }
+
+        {
+        // fill the constraint lists, ordered by constraint index
+        std::vector<unsigned int> fill(m_ptl_con_head.begin(), m_ptl_con_head.end()-1);
+        for (unsigned int n = 0; n < n_constraint; ++n)
+            {
+            const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+            unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+            unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+            m_ptl_con[fill[idx_a]++] = 2*n;
+            m_ptl_con[fill[idx_b]++] = 2*n+1;
+            }
+        }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < (int)max_local; ++i)
+        m_ptl_inv_mass[i] = double(1.0)/double(h_vel.data[i].w);
+
+    // lowest violated constraint index, so that the reported violation does not depend on thread scheduling
+    unsigned int first_violated = n_constraint;
+
+    #pragma omp parallel for schedule(static) reduction(min:first_violated)
+    for (int n = 0; n < (int)n_constraint; ++n)
+        {
+        const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+        vec3<Scalar> ra(h_pos.data[idx_a]);
+        vec3<Scalar> rb(h_pos.data[idx_b]);
+        vec3<Scalar> rn(ra-rb);
+
+        // apply minimum image
+        rn = box.minImage(rn);
+
+        vec3<Scalar> va(h_vel.data[idx_a]);
+        Scalar ma(h_vel.data[idx_a].w);
+        vec3<Scalar> vb(h_vel.data[idx_b]);
+        Scalar mb(h_vel.data[idx_b].w);
+
+        vec3<Scalar> rndot(va-vb);
+        vec3<Scalar> qn(rn+rndot*m_deltaT);
+
+        m_rn[n] = vec3<double>(rn);
+        m_qn[n] = vec3<double>(qn);
+        m_diag[n] = double(4.0)*dot(m_qn[n],m_rn[n])*(m_ptl_inv_mass[idx_a] + m_ptl_inv_mass[idx_b]);
+
+        // get constraint distance
+        Scalar d = m_cdata->getValueByIndex(n);
+
+        // check distance violation
+        if (fast::sqrt(dot(rn,rn))-d >= m_rel_tol*d || std::isnan(dot(rn,rn)))
+            {
+            if ((unsigned int)n < first_violated)
+                first_violated = n;
+            }
+
+        // fill vector component
+        h_cvec.data[n] = (dot(qn,qn)-d*d)/m_deltaT/m_deltaT;
+        h_cvec.data[n] += double(2.0)*dot(qn,vec3<Scalar>(h_netforce.data[idx_a])/ma
+              -vec3<Scalar>(h_netforce.data[idx_b])/mb);
+        }
+
+    if (first_violated < n_constraint)
+        m_constraint_violated.resetFlags(first_violated+1);
+    }
+
+/*! \param x Input vector, one element per constraint
+    \param y Output vector, y = A x
+
+    The matrix element A_nm couples constraints n and m that share a particle. Summing x_m r_m / m_p over the
+    constraints m of every particle p first turns the product into two gathers, each of which is threaded.
+ */
+void ForceDistanceConstraint::multiplyConstraintMatrix(const std::vector<double>& x, std::vector<double>& y)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < (int)max_local; ++i)
+        {
+        vec3<double> sum(0.0,0.0,0.0);
+        for (unsigned int k = m_ptl_con_head[i]; k < m_ptl_con_head[i+1]; ++k)
+            {
+            unsigned int m = m_ptl_con[k] >> 1;
+
+            // the constraint vector points from the second to the first member
+            if (m_ptl_con[k] & 1)
+                sum -= x[m]*m_rn[m];
+            else
+                sum += x[m]*m_rn[m];
+            }
+        m_ptl_sum[i] = sum*m_ptl_inv_mass[i];
+        }
+
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < (int)n_constraint; ++n)
+        {
+        const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+        y[n] = double(4.0)*dot(m_qn[n], m_ptl_sum[idx_a] - m_ptl_sum[idx_b]);
+        }
+    }
+
+//! Dot product of two vectors of Lagrange multipliers
+static double dot_vec(const std::vector<double>& a, const std::vector<double>& b)
+    {
+    double sum = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (int i = 0; i < (int)a.size(); ++i)
+        sum += a[i]*b[i];
+    return sum;
+    }
+
+/*! Solves the constraint equation with a BiCGSTAB iteration that is right-preconditioned with the diagonal
+    of the matrix. The solution of the previous time step is used as the initial guess.
+ */
+void ForceDistanceConstraint::solveConstraintsIterative(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    // skip if zero constraints
+    if (n_constraint == 0) return;
+
+    if (m_prof)
+        m_prof->push("solve");
+
+    // reallocate array of constraint forces
+    m_lagrange.resize(n_constraint);
+
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::read);
+    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_group_tag(m_cdata->getTags(), access_location::host, access_mode::read);
+
+    if (m_lagrange_tag.size() < m_cdata->getMaximumTag()+1)
+        m_lagrange_tag.resize(m_cdata->getMaximumTag()+1, 0.0);
+
+    // initial guess from the previous step
+    std::vector<double> x(n_constraint), b(h_cvec.data, h_cvec.data+n_constraint);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        x[n] = m_lagrange_tag[h_group_tag.data[n]];
+
+    std::vector<double> r(n_constraint), r0(n_constraint), p(n_constraint, 0.0), v(n_constraint, 0.0);
+    std::vector<double> y(n_constraint), z(n_constraint), s(n_constraint), t(n_constraint);
+
+    // r = b - A x
+    multiplyConstraintMatrix(x, r);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        r[n] = b[n] - r[n];
+    r0 = r;
+
+    double norm_b = sqrt(dot_vec(b,b));
+    if (norm_b == 0.0)
+        norm_b = 1.0;
+    double tol = m_solver_tol*norm_b;
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    double norm_r = sqrt(dot_vec(r,r));
+    unsigned int iter = 0;
+
+    while (norm_r > tol && iter < m_max_iterations)
+        {
+        iter++;
+
+        double rho_new = dot_vec(r0, r);
+        if (rho_new == 0.0)
+            {
+            // the iteration broke down, restart from the current residual
+            r0 = r;
+            std::fill(p.begin(), p.end(), 0.0);
+            std::fill(v.begin(), v.end(), 0.0);
+            rho = alpha = omega = 1.0;
+            rho_new = dot_vec(r0, r);
+            }
+
+        double beta = (rho_new/rho)*(alpha/omega);
+        rho = rho_new;
+
+        #pragma omp parallel for schedule(static)
+        for (int n = 0; n < (int)n_constraint; ++n)
+            {
+            p[n] = r[n] + beta*(p[n] - omega*v[n]);
+            y[n] = p[n]/m_diag[n];
+            }
+
+        multiplyConstraintMatrix(y, v);
+        alpha = rho/dot_vec(r0, v);
+
+        #pragma omp parallel for schedule(static)
+        for (int n = 0; n < (int)n_constraint; ++n)
+            {
+            s[n] = r[n] - alpha*v[n];
+            z[n] = s[n]/m_diag[n];
+            }
+
+        double norm_s = sqrt(dot_vec(s,s));
+        if (norm_s <= tol)
+            {
+            #pragma omp parallel for schedule(static)
+            for (int n = 0; n < (int)n_constraint; ++n)
+                x[n] += alpha*y[n];
+            norm_r = norm_s;
+            break;
+            }
+
+        multiplyConstraintMatrix(z, t);
+        double tt = dot_vec(t,t);
+        omega = (tt > 0.0) ? dot_vec(t,s)/tt : 0.0;
+
+        #pragma omp parallel for schedule(static)
+        for (int n = 0; n < (int)n_constraint; ++n)
+            {
+            x[n] += alpha*y[n] + omega*z[n];
+            r[n] = s[n] - omega*t[n];
+            }
+
+        norm_r = sqrt(dot_vec(r,r));
+
+        if (omega == 0.0)
+            break;
+        }
+
+    m_n_iterations = iter;
+    m_residual = norm_r/norm_b;
+
+    if (norm_r > tol || std::isnan(norm_r))
+        {
+        m_exec_conf->msg->warning() << "constrain.distance(): iterative solver did not converge after "
+            << iter << " iterations (relative residual " << m_residual << ")" << std::endl;
+        }
+
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        h_lagrange.data[n] = x[n];
+        m_lagrange_tag[h_group_tag.data[n]] = x[n];
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+std::vector< std::string > ForceDistanceConstraint::getProvidedLogQuantities()
+    {
+    std::vector<std::string> list;
+    list.push_back("constrain_distance_iterations");
+    list.push_back("constrain_distance_residual");
+    return list;
+    }
+
+Scalar ForceDistanceConstraint::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == std::string("constrain_distance_iterations"))
+        {
+        compute(timestep);
+        return Scalar(m_n_iterations);
+        }
+    else if (quantity == std::string("constrain_distance_residual"))
+        {
+        compute(timestep);
+        return m_residual;
+        }
+    else
+        {
+        m_exec_conf->msg->error() << "constrain.distance: " << quantity << " is not a valid log quantity"
+                  << std::endl;
+        throw std::runtime_error("Error getting log value");
+        }
+    }
+
 void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
     {
     ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::read);
@@ -596,5 +940,8 @@ void export_ForceDistanceConstraint(py::module& m)
     py::class_< ForceDistanceConstraint, std::shared_ptr<ForceDistanceConstraint> >(m, "ForceDistanceConstraint", py::base<MolecularForceCompute>())
         .def(py::init< std::shared_ptr<SystemDefinition> >())
         .def("setRelativeTolerance", &ForceDistanceConstraint::setRelativeTolerance)
+        .def("setIterative", &ForceDistanceConstraint::setIterative)
+        .def("setSolverTolerance", &ForceDistanceConstraint::setSolverTolerance)
+        .def("setMaxIterations", &ForceDistanceConstraint::setMaxIterations)
     ;
     }
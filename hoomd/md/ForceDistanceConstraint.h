@@ -21,6 +21,7 @@
 
 #include "hoomd/GPUVector.h"
 #include "hoomd/GPUFlags.h"
+#include "hoomd/VectorMath.h"
 
 #include "hoomd/extern/Eigen/Dense"
 #include "hoomd/extern/Eigen/SparseLU"
@@ -30,6 +31,11 @@
     [1] M. Yoneya, H. J. C. Berendsen, and K. Hirasawa, “A Non-Iterative Matrix Method for Constraint Molecular Dynamics Simulations,” Mol. Simul., vol. 13, no. 6, pp. 395–405, 1994.
     [2] M. Yoneya, “A Generalized Non-iterative Matrix Method for Constraint Molecular Dynamics Simulations,” J. Comput. Phys., vol. 172, no. 1, pp. 188–197, Sep. 2001.
 
+    By default, the constraint matrix is formed and solved with a sparse LU factorization. Alternatively, the system
+    can be solved with a Jacobi preconditioned BiCGSTAB iteration that only needs matrix vector products. These
+    are evaluated from per-particle sums over the constraints of each particle, without forming the matrix. The
+    iteration starts from the Lagrange multipliers of the previous step. It is threaded with OpenMP on the CPU.
+
     See Integrator for detailed documentation on constraint force implementation.
     \ingroup computes
 */
@@ -54,6 +60,33 @@ class ForceDistanceConstraint : public MolecularForceCompute
             m_rel_tol = rel_tol;
             }
 
+        //! Select the matrix-free iterative solver instead of the sparse LU factorization
+        void setIterative(bool iterative)
+            {
+            m_iterative = iterative;
+
+            // the sparse matrix has to be rebuilt when switching back
+            m_constraint_reorder = true;
+            }
+
+        //! Set the relative residual at which the iterative solver stops
+        void setSolverTolerance(Scalar tol)
+            {
+            m_solver_tol = tol;
+            }
+
+        //! Set the maximum number of iterations of the iterative solver
+        void setMaxIterations(unsigned int max_iterations)
+            {
+            m_max_iterations = max_iterations;
+            }
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
@@ -83,6 +116,21 @@ class ForceDistanceConstraint : public MolecularForceCompute
 
         Scalar m_d_max;                    //!< Maximum constraint extension
 
+        bool m_iterative;                  //!< True if the matrix-free iterative solver is used
+        Scalar m_solver_tol;               //!< Relative residual at which the iterative solver stops
+        unsigned int m_max_iterations;     //!< Maximum number of iterations of the iterative solver
+        unsigned int m_n_iterations;       //!< Number of iterations used in the last solve
+        Scalar m_residual;                 //!< Relative residual after the last solve
+
+        std::vector<double> m_lagrange_tag;        //!< Lagrange multipliers of the last solve, indexed by constraint tag
+        std::vector< vec3<double> > m_rn;          //!< Constraint vectors at the current step
+        std::vector< vec3<double> > m_qn;          //!< Unconstrained constraint vectors at the next step
+        std::vector<double> m_diag;                //!< Diagonal of the constraint matrix
+        std::vector<unsigned int> m_ptl_con_head;  //!< Start of the constraint list of every particle
+        std::vector<unsigned int> m_ptl_con;       //!< Constraint index * 2 + member position, per particle
+        std::vector<double> m_ptl_inv_mass;        //!< Inverse particle masses
+        std::vector< vec3<double> > m_ptl_sum;     //!< Per-particle scratch for the matrix vector product
+
         //! Compute the forces
         virtual void computeForces(unsigned int timestep);
 
@@ -98,6 +146,15 @@ class ForceDistanceConstraint : public MolecularForceCompute
         //! Solve the linear matrix-vector equation
         virtual void computeConstraintForces(unsigned int timestep);
 
+        //! Populate the constraint vectors and the RHS for the iterative solver
+        void fillConstraintVectors(unsigned int timestep);
+
+        //! Solve the constraint equation iteratively without forming the matrix
+        void solveConstraintsIterative(unsigned int timestep);
+
+        //! Multiply a vector with the constraint matrix
+        void multiplyConstraintMatrix(const std::vector<double>& x, std::vector<double>& y);
+
         //! Method called when constraint order changes
         virtual void slotConstraintReorder()
             {
@@ -7,6 +7,7 @@
 #include "hoomd/SystemDefinition.h"
 #include "hoomd/ParticleGroup.h"
 #include "hoomd/Profiler.h"
+#include "hoomd/VectorMath.h"
 
 #include <memory>
 
@@ -249,6 +250,17 @@ class IntegrationMethodTwoStep
         //! Set whether this restart is valid
         void setValidRestart(bool b) { m_valid_restart = b; }
 
+        //! Advance the angular momentum by half a step and the orientation by a full step
+        static inline void advanceRotationStepOne(quat<Scalar>& q, quat<Scalar>& p, vec3<Scalar> t,
+            const vec3<Scalar>& I, Scalar deltaT, Scalar exp_thermo_fac);
+
+        //! Advance the angular momentum by half a step
+        static inline void advanceRotationStepTwo(const quat<Scalar>& q, quat<Scalar>& p, vec3<Scalar> t,
+            const vec3<Scalar>& I, Scalar deltaT, Scalar exp_thermo_fac);
+
+        //! Compute twice the rotational kinetic energy of a single particle
+        static inline Scalar rotationalKineticEnergy2(const quat<Scalar>& q, const quat<Scalar>& p, const vec3<Scalar>& I);
+
     protected:
 #ifdef ENABLE_MPI
         std::shared_ptr<Communicator> m_comm;             //!< The communicator to use for MPI
@@ -258,6 +270,156 @@ class IntegrationMethodTwoStep
         bool m_valid_restart;                               //!< True if the restart info was valid when loading
     };
 
+/*! \param q Orientation of the particle, advanced from t to t+deltaT
+    \param p Conjugate quaternion momentum of the particle, advanced from t to t+deltaT/2
+    \param t Net torque on the particle in the space frame
+    \param I Principal moments of inertia of the particle
+    \param deltaT Time step
+    \param exp_thermo_fac Thermostat factor applied to the momentum after the torque kick (1 without a thermostat)
+
+    Implements the first half of the symplectic and time-reversal symmetric NO_SQUISH integration scheme of Miller
+    et al., using a Trotter factorization of the free rotor Liouvillian. Components of the torque along axes with a
+    zero moment of inertia are ignored.
+*/
+inline void IntegrationMethodTwoStep::advanceRotationStepOne(quat<Scalar>& q, quat<Scalar>& p, vec3<Scalar> t,
+    const vec3<Scalar>& I, Scalar deltaT, Scalar exp_thermo_fac)
+    {
+    // rotate torque into principal frame
+    t = rotate(conj(q),t);
+
+    // check for zero moment of inertia
+    bool x_zero, y_zero, z_zero;
+    x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
+
+    // ignore torque component along an axis for which the moment of inertia zero
+    if (x_zero) t.x = 0;
+    if (y_zero) t.y = 0;
+    if (z_zero) t.z = 0;
+
+    // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
+    // using Trotter factorization of rotation Liouvillian
+    p += deltaT*q*t;
+
+    // apply thermostat
+    p = p*exp_thermo_fac;
+
+    quat<Scalar> p1, p2, p3; // permutated quaternions
+    quat<Scalar> q1, q2, q3;
+    Scalar phi1, cphi1, sphi1;
+    Scalar phi2, cphi2, sphi2;
+    Scalar phi3, cphi3, sphi3;
+
+    if (!z_zero)
+        {
+        p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
+        q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
+        phi3 = Scalar(1./4.)/I.z*dot(p,q3);
+        cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
+        sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
+
+        p=cphi3*p+sphi3*p3;
+        q=cphi3*q+sphi3*q3;
+        }
+
+    if (!y_zero)
+        {
+        p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
+        q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
+        phi2 = Scalar(1./4.)/I.y*dot(p,q2);
+        cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
+        sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
+
+        p=cphi2*p+sphi2*p2;
+        q=cphi2*q+sphi2*q2;
+        }
+
+    if (!x_zero)
+        {
+        p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
+        q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
+        phi1 = Scalar(1./4.)/I.x*dot(p,q1);
+        cphi1 = slow::cos(deltaT*phi1);
+        sphi1 = slow::sin(deltaT*phi1);
+
+        p=cphi1*p+sphi1*p1;
+        q=cphi1*q+sphi1*q1;
+        }
+
+    if (! y_zero)
+        {
+        p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
+        q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
+        phi2 = Scalar(1./4.)/I.y*dot(p,q2);
+        cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
+        sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
+
+        p=cphi2*p+sphi2*p2;
+        q=cphi2*q+sphi2*q2;
+        }
+
+    if (! z_zero)
+        {
+        p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
+        q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
+        phi3 = Scalar(1./4.)/I.z*dot(p,q3);
+        cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
+        sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
+
+        p=cphi3*p+sphi3*p3;
+        q=cphi3*q+sphi3*q3;
+        }
+
+    // renormalize (improves stability)
+    q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+    }
+
+/*! \param q Orientation of the particle
+    \param p Conjugate quaternion momentum of the particle, advanced from t+deltaT/2 to t+deltaT
+    \param t Net torque on the particle in the space frame
+    \param I Principal moments of inertia of the particle
+    \param deltaT Time step
+    \param exp_thermo_fac Thermostat factor applied to the momentum before the torque kick (1 without a thermostat)
+*/
+inline void IntegrationMethodTwoStep::advanceRotationStepTwo(const quat<Scalar>& q, quat<Scalar>& p, vec3<Scalar> t,
+    const vec3<Scalar>& I, Scalar deltaT, Scalar exp_thermo_fac)
+    {
+    // rotate torque into principal frame
+    t = rotate(conj(q),t);
+
+    // ignore torque component along an axis for which the moment of inertia zero
+    if (I.x < EPSILON) t.x = 0;
+    if (I.y < EPSILON) t.y = 0;
+    if (I.z < EPSILON) t.z = 0;
+
+    // apply thermostat
+    p = p*exp_thermo_fac;
+
+    // advance p(t+deltaT/2)->p(t+deltaT)
+    p += deltaT*q*t;
+    }
+
+/*! \param q Orientation of the particle
+    \param p Conjugate quaternion momentum of the particle
+    \param I Principal moments of inertia of the particle
+    \returns Twice the rotational kinetic energy, summed over the axes with a non-zero moment of inertia
+
+    This is the same sum that ComputeThermo evaluates, so integrators can fold it into their own loops.
+*/
+inline Scalar IntegrationMethodTwoStep::rotationalKineticEnergy2(const quat<Scalar>& q, const quat<Scalar>& p,
+    const vec3<Scalar>& I)
+    {
+    quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+    Scalar ke_rot = Scalar(0.0);
+    if (I.x >= EPSILON)
+        ke_rot += s.v.x*s.v.x/I.x;
+    if (I.y >= EPSILON)
+        ke_rot += s.v.y*s.v.y/I.y;
+    if (I.z >= EPSILON)
+        ke_rot += s.v.z*s.v.z/I.z;
+    return ke_rot;
+    }
+
 //! Exports the IntegrationMethodTwoStep class to python
 void export_IntegrationMethodTwoStep(pybind11::module& m);
 
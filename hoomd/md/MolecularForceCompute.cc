@@ -20,7 +20,7 @@ namespace py = pybind11;
 MolecularForceCompute::MolecularForceCompute(std::shared_ptr<SystemDefinition> sysdef)
     : ForceConstraint(sysdef), m_molecule_tag(m_exec_conf), m_n_molecules_global(0),
       m_molecule_list(m_exec_conf), m_molecule_length(m_exec_conf), m_molecule_order(m_exec_conf),
-      m_molecule_idx(m_exec_conf), m_dirty(true)
+      m_molecule_idx(m_exec_conf), m_molecule_members(m_exec_conf), m_molecule_members_head(m_exec_conf), m_dirty(true)
     {
     // connect to the ParticleData to recieve notifications when particles change order in memory
     m_pdata->getParticleSortSignal().connect<MolecularForceCompute, &MolecularForceCompute::setDirty>(this);
@@ -145,10 +145,25 @@ void MolecularForceCompute::initMolecules()
     // reset reverse lookup
     memset(h_molecule_idx.data, 0, sizeof(unsigned int)*nptl_local);
 
+    // the contiguous member list holds every particle of a molecule
+    unsigned int n_members = 0;
+    for (unsigned int imol = 0; imol < n_local_molecules; ++imol)
+        {
+        n_members += local_molecules_sorted_by_tag[imol].size();
+        }
+
+    m_molecule_members.resize(n_members);
+    m_molecule_members_head.resize(n_local_molecules+1);
+
+    ArrayHandle<unsigned int> h_molecule_members(m_molecule_members, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_molecule_members_head(m_molecule_members_head, access_location::host, access_mode::overwrite);
+
     unsigned int i_mol = 0;
+    unsigned int i_member = 0;
     for (std::vector< std::set<unsigned int> >::iterator it_mol = local_molecules_sorted_by_tag.begin();
         it_mol != local_molecules_sorted_by_tag.end(); ++it_mol)
         {
+        h_molecule_members_head.data[i_mol] = i_member;
         for (std::set<unsigned int>::iterator it_tag = it_mol->begin(); it_tag != it_mol->end(); ++it_tag)
             {
             unsigned int n = h_molecule_length.data[i_mol]++;
@@ -157,9 +172,11 @@ void MolecularForceCompute::initMolecules()
             h_molecule_list.data[m_molecule_indexer(i_mol, n)] = ptl_idx;
             h_molecule_idx.data[ptl_idx] = i_mol;
             h_molecule_order.data[ptl_idx] = n;
+            h_molecule_members.data[i_member++] = ptl_idx;
             }
         i_mol ++;
         }
+    h_molecule_members_head.data[n_local_molecules] = i_member;
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
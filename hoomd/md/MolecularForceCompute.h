@@ -105,6 +105,22 @@ class MolecularForceCompute : public ForceConstraint
             return m_molecule_idx;
             }
 
+        //! Return the local particle indices of all molecules, with the members of every molecule stored contiguously
+        const GPUVector<unsigned int>& getMoleculeMembers()
+            {
+            checkParticlesSorted();
+
+            return m_molecule_members;
+            }
+
+        //! Return the offset of every molecule into the member array (number of local molecules + 1 elements)
+        const GPUVector<unsigned int>& getMoleculeMembersHead()
+            {
+            checkParticlesSorted();
+
+            return m_molecule_members_head;
+            }
+
     protected:
         GPUVector<unsigned int> m_molecule_tag;     //!< Molecule tag per particle tag
         unsigned int m_n_molecules_global;          //!< Global number of molecules
@@ -114,6 +130,8 @@ class MolecularForceCompute : public ForceConstraint
         GPUVector<unsigned int> m_molecule_length;  //!< List of molecule lengths
         GPUVector<unsigned int> m_molecule_order;   //!< Order in molecule by local ptl idx
         GPUVector<unsigned int> m_molecule_idx;     //!< Reverse-lookup into molecule list
+        GPUVector<unsigned int> m_molecule_members; //!< Local particle indices of molecule members, contiguous per molecule
+        GPUVector<unsigned int> m_molecule_members_head; //!< Offset of every molecule into m_molecule_members
 
         Index2D m_molecule_indexer;                 //!< Index of the molecule table
 
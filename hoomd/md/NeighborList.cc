@@ -198,7 +198,7 @@ NeighborList::~NeighborList()
 /*! Updates the neighborlist if it has not yet been updated this times step
     \param timestep Current time step of the simulation
 */
-void NeighborList::compute(unsigned int timestep)
+void NeighborList::doCompute(unsigned int timestep)
     {
     // check if the rcut array has changed and update it
     if (m_rcut_changed)
@@ -405,7 +405,7 @@ class NeighborList : public Compute
         // @}
 
         //! Computes the NeighborList if it needs updating
-        void compute(unsigned int timestep);
+        virtual void doCompute(unsigned int timestep);
 
         //! Benchmark the neighbor list
         virtual double benchmark(unsigned int num_iters);
@@ -324,7 +324,20 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 //     Index2D nli = m_nlist->getNListIndexer();
     ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    // positions and types are read from the separate x, y, z and type arrays when the SoA layout is enabled
+    const bool soa = m_pdata->getSoALayout();
+    std::unique_ptr< ArrayHandle<Scalar4> > h_pos;
+    std::unique_ptr< SoAHandle > h_soa;
+    if (soa)
+        h_soa.reset(new SoAHandle(*m_pdata, soa_field::position, access_mode::read));
+    else
+        h_pos.reset(new ArrayHandle<Scalar4>(m_pdata->getPositions(), access_location::host, access_mode::read));
+    const Scalar4 *postype = soa ? NULL : h_pos->data;
+    const Scalar *x = soa ? h_soa->x : NULL;
+    const Scalar *y = soa ? h_soa->y : NULL;
+    const Scalar *z = soa ? h_soa->z : NULL;
+    const unsigned int *type = soa ? h_soa->type : NULL;
+
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -350,8 +363,18 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     for (int i = 0; i < (int)m_pdata->getN(); i++)
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        Scalar3 pi;
+        unsigned int typei;
+        if (soa)
+            {
+            pi = make_scalar3(x[i], y[i], z[i]);
+            typei = type[i];
+            }
+        else
+            {
+            pi = make_scalar3(postype[i].x, postype[i].y, postype[i].z);
+            typei = __scalar_as_int(postype[i].w);
+            }
 
         // sanity check
         assert(typei < m_pdata->getNTypes());
@@ -383,12 +406,22 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
             unsigned int j = h_nlist.data[myHead + k];
             assert(j < m_pdata->getN() + m_pdata->getNGhosts());
 
-            // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-            Scalar3 dx = pi - pj;
+            // access the position and type of the neighbor particle (MEM TRANSFER: 4 scalars)
+            Scalar3 pj;
+            unsigned int typej;
+            if (soa)
+                {
+                pj = make_scalar3(x[j], y[j], z[j]);
+                typej = type[j];
+                }
+            else
+                {
+                pj = make_scalar3(postype[j].x, postype[j].y, postype[j].z);
+                typej = __scalar_as_int(postype[j].w);
+                }
 
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+            // calculate dr_ji (FLOPS: 3)
+            Scalar3 dx = pi - pj;
             assert(typej < m_pdata->getNTypes());
 
             // access diameter and charge (if needed)
@@ -14,8 +14,12 @@
 #include "hoomd/Index1D.h"
 #include "hoomd/GPUArray.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/Autotuner.h"
 #include "NeighborList.h"
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 /*! \file PotentialTersoff.h
     \brief Defines the template class for standard three-body potentials
@@ -94,6 +98,25 @@ class PotentialTersoff : public ForceCompute
         //! Calculates the requested log value and returns it
         virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            if (m_thread_tuner)
+                {
+                m_thread_tuner->setPeriod(period);
+                m_thread_tuner->setEnabled(enable);
+                }
+            }
+
+        //! Print the number of threads chosen by the autotuner
+        virtual void printStats()
+            {
+            if (m_thread_tuner)
+                m_thread_tuner->printStats();
+            }
 
     protected:
         std::shared_ptr<NeighborList> m_nlist;    //!< The neighborlist to use for the computation
@@ -104,6 +127,11 @@ class PotentialTersoff : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        GPUArray<Scalar4> m_pair_dr;                //!< Separation (x,y,z) and squared distance (w) per neighbor list entry
+        GPUArray<Scalar3> m_pair_cut;               //!< Distance (x), cutoff function (y) and its derivative (z) per neighbor list entry
+        GPUArray<Scalar4> m_thread_force;           //!< Per-thread force accumulators (CPU only)
+        std::unique_ptr<Autotuner> m_thread_tuner;  //!< Autotuner for the number of threads (CPU only)
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
@@ -154,6 +182,17 @@ PotentialTersoff< evaluator >::PotentialTersoff(std::shared_ptr<SystemDefinition
     m_prof_name = std::string("Triplet ") + evaluator::getName();
     m_log_name = std::string("pair_") + evaluator::getName() + std::string("_energy") + log_suffix;
 
+    // small systems can run faster on fewer threads, tune the number of threads on the CPU
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_thread_tuner.reset(new Autotuner(Autotuner::getThreadCounts(), 5, 100000,
+                                           "pair_threads_" + evaluator::getName(), m_exec_conf));
+        #ifdef ENABLE_MPI
+        // synchronize autotuner results across ranks
+        m_thread_tuner->setSync(bool(m_pdata->getDomainDecomposition()));
+        #endif
+        }
+
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_pdata->getNumTypesChangeSignal().template connect<PotentialTersoff<evaluator>, &PotentialTersoff<evaluator>::slotNumTypesChange>(this);
     }
@@ -263,6 +302,16 @@ Scalar PotentialTersoff< evaluator >::getLogValue(const std::string& quantity, u
     that it is up to date before proceeding.
 
     \param timestep specifies the current time step of the simulation
+
+    The separation vector and squared distance of every neighbor list entry are computed once per step and stored in
+    m_pair_dr, together with the distance, cutoff function and its derivative in m_pair_cut, so that the inner j and k
+    loops only read them. The chi loop over k keeps the bond angle and distance terms of every triplet of the current
+    j (evaluator::triplet_type), which the force loop over k reuses, and the derivative of the bond order is evaluated
+    once per j instead of once per triplet. The cached cutoff function of ik is only used when k has the same type as
+    j, because the triplet terms are evaluated with the parameters of the ij type pair. When running with multiple
+    OpenMP threads, particles are distributed over the threads and every thread accumulates the forces on i, j and k
+    into its own slice of m_thread_force. The slices are summed into the force array at the end, so no two threads
+    ever write the same element. The number of threads is chosen by m_thread_tuner.
 */
 template< class evaluator >
 void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
@@ -282,6 +331,31 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
         throw std::runtime_error("Error computing forces in PotentialTersoff");
         }
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int N_total = N + m_pdata->getNGhosts();
+    const unsigned int ntypes = m_pdata->getNTypes();
+
+    // every parallel region below runs on the number of threads chosen by the autotuner
+    if (m_thread_tuner) m_thread_tuner->begin();
+    unsigned int n_threads = 1;
+    #ifdef ENABLE_OPENMP
+    n_threads = m_thread_tuner ? m_thread_tuner->getParam() : omp_get_max_threads();
+    #endif
+
+    // resize the scratch arrays if needed
+    if (m_pair_dr.getNumElements() < m_nlist->getNListArray().getNumElements())
+        {
+        GPUArray<Scalar4> pair_dr(m_nlist->getNListArray().getNumElements(), m_exec_conf);
+        m_pair_dr.swap(pair_dr);
+        GPUArray<Scalar3> pair_cut(m_nlist->getNListArray().getNumElements(), m_exec_conf);
+        m_pair_cut.swap(pair_cut);
+        }
+    if (n_threads > 1 && m_thread_force.getNumElements() < n_threads*N_total)
+        {
+        GPUArray<Scalar4> thread_force(n_threads*N_total, m_exec_conf);
+        m_thread_force.swap(thread_force);
+        }
+
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
@@ -289,218 +363,251 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
-
     //force arrays
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-
+    ArrayHandle<Scalar4> h_thread_force(m_thread_force, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_pair_dr(m_pair_dr, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_pair_cut(m_pair_cut, access_location::host, access_mode::overwrite);
 
     const BoxDim& box = m_pdata->getBox();
-    ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
     // need to start from a zero force, energy
-    memset(h_force.data, 0, sizeof(Scalar4)*m_pdata->getN());
+    memset(h_force.data, 0, sizeof(Scalar4)*N_total);
+    if (n_threads > 1)
+        memset(h_thread_force.data, 0, sizeof(Scalar4)*n_threads*N_total);
+
+    // whether a type pair interacts only depends on its parameters, determine that once per step
+    std::vector<unsigned char> interactive(m_typpair_idx.getNumElements());
+    for (unsigned int cur_pair = 0; cur_pair < m_typpair_idx.getNumElements(); cur_pair++)
+        {
+        evaluator eval(Scalar(0.0), h_rcutsq.data[cur_pair], h_params.data[cur_pair]);
+        interactive[cur_pair] = eval.areInteractive();
+        }
 
-    // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    // compute the minimum image separation and the cutoff function of every neighbor pair
+    #pragma omp parallel for schedule(static) num_threads(n_threads)
+    for (int i = 0; i < (int)N; i++)
         {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
         Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         const unsigned int head_i = h_head_list.data[i];
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
-
-        // initialize current force and potential energy of particle i to 0
-        Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-        Scalar pei = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        const unsigned int size = h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // access the index of neighbor j (MEM TRANSFER: 1 scalar)
             unsigned int jj = h_nlist.data[head_i + j];
-            assert(jj < m_pdata->getN());
-
-            // access the position and type of particle j
             Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-            unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-            assert(typej < m_pdata->getNTypes());
-
-            // initialize the current force and potential energy of particle j to 0
-            Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pej = 0.0;
-
-            // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 dxij = posi - posj;
-
-            // apply periodic boundary conditions
-            dxij = box.minImage(dxij);
-
-            // compute rij_sq (FLOPS: 5)
+            Scalar3 dxij = box.minImage(posi - posj);
             Scalar rij_sq = dot(dxij, dxij);
+            h_pair_dr.data[head_i + j] = make_scalar4(dxij.x, dxij.y, dxij.z, rij_sq);
 
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
+            // the cutoff function is only needed inside the cutoff
+            unsigned int typpair_idx = m_typpair_idx(typei, __scalar_as_int(h_pos.data[jj].w));
             Scalar rcutsq = h_rcutsq.data[typpair_idx];
-
-            // evaluate the base repulsive and attractive terms
-            Scalar fR = 0.0;
-            Scalar fA = 0.0;
-            evaluator eval(rij_sq, rcutsq, param);
-            bool evaluated = eval.evalRepulsiveAndAttractive(fR, fA);
-
-            if (evaluated)
+            Scalar rij = sqrt(rij_sq);
+            Scalar fcut = Scalar(0.0);
+            Scalar dfcut = Scalar(0.0);
+            if (rij_sq < rcutsq)
                 {
-                // evaluate chi
-                Scalar chi = 0.0;
-                for (unsigned int k = 0; k < size; k++)
-                    {
-                    // access the index of neighbor k
-                    unsigned int kk = h_nlist.data[head_i + k];
-                    assert(kk < m_pdata->getN());
-
-                    // access the position and type of neighbor k
-                    Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                    unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                    assert(typek < m_pdata->getNTypes());
-
-                    // access the type pair parameters for i and k
-                    typpair_idx = m_typpair_idx(typei, typek);
-                    param_type temp_param = h_params.data[typpair_idx];
-
-                    evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                    bool temp_evaluated = temp_eval.areInteractive();
-
-                    if (kk != jj && temp_evaluated)
-                        {
-                        // compute drik
-                        Scalar3 dxik = posi - posk;
-
-                        // apply periodic boundary conditions
-                        dxik = box.minImage(dxik);
-
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
-
-                        // compute the bond angle (if needed)
-                        Scalar cos_th = Scalar(0.0);
-                        if (evaluator::needsAngle())
-                            cos_th = dot(dxij, dxik) / sqrt(rij_sq * rik_sq);
-
-                        // evaluate the partial chi term
-                        eval.setRik(rik_sq);
-                        if (evaluator::needsAngle())
-                            eval.setAngle(cos_th);
+                evaluator eval(rij_sq, rcutsq, h_params.data[typpair_idx]);
+                eval.evalCutoff(rij, fcut, dfcut);
+                }
+            h_pair_cut.data[head_i + j] = make_scalar3(rij, fcut, dfcut);
+            }
+        }
 
-                        eval.evalChi(chi);
-                        }
-                    }
+    #pragma omp parallel num_threads(n_threads)
+        {
+        unsigned int tid = 0;
+        #ifdef ENABLE_OPENMP
+        tid = omp_get_thread_num();
+        #endif
 
-                // evaluate the force and energy from the ij interaction
-                Scalar force_divr = Scalar(0.0);
-                Scalar potential_eng = Scalar(0.0);
-                Scalar bij = Scalar(0.0);
-                eval.evalForceij(fR, fA, chi, bij, force_divr, potential_eng);
+        // each thread accumulates into its own force slice
+        Scalar4 *f = (n_threads > 1) ? h_thread_force.data + tid*N_total : h_force.data;
 
-                // add this force to particle i
-                fi += force_divr * dxij;
-                pei += potential_eng * Scalar(0.5);
+        // cached triplet terms of the current j and all k, and whether the triplet contributes
+        std::vector<typename evaluator::triplet_type> triplet_k;
+        std::vector<unsigned char> triplet_valid_k;
 
-                // add this force to particle j
-                fj += Scalar(-1.0) * force_divr * dxij;
-                pej += potential_eng * Scalar(0.5);
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < (int)N; i++)
+            {
+            // access the particle's type (MEM TRANSFER: 1 scalar)
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            const unsigned int head_i = h_head_list.data[i];
+            // sanity check
+            assert(typei < ntypes);
+
+            // initialize current force and potential energy of particle i to 0
+            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
+            Scalar pei = 0.0;
+
+            // loop over all of the neighbors of this particle
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
+            if (triplet_k.size() < size)
+                {
+                triplet_k.resize(size);
+                triplet_valid_k.resize(size);
+                }
 
-                // evaluate the force from the ik interactions
-                for (unsigned int k = 0; k < size; k++)
+            for (unsigned int j = 0; j < size; j++)
+                {
+                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
+                unsigned int jj = h_nlist.data[head_i + j];
+                assert(jj < N_total);
+
+                // access the type of particle j
+                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
+                assert(typej < ntypes);
+
+                // initialize the current force and potential energy of particle j to 0
+                Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
+                Scalar pej = 0.0;
+
+                // read the precomputed dr_ij, rij_sq, rij and the ij cutoff function
+                Scalar4 drij = h_pair_dr.data[head_i + j];
+                Scalar3 dxij = make_scalar3(drij.x, drij.y, drij.z);
+                Scalar rij_sq = drij.w;
+                Scalar3 cutij = h_pair_cut.data[head_i + j];
+                Scalar rij = cutij.x;
+
+                // get parameters for this type pair
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                param_type param = h_params.data[typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+
+                // evaluate the base repulsive and attractive terms
+                Scalar fR = 0.0;
+                Scalar fA = 0.0;
+                evaluator eval(rij_sq, rcutsq, param);
+                bool evaluated = eval.evalRepulsiveAndAttractive(fR, fA);
+
+                if (evaluated)
                     {
-                    // access the index of neighbor k
-                    unsigned int kk = h_nlist.data[head_i + k];
-                    assert(kk < m_pdata->getN());
+                    // evaluate chi
+                    Scalar chi = 0.0;
+                    for (unsigned int k = 0; k < size; k++)
+                        {
+                        // access the index and type of neighbor k
+                        unsigned int kk = h_nlist.data[head_i + k];
+                        unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
+                        assert(typek < ntypes);
+
+                        triplet_valid_k[k] = 0;
+                        if (kk != jj && interactive[m_typpair_idx(typei, typek)])
+                            {
+                            // read the precomputed dr_ik, rik_sq and rik
+                            Scalar4 drik = h_pair_dr.data[head_i + k];
+                            Scalar3 dxik = make_scalar3(drik.x, drik.y, drik.z);
+                            Scalar rik_sq = drik.w;
+                            Scalar3 cutik = h_pair_cut.data[head_i + k];
+                            Scalar rik = cutik.x;
+
+                            // the triplet uses the cutoff of the ij type pair, which was cached if k is of type j
+                            Scalar fcut_ik = cutik.y;
+                            Scalar dfcut_ik = cutik.z;
+                            if (typek != typej && rik_sq < rcutsq)
+                                eval.evalCutoff(rik, fcut_ik, dfcut_ik);
+
+                            // compute the bond angle (if needed)
+                            eval.setRik(rik_sq);
+                            if (evaluator::needsAngle())
+                                eval.setAngle(dot(dxij, dxik) / (rij * rik));
+
+                            // evaluate the partial chi term and keep the triplet terms for the force loop
+                            triplet_valid_k[k] = eval.evalChiCached(rij, rik, fcut_ik, dfcut_ik, chi, triplet_k[k]);
+                            }
+                        }
 
-                    // access the position and type of neighbor k
-                    Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                    unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                    assert(typek < m_pdata->getNTypes());
+                    // evaluate the force and energy from the ij interaction
+                    Scalar force_divr = Scalar(0.0);
+                    Scalar potential_eng = Scalar(0.0);
+                    Scalar bij = Scalar(0.0);
+                    Scalar dbij = Scalar(0.0);
+                    eval.evalForceijCached(fR, fA, chi, rij, cutij.y, cutij.z, bij, dbij, force_divr, potential_eng);
 
-                    // access the type pair parameters for i and k
-                    typpair_idx = m_typpair_idx(typei, typek);
-                    param_type temp_param = h_params.data[typpair_idx];
+                    // add this force to particle i
+                    fi += force_divr * dxij;
+                    pei += potential_eng * Scalar(0.5);
 
-                    evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                    bool temp_evaluated = temp_eval.areInteractive();
+                    // add this force to particle j
+                    fj += Scalar(-1.0) * force_divr * dxij;
+                    pej += potential_eng * Scalar(0.5);
 
-                    if (kk != jj && temp_evaluated)
+                    // evaluate the force from the ik interactions
+                    for (unsigned int k = 0; k < size; k++)
                         {
-                        // create variable for the force on k
-                        Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
-
-                        // compute dr_ik
-                        Scalar3 dxik = posi - posk;
-
-                        // apply periodic boundary conditions
-                        dxik = box.minImage(dxik);
-
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
-
-                        // compute the bond angle (if needed)
-                        Scalar cos_th = Scalar(0.0);
-                        if (evaluator::needsAngle())
-                            cos_th = dot(dxij, dxik) / sqrt(rij_sq * rik_sq);
-
-                        // set up the evaluator
-                        eval.setRik(rik_sq);
-                        if (evaluator::needsAngle())
-                            eval.setAngle(cos_th);
-
-                        // compute the total force and energy
-                        Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
-                        Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
-                        eval.evalForceik(fR, fA, chi, bij, force_divr_ij, force_divr_ik);
-
-                        // add the force to particle i
-                        // (FLOPS: 17)
-                        fi.x += force_divr_ij.x * dxij.x + force_divr_ik.x * dxik.x;
-                        fi.y += force_divr_ij.x * dxij.y + force_divr_ik.x * dxik.y;
-                        fi.z += force_divr_ij.x * dxij.z + force_divr_ik.x * dxik.z;
-
-                        // add the force to particle j (FLOPS: 17)
-                        fj.x += force_divr_ij.y * dxij.x + force_divr_ik.y * dxik.x;
-                        fj.y += force_divr_ij.y * dxij.y + force_divr_ik.y * dxik.y;
-                        fj.z += force_divr_ij.y * dxij.z + force_divr_ik.y * dxik.z;
-
-                        // add the force to particle k
-                        fk.x += force_divr_ij.z * dxij.x + force_divr_ik.z * dxik.x;
-                        fk.y += force_divr_ij.z * dxij.y + force_divr_ik.z * dxik.y;
-                        fk.z += force_divr_ij.z * dxij.z + force_divr_ik.z * dxik.z;
-
-                        // increment the force for particle k
-                        unsigned int mem_idx = kk;
-                        h_force.data[mem_idx].x += fk.x;
-                        h_force.data[mem_idx].y += fk.y;
-                        h_force.data[mem_idx].z += fk.z;
+                        if (triplet_valid_k[k])
+                            {
+                            // access the index of neighbor k
+                            unsigned int kk = h_nlist.data[head_i + k];
+
+                            // read the precomputed dr_ik and rik
+                            Scalar4 drik = h_pair_dr.data[head_i + k];
+                            Scalar3 dxik = make_scalar3(drik.x, drik.y, drik.z);
+                            Scalar rik = h_pair_cut.data[head_i + k].x;
+
+                            // compute the total force from the triplet terms cached by the chi loop
+                            Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
+                            Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
+                            eval.evalForceikCached(fA, chi, rij, rik, cutij.y, dbij, triplet_k[k],
+                                                   force_divr_ij, force_divr_ik);
+
+                            // add the force to particle i
+                            // (FLOPS: 17)
+                            fi.x += force_divr_ij.x * dxij.x + force_divr_ik.x * dxik.x;
+                            fi.y += force_divr_ij.x * dxij.y + force_divr_ik.x * dxik.y;
+                            fi.z += force_divr_ij.x * dxij.z + force_divr_ik.x * dxik.z;
+
+                            // add the force to particle j (FLOPS: 17)
+                            fj.x += force_divr_ij.y * dxij.x + force_divr_ik.y * dxik.x;
+                            fj.y += force_divr_ij.y * dxij.y + force_divr_ik.y * dxik.y;
+                            fj.z += force_divr_ij.y * dxij.z + force_divr_ik.y * dxik.z;
+
+                            // increment the force for particle k
+                            f[kk].x += force_divr_ij.z * dxij.x + force_divr_ik.z * dxik.x;
+                            f[kk].y += force_divr_ij.z * dxij.y + force_divr_ik.z * dxik.y;
+                            f[kk].z += force_divr_ij.z * dxij.z + force_divr_ik.z * dxik.z;
+                            }
                         }
                     }
+                // increment the force and potential energy for particle j
+                f[jj].x += fj.x;
+                f[jj].y += fj.y;
+                f[jj].z += fj.z;
+                f[jj].w += pej;
                 }
-            // increment the force and potential energy for particle j
-            unsigned int mem_idx = jj;
-            h_force.data[mem_idx].x += fj.x;
-            h_force.data[mem_idx].y += fj.y;
-            h_force.data[mem_idx].z += fj.z;
-            h_force.data[mem_idx].w += pej;
+            // finally, increment the force and potential energy for particle i
+            f[i].x += fi.x;
+            f[i].y += fi.y;
+            f[i].z += fi.z;
+            f[i].w += pei;
             }
-        // finally, increment the force and potential energy for particle i
-        unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
         }
 
+    // sum up the per-thread contributions
+    if (n_threads > 1)
+        {
+        #pragma omp parallel for schedule(static) num_threads(n_threads)
+        for (int i = 0; i < (int)N_total; i++)
+            {
+            Scalar4 fsum = make_scalar4(0.0, 0.0, 0.0, 0.0);
+            for (unsigned int t = 0; t < n_threads; t++)
+                {
+                Scalar4 ft = h_thread_force.data[t*N_total + i];
+                fsum.x += ft.x;
+                fsum.y += ft.y;
+                fsum.z += ft.z;
+                fsum.w += ft.w;
+                }
+            h_force.data[i] = fsum;
+            }
+        }
+
+    if (m_thread_tuner) m_thread_tuner->end();
+
     if (m_prof) m_prof->pop();
     }
 
@@ -6,7 +6,7 @@
 
 #include "TwoStepBD.h"
 #include "hoomd/VectorMath.h"
-#include "hoomd/extern/saruprng.h"
+#include "hoomd/RandomNumbers.h"
 #include "QuaternionMath.h"
 #include "hoomd/HOOMDMath.h"
 
@@ -70,6 +70,7 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
     const unsigned int D = Scalar(m_sysdef->getNDimensions());
 
     const GPUArray< Scalar4 >& net_force = m_pdata->getNetForce();
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
@@ -88,123 +89,148 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
 
     const BoxDim& box = m_pdata->getBox();
 
+    // the random numbers are drawn for a tile of particles at a time with the vectorized block generator. They only
+    // depend on the particle tag, seed and time step, so the trajectory does not depend on the number of threads
+    const unsigned int n_tiles = (group_size + hoomd::RANDOM_BLOCK_TILE - 1) / hoomd::RANDOM_BLOCK_TILE;
+
     // perform the first half step
     // r(t+deltaT) = r(t) + (Fc(t) + Fr)*deltaT/gamma
     // v(t+deltaT) = random distribution consistent with T
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static)
+    for (int tile = 0; tile < (int)n_tiles; tile++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        unsigned int ptag = h_tag.data[j];
-
-        // Initialize the RNG
-        Saru saru(ptag, timestep + m_seed);
-
-        // compute the random force
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz = saru.s<Scalar>(-1,1);
-
-        Scalar gamma;
-        if (m_use_lambda)
-            gamma = m_lambda*h_diameter.data[j];
-        else
+        unsigned int start = tile*hoomd::RANDOM_BLOCK_TILE;
+        unsigned int n = std::min(hoomd::RANDOM_BLOCK_TILE, group_size - start);
+
+        unsigned int tags[hoomd::RANDOM_BLOCK_TILE];
+        for (unsigned int k = 0; k < n; k++)
+            tags[k] = h_tag.data[h_index_array.data[start+k]];
+
+        // block 0 holds the random force, block 1 the new velocity, blocks 2 and 3 the random torque and the new
+        // angular momentum
+        Scalar rand_t[4*hoomd::RANDOM_BLOCK_TILE];
+        Scalar rand_v[4*hoomd::RANDOM_BLOCK_TILE];
+        Scalar rand_r[4*hoomd::RANDOM_BLOCK_TILE];
+        Scalar rand_p[4*hoomd::RANDOM_BLOCK_TILE];
+        hoomd::generateUniformBlock(rand_t, tags, n, hoomd::RNGIdentifier::TwoStepBD, m_seed, timestep, 0, Scalar(-1), Scalar(1));
+        hoomd::generateNormalBlock(rand_v, tags, n, hoomd::RNGIdentifier::TwoStepBD, m_seed, timestep, 1, Scalar(1));
+        if (m_aniso)
             {
-            unsigned int type = __scalar_as_int(h_pos.data[j].w);
-            gamma = h_gamma.data[type];
+            hoomd::generateNormalBlock(rand_r, tags, n, hoomd::RNGIdentifier::TwoStepBD, m_seed, timestep, 2, Scalar(1));
+            hoomd::generateNormalBlock(rand_p, tags, n, hoomd::RNGIdentifier::TwoStepBD, m_seed, timestep, 3, Scalar(1));
             }
 
-        // compute the bd force (the extra factor of 3 is because <rx^2> is 1/3 in the uniform -1,1 distribution
-        // it is not the dimensionality of the system
-        Scalar coeff = fast::sqrt(Scalar(3.0)*Scalar(2.0)*gamma*currentTemp/m_deltaT);
-        if (m_noiseless_t)
-            coeff = Scalar(0.0);
-        Scalar Fr_x = rx*coeff;
-        Scalar Fr_y = ry*coeff;
-        Scalar Fr_z = rz*coeff;
-
-        if (D < 3)
-            Fr_z = Scalar(0.0);
-
-        // update position
-        h_pos.data[j].x += (h_net_force.data[j].x + Fr_x) * m_deltaT / gamma;
-        h_pos.data[j].y += (h_net_force.data[j].y + Fr_y) * m_deltaT / gamma;
-        h_pos.data[j].z += (h_net_force.data[j].z + Fr_z) * m_deltaT / gamma;
-
-        // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-        box.wrap(h_pos.data[j], h_image.data[j]);
-
-        // draw a new random velocity for particle j
-        Scalar mass =  h_vel.data[j].w;
-        Scalar sigma = fast::sqrt(currentTemp/mass);
-        h_vel.data[j].x = gaussian_rng(saru, sigma);
-        h_vel.data[j].y = gaussian_rng(saru, sigma);
-        if (D > 2)
-            h_vel.data[j].z = gaussian_rng(saru, sigma);
-        else
-            h_vel.data[j].z = 0;
-
-        // rotational random force and orientation quaternion updates
-        if (m_aniso)
+        for (unsigned int k = 0; k < n; k++)
             {
-            unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
-            Scalar gamma_r = h_gamma_r.data[type_r];
-            if (gamma_r > 0)
+            unsigned int j = h_index_array.data[start+k];
+
+            // compute the random force
+            Scalar rx = rand_t[4*k];
+            Scalar ry = rand_t[4*k+1];
+            Scalar rz = rand_t[4*k+2];
+
+            Scalar gamma;
+            if (m_use_lambda)
+                gamma = m_lambda*h_diameter.data[j];
+            else
+                {
+                unsigned int type = __scalar_as_int(h_pos.data[j].w);
+                gamma = h_gamma.data[type];
+                }
+
+            // compute the bd force (the extra factor of 3 is because <rx^2> is 1/3 in the uniform -1,1 distribution
+            // it is not the dimensionality of the system
+            Scalar coeff = fast::sqrt(Scalar(3.0)*Scalar(2.0)*gamma*currentTemp/m_deltaT);
+            if (m_noiseless_t)
+                coeff = Scalar(0.0);
+            Scalar Fr_x = rx*coeff;
+            Scalar Fr_y = ry*coeff;
+            Scalar Fr_z = rz*coeff;
+
+            if (D < 3)
+                Fr_z = Scalar(0.0);
+
+            // update position
+            h_pos.data[j].x += (h_net_force.data[j].x + Fr_x) * m_deltaT / gamma;
+            h_pos.data[j].y += (h_net_force.data[j].y + Fr_y) * m_deltaT / gamma;
+            h_pos.data[j].z += (h_net_force.data[j].z + Fr_z) * m_deltaT / gamma;
+
+            // particles may have been moved slightly outside the box by the above steps, wrap them back into place
+            box.wrap(h_pos.data[j], h_image.data[j]);
+
+            // draw a new random velocity for particle j
+            Scalar mass =  h_vel.data[j].w;
+            Scalar sigma = fast::sqrt(currentTemp/mass);
+            h_vel.data[j].x = sigma*rand_v[4*k];
+            h_vel.data[j].y = sigma*rand_v[4*k+1];
+            if (D > 2)
+                h_vel.data[j].z = sigma*rand_v[4*k+2];
+            else
+                h_vel.data[j].z = 0;
+
+            // rotational random force and orientation quaternion updates
+            if (m_aniso)
                 {
-                vec3<Scalar> p_vec;
-                quat<Scalar> q(h_orientation.data[j]);
-                vec3<Scalar> t(h_torque.data[j]);
-                vec3<Scalar> I(h_inertia.data[j]);
-
-                bool x_zero, y_zero, z_zero;
-                x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-                Scalar sigma_r = fast::sqrt(Scalar(2.0)*gamma_r*currentTemp/m_deltaT);
-                if (m_noiseless_r)
-                    sigma_r = Scalar(0.0);
-
-                // original Gaussian random torque
-                // Gaussian random distribution is preferred in terms of preserving the exact math
-                vec3<Scalar> bf_torque;
-                bf_torque.x = gaussian_rng(saru, sigma_r);
-                bf_torque.y = gaussian_rng(saru, sigma_r);
-                bf_torque.z = gaussian_rng(saru, sigma_r);
-
-                if (x_zero) bf_torque.x = 0;
-                if (y_zero) bf_torque.y = 0;
-                if (z_zero) bf_torque.z = 0;
-
-                // use the damping by gamma_r and rotate back to lab frame
-                // Notes For the Future: take special care when have anisotropic gamma_r
-                // if aniso gamma_r, first rotate the torque into particle frame and divide the different gamma_r
-                // and then rotate the "angular velocity" back to lab frame and integrate
-                bf_torque = rotate(q, bf_torque);
-                if (D < 3)
+                unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
+                Scalar gamma_r = h_gamma_r.data[type_r];
+                if (gamma_r > 0)
                     {
-                    bf_torque.x = 0;
-                    bf_torque.y = 0;
-                    t.x = 0;
-                    t.y = 0;
+                    vec3<Scalar> p_vec;
+                    quat<Scalar> q(h_orientation.data[j]);
+                    vec3<Scalar> t(h_torque.data[j]);
+                    vec3<Scalar> I(h_inertia.data[j]);
+
+                    bool x_zero, y_zero, z_zero;
+                    x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
+
+                    Scalar sigma_r = fast::sqrt(Scalar(2.0)*gamma_r*currentTemp/m_deltaT);
+                    if (m_noiseless_r)
+                        sigma_r = Scalar(0.0);
+
+                    // original Gaussian random torque
+                    // Gaussian random distribution is preferred in terms of preserving the exact math
+                    vec3<Scalar> bf_torque;
+                    bf_torque.x = sigma_r*rand_r[4*k];
+                    bf_torque.y = sigma_r*rand_r[4*k+1];
+                    bf_torque.z = sigma_r*rand_r[4*k+2];
+
+                    if (x_zero) bf_torque.x = 0;
+                    if (y_zero) bf_torque.y = 0;
+                    if (z_zero) bf_torque.z = 0;
+
+                    // use the damping by gamma_r and rotate back to lab frame
+                    // Notes For the Future: take special care when have anisotropic gamma_r
+                    // if aniso gamma_r, first rotate the torque into particle frame and divide the different gamma_r
+                    // and then rotate the "angular velocity" back to lab frame and integrate
+                    bf_torque = rotate(q, bf_torque);
+                    if (D < 3)
+                        {
+                        bf_torque.x = 0;
+                        bf_torque.y = 0;
+                        t.x = 0;
+                        t.y = 0;
+                        }
+
+                    // do the integration for quaternion
+                    q += Scalar(0.5) * m_deltaT * ((t + bf_torque) / gamma_r) * q ;
+                    q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
+                    h_orientation.data[j] = quat_to_scalar4(q);
+
+                    // draw a new random ang_mom for particle j in body frame
+                    p_vec.x = fast::sqrt(currentTemp * I.x)*rand_p[4*k];
+                    p_vec.y = fast::sqrt(currentTemp * I.y)*rand_p[4*k+1];
+                    p_vec.z = fast::sqrt(currentTemp * I.z)*rand_p[4*k+2];
+                    if (x_zero) p_vec.x = 0;
+                    if (y_zero) p_vec.y = 0;
+                    if (z_zero) p_vec.z = 0;
+
+                    // !! Note this isn't well-behaving in 2D,
+                    // !! because may have effective non-zero ang_mom in x,y
+
+                    // store ang_mom quaternion
+                    quat<Scalar> p = Scalar(2.0) * q * p_vec;
+                    h_angmom.data[j] = quat_to_scalar4(p);
                     }
-
-                // do the integration for quaternion
-                q += Scalar(0.5) * m_deltaT * ((t + bf_torque) / gamma_r) * q ;
-                q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
-                h_orientation.data[j] = quat_to_scalar4(q);
-
-                // draw a new random ang_mom for particle j in body frame
-                p_vec.x = gaussian_rng(saru, fast::sqrt(currentTemp * I.x));
-                p_vec.y = gaussian_rng(saru, fast::sqrt(currentTemp * I.y));
-                p_vec.z = gaussian_rng(saru, fast::sqrt(currentTemp * I.z));
-                if (x_zero) p_vec.x = 0;
-                if (y_zero) p_vec.y = 0;
-                if (z_zero) p_vec.z = 0;
-
-                // !! Note this isn't well-behaving in 2D,
-                // !! because may have effective non-zero ang_mom in x,y
-
-                // store ang_mom quaternion
-                quat<Scalar> p = Scalar(2.0) * q * p_vec;
-                h_angmom.data[j] = quat_to_scalar4(p);
                 }
             }
         }
@@ -5,7 +5,7 @@
 // Maintainer: joaander
 
 #include "TwoStepBDGPU.cuh"
-#include "hoomd/extern/saruprngCUDA.h"
+#include "hoomd/RandomNumbers.h"
 #include "hoomd/VectorMath.h"
 #include "hoomd/HOOMDMath.h"
 
@@ -48,8 +48,8 @@ extern __shared__ Scalar s_gammas[];
 
     This kernel is implemented in a very similar manner to gpu_nve_step_one_kernel(), see it for design details.
 
-    Random number generation is done per thread with Saru's 3-seed constructor. The seeds are, the time step,
-    the particle tag, and the user-defined seed.
+    Random numbers are drawn per thread from a RandomGenerator keyed by the user-defined seed, the particle tag, and
+    the time step. The block assignment matches TwoStepBD::integrateStepOne() so that both draw the same numbers.
 
     This kernel must be launched with enough dynamic shared memory per block to read in d_gamma
 */
@@ -118,10 +118,12 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         unsigned int ptag = d_tag[idx];
 
         // compute the random force
-        SaruGPU saru(ptag, timestep + seed, 0x9977665);
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz =  saru.s<Scalar>(-1,1);
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::TwoStepBD, seed, ptag, 0, timestep);
+        Scalar rand_t[4];
+        rng.uniform4(rand_t, Scalar(-1), Scalar(1));
+        Scalar rx = rand_t[0];
+        Scalar ry = rand_t[1];
+        Scalar rz = rand_t[2];
 
         // calculate the magnitude of the random force
         Scalar gamma;
@@ -160,10 +162,12 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         // draw a new random velocity for particle j
         Scalar mass = vel.w;
         Scalar sigma = fast::sqrt(T/mass);
-        vel.x = gaussian_rng(saru, sigma);
-        vel.y = gaussian_rng(saru, sigma);
+        Scalar rand_v[4];
+        rng.normal4(rand_v, sigma);
+        vel.x = rand_v[0];
+        vel.y = rand_v[1];
         if (D > 2)
-            vel.z = gaussian_rng(saru, sigma);
+            vel.z = rand_v[2];
         else
             vel.z = 0;
 
@@ -197,9 +201,11 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 // original Gaussian random torque
                 // Gaussian random distribution is preferred in terms of preserving the exact math
                 vec3<Scalar> bf_torque;
-                bf_torque.x = gaussian_rng(saru, sigma_r);
-                bf_torque.y = gaussian_rng(saru, sigma_r);
-                bf_torque.z = gaussian_rng(saru, sigma_r);
+                Scalar rand_r[4];
+                rng.normal4(rand_r, sigma_r);
+                bf_torque.x = rand_r[0];
+                bf_torque.y = rand_r[1];
+                bf_torque.z = rand_r[2];
 
                 if (x_zero) bf_torque.x = 0;
                 if (y_zero) bf_torque.y = 0;
@@ -222,9 +228,11 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 d_orientation[idx] = quat_to_scalar4(q);
 
                 // draw a new random ang_mom for particle j in body frame
-                p_vec.x = gaussian_rng(saru, fast::sqrt(T * I.x));
-                p_vec.y = gaussian_rng(saru, fast::sqrt(T * I.y));
-                p_vec.z = gaussian_rng(saru, fast::sqrt(T * I.z));
+                Scalar rand_p[4];
+                rng.normal4(rand_p, Scalar(1.0));
+                p_vec.x = fast::sqrt(T * I.x)*rand_p[0];
+                p_vec.y = fast::sqrt(T * I.y)*rand_p[1];
+                p_vec.z = fast::sqrt(T * I.z)*rand_p[2];
                 if (x_zero) p_vec.x = 0;
                 if (y_zero) p_vec.y = 0;
                 if (z_zero) p_vec.z = 0;
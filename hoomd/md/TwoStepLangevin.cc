@@ -5,7 +5,7 @@
 // Maintainer: joaander
 
 #include "TwoStepLangevin.h"
-#include "hoomd/extern/saruprng.h"
+#include "hoomd/RandomNumbers.h"
 #include "hoomd/VectorMath.h"
 
 #ifdef ENABLE_MPI
@@ -81,6 +81,8 @@ Scalar TwoStepLangevin::getLogValue(const std::string& quantity, unsigned int ti
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the velocity verlet
           method.
+
+    The translational and rotational updates are done in a single pass over the group, split across OpenMP threads.
 */
 void TwoStepLangevin::integrateStepOne(unsigned int timestep)
     {
@@ -90,21 +92,26 @@ void TwoStepLangevin::integrateStepOne(unsigned int timestep)
     if (m_prof)
         m_prof->push("Langevin step 1");
 
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    ArrayHandle<Scalar> h_gamma_r(m_gamma_r, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
 
         Scalar dx = h_vel.data[j].x*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT*m_deltaT;
         Scalar dy = h_vel.data[j].y*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT*m_deltaT;
@@ -119,108 +126,15 @@ void TwoStepLangevin::integrateStepOne(unsigned int timestep)
         h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
         h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
         h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
-        }
-
-    if (m_aniso)
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        if (m_aniso)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-            // using Trotter factorization of rotation Liouvillian
-            p += m_deltaT*q*t;
-
-            quat<Scalar> p1, p2, p3; // permutated quaternions
-            quat<Scalar> q1, q2, q3;
-            Scalar phi1, cphi1, sphi1;
-            Scalar phi2, cphi2, sphi2;
-            Scalar phi3, cphi3, sphi3;
-
-            if (!z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (!x_zero)
-                {
-                p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
-                q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
-                phi1 = Scalar(1./4.)/I.x*dot(p,q1);
-                cphi1 = slow::cos(m_deltaT*phi1);
-                sphi1 = slow::sin(m_deltaT*phi1);
-
-                p=cphi1*p+sphi1*p1;
-                q=cphi1*q+sphi1*q1;
-                }
-
-            if (! y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (! z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            // renormalize (improves stability)
-            q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+            advanceRotationStepOne(q, p, t, I, m_deltaT, Scalar(1.0));
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
@@ -234,6 +148,10 @@ void TwoStepLangevin::integrateStepOne(unsigned int timestep)
 
 /*! \param timestep Current time step
     \post particle velocities are moved forward to timestep+1
+
+    The random and drag forces and torques are applied and the velocities and angular momenta are advanced in a
+    single pass over the group, split across OpenMP threads. The random numbers come from the counter based
+    RandomGenerator keyed by the particle tag, so the trajectory does not depend on the number of threads.
 */
 void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
     {
@@ -245,6 +163,7 @@ void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
     if (m_prof)
         m_prof->push("Langevin step 2");
 
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
@@ -266,143 +185,132 @@ void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
     // energy transferred over this time step
     Scalar bd_energy_transfer = 0;
 
+    // the random numbers are drawn for a tile of particles at a time with the vectorized block generator. They only
+    // depend on the particle tag, seed and time step, so the trajectory does not depend on the number of threads
+    const unsigned int n_tiles = (group_size + hoomd::RANDOM_BLOCK_TILE - 1) / hoomd::RANDOM_BLOCK_TILE;
+
     // a(t+deltaT) gets modified with the bd forces
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static) reduction(+:bd_energy_transfer)
+    for (int tile = 0; tile < (int)n_tiles; tile++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        unsigned int ptag = h_tag.data[j];
-
-        // Initialize the RNG
-        Saru saru(ptag, timestep + m_seed);
-
-        // first, calculate the BD forces
-        // Generate three random numbers
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz = saru.s<Scalar>(-1,1);
-
-        Scalar gamma;
-        if (m_use_lambda)
-            gamma = m_lambda*h_diameter.data[j];
-        else
-            {
-            unsigned int type = __scalar_as_int(h_pos.data[j].w);
-            gamma = h_gamma.data[type];
-            }
-
-        // compute the bd force
-        Scalar coeff = fast::sqrt(Scalar(6.0) *gamma*currentTemp/m_deltaT);
-        if (m_noiseless_t)
-            coeff = Scalar(0.0);
-        Scalar bd_fx = rx*coeff - gamma*h_vel.data[j].x;
-        Scalar bd_fy = ry*coeff - gamma*h_vel.data[j].y;
-        Scalar bd_fz = rz*coeff - gamma*h_vel.data[j].z;
-
-        if (D < 3)
-            bd_fz = Scalar(0.0);
-
-        // then, calculate acceleration from the net force
-        Scalar minv = Scalar(1.0) / h_vel.data[j].w;
-        h_accel.data[j].x = (h_net_force.data[j].x + bd_fx)*minv;
-        h_accel.data[j].y = (h_net_force.data[j].y + bd_fy)*minv;
-        h_accel.data[j].z = (h_net_force.data[j].z + bd_fz)*minv;
-
-        // then, update the velocity
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+        unsigned int start = tile*hoomd::RANDOM_BLOCK_TILE;
+        unsigned int n = std::min(hoomd::RANDOM_BLOCK_TILE, group_size - start);
 
-        // tally the energy transfer from the bd thermal reservor to the particles
-        if (m_tally) bd_energy_transfer += bd_fx * h_vel.data[j].x + bd_fy * h_vel.data[j].y + bd_fz * h_vel.data[j].z;
+        unsigned int tags[hoomd::RANDOM_BLOCK_TILE];
+        for (unsigned int k = 0; k < n; k++)
+            tags[k] = h_tag.data[h_index_array.data[start+k]];
 
-        // rotational updates
+        // block 0 holds the translational noise, block 1 the rotational noise
+        Scalar rand_t[4*hoomd::RANDOM_BLOCK_TILE];
+        Scalar rand_r[4*hoomd::RANDOM_BLOCK_TILE];
+        hoomd::generateUniformBlock(rand_t, tags, n, hoomd::RNGIdentifier::TwoStepLangevin, m_seed, timestep, 0, Scalar(-1), Scalar(1));
         if (m_aniso)
+            hoomd::generateNormalBlock(rand_r, tags, n, hoomd::RNGIdentifier::TwoStepLangevin, m_seed, timestep, 1, Scalar(1));
+
+        for (unsigned int k = 0; k < n; k++)
             {
-            unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
-            Scalar gamma_r = h_gamma_r.data[type_r];
-            // get body frame ang_mom
-            quat<Scalar> p(h_angmom.data[j]);
-            quat<Scalar> q(h_orientation.data[j]);
-            vec3<Scalar> t(h_net_torque.data[j]);
-            vec3<Scalar> I(h_inertia.data[j]);
+            unsigned int j = h_index_array.data[start+k];
 
-            // s is the pure imaginary quaternion with im. part equal to true angular velocity
-            vec3<Scalar> s;
-            s = (Scalar(1./2.) * conj(q) * p).v;
+            // first, calculate the BD forces
+            Scalar rx = rand_t[4*k];
+            Scalar ry = rand_t[4*k+1];
+            Scalar rz = rand_t[4*k+2];
 
-            if (gamma_r > 0)
+            Scalar gamma;
+            if (m_use_lambda)
+                gamma = m_lambda*h_diameter.data[j];
+            else
                 {
-                // first calculate in the body frame random and damping torque imposed by the dynamics
-                vec3<Scalar> bf_torque;
-
-                // original Gaussian random torque
-                // for future reference: if gamma_r is different for xyz, then we need to generate 3 sigma_r
-                Scalar sigma_r = fast::sqrt(Scalar(2.0)*gamma_r*currentTemp/m_deltaT);
-                if (m_noiseless_r) sigma_r = Scalar(0.0);
-
-                Scalar rand_x = gaussian_rng(saru, sigma_r);
-                Scalar rand_y = gaussian_rng(saru, sigma_r);
-                Scalar rand_z = gaussian_rng(saru, sigma_r);
-
-                // check for degenerate moment of inertia
-                bool x_zero, y_zero, z_zero;
-                x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-                bf_torque.x = rand_x - gamma_r * (s.x / I.x);
-                bf_torque.y = rand_y - gamma_r * (s.y / I.y);
-                bf_torque.z = rand_z - gamma_r * (s.z / I.z);
-
-                // ignore torque component along an axis for which the moment of inertia zero
-                if (x_zero) bf_torque.x = 0;
-                if (y_zero) bf_torque.y = 0;
-                if (z_zero) bf_torque.z = 0;
-
-                // change to lab frame and update the net torque
-                bf_torque = rotate(q, bf_torque);
-                h_net_torque.data[j].x += bf_torque.x;
-                h_net_torque.data[j].y += bf_torque.y;
-                h_net_torque.data[j].z += bf_torque.z;
-
-                if (D < 3) h_net_torque.data[j].x = 0;
-                if (D < 3) h_net_torque.data[j].y = 0;
+                unsigned int type = __scalar_as_int(h_pos.data[j].w);
+                gamma = h_gamma.data[type];
                 }
-            }
-        }
 
-
-    // then, update the angular velocity
-    if (m_aniso)
-        {
-        // angular degrees of freedom
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
-            quat<Scalar> q(h_orientation.data[j]);
-            quat<Scalar> p(h_angmom.data[j]);
-            vec3<Scalar> t(h_net_torque.data[j]);
-            vec3<Scalar> I(h_inertia.data[j]);
-
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // advance p(t+deltaT/2)->p(t+deltaT)
-            p += m_deltaT*q*t;
-            h_angmom.data[j] = quat_to_scalar4(p);
+            // compute the bd force
+            Scalar coeff = fast::sqrt(Scalar(6.0) *gamma*currentTemp/m_deltaT);
+            if (m_noiseless_t)
+                coeff = Scalar(0.0);
+            Scalar bd_fx = rx*coeff - gamma*h_vel.data[j].x;
+            Scalar bd_fy = ry*coeff - gamma*h_vel.data[j].y;
+            Scalar bd_fz = rz*coeff - gamma*h_vel.data[j].z;
+
+            if (D < 3)
+                bd_fz = Scalar(0.0);
+
+            // then, calculate acceleration from the net force
+            Scalar minv = Scalar(1.0) / h_vel.data[j].w;
+            h_accel.data[j].x = (h_net_force.data[j].x + bd_fx)*minv;
+            h_accel.data[j].y = (h_net_force.data[j].y + bd_fy)*minv;
+            h_accel.data[j].z = (h_net_force.data[j].z + bd_fz)*minv;
+
+            // then, update the velocity
+            h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
+            h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
+            h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+
+            // tally the energy transfer from the bd thermal reservor to the particles
+            if (m_tally) bd_energy_transfer += bd_fx * h_vel.data[j].x + bd_fy * h_vel.data[j].y + bd_fz * h_vel.data[j].z;
+
+            // rotational updates
+            if (m_aniso)
+                {
+                unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
+                Scalar gamma_r = h_gamma_r.data[type_r];
+                // get body frame ang_mom
+                quat<Scalar> p(h_angmom.data[j]);
+                quat<Scalar> q(h_orientation.data[j]);
+                vec3<Scalar> I(h_inertia.data[j]);
+
+                // s is the pure imaginary quaternion with im. part equal to true angular velocity
+                vec3<Scalar> s;
+                s = (Scalar(1./2.) * conj(q) * p).v;
+
+                if (gamma_r > 0)
+                    {
+                    // first calculate in the body frame random and damping torque imposed by the dynamics
+                    vec3<Scalar> bf_torque;
+
+                    // original Gaussian random torque
+                    // for future reference: if gamma_r is different for xyz, then we need to generate 3 sigma_r
+                    Scalar sigma_r = fast::sqrt(Scalar(2.0)*gamma_r*currentTemp/m_deltaT);
+                    if (m_noiseless_r) sigma_r = Scalar(0.0);
+
+                    Scalar rand_x = sigma_r*rand_r[4*k];
+                    Scalar rand_y = sigma_r*rand_r[4*k+1];
+                    Scalar rand_z = sigma_r*rand_r[4*k+2];
+
+                    // check for degenerate moment of inertia
+                    bool x_zero, y_zero, z_zero;
+                    x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
+
+                    bf_torque.x = rand_x - gamma_r * (s.x / I.x);
+                    bf_torque.y = rand_y - gamma_r * (s.y / I.y);
+                    bf_torque.z = rand_z - gamma_r * (s.z / I.z);
+
+                    // ignore torque component along an axis for which the moment of inertia zero
+                    if (x_zero) bf_torque.x = 0;
+                    if (y_zero) bf_torque.y = 0;
+                    if (z_zero) bf_torque.z = 0;
+
+                    // change to lab frame and update the net torque
+                    bf_torque = rotate(q, bf_torque);
+                    h_net_torque.data[j].x += bf_torque.x;
+                    h_net_torque.data[j].y += bf_torque.y;
+                    h_net_torque.data[j].z += bf_torque.z;
+
+                    if (D < 3) h_net_torque.data[j].x = 0;
+                    if (D < 3) h_net_torque.data[j].y = 0;
+                    }
+
+                // then, update the angular velocity
+                // advance p(t+deltaT/2)->p(t+deltaT)
+                vec3<Scalar> t(h_net_torque.data[j]);
+                advanceRotationStepTwo(q, p, t, I, m_deltaT, Scalar(1.0));
+                h_angmom.data[j] = quat_to_scalar4(p);
+                }
             }
         }
 
-
     // update energy reservoir
     if (m_tally)
         {
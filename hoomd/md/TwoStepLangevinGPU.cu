@@ -6,7 +6,7 @@
 
 #include "TwoStepLangevinGPU.cuh"
 
-#include "hoomd/extern/saruprngCUDA.h"
+#include "hoomd/RandomNumbers.h"
 
 #include <assert.h>
 
@@ -48,8 +48,8 @@ extern __shared__ Scalar bdtally_sdata[];
 
     This kernel will tally the energy transfer from the bd thermal reservoir and the particle system
 
-    Random number generation is done per thread with Saru's 3-seed constructor. The seeds are, the time step,
-    the particle tag, and the user-defined seed.
+    Random numbers are drawn per thread from block 0 of a RandomGenerator keyed by the user-defined seed, the
+    particle tag, and the time step. This matches TwoStepLangevin::integrateStepTwo() on the host.
 
     This kernel must be launched with enough dynamic shared memory per block to read in d_gamma
 */
@@ -124,11 +124,13 @@ void gpu_langevin_step_two_kernel(const Scalar4 *d_pos,
             coeff = Scalar(0.0);
 
         //Initialize the Random Number Generator and generate the 3 random numbers
-        SaruGPU s(ptag, timestep + seed); // 2 dimensional seeding
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::TwoStepLangevin, seed, ptag, 0, timestep);
+        Scalar rand_t[4];
+        rng.uniform4(rand_t, Scalar(-1.0), Scalar(1.0));
 
-        Scalar randomx=s.s<Scalar>(-1.0, 1.0);
-        Scalar randomy=s.s<Scalar>(-1.0, 1.0);
-        Scalar randomz=s.s<Scalar>(-1.0, 1.0);
+        Scalar randomx=rand_t[0];
+        Scalar randomy=rand_t[1];
+        Scalar randomz=rand_t[2];
 
         bd_force.x = randomx*coeff - gamma*vel.x;
         bd_force.y = randomy*coeff - gamma*vel.y;
@@ -306,10 +308,13 @@ __global__ void gpu_langevin_angular_step_two_kernel(
             Scalar sigma_r = fast::sqrt(Scalar(2.0)*gamma_r*T/deltaT);
             if (noiseless_r) sigma_r = Scalar(0.0);
 
-            SaruGPU saru(ptag, timestep + seed); // 2 dimensional seeding
-            Scalar rand_x = gaussian_rng(saru, sigma_r);
-            Scalar rand_y = gaussian_rng(saru, sigma_r);
-            Scalar rand_z = gaussian_rng(saru, sigma_r);
+            // the rotational noise is block 1 of the particle's stream, block 0 is used by the translational kernel
+            hoomd::RandomGenerator rng(hoomd::RNGIdentifier::TwoStepLangevin, seed, ptag, 0, timestep, 1);
+            Scalar rand_r[4];
+            rng.normal4(rand_r, sigma_r);
+            Scalar rand_x = rand_r[0];
+            Scalar rand_y = rand_r[1];
+            Scalar rand_z = rand_r[2];
 
             // check for zero moment of inertia
             bool x_zero, y_zero, z_zero;
@@ -256,7 +256,8 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
 
         unsigned int nparticles = m_pdata->getN();
 
-        for (unsigned int i = 0; i < nparticles; i++)
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < (int)nparticles; i++)
             {
             Scalar3 r = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
 
@@ -270,18 +271,35 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
             }
         }
 
+    // the kinetic energies can be accumulated in the update loop if the thermostat uses its own thermo compute
+    // on the integration group (a shared compute already holds the values cached by advanceBarostat())
+    const bool fold_thermo = !m_nph && m_thermo_group != m_thermo_group_t && m_thermo_group->getGroup() == m_group;
+
+    // twice the kinetic energies of the local group members after the update
+    double ke_trans = 0.0;
+    double ke_rot = 0.0;
+
         {
+        ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
         ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
 
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
         // precompute loop invariant quantity
         Scalar xi_trans = v.variable[1];
         Scalar exp_thermo_fac = exp(-Scalar(1.0/2.0)*(xi_trans+mtk)*m_deltaT);
+        Scalar xi_rot = v.variable[8];
+        Scalar exp_thermo_fac_rot = exp(-(xi_rot+mtk)*m_deltaT/Scalar(2.0));
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        #pragma omp parallel for schedule(static) reduction(+:ke_trans,ke_rot)
+        for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
+            unsigned int j = h_index_array.data[group_idx];
 
             Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
             Scalar3 accel = h_accel.data[j];
@@ -318,6 +336,28 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
             h_pos.data[j].x = r.x;
             h_pos.data[j].y = r.y;
             h_pos.data[j].z = r.z;
+
+            if (fold_thermo)
+                ke_trans += (double)h_vel.data[j].w*((double)v.x*(double)v.x + (double)v.y*(double)v.y
+                                                     + (double)v.z*(double)v.z);
+
+            // Integration of angular degrees of freedom using sympletic and
+            // time-reversal symmetric integration scheme of Miller et al., extended by thermostat
+            if (m_aniso)
+                {
+                quat<Scalar> q(h_orientation.data[j]);
+                quat<Scalar> p(h_angmom.data[j]);
+                vec3<Scalar> t(h_net_torque.data[j]);
+                vec3<Scalar> I(h_inertia.data[j]);
+
+                advanceRotationStepOne(q, p, t, I, m_deltaT, exp_thermo_fac_rot);
+
+                h_orientation.data[j] = quat_to_scalar4(q);
+                h_angmom.data[j] = quat_to_scalar4(p);
+
+                if (fold_thermo)
+                    ke_rot += rotationalKineticEnergy2(q, p, I);
+                }
             }
         } // end of GPUArray scope
 
@@ -329,125 +369,27 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
         ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
         // Wrap particles
-        for (unsigned int j = 0; j < m_pdata->getN(); j++)
+        #pragma omp parallel for schedule(static)
+        for (int j = 0; j < (int)m_pdata->getN(); j++)
             box.wrap(h_pos.data[j], h_image.data[j]);
         }
 
-    // Integration of angular degrees of freedom using sympletic and
-    // time-reversal symmetric integration scheme of Miller et al., extended by thermostat
-    if (m_aniso)
+    if (fold_thermo)
         {
-        // precompute loop invariant quantity
-        Scalar xi_rot = v.variable[8];
-        Scalar exp_thermo_fac_rot = exp(-(xi_rot+mtk)*m_deltaT/Scalar(2.0));
-
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
-
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        #ifdef ENABLE_MPI
+        if (m_comm)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
-            quat<Scalar> q(h_orientation.data[j]);
-            quat<Scalar> p(h_angmom.data[j]);
-            vec3<Scalar> t(h_net_torque.data[j]);
-            vec3<Scalar> I(h_inertia.data[j]);
-
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-            p += m_deltaT*q*t;
-
-            // apply thermostat
-            p = p*exp_thermo_fac_rot;
-
-            quat<Scalar> p1, p2, p3; // permutated quaternions
-            quat<Scalar> q1, q2, q3;
-            Scalar phi1, cphi1, sphi1;
-            Scalar phi2, cphi2, sphi2;
-            Scalar phi3, cphi3, sphi3;
-
-            if (!z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (!x_zero)
-                {
-                p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
-                q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
-                phi1 = Scalar(1./4.)/I.x*dot(p,q1);
-                cphi1 = slow::cos(m_deltaT*phi1);
-                sphi1 = slow::sin(m_deltaT*phi1);
-
-                p=cphi1*p+sphi1*p1;
-                q=cphi1*q+sphi1*q1;
-                }
-
-            if (! y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (! z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            // renormalize (improves stability)
-            q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
-
-            h_orientation.data[j] = quat_to_scalar4(q);
-            h_angmom.data[j] = quat_to_scalar4(p);
+            double ke[2] = {ke_trans, ke_rot};
+            MPI_Allreduce(MPI_IN_PLACE, ke, 2, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+            ke_trans = ke[0];
+            ke_rot = ke[1];
             }
-        }
+        #endif
 
-    if (! m_nph)
+        // propagate thermostat variables forward
+        updateThermostat(timestep, Scalar(ke_trans)/m_thermo_group->getNDOF(), Scalar(0.5*ke_rot));
+        }
+    else if (! m_nph)
         {
         // propagate thermostat variables forward
         advanceThermostat(timestep);
@@ -487,19 +429,29 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
     Scalar nuzz = v.variable[7];  // Barostat tensor, zz component
 
     {
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
+    // angular degrees of freedom
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
     // precompute loop invariant quantity
     Scalar xi_trans = v.variable[1];
     Scalar mtk = (nuxx+nuyy+nuzz)/(Scalar)m_ndof;
     Scalar exp_thermo_fac = exp(-Scalar(1.0/2.0)*(xi_trans+mtk)*m_deltaT);
+    Scalar xi_rot = v.variable[8];
+    Scalar exp_thermo_fac_rot = exp(-(xi_rot+mtk)*m_deltaT/Scalar(2.0));
 
     // perform second half step of NPT integration
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
 
         // first, calculate acceleration from the net force
         Scalar m = h_vel.data[j].w;
@@ -526,47 +478,17 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
 
         // store velocity
         h_vel.data[j].x = v.x; h_vel.data[j].y = v.y; h_vel.data[j].z = v.z;
-        }
-
-    if (m_aniso)
-        {
-        // angular degrees of freedom
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
-
-        // precompute loop invariant quantity
-        Scalar xi_rot = v.variable[8];
-        Scalar exp_thermo_fac_rot = exp(-(xi_rot+mtk)*m_deltaT/Scalar(2.0));
 
         // apply rotational (NO_SQUISH) equations of motion
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        if (m_aniso)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // thermostat angular degrees of freedom
-            p = p*exp_thermo_fac_rot;
-
-            // advance p(t+deltaT/2)->p(t+deltaT)
-            p += m_deltaT*q*t;
+            // thermostat angular degrees of freedom and advance p(t+deltaT/2)->p(t+deltaT)
+            advanceRotationStepTwo(q, p, t, I, m_deltaT, exp_thermo_fac_rot);
 
             h_angmom.data[j] = quat_to_scalar4(p);
             }
@@ -909,14 +831,23 @@ void TwoStepNPTMTK::advanceBarostat(unsigned int timestep)
 
 void TwoStepNPTMTK::advanceThermostat(unsigned int timestep)
     {
-    IntegratorVariables v = getIntegratorVariables();
-    Scalar& eta = v.variable[0];
-    Scalar& xi = v.variable[1];
-
     // compute the current thermodynamic properties
     m_thermo_group->compute(timestep);
 
     Scalar curr_T_trans = m_thermo_group->getTranslationalTemperature();
+    Scalar curr_ke_rot = Scalar(0.0);
+    if (m_aniso)
+        curr_ke_rot = m_thermo_group->getRotationalKineticEnergy();
+
+    updateThermostat(timestep, curr_T_trans, curr_ke_rot);
+    }
+
+void TwoStepNPTMTK::updateThermostat(unsigned int timestep, Scalar curr_T_trans, Scalar curr_ke_rot)
+    {
+    IntegratorVariables v = getIntegratorVariables();
+    Scalar& eta = v.variable[0];
+    Scalar& xi = v.variable[1];
+
     Scalar T = m_T->getValue(timestep);
 
     // update the state variables Xi and eta
@@ -930,7 +861,6 @@ void TwoStepNPTMTK::advanceThermostat(unsigned int timestep)
         Scalar &xi_rot = v.variable[8];
         Scalar &eta_rot = v.variable[9];
 
-        Scalar curr_ke_rot = m_thermo_group->getRotationalKineticEnergy();
         unsigned int ndof_rot = m_thermo_group->getRotationalNDOF();
 
         Scalar xi_prime_rot = xi_rot + Scalar(1.0/2.0)*m_deltaT/m_tau/m_tau*(Scalar(2.0)*curr_ke_rot/ndof_rot/T - Scalar(1.0));
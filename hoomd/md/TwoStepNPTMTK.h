@@ -196,6 +196,13 @@ class TwoStepNPTMTK : public IntegrationMethodTwoStep
          */
         void advanceThermostat(unsigned int timestep);
 
+        //! advance the thermostat with kinetic energies accumulated during the integration step
+        /*!\param timestep The time step
+         * \param curr_T_trans Current translational temperature of the group
+         * \param curr_ke_rot Current rotational kinetic energy of the group (only used with anisotropic integration)
+         */
+        void updateThermostat(unsigned int timestep, Scalar curr_T_trans, Scalar curr_ke_rot);
+
         //! Helper function to update the propagator elements
         void updatePropagator(Scalar nuxx, Scalar nuxy, Scalar nuxz, Scalar nuyy, Scalar nuyz, Scalar nuzz);
 
@@ -72,25 +72,45 @@ void TwoStepNVE::removeLimit()
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the velocity verlet
           method.
+
+    The translational update, the wrapping into the box and the rotational update are done in a single pass over the
+    group, split across OpenMP threads.
 */
 void TwoStepNVE::integrateStepOne(unsigned int timestep)
     {
+    if (m_pdata->getSoALayout())
+        {
+        integrateStepOneSoA();
+        return;
+        }
+
     unsigned int group_size = m_group->getNumMembers();
 
     // profile this step
     if (m_prof)
         m_prof->push("NVE step 1");
 
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    // particles may be moved slightly outside the box by the update, wrap them back into place
+    const BoxDim& box = m_pdata->getBox();
 
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
         if (m_zero_force)
             h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
 
@@ -117,121 +137,19 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
         h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
         h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
         h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
-        }
-
-    // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-    const BoxDim& box = m_pdata->getBox();
-
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
         box.wrap(h_pos.data[j], h_image.data[j]);
-        }
-
-    // Integration of angular degrees of freedom using sympletic and
-    // time-reversal symmetric integration scheme of Miller et al.
-    if (m_aniso)
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        // Integration of angular degrees of freedom using sympletic and
+        // time-reversal symmetric integration scheme of Miller et al.
+        if (m_aniso)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-            // using Trotter factorization of rotation Liouvillian
-            p += m_deltaT*q*t;
-
-            quat<Scalar> p1, p2, p3; // permutated quaternions
-            quat<Scalar> q1, q2, q3;
-            Scalar phi1, cphi1, sphi1;
-            Scalar phi2, cphi2, sphi2;
-            Scalar phi3, cphi3, sphi3;
-
-            if (!z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (!x_zero)
-                {
-                p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
-                q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
-                phi1 = Scalar(1./4.)/I.x*dot(p,q1);
-                cphi1 = slow::cos(m_deltaT*phi1);
-                sphi1 = slow::sin(m_deltaT*phi1);
-
-                p=cphi1*p+sphi1*p1;
-                q=cphi1*q+sphi1*q1;
-                }
-
-            if (! y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (! z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            // renormalize (improves stability)
-            q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+            advanceRotationStepOne(q, p, t, I, m_deltaT, Scalar(1.0));
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
@@ -248,6 +166,12 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
 */
 void TwoStepNVE::integrateStepTwo(unsigned int timestep)
     {
+    if (m_pdata->getSoALayout())
+        {
+        integrateStepTwoSoA();
+        return;
+        }
+
     unsigned int group_size = m_group->getNumMembers();
 
     const GPUArray< Scalar4 >& net_force = m_pdata->getNetForce();
@@ -256,15 +180,23 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVE step 2");
 
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
+    // angular degrees of freedom
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
 
         if (m_zero_force)
             {
@@ -295,40 +227,164 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
                 h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
                 }
             }
+
+        if (m_aniso)
+            {
+            quat<Scalar> q(h_orientation.data[j]);
+            quat<Scalar> p(h_angmom.data[j]);
+            vec3<Scalar> t(h_net_torque.data[j]);
+            vec3<Scalar> I(h_inertia.data[j]);
+
+            // advance p(t+deltaT/2)->p(t+deltaT)
+            advanceRotationStepTwo(q, p, t, I, m_deltaT, Scalar(1.0));
+            h_angmom.data[j] = quat_to_scalar4(p);
+            }
         }
 
-    if (m_aniso)
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! Same as integrateStepOne(), with the positions and velocities read and written through SoAHandle
+*/
+void TwoStepNVE::integrateStepOneSoA()
+    {
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("NVE step 1");
+
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
+    SoAHandle h_soa(*m_pdata, soa_field::position | soa_field::velocity, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        // angular degrees of freedom
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        unsigned int j = h_index_array.data[group_idx];
+        if (m_zero_force)
+            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
+
+        const Scalar3 a = h_accel.data[j];
+        Scalar dx = h_soa.vx[j]*m_deltaT + Scalar(1.0/2.0)*a.x*m_deltaT*m_deltaT;
+        Scalar dy = h_soa.vy[j]*m_deltaT + Scalar(1.0/2.0)*a.y*m_deltaT*m_deltaT;
+        Scalar dz = h_soa.vz[j]*m_deltaT + Scalar(1.0/2.0)*a.z*m_deltaT*m_deltaT;
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        // limit the movement of the particles
+        if (m_limit)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
+            Scalar len = sqrt(dx*dx + dy*dy + dz*dz);
+            if (len > m_limit_val)
+                {
+                dx = dx / len * m_limit_val;
+                dy = dy / len * m_limit_val;
+                dz = dz / len * m_limit_val;
+                }
+            }
 
+        Scalar3 pos = make_scalar3(h_soa.x[j] + dx, h_soa.y[j] + dy, h_soa.z[j] + dz);
+        box.wrap(pos, h_image.data[j]);
+        h_soa.x[j] = pos.x;
+        h_soa.y[j] = pos.y;
+        h_soa.z[j] = pos.z;
+
+        h_soa.vx[j] += Scalar(1.0/2.0)*a.x*m_deltaT;
+        h_soa.vy[j] += Scalar(1.0/2.0)*a.y*m_deltaT;
+        h_soa.vz[j] += Scalar(1.0/2.0)*a.z*m_deltaT;
+
+        if (m_aniso)
+            {
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
+            advanceRotationStepOne(q, p, t, I, m_deltaT, Scalar(1.0));
 
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
+            h_orientation.data[j] = quat_to_scalar4(q);
+            h_angmom.data[j] = quat_to_scalar4(p);
+            }
+        }
 
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
 
-            // advance p(t+deltaT/2)->p(t+deltaT)
-            p += m_deltaT*q*t;
+/*! Same as integrateStepTwo(), with the velocities and masses read and written through SoAHandle
+*/
+void TwoStepNVE::integrateStepTwoSoA()
+    {
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("NVE step 2");
+
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
+    SoAHandle h_soa(*m_pdata, soa_field::velocity, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
+        {
+        unsigned int j = h_index_array.data[group_idx];
+
+        Scalar3 a = make_scalar3(0.0, 0.0, 0.0);
+        if (!m_zero_force)
+            {
+            Scalar minv = Scalar(1.0) / h_soa.mass[j];
+            a.x = h_net_force.data[j].x*minv;
+            a.y = h_net_force.data[j].y*minv;
+            a.z = h_net_force.data[j].z*minv;
+            }
+        h_accel.data[j] = a;
+
+        Scalar vx = h_soa.vx[j] + Scalar(1.0/2.0)*a.x*m_deltaT;
+        Scalar vy = h_soa.vy[j] + Scalar(1.0/2.0)*a.y*m_deltaT;
+        Scalar vz = h_soa.vz[j] + Scalar(1.0/2.0)*a.z*m_deltaT;
 
+        // limit the movement of the particles
+        if (m_limit)
+            {
+            Scalar vel = sqrt(vx*vx + vy*vy + vz*vz);
+            if ( (vel*m_deltaT) > m_limit_val)
+                {
+                vx = vx / vel * m_limit_val / m_deltaT;
+                vy = vy / vel * m_limit_val / m_deltaT;
+                vz = vz / vel * m_limit_val / m_deltaT;
+                }
+            }
+
+        h_soa.vx[j] = vx;
+        h_soa.vy[j] = vy;
+        h_soa.vz[j] = vz;
+
+        if (m_aniso)
+            {
+            quat<Scalar> q(h_orientation.data[j]);
+            quat<Scalar> p(h_angmom.data[j]);
+            vec3<Scalar> t(h_net_torque.data[j]);
+            vec3<Scalar> I(h_inertia.data[j]);
+
+            // advance p(t+deltaT/2)->p(t+deltaT)
+            advanceRotationStepTwo(q, p, t, I, m_deltaT, Scalar(1.0));
             h_angmom.data[j] = quat_to_scalar4(p);
             }
         }
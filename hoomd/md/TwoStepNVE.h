@@ -58,6 +58,12 @@ class TwoStepNVE : public IntegrationMethodTwoStep
         bool m_limit;       //!< True if we should limit the distance a particle moves in one step
         Scalar m_limit_val; //!< The maximum distance a particle is to move in one step
         bool m_zero_force;  //!< True if the integration step should ignore computed forces
+
+        //! Performs the first step of the integration in the structure-of-arrays layout
+        void integrateStepOneSoA();
+
+        //! Performs the second step of the integration in the structure-of-arrays layout
+        void integrateStepTwoSoA();
     };
 
 //! Exports the TwoStepNVE class to python
@@ -112,6 +112,10 @@ Scalar TwoStepNVTMTK::getLogValue(const std::string& quantity, unsigned int time
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the velocity verlet
           method.
+
+    The translational update, the wrapping into the box and the rotational update are done in a single pass over the
+    group, split across OpenMP threads. When the thermo compute works on the integration group, the kinetic energies
+    needed by the thermostat are summed in the same pass instead of in a separate ComputeThermo sweep.
 */
 void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
     {
@@ -127,15 +131,42 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVT step 1");
 
+    // the kinetic energies can be accumulated in the update loop if the thermo compute uses the same group
+    const bool fold_thermo = m_thermo->getGroup() == m_group;
+
+    // twice the kinetic energies of the local group members after the update
+    double ke_trans = 0.0;
+    double ke_rot = 0.0;
+
+    // thermostat factor for the rotational degrees of freedom
+    Scalar exp_fac = Scalar(1.0);
+    if (m_aniso)
+        {
+        IntegratorVariables v = getIntegratorVariables();
+        Scalar xi_rot = v.variable[2];
+        exp_fac = exp(-m_deltaT/Scalar(2.0)*xi_rot);
+        }
+
     // scope array handles for proper releasing before calling the thermo compute
     {
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    // particles may be moved slightly outside the box by the update, wrap them back into place
+    const BoxDim& box = m_pdata->getBox();
+
+    #pragma omp parallel for schedule(static) reduction(+:ke_trans,ke_rot)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
 
         // load variables
         Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
@@ -158,139 +189,52 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
         h_pos.data[j].x = pos.x;
         h_pos.data[j].y = pos.y;
         h_pos.data[j].z = pos.z;
-        }
-
-    // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-    const BoxDim& box = m_pdata->getBox();
-
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
         // wrap the particles around the box
         box.wrap(h_pos.data[j], h_image.data[j]);
-        }
-    }
 
-    // Integration of angular degrees of freedom using sympletic and
-    // time-reversal symmetric integration scheme of Miller et al., extended by thermostat
-    if (m_aniso)
-        {
-        // thermostat factor
-        IntegratorVariables v = getIntegratorVariables();
-        Scalar xi_rot = v.variable[2];
-        Scalar exp_fac = exp(-m_deltaT/Scalar(2.0)*xi_rot);
+        if (fold_thermo)
+            ke_trans += (double)h_vel.data[j].w*((double)v.x*(double)v.x + (double)v.y*(double)v.y
+                                                 + (double)v.z*(double)v.z);
 
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
-
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        // Integration of angular degrees of freedom using sympletic and
+        // time-reversal symmetric integration scheme of Miller et al., extended by thermostat
+        if (m_aniso)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-            // using Trotter factorization of rotation Liouvillian
-            p += m_deltaT*q*t;
-
-            // apply thermostat
-            p = p*exp_fac;
-
-            quat<Scalar> p1, p2, p3; // permutated quaternions
-            quat<Scalar> q1, q2, q3;
-            Scalar phi1, cphi1, sphi1;
-            Scalar phi2, cphi2, sphi2;
-            Scalar phi3, cphi3, sphi3;
-
-            if (!z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-           if (!x_zero)
-                {
-                p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
-                q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
-                phi1 = Scalar(1./4.)/I.x*dot(p,q1);
-                cphi1 = slow::cos(m_deltaT*phi1);
-                sphi1 = slow::sin(m_deltaT*phi1);
-
-                p=cphi1*p+sphi1*p1;
-                q=cphi1*q+sphi1*q1;
-                }
-
-            if (! y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-                q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-                phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-                cphi2 = slow::cos(Scalar(1./2.)*m_deltaT*phi2);
-                sphi2 = slow::sin(Scalar(1./2.)*m_deltaT*phi2);
-
-                p=cphi2*p+sphi2*p2;
-                q=cphi2*q+sphi2*q2;
-                }
-
-            if (! z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-                q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-                phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-                cphi3 = slow::cos(Scalar(1./2.)*m_deltaT*phi3);
-                sphi3 = slow::sin(Scalar(1./2.)*m_deltaT*phi3);
-
-                p=cphi3*p+sphi3*p3;
-                q=cphi3*q+sphi3*q3;
-                }
-
-            // renormalize (improves stability)
-            q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+            advanceRotationStepOne(q, p, t, I, m_deltaT, exp_fac);
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
+
+            if (fold_thermo)
+                ke_rot += rotationalKineticEnergy2(q, p, I);
             }
         }
+    }
 
     // get temperature and advance thermostat
-    advanceThermostat(timestep);
+    if (fold_thermo)
+        {
+        #ifdef ENABLE_MPI
+        if (m_comm)
+            {
+            double ke[2] = {ke_trans, ke_rot};
+            MPI_Allreduce(MPI_IN_PLACE, ke, 2, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+            ke_trans = ke[0];
+            ke_rot = ke[1];
+            }
+        #endif
+
+        Scalar curr_T_trans = Scalar(ke_trans)/m_thermo->getNDOF();
+        updateThermostat(timestep, curr_T_trans, Scalar(0.5*ke_rot), true);
+        }
+    else
+        advanceThermostat(timestep);
 
     // done profiling
     if (m_prof)
@@ -310,16 +254,31 @@ void TwoStepNVTMTK::integrateStepTwo(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVT step 2");
 
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
-    // perform second half step of Nose-Hoover integration
+    // angular degrees of freedom
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    Scalar exp_fac = Scalar(1.0);
+    if (m_aniso)
+        {
+        IntegratorVariables v = getIntegratorVariables();
+        Scalar xi_rot = v.variable[2];
+        exp_fac = exp(-m_deltaT/Scalar(2.0)*xi_rot);
+        }
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    // perform second half step of Nose-Hoover integration
+    #pragma omp parallel for schedule(static)
+    for (int group_idx = 0; group_idx < (int)group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index_array.data[group_idx];
 
         // load velocity
         Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
@@ -344,46 +303,16 @@ void TwoStepNVTMTK::integrateStepTwo(unsigned int timestep)
 
         // store acceleration
         h_accel.data[j] = accel;
-        }
-
-    if (m_aniso)
-        {
-        IntegratorVariables v = getIntegratorVariables();
-        Scalar xi_rot = v.variable[2];
-        Scalar exp_fac = exp(-m_deltaT/Scalar(2.0)*xi_rot);
-
-        // angular degrees of freedom
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        if (m_aniso)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
             vec3<Scalar> t(h_net_torque.data[j]);
             vec3<Scalar> I(h_inertia.data[j]);
 
-            // rotate torque into principal frame
-            t = rotate(conj(q),t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero) t.x = 0;
-            if (y_zero) t.y = 0;
-            if (z_zero) t.z = 0;
-
-            // apply thermostat
-            p = p*exp_fac;
-
-            // advance p(t+deltaT/2)->p(t+deltaT)
-            p += m_deltaT*q*t;
+            // apply thermostat and advance p(t+deltaT/2)->p(t+deltaT)
+            advanceRotationStepTwo(q, p, t, I, m_deltaT, exp_fac);
 
             h_angmom.data[j] = quat_to_scalar4(p);
             }
@@ -396,14 +325,22 @@ void TwoStepNVTMTK::integrateStepTwo(unsigned int timestep)
 
 void TwoStepNVTMTK::advanceThermostat(unsigned int timestep, bool broadcast)
     {
-    IntegratorVariables v = getIntegratorVariables();
-    Scalar& xi = v.variable[0];
-    Scalar& eta = v.variable[1];
-
     // compute the current thermodynamic properties
     m_thermo->compute(timestep+1);
 
     Scalar curr_T_trans = m_thermo->getTranslationalTemperature();
+    Scalar curr_ke_rot = Scalar(0.0);
+    if (m_aniso)
+        curr_ke_rot = m_thermo->getRotationalKineticEnergy();
+
+    updateThermostat(timestep, curr_T_trans, curr_ke_rot, broadcast);
+    }
+
+void TwoStepNVTMTK::updateThermostat(unsigned int timestep, Scalar curr_T_trans, Scalar curr_ke_rot, bool broadcast)
+    {
+    IntegratorVariables v = getIntegratorVariables();
+    Scalar& xi = v.variable[0];
+    Scalar& eta = v.variable[1];
 
     // update the state variables Xi and eta
     Scalar xi_prime = xi + Scalar(1.0/2.0)*m_deltaT/m_tau/m_tau*(curr_T_trans/m_T->getValue(timestep) - Scalar(1.0));
@@ -428,7 +365,6 @@ void TwoStepNVTMTK::advanceThermostat(unsigned int timestep, bool broadcast)
         Scalar &xi_rot = v.variable[2];
         Scalar &eta_rot = v.variable[3];
 
-        Scalar curr_ke_rot = m_thermo->getRotationalKineticEnergy();
         unsigned int ndof_rot = m_thermo->getRotationalNDOF();
 
         Scalar xi_prime_rot = xi_rot + Scalar(1.0/2.0)*m_deltaT/m_tau/m_tau*
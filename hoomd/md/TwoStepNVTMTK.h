@@ -110,6 +110,14 @@ class TwoStepNVTMTK : public IntegrationMethodTwoStep
          * \param broadcast True if we should broadcast the integrator variables via MPI
          */
         void advanceThermostat(unsigned int timestep, bool broadcast=true);
+
+        //! advance the thermostat with kinetic energies accumulated during the integration step
+        /*!\param timestep The time step
+         * \param curr_T_trans Current translational temperature of the group
+         * \param curr_ke_rot Current rotational kinetic energy of the group (only used with anisotropic integration)
+         * \param broadcast True if we should broadcast the integrator variables via MPI
+         */
+        void updateThermostat(unsigned int timestep, Scalar curr_T_trans, Scalar curr_ke_rot, bool broadcast);
     };
 
 //! Exports the TwoStepNVTMTK class to python
@@ -238,20 +238,46 @@ class distance(_constraint_force):
 
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
 
-    def set_params(self,rel_tol=None):
+    def set_params(self,rel_tol=None,solver=None,tol=None,max_iter=None):
         R""" Set parameters for constraint computation.
 
         Args:
             rel_tol (float): The relative tolerance with which constraint violations are detected (**optional**).
+            solver (str): Either 'direct' (sparse LU factorization) or 'iterative' (matrix-free BiCGSTAB) (**optional**).
+            tol (float): Relative residual at which the iterative solver stops (**optional**).
+            max_iter (int): Maximum number of iterations of the iterative solver (**optional**).
+
+        The direct solver factorizes the constraint matrix every time step. For systems with many constraints, the
+        iterative solver is faster: it never forms the matrix, starts from the Lagrange multipliers of the previous
+        time step, and is threaded on the CPU. The iterative solver always runs on the CPU.
+
+        The number of iterations and the relative residual of the last solve can be logged with the quantities
+        **constrain_distance_iterations** and **constrain_distance_residual**.
 
         Example::
 
             dist = constrain.distance()
             dist.set_params(rel_tol=0.0001)
+            dist.set_params(solver='iterative', tol=1e-8, max_iter=500)
         """
         if rel_tol is not None:
             self.cpp_force.setRelativeTolerance(float(rel_tol))
 
+        if solver is not None:
+            if solver == 'direct':
+                self.cpp_force.setIterative(False)
+            elif solver == 'iterative':
+                self.cpp_force.setIterative(True)
+            else:
+                hoomd.context.msg.error("constrain.distance: Unknown solver " + str(solver) + "\n")
+                raise RuntimeError("Error setting constraint parameters")
+
+        if tol is not None:
+            self.cpp_force.setSolverTolerance(float(tol))
+
+        if max_iter is not None:
+            self.cpp_force.setMaxIterations(int(max_iter))
+
 class rigid(_constraint_force):
     R""" Constrain particles in rigid bodies.
 
@@ -122,6 +122,42 @@ class analyze_log_query_tests (unittest.TestCase):
         self.assertEqual(U0, U1);
         self.assertEqual(K0, K1);
 
+    # tests that all buffered rows are in the file when run() returns
+    def test_file_rows(self):
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.log');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        log = hoomd.analyze.log(quantities = ['potential_energy', 'temperature', 'pressure_xy'], period = 10, filename=self.tmp_file, overwrite=True);
+        hoomd.run(101);
+
+        if hoomd.comm.get_rank() == 0:
+            data = numpy.genfromtxt(self.tmp_file, names=True);
+            self.assertEqual(len(data), 11);
+            self.assertEqual(int(data['timestep'][-1]), int(log.query('timestep')));
+            self.assertAlmostEqual(data['potential_energy'][-1], log.query('potential_energy'), places=5);
+            self.assertAlmostEqual(data['temperature'][-1], log.query('temperature'), places=5);
+            os.remove(self.tmp_file);
+
+    # tests the per class timing quantities
+    def test_timing(self):
+        hoomd.util.set_timing_params(reset=True);
+        pair_name = type(self.pair.cpp_force).__name__;
+        integrator_name = type(hoomd.context.current.integrator.cpp_integrator).__name__;
+        log = hoomd.analyze.log(quantities = ['time_' + pair_name, 'time_' + integrator_name], period = 10, filename=None);
+        hoomd.run(20);
+        t_pair = log.query('time_' + pair_name);
+        t_integrator = log.query('time_' + integrator_name);
+
+        self.assertGreater(t_pair, 0);
+        self.assertGreater(t_integrator, 0);
+
+        timings = hoomd.util.get_timings();
+        self.assertGreaterEqual(timings[pair_name]['steps'], 20);
+        self.assertGreater(timings[integrator_name]['total'], timings[integrator_name]['self']);
+
     def tearDown(self):
         self.pair = None;
         hoomd.context.initialize();
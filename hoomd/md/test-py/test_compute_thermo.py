@@ -26,7 +26,7 @@ class compute_thermo_tests (unittest.TestCase):
             self.snap.particles.velocity[:] = self.v
             self.snap.particles.mass[:] = self.m
 
-        init.read_snapshot(self.snap)
+        self.s = init.read_snapshot(self.snap)
         context.current.sorter.set_params(grid=8)
 
     # API test: tests basic creation of the compute
@@ -76,7 +76,37 @@ class compute_thermo_tests (unittest.TestCase):
         numpy.testing.assert_allclose(log.query('temperature_A'), 2.0 / (3*self.N-3) * K_ref)
 
 
+    # Unit test: the degrees of freedom follow the members of a dynamic group
+    def test_dynamic_group(self):
+        def place(n_left):
+            snap = self.s.take_snapshot()
+            if comm.get_rank() == 0:
+                snap.particles.position[:] = 0
+                snap.particles.position[:n_left,0] = -1
+                snap.particles.position[n_left:,0] = 1
+            self.s.restore_snapshot(snap)
+
+        place(100)
+        left = group.cuboid(name='left', xmax=0)
+        compute.thermo(group=left);
+        update.dynamic_group(left, period=1);
+        log = analyze.log(filename=None, quantities=['num_particles_left', 'ndof_left'], period=None);
+
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.all());
+
+        run(1);
+        numpy.testing.assert_allclose(log.query('num_particles_left'), 100)
+        numpy.testing.assert_allclose(log.query('ndof_left'), 3*100-3)
+
+        # particles enter the group during the run
+        place(300)
+        run(1);
+        numpy.testing.assert_allclose(log.query('num_particles_left'), 300)
+        numpy.testing.assert_allclose(log.query('ndof_left'), 3*300-3)
+
     def tearDown(self):
+        del self.s
         context.initialize();
 
 
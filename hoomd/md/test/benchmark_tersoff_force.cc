@@ -0,0 +1,252 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file benchmark_tersoff_force.cc
+    \brief Compares the cost of PotentialTripletTersoff with the serial three-body loop it replaced
+
+    Usage: benchmark_tersoff_force [n_cells] [n_steps]
+
+    On a perturbed silicon diamond lattice of n_cells^3 conventional cells, prints the time per force evaluation of
+    PotentialTripletTersoff for every thread count the autotuner samples, and of the serial reference loop that
+    recomputes every separation on every visit.
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/AllTripletPotentials.h"
+
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/ClockSource.h"
+#include "hoomd/extern/saruprng.h"
+
+#include <math.h>
+
+using namespace std;
+
+//! Runs PotentialTripletTersoff on a fixed number of threads
+class TersoffThreadPinned : public PotentialTripletTersoff
+    {
+    public:
+        //! Constructs the potential, with the thread autotuner only offering \a n_threads
+        TersoffThreadPinned(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<NeighborList> nlist,
+                            unsigned int n_threads)
+            : PotentialTripletTersoff(sysdef, nlist)
+            {
+            m_thread_tuner.reset(new Autotuner(std::vector<unsigned int>(1, n_threads), 5, 100000,
+                                               "benchmark_threads", m_exec_conf));
+            }
+    };
+
+//! Build a perturbed silicon diamond lattice with n x n x n conventional cells
+std::shared_ptr<SystemDefinition> build_diamond(unsigned int n, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const Scalar a = Scalar(5.431);
+    const Scalar basis[8][3] = {{0,0,0}, {0,0.5,0.5}, {0.5,0,0.5}, {0.5,0.5,0},
+                                {0.25,0.25,0.25}, {0.25,0.75,0.75}, {0.75,0.25,0.75}, {0.75,0.75,0.25}};
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8*n*n*n, BoxDim(a*n), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    Saru saru(11, 21, 33);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    unsigned int idx = 0;
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+            for (unsigned int k = 0; k < n; k++)
+                for (unsigned int b = 0; b < 8; b++)
+                    {
+                    // displace the sites slightly so that the forces don't vanish by symmetry
+                    Scalar3 pos = make_scalar3((Scalar(i) + basis[b][0]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05),
+                                               (Scalar(j) + basis[b][1]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05),
+                                               (Scalar(k) + basis[b][2]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05));
+                    h_pos.data[idx].x = pos.x;
+                    h_pos.data[idx].y = pos.y;
+                    h_pos.data[idx].z = pos.z;
+                    idx++;
+                    }
+
+    return sysdef;
+    }
+
+//! Tersoff (1988) parameters for silicon
+tersoff_params make_silicon_params()
+    {
+    Scalar n = Scalar(0.78734);
+    Scalar beta = Scalar(1.1e-6);
+    Scalar c = Scalar(100390.0);
+    Scalar d = Scalar(16.217);
+    return make_tersoff_params(Scalar(0.3),
+                               make_scalar2(1830.8, 471.18),
+                               make_scalar2(2.4799, 1.7322),
+                               Scalar(0.0),
+                               n,
+                               pow(beta, n),
+                               Scalar(0.0),
+                               make_scalar3(c*c, d*d, -0.59825),
+                               Scalar(3.0));
+    }
+
+//! Reference implementation of the serial three-body loop, recomputing every separation on every visit
+void compute_reference_forces(std::shared_ptr<SystemDefinition> sysdef,
+                              std::shared_ptr<NeighborList> nlist,
+                              const tersoff_params& param,
+                              Scalar rcutsq,
+                              std::vector<Scalar4>& force)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(nlist->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    const BoxDim& box = pdata->getBox();
+
+    force.assign(pdata->getN(), make_scalar4(0,0,0,0));
+
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        const unsigned int head_i = h_head_list.data[i];
+        const unsigned int size = h_n_neigh.data[i];
+        for (unsigned int j = 0; j < size; j++)
+            {
+            unsigned int jj = h_nlist.data[head_i + j];
+            Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
+            Scalar3 dxij = box.minImage(posi - posj);
+            Scalar rij_sq = dot(dxij, dxij);
+
+            Scalar fR = 0.0;
+            Scalar fA = 0.0;
+            EvaluatorTersoff eval(rij_sq, rcutsq, param);
+            if (!eval.evalRepulsiveAndAttractive(fR, fA))
+                continue;
+
+            Scalar chi = 0.0;
+            for (unsigned int k = 0; k < size; k++)
+                {
+                unsigned int kk = h_nlist.data[head_i + k];
+                if (kk == jj)
+                    continue;
+                Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
+                Scalar3 dxik = box.minImage(posi - posk);
+                Scalar rik_sq = dot(dxik, dxik);
+                eval.setRik(rik_sq);
+                eval.setAngle(dot(dxij, dxik) / sqrt(rij_sq * rik_sq));
+                eval.evalChi(chi);
+                }
+
+            Scalar force_divr = Scalar(0.0);
+            Scalar potential_eng = Scalar(0.0);
+            Scalar bij = Scalar(0.0);
+            eval.evalForceij(fR, fA, chi, bij, force_divr, potential_eng);
+
+            Scalar3 fi = force_divr * dxij;
+            Scalar3 fj = Scalar(-1.0) * force_divr * dxij;
+            force[i].w += potential_eng * Scalar(0.5);
+            force[jj].w += potential_eng * Scalar(0.5);
+
+            for (unsigned int k = 0; k < size; k++)
+                {
+                unsigned int kk = h_nlist.data[head_i + k];
+                if (kk == jj)
+                    continue;
+                Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
+                Scalar3 dxik = box.minImage(posi - posk);
+                Scalar rik_sq = dot(dxik, dxik);
+                eval.setRik(rik_sq);
+                eval.setAngle(dot(dxij, dxik) / sqrt(rij_sq * rik_sq));
+
+                Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
+                Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
+                eval.evalForceik(fR, fA, chi, bij, force_divr_ij, force_divr_ik);
+
+                fi += force_divr_ij.x * dxij + force_divr_ik.x * dxik;
+                fj += force_divr_ij.y * dxij + force_divr_ik.y * dxik;
+                Scalar3 fk = force_divr_ij.z * dxij + force_divr_ik.z * dxik;
+                force[kk].x += fk.x;
+                force[kk].y += fk.y;
+                force[kk].z += fk.z;
+                }
+
+            force[i].x += fi.x;
+            force[i].y += fi.y;
+            force[i].z += fi.z;
+            force[jj].x += fj.x;
+            force[jj].y += fj.y;
+            force[jj].z += fj.z;
+            }
+        }
+    }
+
+int main(int argc, char **argv)
+    {
+    unsigned int n_cells = 6;
+    unsigned int n_steps = 20;
+    if (argc > 1)
+        n_cells = atoi(argv[1]);
+    if (argc > 2)
+        n_steps = atoi(argv[2]);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->msg->setNoticeLevel(0);
+    std::shared_ptr<SystemDefinition> sysdef = build_diamond(n_cells, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.3)));
+    nlist->setStorageMode(NeighborList::full);
+
+    tersoff_params param = make_silicon_params();
+
+    // build the neighbor list outside of the timed loops
+    nlist->compute(0);
+
+    std::vector<Scalar4> ref_force;
+    ClockSource clk;
+    for (unsigned int step = 0; step < n_steps; step++)
+        compute_reference_forces(sysdef, nlist, param, Scalar(3.0*3.0), ref_force);
+    int64_t t_ref = clk.getTime();
+
+    cout << pdata->getN() << " particles" << endl;
+    cout << "reference loop: " << double(t_ref)/n_steps/1e6 << " ms/step" << endl;
+
+    // time every thread count that the autotuner would sample
+    std::vector<unsigned int> thread_counts = Autotuner::getThreadCounts();
+    for (unsigned int t = 0; t < thread_counts.size(); t++)
+        {
+        std::shared_ptr<TersoffThreadPinned> pinned(new TersoffThreadPinned(sysdef, nlist, thread_counts[t]));
+        pinned->setRcut(0, 0, Scalar(3.0));
+        pinned->setParams(0, 0, param);
+
+        // warm up the scratch arrays
+        pinned->compute(0);
+
+        clk = ClockSource();
+        for (unsigned int step = 1; step <= n_steps; step++)
+            pinned->compute(step);
+        int64_t t_tersoff = clk.getTime();
+
+        cout << "PotentialTripletTersoff, " << thread_counts[t] << " thread(s): " << double(t_tersoff)/n_steps/1e6
+             << " ms/step";
+
+        Scalar max_diff = 0.0;
+        ArrayHandle<Scalar4> h_force(pinned->getForceArray(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            max_diff = std::max(max_diff, Scalar(fabs(h_force.data[i].x - ref_force[i].x)));
+            max_diff = std::max(max_diff, Scalar(fabs(h_force.data[i].y - ref_force[i].y)));
+            max_diff = std::max(max_diff, Scalar(fabs(h_force.data[i].z - ref_force[i].z)));
+            }
+        if (max_diff > 1e-3)
+            cout << " MISMATCH";
+        cout << endl;
+        }
+
+    return 0;
+    }
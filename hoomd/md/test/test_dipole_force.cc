@@ -20,6 +20,11 @@
 
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
+#include "hoomd/extern/saruprng.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 #include <math.h>
 
@@ -131,3 +136,129 @@ UP_TEST( AnisoPotentialPairDipoleGPU_particle )
     dipole_force_particle_test(dipole_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+//! Dipole potential with the thread autotuner pinned to a single thread count
+class DipoleThreadPinned : public AnisoPotentialPairDipole
+    {
+    public:
+        //! Constructs the potential, with the thread autotuner only offering \a n_threads
+        DipoleThreadPinned(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<NeighborList> nlist,
+                           unsigned int n_threads)
+            : AnisoPotentialPairDipole(sysdef, nlist)
+            {
+            m_thread_tuner.reset(new Autotuner(std::vector<unsigned int>(1, n_threads), 5, 100000,
+                                               "test_threads", m_exec_conf));
+            }
+    };
+
+//! Build a jittered cubic lattice of n x n x n randomly oriented, charged particles
+std::shared_ptr<SystemDefinition> build_random_dipoles(unsigned int n, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const Scalar a = Scalar(1.2);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n*n*n, BoxDim(a*n), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+    Saru saru(3, 5, 9);
+    for (unsigned int i = 0; i < n*n*n; i++)
+        {
+        vec3<Scalar> r(i % n, (i / n) % n, i / (n*n));
+        r = a*(r + vec3<Scalar>(saru.s<Scalar>(-0.15,0.15), saru.s<Scalar>(-0.15,0.15), saru.s<Scalar>(-0.15,0.15)))
+            - vec3<Scalar>(a*n/2, a*n/2, a*n/2);
+        h_pos.data[i] = make_scalar4(r.x, r.y, r.z, __int_as_scalar(0));
+
+        quat<Scalar> q(saru.s<Scalar>(-1,1), vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1)));
+        h_orientation.data[i] = quat_to_scalar4(q * (Scalar(1.0)/sqrt(norm2(q))));
+        h_charge.data[i] = saru.s<Scalar>(-1,1);
+        }
+    return sysdef;
+    }
+
+//! Compare the threaded dipole forces against an all-pairs loop over the evaluator
+/*! The reference loop never calls setRotationMatrix(), so it checks the cached rotation matrices against the
+    quaternion path used on the GPU. Both neighbor list storage modes are run on one and on several threads.
+*/
+UP_TEST( AnisoPotentialPairDipole_threads )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_random_dipoles(6, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    const unsigned int N = pdata->getN();
+
+    const Scalar rcut = Scalar(3.0);
+    // kappa = 0: with screening, the charge-dipole terms of the evaluator are not antisymmetric under i <-> j,
+    // so half and full neighbor lists would disagree regardless of threading
+    Scalar3 params = make_scalar3(0.6, 1.0, 0.0);
+
+    // reference forces, torques, energies and virials
+    std::vector<vec3<Scalar> > ref_force(N), ref_torque(N);
+    std::vector<Scalar> ref_energy(N, Scalar(0.0)), ref_virial(6*N, Scalar(0.0));
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::read);
+        const BoxDim& box = pdata->getBox();
+        for (unsigned int i = 0; i < N; i++)
+            for (unsigned int j = 0; j < N; j++)
+                {
+                if (i == j)
+                    continue;
+                Scalar3 dx = box.minImage(make_scalar3(h_pos.data[i].x - h_pos.data[j].x,
+                                                       h_pos.data[i].y - h_pos.data[j].y,
+                                                       h_pos.data[i].z - h_pos.data[j].z));
+                Scalar3 force = make_scalar3(0,0,0), torque_i = make_scalar3(0,0,0), torque_j = make_scalar3(0,0,0);
+                Scalar pair_eng = Scalar(0.0);
+                EvaluatorPairDipole eval(dx, h_orientation.data[i], h_orientation.data[j], rcut*rcut, params);
+                eval.setCharge(h_charge.data[i], h_charge.data[j]);
+                if (!eval.evaluate(force, pair_eng, false, torque_i, torque_j))
+                    continue;
+                ref_force[i] += vec3<Scalar>(force);
+                ref_torque[i] += vec3<Scalar>(torque_i);
+                ref_energy[i] += Scalar(0.5)*pair_eng;
+                ref_virial[6*i+0] += Scalar(0.5)*dx.x*force.x;
+                ref_virial[6*i+1] += Scalar(0.5)*dx.y*force.x;
+                ref_virial[6*i+2] += Scalar(0.5)*dx.z*force.x;
+                ref_virial[6*i+3] += Scalar(0.5)*dx.y*force.y;
+                ref_virial[6*i+4] += Scalar(0.5)*dx.z*force.y;
+                ref_virial[6*i+5] += Scalar(0.5)*dx.z*force.z;
+                }
+        }
+
+    std::vector<unsigned int> thread_counts(1, 1);
+    #ifdef ENABLE_OPENMP
+    thread_counts.push_back(std::max(omp_get_max_threads(), 4));
+    #endif
+
+    unsigned int timestep = 0;
+    for (unsigned int half = 0; half < 2; half++)
+        for (unsigned int t = 0; t < thread_counts.size(); t++)
+            {
+            std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, rcut, Scalar(0.3)));
+            nlist->setStorageMode(half ? NeighborList::half : NeighborList::full);
+            std::shared_ptr<DipoleThreadPinned> dipole(new DipoleThreadPinned(sysdef, nlist, thread_counts[t]));
+            dipole->setRcut(0, 0, rcut);
+            dipole->setParams(0, 0, params);
+            dipole->compute(timestep++);
+
+            ArrayHandle<Scalar4> h_force(dipole->getForceArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_torque(dipole->getTorqueArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_virial(dipole->getVirialArray(), access_location::host, access_mode::read);
+            unsigned int pitch = dipole->getVirialArray().getPitch();
+            for (unsigned int i = 0; i < N; i++)
+                {
+                MY_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+                MY_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+                MY_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+                MY_CHECK_SMALL(h_force.data[i].w - ref_energy[i], tol_small);
+                MY_CHECK_SMALL(h_torque.data[i].x - ref_torque[i].x, tol_small);
+                MY_CHECK_SMALL(h_torque.data[i].y - ref_torque[i].y, tol_small);
+                MY_CHECK_SMALL(h_torque.data[i].z - ref_torque[i].z, tol_small);
+                for (unsigned int k = 0; k < 6; k++)
+                    MY_CHECK_SMALL(h_virial.data[k*pitch+i] - ref_virial[6*i+k], tol_small);
+                }
+            }
+    }
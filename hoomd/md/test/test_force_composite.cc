@@ -0,0 +1,308 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "hoomd/md/ForceComposite.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/extern/saruprng.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+#include <math.h>
+
+using namespace std;
+
+/*! \file test_force_composite.cc
+    \brief Implements unit tests for the CPU rigid body update and force reduction in ForceComposite
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Number of rigid bodies in the test systems
+const unsigned int n_bodies = 50;
+
+//! Number of constituent particles per body
+const unsigned int n_constituents = 3;
+
+//! Relative positions of the constituent particles
+const Scalar template_pos[n_constituents][3] = {{1.0, 0.0, 0.0}, {0.0, 1.2, 0.0}, {-0.3, -0.4, 0.9}};
+
+//! Relative orientations of the constituent particles
+const Scalar template_orientation[n_constituents][4] = {{1.0, 0.0, 0.0, 0.0},
+                                                        {0.5, 0.5, 0.5, 0.5},
+                                                        {0.0, 0.0, 0.0, 1.0}};
+
+//! Thread counts the tests run with
+std::vector<int> get_thread_counts()
+    {
+    std::vector<int> n_threads(1, 1);
+    #ifdef ENABLE_OPENMP
+    // use several threads even on a single core, so that the bodies are split between threads
+    n_threads.push_back(std::max(omp_get_max_threads(), 4));
+    #endif
+    return n_threads;
+    }
+
+//! Set the number of threads of the following parallel regions
+void set_num_threads(int n_threads)
+    {
+    #ifdef ENABLE_OPENMP
+    omp_set_num_threads(n_threads);
+    #endif
+    }
+
+//! Build a system of randomly placed and oriented rigid bodies, with the constituent particles created by \a rigid
+std::shared_ptr<SystemDefinition> build_bodies(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                               std::shared_ptr<ForceComposite>& rigid)
+    {
+    // the box is small enough for many bodies to span the periodic boundaries
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n_bodies, BoxDim(8.0), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+
+        Saru saru(5, 7, 11);
+        for (unsigned int i = 0; i < n_bodies; i++)
+            {
+            h_pos.data[i] = make_scalar4(saru.s<Scalar>(-4.0, 4.0), saru.s<Scalar>(-4.0, 4.0),
+                                         saru.s<Scalar>(-4.0, 4.0), __int_as_scalar(0));
+
+            quat<Scalar> q(saru.s<Scalar>(-1.0, 1.0), vec3<Scalar>(saru.s<Scalar>(-1.0, 1.0),
+                           saru.s<Scalar>(-1.0, 1.0), saru.s<Scalar>(-1.0, 1.0)));
+            q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+            h_orientation.data[i] = quat_to_scalar4(q);
+            }
+        }
+
+    rigid = std::shared_ptr<ForceComposite>(new ForceComposite(sysdef));
+
+    std::vector<unsigned int> types(n_constituents, 1);
+    std::vector<Scalar3> pos;
+    std::vector<Scalar4> orientation;
+    std::vector<Scalar> charge(n_constituents, 0.0);
+    std::vector<Scalar> diameter(n_constituents, 1.0);
+    for (unsigned int j = 0; j < n_constituents; j++)
+        {
+        pos.push_back(make_scalar3(template_pos[j][0], template_pos[j][1], template_pos[j][2]));
+        orientation.push_back(make_scalar4(template_orientation[j][0], template_orientation[j][1],
+                                           template_orientation[j][2], template_orientation[j][3]));
+        }
+    rigid->setParam(0, types, pos, orientation, charge, diameter);
+    rigid->validateRigidBodies(true);
+
+    return sysdef;
+    }
+
+//! Checks that updateCompositeParticles() places every constituent according to the body template
+UP_TEST( ForceComposite_update_constituents )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<ForceComposite> rigid;
+    std::shared_ptr<SystemDefinition> sysdef = build_bodies(exec_conf, rigid);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    const BoxDim& box = pdata->getBox();
+
+    UP_ASSERT_EQUAL(pdata->getN(), n_bodies*(n_constituents+1));
+
+    std::vector<int> thread_counts = get_thread_counts();
+    for (unsigned int t = 0; t < thread_counts.size(); t++)
+        {
+            {
+            // move all constituents away from their template positions
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+            for (unsigned int tag = n_bodies; tag < pdata->getNGlobal(); tag++)
+                {
+                unsigned int idx = h_rtag.data[tag];
+                h_pos.data[idx].x = h_pos.data[idx].y = h_pos.data[idx].z = Scalar(0.0);
+                h_orientation.data[idx] = make_scalar4(1.0, 0.0, 0.0, 0.0);
+                }
+            }
+
+        set_num_threads(thread_counts[t]);
+        rigid->updateCompositeParticles(t);
+
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+        for (unsigned int body = 0; body < n_bodies; body++)
+            {
+            unsigned int central_idx = h_rtag.data[body];
+            vec3<Scalar> central_pos(h_pos.data[central_idx]);
+            quat<Scalar> central_orientation(h_orientation.data[central_idx]);
+            int3 central_image = h_image.data[central_idx];
+            vec3<Scalar> central_unwrapped(box.shift(vec_to_scalar3(central_pos), central_image));
+
+            for (unsigned int j = 0; j < n_constituents; j++)
+                {
+                // constituents are created in the order of their central particles
+                unsigned int idx = h_rtag.data[n_bodies + body*n_constituents + j];
+                UP_ASSERT_EQUAL(h_body.data[idx], body);
+
+                vec3<Scalar> expected_pos = central_unwrapped
+                    + rotate(central_orientation, vec3<Scalar>(template_pos[j][0], template_pos[j][1], template_pos[j][2]));
+                quat<Scalar> expected_orientation = central_orientation
+                    * quat<Scalar>(make_scalar4(template_orientation[j][0], template_orientation[j][1],
+                                                template_orientation[j][2], template_orientation[j][3]));
+
+                // the constituent is wrapped into the box, its image keeps track of the unwrapped position
+                Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+                Scalar3 unwrapped = box.shift(pos, h_image.data[idx]);
+                MY_CHECK_SMALL(unwrapped.x - expected_pos.x, tol_small);
+                MY_CHECK_SMALL(unwrapped.y - expected_pos.y, tol_small);
+                MY_CHECK_SMALL(unwrapped.z - expected_pos.z, tol_small);
+
+                Scalar3 f = box.makeFraction(pos);
+                UP_ASSERT(f.x >= Scalar(0.0) && f.x < Scalar(1.0));
+                UP_ASSERT(f.y >= Scalar(0.0) && f.y < Scalar(1.0));
+                UP_ASSERT(f.z >= Scalar(0.0) && f.z < Scalar(1.0));
+
+                MY_CHECK_SMALL(h_orientation.data[idx].x - expected_orientation.s, tol_small);
+                MY_CHECK_SMALL(h_orientation.data[idx].y - expected_orientation.v.x, tol_small);
+                MY_CHECK_SMALL(h_orientation.data[idx].z - expected_orientation.v.y, tol_small);
+                MY_CHECK_SMALL(h_orientation.data[idx].w - expected_orientation.v.z, tol_small);
+                }
+            }
+        }
+    set_num_threads(thread_counts[0]);
+    }
+
+//! Checks that computeForces() sums the constituent forces and torques onto the central particles
+UP_TEST( ForceComposite_reduce_forces )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<ForceComposite> rigid;
+    std::shared_ptr<SystemDefinition> sysdef = build_bodies(exec_conf, rigid);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    rigid->updateCompositeParticles(0);
+
+    std::vector<int> thread_counts = get_thread_counts();
+    for (unsigned int t = 0; t < thread_counts.size(); t++)
+        {
+        // expected force and torque on every body
+        std::vector<vec3<Scalar> > expected_force(n_bodies);
+        std::vector<vec3<Scalar> > expected_torque(n_bodies);
+        std::vector<Scalar> expected_energy(n_bodies, Scalar(0.0));
+
+            {
+            ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> h_net_torque(pdata->getNetTorqueArray(), access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+            memset(h_net_force.data, 0, sizeof(Scalar4)*pdata->getNetForce().getNumElements());
+            memset(h_net_torque.data, 0, sizeof(Scalar4)*pdata->getNetTorqueArray().getNumElements());
+
+            Saru saru(13, 17, t);
+            for (unsigned int body = 0; body < n_bodies; body++)
+                {
+                quat<Scalar> central_orientation(h_orientation.data[h_rtag.data[body]]);
+                for (unsigned int j = 0; j < n_constituents; j++)
+                    {
+                    unsigned int idx = h_rtag.data[n_bodies + body*n_constituents + j];
+                    vec3<Scalar> f(saru.s<Scalar>(-1.0, 1.0), saru.s<Scalar>(-1.0, 1.0), saru.s<Scalar>(-1.0, 1.0));
+                    vec3<Scalar> tq(saru.s<Scalar>(-1.0, 1.0), saru.s<Scalar>(-1.0, 1.0), saru.s<Scalar>(-1.0, 1.0));
+                    Scalar e = saru.s<Scalar>(0.0, 1.0);
+                    h_net_force.data[idx] = make_scalar4(f.x, f.y, f.z, e);
+                    h_net_torque.data[idx] = make_scalar4(tq.x, tq.y, tq.z, 0.0);
+
+                    vec3<Scalar> dr = rotate(central_orientation,
+                                             vec3<Scalar>(template_pos[j][0], template_pos[j][1], template_pos[j][2]));
+                    expected_force[body] += f;
+                    expected_torque[body] += cross(dr, f) + tq;
+                    expected_energy[body] += e;
+                    }
+                }
+            }
+
+        set_num_threads(thread_counts[t]);
+        rigid->compute(t);
+
+        ArrayHandle<Scalar4> h_force(rigid->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_torque(rigid->getTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+        for (unsigned int body = 0; body < n_bodies; body++)
+            {
+            unsigned int central_idx = h_rtag.data[body];
+            MY_CHECK_SMALL(h_force.data[central_idx].x - expected_force[body].x, tol_small);
+            MY_CHECK_SMALL(h_force.data[central_idx].y - expected_force[body].y, tol_small);
+            MY_CHECK_SMALL(h_force.data[central_idx].z - expected_force[body].z, tol_small);
+            MY_CHECK_SMALL(h_force.data[central_idx].w - expected_energy[body], tol_small);
+
+            MY_CHECK_SMALL(h_torque.data[central_idx].x - expected_torque[body].x, tol_small);
+            MY_CHECK_SMALL(h_torque.data[central_idx].y - expected_torque[body].y, tol_small);
+            MY_CHECK_SMALL(h_torque.data[central_idx].z - expected_torque[body].z, tol_small);
+
+            // the constituent forces are consumed, so that they are not counted twice
+            for (unsigned int j = 0; j < n_constituents; j++)
+                {
+                unsigned int idx = h_rtag.data[n_bodies + body*n_constituents + j];
+                MY_CHECK_SMALL(h_net_force.data[idx].x, tol_small);
+                MY_CHECK_SMALL(h_net_force.data[idx].w, tol_small);
+                MY_CHECK_SMALL(h_net_torque.data[idx].x, tol_small);
+
+                // constituents carry no constraint force themselves
+                MY_CHECK_SMALL(h_force.data[idx].x, tol_small);
+                MY_CHECK_SMALL(h_torque.data[idx].x, tol_small);
+                }
+            }
+        }
+    set_num_threads(thread_counts[0]);
+    }
+
+//! Checks that an incomplete body is reported by the lowest body tag, independent of the thread count
+UP_TEST( ForceComposite_incomplete_body )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<ForceComposite> rigid;
+    std::shared_ptr<SystemDefinition> sysdef = build_bodies(exec_conf, rigid);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // turn the central particles of two bodies into a type without constituents, so their molecules are too long
+    pdata->setType(31, 1);
+    pdata->setType(7, 1);
+
+    std::vector<int> thread_counts = get_thread_counts();
+    for (unsigned int t = 0; t < thread_counts.size(); t++)
+        {
+        std::ostringstream error;
+        exec_conf->msg->setErrorStream(error);
+
+        set_num_threads(thread_counts[t]);
+        bool thrown = false;
+        try
+            {
+            rigid->updateCompositeParticles(t);
+            }
+        catch (std::runtime_error&)
+            {
+            thrown = true;
+            }
+        UP_ASSERT(thrown);
+        UP_ASSERT(error.str().find("body tag 7 incomplete") != std::string::npos);
+        }
+    exec_conf->msg->setErrorStream(std::cerr);
+    set_num_threads(thread_counts[0]);
+    }
@@ -20,6 +20,7 @@
 #include "hoomd/CellList.h"
 #include "hoomd/md/NeighborList.h"
 #include "hoomd/md/NeighborListBinned.h"
+#include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
 #include "hoomd/deprecated/RandomGenerator.h"
 #include "hoomd/md/AllPairPotentials.h"
@@ -32,6 +33,10 @@
 
 #include "hoomd/extern/saruprng.h"
 
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
 #include <math.h>
 
 using namespace std;
@@ -790,6 +795,173 @@ void npt_mtk_updater_aniso(twostep_npt_mtk_creator npt_mtk_creator, std::shared_
         }
     }
 
+//! Build a jittered lattice of n x n x n randomly oriented and rotating particles
+std::shared_ptr< SnapshotSystemData<Scalar> > make_aniso_snapshot(unsigned int n)
+    {
+    const Scalar a = Scalar(1.3);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(a*n);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(n*n*n);
+
+    Saru saru(4, 2, 7);
+    for (unsigned int i = 0; i < n*n*n; i++)
+        {
+        vec3<Scalar> r(i % n, (i / n) % n, i / (n*n));
+        r += vec3<Scalar>(saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1));
+        snap->particle_data.pos[i] = a*(r - vec3<Scalar>(Scalar(n-1)/2, Scalar(n-1)/2, Scalar(n-1)/2));
+        snap->particle_data.vel[i] = vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1));
+
+        quat<Scalar> q(saru.s<Scalar>(-1,1), vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1)));
+        q = q*(Scalar(1.0)/sqrt(norm2(q)));
+        snap->particle_data.orientation[i] = q;
+
+        // angular momentum quaternion p = 2 q (0, L), with L in the body frame
+        vec3<Scalar> I(1.0, 0.8, 1.2);
+        vec3<Scalar> L(I.x*saru.s<Scalar>(-1,1), I.y*saru.s<Scalar>(-1,1), I.z*saru.s<Scalar>(-1,1));
+        snap->particle_data.inertia[i] = I;
+        snap->particle_data.angmom[i] = Scalar(2.0)*(q*L);
+        }
+    return snap;
+    }
+
+//! Checks that two systems have the same particle positions, velocities, orientations and angular momenta
+void check_same_state(std::shared_ptr<ParticleData> pdata1, std::shared_ptr<ParticleData> pdata2, Scalar tol)
+    {
+    ArrayHandle<Scalar4> h_pos1(pdata1->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel1(pdata1->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation1(pdata1->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom1(pdata1->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos2(pdata2->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel2(pdata2->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation2(pdata2->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom2(pdata2->getAngularMomentumArray(), access_location::host, access_mode::read);
+
+    for (unsigned int j = 0; j < pdata1->getN(); j++)
+        {
+        MY_CHECK_SMALL(h_pos1.data[j].x - h_pos2.data[j].x, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].y - h_pos2.data[j].y, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].z - h_pos2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_vel1.data[j].x - h_vel2.data[j].x, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].y - h_vel2.data[j].y, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].z - h_vel2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_orientation1.data[j].x - h_orientation2.data[j].x, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].y - h_orientation2.data[j].y, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].z - h_orientation2.data[j].z, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].w - h_orientation2.data[j].w, tol);
+
+        MY_CHECK_SMALL(h_angmom1.data[j].x - h_angmom2.data[j].x, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].y - h_angmom2.data[j].y, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].z - h_angmom2.data[j].z, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].w - h_angmom2.data[j].w, tol);
+        }
+    }
+
+//! Set the number of threads of the following parallel regions
+void set_num_threads(int n_threads)
+    {
+    #ifdef ENABLE_OPENMP
+    omp_set_num_threads(n_threads);
+    #endif
+    }
+
+//! Compares the kinetic energy summed in the update pass of TwoStepNPTMTK with the ComputeThermo path
+/*! Both systems start from the same anisotropic state. The thermostat compute of the first integrator works on the
+    integration group, so the kinetic energies are summed during step one, on several threads. The computes of the
+    second work on a separate group with the same members, so the thermostat falls back to ComputeThermo, on a
+    single thread. The trajectories, boxes and thermostat energies must agree to round-off.
+*/
+void npt_mtk_updater_thermo_compare(twostep_npt_mtk_creator npt_mtk_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_aniso_snapshot(6);
+
+    std::shared_ptr<IntegratorTwoStep> npt_mtk[2];
+    std::shared_ptr<TwoStepNPTMTK> two_step_npt_mtk[2];
+    std::shared_ptr<ParticleData> pdata[2];
+
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+        pdata[k] = sysdef->getParticleData();
+
+        PDataFlags flags;
+        flags[pdata_flag::pressure_tensor] = 1;
+        flags[pdata_flag::isotropic_virial] = 1;
+        flags[pdata_flag::rotational_kinetic_energy] = 1;
+        pdata[k]->setFlags(flags);
+
+        std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata[k]->getNGlobal()-1));
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+        std::shared_ptr<ParticleGroup> group_thermo = group_all;
+        if (k == 1)
+            group_thermo = std::shared_ptr<ParticleGroup>(new ParticleGroup(sysdef, selector_all));
+
+        std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.4)));
+        std::shared_ptr<AnisoPotentialPairGB> fc(new AnisoPotentialPairGB(sysdef, nlist));
+        fc->setRcut(0, 0, Scalar(2.5));
+        fc->setParams(0, 0, make_scalar3(1.0, 0.45, 0.5));
+
+        npt_mtk[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef, Scalar(0.002)));
+        npt_mtk[k]->addForceCompute(fc);
+
+        args_t args;
+        args.sysdef = sysdef;
+        args.group = group_all;
+        args.thermo_group = std::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_thermo, "name"));
+        args.thermo_group_t = std::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_thermo, "name_t"));
+        args.tau = Scalar(0.2);
+        args.tauP = Scalar(0.5);
+        args.T = Scalar(1.5);
+        args.P = Scalar(1.0);
+        args.mode = TwoStepNPTMTK::couple_none;
+        args.flags = TwoStepNPTMTK::baro_x | TwoStepNPTMTK::baro_y | TwoStepNPTMTK::baro_z;
+
+        two_step_npt_mtk[k] = npt_mtk_creator(args);
+        npt_mtk[k]->addIntegrationMethod(two_step_npt_mtk[k]);
+
+        unsigned int ndof = npt_mtk[k]->getNDOF(group_all);
+        unsigned int ndof_rot = npt_mtk[k]->getRotationalNDOF(group_all);
+        args.thermo_group->setNDOF(ndof);
+        args.thermo_group_t->setNDOF(ndof);
+        args.thermo_group->setRotationalNDOF(ndof_rot);
+        args.thermo_group_t->setRotationalNDOF(ndof_rot);
+
+        npt_mtk[k]->prepRun(0);
+        }
+
+    // use several threads even on a single core, so that the group is split between threads
+    int max_threads = 1;
+    #ifdef ENABLE_OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+    const int n_threads[2] = {std::max(max_threads, 4), 1};
+    for (unsigned int i = 0; i < 50; i++)
+        {
+        for (unsigned int k = 0; k < 2; k++)
+            {
+            set_num_threads(n_threads[k]);
+            npt_mtk[k]->update(i);
+            }
+
+        bool flag = false;
+        MY_CHECK_CLOSE(two_step_npt_mtk[0]->getLogValue("npt_thermostat_energy", i, flag),
+                       two_step_npt_mtk[1]->getLogValue("npt_thermostat_energy", i, flag), tol_small);
+        MY_CHECK_CLOSE(two_step_npt_mtk[0]->getLogValue("npt_barostat_energy", i, flag),
+                       two_step_npt_mtk[1]->getLogValue("npt_barostat_energy", i, flag), tol_small);
+        }
+    set_num_threads(max_threads);
+
+    Scalar3 L1 = pdata[0]->getBox().getL();
+    Scalar3 L2 = pdata[1]->getBox().getL();
+    MY_CHECK_SMALL(L1.x - L2.x, tol_small);
+    MY_CHECK_SMALL(L1.y - L2.y, tol_small);
+    MY_CHECK_SMALL(L1.z - L2.z, tol_small);
+
+    check_same_state(pdata[0], pdata[1], tol_small);
+    }
+
 //! IntegratorTwoStepNPTMTK factory for the unit tests
 std::shared_ptr<TwoStepNPTMTK> base_class_npt_mtk_creator(args_t args)
     {
@@ -869,6 +1041,14 @@ UP_TEST( TwoStepNPTMTK_cubic_NPH )
     nph_integration_test(npt_mtk_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for the kinetic energy summed in the update pass
+UP_TEST( TwoStepNPTMTK_thermo_compare )
+    {
+    twostep_npt_mtk_creator npt_mtk_creator = bind(base_class_npt_mtk_creator, _1);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    npt_mtk_updater_thermo_compare(npt_mtk_creator, exec_conf);
+    }
+
 #ifdef ENABLE_CUDA
 //! test case for GPU integration tests
 UP_TEST( TwoStepNPTMTKGPU_tests )
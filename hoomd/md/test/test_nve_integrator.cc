@@ -24,6 +24,11 @@
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
 #include "hoomd/deprecated/RandomGenerator.h"
+#include "hoomd/extern/saruprng.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 #include <math.h>
 
@@ -449,6 +454,180 @@ void nve_updater_aniso_test(std::shared_ptr<ExecutionConfiguration> exec_conf, t
         }
     }
 
+//! Build a jittered lattice of n x n x n randomly oriented and rotating particles
+std::shared_ptr< SnapshotSystemData<Scalar> > make_aniso_snapshot(unsigned int n)
+    {
+    const Scalar a = Scalar(1.3);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(a*n);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(n*n*n);
+
+    Saru saru(4, 2, 7);
+    for (unsigned int i = 0; i < n*n*n; i++)
+        {
+        vec3<Scalar> r(i % n, (i / n) % n, i / (n*n));
+        r += vec3<Scalar>(saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1));
+        snap->particle_data.pos[i] = a*(r - vec3<Scalar>(Scalar(n-1)/2, Scalar(n-1)/2, Scalar(n-1)/2));
+        snap->particle_data.vel[i] = vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1));
+
+        quat<Scalar> q(saru.s<Scalar>(-1,1), vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1)));
+        q = q*(Scalar(1.0)/sqrt(norm2(q)));
+        snap->particle_data.orientation[i] = q;
+
+        // angular momentum quaternion p = 2 q (0, L), with L in the body frame
+        vec3<Scalar> I(1.0, 0.8, 1.2);
+        vec3<Scalar> L(I.x*saru.s<Scalar>(-1,1), I.y*saru.s<Scalar>(-1,1), I.z*saru.s<Scalar>(-1,1));
+        snap->particle_data.inertia[i] = I;
+        snap->particle_data.angmom[i] = Scalar(2.0)*(q*L);
+        }
+    return snap;
+    }
+
+//! Checks that two systems have the same particle positions, velocities, orientations and angular momenta
+void check_same_state(std::shared_ptr<ParticleData> pdata1, std::shared_ptr<ParticleData> pdata2, Scalar tol)
+    {
+    ArrayHandle<Scalar4> h_pos1(pdata1->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel1(pdata1->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation1(pdata1->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom1(pdata1->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos2(pdata2->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel2(pdata2->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation2(pdata2->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom2(pdata2->getAngularMomentumArray(), access_location::host, access_mode::read);
+
+    for (unsigned int j = 0; j < pdata1->getN(); j++)
+        {
+        MY_CHECK_SMALL(h_pos1.data[j].x - h_pos2.data[j].x, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].y - h_pos2.data[j].y, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].z - h_pos2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_vel1.data[j].x - h_vel2.data[j].x, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].y - h_vel2.data[j].y, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].z - h_vel2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_orientation1.data[j].x - h_orientation2.data[j].x, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].y - h_orientation2.data[j].y, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].z - h_orientation2.data[j].z, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].w - h_orientation2.data[j].w, tol);
+
+        MY_CHECK_SMALL(h_angmom1.data[j].x - h_angmom2.data[j].x, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].y - h_angmom2.data[j].y, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].z - h_angmom2.data[j].z, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].w - h_angmom2.data[j].w, tol);
+        }
+    }
+
+//! Set the number of threads of the following parallel regions
+void set_num_threads(int n_threads)
+    {
+    #ifdef ENABLE_OPENMP
+    omp_set_num_threads(n_threads);
+    #endif
+    }
+
+//! Checks that the anisotropic NVE integration does not depend on the number of threads
+/*! Both systems start from the same anisotropic state, one is integrated on a single thread and the other on several
+    threads. Every particle is updated independently, so the trajectories must agree to round-off.
+*/
+void nve_updater_thread_test(twostepnve_creator nve_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_aniso_snapshot(6);
+
+    std::shared_ptr<IntegratorTwoStep> nve[2];
+    std::shared_ptr<ParticleData> pdata[2];
+
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+        pdata[k] = sysdef->getParticleData();
+        std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata[k]->getNGlobal()-1));
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+        std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.4)));
+        std::shared_ptr<AnisoPotentialPairGB> fc(new AnisoPotentialPairGB(sysdef, nlist));
+        fc->setRcut(0, 0, Scalar(2.5));
+        fc->setParams(0, 0, make_scalar3(1.0, 0.45, 0.5));
+
+        nve[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef, Scalar(0.002)));
+        nve[k]->addIntegrationMethod(nve_creator(sysdef, group_all));
+        nve[k]->addForceCompute(fc);
+        nve[k]->prepRun(0);
+        }
+
+    // use several threads even on a single core, so that the group is split between threads
+    int max_threads = 1;
+    #ifdef ENABLE_OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+    const int n_threads[2] = {std::max(max_threads, 4), 1};
+    for (unsigned int i = 0; i < 50; i++)
+        {
+        for (unsigned int k = 0; k < 2; k++)
+            {
+            set_num_threads(n_threads[k]);
+            nve[k]->update(i);
+            }
+        }
+    set_num_threads(max_threads);
+
+    check_same_state(pdata[0], pdata[1], tol_small);
+    }
+
+//! Checks that the structure-of-arrays particle data layout does not change the trajectory
+/*! One system uses the default layout and the other the SoA layout, in which TwoStepNVE and the LJ pair force read
+    and write the separate arrays while the Gay-Berne force still uses the AoS view.
+*/
+void nve_updater_soa_test(twostepnve_creator nve_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_aniso_snapshot(6);
+
+    std::shared_ptr<IntegratorTwoStep> nve[2];
+    std::shared_ptr<ParticleData> pdata[2];
+
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+        pdata[k] = sysdef->getParticleData();
+        pdata[k]->setSoALayout(k == 1);
+        std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata[k]->getNGlobal()-1));
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+        std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.4)));
+        std::shared_ptr<PotentialPairLJ> fc_lj(new PotentialPairLJ(sysdef, nlist));
+        fc_lj->setRcut(0, 0, Scalar(2.5));
+        fc_lj->setParams(0, 0, make_scalar2(Scalar(4.0)*Scalar(0.2), Scalar(4.0)*Scalar(0.2)));
+        std::shared_ptr<AnisoPotentialPairGB> fc_gb(new AnisoPotentialPairGB(sysdef, nlist));
+        fc_gb->setRcut(0, 0, Scalar(2.5));
+        fc_gb->setParams(0, 0, make_scalar3(1.0, 0.45, 0.5));
+
+        nve[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef, Scalar(0.002)));
+        nve[k]->addIntegrationMethod(nve_creator(sysdef, group_all));
+        nve[k]->addForceCompute(fc_lj);
+        nve[k]->addForceCompute(fc_gb);
+        nve[k]->prepRun(0);
+        }
+
+    for (unsigned int i = 0; i < 100; i++)
+        {
+        for (unsigned int k = 0; k < 2; k++)
+            nve[k]->update(i);
+        }
+
+    check_same_state(pdata[0], pdata[1], tol_small);
+
+    {
+    ArrayHandle<int3> h_image1(pdata[0]->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image2(pdata[1]->getImages(), access_location::host, access_mode::read);
+    for (unsigned int j = 0; j < pdata[0]->getN(); j++)
+        {
+        UP_ASSERT_EQUAL(h_image1.data[j].x, h_image2.data[j].x);
+        UP_ASSERT_EQUAL(h_image1.data[j].y, h_image2.data[j].y);
+        UP_ASSERT_EQUAL(h_image1.data[j].z, h_image2.data[j].z);
+        }
+    }
+    }
+
 //! TwoStepNVE factory for the unit tests
 std::shared_ptr<TwoStepNVE> base_class_nve_creator(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group)
     {
@@ -492,6 +671,20 @@ UP_TEST( TwoStepNVE_aniso_test )
     }
 
 //! Need work on NVEUpdaterGPU with rigid bodies to test these cases
+//! test case for the thread count invariance of the anisotropic integration
+UP_TEST( TwoStepNVE_thread_test )
+    {
+    nve_updater_thread_test(bind(base_class_nve_creator, _1, _2),
+                            std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for the structure-of-arrays particle data layout
+UP_TEST( TwoStepNVE_soa_test )
+    {
+    nve_updater_soa_test(bind(base_class_nve_creator, _1, _2),
+                         std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! test case for base class integration tests
 UP_TEST( TwoStepNVEGPU_integrate_tests )
@@ -21,6 +21,11 @@
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
 #include "hoomd/deprecated/RandomGenerator.h"
+#include "hoomd/extern/saruprng.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 #include <math.h>
 
@@ -413,6 +418,145 @@ void nvt_updater_compare_test(twostepnvt_creator nvt_creator1, twostepnvt_creato
         }
     }
 
+//! Build a jittered lattice of n x n x n randomly oriented and rotating particles
+std::shared_ptr< SnapshotSystemData<Scalar> > make_aniso_snapshot(unsigned int n)
+    {
+    const Scalar a = Scalar(1.3);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(a*n);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(n*n*n);
+
+    Saru saru(4, 2, 7);
+    for (unsigned int i = 0; i < n*n*n; i++)
+        {
+        vec3<Scalar> r(i % n, (i / n) % n, i / (n*n));
+        r += vec3<Scalar>(saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1), saru.s<Scalar>(-0.1,0.1));
+        snap->particle_data.pos[i] = a*(r - vec3<Scalar>(Scalar(n-1)/2, Scalar(n-1)/2, Scalar(n-1)/2));
+        snap->particle_data.vel[i] = vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1));
+
+        quat<Scalar> q(saru.s<Scalar>(-1,1), vec3<Scalar>(saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1), saru.s<Scalar>(-1,1)));
+        q = q*(Scalar(1.0)/sqrt(norm2(q)));
+        snap->particle_data.orientation[i] = q;
+
+        // angular momentum quaternion p = 2 q (0, L), with L in the body frame
+        vec3<Scalar> I(1.0, 0.8, 1.2);
+        vec3<Scalar> L(I.x*saru.s<Scalar>(-1,1), I.y*saru.s<Scalar>(-1,1), I.z*saru.s<Scalar>(-1,1));
+        snap->particle_data.inertia[i] = I;
+        snap->particle_data.angmom[i] = Scalar(2.0)*(q*L);
+        }
+    return snap;
+    }
+
+//! Checks that two systems have the same particle positions, velocities, orientations and angular momenta
+void check_same_state(std::shared_ptr<ParticleData> pdata1, std::shared_ptr<ParticleData> pdata2, Scalar tol)
+    {
+    ArrayHandle<Scalar4> h_pos1(pdata1->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel1(pdata1->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation1(pdata1->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom1(pdata1->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos2(pdata2->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel2(pdata2->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation2(pdata2->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom2(pdata2->getAngularMomentumArray(), access_location::host, access_mode::read);
+
+    for (unsigned int j = 0; j < pdata1->getN(); j++)
+        {
+        MY_CHECK_SMALL(h_pos1.data[j].x - h_pos2.data[j].x, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].y - h_pos2.data[j].y, tol);
+        MY_CHECK_SMALL(h_pos1.data[j].z - h_pos2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_vel1.data[j].x - h_vel2.data[j].x, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].y - h_vel2.data[j].y, tol);
+        MY_CHECK_SMALL(h_vel1.data[j].z - h_vel2.data[j].z, tol);
+
+        MY_CHECK_SMALL(h_orientation1.data[j].x - h_orientation2.data[j].x, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].y - h_orientation2.data[j].y, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].z - h_orientation2.data[j].z, tol);
+        MY_CHECK_SMALL(h_orientation1.data[j].w - h_orientation2.data[j].w, tol);
+
+        MY_CHECK_SMALL(h_angmom1.data[j].x - h_angmom2.data[j].x, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].y - h_angmom2.data[j].y, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].z - h_angmom2.data[j].z, tol);
+        MY_CHECK_SMALL(h_angmom1.data[j].w - h_angmom2.data[j].w, tol);
+        }
+    }
+
+//! Set the number of threads of the following parallel regions
+void set_num_threads(int n_threads)
+    {
+    #ifdef ENABLE_OPENMP
+    omp_set_num_threads(n_threads);
+    #endif
+    }
+
+//! Compares the kinetic energy summed in the update pass of TwoStepNVTMTK with the ComputeThermo path
+/*! Both systems start from the same anisotropic state. The thermo compute of the first integrator works on the
+    integration group, so the kinetic energies are summed during step one, on several threads. The thermo compute of
+    the second works on a separate group with the same members, so the thermostat falls back to ComputeThermo, on a
+    single thread. The trajectories and thermostat energies must agree to round-off.
+*/
+void nvt_updater_thermo_compare_test(twostepnvt_creator nvt_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_aniso_snapshot(6);
+
+    std::shared_ptr<IntegratorTwoStep> nvt[2];
+    std::shared_ptr<TwoStepNVTMTK> two_step_nvt[2];
+    std::shared_ptr<ParticleData> pdata[2];
+
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+        pdata[k] = sysdef->getParticleData();
+        std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata[k]->getNGlobal()-1));
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+        std::shared_ptr<ParticleGroup> group_thermo = group_all;
+        if (k == 1)
+            group_thermo = std::shared_ptr<ParticleGroup>(new ParticleGroup(sysdef, selector_all));
+
+        std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.4)));
+        std::shared_ptr<AnisoPotentialPairGB> fc(new AnisoPotentialPairGB(sysdef, nlist));
+        fc->setRcut(0, 0, Scalar(2.5));
+        fc->setParams(0, 0, make_scalar3(1.0, 0.45, 0.5));
+
+        nvt[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef, Scalar(0.002)));
+        std::shared_ptr<ComputeThermo> thermo(new ComputeThermo(sysdef, group_thermo));
+        two_step_nvt[k] = nvt_creator(sysdef, group_all, thermo, Scalar(0.2), Scalar(1.5));
+        nvt[k]->addIntegrationMethod(two_step_nvt[k]);
+        nvt[k]->addForceCompute(fc);
+
+        thermo->setNDOF(nvt[k]->getNDOF(group_all));
+        thermo->setRotationalNDOF(nvt[k]->getRotationalNDOF(group_all));
+        nvt[k]->prepRun(0);
+
+        PDataFlags flags;
+        flags[pdata_flag::rotational_kinetic_energy] = 1;
+        pdata[k]->setFlags(flags);
+        }
+
+    // use several threads even on a single core, so that the group is split between threads
+    int max_threads = 1;
+    #ifdef ENABLE_OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+    const int n_threads[2] = {std::max(max_threads, 4), 1};
+    for (unsigned int i = 0; i < 50; i++)
+        {
+        for (unsigned int k = 0; k < 2; k++)
+            {
+            set_num_threads(n_threads[k]);
+            nvt[k]->update(i);
+            }
+
+        bool flag = false;
+        MY_CHECK_CLOSE(two_step_nvt[0]->getLogValue("nvt_mtk_reservoir_energy", i, flag),
+                       two_step_nvt[1]->getLogValue("nvt_mtk_reservoir_energy", i, flag), tol_small);
+        }
+    set_num_threads(max_threads);
+
+    check_same_state(pdata[0], pdata[1], tol_small);
+    }
+
 //! Performs a basic equilibration test of TwoStepNVTMTK
 UP_TEST( TwoStepNVTMTK_basic_test )
     {
@@ -425,6 +569,13 @@ UP_TEST( TwoStepNVTMTK_basic_aniso_test )
     test_nvt_mtk_integrator_aniso(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),bind(base_class_nvt_creator, _1, _2, _3, _4, _5));
     }
 
+//! Compares the thermostat kinetic energies summed during step one with those from ComputeThermo
+UP_TEST( TwoStepNVTMTK_thermo_compare_test )
+    {
+    nvt_updater_thermo_compare_test(bind(base_class_nvt_creator, _1, _2, _3, _4, _5),
+                                    std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! Performs a basic equilibration test of TwoStepNVTMTKGPU
 UP_TEST( TwoStepNVTMTKGPU_basic_test )
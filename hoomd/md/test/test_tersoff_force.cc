@@ -0,0 +1,329 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/AllTripletPotentials.h"
+
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/extern/saruprng.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+#include <math.h>
+
+using namespace std;
+
+/*! \file test_tersoff_force.cc
+    \brief Implements unit tests for PotentialTripletTersoff
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Runs PotentialTripletTersoff on a fixed number of threads
+class TersoffThreadPinned : public PotentialTripletTersoff
+    {
+    public:
+        //! Constructs the potential, with the thread autotuner only offering \a n_threads
+        TersoffThreadPinned(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<NeighborList> nlist,
+                            unsigned int n_threads)
+            : PotentialTripletTersoff(sysdef, nlist)
+            {
+            m_thread_tuner.reset(new Autotuner(std::vector<unsigned int>(1, n_threads), 5, 100000,
+                                               "test_threads", m_exec_conf));
+            }
+    };
+
+//! Build a perturbed silicon diamond lattice with n x n x n conventional cells
+/*! With \a n_types > 1, the sites are assigned the types 0 .. n_types-1 in turn.
+*/
+std::shared_ptr<SystemDefinition> build_diamond(unsigned int n, std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                unsigned int n_types=1)
+    {
+    const Scalar a = Scalar(5.431);
+    const Scalar basis[8][3] = {{0,0,0}, {0,0.5,0.5}, {0.5,0,0.5}, {0.5,0.5,0},
+                                {0.25,0.25,0.25}, {0.25,0.75,0.75}, {0.75,0.25,0.75}, {0.75,0.75,0.25}};
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8*n*n*n, BoxDim(a*n), n_types, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    Saru saru(11, 21, 33);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    unsigned int idx = 0;
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+            for (unsigned int k = 0; k < n; k++)
+                for (unsigned int b = 0; b < 8; b++)
+                    {
+                    // displace the sites slightly so that the forces don't vanish by symmetry
+                    Scalar3 pos = make_scalar3((Scalar(i) + basis[b][0]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05),
+                                               (Scalar(j) + basis[b][1]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05),
+                                               (Scalar(k) + basis[b][2]) * a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.05,0.05));
+                    h_pos.data[idx].x = pos.x;
+                    h_pos.data[idx].y = pos.y;
+                    h_pos.data[idx].z = pos.z;
+                    h_pos.data[idx].w = __int_as_scalar(idx % n_types);
+                    idx++;
+                    }
+
+    return sysdef;
+    }
+
+//! Tersoff (1988) parameters for silicon
+tersoff_params make_silicon_params()
+    {
+    Scalar n = Scalar(0.78734);
+    Scalar beta = Scalar(1.1e-6);
+    Scalar c = Scalar(100390.0);
+    Scalar d = Scalar(16.217);
+    return make_tersoff_params(Scalar(0.3),
+                               make_scalar2(1830.8, 471.18),
+                               make_scalar2(2.4799, 1.7322),
+                               Scalar(0.0),
+                               n,
+                               pow(beta, n),
+                               Scalar(0.0),
+                               make_scalar3(c*c, d*d, -0.59825),
+                               Scalar(3.0));
+    }
+
+//! Reference implementation of the serial three-body loop, recomputing every separation on every visit
+/*! \param params Parameters per type pair, indexed by Index2D
+    \param rcutsq Squared cutoff per type pair, indexed by Index2D
+*/
+void compute_reference_forces(std::shared_ptr<SystemDefinition> sysdef,
+                              std::shared_ptr<NeighborList> nlist,
+                              const std::vector<tersoff_params>& params,
+                              const std::vector<Scalar>& rcutsq,
+                              std::vector<Scalar4>& force)
+    {
+    Index2D typpair_idx(sysdef->getParticleData()->getNTypes());
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(nlist->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    const BoxDim& box = pdata->getBox();
+
+    force.assign(pdata->getN(), make_scalar4(0,0,0,0));
+
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        const unsigned int head_i = h_head_list.data[i];
+        const unsigned int size = h_n_neigh.data[i];
+        for (unsigned int j = 0; j < size; j++)
+            {
+            unsigned int jj = h_nlist.data[head_i + j];
+            Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
+            Scalar3 dxij = box.minImage(posi - posj);
+            Scalar rij_sq = dot(dxij, dxij);
+
+            Scalar fR = 0.0;
+            Scalar fA = 0.0;
+            // the triplet terms use the parameters of the ij pair
+            unsigned int typpair = typpair_idx(__scalar_as_int(h_pos.data[i].w), __scalar_as_int(h_pos.data[jj].w));
+            EvaluatorTersoff eval(rij_sq, rcutsq[typpair], params[typpair]);
+            if (!eval.evalRepulsiveAndAttractive(fR, fA))
+                continue;
+
+            Scalar chi = 0.0;
+            for (unsigned int k = 0; k < size; k++)
+                {
+                unsigned int kk = h_nlist.data[head_i + k];
+                if (kk == jj)
+                    continue;
+                Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
+                Scalar3 dxik = box.minImage(posi - posk);
+                Scalar rik_sq = dot(dxik, dxik);
+                eval.setRik(rik_sq);
+                eval.setAngle(dot(dxij, dxik) / sqrt(rij_sq * rik_sq));
+                eval.evalChi(chi);
+                }
+
+            Scalar force_divr = Scalar(0.0);
+            Scalar potential_eng = Scalar(0.0);
+            Scalar bij = Scalar(0.0);
+            eval.evalForceij(fR, fA, chi, bij, force_divr, potential_eng);
+
+            Scalar3 fi = force_divr * dxij;
+            Scalar3 fj = Scalar(-1.0) * force_divr * dxij;
+            force[i].w += potential_eng * Scalar(0.5);
+            force[jj].w += potential_eng * Scalar(0.5);
+
+            for (unsigned int k = 0; k < size; k++)
+                {
+                unsigned int kk = h_nlist.data[head_i + k];
+                if (kk == jj)
+                    continue;
+                Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
+                Scalar3 dxik = box.minImage(posi - posk);
+                Scalar rik_sq = dot(dxik, dxik);
+                eval.setRik(rik_sq);
+                eval.setAngle(dot(dxij, dxik) / sqrt(rij_sq * rik_sq));
+
+                Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
+                Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
+                eval.evalForceik(fR, fA, chi, bij, force_divr_ij, force_divr_ik);
+
+                fi += force_divr_ij.x * dxij + force_divr_ik.x * dxik;
+                fj += force_divr_ij.y * dxij + force_divr_ik.y * dxik;
+                Scalar3 fk = force_divr_ij.z * dxij + force_divr_ik.z * dxik;
+                force[kk].x += fk.x;
+                force[kk].y += fk.y;
+                force[kk].z += fk.z;
+                }
+
+            force[i].x += fi.x;
+            force[i].y += fi.y;
+            force[i].z += fi.z;
+            force[jj].x += fj.x;
+            force[jj].y += fj.y;
+            force[jj].z += fj.z;
+            }
+        }
+    }
+
+//! Compares PotentialTripletTersoff against the reference loop on a diamond lattice
+UP_TEST( PotentialTripletTersoff_diamond )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_diamond(6, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.3)));
+    nlist->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<PotentialTripletTersoff> tersoff(new PotentialTripletTersoff(sysdef, nlist));
+    tersoff_params param = make_silicon_params();
+    tersoff->setRcut(0, 0, Scalar(3.0));
+    tersoff->setParams(0, 0, param);
+
+    tersoff->compute(0);
+
+    std::vector<Scalar4> ref_force;
+    compute_reference_forces(sysdef, nlist, std::vector<tersoff_params>(1, param), std::vector<Scalar>(1, Scalar(3.0*3.0)),
+                             ref_force);
+
+    ArrayHandle<Scalar4> h_force(tersoff->getForceArray(), access_location::host, access_mode::read);
+
+    Scalar3 total_force = make_scalar3(0,0,0);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        MY_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+        MY_CHECK_CLOSE(h_force.data[i].w, ref_force[i].w, tol_small);
+
+        total_force.x += h_force.data[i].x;
+        total_force.y += h_force.data[i].y;
+        total_force.z += h_force.data[i].z;
+        }
+
+    // momentum is conserved
+    MY_CHECK_SMALL(total_force.x, tol_small);
+    MY_CHECK_SMALL(total_force.y, tol_small);
+    MY_CHECK_SMALL(total_force.z, tol_small);
+    }
+
+//! Compares PotentialTripletTersoff against the reference loop with type pairs of different cutoffs
+/*! The cutoff function of a pair is cached with the parameters of that pair, while a triplet ijk evaluates it with the
+    parameters of ij. This checks that triplets with k of a different type than j do not use the cached value.
+*/
+UP_TEST( PotentialTripletTersoff_mixed_types )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_diamond(4, exec_conf, 2);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.3)));
+    nlist->setStorageMode(NeighborList::full);
+
+    Index2D typpair_idx(2);
+    std::vector<tersoff_params> params(typpair_idx.getNumElements(), make_silicon_params());
+    std::vector<Scalar> rcut(typpair_idx.getNumElements(), Scalar(3.0));
+
+    // the A-B and B-B pairs have shorter cutoffs and thicker cutoff shells
+    params[typpair_idx(0,1)].cutoff_thickness = params[typpair_idx(1,0)].cutoff_thickness = Scalar(0.5);
+    rcut[typpair_idx(0,1)] = rcut[typpair_idx(1,0)] = Scalar(2.8);
+    params[typpair_idx(1,1)].cutoff_thickness = Scalar(0.6);
+    params[typpair_idx(1,1)].alpha = Scalar(2.0);
+    rcut[typpair_idx(1,1)] = Scalar(2.9);
+
+    std::shared_ptr<PotentialTripletTersoff> tersoff(new PotentialTripletTersoff(sysdef, nlist));
+    std::vector<Scalar> rcutsq(typpair_idx.getNumElements());
+    for (unsigned int a = 0; a < 2; a++)
+        for (unsigned int b = 0; b < 2; b++)
+            {
+            tersoff->setRcut(a, b, rcut[typpair_idx(a,b)]);
+            tersoff->setParams(a, b, params[typpair_idx(a,b)]);
+            rcutsq[typpair_idx(a,b)] = rcut[typpair_idx(a,b)]*rcut[typpair_idx(a,b)];
+            }
+
+    tersoff->compute(0);
+
+    std::vector<Scalar4> ref_force;
+    compute_reference_forces(sysdef, nlist, params, rcutsq, ref_force);
+
+    ArrayHandle<Scalar4> h_force(tersoff->getForceArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        MY_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].w - ref_force[i].w, tol_small);
+        }
+    }
+
+#ifdef ENABLE_OPENMP
+//! Checks that the threaded forces agree with the single threaded ones
+UP_TEST( PotentialTripletTersoff_threads )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_diamond(4, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.3)));
+    nlist->setStorageMode(NeighborList::full);
+
+    // the thread counts are set through the autotuner, which would otherwise start its scan on one thread
+    std::shared_ptr<TersoffThreadPinned> serial(new TersoffThreadPinned(sysdef, nlist, 1));
+    serial->setRcut(0, 0, Scalar(3.0));
+    serial->setParams(0, 0, make_silicon_params());
+    serial->compute(0);
+    std::vector<Scalar4> serial_force;
+        {
+        ArrayHandle<Scalar4> h_force(serial->getForceArray(), access_location::host, access_mode::read);
+        serial_force.assign(h_force.data, h_force.data + pdata->getN());
+        }
+
+    // use several threads even on a single core, so that the per-thread force slices are summed
+    unsigned int n_threads = std::max(omp_get_max_threads(), 4);
+    std::shared_ptr<TersoffThreadPinned> tersoff(new TersoffThreadPinned(sysdef, nlist, n_threads));
+    tersoff->setRcut(0, 0, Scalar(3.0));
+    tersoff->setParams(0, 0, make_silicon_params());
+    tersoff->compute(0);
+    ArrayHandle<Scalar4> h_force(tersoff->getForceArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        MY_CHECK_SMALL(h_force.data[i].x - serial_force[i].x, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].y - serial_force[i].y, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].z - serial_force[i].z, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].w - serial_force[i].w, tol_small);
+        }
+    }
+#endif
@@ -3,6 +3,14 @@
 
 #include "EAMForceCompute.h"
 
+#ifdef ENABLE_MPI
+#include "hoomd/Communicator.h"
+#endif
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
 #include <vector>
 using namespace std;
 #include <stdexcept>
@@ -122,9 +130,9 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
     if (n != 1) throw runtime_error("Error parsing eam file");
 
     m_r_cut = tmp;
-    if (nrho < 1 || nr < 1 || nrho > MAX_POINT_NUMBER || nr > MAX_POINT_NUMBER)
+    if (nrho < 2 || nr < 2 || nrho > MAX_POINT_NUMBER || nr > MAX_POINT_NUMBER)
         {
-        m_exec_conf->msg->error() << "pair.eam: Invalid EAM file format: Point number is greater than " << MAX_POINT_NUMBER << endl;
+        m_exec_conf->msg->error() << "pair.eam: Invalid EAM file format: Point number must be between 2 and " << MAX_POINT_NUMBER << endl;
         throw runtime_error("Error loading file");
         }
     //Resize arrays for tables
@@ -150,6 +158,7 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
             embeddingFunction[types[type] * nrho + i] = (Scalar)tmp;
             }
         //Read Rho's arrays
+        //The table (a, b) holds the density that an atom of type a contributes at an atom of type b.
         //If FS we need read N arrays
         //If Alloy we ned read 1 array, and then duplicate N-1 times.
         unsigned int count = 1;
@@ -160,18 +169,17 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
             for(i = 0 ; i < nr; i++)
                 {
                 res = fscanf(fp, "%lg", &tmp);
-                electronDensity[types[type] * m_ntypes * nr + j * nr + i] = (Scalar)tmp;
+                electronDensity[types[type] * m_ntypes * nr + types[j] * nr + i] = (Scalar)tmp;
                 }
             }
 
-        for(j = 1; j <= m_ntypes - count; j++)
+        for(j = count; j < m_ntypes; j++)
             {
             for(i = 0 ; i < nr; i++)
                 {
-                electronDensity[types[type] * m_ntypes * nr + j * nr + i] = electronDensity[i];
+                electronDensity[types[type] * m_ntypes * nr + types[j] * nr + i] =
+                    electronDensity[types[type] * m_ntypes * nr + types[0] * nr + i];
                 }
-
-
             }
         }
 
@@ -188,7 +196,7 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
             for(i = 0 ; i < nr; i++)
                 {
                 res = fscanf(fp, "%lg", &tmp);
-                pairPotential[(unsigned int)ceil(0.5 *(2 * m_ntypes - types[k] -1) * types[k] + types[j]) * nr + i].x = (Scalar)tmp;
+                pairPotential[pairTableIndex(types[k], types[j]) * nr + i].x = (Scalar)tmp;
 
                 }
             }
@@ -228,17 +236,93 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
         {
         for(j = 0; j <= k; j++)
             {
-            for(i = 0 ; i < nr; i++)
+            unsigned int shift = pairTableIndex(types[k], types[j]) * nr;
+            for(i = 0 ; i < nr - 1; i++)
                 {
-                if((i + 1)%nr == 0) continue;
-                pairPotential[(unsigned int)ceil(0.5 *(2 * m_ntypes - types[k] -1) * types[k])  + types[j] * nr + i].y =
-                (pairPotential[(unsigned int)ceil(0.5 *(2 * m_ntypes - types[k] -1) * types[k]) + types[j] * nr + i + 1].x - pairPotential[(unsigned int)ceil(0.5 *(2 * m_ntypes - types[k] -1) * types[k]) + types[j] * nr + i].x) / dr;
-
+                pairPotential[shift + i].y = (pairPotential[shift + i + 1].x - pairPotential[shift + i].x) / dr;
                 }
             }
 
         }
 
+    computeSplines();
+    }
+
+/*! \param n_tables Number of tables
+    \param n_points Number of points per table, at least 2
+    \param dx Spacing of the points
+*/
+void EAMSpline::resize(unsigned int n_tables, unsigned int n_points, Scalar dx)
+    {
+    assert(n_points >= 2);
+    m_n_tables = n_tables;
+    m_n_points = n_points;
+    m_dx = dx;
+    m_rdx = Scalar(1.0) / dx;
+
+    m_c0.assign(n_tables * n_points, Scalar(0.0));
+    m_c1.assign(n_tables * n_points, Scalar(0.0));
+    m_c2.assign(n_tables * n_points, Scalar(0.0));
+    m_c3.assign(n_tables * n_points, Scalar(0.0));
+    }
+
+/*! \param table Index of the table
+    \param y Table values, m_n_points of them
+
+    The derivatives at the nodes are estimated with a five point stencil in the interior and with lower order
+    differences at the ends. Each segment is then the cubic Hermite polynomial matching the values and derivatives at
+    its two nodes. Coefficients are stored in units of the point spacing.
+*/
+void EAMSpline::setTable(unsigned int table, const Scalar *y)
+    {
+    assert(table < m_n_tables);
+    const unsigned int n = m_n_points;
+    const unsigned int offset = table * n;
+
+    // estimate the derivatives (per point spacing) at the nodes
+    std::vector<Scalar> d(n);
+    d[0] = y[1] - y[0];
+    d[n-1] = y[n-1] - y[n-2];
+    for (unsigned int m = 1; m < n - 1; m++)
+        {
+        if (m >= 2 && m + 2 < n)
+            d[m] = ((y[m-2] - y[m+2]) + Scalar(8.0) * (y[m+1] - y[m-1])) / Scalar(12.0);
+        else
+            d[m] = Scalar(0.5) * (y[m+1] - y[m-1]);
+        }
+
+    for (unsigned int m = 0; m < n - 1; m++)
+        {
+        Scalar dy = y[m+1] - y[m];
+        m_c0[offset + m] = y[m];
+        m_c1[offset + m] = d[m];
+        m_c2[offset + m] = Scalar(3.0) * dy - Scalar(2.0) * d[m] - d[m+1];
+        m_c3[offset + m] = d[m] + d[m+1] - Scalar(2.0) * dy;
+        }
+
+    // the last node is only reached through clamping, store the end value for completeness
+    m_c0[offset + n - 1] = y[n-1];
+    }
+
+void EAMForceCompute::computeSplines()
+    {
+    m_F_spline.resize(m_ntypes, nrho, drho);
+    for (unsigned int t = 0; t < m_ntypes; t++)
+        m_F_spline.setTable(t, &embeddingFunction[t * nrho]);
+
+    m_rho_spline.resize(m_ntypes * m_ntypes, nr, dr);
+    for (unsigned int t = 0; t < m_ntypes * m_ntypes; t++)
+        m_rho_spline.setTable(t, &electronDensity[t * nr]);
+
+    unsigned int n_pair_tables = m_ntypes * (m_ntypes + 1) / 2;
+    m_phi_spline.resize(n_pair_tables, nr, dr);
+    std::vector<Scalar> phi(nr);
+    for (unsigned int t = 0; t < n_pair_tables; t++)
+        {
+        for (unsigned int i = 0; i < nr; i++)
+            phi[i] = pairPotential[t * nr + i].x;
+        m_phi_spline.setTable(t, &phi.front());
+        }
     }
 std::vector< std::string > EAMForceCompute::getProvidedLogQuantities()
     {
@@ -261,10 +345,16 @@ Scalar EAMForceCompute::getLogValue(const std::string& quantity, unsigned int ti
         }
     }
 
-/*! \post The lennard jones forces are computed for the given timestep. The neighborlist's
+/*! \post The EAM forces are computed for the given timestep. The neighborlist's
      compute method is called to ensure that it is up to date.
 
     \param timestep specifies the current time step of the simulation
+
+    The first pass sums the electron density of every local particle and evaluates F(rho) and F'(rho). In MPI
+    simulations, F'(rho) of the ghost particles is then received from their owners, so that the second pass can
+    compute the pair forces without recomputing ghost densities. Tables are interpolated with cubic splines. When
+    running with several OpenMP threads and a half neighbor list, contributions to the neighbors of a particle are
+    accumulated in per-thread scratch arrays and summed after each pass.
 */
 void EAMForceCompute::computeForces(unsigned int timestep)
     {
@@ -274,11 +364,39 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // start the profile for this compute
     if (m_prof) m_prof->push("EAM pair");
 
-
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int N_total = N + m_pdata->getNGhosts();
+
+    unsigned int n_threads = 1;
+    #ifdef ENABLE_OPENMP
+    n_threads = omp_get_max_threads();
+    #endif
+
+    // with a half neighbor list, threads write to the neighbors of their particles and need private accumulators
+    const bool use_thread_scratch = third_law && n_threads > 1;
+
+    // resize the per-particle and scratch arrays if needed
+    if (m_rho.getNumElements() < N_total)
+        {
+        GPUArray<Scalar> rho(N_total, m_exec_conf);
+        m_rho.swap(rho);
+        GPUArray<Scalar> dFdrho(N_total, m_exec_conf);
+        m_dFdrho.swap(dFdrho);
+        }
+    if (use_thread_scratch && m_thread_force.getNumElements() < n_threads*N_total)
+        {
+        GPUArray<Scalar> thread_rho(n_threads*N_total, m_exec_conf);
+        m_thread_rho.swap(thread_rho);
+        GPUArray<Scalar4> thread_force(n_threads*N_total, m_exec_conf);
+        m_thread_force.swap(thread_force);
+        GPUArray<Scalar> thread_virial(6*n_threads*N_total, m_exec_conf);
+        m_thread_virial.swap(thread_virial);
+        }
+
     // access the neighbor list
     assert(m_nlist);
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
@@ -309,177 +427,268 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // tally up the number of forces calculated
     int64_t n_calc = 0;
 
+    const unsigned int ntypes = m_ntypes;
 
-    // for each particle
-    vector<Scalar> atomElectronDensity;
-    atomElectronDensity.resize(m_pdata->getN());
-    vector<Scalar> atomDerivativeEmbeddingFunction;
-    atomDerivativeEmbeddingFunction.resize(m_pdata->getN());
-    vector<Scalar> atomEmbeddingFunction;
-    atomEmbeddingFunction.resize(m_pdata->getN());
-    unsigned int ntypes = m_pdata->getNTypes();
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int head_i = h_head_list.data[i];
+        // first pass: electron densities and embedding energies
+        ArrayHandle<Scalar> h_rho(m_rho, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_dFdrho(m_dFdrho, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_thread_rho(m_thread_rho, access_location::host, access_mode::overwrite);
 
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
+        memset((void*)h_rho.data, 0, sizeof(Scalar)*N_total);
+        memset((void*)h_dFdrho.data, 0, sizeof(Scalar)*N_total);
+        if (use_thread_scratch)
+            memset((void*)h_thread_rho.data, 0, sizeof(Scalar)*n_threads*N_total);
 
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-
-        for (unsigned int j = 0; j < size; j++)
+        #pragma omp parallel
             {
-            // increment our calculation counter
-            n_calc++;
-
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
-
-            // calculate dr (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
-
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar
-            unsigned int typej = __scalar_as_int(h_pos.data[k].w);
-            // sanity check
-            assert(typej < m_pdata->getNTypes());
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // start computing the force
-            // calculate r squared (FLOPS: 5)
-            Scalar rsq = dot(dx, dx);;
-            // only compute the force if the particles are closer than the cuttoff (FLOPS: 1)
-            if (rsq < r_cut_sq)
+            unsigned int tid = 0;
+            #ifdef ENABLE_OPENMP
+            tid = omp_get_thread_num();
+            #endif
+
+            Scalar *rho = use_thread_scratch ? h_thread_rho.data + tid*N_total : h_rho.data;
+
+            #pragma omp for schedule(dynamic, 16) reduction(+:n_calc)
+            for (int i = 0; i < (int)N; i++)
                 {
-                 Scalar position_scalar = sqrt(rsq) * rdr;
-                 Scalar position = position_scalar;
-                 unsigned int r_index = (unsigned int)position;
-                 r_index = min(r_index,nr);
-                 position -= r_index;
-                 atomElectronDensity[i] += electronDensity[r_index + nr * (typei * ntypes + typej)] + derivativeElectronDensity[r_index + nr * (typei * ntypes + typej)] * position * dr;
-                 if(third_law)
+                // access the particle's position and type (MEM TRANSFER: 4 scalars)
+                Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+                unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+                const unsigned int head_i = h_head_list.data[i];
+
+                // sanity check
+                assert(typei < ntypes);
+
+                Scalar rhoi = Scalar(0.0);
+
+                // loop over all of the neighbors of this particle
+                const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                for (unsigned int j = 0; j < size; j++)
                     {
-                    atomElectronDensity[k] += electronDensity[r_index + nr * (typej * ntypes + typei)]
-                        + derivativeElectronDensity[r_index + nr * (typej * ntypes + typei)] * position * dr;
+                    // increment our calculation counter
+                    n_calc++;
+
+                    // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                    unsigned int k = h_nlist.data[head_i + j];
+                    // sanity check
+                    assert(k < N_total);
+
+                    // calculate dr (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                    Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
+                    Scalar3 dx = pi - pk;
+
+                    // access the type of the neighbor particle (MEM TRANSFER: 1 scalar
+                    unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+                    // sanity check
+                    assert(typej < ntypes);
+
+                    // apply periodic boundary conditions
+                    dx = box.minImage(dx);
+
+                    // only compute the density if the particles are closer than the cuttoff (FLOPS: 6)
+                    Scalar rsq = dot(dx, dx);
+                    if (rsq >= r_cut_sq) continue;
+
+                    Scalar r = sqrt(rsq);
+                    Scalar rho_r, drho_r;
+                    m_rho_spline.evaluate(typej * ntypes + typei, r, rho_r, drho_r);
+                    rhoi += rho_r;
+
+                    if (third_law && k < N)
+                        {
+                        if (typej != typei)
+                            m_rho_spline.evaluate(typei * ntypes + typej, r, rho_r, drho_r);
+                        rho[k] += rho_r;
+                        }
                     }
+                rho[i] += rhoi;
                 }
             }
-        }
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        // sum up the per-thread densities and evaluate the embedding function
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < (int)N; i++)
+            {
+            if (use_thread_scratch)
+                {
+                Scalar rhoi = Scalar(0.0);
+                for (unsigned int t = 0; t < n_threads; t++)
+                    rhoi += h_thread_rho.data[t*N_total + i];
+                h_rho.data[i] = rhoi;
+                }
 
-        Scalar position = atomElectronDensity[i] * rdrho;
-        unsigned int r_index = (unsigned int)position;
-        r_index = min(r_index,nrho);
-        position -= (Scalar)r_index;
-        atomDerivativeEmbeddingFunction[i] = derivativeEmbeddingFunction[r_index + typei * nrho];
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            Scalar F, dF;
+            m_F_spline.evaluate(typei, h_rho.data[i], F, dF);
+            h_dFdrho.data[i] = dF;
+            h_force.data[i].w += F;
+            }
+        }
 
-        h_force.data[i].w += embeddingFunction[r_index + typei * nrho] + derivativeEmbeddingFunction[r_index + typei * nrho] * position * drho;
+#ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        // the second pass needs F'(rho) of the ghost particles
+        if (m_prof) m_prof->push("ghost F'(rho)");
+        m_comm->updateGhostField(m_dFdrho);
+        if (m_prof) m_prof->pop();
         }
+#endif
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int head_i = h_head_list.data[i];
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
-
-        // initialize current particle force, potential energy, and virial to 0
-        Scalar fxi = 0.0;
-        Scalar fyi = 0.0;
-        Scalar fzi = 0.0;
-        Scalar pei = 0.0;
-        Scalar viriali[6];
-        for (int k = 0; k < 6; k++)
-            viriali[k] = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int j = 0; j < size; j++)
+        // second pass: forces
+        ArrayHandle<Scalar> h_dFdrho(m_dFdrho, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_thread_force(m_thread_force, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_thread_virial(m_thread_virial, access_location::host, access_mode::overwrite);
+
+        if (use_thread_scratch)
+            {
+            memset((void*)h_thread_force.data, 0, sizeof(Scalar4)*n_threads*N_total);
+            memset((void*)h_thread_virial.data, 0, sizeof(Scalar)*6*n_threads*N_total);
+            }
+
+        #pragma omp parallel
+            {
+            unsigned int tid = 0;
+            #ifdef ENABLE_OPENMP
+            tid = omp_get_thread_num();
+            #endif
+
+            // each thread accumulates into its own slice when writing to neighbors
+            Scalar4 *f = use_thread_scratch ? h_thread_force.data + tid*N_total : h_force.data;
+            Scalar *virial = use_thread_scratch ? h_thread_virial.data + 6*tid*N_total : h_virial.data;
+            const unsigned int pitch = use_thread_scratch ? N_total : virial_pitch;
+
+            #pragma omp for schedule(dynamic, 16) reduction(+:n_calc)
+            for (int i = 0; i < (int)N; i++)
+                {
+                // access the particle's position and type (MEM TRANSFER: 4 scalars)
+                Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+                unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+                const unsigned int head_i = h_head_list.data[i];
+                // sanity check
+                assert(typei < ntypes);
+
+                Scalar dFi = h_dFdrho.data[i];
+
+                // initialize current particle force, potential energy, and virial to 0
+                Scalar fxi = 0.0;
+                Scalar fyi = 0.0;
+                Scalar fzi = 0.0;
+                Scalar pei = 0.0;
+                Scalar viriali[6];
+                for (int c = 0; c < 6; c++)
+                    viriali[c] = 0.0;
+
+                // loop over all of the neighbors of this particle
+                const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                for (unsigned int j = 0; j < size; j++)
+                    {
+                    // increment our calculation counter
+                    n_calc++;
+
+                    // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                    unsigned int k = h_nlist.data[head_i + j];
+                    // sanity check
+                    assert(k < N_total);
+
+                    // calculate dr (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                    Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
+                    Scalar3 dx = pi - pk;
+
+                    // access the type of the neighbor particle (MEM TRANSFER: 1 scalar
+                    unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+                    // sanity check
+                    assert(typej < ntypes);
+
+                    // apply periodic boundary conditions
+                    dx = box.minImage(dx);
+
+                    // start computing the force
+                    // calculate r squared (FLOPS: 5)
+                    Scalar rsq = dot(dx, dx);
+
+                    if (rsq >= r_cut_sq) continue;
+                    Scalar r = sqrt(rsq);
+                    Scalar inverseR = Scalar(1.0) / r;
+
+                    // the table holds r*phi(r)
+                    Scalar z, dz;
+                    m_phi_spline.evaluate(pairTableIndex(typei, typej), r, z, dz);
+                    Scalar pair_eng = z * inverseR;
+                    Scalar derivativePhi = (dz - pair_eng) * inverseR;
+
+                    // derivatives of the density of j at i and of i at j
+                    Scalar rho_r, derivativeRhoJ, derivativeRhoI;
+                    m_rho_spline.evaluate(typej * ntypes + typei, r, rho_r, derivativeRhoJ);
+                    if (typej != typei)
+                        m_rho_spline.evaluate(typei * ntypes + typej, r, rho_r, derivativeRhoI);
+                    else
+                        derivativeRhoI = derivativeRhoJ;
+
+                    Scalar fullDerivativePhi = dFi * derivativeRhoJ + h_dFdrho.data[k] * derivativeRhoI + derivativePhi;
+                    Scalar pairForce = - fullDerivativePhi * inverseR;
+
+                    // the pair energy and virial are split evenly between i and k
+                    Scalar pairForce_div2 = Scalar(0.5) * pairForce;
+                    viriali[0] += dx.x*dx.x * pairForce_div2;
+                    viriali[1] += dx.x*dx.y * pairForce_div2;
+                    viriali[2] += dx.x*dx.z * pairForce_div2;
+                    viriali[3] += dx.y*dx.y * pairForce_div2;
+                    viriali[4] += dx.y*dx.z * pairForce_div2;
+                    viriali[5] += dx.z*dx.z * pairForce_div2;
+                    fxi += dx.x * pairForce;
+                    fyi += dx.y * pairForce;
+                    fzi += dx.z * pairForce;
+                    pei += Scalar(0.5) * pair_eng;
+
+                    if (third_law && k < N)
+                        {
+                        f[k].x -= dx.x * pairForce;
+                        f[k].y -= dx.y * pairForce;
+                        f[k].z -= dx.z * pairForce;
+                        f[k].w += Scalar(0.5) * pair_eng;
+                        virial[0*pitch+k] += dx.x*dx.x * pairForce_div2;
+                        virial[1*pitch+k] += dx.x*dx.y * pairForce_div2;
+                        virial[2*pitch+k] += dx.x*dx.z * pairForce_div2;
+                        virial[3*pitch+k] += dx.y*dx.y * pairForce_div2;
+                        virial[4*pitch+k] += dx.y*dx.z * pairForce_div2;
+                        virial[5*pitch+k] += dx.z*dx.z * pairForce_div2;
+                        }
+                    }
+                f[i].x += fxi;
+                f[i].y += fyi;
+                f[i].z += fzi;
+                f[i].w += pei;
+                for (int c = 0; c < 6; c++)
+                    virial[c*pitch+i] += viriali[c];
+                }
+            }
+
+        // sum up the per-thread forces
+        if (use_thread_scratch)
             {
-            // increment our calculation counter
-            n_calc++;
-
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
-
-            // calculate dr (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
-
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar
-            unsigned int typej = __scalar_as_int(h_pos.data[k].w);
-            // sanity check
-            assert(typej < m_pdata->getNTypes());
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // start computing the force
-            // calculate r squared (FLOPS: 5)
-            Scalar rsq = dot(dx, dx);
-
-            if (rsq >= r_cut_sq) continue;
-            Scalar r = sqrt(rsq);
-            Scalar inverseR = 1.0 / r;
-            Scalar position = r * rdr;
-            unsigned int r_index = (unsigned int)position;
-            position = position - (Scalar)r_index;
-            int shift = (typei>=typej)?(int)(0.5 * (2 * ntypes - typej -1)*typej + typei) * nr:(int)(0.5 * (2 * ntypes - typei -1)*typei + typej) * nr;
-            //r_index = min(r_index,nr - 1);
-            Scalar pair_eng = (pairPotential[r_index + shift].x +
-                pairPotential[r_index + shift].y * position * dr) * inverseR;
-            Scalar derivativePhi = (pairPotential[r_index + shift].y - pair_eng) * inverseR;
-            Scalar derivativeRhoI = derivativeElectronDensity[r_index + typei * nr];
-            Scalar derivativeRhoJ = derivativeElectronDensity[r_index + typej * nr];
-            Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ +
-                atomDerivativeEmbeddingFunction[k] * derivativeRhoI + derivativePhi;
-            Scalar pairForce = - fullDerivativePhi * inverseR;
-            // are the virial and potential energy correctly calculated
-            // with respect to double counting?
-            viriali[0] += dx.x*dx.x * pairForce;
-            viriali[1] += dx.x*dx.y * pairForce;
-            viriali[2] += dx.x*dx.z * pairForce;
-            viriali[3] += dx.y*dx.y * pairForce;
-            viriali[4] += dx.y*dx.z * pairForce;
-            viriali[5] += dx.z*dx.z * pairForce;
-            fxi += dx.x * pairForce;
-            fyi += dx.y * pairForce;
-            fzi += dx.z * pairForce;
-            pei += pair_eng;
-
-            if (third_law)
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < (int)N; i++)
                 {
-                h_force.data[k].x -= dx.x * pairForce;
-                h_force.data[k].y -= dx.y * pairForce;
-                h_force.data[k].z -= dx.z * pairForce;
+                for (unsigned int t = 0; t < n_threads; t++)
+                    {
+                    Scalar4 ft = h_thread_force.data[t*N_total + i];
+                    h_force.data[i].x += ft.x;
+                    h_force.data[i].y += ft.y;
+                    h_force.data[i].z += ft.z;
+                    h_force.data[i].w += ft.w;
+                    for (int c = 0; c < 6; c++)
+                        h_virial.data[c*virial_pitch+i] += h_thread_virial.data[(6*t+c)*N_total + i];
+                    }
                 }
             }
-        h_force.data[i].x += fxi;
-        h_force.data[i].y += fyi;
-        h_force.data[i].z += fzi;
-        h_force.data[i].w += pei;
-        for (int k = 0; k < 6; k++)
-            h_virial.data[k*virial_pitch+i] += viriali[k];
         }
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+9+6+8);
+    int64_t flops = N * 5 + n_calc * (3+5+9+1+9+6+8);
     if (third_law) flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
+    int64_t mem_transfer = N * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
     if (third_law) mem_transfer += n_calc*10*sizeof(Scalar);
     if (m_prof) m_prof->pop(flops, mem_transfer);
     }
@@ -5,6 +5,8 @@
 #include "hoomd/md/NeighborList.h"
 
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 /*! \file EAMForceCompute.h
     \brief Declares the EAMForceCompute class
@@ -19,6 +21,66 @@
 #ifndef __EAMFORCECOMPUTE_H__
 #define __EAMFORCECOMPUTE_H__
 
+//! Cubic spline interpolation of a set of uniformly tabulated functions
+/*! All tables share the number of points and the spacing. The coefficients of the interpolating polynomials are
+    stored as a structure of arrays: one array per polynomial coefficient, each holding the segments of all tables
+    one after the other. The derivative at every node is estimated from the neighboring table values, so that the
+    interpolant and its first derivative are continuous.
+
+    \ingroup computes
+*/
+class EAMSpline
+    {
+    public:
+        //! Constructs an empty spline
+        EAMSpline() : m_n_points(0), m_n_tables(0), m_dx(0), m_rdx(0)
+            {
+            }
+
+        //! Allocate storage for \a n_tables tables of \a n_points points with spacing \a dx
+        void resize(unsigned int n_tables, unsigned int n_points, Scalar dx);
+
+        //! Compute the coefficients of table \a table from the values \a y
+        void setTable(unsigned int table, const Scalar *y);
+
+        //! Evaluate a table and its derivative
+        /*! \param table Index of the table
+            \param x Argument (distance or density)
+            \param f Value at \a x (output)
+            \param df Derivative at \a x (output)
+
+            Arguments beyond the last point are clamped to the end of the table.
+        */
+        inline void evaluate(unsigned int table, Scalar x, Scalar& f, Scalar& df) const
+            {
+            Scalar p = x * m_rdx;
+            unsigned int m = (p > Scalar(0.0)) ? (unsigned int)p : 0;
+            if (m > m_n_points - 2)
+                {
+                m = m_n_points - 2;
+                p = Scalar(1.0);
+                }
+            else
+                {
+                p = (p > Scalar(0.0)) ? p - Scalar(m) : Scalar(0.0);
+                }
+            m += table * m_n_points;
+
+            f = ((m_c3[m]*p + m_c2[m])*p + m_c1[m])*p + m_c0[m];
+            df = ((Scalar(3.0)*m_c3[m]*p + Scalar(2.0)*m_c2[m])*p + m_c1[m]) * m_rdx;
+            }
+
+    private:
+        unsigned int m_n_points;            //!< Number of points per table
+        unsigned int m_n_tables;            //!< Number of tables
+        Scalar m_dx;                        //!< Spacing of the points
+        Scalar m_rdx;                       //!< Inverse spacing of the points
+        std::vector<Scalar> m_c0;           //!< Constant coefficient per segment
+        std::vector<Scalar> m_c1;           //!< Linear coefficient per segment
+        std::vector<Scalar> m_c2;           //!< Quadratic coefficient per segment
+        std::vector<Scalar> m_c3;           //!< Cubic coefficient per segment
+    };
+
 //! Computes Lennard-Jones forces on each particle
 /*! The total pair force is summed for each particle when compute() is called. Forces are only summed between
     neighboring particles with a separation distance less than \c r_cut. A NeighborList must be provided
@@ -31,6 +93,13 @@
     Forces can be computed directly by calling compute() and then retrieved with a call to acquire(), but
     a more typical usage will be to add the force compute to NVEUpdater or NVTUpdater.
 
+    The CPU implementation works in two passes over the neighbor list. The first pass accumulates the electron
+    density of every particle in m_rho and evaluates the derivative of the embedding function into m_dFdrho. The
+    second pass computes the forces, reading F'(rho) of both partners from m_dFdrho. Both passes are threaded with
+    OpenMP. With a half neighbor list, each thread accumulates its contributions to neighbors in its own slice of the
+    scratch arrays, which are summed at the end of the pass. In MPI simulations, the F'(rho) of ghost particles is
+    received from the ranks that own them.
+
     \ingroup computes
 */
 class EAMForceCompute : public ForceCompute
@@ -82,6 +151,27 @@ class EAMForceCompute : public ForceCompute
         std::vector<Scalar> derivativePairPotential;        //!< array Z'(r)
         std::vector<Scalar> derivativeEmbeddingFunction;    //!< array F'(rho)
 
+        EAMSpline m_rho_spline;                        //!< Spline of rho(r) per (contributing, receiving) type pair
+        EAMSpline m_phi_spline;                        //!< Spline of r*phi(r) per unordered type pair
+        EAMSpline m_F_spline;                          //!< Spline of F(rho) per type
+
+        GPUArray<Scalar> m_rho;                        //!< Electron density per particle
+        GPUArray<Scalar> m_dFdrho;                     //!< Derivative of the embedding function per particle
+        GPUArray<Scalar> m_thread_rho;                 //!< Per-thread density accumulators (half neighbor list)
+        GPUArray<Scalar4> m_thread_force;              //!< Per-thread force accumulators (half neighbor list)
+        GPUArray<Scalar> m_thread_virial;              //!< Per-thread virial accumulators (half neighbor list)
+
+        //! Index of the pair potential table of the type pair (\a a, \a b)
+        unsigned int pairTableIndex(unsigned int a, unsigned int b) const
+            {
+            if (a > b)
+                std::swap(a,b);
+            return (2 * m_ntypes - a - 1) * a / 2 + b;
+            }
+
+        //! Build the interpolation tables from the tabulated functions
+        void computeSplines();
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
@@ -47,6 +47,7 @@ EAMForceComputeGPU::EAMForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef,
 
     // allocate the coeff data on the GPU
     loadFile(filename, type_of_file);
+    eam_data.ntypes = m_ntypes;
     eam_data.nr = nr;
     eam_data.nrho = nrho;
     eam_data.dr = dr;
@@ -59,24 +60,33 @@ EAMForceComputeGPU::EAMForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef,
     cudaMalloc(&d_atomDerivativeEmbeddingFunction, m_pdata->getN() * sizeof(Scalar));
     cudaMemset(d_atomDerivativeEmbeddingFunction, 0, m_pdata->getN() * sizeof(Scalar));
 
+    // there is one density table per pair of types and one pair potential table per unordered pair of types
+    unsigned int n_density = m_ntypes * m_ntypes * nr;
+    unsigned int n_pair = m_ntypes * (m_ntypes + 1) / 2 * nr;
+    if (n_density > (unsigned int)m_exec_conf->dev_prop.maxTexture1D)
+        {
+        m_exec_conf->msg->error() << "pair.eam: The tables in the EAM file have too many points for the GPU" << endl;
+        throw std::runtime_error("Error initializing EAMForceComputeGPU");
+        }
+
     //Allocate mem on GPU for tables for EAM in cudaArray
     cudaChannelFormatDesc eam_desc = cudaCreateChannelDesc< Scalar >();
 
-    cudaMallocArray(&eam_tex_data.electronDensity, &eam_desc, m_ntypes * nr, 1);
-    cudaMemcpyToArray(eam_tex_data.electronDensity, 0, 0, &electronDensity[0], m_ntypes * nr * sizeof(Scalar), cudaMemcpyHostToDevice);
+    cudaMallocArray(&eam_tex_data.electronDensity, &eam_desc, n_density, 1);
+    cudaMemcpyToArray(eam_tex_data.electronDensity, 0, 0, &electronDensity[0], n_density * sizeof(Scalar), cudaMemcpyHostToDevice);
 
     cudaMallocArray(&eam_tex_data.embeddingFunction, &eam_desc, m_ntypes * nrho, 1);
     cudaMemcpyToArray(eam_tex_data.embeddingFunction, 0, 0, &embeddingFunction[0], m_ntypes * nrho * sizeof(Scalar), cudaMemcpyHostToDevice);
 
-    cudaMallocArray(&eam_tex_data.derivativeElectronDensity, &eam_desc, m_ntypes * nr, 1);
-    cudaMemcpyToArray(eam_tex_data.derivativeElectronDensity, 0, 0, &derivativeElectronDensity[0], m_ntypes * nr * sizeof(Scalar), cudaMemcpyHostToDevice);
+    cudaMallocArray(&eam_tex_data.derivativeElectronDensity, &eam_desc, n_density, 1);
+    cudaMemcpyToArray(eam_tex_data.derivativeElectronDensity, 0, 0, &derivativeElectronDensity[0], n_density * sizeof(Scalar), cudaMemcpyHostToDevice);
 
     cudaMallocArray(&eam_tex_data.derivativeEmbeddingFunction, &eam_desc, m_ntypes * nrho, 1);
     cudaMemcpyToArray(eam_tex_data.derivativeEmbeddingFunction, 0, 0, &derivativeEmbeddingFunction[0], m_ntypes * nrho * sizeof(Scalar), cudaMemcpyHostToDevice);
 
     eam_desc = cudaCreateChannelDesc< Scalar2 >();
-    cudaMallocArray(&eam_tex_data.pairPotential, &eam_desc,  ((m_ntypes * m_ntypes / 2) + 1) * nr, 1);
-    cudaMemcpyToArray(eam_tex_data.pairPotential, 0, 0, &pairPotential[0], ((m_ntypes * m_ntypes / 2) + 1) * nr *sizeof(Scalar2), cudaMemcpyHostToDevice);
+    cudaMallocArray(&eam_tex_data.pairPotential, &eam_desc, n_pair, 1);
+    cudaMemcpyToArray(eam_tex_data.pairPotential, 0, 0, &pairPotential[0], n_pair * sizeof(Scalar2), cudaMemcpyHostToDevice);
 
     CHECK_CUDA_ERROR();
     }
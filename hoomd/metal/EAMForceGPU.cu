@@ -137,7 +137,7 @@ __global__ void gpu_compute_eam_tex_inter_forces_kernel(
         if (rsq < eam_data_ti.r_cutsq)
             {
             Scalar position_scalar = sqrtf(rsq) * eam_data_ti.rdr;
-            atomElectronDensity += tex1D(electronDensity_tex, position_scalar + nr * (typei * ntypes + typej) + Scalar(0.5) ); //electronDensity[r_index + eam_data_ti.nr * typej] + derivativeElectronDensity[r_index + eam_data_ti.nr * typej] * position * eam_data_ti.dr;
+            atomElectronDensity += tex1D(electronDensity_tex, position_scalar + nr * (typej * ntypes + typei) + Scalar(0.5) ); //electronDensity[r_index + eam_data_ti.nr * typej] + derivativeElectronDensity[r_index + eam_data_ti.nr * typej] * position * eam_data_ti.dr;
             }
         }
 
@@ -245,9 +245,10 @@ __global__ void gpu_compute_eam_tex_inter_forces_kernel_2(
 
         Scalar derivativePhi = (pair_potential.y - pair_eng) * inverseR;
 
-        Scalar derivativeRhoI = tex1D(derivativeElectronDensity_tex, position + typei * eam_data_ti.nr + Scalar(0.5));
+        // table (a, b) holds the density that type a contributes at type b
+        Scalar derivativeRhoI = tex1D(derivativeElectronDensity_tex, position + nr * (typei * ntypes + typej) + Scalar(0.5));
 
-        Scalar derivativeRhoJ = tex1D(derivativeElectronDensity_tex, position + typej * eam_data_ti.nr + Scalar(0.5));
+        Scalar derivativeRhoJ = tex1D(derivativeElectronDensity_tex, position + nr * (typej * ntypes + typei) + Scalar(0.5));
 
         Scalar fullDerivativePhi = adef * derivativeRhoJ +
                 atomDerivativeEmbeddingFunction[cur_neigh] * derivativeRhoI + derivativePhi;
@@ -0,0 +1,183 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import _hoomd
+from hoomd import md
+from hoomd import metal
+context.initialize()
+import unittest
+import os
+import math
+import random
+import tempfile
+
+# EAM is only available in single precision builds
+single_precision = 'SINGLE' in _hoomd.hoomd_compile_flags()
+
+# tables of the test potential, see write_eam_file()
+r_cut = 2.0
+c_fs = [[1.0, 0.5], [1.5, 2.0]]
+c_alloy = [[1.0, 1.0], [2.0, 2.0]]
+k_pair = [[1.0, -0.5], [-0.5, 2.0]]
+F_embed = [(-1.0, 0.25), (-2.0, 0.5)]
+
+def write_eam_file(filename, fs):
+    R""" Write a two type EAM potential file
+
+    The density that type a contributes at type b is c_ab (2 - r), the pair potentials are r phi_ab(r) = k_ab (2 - r)
+    and the embedding functions are F_a(rho) = F_a0 rho + F_a1 rho^2. They are interpolated exactly by cubic splines
+    away from the ends of the tables.
+    """
+    nrho = 20001; drho = 0.001; nr = 201; dr = 0.01
+    c = c_fs if fs else c_alloy
+    with open(filename, 'w') as f:
+        f.write('test potential\nfor unit tests\nof pair.eam\n')
+        f.write('2 A B\n')
+        f.write('%d %g %d %g %g\n' % (nrho, drho, nr, dr, r_cut))
+        for a in range(2):
+            f.write('%d 1.0 1.0 fcc\n' % (a+1))
+            for i in range(nrho):
+                rho = i*drho
+                f.write('%.10g\n' % (F_embed[a][0]*rho + F_embed[a][1]*rho*rho))
+            for b in range(2 if fs else 1):
+                for i in range(nr):
+                    f.write('%.10g\n' % (c[a][b]*(r_cut - i*dr)))
+        for a in range(2):
+            for b in range(a+1):
+                for i in range(nr):
+                    f.write('%.10g\n' % (k_pair[a][b]*(r_cut - i*dr)))
+
+def reference(pos, typeid, L, fs):
+    R""" Compute the EAM energies and forces of all particles directly from the functions in write_eam_file()
+    """
+    c = c_fs if fs else c_alloy
+    N = len(pos)
+
+    def min_image(i, j):
+        dx = [pos[i][d] - pos[j][d] for d in range(3)]
+        return [dx[d] - L[d]*round(dx[d]/L[d]) for d in range(3)]
+
+    pairs = []
+    for i in range(N):
+        for j in range(N):
+            if i == j:
+                continue
+            dx = min_image(i, j)
+            r = math.sqrt(sum(x*x for x in dx))
+            if r < r_cut:
+                pairs.append((i, j, dx, r))
+
+    rho = [0.0]*N
+    for (i, j, dx, r) in pairs:
+        rho[i] += c[typeid[j]][typeid[i]]*(r_cut - r)
+
+    energy = [F_embed[typeid[i]][0]*rho[i] + F_embed[typeid[i]][1]*rho[i]**2 for i in range(N)]
+    dF = [F_embed[typeid[i]][0] + 2*F_embed[typeid[i]][1]*rho[i] for i in range(N)]
+    force = [[0.0]*3 for i in range(N)]
+    for (i, j, dx, r) in pairs:
+        k = k_pair[typeid[i]][typeid[j]]
+        energy[i] += 0.5*k*(r_cut - r)/r
+        dphi = -k*r_cut/(r*r)
+        dE = -dF[i]*c[typeid[j]][typeid[i]] - dF[j]*c[typeid[i]][typeid[j]] + dphi
+        for d in range(3):
+            force[i][d] -= dE*dx[d]/r
+
+    return energy, force
+
+# metal.pair.eam
+class pair_eam_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        tmp = tempfile.mkstemp(suffix='.eam')
+        os.close(tmp[0])
+        self.tmp_file = tmp[1]
+
+        # the GPU interpolates the tables linearly
+        self.tol = 1e-2 if context.exec_conf.isCUDAEnabled() else 1e-4
+
+    def run_eam(self, pos, typeid, L, fs):
+        snap = data.make_snapshot(N=len(pos), particle_types=['A','B'], box=data.boxdim(Lx=L[0], Ly=L[1], Lz=L[2]))
+        if comm.get_rank() == 0:
+            for i in range(len(pos)):
+                snap.particles.position[i] = pos[i]
+                snap.particles.typeid[i] = typeid[i]
+        self.s = init.read_snapshot(snap)
+
+        write_eam_file(self.tmp_file, fs)
+        nl = md.nlist.cell()
+        eam = metal.pair.eam(file=self.tmp_file, type='FS' if fs else 'Alloy', nlist=nl)
+        log = analyze.log(quantities=['pair_eam_energy'], period=1, filename=None)
+        md.integrate.mode_standard(dt=0.0)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        energy, force = reference(pos, typeid, L, fs)
+        for i in range(len(pos)):
+            p = self.s.particles[i]
+            self.assertAlmostEqual(p.net_energy, energy[i], delta=self.tol*max(1.0, abs(energy[i])))
+            for d in range(3):
+                self.assertAlmostEqual(p.net_force[d], force[i][d], delta=self.tol*max(1.0, abs(force[i][d])))
+        self.assertAlmostEqual(log.query('pair_eam_energy'), sum(energy), delta=self.tol*max(1.0, abs(sum(energy))))
+
+        del eam
+        del log
+        del nl
+
+    # three particles of two types, split across the domain boundary when running on two ranks
+    def check_particles(self, fs):
+        pos = [(-0.6, 0.0, 0.0), (0.6, 0.0, 0.0), (-0.6, 0.9, 0.3)]
+        self.run_eam(pos, [0, 1, 0], (12.0, 8.0, 8.0), fs)
+
+    @unittest.skipIf(not single_precision, 'EAM requires a single precision build')
+    def test_particles_fs(self):
+        if comm.get_num_ranks() > 1 and context.exec_conf.isCUDAEnabled():
+            return
+        self.check_particles(fs=True)
+
+    @unittest.skipIf(not single_precision, 'EAM requires a single precision build')
+    def test_particles_alloy(self):
+        if comm.get_num_ranks() > 1 and context.exec_conf.isCUDAEnabled():
+            return
+        self.check_particles(fs=False)
+
+    # perturbed lattice of two types, many of the neighbors are ghosts when running on two ranks
+    @unittest.skipIf(not single_precision, 'EAM requires a single precision build')
+    def test_lattice(self):
+        if comm.get_num_ranks() > 1 and context.exec_conf.isCUDAEnabled():
+            return
+        n = (8, 5, 5)
+        a = 1.5
+        L = (n[0]*a, n[1]*a, n[2]*a)
+        rng = random.Random(12345)
+        pos = []
+        typeid = []
+        for i in range(n[0]):
+            for j in range(n[1]):
+                for k in range(n[2]):
+                    pos.append(((i+0.5)*a - 0.5*L[0] + rng.uniform(-0.2, 0.2),
+                                (j+0.5)*a - 0.5*L[1] + rng.uniform(-0.2, 0.2),
+                                (k+0.5)*a - 0.5*L[2] + rng.uniform(-0.2, 0.2)))
+                    typeid.append(int(len(typeid) % 3 == 0))
+        self.run_eam(pos, typeid, L, fs=True)
+
+    # EAM is not available in multi-processor simulations on the GPU
+    @unittest.skipIf(not single_precision, 'EAM requires a single precision build')
+    def test_mpi_gpu(self):
+        if comm.get_num_ranks() == 1 or not context.exec_conf.isCUDAEnabled():
+            return
+        snap = data.make_snapshot(N=2, particle_types=['A','B'], box=data.boxdim(Lx=12, Ly=8, Lz=8))
+        self.s = init.read_snapshot(snap)
+        write_eam_file(self.tmp_file, True)
+        nl = md.nlist.cell()
+        self.assertRaises(RuntimeError, metal.pair.eam, file=self.tmp_file, type='FS', nlist=nl)
+        del nl
+
+    def tearDown(self):
+        os.remove(self.tmp_file)
+        if hasattr(self, 's'):
+            del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,336 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#include <functional>
+#include <memory>
+
+#include "hoomd/metal/EAMForceCompute.h"
+#ifdef ENABLE_CUDA
+#include "hoomd/metal/EAMForceComputeGPU.h"
+#endif
+
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/extern/saruprng.h"
+
+#include <math.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+/*! \file test_eam_force.cc
+    \brief Implements unit tests for EAMForceCompute and descendants
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Typedef'd EAMForceCompute factory
+typedef std::function<std::shared_ptr<EAMForceCompute> (std::shared_ptr<SystemDefinition> sysdef,
+                                                         std::shared_ptr<NeighborList> nlist,
+                                                         const std::string& filename,
+                                                         int type_of_file)> eamforce_creator;
+
+//! Write a two type EAM potential file with tables that are simple functions of r and rho
+/*! \param filename File to write
+    \param type_of_file 0 for Alloy, 1 for FS
+
+    With a cutoff of 2, the functions are:
+     - density that type a contributes at type b: c_ab (2 - r) with c_AA = 1, c_AB = 0.5, c_BA = 1.5, c_BB = 2 (FS),
+       or c_ab = c_a with c_A = 1 and c_B = 2 (Alloy)
+     - pair potentials r phi_ab(r) = k_ab (2 - r) with k_AA = 1, k_AB = -0.5, k_BB = 2
+     - embedding functions F_A(rho) = -rho + rho^2/4 and F_B(rho) = -2 rho + rho^2/2
+
+    All of them are interpolated exactly by cubic splines away from the ends of the tables, so forces and energies can
+    be computed by hand.
+*/
+void write_eam_file(const std::string& filename, int type_of_file)
+    {
+    const unsigned int nrho = 20001;
+    const Scalar drho = Scalar(0.001);
+    const unsigned int nr = 201;
+    const Scalar dr = Scalar(0.01);
+    const Scalar r_cut = Scalar(2.0);
+
+    const Scalar c[2][2] = {{1.0, 0.5}, {1.5, 2.0}};
+    const Scalar k[2][2] = {{1.0, -0.5}, {-0.5, 2.0}};
+    const Scalar F[2][2] = {{-1.0, 0.25}, {-2.0, 0.5}};
+
+    ofstream f(filename.c_str());
+    f.precision(10);
+    f << "test potential" << endl << "for unit tests" << endl << "of pair.eam" << endl;
+    f << "2 A B" << endl;
+    f << nrho << " " << drho << " " << nr << " " << dr << " " << r_cut << endl;
+    for (unsigned int a = 0; a < 2; a++)
+        {
+        f << a+1 << " 1.0 1.0 fcc" << endl;
+        for (unsigned int i = 0; i < nrho; i++)
+            {
+            Scalar rho = i*drho;
+            f << F[a][0]*rho + F[a][1]*rho*rho << endl;
+            }
+        unsigned int n_density = (type_of_file == 1) ? 2 : 1;
+        for (unsigned int b = 0; b < n_density; b++)
+            {
+            Scalar c_ab = (type_of_file == 1) ? c[a][b] : Scalar(a+1);
+            for (unsigned int i = 0; i < nr; i++)
+                f << c_ab*(r_cut - i*dr) << endl;
+            }
+        }
+    for (unsigned int a = 0; a < 2; a++)
+        for (unsigned int b = 0; b <= a; b++)
+            for (unsigned int i = 0; i < nr; i++)
+                f << k[a][b]*(r_cut - i*dr) << endl;
+    }
+
+//! Test the forces, energies and virials of three particles of two types against hand computed values
+void eam_force_particle_test(eamforce_creator eam_creator, std::shared_ptr<ExecutionConfiguration> exec_conf,
+    int type_of_file, bool half_nlist)
+    {
+    // A at the origin, B on the x axis and A in the y-z plane, all within the cutoff of each other
+    std::shared_ptr<SystemDefinition> sysdef_3(new SystemDefinition(3, BoxDim(20.0), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_3 = sysdef_3->getParticleData();
+    pdata_3->setFlags(~PDataFlags(0));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata_3->getPositions(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0] = make_scalar4(0.0, 0.0, 0.0, __int_as_scalar(0));
+    h_pos.data[1] = make_scalar4(1.2, 0.0, 0.0, __int_as_scalar(1));
+    h_pos.data[2] = make_scalar4(0.0, 0.9, 0.3, __int_as_scalar(0));
+    }
+
+    std::string filename = type_of_file == 1 ? "test_eam_force.eam.fs" : "test_eam_force.eam.alloy";
+    write_eam_file(filename, type_of_file);
+
+    std::shared_ptr<NeighborListTree> nlist_3(new NeighborListTree(sysdef_3, Scalar(2.0), Scalar(0.5)));
+    nlist_3->setStorageMode(half_nlist ? NeighborList::half : NeighborList::full);
+    std::shared_ptr<EAMForceCompute> fc_3 = eam_creator(sysdef_3, nlist_3, filename, type_of_file);
+    remove(filename.c_str());
+
+    fc_3->compute(0);
+
+    // reference values: E_i = F_i(rho_i) + 1/2 sum_j phi_ij(r_ij), and the virial is split evenly between i and j
+    const Scalar fs_ref[3][10] =
+        {{1.1883833815, -2.11201523666, -0.704005078888, -0.596784092108,
+          -0.713030028901, 0.0, 0.0, 0.950406856499, 0.3168022855, 0.105600761833},
+         {-2.20207508972, 0.760268781165, 0.253422927055, -1.31211513567,
+          -1.32124505383, 0.456161268699, 0.152053756233, -0.342120951524, -0.114040317175, -0.0380134390583},
+         {1.01369170822, 1.3517464555, 0.450582151833, -0.507975994571,
+          -0.608215024932, 0.456161268699, 0.152053756233, 0.608285904975, 0.202761968325, 0.067587322775}};
+    const Scalar alloy_ref[3][10] =
+        {{0.772833596573, -2.41329194663, -0.804430648876, -0.506520751718,
+          -0.463700157944, 0.0, 0.0, 1.08598137598, 0.361993791994, 0.120664597331},
+         {-1.6868534661, 0.685514902146, 0.228504967382, -1.97729157516,
+          -1.01211207966, 0.411308941288, 0.137102980429, -0.308481705966, -0.102827235322, -0.0342757451073},
+         {0.914019869529, 1.72777704448, 0.575925681493, -0.522751289559,
+          -0.548411921717, 0.411308941288, 0.137102980429, 0.777499670016, 0.259166556672, 0.086388852224}};
+    const Scalar (*ref)[10] = type_of_file == 1 ? fs_ref : alloy_ref;
+
+    {
+    GPUArray<Scalar4>& force_array_1 =  fc_3->getForceArray();
+    GPUArray<Scalar>& virial_array_1 =  fc_3->getVirialArray();
+    unsigned int pitch = virial_array_1.getPitch();
+    ArrayHandle<Scalar4> h_force_1(force_array_1,access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_1(virial_array_1,access_location::host,access_mode::read);
+
+    for (unsigned int i = 0; i < 3; i++)
+        {
+        MY_CHECK_CLOSE(h_force_1.data[i].x, ref[i][0], tol);
+        MY_CHECK_CLOSE(h_force_1.data[i].y, ref[i][1], tol);
+        MY_CHECK_CLOSE(h_force_1.data[i].z, ref[i][2], tol);
+        MY_CHECK_CLOSE(h_force_1.data[i].w, ref[i][3], tol);
+        for (unsigned int j = 0; j < 6; j++)
+            {
+            if (ref[i][4+j] == Scalar(0.0))
+                MY_CHECK_SMALL(h_virial_1.data[j*pitch+i], tol_small);
+            else
+                MY_CHECK_CLOSE(h_virial_1.data[j*pitch+i], ref[i][4+j], tol);
+            }
+        }
+    }
+    }
+
+//! Unit test a comparison between 2 EAMForceComputes on a perturbed lattice of two types
+void eam_force_comparison_test(eamforce_creator eam_creator1,
+                               eamforce_creator eam_creator2,
+                               std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int n = 8;
+    const Scalar a = Scalar(1.5);
+    const unsigned int N = n*n*n;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(a*n), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    Saru saru(12345);
+    unsigned int idx = 0;
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+            for (unsigned int k = 0; k < n; k++)
+                {
+                h_pos.data[idx] = make_scalar4((i + Scalar(0.5))*a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.2, 0.2),
+                                               (j + Scalar(0.5))*a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.2, 0.2),
+                                               (k + Scalar(0.5))*a - Scalar(0.5)*a*n + saru.s<Scalar>(-0.2, 0.2),
+                                               __int_as_scalar(idx % 3 == 0));
+                idx++;
+                }
+    }
+
+    write_eam_file("test_eam_force.eam.fs", 1);
+    std::shared_ptr<NeighborListTree> nlist1(new NeighborListTree(sysdef, Scalar(2.0), Scalar(0.5)));
+    std::shared_ptr<NeighborListTree> nlist2(new NeighborListTree(sysdef, Scalar(2.0), Scalar(0.5)));
+    std::shared_ptr<EAMForceCompute> fc1 = eam_creator1(sysdef, nlist1, "test_eam_force.eam.fs", 1);
+    std::shared_ptr<EAMForceCompute> fc2 = eam_creator2(sysdef, nlist2, "test_eam_force.eam.fs", 1);
+    remove("test_eam_force.eam.fs");
+
+    // compute the forces
+    fc1->compute(0);
+    fc2->compute(0);
+
+    {
+    // verify that the forces are identical (within roundoff errors)
+    GPUArray<Scalar4>& force_array_3 =  fc1->getForceArray();
+    GPUArray<Scalar>& virial_array_3 =  fc1->getVirialArray();
+    unsigned int pitch = virial_array_3.getPitch();
+    ArrayHandle<Scalar4> h_force_3(force_array_3,access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_3(virial_array_3,access_location::host,access_mode::read);
+    GPUArray<Scalar4>& force_array_4 =  fc2->getForceArray();
+    GPUArray<Scalar>& virial_array_4 =  fc2->getVirialArray();
+    ArrayHandle<Scalar4> h_force_4(force_array_4,access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_4(virial_array_4,access_location::host,access_mode::read);
+
+    // compare average deviation between the two computes
+    double deltaf2 = 0.0;
+    double deltape2 = 0.0;
+    double deltav2[6];
+    for (unsigned int j = 0; j < 6; j++)
+        deltav2[j] = 0.0;
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        deltaf2 += double(h_force_4.data[i].x - h_force_3.data[i].x) * double(h_force_4.data[i].x - h_force_3.data[i].x);
+        deltaf2 += double(h_force_4.data[i].y - h_force_3.data[i].y) * double(h_force_4.data[i].y - h_force_3.data[i].y);
+        deltaf2 += double(h_force_4.data[i].z - h_force_3.data[i].z) * double(h_force_4.data[i].z - h_force_3.data[i].z);
+        deltape2 += double(h_force_4.data[i].w - h_force_3.data[i].w) * double(h_force_4.data[i].w - h_force_3.data[i].w);
+        for (unsigned int j = 0; j < 6; j++)
+            deltav2[j] += double(h_virial_4.data[j*pitch+i] - h_virial_3.data[j*pitch+i]) * double(h_virial_4.data[j*pitch+i] - h_virial_3.data[j*pitch+i]);
+        }
+    deltaf2 /= double(pdata->getN());
+    deltape2 /= double(pdata->getN());
+    for (unsigned int j = 0; j < 6; j++)
+        deltav2[j] /= double(pdata->getN());
+    CHECK_SMALL(deltaf2, double(tol_small));
+    CHECK_SMALL(deltape2, double(tol_small));
+    CHECK_SMALL(deltav2[0], double(tol_small));
+    CHECK_SMALL(deltav2[1], double(tol_small));
+    CHECK_SMALL(deltav2[2], double(tol_small));
+    CHECK_SMALL(deltav2[3], double(tol_small));
+    CHECK_SMALL(deltav2[4], double(tol_small));
+    CHECK_SMALL(deltav2[5], double(tol_small));
+    }
+    }
+
+//! EAMForceCompute creator for unit tests
+std::shared_ptr<EAMForceCompute> base_class_eam_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                        std::shared_ptr<NeighborList> nlist,
+                                                        const std::string& filename,
+                                                        int type_of_file)
+    {
+    std::shared_ptr<EAMForceCompute> eam(new EAMForceCompute(sysdef, (char *)filename.c_str(), type_of_file));
+    eam->set_neighbor_list(nlist);
+    return eam;
+    }
+
+#ifdef ENABLE_CUDA
+//! EAMForceComputeGPU creator for unit tests
+std::shared_ptr<EAMForceCompute> gpu_eam_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                 std::shared_ptr<NeighborList> nlist,
+                                                 const std::string& filename,
+                                                 int type_of_file)
+    {
+    nlist->setStorageMode(NeighborList::full);
+    std::shared_ptr<EAMForceCompute> eam(new EAMForceComputeGPU(sysdef, (char *)filename.c_str(), type_of_file));
+    eam->set_neighbor_list(nlist);
+    return eam;
+    }
+#endif
+
+// EAM is only available in single precision builds
+#ifdef SINGLE_PRECISION
+
+//! test case for particle test on CPU with an FS file
+UP_TEST( EAMForce_particle_fs )
+    {
+    eamforce_creator eam_creator_base = bind(base_class_eam_creator, _1, _2, _3, _4);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    eam_force_particle_test(eam_creator_base, exec_conf, 1, false);
+    eam_force_particle_test(eam_creator_base, exec_conf, 1, true);
+    }
+
+//! test case for particle test on CPU with an Alloy file
+UP_TEST( EAMForce_particle_alloy )
+    {
+    eamforce_creator eam_creator_base = bind(base_class_eam_creator, _1, _2, _3, _4);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    eam_force_particle_test(eam_creator_base, exec_conf, 0, false);
+    eam_force_particle_test(eam_creator_base, exec_conf, 0, true);
+    }
+
+//! test case for comparing the half and full neighbor lists on the CPU
+UP_TEST( EAMForce_compare_half_full )
+    {
+    eamforce_creator eam_creator_base = bind(base_class_eam_creator, _1, _2, _3, _4);
+    eam_force_comparison_test(eam_creator_base,
+                              [](std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<NeighborList> nlist,
+                                 const std::string& filename, int type_of_file)
+                                {
+                                nlist->setStorageMode(NeighborList::full);
+                                return base_class_eam_creator(sysdef, nlist, filename, type_of_file);
+                                },
+                              std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+# ifdef ENABLE_CUDA
+//! test case for particle test on GPU with an FS file
+UP_TEST( EAMForceGPU_particle_fs )
+    {
+    eamforce_creator eam_creator_gpu = bind(gpu_eam_creator, _1, _2, _3, _4);
+    eam_force_particle_test(eam_creator_gpu,
+                            std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)),
+                            1, false);
+    }
+
+//! test case for particle test on GPU with an Alloy file
+UP_TEST( EAMForceGPU_particle_alloy )
+    {
+    eamforce_creator eam_creator_gpu = bind(gpu_eam_creator, _1, _2, _3, _4);
+    eam_force_particle_test(eam_creator_gpu,
+                            std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)),
+                            0, false);
+    }
+
+//! test case for comparing GPU output to base class output
+UP_TEST( EAMForceGPU_compare )
+    {
+    eamforce_creator eam_creator_gpu = bind(gpu_eam_creator, _1, _2, _3, _4);
+    eamforce_creator eam_creator_base = bind(base_class_eam_creator, _1, _2, _3, _4);
+    eam_force_comparison_test(eam_creator_base,
+                              eam_creator_gpu,
+                              std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+# endif
+
+#endif
@@ -6,6 +6,9 @@
 
 #include "HOOMDMath.h"
 #include "ExecutionConfiguration.h"
+#include "HostMemoryPool.h"
+#include "StepTimer.h"
+#include "TraceRecorder.h"
 #include "ClockSource.h"
 #include "Profiler.h"
 #include "ParticleData.h"
@@ -35,6 +38,7 @@
 #include "Integrator.h"
 #include "SFCPackUpdater.h"
 #include "BoxResizeUpdater.h"
+#include "DynamicGroupUpdater.h"
 #include "System.h"
 #include "Variant.h"
 #include "Messenger.h"
@@ -182,6 +186,18 @@ void mpi_barrier_world()
     #endif
     }
 
+//! Sum a value over all ranks of the MPI run
+double mpi_allreduce_sum_world(double value)
+    {
+    #ifdef ENABLE_MPI
+    double result;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return result;
+    #else
+    return value;
+    #endif
+    }
+
 //! Start the CUDA profiler
 void cuda_profile_start()
     {
@@ -303,6 +319,7 @@ PYBIND11_PLUGIN(_hoomd)
 
     m.def("abort_mpi", abort_mpi);
     m.def("mpi_barrier_world", mpi_barrier_world);
+    m.def("mpi_allreduce_sum_world", mpi_allreduce_sum_world);
     m.def("mpi_bcast_str", mpi_bcast_str);
 
     m.def("hoomd_compile_flags", &hoomd_compile_flags);
@@ -339,6 +356,9 @@ PYBIND11_PLUGIN(_hoomd)
     export_BoxDim(m);
     export_ParticleData(m);
     export_SnapshotParticleData(m);
+    export_HostMemoryPool(m);
+    export_StepTimer(m);
+    export_TraceRecorder(m);
     export_ExecutionConfiguration(m);
     export_SystemDefinition(m);
     export_SnapshotSystemData(m);
@@ -385,6 +405,7 @@ PYBIND11_PLUGIN(_hoomd)
     export_Integrator(m);
     export_BoxResizeUpdater(m);
     export_SFCPackUpdater(m);
+    export_DynamicGroupUpdater(m);
 #ifdef ENABLE_CUDA
     export_SFCPackUpdaterGPU(m);
 #endif
@@ -42,6 +42,8 @@ class options:
         self.onelevel = None;
         self.autotuner_enable = True;
         self.autotuner_period = 100000;
+        self.host_huge_pages = 'transparent';
+        self.host_max_cached = None;
 
     def __repr__(self):
         tmp = dict(mode=self.mode,
@@ -81,6 +83,7 @@ def _parse_command_line(arg_string=None):
     parser.add_option("--nz", dest="nz", help="(MPI) Number of domains along the z-direction");
     parser.add_option("--linear", dest="linear", action="store_true", default=False, help="(MPI only) Force a slab (1D) decomposition along the z-direction");
     parser.add_option("--onelevel", dest="onelevel", action="store_true", default=False, help="(MPI only) Disable two-level (node-local) decomposition");
+    parser.add_option("--host-huge-pages", dest="host_huge_pages", help="Huge pages for large host arrays (none, transparent, or hugetlb)");
     parser.add_option("--user", dest="user", help="User options");
 
     input_args = None;
@@ -102,6 +105,11 @@ def _parse_command_line(arg_string=None):
     if cmd_options.gpu is not None and cmd_options.mode == 'auto':
         cmd_options.mode = "gpu"
 
+    # check for valid huge page setting
+    if cmd_options.host_huge_pages is not None:
+        if not cmd_options.host_huge_pages in ('none', 'transparent', 'hugetlb'):
+            parser.error("--host-huge-pages must be either none, transparent, or hugetlb");
+
     # convert gpu to an integer
     if cmd_options.gpu is not None:
         try:
@@ -159,6 +167,9 @@ def _parse_command_line(arg_string=None):
     hoomd.context.options.linear = cmd_options.linear
     hoomd.context.options.onelevel = cmd_options.onelevel
 
+    if cmd_options.host_huge_pages is not None:
+        hoomd.context.options.host_huge_pages = cmd_options.host_huge_pages;
+
     if cmd_options.notice_level is not None:
         hoomd.context.options.notice_level = cmd_options.notice_level;
         hoomd.context.msg.setNoticeLevel(hoomd.context.options.notice_level);
@@ -251,6 +262,9 @@ def set_autotuner_params(enable=True, period=100000):
         enable (bool). Set to True to enable autotuning. Set to False to disable.
         period (int): Approximate period in time steps between retuning.
 
+    On the GPU, the autotuners choose kernel launch parameters. On the CPU, they choose the number of OpenMP
+    threads of the threaded force computes. The choices are printed at the end of each run.
+
     TODO: reference autotuner page here.
 
     """
@@ -259,6 +273,63 @@ def set_autotuner_params(enable=True, period=100000):
     hoomd.context.options.autotuner_period = period;
     hoomd.context.options.autotuner_enable = enable;
 
+def set_host_memory_params(huge_pages=None, max_cached=None):
+    R""" Set parameters of the host memory pool.
+
+    Args:
+        huge_pages (str): Use huge pages for large host arrays: 'none', 'transparent', or 'hugetlb'.
+        max_cached (int): Maximum number of bytes of freed host memory kept for reuse.
+
+    HOOMD allocates the host memory of all particle data arrays from a pool. Freed blocks are reused by later
+    allocations of about the same size, which avoids repeated allocation and copying when arrays are resized after
+    particle migration. Arrays of 2 MB and more are backed by huge pages to reduce TLB misses. By default,
+    ``huge_pages='transparent'`` requests transparent huge pages from the kernel. Use ``'hugetlb'`` to map explicit
+    huge pages that the administrator has reserved, and ``'none'`` to turn huge pages off. Huge pages are only
+    available on Linux.
+
+    The huge page setting applies to memory allocated after the call. Set it before initializing the system to
+    cover all particle data.
+
+    Use :py:func:`hoomd.util.get_host_memory_stats()` to monitor the pool.
+
+    Note:
+        Overrides ``--host-huge-pages`` on the command line.
+
+    Example::
+
+        option.set_host_memory_params(huge_pages='hugetlb')
+        option.set_host_memory_params(max_cached=1024**3)
+
+    """
+    _verify_init();
+
+    if huge_pages is not None:
+        if not huge_pages in ('none', 'transparent', 'hugetlb'):
+            hoomd.context.msg.error("huge_pages must be either none, transparent, or hugetlb\n");
+            raise RuntimeError('Error setting option');
+        hoomd.context.options.host_huge_pages = huge_pages;
+
+    if max_cached is not None:
+        if int(max_cached) < 0:
+            hoomd.context.msg.error("max_cached must not be negative\n");
+            raise RuntimeError('Error setting option');
+        hoomd.context.options.host_max_cached = int(max_cached);
+
+    if hoomd.context.exec_conf is not None:
+        _apply_host_memory_params(hoomd.context.exec_conf);
+
+## \internal
+# \brief Pass the host memory options to the memory pool of the given execution configuration
+def _apply_host_memory_params(exec_conf):
+    pool = exec_conf.getHostMemoryPool();
+    modes = dict(none=_hoomd.HostMemoryPool.hugePageMode.none,
+                 transparent=_hoomd.HostMemoryPool.hugePageMode.transparent,
+                 hugetlb=_hoomd.HostMemoryPool.hugePageMode.hugetlb);
+    pool.setHugePageMode(modes[hoomd.context.options.host_huge_pages]);
+
+    if hoomd.context.options.host_max_cached is not None:
+        pool.setMaxCachedBytes(hoomd.context.options.host_max_cached);
+
 ## \internal
 # \brief Throw an error if the context is not initialized
 def _verify_init():
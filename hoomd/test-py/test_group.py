@@ -203,6 +203,17 @@ class pair_group_tests (unittest.TestCase):
         tags = [(x.tag) for x in g]
         self.assertEqual(tags, [1,2,9])
 
+    def test_cuboid_dynamic(self):
+        g = group.cuboid(name='test', xmin=0.99)
+        update.dynamic_group(g, period=1)
+
+        # move one particle out and another in
+        self.s.particles[5].position = (-2,0,0);
+        self.s.particles[9].position = (1,-2,0);
+        run(1);
+        tags = [(x.tag) for x in g]
+        self.assertEqual(tags, [1,2,9])
+
     def test_type_update(self):
         B = group.type(type='B')
         tags = [(x.tag) for x in B]
@@ -22,8 +22,40 @@ class option_tests (unittest.TestCase):
 
         self.assertRaises(RuntimeError, option.set_notice_level, 'foo');
 
+    # tests that the host memory pool settings reach the pool
+    def test_host_memory_params(self):
+        pool = hoomd.context.exec_conf.getHostMemoryPool();
+
+        option.set_host_memory_params(huge_pages='none');
+        self.assertEqual(hoomd.context.options.host_huge_pages, 'none');
+        self.assertEqual(pool.getHugePageMode(), hoomd._hoomd.HostMemoryPool.hugePageMode.none);
+
+        option.set_host_memory_params(huge_pages='transparent', max_cached=1024**2);
+        self.assertEqual(pool.getHugePageMode(), hoomd._hoomd.HostMemoryPool.hugePageMode.transparent);
+        self.assertEqual(pool.getMaxCachedBytes(), 1024**2);
+
+        self.assertRaises(RuntimeError, option.set_host_memory_params, huge_pages='foo');
+        self.assertRaises(RuntimeError, option.set_host_memory_params, max_cached=-1);
+
+    # tests that the particle data is allocated from the pool
+    def test_host_memory_stats(self):
+        stats = util.get_host_memory_stats();
+
+        sys = init.create_lattice(lattice.sc(a=1.5), n=10);
+        new_stats = util.get_host_memory_stats();
+        self.assertGreater(new_stats['allocations'], stats['allocations']);
+        self.assertGreater(new_stats['bytes_in_use'], stats['bytes_in_use']);
+        self.assertGreaterEqual(new_stats['peak_bytes_in_use'], new_stats['bytes_in_use']);
+        self.assertLessEqual(new_stats['cache_hits'], new_stats['allocations']);
+
+        # a cache of size zero releases all freed memory
+        option.set_host_memory_params(max_cached=0);
+        self.assertEqual(util.get_host_memory_stats()['bytes_cached'], 0);
+        del sys;
+
     def tearDown(self):
-        pass;
+        option.set_host_memory_params(huge_pages='transparent', max_cached=256*1024**2);
+        context.initialize();
 
 
 if __name__ == '__main__':
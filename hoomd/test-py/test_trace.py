@@ -0,0 +1,66 @@
+# -*- coding: iso-8859-1 -*-
+
+import hoomd
+hoomd.context.initialize()
+import unittest
+import tempfile
+import json
+import os
+
+class trace_tests(unittest.TestCase):
+
+    def setUp(self):
+        hoomd.init.create_lattice(unitcell=hoomd.lattice.sq(a=2.0), n=[4,4]);
+
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.json');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+    # test that every step and every analyzer call is recorded
+    def test_steps(self):
+        hoomd.analyze.callback(callback=lambda step: None, period=2);
+
+        hoomd.util.start_trace(self.tmp_file);
+        hoomd.run(10);
+        hoomd.util.stop_trace();
+
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                trace = json.load(f);
+
+            events = [e for e in trace['traceEvents'] if e['pid'] == 0 and e['ph'] in ('B', 'E')];
+            steps = [e['args']['timestep'] for e in events if e.get('name') == 'step'];
+            self.assertEqual(steps, list(range(10)));
+            self.assertEqual(len([e for e in events if e.get('name') == 'CallbackAnalyzer']), 5);
+
+            # begin and end events must match and time must not run backwards
+            depth = 0;
+            for i,e in enumerate(events):
+                depth += 1 if e['ph'] == 'B' else -1;
+                self.assertGreaterEqual(depth, 0);
+                if i > 0:
+                    self.assertGreaterEqual(e['ts'], events[i-1]['ts']);
+            self.assertEqual(depth, 0);
+
+    # test that the event limit drops whole regions
+    def test_max_events(self):
+        hoomd.util.start_trace(self.tmp_file, max_events=5);
+        hoomd.run(10);
+        hoomd.util.stop_trace();
+
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                trace = json.load(f);
+
+            events = [e for e in trace['traceEvents'] if e['pid'] == 0 and e['ph'] in ('B', 'E')];
+            self.assertEqual(len([e for e in events if e['ph'] == 'B']), len([e for e in events if e['ph'] == 'E']));
+
+    def tearDown(self):
+        hoomd.context.initialize();
+        if hoomd.comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
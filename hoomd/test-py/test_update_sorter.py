@@ -19,6 +19,19 @@ class update_sorter_tests (unittest.TestCase):
 
         context.current.sorter.set_params(grid=20);
 
+    # test the adaptive sort
+    def test_max_disorder(self):
+        context.current.sorter.set_params(max_disorder=0.2);
+        run(10);
+        self.assertRaises(ValueError, context.current.sorter.set_params, max_disorder=2.0);
+
+    # the disorder is small right after a sort
+    def test_get_disorder(self):
+        context.current.sorter.set_params(max_disorder=0.0);
+        context.current.sorter.set_period(1);
+        run(1);
+        self.assertLess(context.current.sorter.get_disorder(), 0.1);
+
     def tearDown(self):
         context.initialize();
 
@@ -0,0 +1,108 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+
+#include "hoomd/Autotuner.h"
+
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+using namespace std;
+
+/*! \file test_autotuner.cc
+    \brief Implements unit tests for Autotuner on the CPU
+    \ingroup unit_tests
+*/
+
+//! Wait for the given number of microseconds without yielding the CPU
+static void busy_wait(unsigned int usec)
+    {
+    ClockSource clk;
+    while (clk.getTime() < int64_t(usec)*int64_t(1000))
+        {
+        }
+    }
+
+//! Time a synthetic workload with the autotuner
+/*! \param tuner Autotuner to drive
+    \param fast Parameter that runs fastest
+*/
+static void tuned_call(Autotuner& tuner, unsigned int fast)
+    {
+    tuner.begin();
+    busy_wait(tuner.getParam() == fast ? 200 : 1000);
+    tuner.end();
+    }
+
+//! The autotuner picks the fastest parameter on the CPU
+UP_TEST( autotuner_cpu_choose )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    vector<unsigned int> params;
+    params.push_back(1);
+    params.push_back(2);
+    params.push_back(3);
+    Autotuner tuner(params, 3, 1000, "test", exec_conf);
+
+    // the initial scan takes nsamples calls per parameter
+    for (unsigned int i = 0; i < 3*3; i++)
+        {
+        UP_ASSERT(!tuner.isComplete());
+        tuned_call(tuner, 2);
+        }
+
+    UP_ASSERT(tuner.isComplete());
+    UP_ASSERT_EQUAL(tuner.getParam(), (unsigned int)2);
+    tuner.printStats();
+    }
+
+//! The autotuner follows a change of the fastest parameter in periodic scans
+UP_TEST( autotuner_cpu_retune )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    Autotuner tuner(1, 3, 1, 3, 2, "test", exec_conf);
+
+    while (!tuner.isComplete())
+        tuned_call(tuner, 1);
+    UP_ASSERT_EQUAL(tuner.getParam(), (unsigned int)1);
+
+    // every scan replaces one sample per parameter, the median changes after two scans
+    for (unsigned int i = 0; i < 30; i++)
+        tuned_call(tuner, 3);
+    UP_ASSERT_EQUAL(tuner.getParam(), (unsigned int)3);
+
+    // a disabled autotuner keeps its choice
+    tuner.setEnabled(false);
+    for (unsigned int i = 0; i < 30; i++)
+        tuned_call(tuner, 2);
+    UP_ASSERT_EQUAL(tuner.getParam(), (unsigned int)3);
+    }
+
+//! The thread counts start at one and end at the maximum
+UP_TEST( autotuner_thread_counts )
+    {
+    vector<unsigned int> counts = Autotuner::getThreadCounts();
+    UP_ASSERT(counts.size() > 0);
+    UP_ASSERT_EQUAL(counts[0], (unsigned int)1);
+    for (unsigned int i = 1; i < counts.size(); i++)
+        UP_ASSERT(counts[i] > counts[i-1]);
+
+    #ifdef ENABLE_OPENMP
+    UP_ASSERT_EQUAL(counts.back(), (unsigned int)omp_get_max_threads());
+    #else
+    UP_ASSERT_EQUAL(counts.size(), (size_t)1);
+    #endif
+    }
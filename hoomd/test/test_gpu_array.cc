@@ -89,6 +89,106 @@ UP_TEST( GPUArray_basic_tests )
 
     }
 
+//! test case for checking the alignment of host allocations
+UP_TEST( GPUArray_alignment_tests )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // 1D arrays must be cache line aligned, also after resizing
+    GPUArray<Scalar4> a(13, exec_conf);
+        {
+        ArrayHandle<Scalar4> h_handle(a, access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL((size_t)h_handle.data % GPUARRAY_HOST_ALIGNMENT, (size_t)0);
+        }
+
+    a.resize(1001);
+        {
+        ArrayHandle<Scalar4> h_handle(a, access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL((size_t)h_handle.data % GPUARRAY_HOST_ALIGNMENT, (size_t)0);
+        }
+
+    // every row of a 2D array must start on a cache line
+    GPUArray<float> b(3, 6, exec_conf);
+    b.resize(37, 7);
+        {
+        ArrayHandle<float> h_handle(b, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < 7; i++)
+            UP_ASSERT_EQUAL((size_t)(h_handle.data + i*b.getPitch()) % GPUARRAY_HOST_ALIGNMENT, (size_t)0);
+        }
+    }
+
+//! test case for checking that host memory is recycled through the pool of the execution configuration
+UP_TEST( GPUArray_pool_tests )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    HostMemoryPool& pool = exec_conf->getHostMemoryPool();
+
+    unsigned long long n_system = pool.getNumSystemAllocations();
+    void *first = NULL;
+        {
+        GPUArray<Scalar4> a(1000, exec_conf);
+        ArrayHandle<Scalar4> h_handle(a, access_location::host, access_mode::read);
+        first = h_handle.data;
+        UP_ASSERT(pool.getBytesInUse() >= 1000*sizeof(Scalar4));
+        }
+
+    // the freed block is cached and handed out again for an array of the same size
+    UP_ASSERT(pool.getBytesCached() >= 1000*sizeof(Scalar4));
+    unsigned long long n_hits = pool.getNumCacheHits();
+        {
+        GPUArray<Scalar4> b(1000, exec_conf);
+        ArrayHandle<Scalar4> h_handle(b, access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL((void *)h_handle.data, first);
+
+        // the recycled block must be cleared
+        for (unsigned int i = 0; i < 1000; i++)
+            UP_ASSERT_EQUAL(h_handle.data[i].x, Scalar(0.0));
+        }
+    UP_ASSERT_EQUAL(pool.getNumCacheHits(), n_hits+1);
+    UP_ASSERT_EQUAL(pool.getNumSystemAllocations(), n_system+1);
+
+    // resizing back and forth recycles the blocks
+    GPUVector<unsigned int> v(exec_conf);
+    for (unsigned int i = 0; i < 10; i++)
+        {
+        v.resize(100000);
+        v.resize(10);
+        GPUArray<unsigned int> c(100000, exec_conf);
+        }
+    UP_ASSERT(pool.getNumCacheHits() > n_hits+1);
+
+    // a cache of size zero releases all blocks
+    pool.setMaxCachedBytes(0);
+    UP_ASSERT_EQUAL(pool.getBytesCached(), (size_t)0);
+
+    // pointers that the pool did not hand out, or that were already returned, are rejected
+    void *foreign = malloc(64);
+    bool except = false;
+    try
+        {
+        pool.deallocate(foreign);
+        }
+    catch (std::runtime_error)
+        {
+        except = true;
+        }
+    UP_ASSERT(except);
+    free(foreign);
+
+    void *block = pool.allocate(64);
+    pool.deallocate(block);
+    except = false;
+    try
+        {
+        pool.deallocate(block);
+        }
+    catch (std::runtime_error)
+        {
+        except = true;
+        }
+    UP_ASSERT(except);
+    }
+
 #ifdef ENABLE_CUDA
 //! test case for testing device to/from host transfers
 UP_TEST( GPUArray_transfer_tests )
@@ -12,6 +12,7 @@
 
 
 #include <iostream>
+#include <algorithm>
 
 #include "hoomd/ParticleData.h"
 #include "hoomd/Initializers.h"
@@ -223,6 +224,93 @@ UP_TEST( ParticleGroup_sort_test )
     }
     }
 
+//! Checks that ParticleGroup patches its index list after a known rearrangement of the particles
+UP_TEST( ParticleGroup_reorder_test )
+    {
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef();
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    unsigned int N = pdata->getN();
+
+    std::shared_ptr<ParticleSelector> selector_type(new ParticleSelectorType(sysdef, 0, 0));
+    std::shared_ptr<ParticleSelector> selector_cuboid(new ParticleSelectorCuboid(sysdef,
+                                                                      make_scalar3(-5.5, -5.5, -5.5),
+                                                                      make_scalar3( 0.5,  0.5,  0.5)));
+    ParticleGroup type0(sysdef, selector_type);
+    ParticleGroup cuboid(sysdef, selector_cuboid);
+    CHECK_EQUAL_UINT(type0.getNumMembers(), 4);
+    CHECK_EQUAL_UINT(cuboid.getNumMembers(), 5);
+
+    // move the particles to a shuffled order
+    const unsigned int order[] = {3, 7, 0, 9, 5, 1, 8, 2, 6, 4};
+    std::vector<unsigned int> new_idx(N);
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+    std::vector<Scalar4> pos(h_pos.data, h_pos.data + N);
+    std::vector<unsigned int> tag(h_tag.data, h_tag.data + N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_pos.data[i] = pos[order[i]];
+        h_tag.data[i] = tag[order[i]];
+        h_rtag.data[h_tag.data[i]] = i;
+        new_idx[order[i]] = i;
+        }
+    }
+
+    pdata->notifyParticleReorder(&new_idx[0], N, N);
+
+    // the patched groups must match groups built from scratch
+    ParticleGroup type0_new(sysdef, selector_type);
+    ParticleGroup cuboid_new(sysdef, selector_cuboid);
+    CHECK_EQUAL_UINT(type0.getNumMembers(), type0_new.getNumMembers());
+    CHECK_EQUAL_UINT(cuboid.getNumMembers(), cuboid_new.getNumMembers());
+    for (unsigned int i = 0; i < type0.getNumMembers(); i++)
+        CHECK_EQUAL_UINT(type0.getMemberIndex(i), type0_new.getMemberIndex(i));
+    for (unsigned int i = 0; i < cuboid.getNumMembers(); i++)
+        CHECK_EQUAL_UINT(cuboid.getMemberIndex(i), cuboid_new.getMemberIndex(i));
+    for (unsigned int i = 0; i < N; i++)
+        {
+        UP_ASSERT_EQUAL(type0.isMember(i), type0_new.isMember(i));
+        UP_ASSERT_EQUAL(cuboid.isMember(i), cuboid_new.isMember(i));
+        }
+    }
+
+//! Checks that the bulk selection matches the per particle selection criteria
+UP_TEST( ParticleSelector_selected_tags_test )
+    {
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef();
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::vector< std::shared_ptr<ParticleSelector> > selectors;
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorAll(sysdef)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorTag(sysdef, 2, 6)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorType(sysdef, 1, 2)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorRigid(sysdef, true)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorRigid(sysdef, false)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorRigidCenter(sysdef)));
+    selectors.push_back(std::shared_ptr<ParticleSelector>(new ParticleSelectorCuboid(sysdef,
+                                                                      make_scalar3(-1.5, -2.5, -3.5),
+                                                                      make_scalar3( 5.5,  5.5,  5.5))));
+
+    for (unsigned int s = 0; s < selectors.size(); s++)
+        {
+        std::vector<unsigned int> selected;
+        selectors[s]->getSelectedTags(selected);
+
+        std::vector<unsigned int> expected;
+        for (unsigned int tag = 0; tag < pdata->getN(); tag++)
+            if (selectors[s]->isSelected(tag))
+                expected.push_back(tag);
+
+        std::sort(selected.begin(), selected.end());
+        UP_ASSERT_EQUAL(selected.size(), expected.size());
+        for (unsigned int i = 0; i < expected.size(); i++)
+            CHECK_EQUAL_UINT(selected[i], expected[i]);
+        }
+    }
+
 //! Checks that ParticleGroup can initialize by particle type
 UP_TEST( ParticleGroup_type_test )
     {
@@ -617,6 +617,108 @@ UP_TEST( ParticleData_test )
     UP_ASSERT(pdata_type_test.getTypeByName("test") == 1);
     }
 
+//! Checks that the structure-of-arrays layout stays consistent with the AoS arrays
+UP_TEST( ParticleData_soa_test )
+    {
+    BoxDim box(20.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    const unsigned int N = 100;
+    ParticleData pdata(N, box, 3, exec_conf);
+
+    Scalar tol = Scalar(1e-6);
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata.getVelocities(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_pos.data[i] = make_scalar4(Scalar(0.1)*i - 5.0, Scalar(0.05)*i, -Scalar(0.02)*i, __int_as_scalar(i % 3));
+        h_vel.data[i] = make_scalar4(Scalar(i), -Scalar(i), Scalar(2*i), Scalar(1.0) + i);
+        }
+    }
+
+    UP_ASSERT(!pdata.getSoALayout());
+    pdata.setSoALayout(true);
+    UP_ASSERT(pdata.getSoALayout());
+
+    // the SoA arrays are gathered from the AoS arrays, and every row is cache line aligned
+    {
+    SoAHandle h_soa(pdata, soa_field::position | soa_field::velocity, access_mode::readwrite);
+    UP_ASSERT(((size_t)h_soa.x) % GPUARRAY_HOST_ALIGNMENT == 0);
+    UP_ASSERT(((size_t)h_soa.y) % GPUARRAY_HOST_ALIGNMENT == 0);
+    UP_ASSERT(((size_t)h_soa.vx) % GPUARRAY_HOST_ALIGNMENT == 0);
+    UP_ASSERT(((size_t)h_soa.mass) % GPUARRAY_HOST_ALIGNMENT == 0);
+    UP_ASSERT(((size_t)h_soa.type) % GPUARRAY_HOST_ALIGNMENT == 0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        MY_CHECK_CLOSE(h_soa.x[i], Scalar(0.1)*i - 5.0, tol);
+        MY_CHECK_SMALL(h_soa.y[i] - Scalar(0.05)*i, tol);
+        MY_CHECK_SMALL(h_soa.z[i] + Scalar(0.02)*i, tol);
+        UP_ASSERT_EQUAL(h_soa.type[i], i % 3);
+        MY_CHECK_SMALL(h_soa.vx[i] - Scalar(i), tol);
+        MY_CHECK_SMALL(h_soa.vy[i] + Scalar(i), tol);
+        MY_CHECK_SMALL(h_soa.vz[i] - Scalar(2*i), tol);
+        MY_CHECK_CLOSE(h_soa.mass[i], Scalar(1.0) + i, tol);
+
+        // write through the SoA arrays
+        h_soa.x[i] += Scalar(1.0);
+        h_soa.type[i] = (i + 1) % 3;
+        h_soa.vz[i] = Scalar(-3.0);
+        h_soa.mass[i] = Scalar(2.0);
+        }
+    }
+
+    // the writes are visible through the AoS view
+    for (unsigned int i = 0; i < N; i++)
+        {
+        MY_CHECK_CLOSE(pdata.getPosition(i).x, Scalar(0.1)*i - 4.0, tol);
+        UP_ASSERT_EQUAL(pdata.getType(i), (i + 1) % 3);
+        MY_CHECK_CLOSE(pdata.getVelocity(i).z, -3.0, tol);
+        MY_CHECK_CLOSE(pdata.getMass(i), 2.0, tol);
+        }
+
+    // writes to the AoS arrays are visible through the SoA view
+    pdata.setPosition(7, make_scalar3(1.0, 2.0, 3.0));
+    pdata.setVelocity(9, make_scalar3(4.0, 5.0, 6.0));
+    {
+    ArrayHandle<unsigned int> h_rtag(pdata.getRTags(), access_location::host, access_mode::read);
+    SoAHandle h_soa(pdata, soa_field::position | soa_field::velocity, access_mode::read);
+    unsigned int idx = h_rtag.data[7];
+    MY_CHECK_CLOSE(h_soa.x[idx], 1.0, tol);
+    MY_CHECK_CLOSE(h_soa.y[idx], 2.0, tol);
+    MY_CHECK_CLOSE(h_soa.z[idx], 3.0, tol);
+    idx = h_rtag.data[9];
+    MY_CHECK_CLOSE(h_soa.vx[idx], 4.0, tol);
+    MY_CHECK_CLOSE(h_soa.vy[idx], 5.0, tol);
+    MY_CHECK_CLOSE(h_soa.vz[idx], 6.0, tol);
+    }
+
+    // pending writes are copied back when the layout is disabled
+    {
+    SoAHandle h_soa(pdata, soa_field::velocity, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        h_soa.vx[i] = Scalar(0.5);
+    }
+    pdata.setSoALayout(false);
+    {
+    ArrayHandle<Scalar4> h_vel(pdata.getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < N; i++)
+        MY_CHECK_CLOSE(h_vel.data[i].x, 0.5, tol);
+    }
+
+    // SoA access requires the layout to be enabled
+    bool thrown = false;
+    try
+        {
+        SoAHandle h_soa(pdata, soa_field::position, access_mode::read);
+        }
+    catch (std::runtime_error&)
+        {
+        thrown = true;
+        }
+    UP_ASSERT(thrown);
+    }
+
 //! Tests the RandomParticleInitializer class
 UP_TEST( Random_test )
     {
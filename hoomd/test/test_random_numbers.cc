@@ -0,0 +1,154 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+
+#include "hoomd/RandomNumbers.h"
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+using namespace std;
+using namespace hoomd;
+
+/*! \file test_random_numbers.cc
+    \brief Implements unit tests for the counter based random number generator
+    \ingroup unit_tests
+*/
+
+//! Philox4x32-10 must reproduce the known answer vectors of the reference implementation
+UP_TEST( philox_known_answers )
+    {
+    unsigned int a[4] = {0, 0, 0, 0};
+    Philox4x32::generate(a, 0, 0);
+    UP_ASSERT_EQUAL(a[0], 0x6627e8d5u);
+    UP_ASSERT_EQUAL(a[1], 0xe169c58du);
+    UP_ASSERT_EQUAL(a[2], 0xbc57ac4cu);
+    UP_ASSERT_EQUAL(a[3], 0x9b00dbd8u);
+
+    unsigned int b[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    Philox4x32::generate(b, 0xffffffff, 0xffffffff);
+    UP_ASSERT_EQUAL(b[0], 0x408f276du);
+    UP_ASSERT_EQUAL(b[1], 0x41c83b0eu);
+    UP_ASSERT_EQUAL(b[2], 0xa20bc7c6u);
+    UP_ASSERT_EQUAL(b[3], 0x6d5451fdu);
+
+    unsigned int c[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    Philox4x32::generate(c, 0xa4093822, 0x299f31d0);
+    UP_ASSERT_EQUAL(c[0], 0xd16cfe09u);
+    UP_ASSERT_EQUAL(c[1], 0x94fdccebu);
+    UP_ASSERT_EQUAL(c[2], 0x5001e420u);
+    UP_ASSERT_EQUAL(c[3], 0x24126ea1u);
+    }
+
+//! RandomGenerator must map seed and stream to the key and i, j, timestep and block to the counter
+UP_TEST( generator_known_answer )
+    {
+    // third known answer vector of the reference implementation
+    RandomGenerator rng(0x299f31d0, 0xa4093822, 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344);
+    unsigned int u[4];
+    rng.u32x4(u);
+    UP_ASSERT_EQUAL(u[0], 0xd16cfe09u);
+    UP_ASSERT_EQUAL(u[1], 0x94fdccebu);
+    UP_ASSERT_EQUAL(u[2], 0x5001e420u);
+    UP_ASSERT_EQUAL(u[3], 0x24126ea1u);
+
+    // the next block increments the last counter word
+    unsigned int c[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707345};
+    Philox4x32::generate(c, 0xa4093822, 0x299f31d0);
+    rng.u32x4(u);
+    for (unsigned int k = 0; k < 4; k++)
+        UP_ASSERT_EQUAL(u[k], c[k]);
+
+    // uniform numbers are computed from the same words with u01
+    RandomGenerator rng2(0x299f31d0, 0xa4093822, 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344);
+    double r[4];
+    rng2.uniform4(r, 0.0, 1.0);
+    UP_ASSERT_EQUAL(r[0], double(0xd16cfe09u) / 4294967296.0);
+    UP_ASSERT_EQUAL(r[3], double(0x24126ea1u) / 4294967296.0);
+    }
+
+//! The block generators must return exactly the numbers of the per-id streams
+UP_TEST( block_matches_stream )
+    {
+    // use a count that is not a multiple of the tile size
+    const unsigned int n = 2*RANDOM_BLOCK_TILE + 5;
+    vector<unsigned int> ids(n);
+    for (unsigned int i = 0; i < n; i++)
+        ids[i] = 7*i + 3;
+
+    vector<double> uniform(4*n), normal(4*n);
+    generateUniformBlock(&uniform[0], &ids[0], n, RNGIdentifier::TwoStepBD, 42, 1000, 0, -1.0, 1.0);
+    generateNormalBlock(&normal[0], &ids[0], n, RNGIdentifier::TwoStepBD, 42, 1000, 1, 2.0);
+
+    for (unsigned int i = 0; i < n; i++)
+        {
+        RandomGenerator rng(RNGIdentifier::TwoStepBD, 42, ids[i], 0, 1000);
+        double u[4], g[4];
+        rng.uniform4(u, -1.0, 1.0);
+        rng.normal4(g, 2.0);
+        for (unsigned int k = 0; k < 4; k++)
+            {
+            UP_ASSERT_EQUAL(u[k], uniform[4*i+k]);
+            UP_ASSERT_EQUAL(g[k], normal[4*i+k]);
+            }
+        }
+    }
+
+//! Streams that differ in any part of the key or counter must differ
+UP_TEST( streams_are_distinct )
+    {
+    unsigned int ref[4], u[4];
+    RandomGenerator(1, 2, 3, 4, 5).u32x4(ref);
+
+    RandomGenerator(0, 2, 3, 4, 5).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    RandomGenerator(1, 0, 3, 4, 5).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    RandomGenerator(1, 2, 0, 4, 5).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    RandomGenerator(1, 2, 3, 0, 5).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    RandomGenerator(1, 2, 3, 4, 0).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    RandomGenerator(1, 2, 3, 4, 5, 1).u32x4(u);
+    UP_ASSERT(u[0] != ref[0]);
+    }
+
+//! Check the first two moments of the uniform and normal distributions
+UP_TEST( moments )
+    {
+    const unsigned int n = 100000;
+    double u_sum = 0, u_sum2 = 0, g_sum = 0, g_sum2 = 0;
+    float u_min = 1, u_max = -1;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        RandomGenerator rng(RNGIdentifier::TwoStepLangevin, 12345, i, 0, 17);
+        float u[4], g[4];
+        rng.uniform4(u, -1.0f, 1.0f);
+        rng.normal4(g, 1.0f);
+        for (unsigned int k = 0; k < 4; k++)
+            {
+            u_sum += u[k];
+            u_sum2 += u[k]*u[k];
+            g_sum += g[k];
+            g_sum2 += g[k]*g[k];
+            u_min = std::min(u_min, u[k]);
+            u_max = std::max(u_max, u[k]);
+            }
+        }
+
+    double N = 4.0*n;
+    UP_ASSERT(u_min >= -1.0f);
+    UP_ASSERT(u_max < 1.0f);
+    MY_CHECK_SMALL(u_sum/N, 0.01);
+    MY_CHECK_CLOSE(u_sum2/N, 1.0/3.0, 0.01);
+    MY_CHECK_SMALL(g_sum/N, 0.01);
+    MY_CHECK_CLOSE(g_sum2/N, 1.0, 0.01);
+    }
@@ -0,0 +1,188 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "hoomd/SFCPackUpdater.h"
+#include "hoomd/extern/saruprng.h"
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+using namespace std;
+
+/*! \file test_sfcpack_updater.cc
+    \brief Implements unit tests for SFCPackUpdater
+    \ingroup unit_tests
+*/
+
+//! Gives the tests access to the bins and the sort order of SFCPackUpdater
+class SFCPackUpdaterTester : public SFCPackUpdater
+    {
+    public:
+        //! Constructs the tester
+        SFCPackUpdaterTester(std::shared_ptr<SystemDefinition> sysdef) : SFCPackUpdater(sysdef)
+            {
+            }
+
+        //! Compute the bins of all particles and sort them
+        /*! \param bins Position of each particle's bin along the curve, in memory order (output)
+            \param order Index of the particle that moves to each position (output)
+        */
+        void getSortOrder(std::vector<unsigned int>& bins, std::vector<unsigned int>& order)
+            {
+            const unsigned int N = m_pdata->getN();
+            computeBins();
+            bins.assign(m_particle_bins.begin(), m_particle_bins.begin() + N);
+            sortBins();
+            order.assign(m_sort_order.begin(), m_sort_order.begin() + N);
+            }
+    };
+
+//! Build a system of \a N particles at random positions in a cube (or square) of side \a L
+std::shared_ptr<SystemDefinition> build_random(unsigned int N,
+                                               Scalar L,
+                                               unsigned int dim,
+                                               std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    sysdef->setNDimensions(dim);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    Saru saru(12345);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_pos.data[i].x = saru.s(-L/Scalar(2.0), L/Scalar(2.0));
+        h_pos.data[i].y = saru.s(-L/Scalar(2.0), L/Scalar(2.0));
+        h_pos.data[i].z = (dim == 3) ? saru.s(-L/Scalar(2.0), L/Scalar(2.0)) : Scalar(0.0);
+        }
+    return sysdef;
+    }
+
+//! Checks that the radix sort gives the same order as sorting (bin, index) pairs
+void sfcpack_radix_test(unsigned int dim, unsigned int grid, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef = build_random(5000, Scalar(20.0), dim, exec_conf);
+    std::shared_ptr<SFCPackUpdaterTester> sorter(new SFCPackUpdaterTester(sysdef));
+    if (grid > 0)
+        sorter->setGrid(grid);
+
+    std::vector<unsigned int> bins, order;
+    sorter->getSortOrder(bins, order);
+
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(bins.size());
+    for (unsigned int i = 0; i < bins.size(); i++)
+        pairs[i] = std::make_pair(bins[i], i);
+    std::sort(pairs.begin(), pairs.end());
+
+    UP_ASSERT_EQUAL(order.size(), pairs.size());
+    for (unsigned int i = 0; i < pairs.size(); i++)
+        UP_ASSERT_EQUAL(order[i], pairs[i].second);
+    }
+
+//! Shuffle the particles in memory
+void shuffle_particles(std::shared_ptr<ParticleData> pdata, unsigned int seed)
+    {
+    Saru saru(seed);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = pdata->getN()-1; i > 0; i--)
+        {
+        unsigned int j = saru.u32() % (i+1);
+        std::swap(h_pos.data[i], h_pos.data[j]);
+        }
+    }
+
+//! Checks the disorder of a random, a sorted and a shuffled particle order
+void sfcpack_disorder_test(unsigned int dim, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 8000;
+    std::shared_ptr<SystemDefinition> sysdef = build_random(N, Scalar(20.0), dim, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<SFCPackUpdater> sorter(new SFCPackUpdater(sysdef));
+
+    // particles placed in random order are far apart along the curve
+    UP_ASSERT(sorter->computeDisorder() > Scalar(0.9));
+
+    sorter->update(0);
+    UP_ASSERT(sorter->computeDisorder() < Scalar(0.01));
+
+    shuffle_particles(pdata, 54321);
+    UP_ASSERT(sorter->computeDisorder() > Scalar(0.9));
+
+    // an adaptive sort must sort the shuffled particles
+    sorter->setMaxDisorder(Scalar(0.5));
+    sorter->update(1);
+    UP_ASSERT(sorter->computeDisorder() < Scalar(0.01));
+    }
+
+//! Checks that an adaptive sorter created at a late time step (as after a restart) still sorts
+void sfcpack_restart_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef = build_random(8000, Scalar(20.0), 3, exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // start from sorted particles
+    std::shared_ptr<SFCPackUpdater> sorter(new SFCPackUpdater(sysdef));
+    sorter->update(0);
+
+    // the first adaptive check at a late step must not push the next check far into the future
+    std::shared_ptr<SFCPackUpdater> restarted(new SFCPackUpdater(sysdef));
+    restarted->setMaxDisorder(Scalar(0.5));
+    restarted->update(1000000);
+    UP_ASSERT(restarted->computeDisorder() < Scalar(0.01));
+
+    shuffle_particles(pdata, 54321);
+    restarted->update(1000100);
+    UP_ASSERT(restarted->computeDisorder() < Scalar(0.01));
+    }
+
+//! Radix sort in 3D with the default grid
+UP_TEST( SFCPackUpdater_radix_3d )
+    {
+    sfcpack_radix_test(3, 0, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Radix sort in 3D with many particles per bin
+UP_TEST( SFCPackUpdater_radix_3d_coarse )
+    {
+    sfcpack_radix_test(3, 8, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Radix sort in 2D with the default grid
+UP_TEST( SFCPackUpdater_radix_2d )
+    {
+    sfcpack_radix_test(2, 0, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Radix sort in 2D with many particles per bin
+UP_TEST( SFCPackUpdater_radix_2d_coarse )
+    {
+    sfcpack_radix_test(2, 16, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Disorder in 3D
+UP_TEST( SFCPackUpdater_disorder_3d )
+    {
+    sfcpack_disorder_test(3, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Disorder in 2D
+UP_TEST( SFCPackUpdater_disorder_2d )
+    {
+    sfcpack_disorder_test(2, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Adaptive sorting after a restart
+UP_TEST( SFCPackUpdater_disorder_restart )
+    {
+    sfcpack_restart_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
@@ -0,0 +1,110 @@
+// Copyright (c) 2009-2017 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+
+#include "hoomd/StepTimer.h"
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+using namespace std;
+
+/*! \file test_step_timer.cc
+    \brief Implements unit tests for StepTimer
+    \ingroup unit_tests
+*/
+
+//! Wait for the given number of milliseconds without yielding the CPU
+static void busy_wait(unsigned int msec)
+    {
+    ClockSource clk;
+    while (clk.getTime() < int64_t(msec)*int64_t(1000000))
+        {
+        }
+    }
+
+//! Regions are registered once per name
+UP_TEST( step_timer_register )
+    {
+    StepTimer timer;
+    unsigned int a = timer.registerRegion("A");
+    unsigned int b = timer.registerRegion("B");
+    UP_ASSERT(a != b);
+    UP_ASSERT_EQUAL(timer.registerRegion("A"), a);
+    UP_ASSERT_EQUAL(timer.findRegion("B"), b);
+    UP_ASSERT_EQUAL(timer.findRegion("C"), StepTimer::NO_REGION);
+    UP_ASSERT_EQUAL(timer.getNumRegions(), (unsigned int)2);
+    UP_ASSERT_EQUAL(timer.getRegionName(b), string("B"));
+    }
+
+//! Executions on the same step are summed, and the ring buffer keeps the last steps
+UP_TEST( step_timer_history )
+    {
+    StepTimer timer(4);
+    unsigned int a = timer.registerRegion("A");
+
+    for (unsigned int step = 10; step < 16; step++)
+        {
+        // execute twice on every step
+        for (unsigned int k = 0; k < 2; k++)
+            {
+            StepTimerScope timing(timer, a, step);
+            }
+        }
+
+    UP_ASSERT_EQUAL(timer.getNumSteps(a), (unsigned long long)6);
+
+    vector<unsigned int> steps = timer.getHistorySteps(a);
+    UP_ASSERT_EQUAL(steps.size(), (size_t)4);
+    for (unsigned int i = 0; i < 4; i++)
+        UP_ASSERT_EQUAL(steps[i], 12 + i);
+
+    // nothing is recorded while the timer is disabled
+    timer.setEnabled(false);
+        {
+        StepTimerScope timing(timer, a, 16);
+        }
+    UP_ASSERT_EQUAL(timer.getNumSteps(a), (unsigned long long)6);
+
+    timer.reset();
+    UP_ASSERT_EQUAL(timer.getNumSteps(a), (unsigned long long)0);
+    UP_ASSERT_EQUAL(timer.getHistory(a).size(), (size_t)0);
+    MY_CHECK_SMALL(timer.getMeanTime(a), 1e-12);
+    }
+
+//! Nested regions are excluded from the self time
+UP_TEST( step_timer_nested )
+    {
+    StepTimer timer;
+    unsigned int outer = timer.registerRegion("outer");
+    unsigned int inner = timer.registerRegion("inner");
+
+        {
+        StepTimerScope timing_outer(timer, outer, 0);
+        busy_wait(10);
+            {
+            StepTimerScope timing_inner(timer, inner, 0);
+            busy_wait(20);
+            }
+        }
+
+    double inner_time = timer.getTotalTime(inner);
+    double outer_time = timer.getTotalTime(outer);
+    double outer_self = timer.getSelfTime(outer);
+
+    // the measured times are only checked loosely, the test machine may be busy. The tick rate is recalibrated on
+    // every query, so values read at different times differ slightly
+    UP_ASSERT(inner_time >= 0.015);
+    UP_ASSERT(outer_time >= inner_time);
+    MY_CHECK_CLOSE(outer_self, outer_time - inner_time, 1e-2);
+    MY_CHECK_CLOSE(timer.getSelfTime(inner), inner_time, 1e-3);
+    MY_CHECK_CLOSE(timer.getMeanTime(inner), inner_time, 1e-3);
+    MY_CHECK_CLOSE(timer.getLastTime(outer), outer_time, 1e-3);
+    }
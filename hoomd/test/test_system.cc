@@ -88,7 +88,7 @@ class DummyCompute : public Compute
             }
 
         //! Just prints our name and the current time step
-        void compute(unsigned int timestep)
+        void doCompute(unsigned int timestep)
             {
             if (m_prof)
                 m_prof->push(m_name);
@@ -340,6 +340,25 @@ UP_TEST( getter_setter_tests )
     }
 
 
+//! Tests that every compute added to a System records its time in the StepTimer
+UP_TEST( compute_timing_test )
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(10, BoxDim(10)));
+    std::shared_ptr< Compute > compute(new DummyCompute(sysdef, "compute1"));
+
+    System sys(sysdef, 0);
+    sys.addCompute(compute, "compute1");
+
+    StepTimer& timer = sysdef->getParticleData()->getExecConf()->getStepTimer();
+    timer.setEnabled(true);
+    unsigned int region = timer.findRegion("compute1");
+    UP_ASSERT(region != StepTimer::NO_REGION);
+
+    // the dummy sleeps for 8 ms in doCompute()
+    compute->compute(3);
+    UP_ASSERT(timer.getTotalTime(region) > 0.005);
+    }
+
 // since there is no automatic verification, there is no reason to run this test all the time
 // this test can be uncommented only when it needs to be checked by a person
 
@@ -238,14 +238,22 @@ class sort(_updater):
 
         self.setupUpdater(default_period);
 
-    def set_params(self, grid=None):
+    def set_params(self, grid=None, max_disorder=None):
         R""" Change sorter parameters.
 
         Args:
             grid (int): New grid dimension (if set)
+            max_disorder (float): Skip the sort on scheduled time steps while the particle order is less disordered
+                than this (if set). Set to 0 to sort every *period* time steps.
+
+        The disorder is the fraction of particles whose neighbor in memory is far away along the Hilbert curve. It
+        is close to 0 right after a sort and approaches 1 for a random order. With *max_disorder* set, the sorter
+        checks the disorder every *period* time steps and only sorts when it exceeds the threshold, so slowly
+        diffusing systems are sorted less often.
 
         Examples::
             sorter.set_params(grid=128)
+            sorter.set_params(max_disorder=0.2)
         """
 
         hoomd.util.print_status_line();
@@ -254,6 +262,27 @@ class sort(_updater):
         if grid is not None:
             self.cpp_updater.setGrid(grid);
 
+        if max_disorder is not None:
+            if max_disorder < 0 or max_disorder > 1:
+                hoomd.context.msg.error("update.sort: max_disorder must be between 0 and 1\n");
+                raise ValueError("Invalid max_disorder");
+            self.cpp_updater.setMaxDisorder(max_disorder);
+
+    def get_disorder(self):
+        R""" Measure the current disorder of the particle order.
+
+        Returns:
+            The fraction of particles whose neighbor in memory is far away along the Hilbert curve (the maximum over
+            all ranks in MPI simulations).
+
+        Use this to choose *max_disorder* in :py:meth:`set_params()`.
+
+        Examples::
+            d = sorter.get_disorder()
+        """
+        self.check_initialization();
+        return self.cpp_updater.computeDisorder();
+
 class box_resize(_updater):
     R""" Rescale the system box size.
 
@@ -479,5 +508,47 @@ class balance(_updater):
             self.maxiter = maxiter
             self.cpp_updater.setMaxIterations(self.maxiter)
 
+class dynamic_group(_updater):
+    R""" Periodically updates the membership of a group.
+
+    Args:
+        group (:py:mod:`hoomd.group`): Group to update
+        period (int): The group is updated every *period* time steps
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+
+    Every *period* time steps, all particles are re-evaluated against the original selection criterion of *group*
+    and the group membership is replaced by the particles that currently meet it, as if
+    :py:meth:`hoomd.group.group.force_update()` was called. Use this to define regions, such as thermostatted
+    slabs, that particles enter and leave during a run.
+
+    Groups made by a combination (union, intersection, difference) of other groups and groups created with
+    :py:func:`hoomd.group.tag_list()` have no selection criterion, they are not changed.
+
+    Note:
+        Integration methods, computes and analyzers that use the group always act on its current members. After
+        every update, the number of degrees of freedom of all :py:class:`hoomd.compute.thermo` instances is counted
+        again, so that temperatures reflect the current members of the group.
+
+    Examples::
+
+        slab = group.cuboid(name="slab", zmin=-2, zmax=2)
+        update.dynamic_group(slab, period=100)
+    """
+    def __init__(self, group, period=1, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _updater.__init__(self);
+
+        # create the c++ mirror class
+        self.cpp_updater = _hoomd.DynamicGroupUpdater(hoomd.context.current.system_definition, group.cpp_group);
+        self.setupUpdater(period, phase);
+
+        # store metadata
+        self.group = group
+        self.period = period
+        self.phase = phase
+        self.metadata_fields = ['group','period','phase']
+
 # Global current id counter to assign updaters unique names
 _updater.cur_id = 0;
@@ -114,3 +114,156 @@ def cuda_profile_stop():
     """
 
     _hoomd.cuda_profile_stop();
+
+def get_host_memory_stats():
+    R""" Get statistics of the host memory pool.
+
+    Returns:
+        A dictionary with the following keys:
+
+        - ``allocations``: number of host array allocations
+        - ``cache_hits``: number of allocations served with freed memory from the pool
+        - ``system_allocations``: number of blocks the pool requested from the system
+        - ``bytes_in_use``: bytes currently held by arrays
+        - ``peak_bytes_in_use``: largest value of ``bytes_in_use`` so far
+        - ``bytes_cached``: freed bytes kept in the pool for reuse
+        - ``huge_page_bytes``: bytes (in use or cached) backed by huge pages
+
+    Example::
+
+        stats = hoomd.util.get_host_memory_stats()
+        print(stats['cache_hits'] / stats['allocations'])
+
+    See Also:
+        :py:func:`hoomd.option.set_host_memory_params()`.
+    """
+    hoomd.context._verify_init();
+
+    pool = hoomd.context.exec_conf.getHostMemoryPool();
+    return dict(allocations=pool.getNumAllocations(),
+                cache_hits=pool.getNumCacheHits(),
+                system_allocations=pool.getNumSystemAllocations(),
+                bytes_in_use=pool.getBytesInUse(),
+                peak_bytes_in_use=pool.getPeakBytesInUse(),
+                bytes_cached=pool.getBytesCached(),
+                huge_page_bytes=pool.getHugePageBytes());
+
+def get_timings():
+    R""" Get the time spent in each compute, updater, analyzer, and integrator.
+
+    HOOMD times the components of every step with a low overhead counter. The timing is always on and does not
+    require ``profile=True`` in :py:func:`hoomd.run()`. Components are grouped by their C++ class, so that two Lennard-Jones pair forces are
+    reported together as ``PotentialPairLJ``. The time of a component includes the time of all components that
+    it calls, for example the integrator includes the forces it computes.
+
+    Returns:
+        A dictionary keyed by class name. Each value is a dictionary with the following keys:
+
+        - ``mean``: mean time per step over the last steps the component executed (in seconds)
+        - ``last``: time spent on the last step the component executed (in seconds)
+        - ``total``: time spent since the start of the simulation (in seconds)
+        - ``self``: the part of ``total`` not spent in other timed components (in seconds)
+        - ``steps``: number of steps the component executed
+        - ``history``: list of the times per step that ``mean`` is computed from, oldest first (in seconds)
+
+    The ``mean`` value is also available to :py:class:`hoomd.analyze.log` as the quantity ``time_<class name>``.
+
+    Example::
+
+        timings = hoomd.util.get_timings()
+        print(timings['PotentialPairLJ']['mean'])
+
+    See Also:
+        :py:func:`hoomd.util.set_timing_params()`.
+    """
+    hoomd.context._verify_init();
+
+    timer = hoomd.context.exec_conf.getStepTimer();
+    result = dict();
+    for i in range(timer.getNumRegions()):
+        result[timer.getRegionName(i)] = dict(mean=timer.getMeanTime(i),
+                                              last=timer.getLastTime(i),
+                                              total=timer.getTotalTime(i),
+                                              self=timer.getSelfTime(i),
+                                              steps=timer.getNumSteps(i),
+                                              history=list(timer.getHistory(i)));
+    return result;
+
+def set_timing_params(enable=None, history=None, reset=False):
+    R""" Set parameters of the per-component timing.
+
+    Args:
+        enable (bool): Set to False to turn timing off.
+        history (int): Number of steps the mean time per step is computed over.
+        reset (bool): Set to True to clear all timings.
+
+    Timing is enabled by default with a history of 100 steps. Changing the history clears the times per step.
+
+    Example::
+
+        hoomd.util.set_timing_params(history=1000)
+        hoomd.util.set_timing_params(reset=True)
+
+    See Also:
+        :py:func:`hoomd.util.get_timings()`.
+    """
+    hoomd.context._verify_init();
+
+    timer = hoomd.context.exec_conf.getStepTimer();
+    if enable is not None:
+        timer.setEnabled(bool(enable));
+
+    if history is not None:
+        if int(history) <= 0:
+            hoomd.context.msg.error("history must be positive\n");
+            raise RuntimeError('Error setting timing parameters');
+        timer.setHistoryLength(int(history));
+
+    if reset:
+        timer.reset();
+
+def start_trace(filename, max_events=10000000):
+    R""" Start recording a timeline trace.
+
+    Args:
+        filename (str): File to write the trace to.
+        max_events (int): Maximum number of events recorded per MPI rank.
+
+    While a trace is recorded, :py:func:`hoomd.run()` records the beginning and end of every time step, every
+    analyzer, updater, and integrator call, every section that the profiler times (see the ``profile`` option of
+    :py:func:`hoomd.run()`), and every MPI communication phase. :py:func:`hoomd.util.stop_trace()` writes the
+    events of all ranks to *filename* in the Chrome trace event format. Open the file in chrome://tracing or
+    https://ui.perfetto.dev to inspect the timeline of each rank step by step, for example to find the rank that
+    holds up the others in a communication phase.
+
+    The time stamps of all ranks are measured from a common barrier at the start of the trace. Each event takes
+    24 bytes of memory until the trace is written. When *max_events* is reached, later events are dropped.
+
+    Start the trace before calling :py:func:`hoomd.run()`. In MPI simulations, all ranks must call
+    :py:func:`start_trace()` and :py:func:`stop_trace()`. With more than one partition, each partition writes
+    its own file with the partition index appended to *filename* (e.g. ``trace.json.0``).
+
+    Example::
+
+        hoomd.util.start_trace('trace.json')
+        hoomd.run(1000)
+        hoomd.util.stop_trace()
+
+    """
+    hoomd.context._verify_init();
+
+    if int(max_events) <= 0:
+        hoomd.context.msg.error("max_events must be positive\n");
+        raise RuntimeError('Error starting trace');
+
+    hoomd.context.exec_conf.getTraceRecorder().start(filename, int(max_events));
+
+def stop_trace():
+    R""" Stop recording a timeline trace and write it to the file.
+
+    See Also:
+        :py:func:`hoomd.util.start_trace()`.
+    """
+    hoomd.context._verify_init();
+
+    hoomd.context.exec_conf.getTraceRecorder().stop();